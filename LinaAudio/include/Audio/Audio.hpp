@@ -44,10 +44,14 @@ Timestamp: 12/15/2021 2:12:28 PM
 #include "Audio/AudioAssetData.hpp"
 #include "Resources/IResource.hpp"
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace Lina::Audio
 {
+    class AudioDecoder;
+
     class Audio : public Resources::IResource
     {
 
@@ -65,16 +69,47 @@ namespace Lina::Audio
             return m_buffer;
         }
 
+        /// <summary>
+        /// Length of the buffer in seconds, voices use it to track the position while they don't hold a source.
+        /// </summary>
+        inline float GetDuration() const
+        {
+            return m_duration;
+        }
+
+        /// <summary>
+        /// Streamed audio has no buffer, it's decoded in chunks while playing. Ogg files & wav files larger than
+        /// StreamThreshold are streamed, other formats, e.g. mp3, have no streaming decoder & are loaded through alut.
+        /// </summary>
+        inline bool IsStreamed() const
+        {
+            return m_isStreamed;
+        }
+
+        /// <summary>
+        /// Opens a new decoder on the file, or on the kept file image if loaded from memory. Returns nullptr if the
+        /// audio isn't streamed or its format has no decoder.
+        /// </summary>
+        std::unique_ptr<AudioDecoder> CreateDecoder() const;
+
+        static const size_t StreamThreshold = 2 * 1024 * 1024;
+
     private:
-        static void CheckForError();
+        static void  CheckForError();
+        static float GetBufferDuration(unsigned int buffer);
+        bool         SetupStreaming(const std::string& path, size_t fileSize);
 
     private:
-        AudioAssetData* m_assetData = nullptr;
-        int             m_size      = 0;
-        int             m_format    = 0;
-        unsigned int    m_buffer    = 0;
-        float           m_freq      = 0.0f;
-        void*           m_data      = nullptr;
+        AudioAssetData*            m_assetData  = nullptr;
+        int                        m_size       = 0;
+        int                        m_format     = 0;
+        unsigned int               m_buffer     = 0;
+        float                      m_freq       = 0.0f;
+        float                      m_duration   = 0.0f;
+        void*                      m_data       = nullptr;
+        bool                       m_isStreamed = false;
+        std::string                m_path;
+        std::vector<unsigned char> m_fileData;
     };
 } // namespace Lina::Audio
 
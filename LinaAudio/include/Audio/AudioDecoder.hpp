@@ -0,0 +1,161 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: AudioDecoder
+
+Decodes audio files in chunks of interleaved 16 bit frames, used by the streams instead of loading the whole
+file into a single buffer. Ogg is decoded through stb_vorbis, wav is read straight from the RIFF data chunk.
+Decoders aren't thread safe, a stream only touches its decoder from the decoding thread.
+
+Timestamp: 2/10/2022 10:12:44 AM
+*/
+
+#pragma once
+
+#ifndef AudioDecoder_HPP
+#define AudioDecoder_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct stb_vorbis;
+
+namespace Lina::Audio
+{
+    class AudioDecoder
+    {
+
+    public:
+        AudioDecoder()          = default;
+        virtual ~AudioDecoder() = default;
+
+        /// <summary>
+        /// Creates a decoder by the file extension & opens the file, returns nullptr if the format isn't supported or
+        /// the file can't be opened.
+        /// </summary>
+        static std::unique_ptr<AudioDecoder> Create(const std::string& path);
+
+        /// <summary>
+        /// Same as Create, decodes from a copy of the given file image, path is only used for the extension.
+        /// </summary>
+        static std::unique_ptr<AudioDecoder> Create(const std::string& path, const unsigned char* data, size_t dataSize);
+
+        /// <summary>
+        /// Returns true if files with this extension can be streamed.
+        /// </summary>
+        static bool IsSupported(const std::string& extension);
+
+        /// <summary>
+        /// Decodes up to frameCount frames into samples, which must hold frameCount * channels values.
+        /// Returns the number of frames decoded, less than requested only at the end of the stream.
+        /// </summary>
+        virtual uint32 Read(int16* samples, uint32 frameCount) = 0;
+
+        /// <summary>
+        /// Moves the read position to the given frame, clamped to the stream length.
+        /// </summary>
+        virtual bool Seek(uint64 frame) = 0;
+
+        inline uint32 GetChannels() const
+        {
+            return m_channels;
+        }
+
+        inline uint32 GetSampleRate() const
+        {
+            return m_sampleRate;
+        }
+
+        inline uint64 GetTotalFrames() const
+        {
+            return m_totalFrames;
+        }
+
+    protected:
+        uint32 m_channels    = 0;
+        uint32 m_sampleRate  = 0;
+        uint64 m_totalFrames = 0;
+    };
+
+    class WavDecoder : public AudioDecoder
+    {
+
+    public:
+        WavDecoder() = default;
+        virtual ~WavDecoder() = default;
+
+        bool Open(const std::string& path);
+        bool Open(const unsigned char* data, size_t dataSize);
+
+        virtual uint32 Read(int16* samples, uint32 frameCount) override;
+        virtual bool   Seek(uint64 frame) override;
+
+    private:
+        bool   ParseHeader();
+        size_t ReadBytes(uint64 offset, void* dst, size_t size);
+
+    private:
+        std::ifstream      m_file;
+        std::vector<uint8> m_memory;
+        std::vector<uint8> m_readBuffer;
+        bool               m_fromMemory    = false;
+        uint64             m_dataOffset    = 0;
+        uint64             m_frame         = 0;
+        uint32             m_bytesPerFrame = 0;
+        uint32             m_bitsPerSample = 0;
+    };
+
+    class VorbisDecoder : public AudioDecoder
+    {
+
+    public:
+        VorbisDecoder() = default;
+        virtual ~VorbisDecoder();
+
+        bool Open(const std::string& path);
+        bool Open(const unsigned char* data, size_t dataSize);
+
+        virtual uint32 Read(int16* samples, uint32 frameCount) override;
+        virtual bool   Seek(uint64 frame) override;
+
+    private:
+        bool ReadInfo();
+
+    private:
+        stb_vorbis*        m_vorbis = nullptr;
+        std::vector<uint8> m_memory;
+    };
+} // namespace Lina::Audio
+
+#endif
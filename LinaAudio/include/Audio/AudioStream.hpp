@@ -0,0 +1,255 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: AudioStream
+
+Plays a decoder through a small ring of buffers instead of a single fully decoded one. A background thread decodes
+chunks ahead into the free slots of the ring, Update moves the decoded slots to the sink's queue in order & returns
+the played ones to the decoder, so only bufferCount * bufferFrames frames are ever resident.
+
+The sink is the device side, OpenAL queues the slots on a source, a fake sink can drive the same logic without
+a device. Streams aren't thread safe, all calls are expected from the thread owning the sink.
+
+Timestamp: 2/10/2022 11:03:27 AM
+*/
+
+#pragma once
+
+#ifndef AudioStream_HPP
+#define AudioStream_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Lina::Audio
+{
+    class AudioDecoder;
+
+    class AudioStreamSink
+    {
+
+    public:
+        AudioStreamSink()          = default;
+        virtual ~AudioStreamSink() = default;
+
+        /// <summary>
+        /// Number of buffers the sink can have queued, the stream's ring has one slot for each.
+        /// </summary>
+        virtual uint32 GetBufferCount() const = 0;
+
+        /// <summary>
+        /// Copies the frames into the given buffer & appends it to the play queue.
+        /// </summary>
+        virtual void Queue(uint32 buffer, const int16* samples, uint32 frames, uint32 channels, uint32 sampleRate) = 0;
+
+        /// <summary>
+        /// Removes the buffers that finished playing from the front of the queue & writes their indices, in play order.
+        /// </summary>
+        virtual uint32 Unqueue(uint32* buffers, uint32 maxCount) = 0;
+
+        /// <summary>
+        /// Drops all queued buffers without playing them.
+        /// </summary>
+        virtual void Flush() = 0;
+
+        /// <summary>
+        /// Playback stops by itself when the queue runs dry, the stream detects underruns from this.
+        /// </summary>
+        virtual bool IsPlaying() const = 0;
+
+        virtual void Play()  = 0;
+        virtual void Pause() = 0;
+    };
+
+    enum class AudioStreamState : uint8
+    {
+        Stopped = 0,
+        Playing,
+        Paused
+    };
+
+    struct AudioStreamStats
+    {
+        uint32 m_underruns     = 0;
+        uint32 m_loops         = 0;
+        uint64 m_queuedBuffers = 0;
+        uint64 m_decodedFrames = 0;
+    };
+
+    class AudioStream
+    {
+
+    public:
+        /// <summary>
+        /// Takes ownership of both, decoding starts right away to have the ring full before the first Play.
+        /// If decodeOnThread is false, Update decodes the free slots itself, which keeps runs deterministic.
+        /// </summary>
+        AudioStream(std::unique_ptr<AudioDecoder> decoder, std::unique_ptr<AudioStreamSink> sink, uint32 bufferFrames = 16384, bool decodeOnThread = true);
+        ~AudioStream();
+
+        AudioStream(const AudioStream&) = delete;
+        AudioStream& operator=(const AudioStream&) = delete;
+
+        void Play();
+        void Pause();
+
+        /// <summary>
+        /// Stops the sink & rewinds to the beginning.
+        /// </summary>
+        void Stop();
+
+        /// <summary>
+        /// Drops everything queued & decoded, decoding restarts from the given frame. Keeps the current state.
+        /// </summary>
+        void Seek(uint64 frame);
+
+        /// <summary>
+        /// Seek in seconds.
+        /// </summary>
+        void SeekTime(float seconds);
+
+        /// <summary>
+        /// Looping wraps the decoder inside the chunk being decoded, so there is no gap between the end & the start.
+        /// Turning it on after the end was decoded won't bring the stream back, Seek to restart it.
+        /// </summary>
+        void SetLooping(bool looping);
+
+        /// <summary>
+        /// Returns played slots to the decoder, queues the decoded ones, detects underruns & the end of the stream.
+        /// Should be called more often than a buffer takes to play.
+        /// </summary>
+        void Update();
+
+        /// <summary>
+        /// Frame of the decoder position at the start of the buffer being played, at buffer granularity.
+        /// </summary>
+        uint64 GetPlaybackFrame() const;
+
+        inline AudioStreamState GetState() const
+        {
+            return m_state;
+        }
+
+        inline bool GetIsLooping() const
+        {
+            return m_looping;
+        }
+
+        /// <summary>
+        /// Copy of the stats, the decoding thread writes to them.
+        /// </summary>
+        AudioStreamStats GetStats() const;
+
+        inline AudioStreamSink* GetSink() const
+        {
+            return m_sink.get();
+        }
+
+        inline uint32 GetChannels() const
+        {
+            return m_channels;
+        }
+
+        inline uint32 GetSampleRate() const
+        {
+            return m_sampleRate;
+        }
+
+        inline uint64 GetTotalFrames() const
+        {
+            return m_totalFrames;
+        }
+
+    private:
+        enum class SlotState : uint8
+        {
+            Free = 0,
+            Decoding,
+            Decoded,
+            Queued
+        };
+
+        struct Slot
+        {
+            std::vector<int16> m_samples;
+            uint64             m_startFrame = 0;
+            uint32             m_frames     = 0;
+            SlotState          m_state      = SlotState::Free;
+        };
+
+        void DecodeLoop();
+
+        /// <summary>
+        /// Decodes the next free slot if there is one, returns false if there was nothing to do.
+        /// The lock is released while decoding.
+        /// </summary>
+        bool DecodeNext(std::unique_lock<std::mutex>& lock);
+
+        /// <summary>
+        /// Flushes the sink & the ring, decoding continues from the given frame. Called with the lock held.
+        /// </summary>
+        void Reset(uint64 frame);
+
+    private:
+        std::unique_ptr<AudioDecoder>    m_decoder;
+        std::unique_ptr<AudioStreamSink> m_sink;
+        std::vector<Slot>                m_slots;
+        std::vector<uint32>              m_unqueued;
+        std::thread                      m_thread;
+        mutable std::mutex               m_mutex;
+        std::condition_variable          m_condition;
+        AudioStreamStats                 m_stats;
+        AudioStreamState                 m_state          = AudioStreamState::Stopped;
+        uint32                           m_bufferFrames   = 0;
+        uint32                           m_channels       = 0;
+        uint32                           m_sampleRate     = 0;
+        uint64                           m_totalFrames    = 0;
+        uint32                           m_nextDecode     = 0;
+        uint32                           m_nextQueue      = 0;
+        uint32                           m_queuedCount    = 0;
+        uint32                           m_generation     = 0;
+        uint64                           m_seekFrame      = 0;
+        uint64                           m_decodeFrame    = 0;
+        bool                             m_seekPending    = false;
+        bool                             m_looping        = false;
+        bool                             m_endOfStream    = false;
+        bool                             m_exit           = false;
+        bool                             m_decodeOnThread = true;
+        bool                             m_sinkStarted    = false;
+        bool                             m_isStarved      = false;
+    };
+} // namespace Lina::Audio
+
+#endif
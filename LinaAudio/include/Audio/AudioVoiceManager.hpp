@@ -0,0 +1,228 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: AudioVoiceManager
+
+Plays one-shot buffers on a fixed pool of sources created up front. Every playing sound is a voice, voices are
+ranked by priority, then by audibility (gain & distance attenuation from the listener), then by age, newer first.
+The highest ranked audible voices own the sources, the rest are virtual: they don't hold a source but keep their
+playback position advancing, so they continue from the right spot once a source is rebound to them.
+
+The device is the backend side, OpenAL plays the sources, a null device runs the same logic without a device.
+
+Timestamp: 2/11/2022 10:24:03 AM
+*/
+
+#pragma once
+
+#ifndef AudioVoiceManager_HPP
+#define AudioVoiceManager_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include "Math/Vector.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Lina::Audio
+{
+    struct AudioVoiceParams
+    {
+        Vector3 m_position = Vector3::Zero;
+        float   m_gain     = 1.0f;
+        float   m_pitch    = 1.0f;
+        bool    m_looping  = false;
+    };
+
+    class AudioVoiceDevice
+    {
+
+    public:
+        AudioVoiceDevice()          = default;
+        virtual ~AudioVoiceDevice() = default;
+
+        /// <summary>
+        /// Creates up to count sources, returns how many could be created. Sources are addressed by index after.
+        /// </summary>
+        virtual uint32 CreateSources(uint32 count) = 0;
+        virtual void   DestroySources()            = 0;
+
+        /// <summary>
+        /// Binds the buffer & starts it from the given offset in seconds. Duration is the length of the buffer.
+        /// </summary>
+        virtual void Play(uint32 source, unsigned int buffer, float duration, float offset, const AudioVoiceParams& params) = 0;
+        virtual void Stop(uint32 source)                                                                                 = 0;
+        virtual void SetParams(uint32 source, const AudioVoiceParams& params)                                            = 0;
+
+        /// <summary>
+        /// Non looping sources stop by themselves at the end of their buffer.
+        /// </summary>
+        virtual bool IsPlaying(uint32 source) const = 0;
+
+        /// <summary>
+        /// Playback position of the source in seconds.
+        /// </summary>
+        virtual float GetOffset(uint32 source) const = 0;
+    };
+
+    struct AudioVoiceStats
+    {
+        uint32 m_sources       = 0;
+        uint32 m_freeSources   = 0;
+        uint32 m_realVoices    = 0;
+        uint32 m_virtualVoices = 0;
+        uint64 m_played        = 0;
+        uint64 m_finished      = 0;
+        uint64 m_stolen        = 0;
+        uint64 m_virtualized   = 0;
+        uint64 m_rebound       = 0;
+        uint64 m_dropped       = 0;
+    };
+
+    class AudioVoiceManager
+    {
+
+    public:
+        /// <summary>
+        /// Creates the source pool on the device, maxVoices caps real & virtual voices together.
+        /// </summary>
+        AudioVoiceManager(AudioVoiceDevice* device, uint32 sourceCount = 32, uint32 maxVoices = 256);
+        ~AudioVoiceManager();
+
+        AudioVoiceManager(const AudioVoiceManager&) = delete;
+        AudioVoiceManager& operator=(const AudioVoiceManager&) = delete;
+
+        /// <summary>
+        /// Starts a voice, it takes a free source or steals the lowest ranked one if it ranks higher, otherwise it
+        /// starts virtual. Returns the voice handle, 0 if the voice cap was hit & the voice ranked the lowest.
+        /// </summary>
+        uint32 Play(unsigned int buffer, float duration, const AudioVoiceParams& params, uint8 priority = 128);
+
+        void Stop(uint32 voice);
+        void StopAll();
+
+        /// <summary>
+        /// Audibility is reevaluated on the next update.
+        /// </summary>
+        void SetParams(uint32 voice, const AudioVoiceParams& params);
+
+        /// <summary>
+        /// Retires the finished voices, advances the virtual ones & redistributes the sources by rank.
+        /// </summary>
+        void Update(float deltaTime);
+
+        /// <summary>
+        /// False if the voice finished, was stopped or dropped.
+        /// </summary>
+        bool IsPlaying(uint32 voice) const;
+
+        /// <summary>
+        /// False if the voice holds a source.
+        /// </summary>
+        bool IsVirtual(uint32 voice) const;
+
+        /// <summary>
+        /// Playback position in seconds, tracked for virtual voices too.
+        /// </summary>
+        float GetPosition(uint32 voice) const;
+
+        AudioVoiceStats GetStats() const;
+
+        inline void SetListenerPosition(const Vector3& position)
+        {
+            m_listenerPosition = position;
+        }
+
+        /// <summary>
+        /// Voices quieter than this after attenuation are virtualized even if a source is free.
+        /// </summary>
+        inline void SetAudibilityThreshold(float threshold)
+        {
+            m_audibilityThreshold = threshold;
+        }
+
+        /// <summary>
+        /// Same as AL_REFERENCE_DISTANCE & AL_ROLLOFF_FACTOR of the inverse distance clamped model the sources use.
+        /// </summary>
+        inline void SetAttenuation(float referenceDistance, float rolloff)
+        {
+            m_referenceDistance = referenceDistance;
+            m_rolloff           = rolloff;
+        }
+
+    private:
+        struct Voice
+        {
+            AudioVoiceParams m_params;
+            unsigned int     m_buffer     = 0;
+            uint32           m_id         = 0;
+            int              m_source     = -1;
+            float            m_duration   = 0.0f;
+            float            m_position   = 0.0f;
+            float            m_age        = 0.0f;
+            float            m_audibility = 0.0f;
+            uint8            m_priority   = 0;
+        };
+
+        float ComputeAudibility(const Voice& voice) const;
+        bool  IsAudible(const Voice& voice) const;
+
+        /// <summary>
+        /// Priority, audibility, then the newer voice wins. Ties go to the voice holding a source, then the older handle.
+        /// </summary>
+        static bool Outranks(const Voice& a, const Voice& b);
+
+        void Bind(Voice& voice, uint32 source);
+        void Unbind(Voice& voice);
+        void Remove(uint32 index);
+
+        /// <summary>
+        /// Index of the lowest ranked voice, holding a source if realOnly. -1 if there is none.
+        /// </summary>
+        int FindLowest(bool realOnly) const;
+
+    private:
+        AudioVoiceDevice*                  m_device = nullptr;
+        std::vector<Voice>                 m_voices;
+        std::unordered_map<uint32, uint32> m_voiceIndices;
+        std::vector<uint32>                m_freeSources;
+        std::vector<uint32>                m_order;
+        AudioVoiceStats                    m_stats;
+        Vector3                            m_listenerPosition    = Vector3::Zero;
+        uint32                             m_sourceCount         = 0;
+        uint32                             m_maxVoices           = 0;
+        uint32                             m_nextId              = 1;
+        float                              m_audibilityThreshold = 0.01f;
+        float                              m_referenceDistance   = 1.0f;
+        float                              m_rolloff             = 1.0f;
+    };
+} // namespace Lina::Audio
+
+#endif
@@ -0,0 +1,112 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: FakeAudioStreamSink
+
+Audio stream sink without a device. Behaves like an OpenAL source with queued buffers, but playback only moves
+when Advance is called, which makes stream runs reproducible. Played frames can be recorded to check them.
+
+Timestamp: 2/10/2022 2:14:51 PM
+*/
+
+#pragma once
+
+#ifndef FakeAudioStreamSink_HPP
+#define FakeAudioStreamSink_HPP
+
+// Headers here.
+#include "Audio/AudioStream.hpp"
+
+#include <deque>
+#include <vector>
+
+namespace Lina::Audio
+{
+    class FakeAudioStreamSink : public AudioStreamSink
+    {
+
+    public:
+        FakeAudioStreamSink(uint32 bufferCount = 4);
+        virtual ~FakeAudioStreamSink() = default;
+
+        virtual uint32 GetBufferCount() const override
+        {
+            return (uint32)m_buffers.size();
+        }
+
+        virtual void   Queue(uint32 buffer, const int16* samples, uint32 frames, uint32 channels, uint32 sampleRate) override;
+        virtual uint32 Unqueue(uint32* buffers, uint32 maxCount) override;
+        virtual void   Flush() override;
+        virtual bool   IsPlaying() const override;
+        virtual void   Play() override;
+        virtual void   Pause() override;
+
+        /// <summary>
+        /// Plays up to the given number of frames from the queue, a buffer is processed once all of its frames are played.
+        /// Stops when the queue runs dry. Returns the number of frames played.
+        /// </summary>
+        uint32 Advance(uint32 frames);
+
+        inline void SetRecording(bool record)
+        {
+            m_record = record;
+        }
+
+        /// <summary>
+        /// Interleaved samples played since the last ClearPlayed, if recording.
+        /// </summary>
+        inline const std::vector<int16>& GetPlayed() const
+        {
+            return m_played;
+        }
+
+        inline void ClearPlayed()
+        {
+            m_played.clear();
+        }
+
+    private:
+        struct Buffer
+        {
+            std::vector<int16> m_samples;
+            uint32             m_frames   = 0;
+            uint32             m_channels = 0;
+        };
+
+        std::vector<Buffer> m_buffers;
+        std::deque<uint32>  m_queue;
+        std::deque<uint32>  m_processed;
+        std::vector<int16>  m_played;
+        uint32              m_cursor  = 0;
+        bool                m_playing = false;
+        bool                m_record  = true;
+    };
+} // namespace Lina::Audio
+
+#endif
@@ -0,0 +1,98 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: NullAudioVoiceDevice
+
+Voice device without an audio device, sources only keep their state & playback moves when Advance is called.
+Has a source limit like a real device, so running out of sources can be reproduced.
+
+Timestamp: 2/11/2022 11:40:17 AM
+*/
+
+#pragma once
+
+#ifndef NullAudioVoiceDevice_HPP
+#define NullAudioVoiceDevice_HPP
+
+// Headers here.
+#include "Audio/AudioVoiceManager.hpp"
+
+#include <vector>
+
+namespace Lina::Audio
+{
+    class NullAudioVoiceDevice : public AudioVoiceDevice
+    {
+
+    public:
+        NullAudioVoiceDevice(uint32 maxSources = 256) : m_maxSources(maxSources)
+        {
+        }
+        virtual ~NullAudioVoiceDevice() = default;
+
+        virtual uint32 CreateSources(uint32 count) override;
+        virtual void   DestroySources() override;
+        virtual void   Play(uint32 source, unsigned int buffer, float duration, float offset, const AudioVoiceParams& params) override;
+        virtual void   Stop(uint32 source) override;
+        virtual void   SetParams(uint32 source, const AudioVoiceParams& params) override;
+        virtual bool   IsPlaying(uint32 source) const override;
+        virtual float  GetOffset(uint32 source) const override;
+
+        /// <summary>
+        /// Moves the playing sources forward, non looping ones stop at the end of their buffer.
+        /// </summary>
+        void Advance(float deltaTime);
+
+        /// <summary>
+        /// Buffer bound to the source, 0 if it isn't playing.
+        /// </summary>
+        unsigned int GetBuffer(uint32 source) const;
+
+        inline uint64 GetPlayCount() const
+        {
+            return m_playCount;
+        }
+
+    private:
+        struct Source
+        {
+            AudioVoiceParams m_params;
+            unsigned int     m_buffer   = 0;
+            float            m_duration = 0.0f;
+            float            m_offset   = 0.0f;
+            bool             m_playing  = false;
+        };
+
+        std::vector<Source> m_sources;
+        uint32              m_maxSources = 0;
+        uint64              m_playCount  = 0;
+    };
+} // namespace Lina::Audio
+
+#endif
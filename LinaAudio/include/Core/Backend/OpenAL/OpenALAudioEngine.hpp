@@ -39,12 +39,17 @@ Timestamp: 5/1/2019 2:35:28 AM
 #ifndef AudioEngine_HPP
 #define AudioEngine_HPP
 
+#include "Audio/AudioStream.hpp"
+#include "Audio/AudioVoiceManager.hpp"
+#include "Core/Backend/OpenAL/OpenALVoiceDevice.hpp"
 #include "Math/Vector.hpp"
 #include "Utility/StringId.hpp"
 
 #include <map>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 struct ALCcontext;
 struct ALCdevice;
@@ -72,14 +77,50 @@ namespace Lina::Audio
     class OpenALAudioEngine
     {
     public:
-        void                      PlayOneShot(Audio* audio, float gain = 1.0f, bool looping = false, float pitch = 1.0f, Vector3 position = Vector3::Zero, Vector3 velocity = Vector3::Zero);
+        /// <summary>
+        /// Plays the audio on a voice of the pool, see AudioVoiceManager for how sources are shared. Returns the voice
+        /// handle, 0 if the voice was dropped. Streamed audio is played through a stream that is released once it stops,
+        /// 0 is returned for it.
+        /// </summary>
+        uint32 PlayOneShot(Audio* audio, float gain = 1.0f, bool looping = false, float pitch = 1.0f, Vector3 position = Vector3::Zero, Vector3 velocity = Vector3::Zero, uint8 priority = 128);
+
+        /// <summary>
+        /// Starts a stream on streamed audio, the stream is owned by the engine & kept until ReleaseStream, so it can be
+        /// paused, seeked & played again. Returns nullptr if the audio can't be decoded.
+        /// </summary>
+        AudioStream* PlayStream(Audio* audio, float gain = 1.0f, bool looping = false, float pitch = 1.0f, Vector3 position = Vector3::Zero);
+
+        void ReleaseStream(AudioStream* stream);
+
+        /// <summary>
+        /// Moves the OpenAL listener, voices are ranked by their distance to it.
+        /// </summary>
+        void SetListenerPosition(const Vector3& position);
+
+        inline AudioVoiceManager* GetVoiceManager()
+        {
+            return m_voiceManager.get();
+        }
+
         static OpenALAudioEngine* Get()
         {
             return s_audioEngine;
         }
 
+        static const uint32 StreamBufferCount  = 4;
+        static const uint32 StreamBufferFrames = 16384;
+        static const uint32 VoiceSourceCount   = 32;
+        static const uint32 MaxVoices          = 256;
+
     private:
-        void ListAudioDevices(const char* type, const char* list);
+        struct StreamInstance
+        {
+            std::unique_ptr<AudioStream> m_stream;
+            bool                         m_releaseWhenStopped = false;
+        };
+
+        void         ListAudioDevices(const char* type, const char* list);
+        AudioStream* CreateStream(Audio* audio, float gain, bool looping, float pitch, Vector3 position, bool releaseWhenStopped);
 
     private:
         friend class Engine;
@@ -88,13 +129,20 @@ namespace Lina::Audio
         void Initialize();
         void Shutdown();
 
+        /// <summary>
+        /// Feeds the streams & updates the voices, called every frame, paused or not.
+        /// </summary>
+        void Tick(float deltaTime);
+
     private:
-        static OpenALAudioEngine*            s_audioEngine;
-        mutable std::mutex                   m_mutex;
-        ALCcontext*                          m_context             = nullptr;
-        ALCdevice*                           m_device              = nullptr;
-        Vector3                              m_mainListenerLastPos = Vector3::Zero;
-        std::map<StringIDType, unsigned int> m_generatedSources;
+        static OpenALAudioEngine*          s_audioEngine;
+        mutable std::mutex                 m_mutex;
+        ALCcontext*                        m_context             = nullptr;
+        ALCdevice*                         m_device              = nullptr;
+        Vector3                            m_mainListenerLastPos = Vector3::Zero;
+        OpenALVoiceDevice                  m_voiceDevice;
+        std::unique_ptr<AudioVoiceManager> m_voiceManager;
+        std::vector<StreamInstance>        m_streams;
     };
 } // namespace Lina::Audio
 
@@ -0,0 +1,83 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: OpenALStreamSink
+
+Audio stream sink queuing the stream's buffers on an OpenAL source with alSourceQueueBuffers. Owns the source &
+one AL buffer for each slot of the stream's ring.
+
+Timestamp: 2/10/2022 1:26:05 PM
+*/
+
+#pragma once
+
+#ifndef OpenALStreamSink_HPP
+#define OpenALStreamSink_HPP
+
+// Headers here.
+#include "Audio/AudioStream.hpp"
+
+#include <vector>
+
+namespace Lina::Audio
+{
+    class OpenALStreamSink : public AudioStreamSink
+    {
+
+    public:
+        OpenALStreamSink(uint32 bufferCount = 4);
+        virtual ~OpenALStreamSink();
+
+        virtual uint32 GetBufferCount() const override
+        {
+            return (uint32)m_buffers.size();
+        }
+
+        virtual void   Queue(uint32 buffer, const int16* samples, uint32 frames, uint32 channels, uint32 sampleRate) override;
+        virtual uint32 Unqueue(uint32* buffers, uint32 maxCount) override;
+        virtual void   Flush() override;
+        virtual bool   IsPlaying() const override;
+        virtual void   Play() override;
+        virtual void   Pause() override;
+
+        /// <summary>
+        /// Source the buffers are queued on, for gain, pitch & 3D parameters.
+        /// </summary>
+        inline unsigned int GetSource() const
+        {
+            return m_source;
+        }
+
+    private:
+        std::vector<unsigned int> m_buffers;
+        unsigned int              m_source = 0;
+    };
+} // namespace Lina::Audio
+
+#endif
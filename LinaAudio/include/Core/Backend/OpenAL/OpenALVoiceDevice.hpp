@@ -0,0 +1,72 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: OpenALVoiceDevice
+
+Voice device playing the voice manager's pool on OpenAL sources.
+
+Timestamp: 2/11/2022 12:15:42 PM
+*/
+
+#pragma once
+
+#ifndef OpenALVoiceDevice_HPP
+#define OpenALVoiceDevice_HPP
+
+// Headers here.
+#include "Audio/AudioVoiceManager.hpp"
+
+#include <vector>
+
+namespace Lina::Audio
+{
+    class OpenALVoiceDevice : public AudioVoiceDevice
+    {
+
+    public:
+        OpenALVoiceDevice() = default;
+        virtual ~OpenALVoiceDevice();
+
+        /// <summary>
+        /// Sources are generated one at a time until the implementation refuses, drivers have their own limits.
+        /// </summary>
+        virtual uint32 CreateSources(uint32 count) override;
+        virtual void   DestroySources() override;
+        virtual void   Play(uint32 source, unsigned int buffer, float duration, float offset, const AudioVoiceParams& params) override;
+        virtual void   Stop(uint32 source) override;
+        virtual void   SetParams(uint32 source, const AudioVoiceParams& params) override;
+        virtual bool   IsPlaying(uint32 source) const override;
+        virtual float  GetOffset(uint32 source) const override;
+
+    private:
+        std::vector<unsigned int> m_sources;
+    };
+} // namespace Lina::Audio
+
+#endif
@@ -27,6 +27,7 @@ SOFTWARE.
 */
 
 #include "Audio/Audio.hpp"
+#include "Audio/AudioDecoder.hpp"
 #include "Resources/ResourceStorage.hpp"
 #include "Log/Log.hpp"
 #include "Utility/UtilityFunctions.hpp"
@@ -35,18 +36,28 @@ SOFTWARE.
 #include <AL/alc.h>
 #include <AL/alut.h>
 #include <cereal/archives/portable_binary.hpp>
+#include <filesystem>
 #include <fstream>
 
 namespace Lina::Audio
 {
     Audio::~Audio()
     {
-        alDeleteBuffers(1, &m_buffer);
+        if (m_buffer != 0)
+            alDeleteBuffers(1, &m_buffer);
     }
 
     void* Audio::LoadFromMemory(const std::string& path, unsigned char* data, size_t dataSize)
     {
         LINA_TRACE("[Audio Loader - Memory] -> Loading: {0}", path);
+
+        // The image is kept, streams decode from it.
+        if (SetupStreaming(path, dataSize))
+        {
+            m_fileData.assign(data, data + dataSize);
+            return static_cast<void*>(this);
+        }
+
         ALsizei size;
         ALfloat freq;
         ALenum  format;
@@ -67,6 +78,7 @@ namespace Lina::Audio
         alGenBuffers((ALuint)1, &m_buffer);
         alBufferData(m_buffer, format, aldata, size, (ALsizei)freq);
         free(aldata);
+        m_duration = GetBufferDuration(m_buffer);
 
 #ifndef LINA_PRODUCTION_BUILD
         CheckForError();
@@ -79,6 +91,13 @@ namespace Lina::Audio
     {
         LINA_TRACE("[Audio Loader - File] -> Loading: {0}", path);
         IResource::SetSID(path);
+
+        std::error_code error;
+        const uintmax_t fileSize = std::filesystem::file_size(path, error);
+
+        if (!error && SetupStreaming(path, (size_t)fileSize))
+            return static_cast<void*>(this);
+
         ALsizei size;
         ALfloat freq;
         ALenum  format;
@@ -99,6 +118,7 @@ namespace Lina::Audio
         alGenBuffers((ALuint)1, &m_buffer);
         alBufferData(m_buffer, format, data, size, (ALsizei)freq);
         free(data);
+        m_duration = GetBufferDuration(m_buffer);
 
 #ifndef LINA_PRODUCTION_BUILD
         CheckForError();
@@ -107,6 +127,48 @@ namespace Lina::Audio
         return static_cast<void*>(this);
     }
 
+    bool Audio::SetupStreaming(const std::string& path, size_t fileSize)
+    {
+        // Short wav files are still loaded into a single buffer, formats without a streaming decoder are left to alut.
+        const std::string extension = Utility::ToLower(Utility::GetFileExtension(path));
+
+        if (!AudioDecoder::IsSupported(extension) || (extension == "wav" && fileSize < StreamThreshold))
+            return false;
+
+        m_isStreamed = true;
+        m_path       = path;
+
+        const std::string fileNameNoExt = Utility::GetFileWithoutExtension(path);
+        const std::string assetDataPath = fileNameNoExt + ".linaaudiodata";
+        GetCreateAssetdata<AudioAssetData>(assetDataPath, m_assetData);
+        return true;
+    }
+
+    float Audio::GetBufferDuration(unsigned int buffer)
+    {
+        ALint size = 0, channels = 0, bits = 0, frequency = 0;
+        alGetBufferi(buffer, AL_SIZE, &size);
+        alGetBufferi(buffer, AL_CHANNELS, &channels);
+        alGetBufferi(buffer, AL_BITS, &bits);
+        alGetBufferi(buffer, AL_FREQUENCY, &frequency);
+
+        if (channels <= 0 || bits <= 0 || frequency <= 0)
+            return 0.0f;
+
+        return (float)size / (float)(channels * (bits / 8) * frequency);
+    }
+
+    std::unique_ptr<AudioDecoder> Audio::CreateDecoder() const
+    {
+        if (!m_isStreamed)
+            return nullptr;
+
+        if (!m_fileData.empty())
+            return AudioDecoder::Create(m_path, m_fileData.data(), m_fileData.size());
+
+        return AudioDecoder::Create(m_path);
+    }
+
     void Audio::CheckForError()
     {
         ALCenum error;
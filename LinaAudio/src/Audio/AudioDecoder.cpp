@@ -0,0 +1,300 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Audio/AudioDecoder.hpp"
+
+#include "Log/Log.hpp"
+#include "Utility/UtilityFunctions.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <stb/stb_vorbis.c>
+
+namespace Lina::Audio
+{
+    namespace
+    {
+        uint32 ReadLE16(const uint8* bytes)
+        {
+            return (uint32)bytes[0] | ((uint32)bytes[1] << 8);
+        }
+
+        uint32 ReadLE32(const uint8* bytes)
+        {
+            return (uint32)bytes[0] | ((uint32)bytes[1] << 8) | ((uint32)bytes[2] << 16) | ((uint32)bytes[3] << 24);
+        }
+    } // namespace
+
+    std::unique_ptr<AudioDecoder> AudioDecoder::Create(const std::string& path)
+    {
+        const std::string extension = Utility::ToLower(Utility::GetFileExtension(path));
+
+        if (extension == "wav")
+        {
+            std::unique_ptr<WavDecoder> decoder = std::make_unique<WavDecoder>();
+            if (decoder->Open(path))
+                return decoder;
+        }
+        else if (extension == "ogg")
+        {
+            std::unique_ptr<VorbisDecoder> decoder = std::make_unique<VorbisDecoder>();
+            if (decoder->Open(path))
+                return decoder;
+        }
+        else
+            LINA_ERR("[Audio Decoder] -> No streaming decoder for {0} files, can't stream {1}", extension, path);
+
+        return nullptr;
+    }
+
+    std::unique_ptr<AudioDecoder> AudioDecoder::Create(const std::string& path, const unsigned char* data, size_t dataSize)
+    {
+        const std::string extension = Utility::ToLower(Utility::GetFileExtension(path));
+
+        if (extension == "wav")
+        {
+            std::unique_ptr<WavDecoder> decoder = std::make_unique<WavDecoder>();
+            if (decoder->Open(data, dataSize))
+                return decoder;
+        }
+        else if (extension == "ogg")
+        {
+            std::unique_ptr<VorbisDecoder> decoder = std::make_unique<VorbisDecoder>();
+            if (decoder->Open(data, dataSize))
+                return decoder;
+        }
+        else
+            LINA_ERR("[Audio Decoder] -> No streaming decoder for {0} files, can't stream {1}", extension, path);
+
+        return nullptr;
+    }
+
+    bool AudioDecoder::IsSupported(const std::string& extension)
+    {
+        const std::string lower = Utility::ToLower(extension);
+        return lower == "wav" || lower == "ogg";
+    }
+
+    bool WavDecoder::Open(const std::string& path)
+    {
+        m_file.open(path, std::ios::binary);
+
+        if (!m_file.is_open())
+        {
+            LINA_ERR("[Wav Decoder] -> Could not open {0}", path);
+            return false;
+        }
+
+        if (!ParseHeader())
+        {
+            LINA_ERR("[Wav Decoder] -> {0} is not an 8 or 16 bit PCM mono or stereo wav file.", path);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool WavDecoder::Open(const unsigned char* data, size_t dataSize)
+    {
+        m_fromMemory = true;
+        m_memory.assign(data, data + dataSize);
+
+        if (!ParseHeader())
+        {
+            LINA_ERR("[Wav Decoder] -> Memory image is not an 8 or 16 bit PCM mono or stereo wav file.");
+            return false;
+        }
+
+        return true;
+    }
+
+    bool WavDecoder::ParseHeader()
+    {
+        uint8 riff[12];
+        if (ReadBytes(0, riff, sizeof(riff)) != sizeof(riff) || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0)
+            return false;
+
+        // Chunks are walked until the data chunk, fmt always comes before it.
+        uint64 offset   = 12;
+        bool   foundFmt = false;
+
+        while (true)
+        {
+            uint8 chunk[8];
+            if (ReadBytes(offset, chunk, sizeof(chunk)) != sizeof(chunk))
+                return false;
+
+            const uint32 chunkSize = ReadLE32(chunk + 4);
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0)
+            {
+                uint8 fmt[16];
+                if (chunkSize < sizeof(fmt) || ReadBytes(offset + 8, fmt, sizeof(fmt)) != sizeof(fmt))
+                    return false;
+
+                // 1 is PCM, 0xFFFE is extensible, which is PCM as well for the bit depths accepted here.
+                const uint32 format = ReadLE16(fmt);
+                m_channels          = ReadLE16(fmt + 2);
+                m_sampleRate        = ReadLE32(fmt + 4);
+                m_bytesPerFrame     = ReadLE16(fmt + 12);
+                m_bitsPerSample     = ReadLE16(fmt + 14);
+                foundFmt            = (format == 1 || format == 0xFFFE) && (m_bitsPerSample == 8 || m_bitsPerSample == 16) && (m_channels == 1 || m_channels == 2);
+
+                if (!foundFmt || m_bytesPerFrame != m_channels * m_bitsPerSample / 8)
+                    return false;
+            }
+            else if (std::memcmp(chunk, "data", 4) == 0)
+            {
+                if (!foundFmt)
+                    return false;
+
+                m_dataOffset  = offset + 8;
+                m_totalFrames = chunkSize / m_bytesPerFrame;
+                m_frame       = 0;
+                return true;
+            }
+
+            // Chunks are padded to even sizes.
+            offset += 8 + (uint64)chunkSize + (chunkSize & 1);
+        }
+    }
+
+    size_t WavDecoder::ReadBytes(uint64 offset, void* dst, size_t size)
+    {
+        if (m_fromMemory)
+        {
+            if (offset >= m_memory.size())
+                return 0;
+
+            const size_t count = std::min(size, (size_t)(m_memory.size() - offset));
+            std::memcpy(dst, m_memory.data() + offset, count);
+            return count;
+        }
+
+        m_file.clear();
+        m_file.seekg((std::streamoff)offset);
+        m_file.read((char*)dst, (std::streamsize)size);
+        return (size_t)m_file.gcount();
+    }
+
+    uint32 WavDecoder::Read(int16* samples, uint32 frameCount)
+    {
+        const uint32 frames = (uint32)std::min((uint64)frameCount, m_totalFrames - m_frame);
+
+        if (frames == 0)
+            return 0;
+
+        m_readBuffer.resize((size_t)frames * m_bytesPerFrame);
+        const uint32 read = (uint32)(ReadBytes(m_dataOffset + m_frame * m_bytesPerFrame, m_readBuffer.data(), m_readBuffer.size()) / m_bytesPerFrame);
+
+        if (m_bitsPerSample == 16)
+            std::memcpy(samples, m_readBuffer.data(), (size_t)read * m_bytesPerFrame);
+        else
+        {
+            // 8 bit wav samples are unsigned.
+            for (uint32 i = 0; i < read * m_channels; i++)
+                samples[i] = (int16)(((int)m_readBuffer[i] - 128) << 8);
+        }
+
+        m_frame += read;
+        return read;
+    }
+
+    bool WavDecoder::Seek(uint64 frame)
+    {
+        m_frame = std::min(frame, m_totalFrames);
+        return true;
+    }
+
+    VorbisDecoder::~VorbisDecoder()
+    {
+        if (m_vorbis != nullptr)
+            stb_vorbis_close(m_vorbis);
+    }
+
+    bool VorbisDecoder::Open(const std::string& path)
+    {
+        int error = 0;
+        m_vorbis  = stb_vorbis_open_filename(path.c_str(), &error, nullptr);
+
+        if (m_vorbis == nullptr)
+        {
+            LINA_ERR("[Vorbis Decoder] -> Could not open {0}, error {1}", path, error);
+            return false;
+        }
+
+        return ReadInfo();
+    }
+
+    bool VorbisDecoder::Open(const unsigned char* data, size_t dataSize)
+    {
+        // stb_vorbis reads from the image while decoding, so it's kept alive with the decoder.
+        int error = 0;
+        m_memory.assign(data, data + dataSize);
+        m_vorbis = stb_vorbis_open_memory(m_memory.data(), (int)m_memory.size(), &error, nullptr);
+
+        if (m_vorbis == nullptr)
+        {
+            LINA_ERR("[Vorbis Decoder] -> Could not open the memory image, error {0}", error);
+            return false;
+        }
+
+        return ReadInfo();
+    }
+
+    bool VorbisDecoder::ReadInfo()
+    {
+        const stb_vorbis_info info = stb_vorbis_get_info(m_vorbis);
+        m_channels                 = (uint32)info.channels;
+        m_sampleRate               = (uint32)info.sample_rate;
+        m_totalFrames              = stb_vorbis_stream_length_in_samples(m_vorbis);
+
+        if (m_channels != 1 && m_channels != 2)
+        {
+            LINA_ERR("[Vorbis Decoder] -> Only mono & stereo files can be streamed, file has {0} channels.", m_channels);
+            return false;
+        }
+
+        return true;
+    }
+
+    uint32 VorbisDecoder::Read(int16* samples, uint32 frameCount)
+    {
+        return (uint32)stb_vorbis_get_samples_short_interleaved(m_vorbis, (int)m_channels, samples, (int)(frameCount * m_channels));
+    }
+
+    bool VorbisDecoder::Seek(uint64 frame)
+    {
+        // stb_vorbis can't seek past the last sample, the stream clamps seeks to the length anyway.
+        if (m_totalFrames == 0)
+            return false;
+
+        return stb_vorbis_seek(m_vorbis, (unsigned int)std::min(frame, m_totalFrames - 1)) != 0;
+    }
+} // namespace Lina::Audio
@@ -0,0 +1,318 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Audio/AudioStream.hpp"
+
+#include "Audio/AudioDecoder.hpp"
+#include "Log/Log.hpp"
+
+#include <algorithm>
+
+namespace Lina::Audio
+{
+    AudioStream::AudioStream(std::unique_ptr<AudioDecoder> decoder, std::unique_ptr<AudioStreamSink> sink, uint32 bufferFrames, bool decodeOnThread)
+        : m_decoder(std::move(decoder)), m_sink(std::move(sink)), m_bufferFrames(bufferFrames == 0 ? 1 : bufferFrames), m_decodeOnThread(decodeOnThread)
+    {
+        m_channels    = m_decoder->GetChannels();
+        m_sampleRate  = m_decoder->GetSampleRate();
+        m_totalFrames = m_decoder->GetTotalFrames();
+
+        m_slots.resize(m_sink->GetBufferCount());
+        m_unqueued.resize(m_slots.size());
+
+        for (Slot& slot : m_slots)
+            slot.m_samples.resize((size_t)m_bufferFrames * m_channels);
+
+        if (m_decodeOnThread)
+            m_thread = std::thread(&AudioStream::DecodeLoop, this);
+    }
+
+    AudioStream::~AudioStream()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exit = true;
+        }
+
+        m_condition.notify_one();
+
+        if (m_thread.joinable())
+            m_thread.join();
+
+        m_sink->Flush();
+    }
+
+    void AudioStream::Play()
+    {
+        if (m_state == AudioStreamState::Playing)
+            return;
+
+        if (m_state == AudioStreamState::Paused)
+        {
+            if (m_sinkStarted)
+                m_sink->Play();
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Played to the end before, starts over.
+            if (m_endOfStream && m_queuedCount == 0 && m_slots[m_nextQueue].m_state != SlotState::Decoded)
+                Reset(0);
+
+            m_sinkStarted = false;
+            m_isStarved   = false;
+        }
+
+        m_state = AudioStreamState::Playing;
+        Update();
+    }
+
+    void AudioStream::Pause()
+    {
+        if (m_state != AudioStreamState::Playing)
+            return;
+
+        m_sink->Pause();
+        m_state = AudioStreamState::Paused;
+    }
+
+    void AudioStream::Stop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Reset(0);
+        m_state = AudioStreamState::Stopped;
+    }
+
+    void AudioStream::Seek(uint64 frame)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Reset(m_totalFrames > 0 ? std::min(frame, m_totalFrames - 1) : 0);
+    }
+
+    void AudioStream::SeekTime(float seconds)
+    {
+        Seek((uint64)(std::max(seconds, 0.0f) * (float)m_sampleRate));
+    }
+
+    void AudioStream::SetLooping(bool looping)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_looping = looping;
+    }
+
+    AudioStreamStats AudioStream::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    uint64 AudioStream::GetPlaybackFrame() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint32 slotCount = (uint32)m_slots.size();
+
+        if (m_queuedCount > 0)
+            return m_slots[(m_nextQueue + slotCount - m_queuedCount) % slotCount].m_startFrame;
+
+        if (m_slots[m_nextQueue].m_state == SlotState::Decoded)
+            return m_slots[m_nextQueue].m_startFrame;
+
+        return m_endOfStream ? m_totalFrames : m_seekFrame;
+    }
+
+    void AudioStream::Update()
+    {
+        const uint32 slotCount = (uint32)m_slots.size();
+        const uint32 unqueued  = m_sink->Unqueue(m_unqueued.data(), slotCount);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        for (uint32 i = 0; i < unqueued; i++)
+        {
+            m_slots[m_unqueued[i]].m_state = SlotState::Free;
+            m_queuedCount--;
+        }
+
+        if (!m_decodeOnThread)
+        {
+            while (DecodeNext(lock))
+            {
+            }
+        }
+        else if (unqueued > 0)
+            m_condition.notify_one();
+
+        // Slots are queued in decode order, the decoder fills them in the same order.
+        while (m_slots[m_nextQueue].m_state == SlotState::Decoded)
+        {
+            Slot& slot   = m_slots[m_nextQueue];
+            slot.m_state = SlotState::Queued;
+            m_sink->Queue(m_nextQueue, slot.m_samples.data(), slot.m_frames, m_channels, m_sampleRate);
+            m_nextQueue = (m_nextQueue + 1) % slotCount;
+            m_queuedCount++;
+            m_stats.m_queuedBuffers++;
+        }
+
+        if (m_state != AudioStreamState::Playing || m_sink->IsPlaying())
+            return;
+
+        // The sink stops by itself when it runs out of buffers, at the end that's expected, otherwise it's an underrun.
+        if (m_endOfStream && m_queuedCount == 0)
+        {
+            m_state       = AudioStreamState::Stopped;
+            m_sinkStarted = false;
+            return;
+        }
+
+        if (m_sinkStarted && !m_isStarved)
+        {
+            m_isStarved = true;
+            m_stats.m_underruns++;
+            LINA_WARN("[Audio Stream] -> Buffer underrun, decoding fell behind playback ({0} underruns).", m_stats.m_underruns);
+        }
+
+        if (m_queuedCount > 0)
+        {
+            m_sink->Play();
+            m_sinkStarted = true;
+            m_isStarved   = false;
+        }
+    }
+
+    void AudioStream::Reset(uint64 frame)
+    {
+        // A slot being decoded is dropped when the decoder sees the generation changed.
+        m_sink->Flush();
+
+        for (Slot& slot : m_slots)
+            slot.m_state = SlotState::Free;
+
+        m_generation++;
+        m_nextDecode  = 0;
+        m_nextQueue   = 0;
+        m_queuedCount = 0;
+        m_seekFrame   = frame;
+        m_seekPending = true;
+        m_endOfStream = false;
+        m_sinkStarted = false;
+        m_isStarved   = false;
+        m_condition.notify_one();
+    }
+
+    void AudioStream::DecodeLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (!m_exit)
+        {
+            if (!DecodeNext(lock))
+                m_condition.wait(lock);
+        }
+    }
+
+    bool AudioStream::DecodeNext(std::unique_lock<std::mutex>& lock)
+    {
+        Slot& slot = m_slots[m_nextDecode];
+
+        if (m_exit || m_endOfStream || slot.m_state != SlotState::Free)
+            return false;
+
+        const uint32 generation = m_generation;
+        const bool   looping    = m_looping;
+        const bool   seek       = m_seekPending;
+        const uint64 seekFrame  = m_seekFrame;
+        m_seekPending           = false;
+        slot.m_state            = SlotState::Decoding;
+
+        // Only this thread touches the decoder & a slot in decoding state.
+        lock.unlock();
+
+        if (seek)
+        {
+            m_decoder->Seek(seekFrame);
+            m_decodeFrame = seekFrame;
+        }
+
+        slot.m_startFrame = m_decodeFrame;
+
+        uint32 frames  = 0;
+        uint32 loops   = 0;
+        bool   ended   = false;
+        bool   wrapped = false;
+
+        while (frames < m_bufferFrames)
+        {
+            const uint32 read = m_decoder->Read(slot.m_samples.data() + (size_t)frames * m_channels, m_bufferFrames - frames);
+            frames += read;
+            m_decodeFrame += read;
+
+            if (read > 0)
+                wrapped = false;
+
+            if (frames == m_bufferFrames)
+                break;
+
+            // Decoders return less than requested only at the end, an empty read right after wrapping means an empty stream.
+            if (!looping || wrapped)
+            {
+                ended = true;
+                break;
+            }
+
+            m_decoder->Seek(0);
+            m_decodeFrame = 0;
+            wrapped       = true;
+            loops++;
+        }
+
+        if (!looping && m_totalFrames > 0 && m_decodeFrame >= m_totalFrames)
+            ended = true;
+
+        lock.lock();
+
+        // Seeked or stopped while decoding, the slot was already reset.
+        if (generation != m_generation)
+            return true;
+
+        m_stats.m_decodedFrames += frames;
+        m_stats.m_loops += loops;
+        m_endOfStream = ended;
+
+        if (frames > 0)
+        {
+            slot.m_frames = frames;
+            slot.m_state  = SlotState::Decoded;
+            m_nextDecode  = (m_nextDecode + 1) % (uint32)m_slots.size();
+        }
+        else
+            slot.m_state = SlotState::Free;
+
+        return true;
+    }
+} // namespace Lina::Audio
@@ -0,0 +1,335 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Audio/AudioVoiceManager.hpp"
+
+#include "Log/Log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace Lina::Audio
+{
+    AudioVoiceManager::AudioVoiceManager(AudioVoiceDevice* device, uint32 sourceCount, uint32 maxVoices) : m_device(device), m_maxVoices(maxVoices == 0 ? 1 : maxVoices)
+    {
+        m_sourceCount = m_device->CreateSources(sourceCount);
+
+        if (m_sourceCount < sourceCount)
+            LINA_WARN("[Audio Voice Manager] -> Device could create {0} of {1} sources.", m_sourceCount, sourceCount);
+
+        // Popped from the back, source 0 is handed out first.
+        for (uint32 i = m_sourceCount; i > 0; i--)
+            m_freeSources.push_back(i - 1);
+
+        m_voices.reserve(m_maxVoices);
+    }
+
+    AudioVoiceManager::~AudioVoiceManager()
+    {
+        StopAll();
+        m_device->DestroySources();
+    }
+
+    uint32 AudioVoiceManager::Play(unsigned int buffer, float duration, const AudioVoiceParams& params, uint8 priority)
+    {
+        Voice voice;
+        voice.m_params     = params;
+        voice.m_buffer     = buffer;
+        voice.m_id         = m_nextId;
+        voice.m_duration   = duration;
+        voice.m_priority   = priority;
+        voice.m_audibility = ComputeAudibility(voice);
+
+        // Handle 0 is invalid.
+        m_nextId = m_nextId == UINT32_MAX ? 1 : m_nextId + 1;
+
+        if ((uint32)m_voices.size() >= m_maxVoices)
+        {
+            const int lowest = FindLowest(false);
+            m_stats.m_dropped++;
+
+            if (lowest < 0 || Outranks(m_voices[lowest], voice))
+                return 0;
+
+            Remove((uint32)lowest);
+        }
+
+        m_stats.m_played++;
+
+        if (IsAudible(voice))
+        {
+            if (m_freeSources.empty())
+            {
+                const int lowest = FindLowest(true);
+
+                if (lowest >= 0 && Outranks(voice, m_voices[lowest]))
+                {
+                    Unbind(m_voices[lowest]);
+                    m_stats.m_stolen++;
+                }
+            }
+
+            if (!m_freeSources.empty())
+            {
+                const uint32 source = m_freeSources.back();
+                m_freeSources.pop_back();
+                Bind(voice, source);
+            }
+            else
+                m_stats.m_virtualized++;
+        }
+        else
+            m_stats.m_virtualized++;
+
+        m_voiceIndices[voice.m_id] = (uint32)m_voices.size();
+        m_voices.push_back(voice);
+        return voice.m_id;
+    }
+
+    void AudioVoiceManager::Stop(uint32 voice)
+    {
+        auto it = m_voiceIndices.find(voice);
+
+        if (it != m_voiceIndices.end())
+            Remove(it->second);
+    }
+
+    void AudioVoiceManager::StopAll()
+    {
+        while (!m_voices.empty())
+            Remove((uint32)m_voices.size() - 1);
+    }
+
+    void AudioVoiceManager::SetParams(uint32 voice, const AudioVoiceParams& params)
+    {
+        auto it = m_voiceIndices.find(voice);
+
+        if (it == m_voiceIndices.end())
+            return;
+
+        Voice& data   = m_voices[it->second];
+        data.m_params = params;
+
+        if (data.m_source >= 0)
+            m_device->SetParams((uint32)data.m_source, params);
+    }
+
+    void AudioVoiceManager::Update(float deltaTime)
+    {
+        for (uint32 i = 0; i < (uint32)m_voices.size();)
+        {
+            Voice& voice    = m_voices[i];
+            bool   finished = false;
+            voice.m_age += deltaTime;
+
+            if (voice.m_source >= 0)
+            {
+                finished = !m_device->IsPlaying((uint32)voice.m_source);
+
+                if (!finished)
+                    voice.m_position = m_device->GetOffset((uint32)voice.m_source);
+            }
+            else
+            {
+                // Virtual voices advance as if they were playing.
+                voice.m_position += deltaTime * voice.m_params.m_pitch;
+
+                if (voice.m_position >= voice.m_duration)
+                {
+                    if (voice.m_params.m_looping && voice.m_duration > 0.0f)
+                        voice.m_position = std::fmod(voice.m_position, voice.m_duration);
+                    else
+                        finished = true;
+                }
+            }
+
+            if (finished)
+            {
+                Remove(i);
+                m_stats.m_finished++;
+                continue;
+            }
+
+            voice.m_audibility = ComputeAudibility(voice);
+            i++;
+        }
+
+        m_order.resize(m_voices.size());
+        std::iota(m_order.begin(), m_order.end(), 0u);
+        std::sort(m_order.begin(), m_order.end(), [this](uint32 a, uint32 b) { return Outranks(m_voices[a], m_voices[b]); });
+
+        // The highest ranked audible voices get the sources, sources are released first so they can be handed over.
+        uint32 granted = 0;
+
+        for (uint32 index : m_order)
+        {
+            Voice&     voice   = m_voices[index];
+            const bool desired = IsAudible(voice) && granted < m_sourceCount;
+            granted += desired ? 1 : 0;
+
+            if (!desired && voice.m_source >= 0)
+            {
+                Unbind(voice);
+
+                if (IsAudible(voice))
+                    m_stats.m_stolen++;
+                else
+                    m_stats.m_virtualized++;
+            }
+        }
+
+        granted = 0;
+
+        for (uint32 index : m_order)
+        {
+            Voice&     voice   = m_voices[index];
+            const bool desired = IsAudible(voice) && granted < m_sourceCount;
+            granted += desired ? 1 : 0;
+
+            if (desired && voice.m_source < 0)
+            {
+                const uint32 source = m_freeSources.back();
+                m_freeSources.pop_back();
+                Bind(voice, source);
+                m_stats.m_rebound++;
+            }
+        }
+    }
+
+    bool AudioVoiceManager::IsPlaying(uint32 voice) const
+    {
+        return m_voiceIndices.find(voice) != m_voiceIndices.end();
+    }
+
+    bool AudioVoiceManager::IsVirtual(uint32 voice) const
+    {
+        auto it = m_voiceIndices.find(voice);
+        return it != m_voiceIndices.end() && m_voices[it->second].m_source < 0;
+    }
+
+    float AudioVoiceManager::GetPosition(uint32 voice) const
+    {
+        auto it = m_voiceIndices.find(voice);
+        return it != m_voiceIndices.end() ? m_voices[it->second].m_position : 0.0f;
+    }
+
+    AudioVoiceStats AudioVoiceManager::GetStats() const
+    {
+        AudioVoiceStats stats = m_stats;
+        stats.m_sources       = m_sourceCount;
+        stats.m_freeSources   = (uint32)m_freeSources.size();
+        stats.m_realVoices    = m_sourceCount - stats.m_freeSources;
+        stats.m_virtualVoices = (uint32)m_voices.size() - stats.m_realVoices;
+        return stats;
+    }
+
+    float AudioVoiceManager::ComputeAudibility(const Voice& voice) const
+    {
+        const float distance = voice.m_params.m_position.Distance(m_listenerPosition);
+
+        if (m_referenceDistance <= 0.0f || distance <= m_referenceDistance)
+            return voice.m_params.m_gain;
+
+        return voice.m_params.m_gain * m_referenceDistance / (m_referenceDistance + m_rolloff * (distance - m_referenceDistance));
+    }
+
+    bool AudioVoiceManager::IsAudible(const Voice& voice) const
+    {
+        return voice.m_audibility >= m_audibilityThreshold;
+    }
+
+    bool AudioVoiceManager::Outranks(const Voice& a, const Voice& b)
+    {
+        if (a.m_priority != b.m_priority)
+            return a.m_priority > b.m_priority;
+
+        if (a.m_audibility != b.m_audibility)
+            return a.m_audibility > b.m_audibility;
+
+        if (a.m_age != b.m_age)
+            return a.m_age < b.m_age;
+
+        if ((a.m_source >= 0) != (b.m_source >= 0))
+            return a.m_source >= 0;
+
+        return a.m_id < b.m_id;
+    }
+
+    void AudioVoiceManager::Bind(Voice& voice, uint32 source)
+    {
+        voice.m_source = (int)source;
+        m_device->Play(source, voice.m_buffer, voice.m_duration, voice.m_position, voice.m_params);
+    }
+
+    void AudioVoiceManager::Unbind(Voice& voice)
+    {
+        const uint32 source = (uint32)voice.m_source;
+        voice.m_position    = m_device->GetOffset(source);
+        voice.m_source      = -1;
+        m_device->Stop(source);
+        m_freeSources.push_back(source);
+    }
+
+    void AudioVoiceManager::Remove(uint32 index)
+    {
+        Voice& voice = m_voices[index];
+
+        if (voice.m_source >= 0)
+        {
+            m_device->Stop((uint32)voice.m_source);
+            m_freeSources.push_back((uint32)voice.m_source);
+        }
+
+        m_voiceIndices.erase(voice.m_id);
+
+        if (index != (uint32)m_voices.size() - 1)
+        {
+            voice                      = m_voices.back();
+            m_voiceIndices[voice.m_id] = index;
+        }
+
+        m_voices.pop_back();
+    }
+
+    int AudioVoiceManager::FindLowest(bool realOnly) const
+    {
+        int lowest = -1;
+
+        for (uint32 i = 0; i < (uint32)m_voices.size(); i++)
+        {
+            if (realOnly && m_voices[i].m_source < 0)
+                continue;
+
+            if (lowest < 0 || Outranks(m_voices[lowest], m_voices[i]))
+                lowest = (int)i;
+        }
+
+        return lowest;
+    }
+} // namespace Lina::Audio
@@ -0,0 +1,114 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Audio/FakeAudioStreamSink.hpp"
+
+#include <algorithm>
+
+namespace Lina::Audio
+{
+    FakeAudioStreamSink::FakeAudioStreamSink(uint32 bufferCount)
+    {
+        m_buffers.resize(bufferCount == 0 ? 1 : bufferCount);
+    }
+
+    void FakeAudioStreamSink::Queue(uint32 buffer, const int16* samples, uint32 frames, uint32 channels, uint32 sampleRate)
+    {
+        Buffer& data    = m_buffers[buffer];
+        data.m_frames   = frames;
+        data.m_channels = channels;
+        data.m_samples.assign(samples, samples + (size_t)frames * channels);
+        m_queue.push_back(buffer);
+    }
+
+    uint32 FakeAudioStreamSink::Unqueue(uint32* buffers, uint32 maxCount)
+    {
+        uint32 count = 0;
+
+        for (; count < maxCount && !m_processed.empty(); count++)
+        {
+            buffers[count] = m_processed.front();
+            m_processed.pop_front();
+        }
+
+        return count;
+    }
+
+    void FakeAudioStreamSink::Flush()
+    {
+        m_queue.clear();
+        m_processed.clear();
+        m_cursor  = 0;
+        m_playing = false;
+    }
+
+    bool FakeAudioStreamSink::IsPlaying() const
+    {
+        return m_playing;
+    }
+
+    void FakeAudioStreamSink::Play()
+    {
+        // Same as a source without pending buffers, it stops right away.
+        m_playing = !m_queue.empty();
+    }
+
+    void FakeAudioStreamSink::Pause()
+    {
+        m_playing = false;
+    }
+
+    uint32 FakeAudioStreamSink::Advance(uint32 frames)
+    {
+        uint32 played = 0;
+
+        while (m_playing && played < frames && !m_queue.empty())
+        {
+            Buffer&      buffer = m_buffers[m_queue.front()];
+            const uint32 count  = std::min(frames - played, buffer.m_frames - m_cursor);
+
+            if (m_record)
+                m_played.insert(m_played.end(), buffer.m_samples.begin() + (size_t)m_cursor * buffer.m_channels, buffer.m_samples.begin() + (size_t)(m_cursor + count) * buffer.m_channels);
+
+            m_cursor += count;
+            played += count;
+
+            if (m_cursor == buffer.m_frames)
+            {
+                m_processed.push_back(m_queue.front());
+                m_queue.pop_front();
+                m_cursor = 0;
+            }
+        }
+
+        if (m_queue.empty())
+            m_playing = false;
+
+        return played;
+    }
+} // namespace Lina::Audio
@@ -0,0 +1,105 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Audio/NullAudioVoiceDevice.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Lina::Audio
+{
+    uint32 NullAudioVoiceDevice::CreateSources(uint32 count)
+    {
+        m_sources.resize(std::min(count, m_maxSources));
+        return (uint32)m_sources.size();
+    }
+
+    void NullAudioVoiceDevice::DestroySources()
+    {
+        m_sources.clear();
+    }
+
+    void NullAudioVoiceDevice::Play(uint32 source, unsigned int buffer, float duration, float offset, const AudioVoiceParams& params)
+    {
+        Source& data    = m_sources[source];
+        data.m_params   = params;
+        data.m_buffer   = buffer;
+        data.m_duration = duration;
+        data.m_offset   = offset;
+        data.m_playing  = offset < duration || params.m_looping;
+        m_playCount++;
+    }
+
+    void NullAudioVoiceDevice::Stop(uint32 source)
+    {
+        m_sources[source].m_playing = false;
+        m_sources[source].m_offset  = 0.0f;
+    }
+
+    void NullAudioVoiceDevice::SetParams(uint32 source, const AudioVoiceParams& params)
+    {
+        m_sources[source].m_params = params;
+    }
+
+    bool NullAudioVoiceDevice::IsPlaying(uint32 source) const
+    {
+        return m_sources[source].m_playing;
+    }
+
+    float NullAudioVoiceDevice::GetOffset(uint32 source) const
+    {
+        return m_sources[source].m_offset;
+    }
+
+    unsigned int NullAudioVoiceDevice::GetBuffer(uint32 source) const
+    {
+        return m_sources[source].m_playing ? m_sources[source].m_buffer : 0;
+    }
+
+    void NullAudioVoiceDevice::Advance(float deltaTime)
+    {
+        for (Source& source : m_sources)
+        {
+            if (!source.m_playing)
+                continue;
+
+            source.m_offset += deltaTime * source.m_params.m_pitch;
+
+            if (source.m_offset < source.m_duration)
+                continue;
+
+            if (source.m_params.m_looping && source.m_duration > 0.0f)
+                source.m_offset = std::fmod(source.m_offset, source.m_duration);
+            else
+            {
+                source.m_offset  = 0.0f;
+                source.m_playing = false;
+            }
+        }
+    }
+} // namespace Lina::Audio
@@ -29,6 +29,8 @@ SOFTWARE.
 #include "Core/Backend/OpenAL/OpenALAudioEngine.hpp"
 
 #include "Audio/Audio.hpp"
+#include "Audio/AudioDecoder.hpp"
+#include "Core/Backend/OpenAL/OpenALStreamSink.hpp"
 #include "ECS/Registry.hpp"
 #include "EventSystem/EventSystem.hpp"
 #include "EventSystem/ResourceEvents.hpp"
@@ -38,6 +40,7 @@ SOFTWARE.
 #include <AL/al.h>
 #include <AL/alc.h>
 #include <AL/alut.h>
+#include <algorithm>
 #include <fstream>
 
 namespace Lina::Audio
@@ -91,39 +94,92 @@ namespace Lina::Audio
 
         // Init alut
         alutInit(NULL, NULL);
+
+        m_voiceManager = std::make_unique<AudioVoiceManager>(&m_voiceDevice, VoiceSourceCount, MaxVoices);
     }
 
     void OpenALAudioEngine::Shutdown()
     {
         LINA_TRACE("[Shutdown] -> Audio Engine ({0})", typeid(*this).name());
 
-        for (auto& s : m_generatedSources)
-            alDeleteSources((ALuint)1, &s.second);
+        // Joins the decoding threads & deletes the stream sources, then the voice pool.
+        m_streams.clear();
+        m_voiceManager.reset();
+    }
+
+    void OpenALAudioEngine::Tick(float deltaTime)
+    {
+        for (StreamInstance& instance : m_streams)
+            instance.m_stream->Update();
+
+        if (m_voiceManager != nullptr)
+            m_voiceManager->Update(deltaTime);
+
+        m_streams.erase(std::remove_if(m_streams.begin(), m_streams.end(), [](const StreamInstance& instance) { return instance.m_releaseWhenStopped && instance.m_stream->GetState() == AudioStreamState::Stopped; }), m_streams.end());
+    }
 
-        m_generatedSources.clear();
+    AudioStream* OpenALAudioEngine::PlayStream(Audio* audio, float gain, bool looping, float pitch, Vector3 position)
+    {
+        return CreateStream(audio, gain, looping, pitch, position, false);
     }
 
-    void OpenALAudioEngine::PlayOneShot(Audio* audio, float gain, bool looping, float pitch, Vector3 position, Vector3 velocity)
+    void OpenALAudioEngine::ReleaseStream(AudioStream* stream)
     {
-        unsigned int source = -1;
+        m_streams.erase(std::remove_if(m_streams.begin(), m_streams.end(), [stream](const StreamInstance& instance) { return instance.m_stream.get() == stream; }), m_streams.end());
+    }
 
-        StringIDType sid = audio->GetSID();
+    AudioStream* OpenALAudioEngine::CreateStream(Audio* audio, float gain, bool looping, float pitch, Vector3 position, bool releaseWhenStopped)
+    {
+        std::unique_ptr<AudioDecoder> decoder = audio->CreateDecoder();
 
-        if (m_generatedSources.find(sid) == m_generatedSources.end())
+        if (decoder == nullptr)
         {
-            alGenSources((ALuint)1, &source);
-            m_generatedSources[sid] = source;
+            LINA_ERR("[Audio Engine OpenAL] -> Audio can't be streamed, {0}", audio->GetSID());
+            return nullptr;
         }
-        else
-            source = m_generatedSources[sid];
 
+        std::unique_ptr<OpenALStreamSink> sink   = std::make_unique<OpenALStreamSink>(StreamBufferCount);
+        const unsigned int                source = sink->GetSource();
         alSourcef(source, AL_PITCH, pitch);
         alSourcef(source, AL_GAIN, gain);
         alSource3f(source, AL_POSITION, position.x, position.y, position.z);
         alSource3f(source, AL_VELOCITY, 0, 0, 0);
-        alSourcei(source, AL_LOOPING, looping);
-        alSourcei(source, AL_BUFFER, audio->GetBuffer());
-        alSourcePlay(source);
+
+        // Looping is done by the stream, AL_LOOPING on a queue would replay the queued buffers only.
+        StreamInstance& instance      = m_streams.emplace_back();
+        instance.m_stream             = std::make_unique<AudioStream>(std::move(decoder), std::move(sink), StreamBufferFrames);
+        instance.m_releaseWhenStopped = releaseWhenStopped;
+        instance.m_stream->SetLooping(looping);
+        instance.m_stream->Play();
+        return instance.m_stream.get();
+    }
+
+    uint32 OpenALAudioEngine::PlayOneShot(Audio* audio, float gain, bool looping, float pitch, Vector3 position, Vector3 velocity, uint8 priority)
+    {
+        if (audio->IsStreamed())
+        {
+            CreateStream(audio, gain, looping, pitch, position, true);
+            return 0;
+        }
+
+        if (m_voiceManager == nullptr)
+            return 0;
+
+        AudioVoiceParams params;
+        params.m_position = position;
+        params.m_gain     = gain;
+        params.m_pitch    = pitch;
+        params.m_looping  = looping;
+        return m_voiceManager->Play(audio->GetBuffer(), audio->GetDuration(), params, priority);
+    }
+
+    void OpenALAudioEngine::SetListenerPosition(const Vector3& position)
+    {
+        m_mainListenerLastPos = position;
+        alListener3f(AL_POSITION, position.x, position.y, position.z);
+
+        if (m_voiceManager != nullptr)
+            m_voiceManager->SetListenerPosition(position);
     }
 
     void OpenALAudioEngine::ListAudioDevices(const char* type, const char* list)
@@ -0,0 +1,96 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/OpenAL/OpenALStreamSink.hpp"
+
+#include <AL/al.h>
+#include <algorithm>
+
+namespace Lina::Audio
+{
+    OpenALStreamSink::OpenALStreamSink(uint32 bufferCount)
+    {
+        m_buffers.resize(bufferCount == 0 ? 1 : bufferCount);
+        alGenSources((ALuint)1, &m_source);
+        alGenBuffers((ALsizei)m_buffers.size(), m_buffers.data());
+    }
+
+    OpenALStreamSink::~OpenALStreamSink()
+    {
+        Flush();
+        alDeleteSources((ALuint)1, &m_source);
+        alDeleteBuffers((ALsizei)m_buffers.size(), m_buffers.data());
+    }
+
+    void OpenALStreamSink::Queue(uint32 buffer, const int16* samples, uint32 frames, uint32 channels, uint32 sampleRate)
+    {
+        const ALenum format = channels == 2 ? AL_FORMAT_STEREO16 : AL_FORMAT_MONO16;
+        alBufferData(m_buffers[buffer], format, samples, (ALsizei)(frames * channels * sizeof(int16)), (ALsizei)sampleRate);
+        alSourceQueueBuffers(m_source, 1, &m_buffers[buffer]);
+    }
+
+    uint32 OpenALStreamSink::Unqueue(uint32* buffers, uint32 maxCount)
+    {
+        ALint processed = 0;
+        alGetSourcei(m_source, AL_BUFFERS_PROCESSED, &processed);
+
+        uint32 count = 0;
+        for (; count < (uint32)processed && count < maxCount; count++)
+        {
+            ALuint name = 0;
+            alSourceUnqueueBuffers(m_source, 1, &name);
+            buffers[count] = (uint32)(std::find(m_buffers.begin(), m_buffers.end(), name) - m_buffers.begin());
+        }
+
+        return count;
+    }
+
+    void OpenALStreamSink::Flush()
+    {
+        // Stopping marks every queued buffer as processed, detaching the buffer unqueues them all.
+        alSourceStop(m_source);
+        alSourcei(m_source, AL_BUFFER, 0);
+    }
+
+    bool OpenALStreamSink::IsPlaying() const
+    {
+        ALint state = 0;
+        alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+        return state == AL_PLAYING;
+    }
+
+    void OpenALStreamSink::Play()
+    {
+        alSourcePlay(m_source);
+    }
+
+    void OpenALStreamSink::Pause()
+    {
+        alSourcePause(m_source);
+    }
+} // namespace Lina::Audio
@@ -0,0 +1,110 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/OpenAL/OpenALVoiceDevice.hpp"
+
+#include <AL/al.h>
+
+namespace Lina::Audio
+{
+    OpenALVoiceDevice::~OpenALVoiceDevice()
+    {
+        DestroySources();
+    }
+
+    uint32 OpenALVoiceDevice::CreateSources(uint32 count)
+    {
+        alGetError();
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            ALuint source = 0;
+            alGenSources((ALuint)1, &source);
+
+            if (alGetError() != AL_NO_ERROR)
+                break;
+
+            m_sources.push_back(source);
+        }
+
+        return (uint32)m_sources.size();
+    }
+
+    void OpenALVoiceDevice::DestroySources()
+    {
+        if (m_sources.empty())
+            return;
+
+        for (ALuint source : m_sources)
+            alSourceStop(source);
+
+        alDeleteSources((ALsizei)m_sources.size(), m_sources.data());
+        m_sources.clear();
+    }
+
+    void OpenALVoiceDevice::Play(uint32 source, unsigned int buffer, float duration, float offset, const AudioVoiceParams& params)
+    {
+        // Binding a buffer puts the source to the initial state, the offset is applied when it starts playing.
+        const ALuint name = m_sources[source];
+        alSourceStop(name);
+        alSourcei(name, AL_BUFFER, (ALint)buffer);
+        SetParams(source, params);
+        alSourcef(name, AL_SEC_OFFSET, offset);
+        alSourcePlay(name);
+    }
+
+    void OpenALVoiceDevice::Stop(uint32 source)
+    {
+        alSourceStop(m_sources[source]);
+        alSourcei(m_sources[source], AL_BUFFER, 0);
+    }
+
+    void OpenALVoiceDevice::SetParams(uint32 source, const AudioVoiceParams& params)
+    {
+        const ALuint name = m_sources[source];
+        alSourcef(name, AL_PITCH, params.m_pitch);
+        alSourcef(name, AL_GAIN, params.m_gain);
+        alSource3f(name, AL_POSITION, params.m_position.x, params.m_position.y, params.m_position.z);
+        alSource3f(name, AL_VELOCITY, 0, 0, 0);
+        alSourcei(name, AL_LOOPING, params.m_looping ? AL_TRUE : AL_FALSE);
+    }
+
+    bool OpenALVoiceDevice::IsPlaying(uint32 source) const
+    {
+        ALint state = 0;
+        alGetSourcei(m_sources[source], AL_SOURCE_STATE, &state);
+        return state == AL_PLAYING;
+    }
+
+    float OpenALVoiceDevice::GetOffset(uint32 source) const
+    {
+        ALfloat offset = 0.0f;
+        alGetSourcef(m_sources[source], AL_SEC_OFFSET, &offset);
+        return offset;
+    }
+} // namespace Lina::Audio
@@ -40,9 +40,12 @@ Timestamp: 12/25/2021 11:44:20 AM
 #define CommonPhysics_HPP
 
 // Headers here.
+#include "Core/CommonECS.hpp"
+#include "Math/Vector.hpp"
 #include "SizeDefinitions.hpp"
 
 #include <string>
+#include <vector>
 
 namespace Lina::Physics
 {
@@ -67,16 +70,77 @@ namespace Lina::Physics
         ConvexMesh = 4,
     };
 #elif LINA_PHYSICS_PHYSX
-    extern std::string COLLISION_SHAPES[4];
+    extern std::string COLLISION_SHAPES[5];
 
     enum class CollisionShape : uint8
     {
-        Box        = 0,
-        Sphere     = 1,
-        Capsule    = 2,
-        ConvexMesh = 3,
+        Box          = 0,
+        Sphere       = 1,
+        Capsule      = 2,
+        ConvexMesh   = 3,
+        TriangleMesh = 4,
     };
 #endif
+
+    /// <summary>
+    /// Positions & triangle indices of a single model mesh, handed to the physics engine to be cooked.
+    /// Meshes are numbered in the model's node order.
+    /// </summary>
+    struct CollisionMeshSource
+    {
+        const float*  m_positions   = nullptr;
+        const uint32* m_indices     = nullptr;
+        uint32        m_vertexCount = 0;
+        uint32        m_indexCount  = 0;
+    };
+
+    /// <summary>
+    /// Cooked collision streams of a single mesh, stored in the model's asset data.
+    /// </summary>
+    struct CookedCollisionMesh
+    {
+        std::vector<uint8> m_convexData;
+        std::vector<uint8> m_triangleData;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(m_convexData, m_triangleData);
+        }
+    };
+
+    enum class ContactEvent : uint8
+    {
+        Begin   = 0,
+        Persist = 1,
+        End     = 2,
+    };
+
+    /// <summary>
+    /// A pair of bodies that started, kept or stopped touching during a step. Point & normal are of the first contact
+    /// point, the normal points from the second body to the first. Impulse is summed over the reported points.
+    /// Ending contacts carry no points.
+    /// </summary>
+    struct ContactReport
+    {
+        ECS::Entity  m_entity0 = entt::null;
+        ECS::Entity  m_entity1 = entt::null;
+        Vector3      m_point   = Vector3::Zero;
+        Vector3      m_normal  = Vector3::Zero;
+        float        m_impulse = 0.0f;
+        uint32       m_points  = 0;
+        ContactEvent m_event   = ContactEvent::Begin;
+    };
+
+    /// <summary>
+    /// A body that entered or left a trigger body during a step, Persist isn't reported for triggers.
+    /// </summary>
+    struct TriggerReport
+    {
+        ECS::Entity  m_trigger = entt::null;
+        ECS::Entity  m_other   = entt::null;
+        ContactEvent m_event   = ContactEvent::Begin;
+    };
 } // namespace Lina::Physics
 
 #endif
@@ -41,6 +41,7 @@ Timestamp: 12/8/2021 5:35:25 PM
 
 // Headers here.
 #include "Core/CommonECS.hpp"
+#include "Core/SizeDefinitions.hpp"
 #include "ECS/Component.hpp"
 #include "Math/Transformation.hpp"
 
@@ -110,8 +111,15 @@ namespace Lina::ECS
         void           SetLocalScale(const Vector3& scale, bool isThisPivot = true);
         void           SetScale(const Vector3& scale, bool isThisPivot = true);
 
+        /// <summary>
+        /// Sets the global location & rotation in one go, meant for bulk writes such as the physics sync. Children are
+        /// updated in a single pass & Euler angles are only recomputed when they are queried.
+        /// </summary>
+        void SetPose(const Vector3& location, const Quaternion& rotation);
+
         const Vector3& GetLocalRotationAngles()
         {
+            ResolveRotationAngles();
             return m_transform.m_localRotationAngles;
         }
         const Vector3& GetLocalLocation()
@@ -136,6 +144,7 @@ namespace Lina::ECS
         }
         const Vector3& GetRotationAngles()
         {
+            ResolveRotationAngles();
             return m_transform.m_rotationAngles;
         }
         const Vector3& GetScale()
@@ -143,6 +152,14 @@ namespace Lina::ECS
             return m_transform.m_scale;
         }
 
+        /// <summary>
+        /// Incremented every time the local or global transformation changes, store & compare to detect changes.
+        /// </summary>
+        inline uint32 GetTransformVersion() const
+        {
+            return m_transformVersion;
+        }
+
     private:
         void UpdateGlobalLocation();
         void UpdateLocalLocation();
@@ -150,6 +167,19 @@ namespace Lina::ECS
         void UpdateLocalRotation();
         void UpdateGlobalScale();
         void UpdateLocalScale();
+        void UpdateGlobalPose();
+
+        inline void ResolveRotationAngles()
+        {
+            if (m_rotationAnglesDirty)
+                m_transform.m_rotationAngles = m_transform.m_rotation.GetEuler();
+
+            if (m_localRotationAnglesDirty)
+                m_transform.m_localRotationAngles = m_transform.m_localRotation.GetEuler();
+
+            m_rotationAnglesDirty      = false;
+            m_localRotationAnglesDirty = false;
+        }
 
     private:
         friend class cereal::access;
@@ -163,11 +193,15 @@ namespace Lina::ECS
 
         bool m_isTransformLocked = false;
         bool m_wasPreviouslyEnabled = false;
+        bool m_rotationAnglesDirty = false;
+        bool m_localRotationAnglesDirty = false;
+        uint32 m_transformVersion = 0;
         Transformation m_transform;
 
         template <class Archive>
         void serialize(Archive& archive)
         {
+            ResolveRotationAngles();
             archive(m_transform, m_isTransformLocked, m_isEnabled, m_wasPreviouslyEnabled, m_name, m_parent, m_children);
         }
     };
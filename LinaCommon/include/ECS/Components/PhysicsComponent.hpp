@@ -107,9 +107,32 @@ namespace Lina::ECS
         {
             return m_simType;
         }
-        
+
         StringIDType m_attachedModelID = 0;
 
+        /// <summary>
+        /// Collision mesh of the attached model used by mesh shapes, meshes are numbered in the model's node order.
+        /// </summary>
+        uint32 m_attachedMeshIndex = 0;
+
+        /// <summary>
+        /// Scene queries hit the body if their layer mask shares a bit with these, see SetBodyQueryLayers.
+        /// </summary>
+        uint32 m_queryLayers = 1;
+
+        /// <summary>
+        /// Contacts are reported if either body's report mask shares a bit with the other's contact layers, touches that
+        /// persist are only reported if one of them asks for it. See SetBodyContactReports.
+        /// </summary>
+        uint32 m_contactLayers            = 1;
+        uint32 m_contactReportMask        = 0;
+        bool   m_reportPersistentContacts = false;
+
+        /// <summary>
+        /// Trigger bodies don't collide, they report the bodies entering & leaving them, see SetBodyTrigger.
+        /// </summary>
+        bool m_isTrigger = false;
+
     private:
         friend class cereal::access;
         friend class World::Level;
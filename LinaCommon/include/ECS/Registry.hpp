@@ -72,7 +72,7 @@ namespace Lina::ECS
         }
 
         void                    SerializeComponentsInRegistry(cereal::PortableBinaryOutputArchive& archive);
-        void                    DeserializeComponentsInRegistry(cereal::PortableBinaryInputArchive& archive);
+        void                    DeserializeComponentsInRegistry(cereal::PortableBinaryInputArchive& archive, bool isLegacy = false);
         void                    AddChildToEntity(Entity parent, Entity child);
         void                    DestroyAllChildren(Entity parent);
         void                    RemoveChildFromEntity(Entity parent, Entity child);
@@ -40,6 +40,7 @@ Timestamp: 12/25/2021 12:35:15 PM
 #define SystemList_HPP
 
 // Headers here.
+#include "Core/SizeDefinitions.hpp"
 #include <vector>
 
 namespace Lina::ECS
@@ -56,6 +57,11 @@ namespace Lina::ECS
         void UpdateSystems(float delta);
         bool RemoveSystem(System& system);
 
+        /// <summary>
+        /// Updates the systems only the first time it's called for the given frame, returns false if it already ran.
+        /// </summary>
+        bool UpdateSystemsOnce(uint32 frame, float delta);
+
         inline const std::vector<System*>& GetSystems() const
         {
             return m_systems;
@@ -63,6 +69,7 @@ namespace Lina::ECS
 
     private:
         std::vector<System*> m_systems;
+        uint32               m_updatedFrame = UINT32_MAX;
     };
 } // namespace Lina::ECS
 
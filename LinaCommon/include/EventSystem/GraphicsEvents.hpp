@@ -40,6 +40,7 @@ Timestamp: 12/25/2021 12:18:16 PM
 #define GraphicsEvents_HPP
 
 // Headers here.
+#include "Core/SizeDefinitions.hpp"
 #include "Math/Color.hpp"
 #include "Math/Quaternion.hpp"
 
@@ -64,6 +65,19 @@ namespace Lina::Event
         Color   m_color;
         float   m_lineWidth;
     };
+    // Memory layout matches PxDebugLine, colors are packed as ARGB.
+    struct DebugPackedLine
+    {
+        float  m_from[3];
+        uint32 m_fromColor;
+        float  m_to[3];
+        uint32 m_toColor;
+    };
+    struct EDrawLines
+    {
+        const DebugPackedLine* m_lines     = nullptr;
+        uint32                 m_lineCount = 0;
+    };
     struct EDrawBox
     {
         Vector3 m_position;
@@ -39,11 +39,14 @@ Timestamp: 12/25/2021 12:19:08 PM
 #ifndef LevelEvents_HPP
 #define LevelEvents_HPP
 
+#include <string>
+
 namespace Lina::Event
 {
     // Level
     struct ELevelInstalled
     {
+        std::string m_path = ""; // Empty if the level wasn't installed from or saved to a file.
     };
     struct ELevelUninstalled
     {
@@ -54,7 +57,7 @@ namespace Lina::Event
     };
     struct ESerializedLevel
     {
-    
+        std::string m_path = "";
     };
 } // namespace Lina::Event
 
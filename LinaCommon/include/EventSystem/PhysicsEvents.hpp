@@ -40,6 +40,7 @@ Timestamp: 12/25/2021 12:18:08 PM
 #define PhysicsEvents_HPP
 
 // Headers here.
+#include "Core/CommonPhysics.hpp"
 
 namespace Lina::Event
 {
@@ -58,6 +59,18 @@ namespace Lina::Event
         float m_fixedDelta;
         bool  m_isInPlayMode;
     };
+
+    /// <summary>
+    /// Contacts & trigger overlaps of a step, sent once after the step is fetched if there are any. The arrays are
+    /// reused by the next step, copy what needs to outlive the event.
+    /// </summary>
+    struct EPhysicsContacts
+    {
+        const Physics::ContactReport* m_contacts     = nullptr;
+        const Physics::TriggerReport* m_triggers     = nullptr;
+        uint32                        m_contactCount = 0;
+        uint32                        m_triggerCount = 0;
+    };
 } // namespace Lina::Event
 
 #endif
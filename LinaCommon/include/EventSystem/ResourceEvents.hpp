@@ -40,8 +40,12 @@ Timestamp: 12/25/2021 12:18:35 PM
 #define ResourceEvents_HPP
 
 // Headers here.
+#include "Core/CommonPhysics.hpp"
 #include "Core/CommonResources.hpp"
 
+#include <map>
+#include <vector>
+
 namespace Lina::Event
 {
     struct EResourceLoadCompleted
@@ -93,6 +97,18 @@ namespace Lina::Event
         StringIDType m_sid;
     };
 
+    /// <summary>
+    /// Triggered by a model after its meshes are loaded. The physics engine creates the collision meshes from the cache,
+    /// cooks the missing ones into it & sets m_cacheUpdated if the cache needs to be saved.
+    /// </summary>
+    struct EModelCollisionMeshesLoaded
+    {
+        StringIDType                                     m_sid;
+        const std::vector<Physics::CollisionMeshSource>* m_meshes       = nullptr;
+        std::map<uint64, Physics::CookedCollisionMesh>*  m_cache        = nullptr;
+        bool*                                            m_cacheUpdated = nullptr;
+    };
+
 } // namespace Lina::Event
 
 #endif
@@ -39,6 +39,9 @@ Timestamp: 12/19/2020 11:33:56 PM
 #ifndef JobSystem_HPP
 #define JobSystem_HPP
 
+#include "Core/SizeDefinitions.hpp"
+
+#include <atomic>
 #include <taskflow/taskflow.hpp>
 
 namespace Lina
@@ -46,6 +49,57 @@ namespace Lina
     typedef tf::Executor Executor;
     typedef tf::Taskflow TaskFlow;
     template <typename T> using Future = tf::Future<T>;
+
+    /// <summary>
+    /// Executor with a worker per hardware thread, every module runs its parallel work on it instead of owning workers.
+    /// Created on first use.
+    /// </summary>
+    inline Executor& GetSharedExecutor()
+    {
+        static Executor executor;
+        return executor;
+    }
+
+    /// <summary>
+    /// Calls fn(begin, end) for consecutive chunks of [0, count) & waits for all of them. At most maxConcurrency tasks
+    /// are queued, 0 allows one per worker, each task keeps pulling chunks until none are left. Runs on the calling
+    /// thread if a single task is enough.
+    /// </summary>
+    template <typename Fn> void ParallelFor(Executor& executor, uint32 count, uint32 chunkSize, uint32 maxConcurrency, Fn&& fn)
+    {
+        chunkSize           = chunkSize == 0 ? 1 : chunkSize;
+        const uint32 chunks = (count + chunkSize - 1) / chunkSize;
+        uint32       tasks  = (uint32)executor.num_workers();
+
+        if (maxConcurrency != 0 && maxConcurrency < tasks)
+            tasks = maxConcurrency;
+
+        if (chunks < tasks)
+            tasks = chunks;
+
+        if (tasks <= 1)
+        {
+            for (uint32 begin = 0; begin < count; begin += chunkSize)
+                fn(begin, begin + chunkSize < count ? begin + chunkSize : count);
+            return;
+        }
+
+        std::atomic<uint32> nextChunk{0};
+        TaskFlow            taskflow;
+
+        for (uint32 i = 0; i < tasks; i++)
+        {
+            taskflow.emplace([&]() {
+                for (uint32 chunk = nextChunk.fetch_add(1); chunk < chunks; chunk = nextChunk.fetch_add(1))
+                {
+                    const uint32 begin = chunk * chunkSize;
+                    fn(begin, begin + chunkSize < count ? begin + chunkSize : count);
+                }
+            });
+        }
+
+        executor.run(taskflow).wait();
+    }
 } // namespace Lina
 
 #endif
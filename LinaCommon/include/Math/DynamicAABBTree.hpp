@@ -0,0 +1,468 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: DynamicAABBTree
+
+Incrementally maintained bounding volume hierarchy. Leaves store fattened AABBs so small movements don't
+require tree updates, moved proxies are re-inserted & the tree is kept balanced with rotations on the way up.
+Supports AABB, sphere, frustum & ray queries. AABB & frustum queries also have parallel versions which split the
+tree into subtrees & traverse them on an executor.
+
+Timestamp: 1/29/2022 2:31:50 PM
+*/
+
+#pragma once
+
+#ifndef DynamicAABBTree_HPP
+#define DynamicAABBTree_HPP
+
+// Headers here.
+#include "Math/Frustum.hpp"
+#include "Math/Math.hpp"
+#include "Math/Vector.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include "JobSystem/JobSystem.hpp"
+#include <vector>
+
+#define AABBTREE_NULL_NODE -1
+
+namespace Lina
+{
+    enum class AABBTreeQueryResult
+    {
+        Intersects,
+        Inside
+    };
+
+    /// <summary>
+    /// Per subtree results of a parallel query, owned by the caller so the buffers are reused between queries.
+    /// </summary>
+    struct AABBTreeParallelQuery
+    {
+        std::vector<int>              m_roots;
+        std::vector<std::vector<int>> m_inside;
+        std::vector<std::vector<int>> m_intersects;
+    };
+
+    class DynamicAABBTree
+    {
+
+    public:
+        DynamicAABBTree();
+        ~DynamicAABBTree() = default;
+
+        /// <summary>
+        /// Creates a proxy with the given bounds, returned id stays valid until the proxy is destroyed.
+        /// </summary>
+        int  CreateProxy(const Vector3& min, const Vector3& max, uint32 userData);
+        void DestroyProxy(int proxyID);
+
+        /// <summary>
+        /// Updates the bounds of the proxy, returns true if the proxy had to be re-inserted.
+        /// </summary>
+        bool MoveProxy(int proxyID, const Vector3& min, const Vector3& max);
+
+        void Clear();
+
+        /// <summary>
+        /// Collects the nodes at the given depth (or leaves above it), each one can be traversed independently.
+        /// </summary>
+        void GetSubtreeRoots(int depth, std::vector<int>& outRoots) const;
+
+        /// <summary>
+        /// Calls callback(proxyID) for each proxy whose fat bounds overlap the given box.
+        /// Returning false from the callback stops the query.
+        /// </summary>
+        template <typename Callback>
+        void QueryAABB(const Vector3& min, const Vector3& max, Callback&& callback, int startNode = AABBTREE_NULL_NODE) const;
+
+        template <typename Callback>
+        void QuerySphere(const Vector3& center, float radius, Callback&& callback, int startNode = AABBTREE_NULL_NODE) const;
+
+        /// <summary>
+        /// Calls callback(proxyID, AABBTreeQueryResult) for each proxy not completely outside of the frustum.
+        /// Subtrees found to be completely inside are reported without further plane tests.
+        /// </summary>
+        template <typename Callback>
+        void QueryFrustum(const Frustum& frustum, Callback&& callback, int startNode = AABBTREE_NULL_NODE) const;
+
+        /// <summary>
+        /// Same as QueryAABB, but the subtrees are traversed on the executor. Fills outProxies in subtree order.
+        /// </summary>
+        void QueryAABBParallel(Executor& executor, const Vector3& min, const Vector3& max, AABBTreeParallelQuery& query, std::vector<int>& outProxies) const;
+
+        /// <summary>
+        /// Same as QueryFrustum, but the subtrees are traversed on the executor. Proxies in subtrees completely inside the
+        /// frustum go to outInside, the rest to outIntersects, both in subtree order.
+        /// </summary>
+        void QueryFrustumParallel(Executor& executor, const Frustum& frustum, AABBTreeParallelQuery& query, std::vector<int>& outInside, std::vector<int>& outIntersects) const;
+
+        /// <summary>
+        /// Calls callback(proxyID, float distance) for each proxy whose fat bounds are hit by the ray within maxDistance.
+        /// </summary>
+        template <typename Callback>
+        void RayCast(const Vector3& origin, const Vector3& direction, float maxDistance, Callback&& callback, int startNode = AABBTREE_NULL_NODE) const;
+
+        inline uint32 GetUserData(int proxyID) const
+        {
+            return m_nodes[proxyID].m_userData;
+        }
+
+        inline const Vector3& GetFatMin(int proxyID) const
+        {
+            return m_nodes[proxyID].m_min;
+        }
+
+        inline const Vector3& GetFatMax(int proxyID) const
+        {
+            return m_nodes[proxyID].m_max;
+        }
+
+        inline int GetRoot() const
+        {
+            return m_root;
+        }
+
+        inline int GetProxyCount() const
+        {
+            return m_proxyCount;
+        }
+
+        inline void SetFatMargin(float margin)
+        {
+            m_fatMargin = margin;
+        }
+
+        /// <summary>
+        /// Returns the height of the tree, 0 for a single leaf.
+        /// </summary>
+        int GetHeight() const;
+
+        /// <summary>
+        /// Checks the structure & bounds of the whole tree, only used for debugging.
+        /// </summary>
+        bool Validate() const;
+
+    private:
+        struct Node
+        {
+            Vector3 m_min;
+            Vector3 m_max;
+            uint32  m_userData = 0;
+            int     m_parent   = AABBTREE_NULL_NODE; // Used as next for the free list.
+            int     m_child1   = AABBTREE_NULL_NODE;
+            int     m_child2   = AABBTREE_NULL_NODE;
+            int     m_height   = -1;
+
+            inline bool IsLeaf() const
+            {
+                return m_child1 == AABBTREE_NULL_NODE;
+            }
+        };
+
+        /// <summary>
+        /// Traversal stack of the queries, only allocates for trees deeper than the inline capacity.
+        /// </summary>
+        class TraversalStack
+        {
+        public:
+            inline void Push(int node)
+            {
+                if (m_size < InlineCapacity)
+                    m_inline[m_size] = node;
+                else
+                    m_overflow.push_back(node);
+
+                m_size++;
+            }
+
+            inline int Pop()
+            {
+                m_size--;
+
+                if (m_size < InlineCapacity)
+                    return m_inline[m_size];
+
+                const int node = m_overflow.back();
+                m_overflow.pop_back();
+                return node;
+            }
+
+            inline bool IsEmpty() const
+            {
+                return m_size == 0;
+            }
+
+        private:
+            static const int InlineCapacity = 64;
+            int              m_inline[InlineCapacity];
+            std::vector<int> m_overflow;
+            int              m_size = 0;
+        };
+
+        int  AllocateNode();
+        void FreeNode(int node);
+        void InsertLeaf(int leaf);
+        void RemoveLeaf(int leaf);
+        int  Balance(int node);
+        void FixUpwards(int node);
+        bool ValidateNode(int node) const;
+        void PrepareParallelQuery(Executor& executor, AABBTreeParallelQuery& query) const;
+
+        static float GetSurfaceArea(const Vector3& min, const Vector3& max);
+
+        static inline bool Overlaps(const Node& node, const Vector3& min, const Vector3& max)
+        {
+            return node.m_min.x <= max.x && node.m_max.x >= min.x && node.m_min.y <= max.y && node.m_max.y >= min.y && node.m_min.z <= max.z && node.m_max.z >= min.z;
+        }
+
+        static inline bool Contains(const Node& node, const Vector3& min, const Vector3& max)
+        {
+            return node.m_min.x <= min.x && node.m_min.y <= min.y && node.m_min.z <= min.z && max.x <= node.m_max.x && max.y <= node.m_max.y && max.z <= node.m_max.z;
+        }
+
+        template <typename Callback>
+        bool ReportSubtree(int node, Callback& callback) const;
+
+    private:
+        std::vector<Node> m_nodes;
+        int               m_root       = AABBTREE_NULL_NODE;
+        int               m_freeList   = AABBTREE_NULL_NODE;
+        int               m_proxyCount = 0;
+        float             m_fatMargin  = 0.1f;
+    };
+
+    template <typename Callback>
+    void DynamicAABBTree::QueryAABB(const Vector3& min, const Vector3& max, Callback&& callback, int startNode) const
+    {
+        const int      root = startNode == AABBTREE_NULL_NODE ? m_root : startNode;
+        TraversalStack stack;
+
+        if (root == AABBTREE_NULL_NODE)
+            return;
+
+        stack.Push(root);
+
+        while (!stack.IsEmpty())
+        {
+            const int   index = stack.Pop();
+            const Node& node  = m_nodes[index];
+
+            if (!Overlaps(node, min, max))
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (!callback(index))
+                    return;
+            }
+            else
+            {
+                stack.Push(node.m_child1);
+                stack.Push(node.m_child2);
+            }
+        }
+    }
+
+    template <typename Callback>
+    void DynamicAABBTree::QuerySphere(const Vector3& center, float radius, Callback&& callback, int startNode) const
+    {
+        const int      root     = startNode == AABBTREE_NULL_NODE ? m_root : startNode;
+        const float    radiusSq = radius * radius;
+        TraversalStack stack;
+
+        if (root == AABBTREE_NULL_NODE)
+            return;
+
+        stack.Push(root);
+
+        while (!stack.IsEmpty())
+        {
+            const int   index = stack.Pop();
+            const Node& node  = m_nodes[index];
+
+            // Squared distance from the sphere center to the box.
+            const float dx = center.x < node.m_min.x ? node.m_min.x - center.x : (center.x > node.m_max.x ? center.x - node.m_max.x : 0.0f);
+            const float dy = center.y < node.m_min.y ? node.m_min.y - center.y : (center.y > node.m_max.y ? center.y - node.m_max.y : 0.0f);
+            const float dz = center.z < node.m_min.z ? node.m_min.z - center.z : (center.z > node.m_max.z ? center.z - node.m_max.z : 0.0f);
+
+            if (dx * dx + dy * dy + dz * dz > radiusSq)
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (!callback(index))
+                    return;
+            }
+            else
+            {
+                stack.Push(node.m_child1);
+                stack.Push(node.m_child2);
+            }
+        }
+    }
+
+    template <typename Callback>
+    void DynamicAABBTree::QueryFrustum(const Frustum& frustum, Callback&& callback, int startNode) const
+    {
+        const int      root      = startNode == AABBTREE_NULL_NODE ? m_root : startNode;
+        const Plane*   planes[6] = {&frustum.m_left, &frustum.m_right, &frustum.m_top, &frustum.m_bottom, &frustum.m_near, &frustum.m_far};
+        TraversalStack stack;
+
+        if (root == AABBTREE_NULL_NODE)
+            return;
+
+        stack.Push(root);
+
+        while (!stack.IsEmpty())
+        {
+            const int   index = stack.Pop();
+            const Node& node  = m_nodes[index];
+
+            bool outside = false;
+            bool inside  = true;
+
+            for (const Plane* plane : planes)
+            {
+                const Vector3& n        = plane->m_normal;
+                const Vector3  positive = Vector3(n.x >= 0.0f ? node.m_max.x : node.m_min.x, n.y >= 0.0f ? node.m_max.y : node.m_min.y, n.z >= 0.0f ? node.m_max.z : node.m_min.z);
+                const Vector3  negative = Vector3(n.x >= 0.0f ? node.m_min.x : node.m_max.x, n.y >= 0.0f ? node.m_min.y : node.m_max.y, n.z >= 0.0f ? node.m_min.z : node.m_max.z);
+
+                if (n.Dot(positive) + plane->m_distance < 0.0f)
+                {
+                    outside = true;
+                    break;
+                }
+
+                if (n.Dot(negative) + plane->m_distance < 0.0f)
+                    inside = false;
+            }
+
+            if (outside)
+                continue;
+
+            if (inside)
+            {
+                if (!ReportSubtree(index, callback))
+                    return;
+            }
+            else if (node.IsLeaf())
+            {
+                if (!callback(index, AABBTreeQueryResult::Intersects))
+                    return;
+            }
+            else
+            {
+                stack.Push(node.m_child1);
+                stack.Push(node.m_child2);
+            }
+        }
+    }
+
+    template <typename Callback>
+    bool DynamicAABBTree::ReportSubtree(int root, Callback& callback) const
+    {
+        TraversalStack stack;
+        stack.Push(root);
+
+        while (!stack.IsEmpty())
+        {
+            const int   index = stack.Pop();
+            const Node& node  = m_nodes[index];
+
+            if (node.IsLeaf())
+            {
+                if (!callback(index, AABBTreeQueryResult::Inside))
+                    return false;
+            }
+            else
+            {
+                stack.Push(node.m_child1);
+                stack.Push(node.m_child2);
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Callback>
+    void DynamicAABBTree::RayCast(const Vector3& origin, const Vector3& direction, float maxDistance, Callback&& callback, int startNode) const
+    {
+        const int      root = startNode == AABBTREE_NULL_NODE ? m_root : startNode;
+        const Vector3  inv  = Vector3(direction.x != 0.0f ? 1.0f / direction.x : 0.0f, direction.y != 0.0f ? 1.0f / direction.y : 0.0f, direction.z != 0.0f ? 1.0f / direction.z : 0.0f);
+        TraversalStack stack;
+
+        if (root == AABBTREE_NULL_NODE)
+            return;
+
+        stack.Push(root);
+
+        while (!stack.IsEmpty())
+        {
+            const int   index = stack.Pop();
+            const Node& node  = m_nodes[index];
+
+            // Slab test, axes the ray is parallel to only reject origins outside of their slab. Dividing by 0 instead
+            // would give NaN for origins on a bound.
+            float tmin    = 0.0f;
+            float tmax    = maxDistance;
+            bool  outside = false;
+
+            for (int axis = 0; axis < 3 && !outside; axis++)
+            {
+                if (direction[axis] == 0.0f)
+                {
+                    outside = origin[axis] < node.m_min[axis] || origin[axis] > node.m_max[axis];
+                    continue;
+                }
+
+                const float t1 = (node.m_min[axis] - origin[axis]) * inv[axis];
+                const float t2 = (node.m_max[axis] - origin[axis]) * inv[axis];
+                tmin           = Math::Max(tmin, Math::Min(t1, t2));
+                tmax           = Math::Min(tmax, Math::Max(t1, t2));
+            }
+
+            if (outside || tmin > tmax)
+                continue;
+
+            if (node.IsLeaf())
+            {
+                if (!callback(index, tmin))
+                    return;
+            }
+            else
+            {
+                stack.Push(node.m_child1);
+                stack.Push(node.m_child2);
+            }
+        }
+    }
+} // namespace Lina
+
+#endif
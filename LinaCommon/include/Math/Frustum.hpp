@@ -75,14 +75,14 @@ namespace Lina
         /// </summary>
         /// <param name="aabb"></param>
         /// <returns></returns>
-        FrustumTest TestIntersection(const AABB& aabb);
-
-        Plane             m_left;
-        Plane             m_right;
-        Plane             m_bottom;
-        Plane             m_top;
-        Plane             m_near;
-        Plane             m_far;
+        FrustumTest TestIntersection(const AABB& aabb) const;
+
+        Plane m_left;
+        Plane m_right;
+        Plane m_bottom;
+        Plane m_top;
+        Plane m_near;
+        Plane m_far;
     };
 } // namespace Lina
 
@@ -0,0 +1,122 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: FrustumCuller
+
+Tests batches of world-space AABBs against a frustum. Bounds are stored as structure-of-arrays so the SIMD
+kernels can test 4 (SSE) or 8 (AVX) boxes against all 6 planes at once. Results are written into a
+visibility bitset, bit i being set if the i'th box is not completely outside of the frustum. The AVX kernel is
+built on every x64 target without raising the target's instruction set & only picked if the CPU supports it.
+
+Timestamp: 1/28/2022 11:05:41 AM
+*/
+
+#pragma once
+
+#ifndef FrustumCuller_HPP
+#define FrustumCuller_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LINA_FRUSTUM_CULL_SSE
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define LINA_FRUSTUM_CULL_AVX
+#endif
+
+namespace Lina
+{
+    class Frustum;
+    class Vector3;
+
+    struct AABBSoA
+    {
+        std::vector<float> m_centerX;
+        std::vector<float> m_centerY;
+        std::vector<float> m_centerZ;
+        std::vector<float> m_extentX;
+        std::vector<float> m_extentY;
+        std::vector<float> m_extentZ;
+        uint32             m_count = 0;
+
+        void Clear();
+        void Reserve(uint32 count);
+        void Add(const Vector3& center, const Vector3& halfExtent);
+
+        /// <summary>
+        /// Pads the arrays up to the SIMD width, kernels then never need a scalar tail.
+        /// </summary>
+        void Pad();
+    };
+
+    class FrustumCuller
+    {
+
+    public:
+        /// <summary>
+        /// Culls using the widest kernel available for the target, falls back to scalar.
+        /// </summary>
+        static void Cull(const Frustum& frustum, AABBSoA& bounds, std::vector<uint32>& outVisibility);
+
+        /// <summary>
+        /// Reference implementation, SIMD kernels must produce the exact same bitset.
+        /// </summary>
+        static void CullScalar(const Frustum& frustum, const AABBSoA& bounds, std::vector<uint32>& outVisibility);
+
+#ifdef LINA_FRUSTUM_CULL_SSE
+        /// <summary>
+        /// 4 boxes per iteration, pads the bounds.
+        /// </summary>
+        static void CullSSE(const Frustum& frustum, AABBSoA& bounds, std::vector<uint32>& outVisibility);
+#endif
+
+#ifdef LINA_FRUSTUM_CULL_AVX
+        /// <summary>
+        /// 8 boxes per iteration, pads the bounds. Only call if IsAVXSupported returns true.
+        /// </summary>
+        static void CullAVX(const Frustum& frustum, AABBSoA& bounds, std::vector<uint32>& outVisibility);
+
+        /// <summary>
+        /// Returns true if both the CPU & the OS support AVX, checked once.
+        /// </summary>
+        static bool IsAVXSupported();
+#endif
+
+        static inline bool IsVisible(const std::vector<uint32>& visibility, uint32 index)
+        {
+            return (visibility[index >> 5] & (1u << (index & 31))) != 0;
+        }
+    };
+} // namespace Lina
+
+#endif
@@ -85,9 +85,9 @@ namespace Lina
             return Matrix::TransformMatrix(m_localLocation, m_localRotation, m_localScale);
         }
 
-        Vector3 m_previousLocation = Vector3::Zero;
-        Vector3 m_previousAngles   = Vector3::Zero;
-        Vector3 m_previousScale    = Vector3::Zero;
+        Vector3    m_previousLocation = Vector3::Zero;
+        Quaternion m_previousRotation;
+        Vector3    m_previousScale = Vector3::Zero;
 
         Vector3    m_location = Vector3::Zero;
         Quaternion m_rotation;
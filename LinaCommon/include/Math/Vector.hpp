@@ -425,6 +425,10 @@ namespace Lina
         {
             return (&x)[i];
         }
+        float operator[](unsigned int i) const
+        {
+            return (&x)[i];
+        }
         Vector3 operator-() const
         {
             return Vector3(-x, -y, -z);
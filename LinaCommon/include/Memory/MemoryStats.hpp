@@ -0,0 +1,128 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: MemoryStats
+
+Engine wide memory statistics. Subsystems managing memory of their own register named categories & report their
+allocations to them, counters are atomic so they can be updated from any thread. Categories live until the
+process exits, so the pointers can be kept.
+
+Timestamp: 2/9/2022 10:12:35 AM
+*/
+
+#pragma once
+
+#ifndef MemoryStats_HPP
+#define MemoryStats_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace Lina
+{
+    class MemoryCategory
+    {
+
+    public:
+        MemoryCategory(const std::string& name) : m_name(name)
+        {
+        }
+
+        ~MemoryCategory() = default;
+
+        void OnAllocate(uint64 bytes);
+        void OnFree(uint64 bytes);
+
+        inline const std::string& GetName() const
+        {
+            return m_name;
+        }
+
+        /// <summary>
+        /// Bytes currently allocated.
+        /// </summary>
+        inline uint64 GetBytes() const
+        {
+            return m_bytes.load(std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Highest number of bytes allocated at once since the category was registered.
+        /// </summary>
+        inline uint64 GetPeakBytes() const
+        {
+            return m_peakBytes.load(std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Number of allocations that aren't freed yet.
+        /// </summary>
+        inline uint64 GetAllocations() const
+        {
+            return m_allocations.load(std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Number of allocations made since the category was registered.
+        /// </summary>
+        inline uint64 GetTotalAllocations() const
+        {
+            return m_totalAllocations.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::string         m_name;
+        std::atomic<uint64> m_bytes            = 0;
+        std::atomic<uint64> m_peakBytes        = 0;
+        std::atomic<uint64> m_allocations      = 0;
+        std::atomic<uint64> m_totalAllocations = 0;
+    };
+
+    class MemoryStats
+    {
+
+    public:
+        /// <summary>
+        /// Returns the category with the given name, it is created on first use. Names are grouped by their prefix
+        /// in the statistics, e.g. "PhysX/Simulation".
+        /// </summary>
+        static MemoryCategory* GetCategory(const std::string& name);
+
+        /// <summary>
+        /// Fills the categories in the order they were registered.
+        /// </summary>
+        static void GetCategories(std::vector<const MemoryCategory*>& categories);
+    };
+} // namespace Lina
+
+#endif
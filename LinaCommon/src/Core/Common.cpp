@@ -64,7 +64,7 @@ namespace Lina::Physics
 #ifdef LINA_PHYSICS_BULLET
     std::string COLLISION_SHAPES[4] = {"Box", "Sphere", "Cylinder", "Capsule"};
 #elif LINA_PHYSICS_PHYSX
-    std::string COLLISION_SHAPES[4] = {"Box", "Sphere", "Capsule", "ConvexMesh"};
+    std::string COLLISION_SHAPES[5] = {"Box", "Sphere", "Capsule", "ConvexMesh", "TriangleMesh"};
 #endif
 } // namespace Lina::Physics
 
@@ -96,7 +96,7 @@ namespace Lina::ECS
         Transformation t;
         t.m_location = Vector3::Lerp(m_transform.m_previousLocation, m_transform.m_location, interpolation);
         t.m_scale    = Vector3::Lerp(m_transform.m_previousScale, m_transform.m_scale, interpolation);
-        t.m_rotation = Quaternion::Euler(Vector3::Lerp(m_transform.m_previousAngles, m_transform.m_rotation.GetEuler(), interpolation));
+        t.m_rotation = Quaternion::Slerp(m_transform.m_previousRotation, m_transform.m_rotation, interpolation);
         return t;
     }
 
@@ -132,6 +132,8 @@ namespace Lina::ECS
     {
         if (m_isTransformLocked)
             return;
+
+        ResolveRotationAngles();
         m_transform.m_localRotation       = rot;
         m_transform.m_localRotationAngles = rot.GetEuler();
         UpdateGlobalRotation();
@@ -150,6 +152,8 @@ namespace Lina::ECS
     {
         if (m_isTransformLocked)
             return;
+
+        ResolveRotationAngles();
         m_transform.m_localRotationAngles = angles;
         m_transform.m_localRotation       = Quaternion::FromVector(glm::radians((glm::vec3)angles));
         UpdateGlobalRotation();
@@ -168,7 +172,9 @@ namespace Lina::ECS
     {
         if (m_isTransformLocked)
             return;
-        m_transform.m_previousAngles = m_transform.m_rotationAngles;
+
+        ResolveRotationAngles();
+        m_transform.m_previousRotation = m_transform.m_rotation;
         m_transform.m_rotation       = rot;
         m_transform.m_rotationAngles = rot.GetEuler();
         UpdateLocalRotation();
@@ -187,7 +193,9 @@ namespace Lina::ECS
     {
         if (m_isTransformLocked)
             return;
-        m_transform.m_previousAngles = m_transform.m_rotationAngles;
+
+        ResolveRotationAngles();
+        m_transform.m_previousRotation = m_transform.m_rotation;
         m_transform.m_rotationAngles = angles;
         m_transform.m_rotation       = Quaternion::FromVector(glm::radians((glm::vec3)angles));
         UpdateLocalRotation();
@@ -237,11 +245,70 @@ namespace Lina::ECS
         }
     }
 
+    void EntityDataComponent::SetPose(const Vector3& location, const Quaternion& rotation)
+    {
+        if (m_isTransformLocked)
+            return;
+
+        m_transformVersion++;
+        m_transform.m_previousLocation = m_transform.m_location;
+        m_transform.m_previousRotation = m_transform.m_rotation;
+        m_transform.m_location         = location;
+        m_transform.m_rotation         = rotation;
+        m_rotationAnglesDirty          = true;
+        m_localRotationAnglesDirty     = true;
+
+        if (m_parent == entt::null)
+        {
+            m_transform.m_localLocation = location;
+            m_transform.m_localRotation = rotation;
+        }
+        else
+        {
+            auto&  d                    = ECS::Registry::Get()->get<EntityDataComponent>(m_parent);
+            Matrix local                = d.m_transform.ToMatrix().Inverse() * m_transform.ToMatrix();
+            Matrix localRotation        = Matrix::InitRotation(d.m_transform.m_rotation).Inverse() * m_transform.ToMatrix();
+            m_transform.m_localLocation = local.GetTranslation();
+            localRotation.Decompose(Vector3(), m_transform.m_localRotation);
+        }
+
+        for (auto child : m_children)
+        {
+            auto& d = ECS::Registry::Get()->get<EntityDataComponent>(child);
+            d.UpdateGlobalPose();
+        }
+    }
+
+    void EntityDataComponent::UpdateGlobalPose()
+    {
+        if (m_isTransformLocked)
+            return;
+
+        // Children keep their local pose, location & rotation are carried down together instead of in two recursions.
+        m_transformVersion++;
+
+        auto&  d                       = ECS::Registry::Get()->get<EntityDataComponent>(m_parent);
+        Matrix global                  = d.m_transform.ToMatrix() * m_transform.ToLocalMatrix();
+        m_transform.m_previousLocation = m_transform.m_location;
+        m_transform.m_previousRotation = m_transform.m_rotation;
+        m_transform.m_location         = global.GetTranslation();
+        m_transform.m_rotation         = d.m_transform.m_rotation * m_transform.m_localRotation;
+        m_rotationAnglesDirty          = true;
+
+        for (auto child : m_children)
+        {
+            auto& c = ECS::Registry::Get()->get<EntityDataComponent>(child);
+            c.UpdateGlobalPose();
+        }
+    }
+
     void EntityDataComponent::UpdateGlobalLocation()
     {
         if (m_isTransformLocked)
             return;
 
+        m_transformVersion++;
+
         if (m_parent == entt::null)
         {
             m_transform.m_previousLocation = m_transform.m_location;
@@ -268,6 +335,8 @@ namespace Lina::ECS
         if (m_isTransformLocked)
             return;
 
+        m_transformVersion++;
+
         if (m_parent == entt::null)
             m_transform.m_localLocation = m_transform.m_location;
         else
@@ -283,6 +352,8 @@ namespace Lina::ECS
         if (m_isTransformLocked)
             return;
 
+        m_transformVersion++;
+
         if (m_parent == entt::null)
         {
             m_transform.m_previousScale = m_transform.m_scale;
@@ -310,9 +381,13 @@ namespace Lina::ECS
         if (m_isTransformLocked)
             return;
 
+        ResolveRotationAngles();
+
+        m_transformVersion++;
+
         if (m_parent == entt::null)
         {
-            m_transform.m_previousAngles = m_transform.m_rotationAngles;
+            m_transform.m_previousRotation = m_transform.m_rotation;
             m_transform.m_rotation       = m_transform.m_localRotation;
             m_transform.m_rotationAngles = m_transform.m_localRotationAngles;
         }
@@ -322,7 +397,7 @@ namespace Lina::ECS
             Matrix     global = Matrix::InitRotation(d.m_transform.m_rotation) * m_transform.ToLocalMatrix();
             Quaternion targetRot;
             global.Decompose(Vector3(), targetRot);
-            m_transform.m_previousAngles = m_transform.m_rotationAngles;
+            m_transform.m_previousRotation = m_transform.m_rotation;
             m_transform.m_rotation       = targetRot;
             m_transform.m_rotationAngles = m_transform.m_rotation.GetEuler();
         }
@@ -339,6 +414,8 @@ namespace Lina::ECS
         if (m_isTransformLocked)
             return;
 
+        m_transformVersion++;
+
         if (m_parent == entt::null)
             m_transform.m_localScale = m_transform.m_scale;
         else
@@ -354,6 +431,8 @@ namespace Lina::ECS
         if (m_isTransformLocked)
             return;
 
+        m_transformVersion++;
+
         if (m_parent == entt::null)
         {
             m_transform.m_localRotation       = m_transform.m_rotation;
@@ -69,7 +69,7 @@ namespace Lina::ECS
         }
     }
 
-    void Registry::DeserializeComponentsInRegistry(cereal::PortableBinaryInputArchive& archive)
+    void Registry::DeserializeComponentsInRegistry(cereal::PortableBinaryInputArchive& archive, bool isLegacy)
     {
         auto& loader = entt::snapshot_loader{*this};
         loader.entities(archive);
@@ -81,6 +81,14 @@ namespace Lina::ECS
 
             if (resolved)
             {
+                // Components whose layout changed since legacy levels were saved read their old layout & migrate.
+                auto legacyFunc = resolved.func("deserializeLegacy"_hs);
+                if (isLegacy && legacyFunc)
+                {
+                    legacyFunc.invoke({}, entt::forward_as_meta(*this), entt::forward_as_meta(archive));
+                    continue;
+                }
+
                 auto& deserializeFunc = resolved.func("deserialize"_hs);
 
                 if (deserializeFunc)
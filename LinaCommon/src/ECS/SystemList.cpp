@@ -44,6 +44,16 @@ namespace Lina::ECS
             s->UpdateComponents(delta);
     }
 
+    bool SystemList::UpdateSystemsOnce(uint32 frame, float delta)
+    {
+        if (m_updatedFrame == frame)
+            return false;
+
+        m_updatedFrame = frame;
+        UpdateSystems(delta);
+        return true;
+    }
+
     bool SystemList::RemoveSystem(System& system)
     {
         for (unsigned int i = 0; i < m_systems.size(); i++)
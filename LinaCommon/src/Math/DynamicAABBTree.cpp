@@ -0,0 +1,461 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Math/DynamicAABBTree.hpp"
+
+namespace Lina
+{
+    namespace
+    {
+        // Vector3::Min/Max compare lengths, bounds need component-wise results.
+        inline Vector3 GetMin(const Vector3& a, const Vector3& b)
+        {
+            return Vector3(Math::Min(a.x, b.x), Math::Min(a.y, b.y), Math::Min(a.z, b.z));
+        }
+
+        inline Vector3 GetMax(const Vector3& a, const Vector3& b)
+        {
+            return Vector3(Math::Max(a.x, b.x), Math::Max(a.y, b.y), Math::Max(a.z, b.z));
+        }
+
+        // Below this, splitting the traversal costs more than it saves.
+        const int ParallelQueryMinProxies = 2048;
+
+        // Subtrees per worker, so that uneven subtrees still balance out.
+        const uint32 ParallelQuerySubtreesPerWorker = 4;
+    } // namespace
+
+    DynamicAABBTree::DynamicAABBTree()
+    {
+        m_nodes.reserve(64);
+    }
+
+    int DynamicAABBTree::AllocateNode()
+    {
+        if (m_freeList == AABBTREE_NULL_NODE)
+        {
+            m_nodes.push_back(Node());
+            m_freeList = static_cast<int>(m_nodes.size()) - 1;
+        }
+
+        const int index = m_freeList;
+        Node&     node  = m_nodes[index];
+        m_freeList      = node.m_parent;
+        node            = Node();
+        node.m_height   = 0;
+        return index;
+    }
+
+    void DynamicAABBTree::FreeNode(int node)
+    {
+        m_nodes[node].m_parent = m_freeList;
+        m_nodes[node].m_height = -1;
+        m_freeList             = node;
+    }
+
+    int DynamicAABBTree::CreateProxy(const Vector3& min, const Vector3& max, uint32 userData)
+    {
+        const int     proxy       = AllocateNode();
+        const Vector3 margin      = Vector3(m_fatMargin, m_fatMargin, m_fatMargin);
+        m_nodes[proxy].m_min      = min - margin;
+        m_nodes[proxy].m_max      = max + margin;
+        m_nodes[proxy].m_userData = userData;
+        InsertLeaf(proxy);
+        m_proxyCount++;
+        return proxy;
+    }
+
+    void DynamicAABBTree::DestroyProxy(int proxyID)
+    {
+        RemoveLeaf(proxyID);
+        FreeNode(proxyID);
+        m_proxyCount--;
+    }
+
+    bool DynamicAABBTree::MoveProxy(int proxyID, const Vector3& min, const Vector3& max)
+    {
+        // Still inside the fat bounds, nothing to do.
+        if (Contains(m_nodes[proxyID], min, max))
+            return false;
+
+        const Vector3 margin = Vector3(m_fatMargin, m_fatMargin, m_fatMargin);
+        RemoveLeaf(proxyID);
+        m_nodes[proxyID].m_min = min - margin;
+        m_nodes[proxyID].m_max = max + margin;
+        InsertLeaf(proxyID);
+        return true;
+    }
+
+    void DynamicAABBTree::Clear()
+    {
+        m_nodes.clear();
+        m_root       = AABBTREE_NULL_NODE;
+        m_freeList   = AABBTREE_NULL_NODE;
+        m_proxyCount = 0;
+    }
+
+    float DynamicAABBTree::GetSurfaceArea(const Vector3& min, const Vector3& max)
+    {
+        const Vector3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    void DynamicAABBTree::InsertLeaf(int leaf)
+    {
+        if (m_root == AABBTREE_NULL_NODE)
+        {
+            m_root                 = leaf;
+            m_nodes[leaf].m_parent = AABBTREE_NULL_NODE;
+            return;
+        }
+
+        // Find the best sibling by walking down with the surface area heuristic.
+        const Vector3 leafMin = m_nodes[leaf].m_min;
+        const Vector3 leafMax = m_nodes[leaf].m_max;
+        int           index   = m_root;
+
+        while (!m_nodes[index].IsLeaf())
+        {
+            const Node& node        = m_nodes[index];
+            const float area        = GetSurfaceArea(node.m_min, node.m_max);
+            const float combined    = GetSurfaceArea(GetMin(node.m_min, leafMin), GetMax(node.m_max, leafMax));
+            const float cost        = 2.0f * combined;
+            const float inheritance = 2.0f * (combined - area);
+
+            auto childCost = [&](int child) {
+                const Node& c    = m_nodes[child];
+                const float area = GetSurfaceArea(GetMin(c.m_min, leafMin), GetMax(c.m_max, leafMax));
+                return c.IsLeaf() ? area + inheritance : area - GetSurfaceArea(c.m_min, c.m_max) + inheritance;
+            };
+
+            const float cost1 = childCost(node.m_child1);
+            const float cost2 = childCost(node.m_child2);
+
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.m_child1 : node.m_child2;
+        }
+
+        // Create a new parent for the sibling & the leaf.
+        const int sibling   = index;
+        const int oldParent = m_nodes[sibling].m_parent;
+        const int newParent = AllocateNode();
+
+        Node& parent    = m_nodes[newParent];
+        parent.m_parent = oldParent;
+        parent.m_min    = GetMin(m_nodes[sibling].m_min, leafMin);
+        parent.m_max    = GetMax(m_nodes[sibling].m_max, leafMax);
+        parent.m_height = m_nodes[sibling].m_height + 1;
+        parent.m_child1 = sibling;
+        parent.m_child2 = leaf;
+
+        if (oldParent != AABBTREE_NULL_NODE)
+        {
+            if (m_nodes[oldParent].m_child1 == sibling)
+                m_nodes[oldParent].m_child1 = newParent;
+            else
+                m_nodes[oldParent].m_child2 = newParent;
+        }
+        else
+            m_root = newParent;
+
+        m_nodes[sibling].m_parent = newParent;
+        m_nodes[leaf].m_parent    = newParent;
+
+        FixUpwards(m_nodes[leaf].m_parent);
+    }
+
+    void DynamicAABBTree::RemoveLeaf(int leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = AABBTREE_NULL_NODE;
+            return;
+        }
+
+        const int parent      = m_nodes[leaf].m_parent;
+        const int grandParent = m_nodes[parent].m_parent;
+        const int sibling     = m_nodes[parent].m_child1 == leaf ? m_nodes[parent].m_child2 : m_nodes[parent].m_child1;
+
+        if (grandParent != AABBTREE_NULL_NODE)
+        {
+            // Replace the parent with the sibling.
+            if (m_nodes[grandParent].m_child1 == parent)
+                m_nodes[grandParent].m_child1 = sibling;
+            else
+                m_nodes[grandParent].m_child2 = sibling;
+
+            m_nodes[sibling].m_parent = grandParent;
+            FreeNode(parent);
+            FixUpwards(grandParent);
+        }
+        else
+        {
+            m_root                    = sibling;
+            m_nodes[sibling].m_parent = AABBTREE_NULL_NODE;
+            FreeNode(parent);
+        }
+    }
+
+    void DynamicAABBTree::FixUpwards(int node)
+    {
+        int index = node;
+
+        while (index != AABBTREE_NULL_NODE)
+        {
+            index = Balance(index);
+
+            Node&       n  = m_nodes[index];
+            const Node& c1 = m_nodes[n.m_child1];
+            const Node& c2 = m_nodes[n.m_child2];
+            n.m_height     = 1 + Math::Max(c1.m_height, c2.m_height);
+            n.m_min        = GetMin(c1.m_min, c2.m_min);
+            n.m_max        = GetMax(c1.m_max, c2.m_max);
+
+            index = n.m_parent;
+        }
+    }
+
+    int DynamicAABBTree::Balance(int iA)
+    {
+        // Rotates the taller grandchild up if the subtree of A is imbalanced, returns the new subtree root.
+        Node& A = m_nodes[iA];
+        if (A.IsLeaf())
+            return iA;
+
+        const int iB      = A.m_child1;
+        const int iC      = A.m_child2;
+        Node&     B       = m_nodes[iB];
+        Node&     C       = m_nodes[iC];
+        const int balance = C.m_height - B.m_height;
+
+        auto rotate = [&](int iP, int iQ, bool pIsChild2) {
+            // P is the taller child of A, Q is the other one.
+            Node&     P  = m_nodes[iP];
+            const int iF = P.m_child1;
+            const int iG = P.m_child2;
+            Node&     F  = m_nodes[iF];
+            Node&     G  = m_nodes[iG];
+
+            // Swap A & P.
+            P.m_child1 = iA;
+            P.m_parent = A.m_parent;
+            A.m_parent = iP;
+
+            if (P.m_parent != AABBTREE_NULL_NODE)
+            {
+                if (m_nodes[P.m_parent].m_child1 == iA)
+                    m_nodes[P.m_parent].m_child1 = iP;
+                else
+                    m_nodes[P.m_parent].m_child2 = iP;
+            }
+            else
+                m_root = iP;
+
+            const Node& Q = m_nodes[iQ];
+
+            // Keep the taller grandchild under P, move the other one under A.
+            const bool fTaller = F.m_height > G.m_height;
+            const int  iKeep   = fTaller ? iF : iG;
+            const int  iMove   = fTaller ? iG : iF;
+            Node&      keep    = m_nodes[iKeep];
+            Node&      move    = m_nodes[iMove];
+
+            P.m_child2 = iKeep;
+
+            if (pIsChild2)
+                A.m_child2 = iMove;
+            else
+                A.m_child1 = iMove;
+
+            move.m_parent = iA;
+            A.m_min       = GetMin(Q.m_min, move.m_min);
+            A.m_max       = GetMax(Q.m_max, move.m_max);
+            A.m_height    = 1 + Math::Max(Q.m_height, move.m_height);
+            P.m_min       = GetMin(A.m_min, keep.m_min);
+            P.m_max       = GetMax(A.m_max, keep.m_max);
+            P.m_height    = 1 + Math::Max(A.m_height, keep.m_height);
+            return iP;
+        };
+
+        if (balance > 1)
+            return rotate(iC, iB, true);
+
+        if (balance < -1)
+            return rotate(iB, iC, false);
+
+        return iA;
+    }
+
+    int DynamicAABBTree::GetHeight() const
+    {
+        return m_root == AABBTREE_NULL_NODE ? 0 : m_nodes[m_root].m_height;
+    }
+
+    void DynamicAABBTree::GetSubtreeRoots(int depth, std::vector<int>& outRoots) const
+    {
+        if (m_root == AABBTREE_NULL_NODE)
+            return;
+
+        std::vector<std::pair<int, int>> stack;
+        stack.push_back(std::make_pair(m_root, 0));
+
+        while (!stack.empty())
+        {
+            const auto [index, nodeDepth] = stack.back();
+            stack.pop_back();
+            const Node& node = m_nodes[index];
+
+            if (nodeDepth == depth || node.IsLeaf())
+                outRoots.push_back(index);
+            else
+            {
+                stack.push_back(std::make_pair(node.m_child1, nodeDepth + 1));
+                stack.push_back(std::make_pair(node.m_child2, nodeDepth + 1));
+            }
+        }
+    }
+
+    void DynamicAABBTree::PrepareParallelQuery(Executor& executor, AABBTreeParallelQuery& query) const
+    {
+        int depth = 0;
+
+        if (m_proxyCount >= ParallelQueryMinProxies)
+        {
+            const uint32 subtrees = (uint32)executor.num_workers() * ParallelQuerySubtreesPerWorker;
+
+            while ((1u << depth) < subtrees)
+                depth++;
+        }
+
+        query.m_roots.clear();
+        GetSubtreeRoots(depth, query.m_roots);
+
+        const size_t rootCount = query.m_roots.size();
+
+        if (query.m_inside.size() < rootCount)
+        {
+            query.m_inside.resize(rootCount);
+            query.m_intersects.resize(rootCount);
+        }
+
+        for (size_t i = 0; i < rootCount; i++)
+        {
+            query.m_inside[i].clear();
+            query.m_intersects[i].clear();
+        }
+    }
+
+    void DynamicAABBTree::QueryAABBParallel(Executor& executor, const Vector3& min, const Vector3& max, AABBTreeParallelQuery& query, std::vector<int>& outProxies) const
+    {
+        outProxies.clear();
+        PrepareParallelQuery(executor, query);
+
+        ParallelFor(executor, (uint32)query.m_roots.size(), 1, 0, [&](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; i++)
+            {
+                std::vector<int>& proxies = query.m_intersects[i];
+
+                QueryAABB(
+                    min, max,
+                    [&](int proxyID) {
+                        proxies.push_back(proxyID);
+                        return true;
+                    },
+                    query.m_roots[i]);
+            }
+        });
+
+        for (size_t i = 0; i < query.m_roots.size(); i++)
+            outProxies.insert(outProxies.end(), query.m_intersects[i].begin(), query.m_intersects[i].end());
+    }
+
+    void DynamicAABBTree::QueryFrustumParallel(Executor& executor, const Frustum& frustum, AABBTreeParallelQuery& query, std::vector<int>& outInside, std::vector<int>& outIntersects) const
+    {
+        outInside.clear();
+        outIntersects.clear();
+        PrepareParallelQuery(executor, query);
+
+        ParallelFor(executor, (uint32)query.m_roots.size(), 1, 0, [&](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; i++)
+            {
+                std::vector<int>& inside     = query.m_inside[i];
+                std::vector<int>& intersects = query.m_intersects[i];
+
+                QueryFrustum(
+                    frustum,
+                    [&](int proxyID, AABBTreeQueryResult result) {
+                        if (result == AABBTreeQueryResult::Inside)
+                            inside.push_back(proxyID);
+                        else
+                            intersects.push_back(proxyID);
+
+                        return true;
+                    },
+                    query.m_roots[i]);
+            }
+        });
+
+        for (size_t i = 0; i < query.m_roots.size(); i++)
+        {
+            outInside.insert(outInside.end(), query.m_inside[i].begin(), query.m_inside[i].end());
+            outIntersects.insert(outIntersects.end(), query.m_intersects[i].begin(), query.m_intersects[i].end());
+        }
+    }
+
+    bool DynamicAABBTree::Validate() const
+    {
+        if (m_root == AABBTREE_NULL_NODE)
+            return m_proxyCount == 0;
+
+        return m_nodes[m_root].m_parent == AABBTREE_NULL_NODE && ValidateNode(m_root);
+    }
+
+    bool DynamicAABBTree::ValidateNode(int index) const
+    {
+        const Node& node = m_nodes[index];
+
+        if (node.IsLeaf())
+            return node.m_height == 0 && node.m_child2 == AABBTREE_NULL_NODE;
+
+        const Node& c1 = m_nodes[node.m_child1];
+        const Node& c2 = m_nodes[node.m_child2];
+
+        if (c1.m_parent != index || c2.m_parent != index)
+            return false;
+
+        if (node.m_height != 1 + Math::Max(c1.m_height, c2.m_height))
+            return false;
+
+        if (!Contains(node, c1.m_min, c1.m_max) || !Contains(node, c2.m_min, c2.m_max))
+            return false;
+
+        return ValidateNode(node.m_child1) && ValidateNode(node.m_child2);
+    }
+} // namespace Lina
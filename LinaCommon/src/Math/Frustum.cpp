@@ -72,13 +72,13 @@ namespace Lina
             m_far.m_normal.Normalize();
         }
     }
-    FrustumTest Frustum::TestIntersection(const AABB& aabb)
+    FrustumTest Frustum::TestIntersection(const AABB& aabb) const
     {
         FrustumTest test = FrustumTest::Inside;
 
-        std::vector<Plane*> planes = {&m_left, &m_right, &m_top, &m_bottom, &m_near, &m_far};
+        const Plane* planes[6] = {&m_left, &m_right, &m_top, &m_bottom, &m_near, &m_far};
 
-        for (auto* p : planes)
+        for (const Plane* p : planes)
         {
             const float   pos    = p->m_distance;
             const Vector3 normal = p->m_normal;
@@ -0,0 +1,286 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Math/FrustumCuller.hpp"
+#include "Math/Frustum.hpp"
+#include "Math/Math.hpp"
+
+#if defined(LINA_FRUSTUM_CULL_AVX)
+#include <immintrin.h>
+#elif defined(LINA_FRUSTUM_CULL_SSE)
+#include <emmintrin.h>
+#endif
+
+// MSVC allows AVX intrinsics in any function, GCC & Clang need the function to target AVX.
+#if defined(LINA_FRUSTUM_CULL_AVX) && defined(_MSC_VER)
+#include <intrin.h>
+#define LINA_TARGET_AVX
+#elif defined(LINA_FRUSTUM_CULL_AVX)
+#define LINA_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+#define FRUSTUM_CULL_PAD 8
+
+namespace Lina
+{
+    namespace
+    {
+        struct FrustumPlanes
+        {
+            float m_normalX[6];
+            float m_normalY[6];
+            float m_normalZ[6];
+            float m_absNormalX[6];
+            float m_absNormalY[6];
+            float m_absNormalZ[6];
+            float m_distance[6];
+        };
+
+        void GatherPlanes(const Frustum& frustum, FrustumPlanes& planes)
+        {
+            const Plane* source[6] = {&frustum.m_left, &frustum.m_right, &frustum.m_top, &frustum.m_bottom, &frustum.m_near, &frustum.m_far};
+
+            for (int i = 0; i < 6; i++)
+            {
+                planes.m_normalX[i]    = source[i]->m_normal.x;
+                planes.m_normalY[i]    = source[i]->m_normal.y;
+                planes.m_normalZ[i]    = source[i]->m_normal.z;
+                planes.m_absNormalX[i] = Math::Abs(source[i]->m_normal.x);
+                planes.m_absNormalY[i] = Math::Abs(source[i]->m_normal.y);
+                planes.m_absNormalZ[i] = Math::Abs(source[i]->m_normal.z);
+                planes.m_distance[i]   = source[i]->m_distance;
+            }
+        }
+    } // namespace
+
+    void AABBSoA::Clear()
+    {
+        m_centerX.clear();
+        m_centerY.clear();
+        m_centerZ.clear();
+        m_extentX.clear();
+        m_extentY.clear();
+        m_extentZ.clear();
+        m_count = 0;
+    }
+
+    void AABBSoA::Reserve(uint32 count)
+    {
+        const uint32 padded = count + FRUSTUM_CULL_PAD;
+        m_centerX.reserve(padded);
+        m_centerY.reserve(padded);
+        m_centerZ.reserve(padded);
+        m_extentX.reserve(padded);
+        m_extentY.reserve(padded);
+        m_extentZ.reserve(padded);
+    }
+
+    void AABBSoA::Add(const Vector3& center, const Vector3& halfExtent)
+    {
+        // Drop any padding from a previous Pad() call.
+        if (m_centerX.size() != m_count)
+        {
+            m_centerX.resize(m_count);
+            m_centerY.resize(m_count);
+            m_centerZ.resize(m_count);
+            m_extentX.resize(m_count);
+            m_extentY.resize(m_count);
+            m_extentZ.resize(m_count);
+        }
+
+        m_centerX.push_back(center.x);
+        m_centerY.push_back(center.y);
+        m_centerZ.push_back(center.z);
+        m_extentX.push_back(halfExtent.x);
+        m_extentY.push_back(halfExtent.y);
+        m_extentZ.push_back(halfExtent.z);
+        m_count++;
+    }
+
+    void AABBSoA::Pad()
+    {
+        const size_t padded = ((m_count + FRUSTUM_CULL_PAD - 1) / FRUSTUM_CULL_PAD) * FRUSTUM_CULL_PAD;
+        m_centerX.resize(padded, 0.0f);
+        m_centerY.resize(padded, 0.0f);
+        m_centerZ.resize(padded, 0.0f);
+        m_extentX.resize(padded, 0.0f);
+        m_extentY.resize(padded, 0.0f);
+        m_extentZ.resize(padded, 0.0f);
+    }
+
+    void FrustumCuller::Cull(const Frustum& frustum, AABBSoA& bounds, std::vector<uint32>& outVisibility)
+    {
+#if defined(LINA_FRUSTUM_CULL_AVX)
+        if (IsAVXSupported())
+        {
+            CullAVX(frustum, bounds, outVisibility);
+            return;
+        }
+#endif
+
+#if defined(LINA_FRUSTUM_CULL_SSE)
+        CullSSE(frustum, bounds, outVisibility);
+#else
+        CullScalar(frustum, bounds, outVisibility);
+#endif
+    }
+
+    void FrustumCuller::CullScalar(const Frustum& frustum, const AABBSoA& bounds, std::vector<uint32>& outVisibility)
+    {
+        FrustumPlanes planes;
+        GatherPlanes(frustum, planes);
+        outVisibility.assign((bounds.m_count + 31) / 32, 0);
+
+        for (uint32 i = 0; i < bounds.m_count; i++)
+        {
+            bool outside = false;
+
+            // Distance of the box's positive vertex to each plane, same operation order as the SIMD kernels.
+            for (int p = 0; p < 6 && !outside; p++)
+            {
+                float d = planes.m_normalX[p] * bounds.m_centerX[i];
+                d       = d + planes.m_normalY[p] * bounds.m_centerY[i];
+                d       = d + planes.m_normalZ[p] * bounds.m_centerZ[i];
+                d       = d + planes.m_absNormalX[p] * bounds.m_extentX[i];
+                d       = d + planes.m_absNormalY[p] * bounds.m_extentY[i];
+                d       = d + planes.m_absNormalZ[p] * bounds.m_extentZ[i];
+                d       = d + planes.m_distance[p];
+                outside = d < 0.0f;
+            }
+
+            if (!outside)
+                outVisibility[i >> 5] |= 1u << (i & 31);
+        }
+    }
+
+#ifdef LINA_FRUSTUM_CULL_AVX
+
+    bool FrustumCuller::IsAVXSupported()
+    {
+#if defined(_MSC_VER)
+        // CPUID leaf 1 reports AVX & OSXSAVE, XCR0 tells whether the OS saves the YMM registers.
+        static const bool supported = [] {
+            int info[4];
+            __cpuid(info, 1);
+            const bool cpuSupport = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+            return cpuSupport && (_xgetbv(0) & 0x6) == 0x6;
+        }();
+#else
+        static const bool supported = __builtin_cpu_supports("avx");
+#endif
+        return supported;
+    }
+
+    LINA_TARGET_AVX void FrustumCuller::CullAVX(const Frustum& frustum, AABBSoA& bounds, std::vector<uint32>& outVisibility)
+    {
+        FrustumPlanes planes;
+        GatherPlanes(frustum, planes);
+        bounds.Pad();
+        outVisibility.assign((bounds.m_count + 31) / 32, 0);
+
+        const __m256 zero = _mm256_setzero_ps();
+
+        for (uint32 i = 0; i < bounds.m_count; i += 8)
+        {
+            const __m256 cx      = _mm256_loadu_ps(&bounds.m_centerX[i]);
+            const __m256 cy      = _mm256_loadu_ps(&bounds.m_centerY[i]);
+            const __m256 cz      = _mm256_loadu_ps(&bounds.m_centerZ[i]);
+            const __m256 ex      = _mm256_loadu_ps(&bounds.m_extentX[i]);
+            const __m256 ey      = _mm256_loadu_ps(&bounds.m_extentY[i]);
+            const __m256 ez      = _mm256_loadu_ps(&bounds.m_extentZ[i]);
+            __m256       outside = _mm256_setzero_ps();
+
+            for (int p = 0; p < 6; p++)
+            {
+                __m256 d = _mm256_mul_ps(_mm256_set1_ps(planes.m_normalX[p]), cx);
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.m_normalY[p]), cy));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.m_normalZ[p]), cz));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.m_absNormalX[p]), ex));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.m_absNormalY[p]), ey));
+                d        = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(planes.m_absNormalZ[p]), ez));
+                d        = _mm256_add_ps(d, _mm256_set1_ps(planes.m_distance[p]));
+                outside  = _mm256_or_ps(outside, _mm256_cmp_ps(d, zero, _CMP_LT_OQ));
+            }
+
+            uint32 visible = (uint32)(~_mm256_movemask_ps(outside) & 0xFF);
+
+            // Mask out the padding.
+            if (i + 8 > bounds.m_count)
+                visible &= (1u << (bounds.m_count - i)) - 1;
+
+            outVisibility[i >> 5] |= visible << (i & 31);
+        }
+    }
+
+#endif
+
+#ifdef LINA_FRUSTUM_CULL_SSE
+
+    void FrustumCuller::CullSSE(const Frustum& frustum, AABBSoA& bounds, std::vector<uint32>& outVisibility)
+    {
+        FrustumPlanes planes;
+        GatherPlanes(frustum, planes);
+        bounds.Pad();
+        outVisibility.assign((bounds.m_count + 31) / 32, 0);
+
+        const __m128 zero = _mm_setzero_ps();
+
+        for (uint32 i = 0; i < bounds.m_count; i += 4)
+        {
+            const __m128 cx      = _mm_loadu_ps(&bounds.m_centerX[i]);
+            const __m128 cy      = _mm_loadu_ps(&bounds.m_centerY[i]);
+            const __m128 cz      = _mm_loadu_ps(&bounds.m_centerZ[i]);
+            const __m128 ex      = _mm_loadu_ps(&bounds.m_extentX[i]);
+            const __m128 ey      = _mm_loadu_ps(&bounds.m_extentY[i]);
+            const __m128 ez      = _mm_loadu_ps(&bounds.m_extentZ[i]);
+            __m128       outside = _mm_setzero_ps();
+
+            for (int p = 0; p < 6; p++)
+            {
+                __m128 d = _mm_mul_ps(_mm_set1_ps(planes.m_normalX[p]), cx);
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.m_normalY[p]), cy));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.m_normalZ[p]), cz));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.m_absNormalX[p]), ex));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.m_absNormalY[p]), ey));
+                d        = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(planes.m_absNormalZ[p]), ez));
+                d        = _mm_add_ps(d, _mm_set1_ps(planes.m_distance[p]));
+                outside  = _mm_or_ps(outside, _mm_cmplt_ps(d, zero));
+            }
+
+            uint32 visible = (uint32)(~_mm_movemask_ps(outside) & 0xF);
+
+            // Mask out the padding.
+            if (i + 4 > bounds.m_count)
+                visible &= (1u << (bounds.m_count - i)) - 1;
+
+            outVisibility[i >> 5] |= visible << (i & 31);
+        }
+    }
+
+#endif
+} // namespace Lina
@@ -0,0 +1,93 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Memory/MemoryStats.hpp"
+
+#include <deque>
+#include <mutex>
+
+namespace Lina
+{
+    namespace
+    {
+        // Deque keeps the categories in place as new ones are registered.
+        std::deque<MemoryCategory>& GetRegisteredCategories()
+        {
+            static std::deque<MemoryCategory> categories;
+            return categories;
+        }
+
+        std::mutex& GetCategoryMutex()
+        {
+            static std::mutex mtx;
+            return mtx;
+        }
+    } // namespace
+
+    void MemoryCategory::OnAllocate(uint64 bytes)
+    {
+        const uint64 current = m_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        uint64       peak    = m_peakBytes.load(std::memory_order_relaxed);
+
+        while (current > peak && !m_peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+        {
+        }
+
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        m_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MemoryCategory::OnFree(uint64 bytes)
+    {
+        m_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        m_allocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    MemoryCategory* MemoryStats::GetCategory(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(GetCategoryMutex());
+        std::deque<MemoryCategory>& categories = GetRegisteredCategories();
+
+        for (MemoryCategory& category : categories)
+        {
+            if (category.GetName() == name)
+                return &category;
+        }
+
+        return &categories.emplace_back(name);
+    }
+
+    void MemoryStats::GetCategories(std::vector<const MemoryCategory*>& categories)
+    {
+        std::lock_guard<std::mutex> lock(GetCategoryMutex());
+        categories.clear();
+
+        for (const MemoryCategory& category : GetRegisteredCategories())
+            categories.push_back(&category);
+    }
+} // namespace Lina
@@ -95,7 +95,12 @@ namespace Lina::Editor
         }
         else if (tid == GetTypeID<CameraComponent>())
         {
-            CameraComponent& camComp = ECS::Registry::Get()->get<CameraComponent>(ent);
+            ECS::EntityDataComponent& data       = ECS::Registry::Get()->get<ECS::EntityDataComponent>(ent);
+            CameraComponent&          camComp    = ECS::Registry::Get()->get<CameraComponent>(ent);
+            const float               aspect     = Graphics::RenderEngineBackend::Get()->GetCameraSystem()->GetAspectRatio();
+            const Matrix              view       = Matrix::InitLookAt(data.GetLocation(), data.GetLocation() + data.GetRotation().GetForward(), data.GetRotation().GetUp());
+            const Matrix              projection = Matrix::Perspective(camComp.m_fieldOfView / 2, aspect, camComp.m_zNear, camComp.m_zFar);
+            Graphics::RenderEngineBackend::Get()->DrawFrustum(projection * view, Color::Red);
         }
     }
 
@@ -313,23 +318,27 @@ namespace Lina::Editor
             phy.m_collisionShape                       = (Physics::CollisionShape)WidgetsUtility::CollisionShapeComboBox("##collision", (int)phy.m_collisionShape);
             if (phy.m_collisionShape != currentShape)
             {
-                physicsEngine->SetBodyCollisionShape(entity, phy.m_collisionShape);
-                // f (phy.m_collisionShape == Physics::CollisionShape::ConvexMesh)
-                //
-                //	ECS::ModelRendererComponent* mr = ecs->try_get<ECS::ModelRendererComponent>(entity);
-                //
-                //	if (mr != nullptr)
-                //	{
-                //		phy.m_attachedModelID = mr->m_modelID;
-                //		physicsEngine->SetBodyCollisionShape(entity, phy.m_collisionShape);
-                //
-                //	}
-                //	else
-                //	{
-                //		phy.m_collisionShape = currentShape;
-                //		LINA_ERR("This entity does not contain a mesh renderer.");
-                //	}
-                //
+#ifdef LINA_PHYSICS_PHYSX
+                // Mesh shapes use the first mesh of the entity's model node.
+                if (phy.m_collisionShape == Physics::CollisionShape::ConvexMesh || phy.m_collisionShape == Physics::CollisionShape::TriangleMesh)
+                {
+                    ECS::ModelNodeComponent* node = ECS::Registry::Get()->try_get<ECS::ModelNodeComponent>(entity);
+
+                    if (node != nullptr && node->m_model.m_value != nullptr)
+                    {
+                        phy.m_attachedModelID   = node->m_model.m_sid;
+                        phy.m_attachedMeshIndex = node->m_model.m_value->GetFirstMeshIndex(node->m_nodeIndex);
+                    }
+                    else
+                    {
+                        phy.m_collisionShape = currentShape;
+                        LINA_ERR("Mesh collision shapes need a model node on the entity.");
+                    }
+                }
+#endif
+
+                if (phy.m_collisionShape != currentShape)
+                    physicsEngine->SetBodyCollisionShape(entity, phy.m_collisionShape);
             }
             if (phy.m_collisionShape == Physics::CollisionShape::Box)
             {
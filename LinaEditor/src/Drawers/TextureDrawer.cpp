@@ -106,6 +106,9 @@ namespace Lina::Editor
         WidgetsUtility::PropertyLabel("Mipmaps");
         ImGui::Checkbox("##mips", &assetData->m_samplerParameters.m_textureParams.m_generateMipMaps);
 
+        WidgetsUtility::PropertyLabel("Sprite Atlas", true, "Packed into the sprite atlas when imported, sprites only draw textures from the atlas.");
+        ImGui::Checkbox("##atlas", &assetData->m_packIntoAtlas);
+
         WidgetsUtility::PropertyLabel("Internal Format", true, "OpenGL internal texture format.");
         if (WidgetsUtility::BeginComboBox("##internal_pixel", pixelFormats[currentInternalPixelFormat]))
         {
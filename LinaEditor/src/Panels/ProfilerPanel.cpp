@@ -30,8 +30,11 @@ SOFTWARE.
 #include "Panels/ProfilerPanel.hpp"
 
 #include "Core/Application.hpp"
+#include "Core/AudioBackend.hpp"
 #include "Core/EditorCommon.hpp"
+#include "Core/RenderEngineBackend.hpp"
 #include "Core/Timer.hpp"
+#include "Memory/MemoryStats.hpp"
 #include "Utility/UtilityFunctions.hpp"
 #include "Widgets/WidgetsUtility.hpp"
 #include "imgui/imgui.h"
@@ -124,6 +127,49 @@ namespace Lina::Editor
 
                 displayMS = false;
 
+                // Memory of the subsystems that track their own, e.g. PhysX.
+                static std::vector<const MemoryCategory*> memoryCategories;
+                MemoryStats::GetCategories(memoryCategories);
+
+                if (!memoryCategories.empty())
+                {
+                    WidgetsUtility::IncrementCursorPosY(12);
+
+                    for (const MemoryCategory* category : memoryCategories)
+                    {
+                        const std::string txt = category->GetName() + " " + std::to_string(category->GetBytes() / 1024) + " KB, peak " + std::to_string(category->GetPeakBytes() / 1024) + " KB, " + std::to_string(category->GetAllocations()) + " allocations";
+                        WidgetsUtility::IncrementCursorPosX(12);
+                        ImGui::Text(txt.c_str());
+                    }
+                }
+
+                const Graphics::RenderDeviceStats& deviceStats = Graphics::RenderEngineBackend::Get()->GetRenderDevice()->GetLastFrameStats();
+                const std::string                  deviceTxt   = "Render Device " + std::to_string(deviceStats.m_drawCalls) + " draw calls, " + std::to_string(deviceStats.m_stateCalls) + " state calls, " + std::to_string(deviceStats.m_skippedBinds) + " binds & " + std::to_string(deviceStats.m_skippedRenderStates) + " render states skipped";
+                WidgetsUtility::IncrementCursorPosY(12);
+                WidgetsUtility::IncrementCursorPosX(12);
+                ImGui::Text(deviceTxt.c_str());
+
+                if (Audio::AudioVoiceManager* voiceManager = Audio::AudioEngineBackend::Get()->GetVoiceManager())
+                {
+                    const Audio::AudioVoiceStats stats = voiceManager->GetStats();
+                    const std::string            txt   = "Audio Voices " + std::to_string(stats.m_realVoices) + "/" + std::to_string(stats.m_sources) + " real, " + std::to_string(stats.m_virtualVoices) + " virtual, " + std::to_string(stats.m_stolen) + " stolen, " + std::to_string(stats.m_dropped) + " dropped";
+                    WidgetsUtility::IncrementCursorPosY(12);
+                    WidgetsUtility::IncrementCursorPosX(12);
+                    ImGui::Text(txt.c_str());
+                }
+
+                const Graphics::DebugDrawStats& debugStats = Graphics::RenderEngineBackend::Get()->GetDebugDrawBatcher()->GetLastFrameStats();
+                const std::string               debugTxt   = "Debug Draw " + std::to_string(debugStats.m_lineCount) + " lines, " + std::to_string(debugStats.m_iconCount) + " icons, " + std::to_string(debugStats.m_drawCalls) + " draw calls";
+                WidgetsUtility::IncrementCursorPosY(12);
+                WidgetsUtility::IncrementCursorPosX(12);
+                ImGui::Text(debugTxt.c_str());
+
+                const Graphics::StaticBatchStats& batchStats = Graphics::RenderEngineBackend::Get()->GetStaticBatchSystem()->GetStats();
+                const std::string                 batchTxt   = "Static Batches " + std::to_string(batchStats.m_batchedEntities) + " entities, " + std::to_string(batchStats.m_batchedMeshes) + " meshes, draw calls " + std::to_string(batchStats.m_sourceDrawCalls) + " -> " + std::to_string(batchStats.m_chunkDrawCalls) + ", " + std::to_string(batchStats.m_vertexMemory / 1024) + " KB vertex, " + std::to_string(batchStats.m_indexMemory / 1024) + " KB index";
+                WidgetsUtility::IncrementCursorPosY(12);
+                WidgetsUtility::IncrementCursorPosX(12);
+                ImGui::Text(batchTxt.c_str());
+
                 WidgetsUtility::IncrementCursorPosX(12);
                 WidgetsUtility::IncrementCursorPosY(12);
 
@@ -85,6 +85,7 @@ namespace Lina::Editor
                     const auto& mainPipeline      = Engine::Get()->GetPipeline();
                     const auto& animationPipeline = Graphics::RenderEngineBackend::Get()->GetAnimationPipeline();
                     const auto& renderingPipeline = Graphics::RenderEngineBackend::Get()->GetRenderingPipeline();
+                    const auto& viewPipeline      = Graphics::RenderEngineBackend::Get()->GetViewPipeline();
                     const auto& physicsPipeline   = Physics::PhysicsEngineBackend::Get()->GetPipeline();
                     const auto& inputPipeline     = Input::InputEngineBackend::Get()->GetPipeline();
 
@@ -94,6 +95,8 @@ namespace Lina::Editor
                         DrawSystem(system, "Animation");
                     for (const auto* system : renderingPipeline.GetSystems())
                         DrawSystem(system, "Rendering");
+                    for (const auto* system : viewPipeline.GetSystems())
+                        DrawSystem(system, "View");
                     for (const auto* system : physicsPipeline.GetSystems())
                         DrawSystem(system, "Physics");
                     for (const auto* system : inputPipeline.GetSystems())
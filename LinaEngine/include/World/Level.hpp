@@ -92,6 +92,14 @@ namespace Lina::World
         LINA_PROPERTY("Ambient", "Color", "", "", "Sky")
         Color m_ambientColor = Color(0);
 
+        /// <summary>
+        /// File the level was last installed from or saved to, empty if neither.
+        /// </summary>
+        inline const std::string& GetPath()
+        {
+            return m_path;
+        }
+
     protected:
         ECS::Registry m_registry;
 
@@ -103,6 +111,7 @@ namespace Lina::World
         friend class Application;
         friend class cereal::access;
         static Level* s_currentLevel;
+        std::string   m_path = "";
 
         template <class Archive>
         void serialize(Archive& archive)
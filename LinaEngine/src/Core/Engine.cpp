@@ -39,6 +39,7 @@ SOFTWARE.
 #include "Rendering/Texture.hpp"
 #include "Rendering/Material.hpp"
 #include "Rendering/ShaderInclude.hpp"
+#include "Rendering/ReflectionProbeCache.hpp"
 #include "Physics/PhysicsMaterial.hpp"
 #include "Audio/Audio.hpp"
 #include "Rendering/Shader.hpp"
@@ -174,6 +175,7 @@ namespace Lina
             m_smoothDeltaTime = SmoothDeltaTime(m_rawDeltaTime);
 
             m_inputEngine.Tick();
+            m_audioEngine.Tick((float)m_rawDeltaTime);
             updates++;
             LINA_TIMER_START("Update MS");
             UpdateGame((float)m_rawDeltaTime);
@@ -223,6 +225,22 @@ namespace Lina
     {
         PROFILER_FUNC("Engine Tick");
 
+        float physicsStep = m_physicsEngine.GetStepTime();
+
+#ifdef LINA_PHYSICS_PHYSX
+        // Step started at the end of the last update, fetched even if paused so nothing is left running.
+        if (m_physicsEngine.IsSimulating())
+        {
+            m_physicsEngine.FetchResults();
+            m_eventSystem.Trigger<Event::EPhysicsTick>(Event::EPhysicsTick{physicsStep, m_isInPlayMode});
+            m_eventSystem.Trigger<Event::EPostPhysicsTick>(Event::EPostPhysicsTick{physicsStep, m_isInPlayMode});
+        }
+
+        const bool asyncPhysics = m_physicsEngine.GetAsyncSimulation();
+#else
+        const bool asyncPhysics = false;
+#endif
+
         // Pause & skip frame controls.
         if (m_paused && !m_shouldSkipFrame)
             return;
@@ -232,11 +250,13 @@ namespace Lina
 
         // Physics events & physics tick.
         m_physicsAccumulator += deltaTime;
-        float physicsStep = m_physicsEngine.GetStepTime();
+        const bool stepPhysics = m_physicsAccumulator >= physicsStep;
 
-        if (m_physicsAccumulator >= physicsStep)
-        {
+        if (stepPhysics)
             m_physicsAccumulator -= physicsStep;
+
+        if (stepPhysics && !asyncPhysics)
+        {
             m_eventSystem.Trigger<Event::EPrePhysicsTick>(Event::EPrePhysicsTick{});
             m_physicsEngine.Tick(physicsStep);
             m_eventSystem.Trigger<Event::EPhysicsTick>(Event::EPhysicsTick{physicsStep, m_isInPlayMode});
@@ -253,6 +273,15 @@ namespace Lina
 
         m_eventSystem.Trigger<Event::ETick>(Event::ETick{(float)m_rawDeltaTime, m_isInPlayMode});
         m_eventSystem.Trigger<Event::EPostTick>(Event::EPostTick{(float)m_rawDeltaTime, m_isInPlayMode});
+
+#ifdef LINA_PHYSICS_PHYSX
+        // Solved on the PhysX workers while the frame is rendered, results are fetched at the start of the next update.
+        if (stepPhysics && asyncPhysics)
+        {
+            m_eventSystem.Trigger<Event::EPrePhysicsTick>(Event::EPrePhysicsTick{});
+            m_physicsEngine.Simulate(physicsStep);
+        }
+#endif
     }
 
     void Engine::DisplayGame(float interpolation)
@@ -335,6 +364,13 @@ namespace Lina
                 std::bind(Resources::DeleteResource<Graphics::ModelAssetData>, std::placeholders::_1),
                 std::vector<std::string>{"linamodeldata"}, Color::White, true});
 
+        m_resourceStorage.RegisterResource<Graphics::ReflectionProbeCache>(
+            Resources::ResourceTypeData{
+                0,
+                std::bind(Resources::CreateResource<Graphics::ReflectionProbeCache>),
+                std::bind(Resources::DeleteResource<Graphics::ReflectionProbeCache>, std::placeholders::_1),
+                std::vector<std::string>{"linaprobecache"}, Color::White, true});
+
         m_resourceStorage.RegisterResource<Graphics::Shader>(
             Resources::ResourceTypeData{
                 1,
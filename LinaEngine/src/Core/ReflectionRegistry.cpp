@@ -64,6 +64,8 @@ SOFTWARE.
 #include "ECS/Components/LightComponent.hpp"
 #include "ECS/Components/ReflectionAreaComponent.hpp"
 #include "ECS/Components/SpriteRendererComponent.hpp"
+#include "ECS/Components/OccluderComponent.hpp"
+#include "ECS/Components/StaticComponent.hpp"
 #include "ECS/Components/FreeLookComponent.hpp"
 #include "Rendering/ModelAssetData.hpp"
 #include "Core/EngineSettings.hpp"
@@ -96,6 +98,18 @@ namespace Lina
         loader.component<Type>(archive);
     }
 
+    template <typename Type>
+    void REF_DeserializeLegacyComponent(ECS::Registry& reg, cereal::PortableBinaryInputArchive& archive)
+    {
+        // Loaded in the layout the level was saved with, entities keep their identifiers.
+        using Legacy = typename Type::LegacyLayout;
+        entt::registry legacy;
+        entt::snapshot_loader{legacy}.component<Legacy>(archive);
+
+        for (auto entity : legacy.view<Legacy>())
+            reg.emplace_or_replace<Type>(entity).MigrateFrom(legacy.get<Legacy>(entity));
+    }
+
     template <typename Type>
     void REF_SetEnabled(ECS::Entity ent, bool enabled)
     {
@@ -343,9 +357,12 @@ entt::meta<ECS::ReflectionAreaComponent>().func<&REF_Paste<ECS::ReflectionAreaCo
 entt::meta<ECS::ReflectionAreaComponent>().func<&REF_Add<ECS::ReflectionAreaComponent>, entt::as_void_t>("add"_hs);
 entt::meta<ECS::SpriteRendererComponent>().type().props(std::make_pair("Title"_hs, "Sprite Component"), std::make_pair("Icon"_hs,ICON_FA_EYE), std::make_pair("Category"_hs,"Rendering"), std::make_pair("CanAddComponent"_hs, "1"));
 entt::meta<ECS::SpriteRendererComponent>().data<&ECS::SpriteRendererComponent::m_isEnabled>("m_isEnabled"_hs);
+entt::meta<ECS::SpriteRendererComponent>().data<&ECS::SpriteRendererComponent::m_layer>("m_layer"_hs).props(std::make_pair("Title"_hs,"Layer"),std::make_pair("Type"_hs,"Int"),std::make_pair("Tooltip"_hs,"Sprites on lower layers are drawn first."),std::make_pair("Depends"_hs,""_hs), std::make_pair("Category"_hs, ""));
+entt::meta<ECS::SpriteRendererComponent>().data<&ECS::SpriteRendererComponent::m_material>("m_material"_hs).props(std::make_pair("Title"_hs,"Material"),std::make_pair("Type"_hs,"Material"),std::make_pair("Tooltip"_hs,"Diffuse texture is packed into the sprite atlas, object color tints the sprite."),std::make_pair("Depends"_hs,""_hs), std::make_pair("Category"_hs, ""));
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_CloneComponent<ECS::SpriteRendererComponent>, entt::as_void_t>("clone"_hs);
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_SerializeComponent<ECS::SpriteRendererComponent>, entt::as_void_t>("serialize"_hs);
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_DeserializeComponent<ECS::SpriteRendererComponent>, entt::as_void_t>("deserialize"_hs);
+entt::meta<ECS::SpriteRendererComponent>().func<&REF_DeserializeLegacyComponent<ECS::SpriteRendererComponent>, entt::as_void_t>("deserializeLegacy"_hs);
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_SetEnabled<ECS::SpriteRendererComponent>, entt::as_void_t>("setEnabled"_hs);
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_Get<ECS::SpriteRendererComponent>, entt::as_ref_t>("get"_hs);
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_Reset<ECS::SpriteRendererComponent>, entt::as_void_t>("reset"_hs);
@@ -354,6 +371,32 @@ entt::meta<ECS::SpriteRendererComponent>().func<&REF_Remove<ECS::SpriteRendererC
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_Copy<ECS::SpriteRendererComponent>, entt::as_void_t>("copy"_hs);
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_Paste<ECS::SpriteRendererComponent>, entt::as_void_t>("paste"_hs);
 entt::meta<ECS::SpriteRendererComponent>().func<&REF_Add<ECS::SpriteRendererComponent>, entt::as_void_t>("add"_hs);
+entt::meta<ECS::OccluderComponent>().type().props(std::make_pair("Title"_hs, "Occluder"), std::make_pair("Icon"_hs,ICON_FA_EYE_SLASH), std::make_pair("Category"_hs,"Rendering"), std::make_pair("CanAddComponent"_hs, "1"));
+entt::meta<ECS::OccluderComponent>().data<&ECS::OccluderComponent::m_isEnabled>("m_isEnabled"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_CloneComponent<ECS::OccluderComponent>, entt::as_void_t>("clone"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_SerializeComponent<ECS::OccluderComponent>, entt::as_void_t>("serialize"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_DeserializeComponent<ECS::OccluderComponent>, entt::as_void_t>("deserialize"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_SetEnabled<ECS::OccluderComponent>, entt::as_void_t>("setEnabled"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_Get<ECS::OccluderComponent>, entt::as_ref_t>("get"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_Reset<ECS::OccluderComponent>, entt::as_void_t>("reset"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_Has<ECS::OccluderComponent>, entt::as_is_t>("has"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_Remove<ECS::OccluderComponent>, entt::as_void_t>("remove"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_Copy<ECS::OccluderComponent>, entt::as_void_t>("copy"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_Paste<ECS::OccluderComponent>, entt::as_void_t>("paste"_hs);
+entt::meta<ECS::OccluderComponent>().func<&REF_Add<ECS::OccluderComponent>, entt::as_void_t>("add"_hs);
+entt::meta<ECS::StaticComponent>().type().props(std::make_pair("Title"_hs, "Static"), std::make_pair("Icon"_hs,ICON_FA_ANCHOR), std::make_pair("Category"_hs,"Rendering"), std::make_pair("CanAddComponent"_hs, "1"));
+entt::meta<ECS::StaticComponent>().data<&ECS::StaticComponent::m_isEnabled>("m_isEnabled"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_CloneComponent<ECS::StaticComponent>, entt::as_void_t>("clone"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_SerializeComponent<ECS::StaticComponent>, entt::as_void_t>("serialize"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_DeserializeComponent<ECS::StaticComponent>, entt::as_void_t>("deserialize"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_SetEnabled<ECS::StaticComponent>, entt::as_void_t>("setEnabled"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_Get<ECS::StaticComponent>, entt::as_ref_t>("get"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_Reset<ECS::StaticComponent>, entt::as_void_t>("reset"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_Has<ECS::StaticComponent>, entt::as_is_t>("has"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_Remove<ECS::StaticComponent>, entt::as_void_t>("remove"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_Copy<ECS::StaticComponent>, entt::as_void_t>("copy"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_Paste<ECS::StaticComponent>, entt::as_void_t>("paste"_hs);
+entt::meta<ECS::StaticComponent>().func<&REF_Add<ECS::StaticComponent>, entt::as_void_t>("add"_hs);
 entt::meta<ECS::FreeLookComponent>().type().props(std::make_pair("Title"_hs, "Free Look Component"), std::make_pair("Icon"_hs,ICON_FA_EYE), std::make_pair("Category"_hs,"Input"), std::make_pair("CanAddComponent"_hs, "1"));
 entt::meta<ECS::FreeLookComponent>().data<&ECS::FreeLookComponent::m_isEnabled>("m_isEnabled"_hs);
 entt::meta<ECS::FreeLookComponent>().data<&ECS::FreeLookComponent::m_rotationSpeeds>("m_rotationSpeeds"_hs).props(std::make_pair("Title"_hs,"Rotation Speed"),std::make_pair("Type"_hs,"Vector2"),std::make_pair("Tooltip"_hs,""),std::make_pair("Depends"_hs,""_hs), std::make_pair("Category"_hs, ""));
@@ -370,6 +413,7 @@ entt::meta<ECS::FreeLookComponent>().func<&REF_Copy<ECS::FreeLookComponent>, ent
 entt::meta<ECS::FreeLookComponent>().func<&REF_Paste<ECS::FreeLookComponent>, entt::as_void_t>("paste"_hs);
 entt::meta<ECS::FreeLookComponent>().func<&REF_Add<ECS::FreeLookComponent>, entt::as_void_t>("add"_hs);
 entt::meta<Graphics::ModelAssetData>().type().props(std::make_pair("Title"_hs, "Model Data"));
+entt::meta<Graphics::ModelAssetData>().data<&Graphics::ModelAssetData::m_isOccluder>("m_isOccluder"_hs).props(std::make_pair("Title"_hs,"Occluder"),std::make_pair("Type"_hs,"Bool"),std::make_pair("Tooltip"_hs,"If true, occluder geometry is built at import, entities of this model with an Occluder component hide what's behind them."),std::make_pair("Depends"_hs,""_hs), std::make_pair("Category"_hs, ""));
 entt::meta<Graphics::ModelAssetData>().data<&Graphics::ModelAssetData::m_generatePivots>("m_generatePivots"_hs).props(std::make_pair("Title"_hs,"Generate Entity Pivots"),std::make_pair("Type"_hs,"Bool"),std::make_pair("Tooltip"_hs,"If true, any entity generated via adding this model to the scene will have offset pivots as parents."),std::make_pair("Depends"_hs,""_hs), std::make_pair("Category"_hs, ""));
 entt::meta<Graphics::ModelAssetData>().data<&Graphics::ModelAssetData::m_flipUVs>("m_flipUVs"_hs).props(std::make_pair("Title"_hs,"Flip UVs"),std::make_pair("Type"_hs,"Bool"),std::make_pair("Tooltip"_hs,""),std::make_pair("Depends"_hs,""_hs), std::make_pair("Category"_hs, ""));
 entt::meta<Graphics::ModelAssetData>().data<&Graphics::ModelAssetData::m_flipWinding>("m_flipWinding"_hs).props(std::make_pair("Title"_hs,"Flip Winding"),std::make_pair("Type"_hs,"Bool"),std::make_pair("Tooltip"_hs,""),std::make_pair("Depends"_hs,""_hs), std::make_pair("Category"_hs, ""));
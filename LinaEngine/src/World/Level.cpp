@@ -43,6 +43,9 @@ SOFTWARE.
 #include <fstream>
 #include <stdio.h>
 
+// Written first, levels saved before it was added start with the level data & hold unversioned components.
+#define LEVEL_FILE_MAGIC 0x4C4556454C414E4Cull
+
 namespace Lina::World
 {
     Level* Level::s_currentLevel = nullptr;
@@ -70,10 +73,11 @@ namespace Lina::World
         std::ofstream stream(path, std::ios::binary);
         {
             cereal::PortableBinaryOutputArchive oarchive(stream);
-            oarchive(*this);
+            oarchive(LEVEL_FILE_MAGIC, *this);
             m_registry.SerializeComponentsInRegistry(oarchive);
         }
-        Event::EventSystem::Get()->Trigger<Event::ESerializedLevel>(Event::ESerializedLevel{});
+        m_path = path;
+        Event::EventSystem::Get()->Trigger<Event::ESerializedLevel>(Event::ESerializedLevel{path});
     }
 
     void Level::InstallFromFile(const std::string& path)
@@ -84,12 +88,27 @@ namespace Lina::World
         std::ifstream stream(path, std::ios::binary);
         {
             cereal::PortableBinaryInputArchive iarchive(stream);
-            iarchive(*this);
-            m_registry.DeserializeComponentsInRegistry(iarchive);
+            uint64                             magic = 0;
+            iarchive(magic);
+
+            if (magic == LEVEL_FILE_MAGIC)
+            {
+                iarchive(*this);
+                m_registry.DeserializeComponentsInRegistry(iarchive);
+            }
+            else
+            {
+                stream.clear();
+                stream.seekg(0);
+                cereal::PortableBinaryInputArchive legacyArchive(stream);
+                legacyArchive(*this);
+                m_registry.DeserializeComponentsInRegistry(legacyArchive, true);
+            }
         }
 
         ECS::Registry::s_ecs = &m_registry;
         s_currentLevel       = this;
+        m_path               = path;
         SetupData();
     }
 
@@ -97,7 +116,7 @@ namespace Lina::World
     {
         Graphics::RenderEngineBackend::Get()->SetSkyboxMaterial(m_skyboxMaterial.m_value);
         Graphics::RenderEngineBackend::Get()->GetLightingSystem()->SetAmbientColor(m_ambientColor);
-        Event::EventSystem::Get()->Trigger<Event::ELevelInstalled>(Event::ELevelInstalled{});
+        Event::EventSystem::Get()->Trigger<Event::ELevelInstalled>(Event::ELevelInstalled{m_path});
     };
 
 } // namespace Lina::World
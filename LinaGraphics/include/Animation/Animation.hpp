@@ -29,7 +29,9 @@ SOFTWARE.
 /*
 Class: Animation
 
-
+Skeletal animation clip. All channels are kept in two flat arrays, key times & float4 key values, tracks only store
+the joint they drive & the ranges of their translation, rotation and scale keys. Times are in seconds.
+Clips can be replaced by their compressed form via AnimationCompressor, which is sampled per fixed length segment.
 
 Timestamp: 12/7/2021 11:34:48 AM
 */
@@ -40,20 +42,142 @@ Timestamp: 12/7/2021 11:34:48 AM
 #define Animation_HPP
 
 // Headers here.
+#include "Animation/AnimationMath.hpp"
+#include "Core/SizeDefinitions.hpp"
+
 #include <string>
+#include <vector>
+
+#define ANIMATION_SEGMENT_FRAMES 16
 
 namespace Lina::Graphics
 {
+    class AnimationCompressor;
+
+    enum class AnimationChannel : uint32
+    {
+        Translation = 0,
+        Rotation    = 1,
+        Scale       = 2
+    };
+
+    struct AnimationTrack
+    {
+        uint32 m_joint            = 0;
+        uint32 m_translationStart = 0;
+        uint32 m_translationCount = 0;
+        uint32 m_rotationStart    = 0;
+        uint32 m_rotationCount    = 0;
+        uint32 m_scaleStart       = 0;
+        uint32 m_scaleCount       = 0;
+    };
+
+    struct alignas(16) AnimationKey
+    {
+        float m_value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    };
+
+    /// <summary>
+    /// Channel whose quantized keys are stored in the segments, range is only used by translation & scale.
+    /// </summary>
+    struct alignas(16) AnimationCompressedChannel
+    {
+        float            m_rangeMin[4]   = {0.0f, 0.0f, 0.0f, 0.0f};
+        float            m_rangeScale[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        uint32           m_joint         = 0;
+        AnimationChannel m_channel       = AnimationChannel::Translation;
+    };
+
+    /// <summary>
+    /// Channel that doesn't change throughout the clip.
+    /// </summary>
+    struct alignas(16) AnimationConstantChannel
+    {
+        AnimationKey     m_value;
+        uint32           m_joint   = 0;
+        AnimationChannel m_channel = AnimationChannel::Translation;
+    };
+
     class Animation
     {
 
     public:
-        Animation() = default;
+        Animation()  = default;
         ~Animation() = default;
 
-        bool LoadAnimation(const std::string& animPath);
+        /// <summary>
+        /// Overwrites the joints driven by this clip in the given pose, other joints are left untouched.
+        /// Time is clamped to the clip's range.
+        /// </summary>
+        void Sample(float time, JointTransform* pose) const;
+
+        /// <summary>
+        /// Appends keys of a new track, returns its index. Times must be ascending within each channel.
+        /// </summary>
+        uint32 AddTrack(uint32 joint, const std::vector<float>& translationTimes, const std::vector<AnimationKey>& translations, const std::vector<float>& rotationTimes, const std::vector<AnimationKey>& rotations, const std::vector<float>& scaleTimes, const std::vector<AnimationKey>& scales);
+
+        inline void SetName(const std::string& name)
+        {
+            m_name = name;
+        }
+
+        inline const std::string& GetName() const
+        {
+            return m_name;
+        }
+
+        inline void SetDuration(float duration)
+        {
+            m_duration = duration;
+        }
+
+        inline float GetDuration() const
+        {
+            return m_duration;
+        }
+
+        inline const std::vector<AnimationTrack>& GetTracks() const
+        {
+            return m_tracks;
+        }
+
+        inline uint32 GetKeyCount() const
+        {
+            return (uint32)m_times.size();
+        }
+
+        inline bool IsCompressed() const
+        {
+            return m_isCompressed;
+        }
+
+        /// <summary>
+        /// Bytes used by the key data of the clip, in whichever form it is currently stored.
+        /// </summary>
+        size_t GetDataSize() const;
+
+    private:
+        friend class AnimationCompressor;
+
+        void SampleChannel(uint32 start, uint32 count, float time, bool isRotation, float* out) const;
+        void SampleCompressed(float time, JointTransform* pose) const;
 
     private:
+        std::string                 m_name     = "";
+        float                       m_duration = 0.0f;
+        std::vector<AnimationTrack> m_tracks;
+        std::vector<float>          m_times;
+        std::vector<AnimationKey>   m_keys;
+
+        // Compressed form. Each segment holds, contiguously, the key counts of all animated channels, their key frames
+        // relative to the segment start & their 16 bit quantized values, keys on segment borders are duplicated.
+        bool                                    m_isCompressed = false;
+        float                                   m_sampleRate   = 0.0f;
+        uint32                                  m_frameCount   = 0;
+        std::vector<AnimationCompressedChannel> m_channels;
+        std::vector<AnimationConstantChannel>   m_constants;
+        std::vector<uint32>                     m_segmentOffsets;
+        std::vector<uint8>                      m_segmentData;
     };
 } // namespace Lina::Graphics
 
@@ -0,0 +1,93 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: AnimationCompressor
+
+Offline compression for imported clips. Clips are resampled at a fixed rate & split into segments, keys of each
+channel that can be linearly interpolated within the joint's error budget are dropped. Budgets are derived from the
+object space tolerance, the distance to the farthest descendant & the depth of the chains below each joint.
+Rotations are stored as smallest three quaternions, translations & scales are normalized to their range, both in
+16 bits per component. Channels that don't change are stored once, channels that stay at the bind pose are dropped.
+Budgets are halved & the clip compressed again while the measured error is above the tolerance.
+
+Timestamp: 2/1/2022 11:06:37 AM
+*/
+
+#pragma once
+
+#ifndef AnimationCompressor_HPP
+#define AnimationCompressor_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+
+#include <cstddef>
+
+namespace Lina::Graphics
+{
+    class Animation;
+    class Skeleton;
+
+    struct AnimationCompressionSettings
+    {
+        float m_tolerance     = 0.001f;  // Maximum allowed object space error, in units. 16 bit rotations floor around 0.1-0.3 mm on long chains.
+        float m_shellDistance = 0.03f;   // Distance of the virtual vertices around each joint the error is measured on.
+        float m_sampleRate    = 30.0f;   // Frames per second the clip is resampled at.
+    };
+
+    struct AnimationCompressionStats
+    {
+        size_t m_rawSize          = 0;
+        size_t m_compressedSize   = 0;
+        float  m_ratio            = 1.0f;
+        float  m_maxError         = 0.0f;
+        uint32 m_maxErrorJoint    = 0;
+        uint32 m_animatedChannels = 0;
+        uint32 m_constantChannels = 0;
+        uint32 m_droppedChannels  = 0;
+        uint32 m_storedKeys       = 0;
+    };
+
+    class AnimationCompressor
+    {
+
+    public:
+        /// <summary>
+        /// Replaces the clip's keys with their compressed form, does nothing if the clip is already compressed.
+        /// </summary>
+        static AnimationCompressionStats Compress(const Skeleton& skeleton, Animation& animation, const AnimationCompressionSettings& settings = AnimationCompressionSettings());
+
+        /// <summary>
+        /// Largest distance between the virtual vertices of the two clips in object space, sampled at twice the given rate.
+        /// </summary>
+        static float MeasureError(const Skeleton& skeleton, const Animation& reference, const Animation& animation, float sampleRate, float shellDistance, uint32* outJoint = nullptr);
+    };
+} // namespace Lina::Graphics
+
+#endif
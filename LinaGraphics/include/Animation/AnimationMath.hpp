@@ -0,0 +1,245 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: AnimationMath
+
+Joint transform layout & the interpolation/composition helpers used in pose sampling and hierarchy evaluation.
+Translation, rotation & scale are kept as aligned float4s so that a single SSE register holds each of them,
+a scalar path is used when SSE is not available.
+
+Timestamp: 1/31/2022 10:24:51 AM
+*/
+
+#pragma once
+
+#ifndef AnimationMath_HPP
+#define AnimationMath_HPP
+
+// Headers here.
+#include <cmath>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LINA_ANIMATION_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Lina::Graphics
+{
+    struct alignas(16) JointTransform
+    {
+        float m_translation[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float m_rotation[4]    = {0.0f, 0.0f, 0.0f, 1.0f}; // x, y, z, w
+        float m_scale[4]       = {1.0f, 1.0f, 1.0f, 0.0f};
+    };
+
+    namespace AnimationMath
+    {
+        /// <summary>
+        /// out = a + (b - a) * t, for translation & scale keys.
+        /// </summary>
+        inline void Lerp(const float* a, const float* b, float t, float* out)
+        {
+#ifdef LINA_ANIMATION_SSE
+            const __m128 va = _mm_load_ps(a);
+            const __m128 vb = _mm_load_ps(b);
+            _mm_store_ps(out, _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), _mm_set1_ps(t))));
+#else
+            for (int i = 0; i < 4; i++)
+                out[i] = a[i] + (b[i] - a[i]) * t;
+#endif
+        }
+
+        /// <summary>
+        /// Normalized lerp along the shortest path, close enough to slerp for the small angles between two keys.
+        /// </summary>
+        inline void Nlerp(const float* a, const float* b, float t, float* out)
+        {
+#ifdef LINA_ANIMATION_SSE
+            const __m128 va = _mm_load_ps(a);
+            __m128       vb = _mm_load_ps(b);
+
+            // Horizontal dot product, flip b if the quaternions are in opposite hemispheres.
+            __m128 dot = _mm_mul_ps(va, vb);
+            dot        = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+            dot        = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+            const __m128 sign = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+            vb                = _mm_xor_ps(vb, sign);
+
+            const __m128 r   = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), _mm_set1_ps(t)));
+            __m128       len = _mm_mul_ps(r, r);
+            len              = _mm_add_ps(len, _mm_shuffle_ps(len, len, _MM_SHUFFLE(2, 3, 0, 1)));
+            len              = _mm_add_ps(len, _mm_shuffle_ps(len, len, _MM_SHUFFLE(1, 0, 3, 2)));
+            _mm_store_ps(out, _mm_div_ps(r, _mm_sqrt_ps(len)));
+#else
+            const float dot  = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+            const float sign = dot < 0.0f ? -1.0f : 1.0f;
+            float       len  = 0.0f;
+
+            for (int i = 0; i < 4; i++)
+            {
+                out[i] = a[i] + (b[i] * sign - a[i]) * t;
+                len += out[i] * out[i];
+            }
+
+            const float invLen = 1.0f / std::sqrt(len);
+            for (int i = 0; i < 4; i++)
+                out[i] *= invLen;
+#endif
+        }
+
+        /// <summary>
+        /// Builds a column major TRS matrix, same layout as glm::mat4.
+        /// </summary>
+        inline void Compose(const JointTransform& transform, float* out)
+        {
+            const float* q  = transform.m_rotation;
+            const float* s  = transform.m_scale;
+            const float  xx = q[0] * q[0], yy = q[1] * q[1], zz = q[2] * q[2];
+            const float  xy = q[0] * q[1], xz = q[0] * q[2], yz = q[1] * q[2];
+            const float  wx = q[3] * q[0], wy = q[3] * q[1], wz = q[3] * q[2];
+
+            out[0]  = (1.0f - 2.0f * (yy + zz)) * s[0];
+            out[1]  = (2.0f * (xy + wz)) * s[0];
+            out[2]  = (2.0f * (xz - wy)) * s[0];
+            out[3]  = 0.0f;
+            out[4]  = (2.0f * (xy - wz)) * s[1];
+            out[5]  = (1.0f - 2.0f * (xx + zz)) * s[1];
+            out[6]  = (2.0f * (yz + wx)) * s[1];
+            out[7]  = 0.0f;
+            out[8]  = (2.0f * (xz + wy)) * s[2];
+            out[9]  = (2.0f * (yz - wx)) * s[2];
+            out[10] = (1.0f - 2.0f * (xx + yy)) * s[2];
+            out[11] = 0.0f;
+            out[12] = transform.m_translation[0];
+            out[13] = transform.m_translation[1];
+            out[14] = transform.m_translation[2];
+            out[15] = 1.0f;
+        }
+
+        /// <summary>
+        /// out = a * b for column major 4x4 matrices, out must not alias a or b.
+        /// </summary>
+        inline void Multiply(const float* a, const float* b, float* out)
+        {
+#ifdef LINA_ANIMATION_SSE
+            const __m128 a0 = _mm_loadu_ps(a);
+            const __m128 a1 = _mm_loadu_ps(a + 4);
+            const __m128 a2 = _mm_loadu_ps(a + 8);
+            const __m128 a3 = _mm_loadu_ps(a + 12);
+
+            for (int i = 0; i < 4; i++)
+            {
+                const float* col = b + i * 4;
+                __m128       r   = _mm_mul_ps(a0, _mm_set1_ps(col[0]));
+                r                = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(col[1])));
+                r                = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(col[2])));
+                r                = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(col[3])));
+                _mm_storeu_ps(out + i * 4, r);
+            }
+#else
+            for (int i = 0; i < 4; i++)
+            {
+                for (int j = 0; j < 4; j++)
+                    out[i * 4 + j] = a[j] * b[i * 4] + a[4 + j] * b[i * 4 + 1] + a[8 + j] * b[i * 4 + 2] + a[12 + j] * b[i * 4 + 3];
+            }
+#endif
+        }
+        /// <summary>
+        /// Range normalized 16 bit key, out = min + q * scale. Reads 4 values, buffers holding keys need 2 bytes of padding.
+        /// </summary>
+        inline void DecodeRange(const uint16_t* q, const float* rangeMin, const float* rangeScale, float* out)
+        {
+#ifdef LINA_ANIMATION_SSE
+            const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(q));
+            const __m128  values = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, _mm_setzero_si128()));
+            _mm_store_ps(out, _mm_add_ps(_mm_load_ps(rangeMin), _mm_mul_ps(values, _mm_load_ps(rangeScale))));
+#else
+            for (int i = 0; i < 3; i++)
+                out[i] = rangeMin[i] + (float)q[i] * rangeScale[i];
+            out[3] = rangeMin[3];
+#endif
+        }
+
+        /// <summary>
+        /// Smallest three quaternion, the two low bits of the first two values hold the index of the dropped component.
+        /// Reads 4 values, buffers holding keys need 2 bytes of padding.
+        /// </summary>
+        inline void DecodeSmallestThree(const uint16_t* q, float* out)
+        {
+            const int   largest = (q[0] & 1) | ((q[1] & 1) << 1);
+            const float range   = 0.70710678f;
+
+#ifdef LINA_ANIMATION_SSE
+            const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(q));
+            __m128i       ints   = _mm_unpacklo_epi16(packed, _mm_setzero_si128());
+            ints                 = _mm_and_si128(ints, _mm_setr_epi32(0xFFFE, 0xFFFE, 0xFFFF, 0));
+            const __m128 scale   = _mm_setr_ps(2.0f * range / 65534.0f, 2.0f * range / 65534.0f, 2.0f * range / 65535.0f, 0.0f);
+            const __m128 offset  = _mm_setr_ps(-range, -range, -range, 0.0f);
+            __m128       v       = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(ints), scale), offset);
+
+            __m128 dot = _mm_mul_ps(v, v);
+            dot        = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(2, 3, 0, 1)));
+            dot        = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+            const __m128 w = _mm_sqrt_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(1.0f), dot), _mm_setzero_ps()));
+
+            // v is (a, b, c, 0), move w into the dropped component.
+            v = _mm_add_ps(v, _mm_and_ps(w, _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1))));
+
+            switch (largest)
+            {
+            case 0:
+                v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 1, 0, 3));
+                break;
+            case 1:
+                v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 1, 3, 0));
+                break;
+            case 2:
+                v = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 1, 0));
+                break;
+            default:
+                break;
+            }
+
+            _mm_store_ps(out, v);
+#else
+            const float a = (float)(q[0] & 0xFFFE) * (2.0f * range / 65534.0f) - range;
+            const float b = (float)(q[1] & 0xFFFE) * (2.0f * range / 65534.0f) - range;
+            const float c = (float)q[2] * (2.0f * range / 65535.0f) - range;
+            const float w = std::sqrt(std::fmax(1.0f - a * a - b * b - c * c, 0.0f));
+            float       values[3] = {a, b, c};
+
+            for (int i = 0, j = 0; i < 4; i++)
+                out[i] = i == largest ? w : values[j++];
+#endif
+        }
+    } // namespace AnimationMath
+} // namespace Lina::Graphics
+
+#endif
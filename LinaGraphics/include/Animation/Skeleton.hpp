@@ -29,7 +29,8 @@ SOFTWARE.
 /*
 Class: Skeleton
 
-
+Joint hierarchy stored as flat arrays, parents always come before their children so that local to model
+evaluation is a single forward pass. Owns the animation clips imported along with it.
 
 Timestamp: 12/7/2021 2:13:56 PM
 */
@@ -40,15 +41,28 @@ Timestamp: 12/7/2021 2:13:56 PM
 #define Skeleton_HPP
 
 // Headers here.
-#include "Rendering/RenderingCommon.hpp"
+#include "Animation/AnimationMath.hpp"
+#include "Math/Matrix.hpp"
+#include "Core/SizeDefinitions.hpp"
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace Lina::Graphics
 {
     class Animation;
 
+    /// <summary>
+    /// Scratch buffers for evaluating a skeleton, keep one per instance to avoid allocating every frame.
+    /// </summary>
+    struct SkeletonPose
+    {
+        std::vector<JointTransform> m_local;
+        std::vector<Matrix>         m_model;
+        std::vector<Matrix>         m_palette;
+    };
+
     class Skeleton
     {
 
@@ -56,15 +70,69 @@ namespace Lina::Graphics
         Skeleton() = default;
         ~Skeleton();
 
-        bool LoadSkeleton(const std::string& path);
+        Skeleton(const Skeleton&) = delete;
+        Skeleton& operator=(const Skeleton&) = delete;
+
+        /// <summary>
+        /// Adds a joint & returns its index, parent needs to be added before, -1 for root joints.
+        /// </summary>
+        int AddJoint(const std::string& name, int parent, const JointTransform& bindPose, const Matrix& inverseBindPose);
+
+        /// <summary>
+        /// Returns -1 if the skeleton doesn't have a joint with the given name.
+        /// </summary>
+        int GetJointIndex(const std::string& name) const;
+
+        /// <summary>
+        /// Samples the animation on top of the bind pose, null animation results in the bind pose.
+        /// Root joints are parented to the given transform, resulting palette is written into the pose.
+        /// </summary>
+        void Evaluate(const Animation* animation, float time, const Matrix& rootTransform, SkeletonPose& pose) const;
+
+        /// <summary>
+        /// Concatenates the local joint transforms down the hierarchy.
+        /// </summary>
+        void LocalToModel(const JointTransform* local, const Matrix& rootTransform, Matrix* outModel) const;
+
+        /// <summary>
+        /// Skinning matrices, model space joint transforms multiplied by the inverse bind poses.
+        /// </summary>
+        void BuildPalette(const Matrix* model, Matrix* outPalette) const;
+
+        /// <summary>
+        /// Takes the ownership of the animation, an existing clip with the same name is replaced.
+        /// </summary>
+        void AddAnimation(Animation* animation);
+
+        /// <summary>
+        /// Returns nullptr if there is no clip with the given name.
+        /// </summary>
+        Animation* GetAnimation(const std::string& name) const;
 
         bool IsLoaded() const
         {
-            return m_loaded;
+            return !m_parents.empty();
+        }
+
+        inline uint32 GetJointCount() const
+        {
+            return (uint32)m_parents.size();
+        }
+
+        inline const std::vector<std::string>& GetJointNames() const
+        {
+            return m_jointNames;
+        }
+
+        inline const std::vector<int>& GetParents() const
+        {
+            return m_parents;
         }
 
-        void SetVertexBoneDataToDefault(VertexBoneData& vertex);
-        void SetVertexBoneData(VertexBoneData& vertex, int boneID, float weight);
+        inline const std::vector<JointTransform>& GetBindPose() const
+        {
+            return m_bindPose;
+        }
 
         std::map<std::string, Animation*>& GetAnimations()
         {
@@ -72,13 +140,12 @@ namespace Lina::Graphics
         }
 
     private:
-        bool                              m_loaded = false;
-        std::vector<VertexBoneData>       m_vertexBoneData;
+        std::vector<std::string>          m_jointNames;
+        std::map<std::string, int>        m_jointIndices;
+        std::vector<int>                  m_parents;
+        std::vector<JointTransform>       m_bindPose;
+        std::vector<Matrix>               m_inverseBindPose;
         std::map<std::string, Animation*> m_animationMap;
-        std::map<std::string, BoneInfo>   m_boneInfoMap;
-
-        int   m_boneIDs[MAX_BONE_INFLUENCE];
-        float m_boneWeights[MAX_BONE_INFLUENCE];
     };
 } // namespace Lina::Graphics
 
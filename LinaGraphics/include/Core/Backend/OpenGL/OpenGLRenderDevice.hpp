@@ -30,7 +30,8 @@ SOFTWARE.
 Class: OpenGLRenderDevice
 
 Responsible for handling all Open GL related drawing functionalities. All GL commands are only stored and used
-within an instance of this class.
+within an instance of this class. Bound objects & render states are shadowed on the CPU, calls that wouldn't change
+anything are skipped & counted.
 
 Timestamp: 4/27/2019 10:12:16 PM
 */
@@ -42,15 +43,15 @@ Timestamp: 4/27/2019 10:12:16 PM
 
 #include "Math/Color.hpp"
 #include "Math/Matrix.hpp"
+#include "Rendering/RenderStateCache.hpp"
 #include "Rendering/RenderingCommon.hpp"
 
-#include <map>
+#include <vector>
 
 using namespace Lina;
 
 namespace Lina::Graphics
 {
-
     class OpenGLRenderDevice
     {
     public:
@@ -67,6 +68,21 @@ namespace Lina::Graphics
         /// </summary>
         void Initialize(int width, int height, DrawParams& defaultParams);
 
+        /// <summary>
+        /// Stores the statistics of the previous frame & resets the counters, called at the start of each frame.
+        /// </summary>
+        void BeginFrame();
+
+        inline const RenderDeviceStats& GetLastFrameStats() const
+        {
+            return m_stateCache.GetLastFrameStats();
+        }
+
+        inline const RenderDeviceStats& GetStats() const
+        {
+            return m_stateCache.GetStats();
+        }
+
         /// <summary>
         /// Creates 2D texture in GL, use CreateTexture2DEmpty for framebuffer textures.
         /// </summary>
@@ -102,6 +118,11 @@ namespace Lina::Graphics
         /// </summary>
         void UpdateTextureParameters(uint32 bindMode, uint32 id, SamplerParameters samplerParmas);
 
+        /// <summary>
+        /// Overwrites a region of the base level of an existing 2D texture, unsigned byte pixels.
+        /// </summary>
+        void UpdateTexture2D(uint32 id, const Vector2i& offset, const Vector2i& size, PixelFormat pixelFormat, const void* data);
+
         /// <summary>
         /// Deletes an existing GL texture.
         /// </summary>
@@ -128,6 +149,19 @@ namespace Lina::Graphics
         /// </summary>
         uint32 CreateLineVertexArray();
 
+        /// <summary>
+        /// VAO helper for batched debug lines, interleaved position & color with a single dynamic buffer.
+        /// Fill using UpdateVertexArrayBuffer with buffer index 0.
+        /// </summary>
+        uint32 CreateDebugLineVertexArray();
+
+        /// <summary>
+        /// VAO helper for batched sprites, interleaved position, uv & RGBA8 color with a single dynamic buffer
+        /// & a static index buffer holding the quad pattern for maxQuads quads.
+        /// Fill using UpdateVertexArrayBuffer with buffer index 0, draw using DrawBaseVertex.
+        /// </summary>
+        uint32 CreateSpriteVertexArray(uint32 maxQuads);
+
         /// <summary>
         /// VAO helper for creating HDRI cubemaps.
         /// </summary>
@@ -259,6 +293,16 @@ namespace Lina::Graphics
         /// <param name="pixels"></param>
         void GetTextureImage(uint32 texture, PixelFormat format, TextureBindMode bind, void*& pixels);
 
+        /// <summary>
+        /// Reads a single face of the given cubemap into the given pixel array, data is read as floats.
+        /// </summary>
+        void GetCubemapFaceImage(uint32 texture, uint32 face, PixelFormat format, void* pixels);
+
+        /// <summary>
+        /// Uploads float pixel data into a single face of the given cubemap.
+        /// </summary>
+        void UpdateCubemapFace(uint32 texture, uint32 face, Vector2i size, PixelFormat internalFormat, PixelFormat format, const float* pixels);
+
         void BindUniformBuffer(uint32 buffer, uint32 bindingPoint);
         void BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName);
         void UpdateUniformBuffer(uint32 buffer, const void* data, uintptr offset, uintptr dataSize);
@@ -270,7 +314,8 @@ namespace Lina::Graphics
         void SetDrawParameters(const DrawParams& drawParams);
         void Draw(uint32 vao, const DrawParams& drawParams, uint32 numInstances, uint32 numElements, bool drawArrays = false);
         void DrawLine(float width);
-        void DrawLine(uint32 shader, const Matrix& model, const Vector3& from, const Vector3& to, float width = 1.0f);
+        void DrawLines(uint32 vao, uint32 vertexCount, float width = 1.0f);
+        void DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex);
         void UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, const float f);
         void UpdateShaderUniformInt(uint32 shader, const std::string& uniform, const int f);
         void UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& color);
@@ -302,46 +347,27 @@ namespace Lina::Graphics
         void SetupTextureParameters(uint32 textureTarget, SamplerParameters samplerParams, bool useBorder = false, float* borderColor = NULL);
         void SetStencilWriteMask(uint32 mask);
         void SetDepthTestEnable(bool enable);
+        void SetActiveTextureUnit(uint32 unit);
+        void BindTexture(uint32 target, uint32 texture);
+        void SetUBO(uint32 ubo);
+
+        /// <summary>
+        /// Returns nullptr if the VAO wasn't created through CreateVertexArray or one of the dynamic buffer helpers.
+        /// </summary>
+        VertexArrayData* GetVertexArrayData(uint32 vao);
+        ShaderProgram&   GetShaderProgram(uint32 shader);
 
     private:
         static OpenGLRenderDevice* s_renderDevice;
 
-        uint32                            m_boundShader   = 0;
-        uint32                            m_boundVAO      = 0;
-        uint32                            m_boundFBO      = 0;
-        uint32                            m_boundReadFBO  = 0;
-        uint32                            m_boundWriteFBO = 0;
-        uint32                            m_viewportFBO   = 0;
-        uint32                            m_boundRBO      = 0;
-        uint32                            m_boundUBO;
-        uint32                            m_boundTextureUnit;
-        Vector2i                         m_boundViewportSize;
-        Vector2i                         m_boundViewportPos;
-        std::map<uint32, VertexArrayData> m_vaoMap;
-        std::map<uint32, ShaderProgram>   m_shaderProgramMap;
-        std::string                       m_shaderVersion;
-        uint32                            m_GLVersion;
-
-        // Current drawing parameters.
-        FaceCulling m_usedFaceCulling;
-        DrawFunc    m_usedDepthFunction;
-        BlendFunc   m_usedSourceBlending;
-        BlendFunc   m_usedDestinationBlending;
-        DrawFunc    m_usedStencilFunction;
-        StencilOp   m_usedStencilFail;
-        StencilOp   m_usedStencilPassButDepthFail;
-        StencilOp   m_usedStencilPass;
-
-        // Current operation parameters.
-        uint32 m_usedStencilTestMask        = 0;
-        uint32 m_usedStencilWriteMask       = 0;
-        int32  m_usedStencilComparisonValue = 0;
-        bool   m_isBlendingEnabled          = true;
-        bool   m_isStencilTestEnabled       = true;
-        bool   m_isScissorsTestEnabled      = false;
-        bool   m_shouldWriteDepth           = true;
-        bool   m_isDepthTestEnabled         = true;
-        Color  m_currentClearColor          = Color::Black;
+        RenderStateCache m_stateCache;
+        uint32           m_viewportFBO = 0;
+        std::string      m_shaderVersion;
+        uint32           m_GLVersion;
+
+        // Indexed by the GL names, which GL hands out as small sequential integers.
+        std::vector<VertexArrayData> m_vaoTable;
+        std::vector<ShaderProgram>   m_shaderProgramTable;
     };
 } // namespace Lina::Graphics
 
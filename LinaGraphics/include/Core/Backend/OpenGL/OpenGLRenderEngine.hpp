@@ -47,13 +47,17 @@ Timestamp: 4/15/2019 12:26:31 PM
 #include "ECS/Systems/LightingSystem.hpp"
 #include "ECS/Systems/ModelNodeSystem.hpp"
 #include "ECS/Systems/ReflectionSystem.hpp"
+#include "ECS/Systems/SpatialIndexSystem.hpp"
 #include "ECS/Systems/SpriteRendererSystem.hpp"
+#include "ECS/Systems/StaticBatchSystem.hpp"
 #include "OpenGLRenderDevice.hpp"
 #include "OpenGLWindow.hpp"
+#include "Rendering/DebugDrawBatcher.hpp"
 #include "Rendering/Mesh.hpp"
 #include "Rendering/Model.hpp"
 #include "Rendering/PostProcessEffect.hpp"
 #include "Rendering/RenderBuffer.hpp"
+#include "Rendering/RenderGraph.hpp"
 #include "Rendering/RenderSettings.hpp"
 #include "Rendering/RenderingCommon.hpp"
 #include "Rendering/UniformBuffer.hpp"
@@ -77,6 +81,7 @@ namespace Lina
         class EventSystem;
         struct EAllResourcesOfTypeLoaded;
         struct EDrawLine;
+        struct EDrawLines;
         struct EDrawBox;
         struct EDrawCircle;
         struct EDrawSphere;
@@ -153,6 +158,11 @@ namespace Lina::Graphics
         /// </summary>
         void CaptureReflections(Texture& writeTexture, const Vector3& areaLocation, const Vector2i& resolution);
 
+        /// <summary>
+        /// Captures a single face of the cubemap, used for spreading dynamic reflection captures over multiple frames.
+        /// </summary>
+        void CaptureReflectionFace(Texture& writeTexture, const Vector3& areaLocation, const Vector2i& resolution, uint32 face);
+
         /// <summary>
         /// Draws the current skybox into an irradiance cubemap.
         /// </summary>
@@ -174,6 +184,11 @@ namespace Lina::Graphics
         /// </summary>
         void DrawLine(Vector3 p1, Vector3 p2, Color col, float width = 1.0f);
 
+        /// <summary>
+        /// Adds the edges of the frustum described by the given view-projection matrix to the debug buffer.
+        /// </summary>
+        void DrawFrustum(const Matrix& viewProjection, Color col);
+
         /// <summary>
         /// Pass in any run-time constructed shader. The shader will be drawn to a full-screen quad & added as a
         /// post-process effect.
@@ -235,6 +250,26 @@ namespace Lina::Graphics
         {
             return &m_frustumSystem;
         }
+        inline ECS::SpatialIndexSystem* GetSpatialIndexSystem()
+        {
+            return &m_spatialIndexSystem;
+        }
+        inline ECS::StaticBatchSystem* GetStaticBatchSystem()
+        {
+            return &m_staticBatchSystem;
+        }
+        inline ECS::AnimationSystem* GetAnimationSystem()
+        {
+            return &m_animationSystem;
+        }
+        inline ECS::SpriteRendererSystem* GetSpriteRendererSystem()
+        {
+            return &m_spriteRendererSystem;
+        }
+        inline DebugDrawBatcher* GetDebugDrawBatcher()
+        {
+            return &m_debugDrawBatcher;
+        }
         inline Texture* GetDefaultTexture()
         {
             return &m_defaultTexture;
@@ -275,10 +310,21 @@ namespace Lina::Graphics
         {
             m_currentSpotLightCount = count;
         }
+        /// <summary>
+        /// View independent systems, updated once per frame & shared by every view rendered during the frame.
+        /// </summary>
         inline const ECS::SystemList& GetRenderingPipeline()
         {
             return m_renderingPipeline;
         }
+
+        /// <summary>
+        /// View dependent systems, e.g. camera & culling, updated for each rendered view.
+        /// </summary>
+        inline const ECS::SystemList& GetViewPipeline()
+        {
+            return m_viewPipeline;
+        }
         inline const ECS::SystemList& GetAnimationPipeline()
         {
             return m_animationPipeline;
@@ -307,7 +353,10 @@ namespace Lina::Graphics
         void Shutdown();
         void Render(float interpolation);
         void Tick(float delta);
-        void UpdateSystems(float interpolation);
+        void ExtractScene();
+        void UpdateView();
+        void CullView(const Frustum& frustum, const Vector3& location);
+        void RestoreCameraView();
         void DrawSceneObjects(DrawParams& drawpParams, Material* overrideMaterial = nullptr, bool completeFlush = true);
         void DrawSkybox();
         void SetHDRIData(Material* mat);
@@ -316,6 +365,7 @@ namespace Lina::Graphics
 
     private:
         void OnDrawLine(const Event::EDrawLine& event);
+        void OnDrawLines(const Event::EDrawLines& event);
         void OnDrawBox(const Event::EDrawBox& event);
         void OnDrawCircle(const Event::EDrawCircle& event);
         void OnDrawSphere(const Event::EDrawSphere& event);
@@ -330,13 +380,22 @@ namespace Lina::Graphics
         void ConstructRenderTargets();
         void DumpMemory();
         void Draw();
-        void DrawFinalize(RenderTarget* overrideTarget = nullptr);
+        void BuildFrameGraph();
+        void RealizeFrameGraph();
+        void ReleaseFrameGraphTextures();
+        void DrawPointLightShadows();
+        void DrawGBuffer();
+        void DrawLighting();
+        void DrawBloom();
+        void DrawComposite();
         void UpdateUniformBuffers();
         void CalculateHDRICubemap(Texture& hdriTexture, glm::mat4& captureProjection, glm::mat4 views[6]);
         void CalculateHDRIIrradiance(Matrix& captureProjection, Matrix views[6]);
         void CalculateHDRIPrefilter(Matrix& captureProjection, Matrix views[6]);
         void CalculateHDRIBRDF(Matrix& captureProjection, Matrix views[6]);
 
+        Texture* GetFrameGraphTexture(uint32 texture);
+
     private:
         static OpenGLRenderEngine* s_renderEngine;
         ApplicationMode            m_appMode   = ApplicationMode::Editor;
@@ -344,12 +403,8 @@ namespace Lina::Graphics
         OpenGLRenderDevice         m_renderDevice;
         Event::EventSystem*        m_eventSystem = nullptr;
 
-        RenderTarget m_primaryRenderTarget;
         RenderTarget m_secondaryRenderTarget;
         RenderTarget m_previewRenderTarget;
-        RenderTarget m_primaryMSAATarget;
-        RenderTarget m_pingPongRenderTarget1;
-        RenderTarget m_pingPongRenderTarget2;
         RenderTarget m_hdriCaptureRenderTarget;
         RenderTarget m_reflectionCaptureRenderTarget;
         RenderTarget m_skyboxIrradianceCaptureRenderTarget;
@@ -357,8 +412,6 @@ namespace Lina::Graphics
         RenderTarget m_pLightShadowTargets[MAX_POINT_LIGHTS];
         RenderTarget m_gBuffer;
 
-        RenderBuffer m_primaryBuffer;
-        RenderBuffer m_primaryMSAABuffer;
         RenderBuffer m_secondaryRenderBuffer;
         RenderBuffer m_previewRenderBuffer;
         RenderBuffer m_hdriCaptureRenderBuffer;
@@ -366,20 +419,27 @@ namespace Lina::Graphics
         RenderBuffer m_skyboxIrradianceCaptureRenderBuffer;
         RenderBuffer m_gBufferRenderBuffer;
 
-        Texture m_gBufferPosition;
-        Texture m_gBufferNormal;
-        Texture m_gBufferAlbedo;
-        Texture m_gBufferEmission;
-        Texture m_gBufferMetallicRoughnessAOWorkflow;
+        // Screen sized targets are transient textures of the frame graph, rebuilt when the size or the bloom setting changes.
+        RenderGraph           m_frameGraph;
+        std::vector<Texture*> m_frameGraphTextures;
+        RenderTarget*         m_sceneColorTarget    = nullptr;
+        RenderTarget*         m_bloomTargets[2]     = {nullptr, nullptr};
+        RenderTarget*         m_frameOutputOverride = nullptr;
+        Vector2i              m_frameGraphSize      = Vector2i(0, 0);
+        bool                  m_frameGraphBloom     = false;
+        uint32                m_fgPointLightShadows = 0;
+        uint32                m_fgOutput            = 0;
+        uint32                m_fgGBuffer[5]        = {0, 0, 0, 0, 0};
+        uint32                m_fgSceneColor        = 0;
+        uint32                m_fgBloom[2]          = {0, 0};
+
+        // Set while rendering a model preview through the frame graph.
+        Model*    m_previewModel    = nullptr;
+        Material* m_previewMaterial = nullptr;
+        Matrix    m_previewMatrix;
 
-        Texture  m_primaryMSAARTTexture0;
-        Texture  m_primaryMSAARTTexture1;
-        Texture  m_primaryRTTexture0;
-        Texture  m_primaryRTTexture1;
         Texture  m_secondaryRTTexture;
         Texture  m_previewRTTexture;
-        Texture  m_pingPongRTTexture1;
-        Texture  m_pingPongRTTexture2;
         Texture  m_hdriCubemap;
         Texture  m_hdriIrradianceMap;
         Texture  m_hdriPrefilterMap;
@@ -394,7 +454,6 @@ namespace Lina::Graphics
 
         // Frame buffer texture parameters
         SamplerParameters m_primaryRTParams;
-        SamplerParameters m_pingPongRTParams;
         SamplerParameters m_shadowsRTParams;
 
         Mesh m_quadMesh;
@@ -446,7 +505,10 @@ namespace Lina::Graphics
         ECS::SpriteRendererSystem   m_spriteRendererSystem;
         ECS::LightingSystem         m_lightingSystem;
         ECS::FrustumSystem          m_frustumSystem;
+        ECS::SpatialIndexSystem     m_spatialIndexSystem;
+        ECS::StaticBatchSystem      m_staticBatchSystem;
         ECS::SystemList             m_renderingPipeline;
+        ECS::SystemList             m_viewPipeline;
         ECS::SystemList             m_animationPipeline;
         Resources::ResourceStorage* m_storage = nullptr;
 
@@ -455,23 +517,26 @@ namespace Lina::Graphics
         uint32 m_screenQuadVAO = 0;
         uint32 m_hdriCubeVAO   = 0;
         uint32 m_lineVAO       = 0;
+        uint32 m_debugLineVAO  = 0;
 
         int m_currentSpotLightCount  = 0;
         int m_currentPointLightCount = 0;
 
-        Vector2i m_hdriResolution             = Vector2i(512, 512);
-        Vector2i m_shadowMapResolution        = Vector2i(2048, 2048);
-        Vector2i m_screenPos                  = Vector2i(0, 0);
-        Vector2i m_screenSize                 = Vector2i(0, 0);
-        Vector2i m_pLightShadowResolution     = Vector2i(1024, 1024);
-        Vector2i m_skyboxIrradianceResolution = Vector2i(1024, 1024);
-        bool     m_firstFrameDrawn            = false;
-        float    m_deltaTime                  = 0.0f;
-        float    m_elapsedTime                = 0.0f;
-        Vector2  m_mousePosition              = Vector2::Zero;
-
-        std::queue<DebugLine>                m_debugLineQueue;
-        std::queue<DebugIcon>                m_debugIconQueue;
+        Vector2i m_hdriResolution              = Vector2i(512, 512);
+        Vector2i m_shadowMapResolution         = Vector2i(2048, 2048);
+        Vector2i m_screenPos                   = Vector2i(0, 0);
+        Vector2i m_screenSize                  = Vector2i(0, 0);
+        Vector2i m_pLightShadowResolution      = Vector2i(1024, 1024);
+        Vector2i m_skyboxIrradianceResolution  = Vector2i(1024, 1024);
+        Vector2i m_reflectionCaptureResolution = Vector2i(512, 512);
+        bool     m_firstFrameDrawn             = false;
+        uint32   m_frame                       = 0;
+        float    m_deltaTime                   = 0.0f;
+        float    m_elapsedTime                 = 0.0f;
+        Vector2  m_mousePosition               = Vector2::Zero;
+
+        DebugDrawBatcher                     m_debugDrawBatcher;
+        std::vector<Matrix>                  m_debugIconMatrices;
         std::map<Shader*, PostProcessEffect> m_postProcessMap;
     };
 
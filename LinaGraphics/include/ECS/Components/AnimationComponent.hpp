@@ -29,7 +29,7 @@ SOFTWARE.
 /*
 Class: AnimationComponent
 
-
+Plays the named clip of the model's skeleton on the entity's skinned meshes, entity needs a model node component.
 
 Timestamp: 12/7/2021 4:13:25 PM
 */
@@ -49,6 +49,9 @@ namespace Lina::ECS
     struct AnimationComponent : public Component
     {
         std::string m_animationName;
+        float       m_time  = 0.0f;
+        float       m_speed = 1.0f;
+        bool        m_loop  = true;
     };
 } // namespace Lina::ECS
 
@@ -67,7 +67,15 @@ namespace Lina::ECS
 
         int                                        m_nodeIndex = -1;
         Resources::ResourceHandle<Graphics::Model> m_model;
-        bool                                       m_culled = false;
+
+        // World bounds cache, maintained by the spatial index system & only recalculated if the transform changes.
+        Graphics::ModelNode* m_boundsNode            = nullptr;
+        Vector3              m_boundsLocation        = Vector3::Zero;
+        Quaternion           m_boundsRotation        = Quaternion();
+        Vector3              m_boundsScale           = Vector3::Zero;
+        Vector3              m_worldBoundsCenter     = Vector3::Zero;
+        Vector3              m_worldBoundsHalfExtent = Vector3::Zero;
+        int                  m_spatialProxy          = -1;
 
     private:
         friend class cereal::access;
@@ -0,0 +1,57 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: OccluderComponent
+
+Marks an entity's model node as an occluder, the occluder geometry of its meshes is rasterized into the
+occlusion buffer & hides other renderables behind it. The model has to be imported as an occluder.
+
+Timestamp: 1/30/2022 11:02:51 AM
+*/
+
+#pragma once
+
+#ifndef OccluderComponent_HPP
+#define OccluderComponent_HPP
+
+#include "ECS/Component.hpp"
+
+namespace Lina::ECS
+{
+    LINA_COMPONENT("Occluder", "ICON_FA_EYE_SLASH", "Rendering", "true", "true")
+    struct OccluderComponent : public Component
+    {
+        template <class Archive> void serialize(Archive& archive)
+        {
+            archive(m_isEnabled); // serialize things by passing them to the archive
+        }
+    };
+} // namespace Lina::ECS
+
+#endif
@@ -66,6 +66,11 @@ namespace Lina::ECS
 
         Graphics::Texture m_cubemap;
 
+        // Capture state, maintained by the reflection system.
+        uint32 m_nextFace         = 0;
+        uint32 m_lastCaptureFrame = 0;
+        bool   m_isCaptured       = false;
+
         template <class Archive>
         void serialize(Archive& archive)
         {
@@ -37,26 +37,65 @@ Timestamp: 10/1/2020 9:26:21 AM
 #define SpriteRendererComponent_HPP
 
 #include "ECS/Component.hpp"
+#include "Rendering/Material.hpp"
+#include "Resources/ResourceHandle.hpp"
 
+#include <cereal/access.hpp>
+#include <cereal/cereal.hpp>
 #include <string>
 
 namespace Lina::ECS
 {
+    /// <summary>
+    /// Layout sprites were saved with before the component was versioned, only read from levels saved back then.
+    /// </summary>
+    struct SpriteRendererComponentV0
+    {
+        std::string m_materialPaths = "";
+        bool        m_isEnabled     = true;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(m_materialPaths, m_isEnabled);
+        }
+    };
+
     LINA_COMPONENT("Sprite Component", "ICON_FA_EYE", "Rendering", "true", "true")
     struct SpriteRendererComponent : public Component
     {
-        int         m_materialID    = -1;
-        std::string m_materialPaths = "";
+        using LegacyLayout = SpriteRendererComponentV0;
+
+        /// <summary>
+        /// Sprites of old levels keep their material & are drawn on layer 0.
+        /// </summary>
+        inline void MigrateFrom(const SpriteRendererComponentV0& legacy)
+        {
+            Resources::ResourceStorage* storage = Resources::ResourceStorage::Get();
+            m_material.m_sid                    = StringID(legacy.m_materialPaths.c_str()).value();
+            m_material.m_value                  = storage->Exists<Graphics::Material>(m_material.m_sid) ? storage->GetResource<Graphics::Material>(m_material.m_sid) : nullptr;
+            m_layer                             = 0;
+            m_isEnabled                         = legacy.m_isEnabled;
+        }
 
-        // Editor properties, not inside the macro to avoid any struct size mismatch during serialization.
-        int         m_selectedMatID   = -1;
-        std::string m_selectedMatPath = "";
+        LINA_PROPERTY("Material", "Material", "Diffuse texture is packed into the sprite atlas, object color tints the sprite.")
+        Resources::ResourceHandle<Graphics::Material> m_material;
 
-        template <class Archive> void serialize(Archive& archive)
+        LINA_PROPERTY("Layer", "Int", "Sprites on lower layers are drawn first.")
+        int m_layer = 0;
+
+    private:
+        friend class cereal::access;
+
+        // Version 1 is the first versioned layout, older levels are read as SpriteRendererComponentV0.
+        template <class Archive>
+        void serialize(Archive& archive, std::uint32_t const version)
         {
-            archive(m_materialPaths, m_isEnabled); // serialize things by passing them to the archive
+            archive(m_material, m_layer, m_isEnabled);
         }
     };
 } // namespace Lina::ECS
 
+CEREAL_CLASS_VERSION(Lina::ECS::SpriteRendererComponent, 1);
+
 #endif
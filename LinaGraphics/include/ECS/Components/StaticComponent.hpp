@@ -0,0 +1,57 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: StaticComponent
+
+Marks an entity's model node as immovable geometry, its meshes are merged into the static batches when the level
+is installed. Moving the entity takes it out of its batch.
+
+Timestamp: 2/3/2022 2:12:06 PM
+*/
+
+#pragma once
+
+#ifndef StaticComponent_HPP
+#define StaticComponent_HPP
+
+#include "ECS/Component.hpp"
+
+namespace Lina::ECS
+{
+    LINA_COMPONENT("Static", "ICON_FA_ANCHOR", "Rendering", "true", "true")
+    struct StaticComponent : public Component
+    {
+        template <class Archive> void serialize(Archive& archive)
+        {
+            archive(m_isEnabled); // serialize things by passing them to the archive
+        }
+    };
+} // namespace Lina::ECS
+
+#endif
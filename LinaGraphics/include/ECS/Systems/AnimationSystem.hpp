@@ -29,7 +29,9 @@ SOFTWARE.
 /*
 Class: AnimationSystem
 
-
+Advances the animation components & evaluates the skeleton of each animated entity on the job workers,
+resulting skinning palettes are then uploaded into a uniform buffer per instance on the main thread.
+Instances of entities that weren't updated during the frame are released.
 
 Timestamp: 12/7/2021 4:10:26 PM
 */
@@ -40,17 +42,37 @@ Timestamp: 12/7/2021 4:10:26 PM
 #define AnimationSystem_HPP
 
 // Headers here.
+#include "Animation/Skeleton.hpp"
+#include "Core/CommonECS.hpp"
+#include "Core/RenderBackendFwd.hpp"
 #include "ECS/System.hpp"
 
+#include <unordered_map>
+#include <vector>
+
 namespace Lina
 {
     namespace Graphics
     {
-        class OpenGLRenderEngine;
-    }
+        class Animation;
+        class Model;
+    } // namespace Graphics
 } // namespace Lina
+
 namespace Lina::ECS
 {
+    struct AnimationInstance
+    {
+        Graphics::Model*           m_model         = nullptr;
+        const Graphics::Animation* m_animation     = nullptr;
+        Graphics::SkeletonPose     m_pose;
+        Matrix                     m_rootTransform = Matrix::Identity();
+        float                      m_time          = 0.0f;
+        int                        m_nodeIndex     = -1;
+        uint32                     m_paletteBuffer = 0;
+        uint32                     m_lastSeenFrame = 0;
+    };
+
     class AnimationSystem : public System
     {
 
@@ -61,7 +83,19 @@ namespace Lina::ECS
         virtual void Initialize(const std::string& name) override;
         virtual void UpdateComponents(float delta) override;
 
-    protected:
+        /// <summary>
+        /// Returns the uniform buffer holding the entity's skinning palette, 0 if the entity isn't animated.
+        /// </summary>
+        uint32 GetPaletteBuffer(Entity entity) const;
+
+    private:
+        void UploadPalette(AnimationInstance& instance);
+
+    private:
+        Graphics::RenderDevice*                       m_renderDevice = nullptr;
+        std::unordered_map<Entity, AnimationInstance> m_instances;
+        std::vector<AnimationInstance*>               m_activeInstances;
+        uint32                                        m_frame = 0;
     };
 } // namespace Lina::ECS
 
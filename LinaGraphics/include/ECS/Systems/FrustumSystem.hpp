@@ -44,6 +44,8 @@ Timestamp: 12/24/2021 12:59:35 AM
 #include "Core/CommonECS.hpp"
 #include "ECS/System.hpp"
 #include "Math/AABB.hpp"
+#include "Rendering/OcclusionCuller.hpp"
+#include "Rendering/ViewCuller.hpp"
 
 namespace Lina
 {
@@ -89,8 +91,62 @@ namespace Lina::ECS
         /// </summary>
         bool GetAllBoundsInEntity(Entity ent, std::vector<Vector3>& boundsPositions, std::vector<Vector3>& boundsHalfExtents);
 
+        /// <summary>
+        /// Culls against the frustum of an additional view, e.g. a shadow or a reflection capture. Until
+        /// RestoreCameraVisibility is called, IsVisible answers for that view. Occlusion culling is camera only.
+        /// </summary>
+        void CullView(const Frustum& frustum);
+
+        /// <summary>
+        /// Brings back the visibility calculated for the camera during the last update.
+        /// </summary>
+        void RestoreCameraVisibility();
+
+        /// <summary>
+        /// Returns false if the entity's model node was completely outside of the current view's frustum, the camera's
+        /// unless an additional view is culled. Entities that aren't in the spatial index yet are considered visible.
+        /// </summary>
+        inline bool IsVisible(Entity ent) const
+        {
+            return m_viewCuller.IsVisible(ent);
+        }
+
+        /// <summary>
+        /// When enabled, entities passing the frustum test are also tested against the depth of visible occluder
+        /// entities & hidden ones are reported as not visible.
+        /// </summary>
+        inline void SetOcclusionCullingEnabled(bool enabled)
+        {
+            m_occlusionCullingEnabled = enabled;
+        }
+
+        /// <summary>
+        /// Changes when the set of visible entities differs from the previous update, restoring the camera brings back its version.
+        /// </summary>
+        inline uint32 GetVisibilityVersion() const
+        {
+            return m_viewCuller.GetVersion();
+        }
+
+        inline bool GetOcclusionCullingEnabled() const
+        {
+            return m_occlusionCullingEnabled;
+        }
+
+        inline const Graphics::OcclusionCullerStats& GetOcclusionStats() const
+        {
+            return m_occlusionCuller.GetStats();
+        }
+
+    private:
+        uint32 CullFrustum(const Frustum& frustum);
+        void   CullOccluded(uint32& visibleMeshes);
+
     private:
-        Graphics::RenderEngine* m_renderEngine = nullptr;
+        Graphics::RenderEngine*   m_renderEngine = nullptr;
+        Graphics::ViewCuller      m_viewCuller;
+        Graphics::OcclusionCuller m_occlusionCuller;
+        bool                      m_occlusionCullingEnabled = true;
     };
 } // namespace Lina::ECS
 
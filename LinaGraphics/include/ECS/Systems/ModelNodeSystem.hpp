@@ -32,6 +32,11 @@ Class: ModelNodeSystem
 Responsible for adding all the mesh renderers into a pool which is then
 flushed to draw those renderers' data by the OpenGLRenderEngine.
 
+Each model node entity owns a retained render proxy in the proxy table, which is created when the component is
+added & synced once per frame. Batch contents are kept between frames & visible lists are only rebuilt when the
+batch or the frustum visibility changes. Dirty visible lists are rebuilt on the workers, proxies & batches are only
+modified on the main thread.
+
 Timestamp: 4/27/2019 5:38:44 PM
 */
 
@@ -43,66 +48,35 @@ Timestamp: 4/27/2019 5:38:44 PM
 #include "Core/CommonApplication.hpp"
 #include "Core/CommonECS.hpp"
 #include "Core/RenderBackendFwd.hpp"
+#include "Core/SizeDefinitions.hpp"
 #include "ECS/System.hpp"
 #include "Math/Matrix.hpp"
-
-#include <map>
-#include <queue>
+#include "Rendering/DrawListExtractor.hpp"
+#include "Rendering/RenderProxyTable.hpp"
 
 namespace Lina
 {
+    namespace Event
+    {
+        struct ELevelInstalled;
+        struct ELevelUninstalled;
+    } // namespace Event
 
     namespace Graphics
     {
         class Material;
-        class Skeleton;
-        class VertexArray;
-        struct DrawParams;
-
-        struct BatchDrawData
-        {
-            Graphics::VertexArray* m_vertexArray;
-            Graphics::Material*    m_material;
-            float                  m_distance;
-        };
-
-        struct BatchModelData
-        {
-            std::vector<Matrix> m_models;
-            std::vector<Matrix> m_boneTransformations;
-        };
-
-        class ModelNode;
         class Model;
+        class ModelNode;
+        struct DrawParams;
     } // namespace Graphics
 } // namespace Lina
 
 namespace Lina::ECS
 {
-    struct EntityDataComponent;
-
     class ModelNodeSystem : public System
     {
 
     public:
-        typedef std::tuple<Graphics::BatchDrawData, Graphics::BatchModelData> BatchPair;
-
-        struct BatchComparison
-        {
-            bool const operator()(const BatchPair& lhs, const BatchPair& rhs) const
-            {
-                return std::get<0>(lhs).m_distance < std::get<0>(rhs).m_distance;
-            }
-        };
-
-        struct BatchDrawDataComp
-        {
-            bool const operator()(const Graphics::BatchDrawData& lhs, const Graphics::BatchDrawData& rhs) const
-            {
-                return std::tie(lhs.m_vertexArray, lhs.m_material) < std::tie(rhs.m_vertexArray, rhs.m_material);
-            }
-        };
-
         ModelNodeSystem()          = default;
         virtual ~ModelNodeSystem() = default;
 
@@ -116,40 +90,69 @@ namespace Lina::ECS
         void CreateModelHierarchy(Graphics::Model* model);
 
         /// <summary>
-        /// Pushes an object into the opaque render stack.
+        /// Draws all visible objects in the opaque batches. Batches are retained between frames, so completeFlush doesn't clear them.
         /// </summary>
-        void RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Skeleton& skeleton, Graphics::Material* material, const Matrix& transformIn);
+        void FlushOpaque(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
 
         /// <summary>
-        /// Pushes the given vertex array into the transparent render stack.
+        /// Draws all visible transparent objects back to front. Instances are retained between frames, so completeFlush doesn't clear them.
         /// </summary>
-        void RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Skeleton& skeleton, Graphics::Material* material, const Matrix& transformIn, float priority);
+        void FlushTransparent(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
 
         /// <summary>
-        /// Draws all objects in the opaque stack.
+        /// Draws a single model given the root node.
         /// </summary>
-        void FlushOpaque(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
+        void FlushModelNode(Graphics::ModelNode* node, Matrix& parentMatrix, Graphics::DrawParams& params, Graphics::Material* overrideMaterial = nullptr);
 
         /// <summary>
-        /// Draws all objects in the transparent stack.
+        /// Rebuilds the entity's proxy during the next update, e.g. when it enters or leaves a static batch.
         /// </summary>
-        void FlushTransparent(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
+        void InvalidateProxy(Entity entity);
 
         /// <summary>
-        /// Draws a single model given the root node.
+        /// View dependent step, rebuilds the visible lists from the frustum system's visibility & sorts the transparent
+        /// instances for the active camera. Proxies are only synced once per frame.
         /// </summary>
-        void FlushModelNode(Graphics::ModelNode* node, Matrix& parentMatrix, Graphics::DrawParams& params, Graphics::Material* overrideMaterial = nullptr);
+        void UpdateVisibleLists();
+
+        /// <summary>
+        /// Same as above for any rendered view, transparent instances are sorted back to front from the view's location.
+        /// </summary>
+        void UpdateVisibleLists(const Vector3& viewLocation);
+
+        /// <summary>
+        /// Returns the number of entities that own a render proxy.
+        /// </summary>
+        inline uint32 GetProxyCount() const
+        {
+            return (uint32)m_proxyTable.GetProxies().size();
+        }
+
+        /// <summary>
+        /// Returns the number of proxies that were rebuilt or moved during the last update, 0 on a static scene.
+        /// </summary>
+        inline uint32 GetUpdatedProxyCount() const
+        {
+            return m_proxyTable.GetUpdatedProxyCount();
+        }
 
     private:
         void ConstructEntityHierarchy(Entity entity, Matrix& parentTransform, Graphics::Model* model, Graphics::ModelNode* node);
+        void OnLevelInstalled(const Event::ELevelInstalled& ev);
+        void OnLevelUninstalled(const Event::ELevelUninstalled& ev);
+        void OnModelNodeAdded(entt::registry& reg, entt::entity ent);
+        void OnModelNodeRemoved(entt::registry& reg, entt::entity ent);
 
     private:
-        Graphics::RenderDevice* m_renderDevice = nullptr;
-        Graphics::RenderEngine* m_renderEngine = nullptr;
-        ApplicationMode         m_appMode      = ApplicationMode::Editor;
-        // Map & queue to see the list of same vertex array & textures to compress them into single draw call.
-        std::map<Graphics::BatchDrawData, Graphics::BatchModelData, BatchDrawDataComp> m_opaqueRenderBatch;
-        std::priority_queue<BatchPair, std::vector<BatchPair>, BatchComparison>        m_transparentRenderBatch;
+        Graphics::RenderDevice*        m_renderDevice = nullptr;
+        Graphics::RenderEngine*        m_renderEngine = nullptr;
+        ApplicationMode                m_appMode      = ApplicationMode::Editor;
+        Graphics::RenderProxyTable     m_proxyTable;
+        Graphics::RenderProxyCallbacks m_proxyCallbacks;
+        std::vector<uint32>            m_transparentOrder;
+        Graphics::DrawListExtractor    m_extractor;
+        Vector3                        m_lastViewLocation  = Vector3::Zero;
+        uint32                         m_visibilityVersion = 0;
     };
 } // namespace Lina::ECS
 
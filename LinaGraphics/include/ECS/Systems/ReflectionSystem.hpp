@@ -42,8 +42,13 @@ Timestamp: 1/23/2022 2:11:17 AM
 // Headers here.
 #include "ECS/System.hpp"
 #include "Math/Vector.hpp"
+#include "Core/CommonECS.hpp"
 #include "Core/RenderBackendFwd.hpp"
 #include "Core/CommonApplication.hpp"
+#include "Rendering/ReflectionProbeScheduler.hpp"
+#include "Rendering/ReflectionProbeLookup.hpp"
+#include "Rendering/ReflectionProbeCache.hpp"
+#include <vector>
 
 namespace Lina
 {
@@ -56,7 +61,10 @@ namespace Lina
     namespace Event
     {
         struct EPlayModeChanged;
-    }
+        struct ELevelInstalled;
+        struct ELevelUninstalled;
+        struct ESerializedLevel;
+    } // namespace Event
 } // namespace Lina
 
 namespace Lina::ECS
@@ -71,7 +79,8 @@ namespace Lina::ECS
         virtual void UpdateComponents(float delta){UpdateReflectionData();};
 
         /// <summary>
-        /// Goes through the reflection areas & captures their cubemaps if they are dynamic.
+        /// Goes through the reflection areas & captures the faces of the dynamic ones, limited by the face budget.
+        /// Areas are prioritized by how stale their data is & how close they are to the camera.
         /// </summary>
         void UpdateReflectionData();
 
@@ -80,13 +89,41 @@ namespace Lina::ECS
         /// </summary>
         void SetReflectionsOnMaterial(Graphics::Material* mat, const Vector3& transformLocation);
 
+        /// <summary>
+        /// Maximum amount of cubemap faces to be captured each frame for dynamic reflection areas.
+        /// </summary>
+        inline void SetReflectionFaceBudget(uint32 budget)
+        {
+            m_scheduler.SetFaceBudget(budget);
+        }
+
+        inline uint32 GetReflectionFaceBudget()
+        {
+            return m_scheduler.GetFaceBudget();
+        }
+
     private:
-        void ConstructRefAreaTexture(Graphics::Texture* texture, const Vector2i& res);
-        void OnPlayModeChanged(const Event::EPlayModeChanged& ev);
+        void   ConstructRefAreaTexture(Graphics::Texture* texture, const Vector2i& res);
+        void   BakeStaticAreas();
+        void   LoadProbeCache();
+        void   SaveProbeCache();
+        uint64 HashScene();
+        void   OnPlayModeChanged(const Event::EPlayModeChanged& ev);
+        void   OnLevelInstalled(const Event::ELevelInstalled& ev);
+        void   OnLevelUninstalled(const Event::ELevelUninstalled& ev);
+        void   OnSerializedLevel(const Event::ESerializedLevel& ev);
 
     private:
-        Graphics::RenderEngine* m_renderEngine = nullptr;
-        ApplicationMode         m_appMode;
+        Graphics::RenderEngine*                      m_renderEngine   = nullptr;
+        ApplicationMode                              m_appMode;
+        Graphics::ReflectionProbeScheduler           m_scheduler;
+        Graphics::ReflectionProbeLookup              m_lookup;
+        Graphics::ReflectionProbeCache               m_probeCache;
+        std::vector<Graphics::ReflectionProbeState>  m_probeStates;
+        std::vector<Graphics::ReflectionFaceCapture> m_faceCaptures;
+        std::vector<Entity>                          m_probeEntities;
+        std::string                                  m_probeCachePath = "";
+        uint32                                       m_frame          = 0;
     };
 } // namespace Lina::ECS
 
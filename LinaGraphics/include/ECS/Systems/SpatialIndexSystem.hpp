@@ -0,0 +1,113 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: SpatialIndexSystem
+
+Keeps a dynamic AABB tree of all renderable model nodes. World bounds are only recalculated when a node's
+transformation changes & proxies are only re-inserted when the bounds leave their fattened box.
+Proxies of entities that weren't seen during the update are removed. Runs before any system that queries it, the
+frustum system culls the camera & every additional view, e.g. shadows & reflection captures, against it.
+
+Timestamp: 1/29/2022 4:05:18 PM
+*/
+
+#pragma once
+
+#ifndef SpatialIndexSystem_HPP
+#define SpatialIndexSystem_HPP
+
+// Headers here.
+#include "Core/RenderBackendFwd.hpp"
+#include "Core/CommonECS.hpp"
+#include "ECS/System.hpp"
+#include "Math/DynamicAABBTree.hpp"
+
+namespace Lina::ECS
+{
+    struct SpatialProxy
+    {
+        Entity  m_entity        = entt::null;
+        uint32  m_lastSeenFrame = 0;
+        uint32  m_meshCount     = 0;
+        Vector3 m_center        = Vector3::Zero;
+        Vector3 m_halfExtent    = Vector3::Zero;
+    };
+
+    class SpatialIndexSystem : public System
+    {
+
+    public:
+        SpatialIndexSystem()  = default;
+        ~SpatialIndexSystem() = default;
+
+        virtual void Initialize(const std::string& name) override;
+        virtual void UpdateComponents(float delta);
+
+        inline const DynamicAABBTree& GetTree() const
+        {
+            return m_tree;
+        }
+
+        inline const SpatialProxy& GetProxy(int proxyID) const
+        {
+            return m_proxies[proxyID];
+        }
+
+        /// <summary>
+        /// Indexed by the proxy IDs of the tree.
+        /// </summary>
+        inline const std::vector<SpatialProxy>& GetProxies() const
+        {
+            return m_proxies;
+        }
+
+        /// <summary>
+        /// Returns one past the largest entity index in the tree, use for sizing per-entity arrays.
+        /// </summary>
+        inline uint32 GetEntityCapacity() const
+        {
+            return m_entityCapacity;
+        }
+
+        inline uint32 GetTotalMeshCount() const
+        {
+            return m_totalMeshCount;
+        }
+
+    private:
+        Graphics::RenderEngine*   m_renderEngine = nullptr;
+        DynamicAABBTree           m_tree;
+        std::vector<SpatialProxy> m_proxies;
+        uint32                    m_frame          = 0;
+        uint32                    m_entityCapacity = 0;
+        uint32                    m_totalMeshCount = 0;
+    };
+} // namespace Lina::ECS
+
+#endif
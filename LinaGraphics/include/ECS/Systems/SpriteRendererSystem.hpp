@@ -29,8 +29,10 @@ SOFTWARE.
 /*
 Class: SpriteRendererSystem
 
-Responsible for adding all the sprite renderers into a pool which is then
-flushed to draw those renderers' data by the RenderEngine.
+Collects the enabled sprites each frame into a sprite batcher, each sprite's material gives the atlas region of its
+diffuse texture & the object color that goes into the vertex colors. Textures marked for the atlas are packed when
+imported, the others draw white. Newly packed images are copied into their pages before the sprites are batched.
+Batches are drawn from a single dynamic vertex buffer, one call per layer, blend mode & atlas page.
 
 Timestamp: 10/1/2020 9:27:40 AM
 */
@@ -41,17 +43,20 @@ Timestamp: 10/1/2020 9:27:40 AM
 
 #include "Core/RenderBackendFwd.hpp"
 #include "ECS/System.hpp"
-#include "Math/Matrix.hpp"
+#include "Rendering/DrawListExtractor.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/SpriteBatcher.hpp"
+#include "Rendering/TextureAtlas.hpp"
 
-#include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace Lina
 {
     namespace Graphics
     {
-        class Material;
-        class Mesh;
+        class Shader;
+        class Texture;
         struct DrawParams;
     } // namespace Graphics
 } // namespace Lina
@@ -61,9 +66,18 @@ namespace Lina::ECS
     class SpriteRendererSystem : public System
     {
 
-        struct BatchModelData
+        struct SpriteMaterialData
         {
-            std::vector<Matrix> m_models;
+            const Graphics::AtlasRegion* m_region    = nullptr;
+            uint32                       m_color     = 0xFFFFFFFF;
+            Graphics::SpriteBlendMode    m_blendMode = Graphics::SpriteBlendMode::Opaque;
+        };
+
+        struct SpriteInstance
+        {
+            Matrix              m_model;
+            Graphics::Material* m_material = nullptr;
+            int                 m_layer    = 0;
         };
 
     public:
@@ -73,14 +87,42 @@ namespace Lina::ECS
         virtual void Initialize(const std::string& name) override;
         virtual void UpdateComponents(float delta) override;
 
-        void Render(Graphics::Material& material, const Matrix& transformIn);
+        /// <summary>
+        /// Shader the batches are drawn with, needs to match the sprite vertex layout.
+        /// </summary>
+        void SetShader(Graphics::Shader* shader);
+
+        /// <summary>
+        /// Sprites use their own vertex layout, nothing is drawn if an override material is given.
+        /// </summary>
         void Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr, bool completeFlush = true);
 
+        inline Graphics::TextureAtlas& GetAtlas()
+        {
+            return m_atlas;
+        }
+
+        inline const Graphics::SpriteBatcher& GetBatcher() const
+        {
+            return m_batcher;
+        }
+
+    private:
+        const Graphics::AtlasRegion* GetRegion(Graphics::Material* material);
+        void                         UploadAtlasPages();
+
     private:
-        Graphics::RenderDevice*                       m_renderDevice = nullptr;
-        Graphics::RenderEngine*                       m_renderEngine = nullptr;
-        Graphics::Mesh*                               m_quadMesh;
-        std::map<Graphics::Material*, BatchModelData> m_renderBatch;
+        Graphics::RenderDevice*                                     m_renderDevice = nullptr;
+        Graphics::RenderEngine*                                     m_renderEngine = nullptr;
+        Graphics::TextureAtlas                                      m_atlas;
+        Graphics::SpriteBatcher                                     m_batcher;
+        Graphics::Material                                          m_batchMaterial;
+        std::vector<Graphics::Texture*>                             m_atlasTextures;
+        std::unordered_map<Graphics::Material*, SpriteMaterialData> m_frameMaterials;
+        std::vector<std::vector<SpriteInstance>>                    m_instanceSlices;
+        std::vector<SpriteInstance>                                 m_instances;
+        Graphics::DrawListExtractor                                 m_extractor;
+        uint32                                                      m_vao          = 0;
     };
 } // namespace Lina::ECS
 
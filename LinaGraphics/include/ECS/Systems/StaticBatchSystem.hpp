@@ -0,0 +1,152 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: StaticBatchSystem
+
+Merges the meshes of entities marked with a static component into combined world space vertex & index buffers
+when a level is installed. Grouping & merging is done by the static batch builder, this system uploads the merged
+chunks on the main thread, frustum culls every chunk on its own & draws each with a single call. Batched entities
+are skipped by the model node system. An entity leaves its chunks if it moves, changes its model or materials,
+loses the static component or is destroyed, affected chunks are merged again on the next update.
+
+Timestamp: 2/3/2022 2:20:41 PM
+*/
+
+#pragma once
+
+#ifndef StaticBatchSystem_HPP
+#define StaticBatchSystem_HPP
+
+// Headers here.
+#include "Core/RenderBackendFwd.hpp"
+#include "Core/CommonECS.hpp"
+#include "ECS/System.hpp"
+#include "Math/FrustumCuller.hpp"
+#include "Math/Matrix.hpp"
+#include "Rendering/StaticBatchBuilder.hpp"
+
+namespace Lina
+{
+    namespace Event
+    {
+        struct ELevelInstalled;
+        struct ELevelUninstalled;
+    } // namespace Event
+
+    namespace Graphics
+    {
+        class Material;
+        struct DrawParams;
+    } // namespace Graphics
+} // namespace Lina
+
+namespace Lina::ECS
+{
+    class StaticBatchSystem : public System
+    {
+
+    public:
+        StaticBatchSystem()  = default;
+        ~StaticBatchSystem();
+
+        virtual void Initialize(const std::string& name) override;
+        virtual void UpdateComponents(float delta);
+
+        /// <summary>
+        /// Culls the chunks against the active camera, called after the camera is updated.
+        /// </summary>
+        void UpdateVisibility();
+
+        /// <summary>
+        /// Culls the chunks against the frustum of any rendered view, Flush only draws the chunks inside it.
+        /// </summary>
+        void UpdateVisibility(const Frustum& frustum);
+
+        /// <summary>
+        /// Merges all static entities from scratch, called automatically when a level is installed.
+        /// Static components added afterwards are only batched when this is called again.
+        /// </summary>
+        void Rebuild();
+
+        /// <summary>
+        /// Draws the chunks that were visible during the last update.
+        /// </summary>
+        void Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial = nullptr);
+
+        /// <summary>
+        /// Returns true if the entity's meshes are drawn as a part of the static batches.
+        /// </summary>
+        inline bool IsBatched(Entity entity) const
+        {
+            return m_builder.IsBatched(entity);
+        }
+
+        /// <summary>
+        /// Maps a triangle of a chunk's merged mesh back to the entity it came from, e.g. for editor picking.
+        /// </summary>
+        inline Entity GetSourceEntity(uint32 chunk, uint32 triangle) const
+        {
+            return m_builder.GetSourceEntity(chunk, triangle);
+        }
+
+        /// <summary>
+        /// Size of the grid cells the meshes are grouped by, takes effect on the next rebuild.
+        /// </summary>
+        inline void SetChunkSize(float size)
+        {
+            m_builder.SetChunkSize(size);
+        }
+
+        inline const std::vector<Graphics::StaticBatchChunk>& GetChunks() const
+        {
+            return m_builder.GetChunks();
+        }
+
+        inline const Graphics::StaticBatchStats& GetStats() const
+        {
+            return m_builder.GetStats();
+        }
+
+    private:
+        void OnLevelInstalled(const Event::ELevelInstalled& ev);
+        void OnLevelUninstalled(const Event::ELevelUninstalled& ev);
+        void Clear();
+        void UploadMergedChunks();
+
+    private:
+        Graphics::RenderEngine*      m_renderEngine = nullptr;
+        Graphics::StaticBatchBuilder m_builder;
+        std::vector<Entity>          m_removedEntities;
+        std::vector<uint32>          m_boundsChunks;
+        std::vector<uint32>          m_visibility;
+        AABBSoA                      m_bounds;
+    };
+} // namespace Lina::ECS
+
+#endif
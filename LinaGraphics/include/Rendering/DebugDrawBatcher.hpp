@@ -0,0 +1,158 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: DebugDrawBatcher
+
+Accumulates immediate-mode debug primitives into CPU arrays during the frame. Shapes are expanded into
+line lists per depth mode, icons are grouped by texture. The render engine flushes the arrays with a
+single upload & draw per primitive type and depth mode.
+
+Timestamp: 1/27/2022 3:44:12 PM
+*/
+
+#pragma once
+
+#ifndef DebugDrawBatcher_HPP
+#define DebugDrawBatcher_HPP
+
+// Headers here.
+#include "Rendering/RenderingCommon.hpp"
+#include "Math/Quaternion.hpp"
+#include <vector>
+
+namespace Lina::Event
+{
+    struct DebugPackedLine;
+}
+
+namespace Lina::Graphics
+{
+#define DEBUG_DEPTH_MODES 2
+
+    enum class DebugDepthMode
+    {
+        DepthTested = 0,
+        Overlay     = 1
+    };
+
+    struct DebugVertex
+    {
+        Vector3 m_position;
+        Color   m_color;
+    };
+
+    struct DebugDrawStats
+    {
+        uint32 m_lineCount = 0;
+        uint32 m_iconCount = 0;
+        uint32 m_drawCalls = 0;
+    };
+
+    class DebugDrawBatcher
+    {
+
+    public:
+        DebugDrawBatcher()  = default;
+        ~DebugDrawBatcher() = default;
+
+        void AddLine(const Vector3& from, const Vector3& to, const Color& color, DebugDepthMode mode = DebugDepthMode::DepthTested);
+
+        /// <summary>
+        /// Adds lineCount lines, each consecutive point pair is a line.
+        /// </summary>
+        void AddLines(const Vector3* points, uint32 lineCount, const Color& color, DebugDepthMode mode = DebugDepthMode::DepthTested);
+
+        /// <summary>
+        /// Adds lines with per-vertex packed ARGB colors, layout matches physics engine debug render buffers.
+        /// </summary>
+        void AddPackedLines(const Event::DebugPackedLine* lines, uint32 lineCount, DebugDepthMode mode = DebugDepthMode::DepthTested);
+
+        void AddBox(const Vector3& center, const Vector3& halfExtents, const Color& color, DebugDepthMode mode = DebugDepthMode::DepthTested);
+        void AddCircle(const Vector3& center, float radius, const Color& color, const Quaternion& rotation = Quaternion(), bool half = false, DebugDepthMode mode = DebugDepthMode::DepthTested);
+        void AddSphere(const Vector3& center, float radius, const Color& color, DebugDepthMode mode = DebugDepthMode::DepthTested);
+        void AddHemiSphere(const Vector3& center, float radius, bool top, const Color& color, DebugDepthMode mode = DebugDepthMode::DepthTested);
+        void AddCapsule(const Vector3& center, float radius, float height, const Color& color, DebugDepthMode mode = DebugDepthMode::DepthTested);
+
+        /// <summary>
+        /// Draws the 12 edges of the frustum described by the given view-projection matrix.
+        /// </summary>
+        void AddFrustum(const Matrix& viewProjection, const Color& color, DebugDepthMode mode = DebugDepthMode::DepthTested);
+
+        void AddIcon(const Vector3& center, StringIDType textureID, float size = 1.0f);
+
+        /// <summary>
+        /// Sorts the icons so that icons sharing a texture are consecutive, call before iterating icons for drawing.
+        /// </summary>
+        void SortIcons();
+
+        /// <summary>
+        /// Clears all the primitives, statistics of the current frame are stored as last frame's.
+        /// </summary>
+        void Clear();
+
+        inline const std::vector<DebugVertex>& GetLineVertices(DebugDepthMode mode) const
+        {
+            return m_lineVertices[static_cast<int>(mode)];
+        }
+
+        inline const std::vector<DebugIcon>& GetIcons() const
+        {
+            return m_icons;
+        }
+
+        inline void AddDrawCall()
+        {
+            m_stats.m_drawCalls++;
+        }
+
+        inline const DebugDrawStats& GetLastFrameStats() const
+        {
+            return m_lastFrameStats;
+        }
+
+        inline void SetLineWidth(float width)
+        {
+            m_lineWidth = width;
+        }
+
+        inline float GetLineWidth() const
+        {
+            return m_lineWidth;
+        }
+
+    private:
+        std::vector<DebugVertex> m_lineVertices[DEBUG_DEPTH_MODES];
+        std::vector<DebugIcon>   m_icons;
+        DebugDrawStats           m_stats;
+        DebugDrawStats           m_lastFrameStats;
+        float                    m_lineWidth = 1.0f;
+    };
+} // namespace Lina::Graphics
+
+#endif
@@ -0,0 +1,124 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: DrawListExtractor
+
+Parallel extraction of per entity data from the ECS. The entity range of a component storage is split into slices
+that are walked on worker threads, each slice writes into its own array so no locking is needed & the arrays are
+concatenated in slice order, which keeps the output independent of scheduling. Render systems use it to detect
+changed proxies & collect instances, their retained batches are then drawn by the flush. Doesn't touch the GPU, so
+it can run headless.
+
+Timestamp: 2/3/2022 2:41:27 PM
+*/
+
+#pragma once
+
+#ifndef DrawListExtractor_HPP
+#define DrawListExtractor_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include "JobSystem/JobSystem.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace Lina::Graphics
+{
+    class DrawListExtractor
+    {
+
+    public:
+        /// <summary>
+        /// Slices run on the shared executor, at most maxConcurrency at once, 0 uses every worker.
+        /// </summary>
+        DrawListExtractor(uint32 maxConcurrency = 0);
+        ~DrawListExtractor() = default;
+
+        /// <summary>
+        /// Number of entities walked by a single task, small slices balance better but cost more to concatenate.
+        /// </summary>
+        inline void SetSliceSize(uint32 sliceSize)
+        {
+            m_sliceSize = sliceSize == 0 ? 1 : sliceSize;
+        }
+
+        /// <summary>
+        /// Calls fn(begin, end) for consecutive slices of [0, count) on the workers & waits for all of them.
+        /// </summary>
+        template <typename Fn> void ForEachSlice(uint32 count, uint32 sliceSize, Fn&& fn)
+        {
+            ParallelFor(GetSharedExecutor(), count, sliceSize, m_maxConcurrency, fn);
+        }
+
+        /// <summary>
+        /// Calls fn(begin, end, items) for each slice of [0, count), items is the slice's own array.
+        /// Slice arrays are kept in sliceItems between calls & concatenated into out in slice order.
+        /// </summary>
+        template <typename T, typename Fn> void Gather(uint32 count, std::vector<std::vector<T>>& sliceItems, std::vector<T>& out, Fn&& fn)
+        {
+            const uint32 slices = (count + m_sliceSize - 1) / m_sliceSize;
+
+            if (sliceItems.size() < slices)
+                sliceItems.resize(slices);
+
+            ForEachSlice(count, m_sliceSize, [&](uint32 begin, uint32 end) {
+                std::vector<T>& items = sliceItems[begin / m_sliceSize];
+                items.clear();
+                fn(begin, end, items);
+            });
+
+            m_sliceOffsets.resize(slices + 1);
+            m_sliceOffsets[0] = 0;
+
+            for (uint32 i = 0; i < slices; i++)
+                m_sliceOffsets[i + 1] = m_sliceOffsets[i] + (uint32)sliceItems[i].size();
+
+            out.resize(m_sliceOffsets[slices]);
+
+            ForEachSlice(slices, 1, [&](uint32 begin, uint32 end) {
+                std::copy(sliceItems[begin].begin(), sliceItems[begin].end(), out.begin() + m_sliceOffsets[begin]);
+            });
+        }
+
+        inline uint32 GetWorkerCount() const
+        {
+            const uint32 workers = (uint32)GetSharedExecutor().num_workers();
+            return m_maxConcurrency != 0 && m_maxConcurrency < workers ? m_maxConcurrency : workers;
+        }
+
+    private:
+        std::vector<uint32> m_sliceOffsets;
+        uint32              m_maxConcurrency = 0;
+        uint32              m_sliceSize      = 1024;
+    };
+} // namespace Lina::Graphics
+
+#endif
@@ -56,11 +56,28 @@ namespace Lina::Graphics
         virtual void* LoadFromFile(const std::string& path) override;
 
         SamplerParameters m_samplerParameters;
+        bool              m_packIntoAtlas = false; // Sprite textures are packed into the sprite atlas when imported.
 
         template <class Archive>
-        void serialize(Archive& archive)
+        void save(Archive& archive) const
+        {
+            archive(m_samplerParameters, m_packIntoAtlas);
+        }
+
+        template <class Archive>
+        void load(Archive& archive)
         {
             archive(m_samplerParameters);
+
+            // Asset data saved before the atlas flag was added ends here.
+            try
+            {
+                archive(m_packIntoAtlas);
+            }
+            catch (const cereal::Exception&)
+            {
+                m_packIntoAtlas = false;
+            }
         }
     };
 } // namespace Lina::Graphics
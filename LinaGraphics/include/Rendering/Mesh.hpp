@@ -111,12 +111,46 @@ namespace Lina::Graphics
             return m_bufferElements[0];
         }
 
+        inline std::vector<BufferData>& GetBufferElements()
+        {
+            return m_bufferElements;
+        }
+
+        inline const std::vector<uint32>& GetIndices() const
+        {
+            return m_indices;
+        }
+
+        /// <summary>
+        /// Skinned meshes are deformed by the skeleton's palette in the vertex shader.
+        /// </summary>
+        virtual bool IsSkinned() const
+        {
+            return false;
+        }
+
+        /// <summary>
+        /// Occluder positions & triangle indices, rasterized by the occlusion culler if the entity is an occluder.
+        /// Empty unless the model was imported as an occluder.
+        /// </summary>
+        inline const std::vector<Vector3>& GetOccluderVertices() const
+        {
+            return m_occluderVertices;
+        }
+
+        inline const std::vector<uint32>& GetOccluderIndices() const
+        {
+            return m_occluderIndices;
+        }
+
     protected:
         friend class ModelLoader;
 
         std::string             m_name = "";
         std::vector<uint32>     m_indices;
         std::vector<BufferData> m_bufferElements;
+        std::vector<Vector3>    m_occluderVertices;
+        std::vector<uint32>     m_occluderIndices;
         VertexArray             m_vertexArray;
         uint32                  m_materialSlot      = 0;
         Vector3                 m_vertexCenter      = Vector3(0.0f, 0.0f, 0.0f);
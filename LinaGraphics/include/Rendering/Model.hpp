@@ -38,6 +38,7 @@ Timestamp: 5/6/2019 4:23:45 PM
 #ifndef MODEL_HPP
 #define MODEL_HPP
 
+#include "Animation/Skeleton.hpp"
 #include "Rendering/ModelNode.hpp"
 #include "Rendering/ModelAssetData.hpp"
 #include "Rendering/RenderingCommon.hpp"
@@ -55,6 +56,12 @@ namespace Lina::Graphics
         Model() = default;
         virtual ~Model();
 
+        /// <summary>
+        /// Builds a model around a node created in code instead of an imported file, e.g. in tests. The node becomes
+        /// the root & only node, the model takes its ownership.
+        /// </summary>
+        explicit Model(ModelNode* rootNode);
+
         virtual void* LoadFromMemory(const std::string& path, unsigned char* data, size_t dataSize) override;
         virtual void* LoadFromFile(const std::string& path) override;
 
@@ -99,7 +106,22 @@ namespace Lina::Graphics
         {
             return m_allNodes;
         }
+        inline Skeleton& GetSkeleton()
+        {
+            return m_skeleton;
+        }
 
+        /// <summary>
+        /// Index of the node's first mesh among all meshes of the model in node order, collision meshes are numbered the same.
+        /// </summary>
+        uint32 GetFirstMeshIndex(int nodeIndex);
+
+    private:
+        /// <summary>
+        /// Hands the meshes to the physics engine, which creates the collision meshes from the cooked data in the
+        /// asset data & cooks the missing ones. Returns true if the cooked data changed.
+        /// </summary>
+        bool LoadCollisionMeshes();
 
     private:
         friend class OpenGLRenderEngine;
@@ -116,6 +138,7 @@ namespace Lina::Graphics
         ModelNode*                         m_rootNode;
         std::vector<ModelNode*>            m_allNodes;
         std::vector<ImportedModelMaterial> m_importedMaterials;
+        Skeleton                           m_skeleton;
     };
 } // namespace Lina::Graphics
 
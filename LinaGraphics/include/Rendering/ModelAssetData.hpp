@@ -41,7 +41,10 @@ Timestamp: 12/31/2021 8:18:10 PM
 
 // Headers here.
 #include "Resources/IResource.hpp"
+#include "Core/CommonPhysics.hpp"
 #include "Core/CommonReflection.hpp"
+#include <cereal/types/map.hpp>
+#include <cereal/types/vector.hpp>
 #include <map>
 #include <vector>
 
@@ -76,14 +79,20 @@ namespace Lina::Graphics
         LINA_PROPERTY("Generate Entity Pivots", "Bool", "If true, any entity generated via adding this model to the scene will have offset pivots as parents.")
         bool m_generatePivots = false;
 
-        bool                              m_regenerateConvexMeshes = false;
-        bool                              m_triangulate            = true;
-        std::map<int, std::vector<uint8>> m_convexMeshData;
+        LINA_PROPERTY("Occluder", "Bool", "If true, occluder geometry is built at import, entities of this model with an Occluder component hide what's behind them.")
+        bool m_isOccluder = false;
+
+        bool m_triangulate = true;
+
+        /// <summary>
+        /// Cooked collision meshes of the model, key is the hash of the source mesh & the cooking parameters.
+        /// </summary>
+        std::map<uint64, Physics::CookedCollisionMesh> m_cookedCollisionMeshes;
 
         template <class Archive>
         void serialize(Archive& archive)
         {
-            archive(m_triangulate, m_smoothNormals, m_generatePivots, m_calculateTangentSpace, m_flipUVs, m_flipWinding, m_globalScale, m_convexMeshData);
+            archive(m_triangulate, m_smoothNormals, m_generatePivots, m_calculateTangentSpace, m_flipUVs, m_flipWinding, m_globalScale, m_cookedCollisionMeshes, m_isOccluder);
         }
     };
 } // namespace Lina::Graphics
@@ -75,7 +75,12 @@ namespace Lina::Graphics
         ModelNode(){};
         ~ModelNode();
 
-        void                             FillNodeHierarchy(const aiNode* node, const aiScene* scene, Model* parentModel);
+        /// <summary>
+        /// Builds a node from meshes created in code instead of an imported file, e.g. in tests. Takes the ownership of the meshes.
+        /// </summary>
+        explicit ModelNode(const std::vector<Mesh*>& meshes);
+
+        void                             FillNodeHierarchy(const aiNode* node, const aiScene* scene, Model* parentModel, const Matrix& parentTransform = Matrix::Identity());
         inline const std::vector<Mesh*>& GetMeshes() const
         {
             return m_meshes;
@@ -101,6 +106,14 @@ namespace Lina::Graphics
             return m_aabb;
         }
 
+        /// <summary>
+        /// Node's transformation relative to the model's root, skinned meshes of the node are deformed in this space.
+        /// </summary>
+        inline const Matrix& GetGlobalTransform() const
+        {
+            return m_globalTransform;
+        }
+
     private:
         void Clear()
         {
@@ -121,6 +134,7 @@ namespace Lina::Graphics
         Vector3                 m_totalVertexCenter = Vector3::Zero;
         AABB                    m_aabb;
         Matrix                  m_localTransform;
+        Matrix                  m_globalTransform;
         std::vector<ModelNode*> m_children;
     };
 } // namespace Lina::Graphics
@@ -0,0 +1,174 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: OcclusionCuller
+
+Software occlusion culling on the CPU. Occluder triangles are transformed & binned into horizontal bands,
+bands are rasterized in parallel into a low resolution depth buffer keeping the nearest occluder depth, which is
+then expanded by a pixel so partially covered pixels don't occlude. A hierarchical max-depth pyramid is built on
+top, screen space bounds of the candidates are then tested against the coarsest level that keeps the test small.
+Doesn't touch the GPU, so it can run headless.
+
+Timestamp: 1/30/2022 11:12:40 AM
+*/
+
+#pragma once
+
+#ifndef OcclusionCuller_HPP
+#define OcclusionCuller_HPP
+
+// Headers here.
+#include "Math/Matrix.hpp"
+#include "Math/Vector.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include <vector>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LINA_OCCLUSION_CULL_SSE
+#endif
+
+namespace Lina::Graphics
+{
+    struct OcclusionCullerStats
+    {
+        uint32 m_occluderTriangles = 0;
+        uint32 m_testedObjects     = 0;
+        uint32 m_occludedObjects   = 0;
+    };
+
+    class OcclusionCuller
+    {
+
+    public:
+        OcclusionCuller(uint32 width = 256, uint32 height = 128, uint32 bandHeight = 16);
+        ~OcclusionCuller() = default;
+
+        /// <summary>
+        /// Width is rounded up to a multiple of 4 for the SIMD rasterizer.
+        /// </summary>
+        void SetResolution(uint32 width, uint32 height);
+
+        /// <summary>
+        /// Clears the depth buffer & occluders, statistics of the previous frame are stored.
+        /// </summary>
+        void BeginFrame(const Matrix& viewProjection);
+
+        /// <summary>
+        /// Transforms the given triangle list into screen space & bins the triangles, parts behind the near plane are clipped.
+        /// </summary>
+        void AddOccluder(const Matrix& model, const std::vector<Vector3>& vertices, const std::vector<uint32>& indices);
+
+        /// <summary>
+        /// Rasterizes all added occluders & builds the depth hierarchy, call once after adding occluders.
+        /// </summary>
+        void RasterizeOccluders();
+
+        /// <summary>
+        /// Returns false if the world space box is completely hidden behind the occluders.
+        /// Boxes crossing the near plane or the screen edges are conservatively considered visible.
+        /// </summary>
+        bool TestAABB(const Vector3& center, const Vector3& halfExtent);
+
+        /// <summary>
+        /// Builds the occluder geometry of a mesh, which never covers more than the mesh itself. Meshes up to maxTriangles are
+        /// used as they are. Larger closed meshes are replaced by a box grown inside of them, open meshes & closed ones
+        /// without a usable inner box keep all of their triangles.
+        /// </summary>
+        static void BuildOccluder(const std::vector<Vector3>& vertices, const std::vector<uint32>& indices, uint32 maxTriangles, std::vector<Vector3>& outVertices, std::vector<uint32>& outIndices);
+
+        inline bool HasOccluders() const
+        {
+            return m_stats.m_occluderTriangles > 0;
+        }
+
+        inline const OcclusionCullerStats& GetLastFrameStats() const
+        {
+            return m_lastFrameStats;
+        }
+
+        inline const OcclusionCullerStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+        /// <summary>
+        /// Returns the occluder depth at the given pixel of the full resolution level, conservative over the pixel's area.
+        /// </summary>
+        inline float GetDepth(uint32 x, uint32 y) const
+        {
+            return m_levels[0].m_depth[y * m_levels[0].m_width + x];
+        }
+
+        inline uint32 GetWidth() const
+        {
+            return m_width;
+        }
+
+        inline uint32 GetHeight() const
+        {
+            return m_height;
+        }
+
+    private:
+        struct ScreenTriangle
+        {
+            float m_x[3];
+            float m_y[3];
+            float m_z[3];
+        };
+
+        struct DepthLevel
+        {
+            uint32             m_width  = 0;
+            uint32             m_height = 0;
+            std::vector<float> m_depth;
+        };
+
+        void AddClippedTriangle(const Vector4* clip);
+        void BinTriangle(const ScreenTriangle& triangle);
+        void RasterizeBand(uint32 band);
+        void RasterizeTriangle(const ScreenTriangle& triangle, uint32 minY, uint32 maxY);
+        void ExpandFarthest();
+        void BuildHierarchy();
+
+    private:
+        Matrix                                   m_viewProjection;
+        std::vector<DepthLevel>                  m_levels;
+        std::vector<std::vector<ScreenTriangle>> m_bins;
+        std::vector<Vector4>                     m_clipVertices;
+        std::vector<float>                       m_scratch;
+        OcclusionCullerStats                     m_stats;
+        OcclusionCullerStats                     m_lastFrameStats;
+        uint32                                   m_width      = 0;
+        uint32                                   m_height     = 0;
+        uint32                                   m_bandHeight = 16;
+    };
+} // namespace Lina::Graphics
+
+#endif
@@ -0,0 +1,123 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: ReflectionProbeCache
+
+Persistent storage for baked static reflection probes, one file next to each level. Each entry keeps the raw float
+pixel data of the 6 cubemap faces & a hash of everything the capture depends on, so editing the probe or the scene
+around it invalidates the entry. Files of another version are dropped as a whole.
+
+Timestamp: 1/25/2022 5:20:03 PM
+*/
+
+#pragma once
+
+#ifndef ReflectionProbeCache_HPP
+#define ReflectionProbeCache_HPP
+
+// Headers here.
+#include "Resources/IResource.hpp"
+#include "Rendering/RenderingCommon.hpp"
+
+namespace Lina::Graphics
+{
+    struct ReflectionProbeCacheEntry
+    {
+        uint64                          m_hash       = 0;
+        Vector2i                        m_resolution = Vector2i(0, 0);
+        std::vector<std::vector<float>> m_faces;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(m_hash, m_resolution, m_faces);
+        }
+    };
+
+    class ReflectionProbeCache : public Resources::IResource
+    {
+
+    public:
+        ReflectionProbeCache()  = default;
+        ~ReflectionProbeCache() = default;
+
+        virtual void* LoadFromMemory(const std::string& path, unsigned char* data, size_t dataSize) override;
+        virtual void* LoadFromFile(const std::string& path) override;
+
+        /// <summary>
+        /// Returns the path of the cache belonging to the level saved at the given path.
+        /// </summary>
+        static std::string GetCachePath(const std::string& levelPath);
+
+        /// <summary>
+        /// FNV-1a over the bytes, chain calls by passing the previous result. Start with HashSeed.
+        /// </summary>
+        static uint64 HashBytes(uint64 hash, const void* data, size_t size);
+
+        /// <summary>
+        /// Combines the hash of the scene the probe captures with the probe's own properties.
+        /// </summary>
+        static uint64 GetProbeHash(uint64 sceneHash, const Vector3& location, const Vector2i& resolution);
+
+        /// <summary>
+        /// Returns the baked data of the probe, nullptr if it was never baked or baked with a different hash.
+        /// </summary>
+        const ReflectionProbeCacheEntry* GetEntry(uint32 probeID, uint64 hash) const;
+
+        inline void SetEntry(uint32 probeID, const ReflectionProbeCacheEntry& entry)
+        {
+            m_entries[probeID] = entry;
+        }
+
+        inline bool IsCurrentVersion() const
+        {
+            return m_version == Version;
+        }
+
+        inline void Clear()
+        {
+            m_version = Version;
+            m_entries.clear();
+        }
+
+        static const uint32 Version  = 2;
+        static const uint64 HashSeed = 14695981039346656037ull;
+
+        uint32                                      m_version = Version;
+        std::map<uint32, ReflectionProbeCacheEntry> m_entries;
+
+        template <class Archive>
+        void serialize(Archive& archive)
+        {
+            archive(m_version, m_entries);
+        }
+    };
+} // namespace Lina::Graphics
+
+#endif
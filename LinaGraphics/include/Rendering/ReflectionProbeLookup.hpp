@@ -0,0 +1,95 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: ReflectionProbeLookup
+
+Spatial lookup that resolves which reflection probe affects a given world location. Built once per frame
+from the current probe states, bins local probes into a uniform grid so resolving a location only tests
+the probes overlapping its cell. Falls back to the first global probe when no local probe contains the point.
+
+Timestamp: 1/25/2022 4:02:18 PM
+*/
+
+#pragma once
+
+#ifndef ReflectionProbeLookup_HPP
+#define ReflectionProbeLookup_HPP
+
+// Headers here.
+#include "Rendering/ReflectionProbeScheduler.hpp"
+#include <vector>
+
+namespace Lina::Graphics
+{
+    class ReflectionProbeLookup
+    {
+
+    public:
+        ReflectionProbeLookup()  = default;
+        ~ReflectionProbeLookup() = default;
+
+        /// <summary>
+        /// Rebuilds the grid based on the given probes, indices returned from Resolve() refer to this list.
+        /// </summary>
+        void Build(const std::vector<ReflectionProbeState>& probes);
+
+        /// <summary>
+        /// Returns the index of the probe affecting the location, -1 if there are none.
+        /// If multiple local probes contain the location, the smallest one wins.
+        /// </summary>
+        int Resolve(const Vector3& location) const;
+
+        inline void SetCellsPerAxis(uint32 cells)
+        {
+            m_cellsPerAxis = cells == 0 ? 1 : cells;
+        }
+
+    private:
+        bool   GetCell(const Vector3& location, uint32& outCell) const;
+        uint32 ToCellIndex(int x, int y, int z) const;
+
+    private:
+        struct LocalProbe
+        {
+            Vector3 m_min;
+            Vector3 m_max;
+            float   m_volume = 0.0f;
+            int     m_index  = -1;
+        };
+
+        std::vector<LocalProbe>          m_localProbes;
+        std::vector<std::vector<uint32>> m_cells;
+        Vector3                          m_gridMin      = Vector3::Zero;
+        Vector3                          m_cellSize     = Vector3::One;
+        uint32                           m_cellsPerAxis = 8;
+        int                              m_globalProbe  = -1;
+    };
+} // namespace Lina::Graphics
+
+#endif
@@ -0,0 +1,116 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: ReflectionProbeScheduler
+
+Decides which reflection probe faces are going to be captured in a given frame. Captures are
+time-sliced by a face budget & prioritized by the distance to the camera and the staleness of each probe.
+Contains no GPU calls, the render engine is responsible for executing the returned captures.
+
+Timestamp: 1/25/2022 3:12:40 PM
+*/
+
+#pragma once
+
+#ifndef ReflectionProbeScheduler_HPP
+#define ReflectionProbeScheduler_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include "Math/Vector.hpp"
+#include <vector>
+
+namespace Lina::Graphics
+{
+#define REFLECTION_PROBE_FACES 6
+
+    struct ReflectionProbeState
+    {
+        Vector3 m_location         = Vector3::Zero;
+        Vector3 m_halfExtents      = Vector3::Zero;
+        bool    m_isLocal          = false;
+        bool    m_isDynamic        = true;
+        bool    m_isCaptured       = false;
+        uint32  m_nextFace         = 0;
+        uint32  m_lastCaptureFrame = 0;
+    };
+
+    struct ReflectionFaceCapture
+    {
+        uint32 m_probeIndex = 0;
+        uint32 m_face       = 0;
+    };
+
+    class ReflectionProbeScheduler
+    {
+
+    public:
+        ReflectionProbeScheduler()  = default;
+        ~ReflectionProbeScheduler() = default;
+
+        /// <summary>
+        /// Fills the given capture list with the faces that should be rendered this frame & advances the probe states.
+        /// Only dynamic probes are scheduled, static ones are baked separately.
+        /// </summary>
+        void Schedule(std::vector<ReflectionProbeState>& probes, const Vector3& cameraLocation, uint32 frame, std::vector<ReflectionFaceCapture>& outCaptures);
+
+        /// <summary>
+        /// Returns the priority of a probe, higher means the probe is going to be captured sooner.
+        /// </summary>
+        float GetPriority(const ReflectionProbeState& probe, const Vector3& cameraLocation, uint32 frame) const;
+
+        inline void SetFaceBudget(uint32 budget)
+        {
+            m_faceBudget = budget;
+        }
+
+        inline uint32 GetFaceBudget() const
+        {
+            return m_faceBudget;
+        }
+
+        inline void SetStalenessWeight(float weight)
+        {
+            m_stalenessWeight = weight;
+        }
+
+        inline void SetDistanceWeight(float weight)
+        {
+            m_distanceWeight = weight;
+        }
+
+    private:
+        std::vector<std::pair<float, uint32>> m_sortedProbes;
+        uint32                                m_faceBudget      = REFLECTION_PROBE_FACES;
+        float                                 m_stalenessWeight = 1.0f;
+        float                                 m_distanceWeight  = 1.0f;
+    };
+} // namespace Lina::Graphics
+
+#endif
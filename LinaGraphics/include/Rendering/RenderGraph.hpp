@@ -0,0 +1,215 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderGraph
+
+Frame graph where passes declare the textures they read & write. Compiling culls the passes whose outputs are never
+read, calculates the lifetime of every transient texture over the remaining passes & assigns transients with the
+same description & disjoint lifetimes to the same physical texture. Imported textures are owned outside the graph,
+they are never aliased & passes writing them are never culled. Only plans the resources, creating the actual
+textures is up to the render engine, so compiling doesn't need a graphics context.
+
+Timestamp: 2/4/2022 10:41:17 AM
+*/
+
+#pragma once
+
+#ifndef RenderGraph_HPP
+#define RenderGraph_HPP
+
+// Headers here.
+#include "Rendering/RenderingCommon.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+
+#define RENDERGRAPH_INVALID 0xFFFFFFFF
+
+namespace Lina::Graphics
+{
+    struct RenderGraphTextureDesc
+    {
+        Vector2i      m_size                = Vector2i(1, 1);
+        PixelFormat   m_internalPixelFormat = PixelFormat::FORMAT_RGBA16F;
+        SamplerFilter m_filter              = SamplerFilter::FILTER_NEAREST; // Part of the texture object in GL.
+        uint32        m_samples             = 1;
+        bool          m_isCubemap           = false;
+
+        bool operator==(const RenderGraphTextureDesc& other) const
+        {
+            return m_size.x == other.m_size.x && m_size.y == other.m_size.y && m_internalPixelFormat == other.m_internalPixelFormat && m_filter == other.m_filter && m_samples == other.m_samples && m_isCubemap == other.m_isCubemap;
+        }
+    };
+
+    struct RenderGraphStats
+    {
+        uint32 m_passes               = 0;
+        uint32 m_culledPasses         = 0;
+        uint32 m_transientTextures    = 0; // Transients used by at least one pass.
+        uint32 m_physicalTextures     = 0;
+        uint64 m_memoryBeforeAliasing = 0; // Bytes, one texture per transient.
+        uint64 m_memoryAfterAliasing  = 0; // Bytes
+    };
+
+    class RenderGraph
+    {
+
+    public:
+        typedef std::function<void()> PassExecute;
+
+        RenderGraph()  = default;
+        ~RenderGraph() = default;
+
+        /// <summary>
+        /// Removes all passes & resources, call before declaring a new configuration.
+        /// </summary>
+        void Reset();
+
+        /// <summary>
+        /// Declares a texture that only lives within the frame, contents are undefined until a pass writes it.
+        /// </summary>
+        uint32 CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+        /// <summary>
+        /// Declares a texture owned outside the graph, e.g. the back buffer or shadow maps that are kept between frames.
+        /// </summary>
+        uint32 ImportTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+        /// <summary>
+        /// Adds a pass, passes are executed in the order they are added.
+        /// </summary>
+        uint32 AddPass(const std::string& name, PassExecute execute);
+
+        void Read(uint32 pass, uint32 texture);
+        void Write(uint32 pass, uint32 texture);
+
+        /// <summary>
+        /// Passes with side effects, e.g. writing to a buffer outside the graph, are never culled.
+        /// </summary>
+        void SetSideEffects(uint32 pass);
+
+        /// <summary>
+        /// Culls passes, calculates lifetimes & builds the aliasing plan.
+        /// </summary>
+        void Compile();
+
+        /// <summary>
+        /// Runs the passes that survived culling.
+        /// </summary>
+        void Execute();
+
+        /// <summary>
+        /// Returns the index of the physical texture the transient is assigned to, RENDERGRAPH_INVALID for imported or unused ones.
+        /// </summary>
+        uint32 GetPhysicalTexture(uint32 texture) const;
+
+        bool IsPassCulled(uint32 pass) const;
+
+        /// <summary>
+        /// Approximate size of the texture on the GPU, 3 channel formats are counted as padded to 4.
+        /// </summary>
+        static uint64 GetTextureMemory(const RenderGraphTextureDesc& desc);
+
+        inline const std::vector<RenderGraphTextureDesc>& GetPhysicalTextures() const
+        {
+            return m_physicalTextures;
+        }
+
+        inline const RenderGraphStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+        inline bool IsCompiled() const
+        {
+            return m_isCompiled;
+        }
+
+        inline const std::string& GetPassName(uint32 pass) const
+        {
+            return m_passes[pass].m_name;
+        }
+
+        inline const std::string& GetTextureName(uint32 texture) const
+        {
+            return m_textures[texture].m_name;
+        }
+
+        /// <summary>
+        /// First & last index of the executed passes using the texture, RENDERGRAPH_INVALID if it's unused.
+        /// </summary>
+        inline uint32 GetFirstUse(uint32 texture) const
+        {
+            return m_textures[texture].m_firstUse;
+        }
+
+        inline uint32 GetLastUse(uint32 texture) const
+        {
+            return m_textures[texture].m_lastUse;
+        }
+
+    private:
+        struct PassNode
+        {
+            std::string         m_name;
+            PassExecute         m_execute;
+            std::vector<uint32> m_reads;
+            std::vector<uint32> m_writes;
+            uint32              m_refCount    = 0;
+            bool                m_sideEffects = false;
+            bool                m_isCulled    = false;
+        };
+
+        struct TextureNode
+        {
+            std::string            m_name;
+            RenderGraphTextureDesc m_desc;
+            std::vector<uint32>    m_producers;
+            uint32                 m_refCount = 0;
+            uint32                 m_firstUse = RENDERGRAPH_INVALID;
+            uint32                 m_lastUse  = RENDERGRAPH_INVALID;
+            uint32                 m_physical = RENDERGRAPH_INVALID;
+            bool                   m_imported = false;
+        };
+
+        void CullPasses();
+        void CalculateLifetimes();
+        void AssignPhysicalTextures();
+
+    private:
+        std::vector<PassNode>               m_passes;
+        std::vector<TextureNode>            m_textures;
+        std::vector<RenderGraphTextureDesc> m_physicalTextures;
+        RenderGraphStats                    m_stats;
+        bool                                m_isCompiled = false;
+    };
+} // namespace Lina::Graphics
+
+#endif
@@ -0,0 +1,238 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderProxyTable
+
+Retained render proxies of the model node entities & the batches they draw into. Each proxy keeps the batch slot &
+instance index of every mesh, proxies are only touched when the entity's transform version, enabled state, model or
+materials change. Removing an instance swaps the batch's last instance into its slot & fixes up the moved instance's
+owner, so batches stay packed. Change detection walks slices of the model node storage on the workers, proxies &
+batches are only modified on the calling thread. Doesn't touch the GPU, so it can run headless.
+
+Timestamp: 2/9/2022 11:02:17 AM
+*/
+
+#pragma once
+
+#ifndef RenderProxyTable_HPP
+#define RenderProxyTable_HPP
+
+// Headers here.
+#include "Core/CommonECS.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include "Math/Matrix.hpp"
+
+#include <functional>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Lina::ECS
+{
+    struct EntityDataComponent;
+    struct ModelNodeComponent;
+} // namespace Lina::ECS
+
+namespace Lina::Graphics
+{
+    class DrawListExtractor;
+    class Material;
+    class Model;
+    class VertexArray;
+
+    struct BatchDrawData
+    {
+        Graphics::VertexArray* m_vertexArray;
+        Graphics::Material*    m_material;
+        float                  m_distance      = 0.0f;
+        uint32                 m_paletteBuffer = 0;
+    };
+
+    struct BatchDrawDataComp
+    {
+        bool const operator()(const BatchDrawData& lhs, const BatchDrawData& rhs) const
+        {
+            return std::tie(lhs.m_vertexArray, lhs.m_material, lhs.m_paletteBuffer) < std::tie(rhs.m_vertexArray, rhs.m_material, rhs.m_paletteBuffer);
+        }
+    };
+
+    struct RenderInstanceOwner
+    {
+        ECS::Entity m_entity = entt::null;
+        uint32      m_mesh   = 0;
+    };
+
+    struct RenderBatch
+    {
+        BatchDrawData                    m_drawData;
+        std::vector<Matrix>              m_models;
+        std::vector<RenderInstanceOwner> m_owners;
+        std::vector<Matrix>              m_visibleModels;
+        bool                             m_isDirty = true;
+    };
+
+    struct TransparentInstance
+    {
+        BatchDrawData       m_drawData;
+        Matrix              m_model;
+        Vector3             m_location = Vector3::Zero;
+        RenderInstanceOwner m_owner;
+    };
+
+    struct RenderProxyMesh
+    {
+        Material* m_material      = nullptr;
+        uint32    m_batch         = 0;
+        uint32    m_instance      = 0;
+        bool      m_isTransparent = false;
+        bool      m_isRendered    = false;
+    };
+
+    struct RenderProxy
+    {
+        Model*                       m_model            = nullptr;
+        int                          m_nodeIndex        = -1;
+        uint32                       m_transformVersion = 0;
+        uint32                       m_paletteBuffer    = 0;
+        bool                         m_isEnabled        = false;
+        bool                         m_isSkinned        = false;
+        bool                         m_isStaticBatched  = false;
+        bool                         m_needsRebuild     = true;
+        std::vector<RenderProxyMesh> m_meshes;
+    };
+
+    struct RenderProxyChange
+    {
+        ECS::Entity m_entity           = entt::null;
+        Matrix      m_model;
+        Vector3     m_location         = Vector3::Zero;
+        uint32      m_transformVersion = 0;
+        bool        m_needsRebuild     = false;
+    };
+
+    /// <summary>
+    /// State owned by other systems that a proxy depends on, palettes are also read on the workers during detection.
+    /// </summary>
+    struct RenderProxyCallbacks
+    {
+        std::function<bool(ECS::Entity)>   m_isStaticBatched;
+        std::function<uint32(ECS::Entity)> m_getPaletteBuffer;
+    };
+
+    class RenderProxyTable
+    {
+
+    public:
+        RenderProxyTable()  = default;
+        ~RenderProxyTable() = default;
+
+        /// <summary>
+        /// Creates the entity's proxy if needed, it's built during the next sync.
+        /// </summary>
+        void MarkForRebuild(ECS::Entity entity);
+
+        /// <summary>
+        /// Rebuilds the entity's proxy during the next sync if it has one, e.g. when it enters or leaves a static batch.
+        /// </summary>
+        void Invalidate(ECS::Entity entity);
+
+        /// <summary>
+        /// Removes the entity's instances from the batches & deletes its proxy.
+        /// </summary>
+        void Remove(ECS::Entity entity);
+
+        /// <summary>
+        /// Deletes every proxy & batch.
+        /// </summary>
+        void Clear();
+
+        /// <summary>
+        /// Detects the changed proxies in the model node storage & rebuilds or moves them, returns the number of
+        /// updated proxies, 0 on a static scene.
+        /// </summary>
+        uint32 Sync(entt::registry& reg, DrawListExtractor& extractor, const RenderProxyCallbacks& callbacks);
+
+        inline const std::unordered_map<ECS::Entity, RenderProxy>& GetProxies() const
+        {
+            return m_proxies;
+        }
+
+        inline std::vector<RenderBatch>& GetOpaqueBatches()
+        {
+            return m_opaqueBatches;
+        }
+
+        inline std::vector<TransparentInstance>& GetTransparentInstances()
+        {
+            return m_transparentInstances;
+        }
+
+        /// <summary>
+        /// True if transparent instances were added, removed or moved since the last ClearTransparentDirty call.
+        /// </summary>
+        inline bool IsTransparentDirty() const
+        {
+            return m_transparentDirty;
+        }
+
+        inline void ClearTransparentDirty()
+        {
+            m_transparentDirty = false;
+        }
+
+        /// <summary>
+        /// Returns the number of proxies that were rebuilt or moved during the last sync.
+        /// </summary>
+        inline uint32 GetUpdatedProxyCount() const
+        {
+            return m_updatedProxies;
+        }
+
+    private:
+        bool IsProxyOutdated(const RenderProxy& proxy, ECS::ModelNodeComponent& nodeComponent, ECS::EntityDataComponent& data, ECS::Entity entity, const RenderProxyCallbacks& callbacks) const;
+        void BuildProxy(RenderProxy& proxy, ECS::ModelNodeComponent& nodeComponent, ECS::EntityDataComponent& data, ECS::Entity entity, const RenderProxyCallbacks& callbacks);
+        void ReleaseProxy(RenderProxy& proxy);
+        void RemoveInstance(RenderProxyMesh& proxyMesh);
+        void UpdateProxyTransform(RenderProxy& proxy, const RenderProxyChange& change);
+
+    private:
+        // Same vertex array & material pairs are compressed into a single batch.
+        std::map<BatchDrawData, uint32, BatchDrawDataComp> m_batchLookup;
+        std::vector<RenderBatch>                           m_opaqueBatches;
+        std::vector<TransparentInstance>                   m_transparentInstances;
+        std::unordered_map<ECS::Entity, RenderProxy>       m_proxies;
+        std::vector<std::vector<RenderProxyChange>>        m_changeSlices;
+        std::vector<RenderProxyChange>                     m_changes;
+        uint32                                             m_updatedProxies   = 0;
+        bool                                               m_transparentDirty = true;
+    };
+} // namespace Lina::Graphics
+
+#endif
@@ -0,0 +1,198 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: RenderStateCache
+
+CPU shadow of the bound objects & render states of the render device. Every setter returns whether the state
+changed & the caller has to reach GL, calls that wouldn't change anything are counted as skipped. It doesn't call
+GL itself, so it runs headless.
+
+Timestamp: 2/11/2022 4:18:37 PM
+*/
+
+#pragma once
+
+#ifndef RenderStateCache_HPP
+#define RenderStateCache_HPP
+
+// Headers here.
+#include "Math/Color.hpp"
+#include "Math/Vector.hpp"
+#include "Rendering/RenderingCommon.hpp"
+
+#define LINA_GL_CACHED_TEXTURE_UNITS 32
+
+namespace Lina::Graphics
+{
+    struct RenderDeviceStats
+    {
+        uint32 m_drawCalls           = 0;
+        uint32 m_stateCalls          = 0; // Binds & state changes that reached GL.
+        uint32 m_skippedBinds        = 0; // Program, VAO, FBO, RBO, buffer, texture & sampler binds filtered by the cache.
+        uint32 m_skippedRenderStates = 0; // Depth, stencil, blend, cull, scissor, viewport & clear color changes filtered by the cache.
+    };
+
+    class RenderStateCache
+    {
+    public:
+        RenderStateCache()  = default;
+        ~RenderStateCache() = default;
+
+        /// <summary>
+        /// Mirrors the default GL state the render device sets up on initialization, bindings are left untouched.
+        /// </summary>
+        void Reset(const Vector2i& viewportSize);
+
+        /// <summary>
+        /// Stores the statistics of the previous frame & resets the counters.
+        /// </summary>
+        void BeginFrame();
+
+        inline const RenderDeviceStats& GetLastFrameStats() const
+        {
+            return m_lastFrameStats;
+        }
+
+        inline const RenderDeviceStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+        inline void AddDrawCall()
+        {
+            m_stats.m_drawCalls++;
+        }
+
+        // Bindings, each returns true if GL has to be called.
+        bool SetShader(uint32 shader);
+        bool SetVAO(uint32 vao);
+        bool SetFBO(uint32 fbo);
+        bool SetRBO(uint32 rbo);
+        bool SetUBO(uint32 ubo);
+        bool SetActiveTextureUnit(uint32 unit);
+        bool BindTexture(uint32 target, uint32 texture);
+        bool BindSampler(uint32 unit, uint32 sampler);
+
+        /// <summary>
+        /// Binding a buffer base also binds the generic point, records it without filtering.
+        /// </summary>
+        void SetBufferBase(uint32 ubo);
+
+        /// <summary>
+        /// Read & draw targets differ after a blit, the next SetFBO has to rebind.
+        /// </summary>
+        void SetBlitTargets(uint32 readFBO, uint32 writeFBO);
+
+        // Render states, each returns true if GL has to be called.
+        bool SetViewport(const Vector2i& pos, const Vector2i& size);
+        bool SetClearColor(const Color& color);
+        bool SetFaceCulling(FaceCulling faceCulling);
+        bool SetDepthWrite(bool shouldWrite);
+        bool SetDepthFunc(DrawFunc depthFunc);
+        bool SetDepthTestEnable(bool enable);
+        bool SetBlending(BlendFunc sourceBlend, BlendFunc destBlend);
+        bool SetStencilTestEnable(bool enable);
+        bool SetStencilFunc(DrawFunc stencilFunc, uint32 stencilTestMask, int32 stencilComparisonVal);
+        bool SetStencilOp(StencilOp stencilFail, StencilOp stencilPassButDepthFail, StencilOp stencilPass);
+        bool SetStencilWriteMask(uint32 mask);
+        bool SetScissorTestEnable(bool enable);
+        bool SetScissorBox(uint32 startX, uint32 startY, uint32 width, uint32 height);
+
+        // GL drops deleted objects from the bindings & hands their names out again.
+        void OnTextureReleased(uint32 texture);
+        void OnSamplerReleased(uint32 sampler);
+        void OnVAOReleased(uint32 vao);
+        void OnUBOReleased(uint32 ubo);
+        void OnFBOReleased(uint32 fbo);
+        void OnRBOReleased(uint32 rbo);
+
+        inline uint32 GetShader() const
+        {
+            return m_boundShader;
+        }
+
+        inline FaceCulling GetFaceCulling() const
+        {
+            return m_usedFaceCulling;
+        }
+
+        inline bool IsBlendingEnabled() const
+        {
+            return m_isBlendingEnabled;
+        }
+
+    private:
+        struct TextureUnitState
+        {
+            uint32 m_target  = 0;
+            uint32 m_texture = 0;
+            uint32 m_sampler = 0;
+        };
+
+    private:
+        RenderDeviceStats m_stats;
+        RenderDeviceStats m_lastFrameStats;
+
+        uint32           m_boundShader       = 0;
+        uint32           m_boundVAO          = 0;
+        uint32           m_boundFBO          = 0;
+        uint32           m_boundReadFBO      = 0;
+        uint32           m_boundWriteFBO     = 0;
+        uint32           m_boundRBO          = 0;
+        uint32           m_boundUBO          = 0;
+        uint32           m_activeTextureUnit = 0;
+        TextureUnitState m_textureUnits[LINA_GL_CACHED_TEXTURE_UNITS];
+        Vector2i         m_boundViewportSize;
+        Vector2i         m_boundViewportPos;
+
+        // Current drawing parameters.
+        FaceCulling m_usedFaceCulling             = FACE_CULL_NONE;
+        DrawFunc    m_usedDepthFunction           = DRAW_FUNC_LESS;
+        BlendFunc   m_usedSourceBlending          = BLEND_FUNC_NONE;
+        BlendFunc   m_usedDestinationBlending     = BLEND_FUNC_NONE;
+        DrawFunc    m_usedStencilFunction         = DRAW_FUNC_NOT_EQUAL;
+        StencilOp   m_usedStencilFail             = STENCIL_KEEP;
+        StencilOp   m_usedStencilPassButDepthFail = STENCIL_KEEP;
+        StencilOp   m_usedStencilPass             = STENCIL_REPLACE;
+
+        // Current operation parameters.
+        uint32 m_usedStencilTestMask        = 0xFF;
+        uint32 m_usedStencilWriteMask       = 0xFF;
+        int32  m_usedStencilComparisonValue = 1;
+        uint32 m_usedScissor[4]             = {0, 0, 0, 0};
+        bool   m_isBlendingEnabled          = false;
+        bool   m_isStencilTestEnabled       = true;
+        bool   m_isScissorsTestEnabled      = false;
+        bool   m_shouldWriteDepth           = true;
+        bool   m_isDepthTestEnabled         = true;
+        Color  m_currentClearColor          = Color::Black;
+    };
+} // namespace Lina::Graphics
+
+#endif
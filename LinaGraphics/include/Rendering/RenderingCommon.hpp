@@ -53,6 +53,7 @@ namespace Lina::Graphics
 #define INTERNAL_MAT_PATH         "__internal"
 #define MAX_POINT_LIGHTS          12
 #define MAX_BONE_INFLUENCE        4
+#define MAX_BONES                 150
 
     enum BufferUsage
     {
@@ -379,12 +380,12 @@ namespace Lina::Graphics
     // Vertex array struct for storage & vertex array data transportation.
     struct VertexArrayData
     {
-        uint32*     buffers;
-        uintptr*    bufferSizes;
-        uint32      numBuffers;
-        uint32      numElements;
-        uint32      instanceComponentsStartIndex;
-        BufferUsage bufferUsage;
+        uint32*     buffers                      = nullptr;
+        uintptr*    bufferSizes                  = nullptr;
+        uint32      numBuffers                   = 0;
+        uint32      numElements                  = 0;
+        uint32      instanceComponentsStartIndex = 0;
+        BufferUsage bufferUsage                  = BufferUsage::USAGE_STATIC_DRAW;
     };
 
     // Shader program struct for storage.
@@ -394,6 +395,7 @@ namespace Lina::Graphics
         std::map<std::string, int32> uniformBlockMap;
         std::map<std::string, int32> samplerMap;
         std::map<std::string, int32> uniformMap;
+        bool                         isValid = false;
     };
 
     struct BufferData
@@ -51,6 +51,11 @@ namespace Lina::Graphics
         SkinnedMesh() = default;
         ~SkinnedMesh() = default;
 
+        virtual bool IsSkinned() const override
+        {
+            return true;
+        }
+
     private:
     };
 } // namespace Lina::Graphics
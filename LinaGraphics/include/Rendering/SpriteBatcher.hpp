@@ -0,0 +1,137 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: SpriteBatcher
+
+Builds a single dynamic vertex stream out of the frame's sprites. Sprites are sorted by layer, then blend mode,
+then atlas page & expanded into world space quads on the CPU, consecutive sprites sharing the same key end up in
+the same batch, so a batch is drawn in one call no matter how many sprites it has. Doesn't touch the GPU.
+
+Timestamp: 2/2/2022 11:25:36 AM
+*/
+
+#pragma once
+
+#ifndef SpriteBatcher_HPP
+#define SpriteBatcher_HPP
+
+// Headers here.
+#include "Math/Matrix.hpp"
+#include "Core/SizeDefinitions.hpp"
+
+#include <vector>
+
+namespace Lina::Graphics
+{
+    struct AtlasRegion;
+
+#define SPRITE_BATCH_MAX_QUADS 65536
+
+    enum class SpriteBlendMode : uint8
+    {
+        Opaque      = 0,
+        Transparent = 1
+    };
+
+    struct SpriteVertex
+    {
+        float  m_position[3];
+        float  m_uv[2];
+        uint32 m_color; // RGBA8, R in the lowest byte.
+    };
+
+    struct SpriteBatch
+    {
+        int             m_layer       = 0;
+        SpriteBlendMode m_blendMode   = SpriteBlendMode::Opaque;
+        uint32          m_page        = 0;
+        uint32          m_firstVertex = 0;
+        uint32          m_quadCount   = 0;
+    };
+
+    class SpriteBatcher
+    {
+
+    public:
+        SpriteBatcher()  = default;
+        ~SpriteBatcher() = default;
+
+        /// <summary>
+        /// Queues a unit quad centered on the transform's origin, facing +Z.
+        /// </summary>
+        void AddSprite(const Matrix& transform, const AtlasRegion& region, uint32 color, int layer, SpriteBlendMode blendMode);
+
+        /// <summary>
+        /// Sorts the queued sprites & fills the vertex stream & batches. Batches are split at SPRITE_BATCH_MAX_QUADS.
+        /// </summary>
+        void Build();
+
+        /// <summary>
+        /// Removes all the sprites, vertices & batches.
+        /// </summary>
+        void Clear();
+
+        inline const std::vector<SpriteVertex>& GetVertices() const
+        {
+            return m_vertices;
+        }
+
+        inline const std::vector<SpriteBatch>& GetBatches() const
+        {
+            return m_batches;
+        }
+
+        inline uint32 GetSpriteCount() const
+        {
+            return (uint32)m_sprites.size();
+        }
+
+        /// <summary>
+        /// Packs a color into the vertex color layout.
+        /// </summary>
+        static uint32 PackColor(float r, float g, float b, float a);
+
+    private:
+        struct SpriteInstance
+        {
+            float  m_axisX[3];
+            float  m_axisY[3];
+            float  m_origin[3];
+            float  m_uv[4];
+            uint32 m_color;
+        };
+
+        std::vector<SpriteInstance>            m_sprites;
+        std::vector<std::pair<uint64, uint32>> m_sortKeys;
+        std::vector<SpriteVertex>              m_vertices;
+        std::vector<SpriteBatch>               m_batches;
+    };
+} // namespace Lina::Graphics
+
+#endif
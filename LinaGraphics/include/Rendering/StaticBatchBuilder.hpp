@@ -0,0 +1,179 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: StaticBatchBuilder
+
+CPU side of the static batches. Groups the meshes of entities marked with a static component by material & a
+uniform grid cell & merges every group into a chunk mesh with world space vertices, merging runs on job workers.
+A chunk can't mix vertex layouts, meshes with a different one go to their own chunk in the same cell. Entities that
+move, change their model or materials, lose the static component or are destroyed leave their chunks & only those
+chunks are merged again. Merged meshes keep their CPU data until the caller uploads them, so it can run headless.
+
+Timestamp: 2/9/2022 3:26:51 PM
+*/
+
+#pragma once
+
+#ifndef StaticBatchBuilder_HPP
+#define StaticBatchBuilder_HPP
+
+// Headers here.
+#include "Core/CommonECS.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include "Math/Matrix.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Lina::Graphics
+{
+    class Material;
+    class Mesh;
+    class Model;
+    class StaticMesh;
+
+    struct StaticBatchSource
+    {
+        ECS::Entity m_entity     = entt::null;
+        Mesh*       m_mesh       = nullptr;
+        Matrix      m_transform;
+        uint32      m_firstIndex = 0;
+        uint32      m_indexCount = 0;
+    };
+
+    struct StaticBatchChunk
+    {
+        Material*                      m_material     = nullptr;
+        StaticMesh*                    m_mesh         = nullptr;
+        std::vector<StaticBatchSource> m_sources;
+        Vector3                        m_center       = Vector3::Zero;
+        Vector3                        m_halfExtent   = Vector3::Zero;
+        uint64                         m_vertexMemory = 0;
+        uint64                         m_indexMemory  = 0;
+        bool                           m_isDirty      = true;
+    };
+
+    struct StaticBatchEntity
+    {
+        Model*                 m_model            = nullptr;
+        uint32                 m_transformVersion = 0;
+        std::vector<Material*> m_materials;
+        std::vector<uint32>    m_chunks;
+    };
+
+    struct StaticBatchStats
+    {
+        uint32 m_batchedEntities = 0;
+        uint32 m_batchedMeshes   = 0;
+        uint32 m_sourceDrawCalls = 0; // Unique vertex array & material pairs of the batched meshes, e.g. draw calls without batching.
+        uint32 m_chunkDrawCalls  = 0;
+        uint64 m_vertexMemory    = 0; // Bytes
+        uint64 m_indexMemory     = 0; // Bytes
+    };
+
+    class StaticBatchBuilder
+    {
+
+    public:
+        StaticBatchBuilder() = default;
+        ~StaticBatchBuilder();
+
+        /// <summary>
+        /// Deletes every chunk & forgets the batched entities.
+        /// </summary>
+        void Clear();
+
+        /// <summary>
+        /// Merges all enabled static entities of the registry from scratch.
+        /// </summary>
+        void Build(entt::registry& reg);
+
+        /// <summary>
+        /// Takes the outdated entities out of their chunks & merges those chunks again, the removed entities are
+        /// written to outRemoved.
+        /// </summary>
+        void RemoveOutdated(entt::registry& reg, std::vector<ECS::Entity>& outRemoved);
+
+        /// <summary>
+        /// Returns true if the entity's meshes are a part of a chunk.
+        /// </summary>
+        bool IsBatched(ECS::Entity entity) const;
+
+        /// <summary>
+        /// Maps a triangle of a chunk's merged mesh back to the entity it came from, e.g. for editor picking.
+        /// </summary>
+        ECS::Entity GetSourceEntity(uint32 chunk, uint32 triangle) const;
+
+        /// <summary>
+        /// Size of the grid cells the meshes are grouped by, takes effect on the next build.
+        /// </summary>
+        inline void SetChunkSize(float size)
+        {
+            m_chunkSize = size;
+        }
+
+        inline const std::vector<StaticBatchChunk>& GetChunks() const
+        {
+            return m_chunks;
+        }
+
+        /// <summary>
+        /// Chunks merged by the last Build or RemoveOutdated call, their meshes still hold the CPU data. Chunks whose
+        /// sources were all removed are listed too, their mesh is null.
+        /// </summary>
+        inline const std::vector<uint32>& GetMergedChunks() const
+        {
+            return m_mergedChunks;
+        }
+
+        inline const std::unordered_map<ECS::Entity, StaticBatchEntity>& GetBatchedEntities() const
+        {
+            return m_batchedEntities;
+        }
+
+        inline const StaticBatchStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+    private:
+        bool IsBatchedEntityOutdated(entt::registry& reg, ECS::Entity entity, const StaticBatchEntity& batched) const;
+        void MergeDirtyChunks();
+        void UpdateStats();
+
+    private:
+        std::vector<StaticBatchChunk>                      m_chunks;
+        std::unordered_map<ECS::Entity, StaticBatchEntity> m_batchedEntities;
+        std::vector<uint32>                                m_mergedChunks;
+        StaticBatchStats                                   m_stats;
+        float                                              m_chunkSize = 32.0f;
+    };
+} // namespace Lina::Graphics
+
+#endif
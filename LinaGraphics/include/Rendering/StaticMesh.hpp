@@ -29,7 +29,8 @@ SOFTWARE.
 /*
 Class: StaticMesh
 
-
+Mesh without skinning data. Can also be used as the merge target of static batches, in which case the vertices of
+multiple meshes are appended in world space.
 
 Timestamp: 12/24/2021 8:54:24 PM
 */
@@ -51,7 +52,30 @@ namespace Lina::Graphics
         StaticMesh() = default;
         virtual ~StaticMesh() = default;
 
+        /// <summary>
+        /// Returns true if both meshes have the same vertex elements & can be merged together.
+        /// </summary>
+        static bool IsLayoutCompatible(Mesh& a, Mesh& b);
+
+        /// <summary>
+        /// Allocates the same vertex elements as the given mesh, call once before appending.
+        /// </summary>
+        void CopyLayout(Mesh& source);
+
+        /// <summary>
+        /// Appends the source's vertices transformed by the given matrix & its indices, returns the first appended index.
+        /// Normals, tangents & bitangents are transformed as directions, winding is flipped for mirroring transforms.
+        /// </summary>
+        uint32 AppendTransformed(Mesh& source, const Matrix& transform);
+
+        /// <summary>
+        /// Frees the CPU copy of the vertex & index data, call after creating the vertex array.
+        /// </summary>
+        void ReleaseCPUData();
+
     private:
+        Vector3 m_mergedMin = Vector3::Zero;
+        Vector3 m_mergedMax = Vector3::Zero;
     };
 } // namespace Lina::Graphics
 
@@ -69,6 +69,7 @@ namespace Lina::Graphics
         void ConstructRTTexture(Vector2i size, SamplerParameters samplerParams, bool useBorder = false, const std::string& path = "");
         void ConstructRTTextureMSAA(Vector2i size, SamplerParameters samplerParams, int sampleCount, const std::string& path = "");
         void ConstructEmpty(SamplerParameters samplerParams = SamplerParameters(), const std::string& path = "");
+        void ConstructFromPixels(const Vector2i& size, const unsigned char* pixels, SamplerParameters samplerParams, const std::string& path = "");
 
         inline ImageAssetData* GetAssetData()
         {
@@ -111,6 +112,8 @@ namespace Lina::Graphics
     private:
         friend RenderEngine;
 
+        void PackIntoSpriteAtlas();
+
         TextureBindMode m_bindMode;
         Sampler         m_sampler;
         ImageAssetData* m_assetData     = nullptr;
@@ -0,0 +1,166 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: TextureAtlas
+
+Packs images into fixed size RGBA8 pages with stb_rect_pack. Each image is extruded by the padding on all sides to
+avoid bleeding when filtering. Images are converted when added & packed in batches, a batch is packed in the same
+order no matter the order the images were added in. Regions never move once packed, new images go into the first
+page with enough space & a new page is opened when none has. Pages only exist on the GPU, the atlas keeps the
+packed images until the owner uploads them.
+
+Timestamp: 2/2/2022 10:41:12 AM
+*/
+
+#pragma once
+
+#ifndef TextureAtlas_HPP
+#define TextureAtlas_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include "Utility/StringId.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Lina::Graphics
+{
+    struct AtlasRegion
+    {
+        uint32 m_page  = 0;
+        float  m_uv[4] = {0.0f, 0.0f, 1.0f, 1.0f}; // u0, v0, u1, v1
+    };
+
+    /// <summary>
+    /// Padded RGBA8 block of a packed image, to be copied into its page at the given texel.
+    /// </summary>
+    struct AtlasUpload
+    {
+        uint32             m_page   = 0;
+        uint32             m_x      = 0;
+        uint32             m_y      = 0;
+        uint32             m_width  = 0;
+        uint32             m_height = 0;
+        std::vector<uint8> m_pixels;
+    };
+
+    class TextureAtlas
+    {
+
+    public:
+        TextureAtlas(uint32 pageSize = 2048, uint32 padding = 2);
+        ~TextureAtlas();
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+        /// <summary>
+        /// Copies the image with 1 to 4 components per pixel, rows starting from v = 0, it's packed on the next call
+        /// to Pack. Returns false if the image doesn't fit in a page or the id is already added.
+        /// </summary>
+        bool AddImage(StringIDType sid, uint32 width, uint32 height, uint32 components, const uint8* pixels);
+
+        /// <summary>
+        /// Packs the added images, tallest first, ties broken by id.
+        /// </summary>
+        void Pack();
+
+        /// <summary>
+        /// Removes all pages & regions.
+        /// </summary>
+        void Clear();
+
+        /// <summary>
+        /// Returns nullptr if the id is not packed.
+        /// </summary>
+        const AtlasRegion* GetRegion(StringIDType sid) const;
+
+        /// <summary>
+        /// Ratio of the packed area, padding included, to the page area.
+        /// </summary>
+        float GetOccupancy(uint32 page) const;
+
+        /// <summary>
+        /// Images packed since the last call to ClearUploads, in packing order.
+        /// </summary>
+        inline const std::vector<AtlasUpload>& GetUploads() const
+        {
+            return m_uploads;
+        }
+
+        /// <summary>
+        /// Call after uploading, releases the packed images.
+        /// </summary>
+        void ClearUploads();
+
+        inline uint32 GetPageCount() const
+        {
+            return (uint32)m_pages.size();
+        }
+
+        inline uint32 GetPageSize() const
+        {
+            return m_pageSize;
+        }
+
+        inline uint32 GetRegionCount() const
+        {
+            return (uint32)m_regions.size();
+        }
+
+        inline uint32 GetPendingCount() const
+        {
+            return (uint32)m_pending.size();
+        }
+
+    private:
+        struct Page;
+
+        struct PendingImage
+        {
+            StringIDType m_sid    = 0;
+            uint32       m_width  = 0;
+            uint32       m_height = 0;
+            AtlasUpload  m_upload;
+        };
+
+        void CopyImage(AtlasUpload& upload, uint32 width, uint32 height, uint32 components, const uint8* pixels);
+
+    private:
+        std::vector<Page*>                            m_pages;
+        std::unordered_map<StringIDType, AtlasRegion> m_regions;
+        std::vector<PendingImage>                     m_pending;
+        std::vector<AtlasUpload>                      m_uploads;
+        uint32                                        m_pageSize = 2048;
+        uint32                                        m_padding  = 2;
+    };
+} // namespace Lina::Graphics
+
+#endif
@@ -0,0 +1,142 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: ViewCuller
+
+Culls the proxies of the spatial index against the frustum of a view into a bitset indexed by entity. The camera's
+visibility is kept while additional views, e.g. shadows & reflection captures, are culled & can be restored along
+with its version. Versions come from a counter that only increases, so a number is never handed out for two
+different sets. Doesn't touch the GPU or the registry, so it can run headless.
+
+Timestamp: 2/12/2022 2:41:09 PM
+*/
+
+#pragma once
+
+#ifndef ViewCuller_HPP
+#define ViewCuller_HPP
+
+// Headers here.
+#include "Core/CommonECS.hpp"
+#include "Math/DynamicAABBTree.hpp"
+#include "Math/FrustumCuller.hpp"
+
+namespace Lina::ECS
+{
+    struct SpatialProxy;
+}
+
+namespace Lina::Graphics
+{
+    class ViewCuller
+    {
+    public:
+        ViewCuller()  = default;
+        ~ViewCuller() = default;
+
+        /// <summary>
+        /// Replaces the current visibility with the proxies of the tree that intersect the frustum, proxies are indexed
+        /// by the tree's proxy IDs. Returns the number of meshes of the visible proxies.
+        /// </summary>
+        uint32 Cull(const Frustum& frustum, const DynamicAABBTree& tree, const std::vector<ECS::SpatialProxy>& proxies, uint32 entityCapacity);
+
+        /// <summary>
+        /// Hides an entity that passed the frustum test, e.g. an occluded one.
+        /// </summary>
+        void Hide(ECS::Entity entity);
+
+        /// <summary>
+        /// Drops the visibility, every entity is considered visible until the next cull.
+        /// </summary>
+        void Clear();
+
+        /// <summary>
+        /// Keeps the current visibility as the camera's, bumps the version if it changed.
+        /// </summary>
+        void CommitCamera();
+
+        /// <summary>
+        /// Bumps the version if the visibility of an additional view differs from the previous one.
+        /// </summary>
+        void CommitView();
+
+        /// <summary>
+        /// Brings back the camera's visibility & the version it had.
+        /// </summary>
+        void RestoreCamera();
+
+        /// <summary>
+        /// Entities that aren't in the spatial index yet are considered visible.
+        /// </summary>
+        inline bool IsVisible(ECS::Entity entity) const
+        {
+            const uint32 index = (uint32)entt::to_entity(entity);
+            return index >= m_visibilityCapacity || FrustumCuller::IsVisible(m_visibility, index);
+        }
+
+        inline uint32 GetVersion() const
+        {
+            return m_version;
+        }
+
+        inline const std::vector<uint32>& GetVisibility() const
+        {
+            return m_visibility;
+        }
+
+        /// <summary>
+        /// Proxy IDs that passed the last frustum test, in tree order.
+        /// </summary>
+        inline const std::vector<int>& GetVisibleProxies() const
+        {
+            return m_visibleProxies;
+        }
+
+    private:
+        void UpdateVersion();
+
+    private:
+        AABBSoA               m_bounds;
+        AABBTreeParallelQuery m_treeQuery;
+        std::vector<int>      m_insideProxies;
+        std::vector<int>      m_boundsProxies;
+        std::vector<int>      m_visibleProxies;
+        std::vector<uint32>   m_boundsVisibility;
+        std::vector<uint32>   m_visibility;
+        std::vector<uint32>   m_previousVisibility;
+        std::vector<uint32>   m_cameraVisibility;
+        uint32                m_visibilityCapacity = 0;
+        uint32                m_cameraCapacity     = 0;
+        uint32                m_version            = 0;
+        uint32                m_cameraVersion      = 0;
+        uint32                m_versionCounter     = 0;
+    };
+} // namespace Lina::Graphics
+
+#endif
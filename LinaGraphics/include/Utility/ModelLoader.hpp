@@ -39,6 +39,10 @@ Timestamp: 4/26/2019 12:07:47 AM
 #ifndef ModelLoader_HPP
 #define ModelLoader_HPP
 
+#include "Math/Matrix.hpp"
+
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -50,17 +54,27 @@ namespace Lina::Graphics
 {
     class Mesh;
     class Model;
+    class Skeleton;
 
     class ModelLoader
     {
     public:
-        // Load models using ASSIMP
-        static void FillMeshData(const aiMesh* aimesh, Mesh* linaMesh);
+        // Load models using ASSIMP, occluder geometry is built if buildOccluder is set.
+        static void FillMeshData(const aiMesh* aimesh, Mesh* linaMesh, const Skeleton& skeleton, bool buildOccluder);
         static bool LoadModel(const aiScene* scene, Model* model);
         static bool LoadModel(unsigned char* data, size_t dataSize, Model* model);
         static bool LoadModel(const std::string& fileName, Model* model);
         static bool LoadSpriteQuad(Mesh& model);
         static void SetVertexBoneData(std::vector<int>& vertexBoneIDs, std::vector<float>& vertexBoneWeights, int boneID, float weight);
+
+        // Builds the joint hierarchy out of the bones of all meshes & their ancestor nodes, needs to be loaded before the mesh data.
+        static bool LoadSkeleton(const aiScene* scene, Skeleton& skeleton);
+
+        // Imports the scene's animations into the skeleton, channels that don't drive a joint are skipped.
+        static void LoadAnimations(const aiScene* scene, Skeleton& skeleton);
+
+    private:
+        static void AddSkeletonJoints(const aiNode* node, int parent, const std::set<const aiNode*>& requiredNodes, const std::map<std::string, Matrix>& inverseBindPoses, Skeleton& skeleton);
     };
 } // namespace Lina::Graphics
 
@@ -28,13 +28,175 @@ SOFTWARE.
 
 #include "Animation/Animation.hpp"
 
-#include "Log/Log.hpp"
+#include <algorithm>
+#include <cstring>
 
 namespace Lina::Graphics
 {
-    bool Animation::LoadAnimation(const std::string& animPath)
+    namespace
     {
-        LINA_TRACE("Loading animation archive: {0}", animPath);
-        return true;
+        inline float* GetChannelData(JointTransform& joint, AnimationChannel channel)
+        {
+            if (channel == AnimationChannel::Translation)
+                return joint.m_translation;
+            else if (channel == AnimationChannel::Rotation)
+                return joint.m_rotation;
+            return joint.m_scale;
+        }
+    } // namespace
+
+    void Animation::Sample(float time, JointTransform* pose) const
+    {
+        if (m_isCompressed)
+        {
+            SampleCompressed(time, pose);
+            return;
+        }
+
+        for (const AnimationTrack& track : m_tracks)
+        {
+            JointTransform& joint = pose[track.m_joint];
+
+            if (track.m_translationCount > 0)
+                SampleChannel(track.m_translationStart, track.m_translationCount, time, false, joint.m_translation);
+
+            if (track.m_rotationCount > 0)
+                SampleChannel(track.m_rotationStart, track.m_rotationCount, time, true, joint.m_rotation);
+
+            if (track.m_scaleCount > 0)
+                SampleChannel(track.m_scaleStart, track.m_scaleCount, time, false, joint.m_scale);
+        }
+    }
+
+    void Animation::SampleChannel(uint32 start, uint32 count, float time, bool isRotation, float* out) const
+    {
+        const float*        times = &m_times[start];
+        const AnimationKey* keys  = &m_keys[start];
+
+        if (count == 1 || time <= times[0])
+        {
+            std::copy(keys[0].m_value, keys[0].m_value + 4, out);
+            return;
+        }
+
+        if (time >= times[count - 1])
+        {
+            std::copy(keys[count - 1].m_value, keys[count - 1].m_value + 4, out);
+            return;
+        }
+
+        // First key after the time, guaranteed to be in [1, count - 1] by the checks above.
+        const uint32 next = (uint32)(std::upper_bound(times, times + count, time) - times);
+        const uint32 prev = next - 1;
+        const float  t    = (time - times[prev]) / (times[next] - times[prev]);
+
+        if (isRotation)
+            AnimationMath::Nlerp(keys[prev].m_value, keys[next].m_value, t, out);
+        else
+            AnimationMath::Lerp(keys[prev].m_value, keys[next].m_value, t, out);
+    }
+
+    void Animation::SampleCompressed(float time, JointTransform* pose) const
+    {
+        for (const AnimationConstantChannel& constant : m_constants)
+            std::memcpy(GetChannelData(pose[constant.m_joint], constant.m_channel), constant.m_value.m_value, sizeof(float) * 4);
+
+        if (m_channels.empty())
+            return;
+
+        const uint32 segmentCount = (uint32)m_segmentOffsets.size();
+        const float  lastFrame    = (float)(m_frameCount - 1);
+        float        frame        = time * m_sampleRate;
+        frame                     = frame < 0.0f ? 0.0f : (frame > lastFrame ? lastFrame : frame);
+
+        uint32 segment = (uint32)frame / ANIMATION_SEGMENT_FRAMES;
+        segment        = segment < segmentCount ? segment : segmentCount - 1;
+
+        const float  localFrame   = frame - (float)(segment * ANIMATION_SEGMENT_FRAMES);
+        const uint8* block        = &m_segmentData[m_segmentOffsets[segment]];
+        const uint32 channelCount = (uint32)m_channels.size();
+
+        uint16 totalKeys = 0;
+        std::memcpy(&totalKeys, block, sizeof(uint16));
+
+        const uint8*  counts = block + sizeof(uint16);
+        const uint8*  frames = counts + channelCount;
+        const uint16* values = reinterpret_cast<const uint16*>(block + ((sizeof(uint16) + channelCount + totalKeys + 1) & ~1u));
+
+        alignas(16) float a[4];
+        alignas(16) float b[4];
+
+        for (uint32 c = 0; c < channelCount; c++)
+        {
+            const AnimationCompressedChannel& channel = m_channels[c];
+            const uint32                      count   = counts[c];
+            const bool                        isRot   = channel.m_channel == AnimationChannel::Rotation;
+            float*                            out     = GetChannelData(pose[channel.m_joint], channel.m_channel);
+
+            // Segments are short, a linear scan over the key frames touches a few bytes only.
+            uint32 key = 0;
+            while (key + 2 < count && (float)frames[key + 1] <= localFrame)
+                key++;
+
+            const uint16* keyA = values + key * 3;
+
+            if (count == 1)
+            {
+                if (isRot)
+                    AnimationMath::DecodeSmallestThree(keyA, out);
+                else
+                    AnimationMath::DecodeRange(keyA, channel.m_rangeMin, channel.m_rangeScale, out);
+            }
+            else
+            {
+                const float span = (float)(frames[key + 1] - frames[key]);
+                float       t    = (localFrame - (float)frames[key]) / span;
+                t                = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+
+                if (isRot)
+                {
+                    AnimationMath::DecodeSmallestThree(keyA, a);
+                    AnimationMath::DecodeSmallestThree(keyA + 3, b);
+                    AnimationMath::Nlerp(a, b, t, out);
+                }
+                else
+                {
+                    AnimationMath::DecodeRange(keyA, channel.m_rangeMin, channel.m_rangeScale, a);
+                    AnimationMath::DecodeRange(keyA + 3, channel.m_rangeMin, channel.m_rangeScale, b);
+                    AnimationMath::Lerp(a, b, t, out);
+                }
+            }
+
+            frames += count;
+            values += count * 3;
+        }
+    }
+
+    size_t Animation::GetDataSize() const
+    {
+        if (m_isCompressed)
+            return m_channels.size() * sizeof(AnimationCompressedChannel) + m_constants.size() * sizeof(AnimationConstantChannel) + m_segmentOffsets.size() * sizeof(uint32) + m_segmentData.size();
+
+        return m_tracks.size() * sizeof(AnimationTrack) + m_times.size() * sizeof(float) + m_keys.size() * sizeof(AnimationKey);
+    }
+
+    uint32 Animation::AddTrack(uint32 joint, const std::vector<float>& translationTimes, const std::vector<AnimationKey>& translations, const std::vector<float>& rotationTimes, const std::vector<AnimationKey>& rotations, const std::vector<float>& scaleTimes, const std::vector<AnimationKey>& scales)
+    {
+        AnimationTrack track;
+        track.m_joint = joint;
+
+        auto addChannel = [this](const std::vector<float>& times, const std::vector<AnimationKey>& keys, uint32& start, uint32& count) {
+            start = (uint32)m_times.size();
+            count = (uint32)std::min(times.size(), keys.size());
+            m_times.insert(m_times.end(), times.begin(), times.begin() + count);
+            m_keys.insert(m_keys.end(), keys.begin(), keys.begin() + count);
+        };
+
+        addChannel(translationTimes, translations, track.m_translationStart, track.m_translationCount);
+        addChannel(rotationTimes, rotations, track.m_rotationStart, track.m_rotationCount);
+        addChannel(scaleTimes, scales, track.m_scaleStart, track.m_scaleCount);
+
+        m_tracks.push_back(track);
+        return (uint32)m_tracks.size() - 1;
     }
 } // namespace Lina::Graphics
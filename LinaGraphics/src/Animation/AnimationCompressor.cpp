@@ -0,0 +1,437 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Animation/AnimationCompressor.hpp"
+
+#include "Animation/Animation.hpp"
+#include "Animation/Skeleton.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#define ANIMATION_BUDGET_ATTEMPTS 4
+
+namespace Lina::Graphics
+{
+    namespace
+    {
+        struct ChannelSource
+        {
+            uint32                    m_joint   = 0;
+            AnimationChannel          m_channel = AnimationChannel::Translation;
+            std::vector<AnimationKey> m_frames;
+            float                     m_budget = 0.0f;
+            float                     m_reach  = 0.0f;
+        };
+
+        float KeyError(const float* a, const float* b, AnimationChannel channel, float reach)
+        {
+            if (channel == AnimationChannel::Rotation)
+            {
+                // Chord length of a point at the reach distance, rotated by the angle between the quaternions.
+                // 1 - dot is taken from the distance of the quaternions, the dot product itself loses small angles to rounding.
+                const float sign     = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0.0f ? -1.0f : 1.0f;
+                float       distance = 0.0f;
+                for (int i = 0; i < 4; i++)
+                    distance += (a[i] - b[i] * sign) * (a[i] - b[i] * sign);
+
+                const float oneMinusDot = distance * 0.5f;
+                return 2.0f * std::sqrt(std::fmax(oneMinusDot * (2.0f - oneMinusDot), 0.0f)) * reach;
+            }
+
+            const float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+
+            if (channel == AnimationChannel::Translation)
+                return std::sqrt(dx * dx + dy * dy + dz * dz);
+
+            return std::fmax(std::fabs(dx), std::fmax(std::fabs(dy), std::fabs(dz))) * reach;
+        }
+
+        bool CanInterpolate(const ChannelSource& source, uint32 from, uint32 to)
+        {
+            alignas(16) float value[4];
+
+            for (uint32 f = from + 1; f < to; f++)
+            {
+                const float t = (float)(f - from) / (float)(to - from);
+
+                if (source.m_channel == AnimationChannel::Rotation)
+                    AnimationMath::Nlerp(source.m_frames[from].m_value, source.m_frames[to].m_value, t, value);
+                else
+                    AnimationMath::Lerp(source.m_frames[from].m_value, source.m_frames[to].m_value, t, value);
+
+                if (KeyError(value, source.m_frames[f].m_value, source.m_channel, source.m_reach) > source.m_budget)
+                    return false;
+            }
+
+            return true;
+        }
+
+        uint16 Quantize(float value, float maxValue)
+        {
+            const float q = std::round(value * maxValue);
+            return (uint16)(q < 0.0f ? 0.0f : (q > maxValue ? maxValue : q));
+        }
+
+        void EncodeSmallestThree(const float* q, uint16* out)
+        {
+            const float range   = 0.70710678f;
+            int         largest = 0;
+
+            for (int i = 1; i < 4; i++)
+            {
+                if (std::fabs(q[i]) > std::fabs(q[largest]))
+                    largest = i;
+            }
+
+            // q & -q are the same rotation, keep the dropped component positive.
+            const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+            float       values[3];
+
+            for (int i = 0, j = 0; i < 4; i++)
+            {
+                if (i != largest)
+                    values[j++] = (q[i] * sign + range) / (2.0f * range);
+            }
+
+            out[0] = (uint16)(Quantize(values[0], 32767.0f) << 1) | (uint16)(largest & 1);
+            out[1] = (uint16)(Quantize(values[1], 32767.0f) << 1) | (uint16)((largest >> 1) & 1);
+            out[2] = Quantize(values[2], 65535.0f);
+        }
+
+        void EncodeRange(const float* value, const AnimationCompressedChannel& channel, uint16* out)
+        {
+            for (int i = 0; i < 3; i++)
+                out[i] = channel.m_rangeScale[i] > 0.0f ? Quantize((value[i] - channel.m_rangeMin[i]) / (channel.m_rangeScale[i] * 65535.0f), 65535.0f) : 0;
+        }
+
+        const float* GetBindValue(const JointTransform& joint, AnimationChannel channel)
+        {
+            if (channel == AnimationChannel::Translation)
+                return joint.m_translation;
+            else if (channel == AnimationChannel::Rotation)
+                return joint.m_rotation;
+            return joint.m_scale;
+        }
+    } // namespace
+
+    AnimationCompressionStats AnimationCompressor::Compress(const Skeleton& skeleton, Animation& animation, const AnimationCompressionSettings& settings)
+    {
+        AnimationCompressionStats stats;
+        stats.m_rawSize        = animation.GetDataSize();
+        stats.m_compressedSize = stats.m_rawSize;
+
+        if (animation.IsCompressed() || !skeleton.IsLoaded())
+            return stats;
+
+        const uint32                       jointCount = skeleton.GetJointCount();
+        const std::vector<int>&            parents    = skeleton.GetParents();
+        const std::vector<JointTransform>& bindPose   = skeleton.GetBindPose();
+
+        // Bind pose in object space for the reach of each joint.
+        std::vector<Matrix> bindModel(jointCount);
+        skeleton.LocalToModel(bindPose.data(), Matrix::Identity(), bindModel.data());
+
+        // Errors of a joint add up with the errors of its ancestors on the way to the deepest descendant.
+        std::vector<uint32> depth(jointCount, 1);
+        std::vector<uint32> chainDepth(jointCount, 1);
+        std::vector<float>  reach(jointCount, settings.m_shellDistance);
+
+        for (uint32 i = 0; i < jointCount; i++)
+        {
+            depth[i] = parents[i] < 0 ? 1 : depth[parents[i]] + 1;
+
+            const glm::vec3 position = glm::vec3(bindModel[i][3]);
+            for (int ancestor = parents[i]; ancestor >= 0; ancestor = parents[ancestor])
+                reach[ancestor] = std::fmax(reach[ancestor], glm::length(position - glm::vec3(bindModel[ancestor][3])) + settings.m_shellDistance);
+        }
+
+        for (int i = (int)jointCount - 1; i >= 0; i--)
+        {
+            chainDepth[i] = std::max(chainDepth[i], depth[i]);
+            if (parents[i] >= 0)
+                chainDepth[parents[i]] = std::max(chainDepth[parents[i]], chainDepth[i]);
+        }
+
+        // Resample every channel at a fixed rate, frames span the clip exactly. Densely keyed clips keep their own rate so no detail is lost.
+        const float duration  = animation.GetDuration();
+        uint32      keyFrames = 0;
+        for (const AnimationTrack& track : animation.m_tracks)
+            keyFrames = std::max(keyFrames, std::max(track.m_translationCount, std::max(track.m_rotationCount, track.m_scaleCount)));
+
+        const float  targetRate = duration > 0.0f ? std::fmax(settings.m_sampleRate, (float)(keyFrames > 1 ? keyFrames - 1 : 0) / duration) : 0.0f;
+        const uint32 frameCount = duration > 0.0f ? (uint32)std::ceil(duration * targetRate - 0.001f) + 1 : 1;
+        const float  sampleRate = frameCount > 1 ? (float)(frameCount - 1) / duration : 0.0f;
+
+        // Budgets estimate how the errors add up along the chains, quantization comes on top of them. They are tightened
+        // until the measured error is within the tolerance.
+        const size_t rawSize     = stats.m_rawSize;
+        float        budgetScale = 1.0f;
+        Animation    compressed;
+
+        for (uint32 attempt = 0; attempt < ANIMATION_BUDGET_ATTEMPTS; attempt++, budgetScale *= 0.5f)
+        {
+            compressed      = Animation();
+            stats           = AnimationCompressionStats();
+            stats.m_rawSize = rawSize;
+
+            compressed.m_name         = animation.m_name;
+            compressed.m_duration     = duration;
+            compressed.m_isCompressed = true;
+            compressed.m_sampleRate   = sampleRate;
+            compressed.m_frameCount   = frameCount;
+
+            std::vector<ChannelSource> sources;
+
+            for (const AnimationTrack& track : animation.m_tracks)
+            {
+                const uint32 starts[3] = {track.m_translationStart, track.m_rotationStart, track.m_scaleStart};
+                const uint32 counts[3] = {track.m_translationCount, track.m_rotationCount, track.m_scaleCount};
+
+                for (uint32 c = 0; c < 3; c++)
+                {
+                    if (counts[c] == 0)
+                        continue;
+
+                    ChannelSource source;
+                    source.m_joint   = track.m_joint;
+                    source.m_channel = (AnimationChannel)c;
+                    source.m_budget  = settings.m_tolerance * budgetScale / (float)chainDepth[track.m_joint];
+                    source.m_reach   = reach[track.m_joint];
+
+                    // Dropping keys below the quantization error of a rotation only costs keys without reducing the error.
+                    if (source.m_channel == AnimationChannel::Rotation)
+                        source.m_budget = std::fmax(source.m_budget, 4.0f * 0.70710678f / 32767.0f * source.m_reach);
+                    source.m_frames.resize(frameCount);
+
+                    for (uint32 f = 0; f < frameCount; f++)
+                    {
+                        const float time = frameCount > 1 ? std::fmin((float)f / sampleRate, duration) : 0.0f;
+                        animation.SampleChannel(starts[c], counts[c], time, source.m_channel == AnimationChannel::Rotation, source.m_frames[f].m_value);
+
+                        // Keep rotations in the same hemisphere as the previous frame.
+                        if (source.m_channel == AnimationChannel::Rotation && f > 0)
+                        {
+                            float*       q    = source.m_frames[f].m_value;
+                            const float* prev = source.m_frames[f - 1].m_value;
+                            if (q[0] * prev[0] + q[1] * prev[1] + q[2] * prev[2] + q[3] * prev[3] < 0.0f)
+                            {
+                                for (int i = 0; i < 4; i++)
+                                    q[i] = -q[i];
+                            }
+                        }
+                    }
+
+                    bool isDefault  = true;
+                    bool isConstant = true;
+                    for (uint32 f = 0; f < frameCount && (isDefault || isConstant); f++)
+                    {
+                        isDefault  = isDefault && KeyError(source.m_frames[f].m_value, GetBindValue(bindPose[track.m_joint], source.m_channel), source.m_channel, source.m_reach) <= source.m_budget;
+                        isConstant = isConstant && KeyError(source.m_frames[f].m_value, source.m_frames[0].m_value, source.m_channel, source.m_reach) <= source.m_budget;
+                    }
+
+                    if (isDefault)
+                        stats.m_droppedChannels++;
+                    else if (isConstant)
+                    {
+                        AnimationConstantChannel constant;
+                        constant.m_joint   = source.m_joint;
+                        constant.m_channel = source.m_channel;
+                        constant.m_value   = source.m_frames[0];
+                        compressed.m_constants.push_back(constant);
+                        stats.m_constantChannels++;
+                    }
+                    else
+                        sources.push_back(std::move(source));
+                }
+            }
+
+            // Pose is written in joint order during sampling.
+            std::sort(sources.begin(), sources.end(), [](const ChannelSource& a, const ChannelSource& b) { return a.m_joint != b.m_joint ? a.m_joint < b.m_joint : a.m_channel < b.m_channel; });
+            stats.m_animatedChannels = (uint32)sources.size();
+
+            for (const ChannelSource& source : sources)
+            {
+                AnimationCompressedChannel channel;
+                channel.m_joint   = source.m_joint;
+                channel.m_channel = source.m_channel;
+
+                if (source.m_channel != AnimationChannel::Rotation)
+                {
+                    for (int i = 0; i < 3; i++)
+                    {
+                        float minValue = source.m_frames[0].m_value[i];
+                        float maxValue = minValue;
+
+                        for (const AnimationKey& frame : source.m_frames)
+                        {
+                            minValue = std::fmin(minValue, frame.m_value[i]);
+                            maxValue = std::fmax(maxValue, frame.m_value[i]);
+                        }
+
+                        channel.m_rangeMin[i]   = minValue;
+                        channel.m_rangeScale[i] = (maxValue - minValue) / 65535.0f;
+                    }
+                }
+
+                compressed.m_channels.push_back(channel);
+            }
+
+            if (!sources.empty())
+            {
+                // Segments share their border frames, so interpolation never has to look into the neighbours.
+                const uint32 segmentCount = frameCount > 1 ? (frameCount - 2) / ANIMATION_SEGMENT_FRAMES + 1 : 1;
+                const uint32 channelCount = (uint32)sources.size();
+
+                std::vector<uint8>  counts(channelCount);
+                std::vector<uint8>  frames;
+                std::vector<uint16> values;
+
+                for (uint32 segment = 0; segment < segmentCount; segment++)
+                {
+                    const uint32 start = segment * ANIMATION_SEGMENT_FRAMES;
+                    const uint32 end   = std::min(start + ANIMATION_SEGMENT_FRAMES, frameCount - 1);
+                    frames.clear();
+                    values.clear();
+
+                    for (uint32 c = 0; c < channelCount; c++)
+                    {
+                        const ChannelSource& source = sources[c];
+                        uint32               count  = 0;
+
+                        // Greedy reduction, extend each span as long as the dropped frames stay within the budget.
+                        uint32 from = start;
+                        while (true)
+                        {
+                            uint16 encoded[3];
+                            if (source.m_channel == AnimationChannel::Rotation)
+                                EncodeSmallestThree(source.m_frames[from].m_value, encoded);
+                            else
+                                EncodeRange(source.m_frames[from].m_value, compressed.m_channels[c], encoded);
+
+                            frames.push_back((uint8)(from - start));
+                            values.insert(values.end(), encoded, encoded + 3);
+                            count++;
+
+                            if (from >= end)
+                                break;
+
+                            uint32 to = from + 1;
+                            while (to < end && CanInterpolate(source, from, to + 1))
+                                to++;
+
+                            from = to;
+                        }
+
+                        counts[c] = (uint8)count;
+                        stats.m_storedKeys += count;
+                    }
+
+                    // Block start & values are kept 2 byte aligned.
+                    std::vector<uint8>& data = compressed.m_segmentData;
+                    if (data.size() & 1)
+                        data.push_back(0);
+
+                    compressed.m_segmentOffsets.push_back((uint32)data.size());
+
+                    const uint16 totalKeys = (uint16)frames.size();
+                    const size_t blockStart = data.size();
+                    data.resize(blockStart + sizeof(uint16));
+                    std::memcpy(&data[blockStart], &totalKeys, sizeof(uint16));
+                    data.insert(data.end(), counts.begin(), counts.end());
+                    data.insert(data.end(), frames.begin(), frames.end());
+
+                    if ((data.size() - blockStart) & 1)
+                        data.push_back(0);
+
+                    const size_t valuesStart = data.size();
+                    data.resize(valuesStart + values.size() * sizeof(uint16));
+                    std::memcpy(&data[valuesStart], values.data(), values.size() * sizeof(uint16));
+                }
+
+                // Decoders read a full 64 bits per key.
+                compressed.m_segmentData.push_back(0);
+                compressed.m_segmentData.push_back(0);
+            }
+
+            stats.m_compressedSize = compressed.GetDataSize();
+            stats.m_ratio          = stats.m_compressedSize > 0 ? (float)stats.m_rawSize / (float)stats.m_compressedSize : 1.0f;
+            stats.m_maxError       = MeasureError(skeleton, animation, compressed, std::fmax(sampleRate, settings.m_sampleRate), settings.m_shellDistance, &stats.m_maxErrorJoint);
+
+            if (stats.m_maxError <= settings.m_tolerance)
+                break;
+        }
+
+        animation = std::move(compressed);
+        return stats;
+    }
+
+    float AnimationCompressor::MeasureError(const Skeleton& skeleton, const Animation& reference, const Animation& animation, float sampleRate, float shellDistance, uint32* outJoint)
+    {
+        const uint32 jointCount = skeleton.GetJointCount();
+        const Matrix root       = Matrix::Identity();
+        const float  step       = 0.5f / sampleRate;
+        float        maxError   = 0.0f;
+
+        std::vector<JointTransform> localA(jointCount), localB(jointCount);
+        std::vector<Matrix>         modelA(jointCount), modelB(jointCount);
+
+        const Vector4 shell[4] = {Vector4(0.0f, 0.0f, 0.0f, 1.0f), Vector4(shellDistance, 0.0f, 0.0f, 1.0f), Vector4(0.0f, shellDistance, 0.0f, 1.0f), Vector4(0.0f, 0.0f, shellDistance, 1.0f)};
+
+        for (float time = 0.0f; time <= reference.GetDuration() + step * 0.5f; time += step)
+        {
+            const float sampleTime = std::fmin(time, reference.GetDuration());
+            localA.assign(skeleton.GetBindPose().begin(), skeleton.GetBindPose().end());
+            localB.assign(skeleton.GetBindPose().begin(), skeleton.GetBindPose().end());
+            reference.Sample(sampleTime, localA.data());
+            animation.Sample(sampleTime, localB.data());
+            skeleton.LocalToModel(localA.data(), root, modelA.data());
+            skeleton.LocalToModel(localB.data(), root, modelB.data());
+
+            for (uint32 i = 0; i < jointCount; i++)
+            {
+                for (const Vector4& vertex : shell)
+                {
+                    const glm::vec4 a     = modelA[i] * vertex;
+                    const glm::vec4 b     = modelB[i] * vertex;
+                    const float     error = glm::length(glm::vec3(a) - glm::vec3(b));
+
+                    if (error > maxError)
+                    {
+                        maxError = error;
+                        if (outJoint != nullptr)
+                            *outJoint = i;
+                    }
+                }
+            }
+        }
+
+        return maxError;
+    }
+} // namespace Lina::Graphics
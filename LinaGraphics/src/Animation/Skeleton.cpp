@@ -28,23 +28,87 @@ SOFTWARE.
 
 #include "Animation/Skeleton.hpp"
 
+#include "Animation/Animation.hpp"
 #include "Log/Log.hpp"
 
 namespace Lina::Graphics
 {
     Skeleton::~Skeleton()
     {
+        for (auto& [name, animation] : m_animationMap)
+            delete animation;
+
+        m_animationMap.clear();
+    }
+
+    int Skeleton::AddJoint(const std::string& name, int parent, const JointTransform& bindPose, const Matrix& inverseBindPose)
+    {
+        LINA_ASSERT(parent < (int)m_parents.size(), "Parent joints need to be added before their children!");
+
+        const int index = (int)m_parents.size();
+        m_jointNames.push_back(name);
+        m_jointIndices[name] = index;
+        m_parents.push_back(parent);
+        m_bindPose.push_back(bindPose);
+        m_inverseBindPose.push_back(inverseBindPose);
+        return index;
     }
 
-    bool Skeleton::LoadSkeleton(const std::string& skelPath)
+    int Skeleton::GetJointIndex(const std::string& name) const
     {
-        return false;
+        auto it = m_jointIndices.find(name);
+        return it == m_jointIndices.end() ? -1 : it->second;
     }
-    void Skeleton::SetVertexBoneDataToDefault(VertexBoneData& vertex)
+
+    void Skeleton::Evaluate(const Animation* animation, float time, const Matrix& rootTransform, SkeletonPose& pose) const
     {
+        const size_t jointCount = m_parents.size();
+        pose.m_local.assign(m_bindPose.begin(), m_bindPose.end());
+        pose.m_model.resize(jointCount);
+        pose.m_palette.resize(jointCount);
+
+        if (jointCount == 0)
+            return;
+
+        if (animation != nullptr)
+            animation->Sample(time, pose.m_local.data());
+
+        LocalToModel(pose.m_local.data(), rootTransform, pose.m_model.data());
+        BuildPalette(pose.m_model.data(), pose.m_palette.data());
+    }
+
+    void Skeleton::LocalToModel(const JointTransform* local, const Matrix& rootTransform, Matrix* outModel) const
+    {
+        alignas(16) float localMatrix[16];
+
+        for (size_t i = 0; i < m_parents.size(); i++)
+        {
+            const int    parent       = m_parents[i];
+            const float* parentMatrix = parent < 0 ? &rootTransform[0][0] : &outModel[parent][0][0];
+            AnimationMath::Compose(local[i], localMatrix);
+            AnimationMath::Multiply(parentMatrix, localMatrix, &outModel[i][0][0]);
+        }
+    }
+
+    void Skeleton::BuildPalette(const Matrix* model, Matrix* outPalette) const
+    {
+        for (size_t i = 0; i < m_parents.size(); i++)
+            AnimationMath::Multiply(&model[i][0][0], &m_inverseBindPose[i][0][0], &outPalette[i][0][0]);
+    }
+
+    void Skeleton::AddAnimation(Animation* animation)
+    {
+        auto it = m_animationMap.find(animation->GetName());
+
+        if (it != m_animationMap.end())
+            delete it->second;
+
+        m_animationMap[animation->GetName()] = animation;
     }
 
-    void Skeleton::SetVertexBoneData(VertexBoneData& vertex, int boneID, float weight)
+    Animation* Skeleton::GetAnimation(const std::string& name) const
     {
+        auto it = m_animationMap.find(name);
+        return it == m_animationMap.end() ? nullptr : it->second;
     }
 } // namespace Lina::Graphics
@@ -61,21 +61,6 @@ namespace Lina::Graphics
 
     float lineVertices[]{0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f};
 
-    struct btLine
-    {
-        GLfloat vertices[6];
-        btLine(const Vector3& f, const Vector3& t)
-        {
-            vertices[0] = f.x;
-            vertices[1] = f.y;
-            vertices[2] = f.z;
-
-            vertices[3] = t.x;
-            vertices[4] = t.y;
-            vertices[5] = t.z;
-        }
-    };
-
     float skyboxVertices[] = {
         // positions
         -1.0f, 1.0f,  -1.0f, -1.0f, -1.0f, -1.0f, 1.0f,  -1.0f, -1.0f, 1.0f,  -1.0f, -1.0f, 1.0f,  1.0f,  -1.0f, -1.0f, 1.0f,  -1.0f,
@@ -157,7 +142,7 @@ namespace Lina::Graphics
     OpenGLRenderDevice::OpenGLRenderDevice()
     {
         LINA_TRACE("[Constructor] -> OpenGLRenderDevice ({0})", typeid(*this).name());
-        m_GLVersion = m_boundFBO = m_boundVAO = m_boundShader = m_viewportFBO = 0;
+        m_GLVersion = m_viewportFBO = 0;
     }
 
     OpenGLRenderDevice::~OpenGLRenderDevice()
@@ -170,38 +155,32 @@ namespace Lina::Graphics
         const GLubyte* renderer = glGetString(GL_RENDERER); // Returns a hint to the model
         LINA_TRACE("Graphics Information: {0}, {1}", vendor, renderer);
 
-        m_isStencilTestEnabled        = defaultParams.useStencilTest;
-        m_isDepthTestEnabled          = defaultParams.useDepthTest;
-        m_isBlendingEnabled           = (defaultParams.sourceBlend != BlendFunc::BLEND_FUNC_NONE || defaultParams.destBlend != BlendFunc::BLEND_FUNC_NONE);
-        m_isScissorsTestEnabled       = defaultParams.useScissorTest;
-        m_usedDepthFunction           = defaultParams.depthFunc;
-        m_shouldWriteDepth            = defaultParams.shouldWriteDepth;
-        m_usedStencilFail             = defaultParams.stencilFail;
-        m_usedStencilPassButDepthFail = defaultParams.stencilPassButDepthFail;
-        m_usedStencilPass             = defaultParams.stencilPass;
-        m_usedStencilFunction         = defaultParams.stencilFunc;
-        m_usedStencilTestMask         = defaultParams.stencilTestMask;
-        m_usedStencilWriteMask        = defaultParams.stencilWriteMask;
-        m_usedStencilComparisonValue  = defaultParams.stencilComparisonVal;
-        m_usedFaceCulling             = defaultParams.faceCulling;
-        m_usedSourceBlending          = defaultParams.sourceBlend;
-        m_usedDestinationBlending     = defaultParams.destBlend;
-
-        // Default GL settings.
+        // Default GL settings, the state cache mirrors them exactly & the default parameters are applied on top through it.
         glEnable(GL_DEPTH_TEST);
         glEnable(GL_STENCIL_TEST);
-        glEnable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+        glDisable(GL_BLEND);
+        glDisable(GL_CULL_FACE);
+        glDisable(GL_SCISSOR_TEST);
         glEnable(GL_LINE_SMOOTH);
         glEnable(GL_MULTISAMPLE);
 
         glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
         glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
         glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+        glStencilMask(0xFF);
         glFrontFace(GL_CW);
+        glViewport(0, 0, width, height);
+        glScissor(0, 0, width, height);
+
+        m_stateCache.Reset(Vector2i(width, height));
 
-        if (m_isBlendingEnabled)
-            glBlendFunc(m_usedSourceBlending, m_usedDestinationBlending);
+        SetDrawParameters(defaultParams);
+    }
+
+    void OpenGLRenderDevice::BeginFrame()
+    {
+        m_stateCache.BeginFrame();
     }
 
     // ---------------------------------------------------------------------
@@ -219,7 +198,7 @@ namespace Lina::Graphics
 
         // Generate texture & bind to program.
         glGenTextures(1, &textureHandle);
-        glBindTexture(textureTarget, textureHandle);
+        BindTexture(textureTarget, textureHandle);
 
         glTexImage2D(textureTarget, 0, internalFormat, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, data);
 
@@ -235,7 +214,7 @@ namespace Lina::Graphics
             glTexParameteri(textureTarget, GL_TEXTURE_MAX_LEVEL, 0);
         }
 
-        glBindTexture(textureTarget, 0);
+        BindTexture(textureTarget, 0);
 
         return textureHandle;
     }
@@ -250,7 +229,7 @@ namespace Lina::Graphics
 
         // Generate texture & bind to program.
         glGenTextures(1, &textureHandle);
-        glBindTexture(textureTarget, textureHandle);
+        BindTexture(textureTarget, textureHandle);
 
         glTexImage2D(textureTarget, 0, internalFormat, size.x, size.y, 0, format, GL_FLOAT, data);
 
@@ -266,7 +245,7 @@ namespace Lina::Graphics
             glTexParameteri(textureTarget, GL_TEXTURE_MAX_LEVEL, 0);
         }
 
-        glBindTexture(textureTarget, 0);
+        BindTexture(textureTarget, 0);
 
         return textureHandle;
     }
@@ -280,7 +259,7 @@ namespace Lina::Graphics
 
         // Generate texture & bind to program.
         glGenTextures(1, &textureHandle);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureHandle);
+        BindTexture(GL_TEXTURE_CUBE_MAP, textureHandle);
 
         // Loop through each face to gen. image.
         for (GLuint i = 0; i < dataSize; i++)
@@ -299,7 +278,7 @@ namespace Lina::Graphics
             glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, 0);
         }
 
-        glBindTexture(GL_TEXTURE_2D, 0);
+        BindTexture(GL_TEXTURE_2D, 0);
         return textureHandle;
     }
 
@@ -312,7 +291,7 @@ namespace Lina::Graphics
 
         // Generate texture & bind to program.
         glGenTextures(1, &textureHandle);
-        glBindTexture(GL_TEXTURE_CUBE_MAP, textureHandle);
+        BindTexture(GL_TEXTURE_CUBE_MAP, textureHandle);
 
         // Loop through each face to gen. image.
         for (GLuint i = 0; i < 6; i++)
@@ -331,7 +310,7 @@ namespace Lina::Graphics
             // glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, 0);
         }
 
-        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        BindTexture(GL_TEXTURE_CUBE_MAP, 0);
         return textureHandle;
     }
 
@@ -345,7 +324,7 @@ namespace Lina::Graphics
 
         // Generate texture & bind to program.
         glGenTextures(1, &textureHandle);
-        glBindTexture(textureTarget, textureHandle);
+        BindTexture(textureTarget, textureHandle);
 
         // Build texture
         glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, sampleCount, internalFormat, size.x, size.y, GL_TRUE);
@@ -362,7 +341,7 @@ namespace Lina::Graphics
         //	glTexParameteri(textureTarget, GL_TEXTURE_MAX_LEVEL, 0);
         //}
 
-        glBindTexture(textureTarget, 0);
+        BindTexture(textureTarget, 0);
         return textureHandle;
     }
 
@@ -376,7 +355,7 @@ namespace Lina::Graphics
 
         // Generate texture & bind to program.
         glGenTextures(1, &textureHandle);
-        glBindTexture(textureTarget, textureHandle);
+        BindTexture(textureTarget, textureHandle);
 
         GLubyte texData[] = {255, 255, 255, 255};
         glTexImage2D(textureTarget, 0, internalFormat, size.x, size.y, 0, format, GL_UNSIGNED_BYTE, texData);
@@ -393,7 +372,7 @@ namespace Lina::Graphics
             glTexParameteri(textureTarget, GL_TEXTURE_MAX_LEVEL, 0);
         }
 
-        glBindTexture(textureTarget, 0);
+        BindTexture(textureTarget, 0);
         return textureHandle;
     }
 
@@ -415,7 +394,7 @@ namespace Lina::Graphics
 
     void OpenGLRenderDevice::UpdateTextureParameters(uint32 bindMode, uint32 id, SamplerParameters samplerParams)
     {
-        glBindTexture(bindMode, id);
+        BindTexture(bindMode, id);
         glTexParameterf(bindMode, GL_TEXTURE_MIN_FILTER, (GLfloat)samplerParams.m_textureParams.m_minFilter);
         glTexParameterf(bindMode, GL_TEXTURE_MAG_FILTER, (GLfloat)samplerParams.m_textureParams.m_magFilter);
         glTexParameteri(bindMode, GL_TEXTURE_WRAP_S, (GLint)samplerParams.m_textureParams.m_wrapS);
@@ -431,7 +410,14 @@ namespace Lina::Graphics
             glTexParameteri(bindMode, GL_TEXTURE_MAX_LEVEL, 0);
         }
 
-        glBindTexture(bindMode, 0);
+        BindTexture(bindMode, 0);
+    }
+
+    void OpenGLRenderDevice::UpdateTexture2D(uint32 id, const Vector2i& offset, const Vector2i& size, PixelFormat pixelFormat, const void* data)
+    {
+        BindTexture(GL_TEXTURE_2D, id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, size.x, size.y, GetOpenGLFormat(pixelFormat), GL_UNSIGNED_BYTE, data);
+        BindTexture(GL_TEXTURE_2D, 0);
     }
 
     uint32 OpenGLRenderDevice::ReleaseTexture2D(uint32 texture2D)
@@ -440,6 +426,10 @@ namespace Lina::Graphics
         if (texture2D == 0)
             return 0;
         glDeleteTextures(1, &texture2D);
+
+        // GL unbinds deleted textures from all units & the name can be handed out again.
+        m_stateCache.OnTextureReleased(texture2D);
+
         return 0;
     }
 
@@ -553,28 +543,27 @@ namespace Lina::Graphics
         vaoData.bufferUsage                  = bufferUsage;
         vaoData.instanceComponentsStartIndex = numVertexComponents;
 
-        // Store the array in our map & return the modified vertex array object.
-        m_vaoMap[VAO] = vaoData;
+        // Store the array in our table & return the modified vertex array object.
+        if (VAO >= m_vaoTable.size())
+            m_vaoTable.resize(VAO + 1);
+        m_vaoTable[VAO] = vaoData;
         return VAO;
     }
 
     uint32 OpenGLRenderDevice::ReleaseVertexArray(uint32 vao, bool checkMap)
     {
+        m_stateCache.OnVAOReleased(vao);
+
         if (!checkMap)
         {
             glDeleteVertexArrays(1, &vao);
             return 0;
         }
 
-        // Terminate if vao is null or does not exist in our mapped objects.
-        if (vao == 0)
+        // Terminate if vao is null or does not exist in our table.
+        VertexArrayData* vaoData = GetVertexArrayData(vao);
+        if (vaoData == nullptr)
             return 0;
-        std::map<uint32, VertexArrayData>::iterator it = m_vaoMap.find(vao);
-        if (it == m_vaoMap.end())
-            return 0;
-
-        // Get the vertex array object data from the map.
-        const struct VertexArrayData* vaoData = &it->second;
 
         // Delete the VA & buffers, then data.
         glDeleteVertexArrays(1, &vao);
@@ -582,8 +571,8 @@ namespace Lina::Graphics
         delete[] vaoData->buffers;
         delete[] vaoData->bufferSizes;
 
-        // Remove from the map.
-        m_vaoMap.erase(it);
+        // Clear the slot.
+        *vaoData = VertexArrayData();
         return 0;
     }
 
@@ -628,6 +617,84 @@ namespace Lina::Graphics
         return lineVAO;
     }
 
+    uint32 OpenGLRenderDevice::CreateDebugLineVertexArray()
+    {
+        uint32 lineVAO;
+        glGenVertexArrays(1, &lineVAO);
+        SetVAO(lineVAO);
+
+        // Stored in the table so that the buffer can be grown & released like any other VAO.
+        VertexArrayData vaoData;
+        vaoData.numBuffers                   = 1;
+        vaoData.numElements                  = 0;
+        vaoData.instanceComponentsStartIndex = 1;
+        vaoData.bufferUsage                  = BufferUsage::USAGE_DYNAMIC_DRAW;
+        vaoData.buffers                      = new uint32[1];
+        vaoData.bufferSizes                  = new uintptr[1];
+        vaoData.bufferSizes[0]               = 0;
+        glGenBuffers(1, vaoData.buffers);
+
+        const GLsizei stride = sizeof(float) * 7;
+        glBindBuffer(GL_ARRAY_BUFFER, vaoData.buffers[0]);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+
+        if (lineVAO >= m_vaoTable.size())
+            m_vaoTable.resize(lineVAO + 1);
+        m_vaoTable[lineVAO] = vaoData;
+        return lineVAO;
+    }
+
+    uint32 OpenGLRenderDevice::CreateSpriteVertexArray(uint32 maxQuads)
+    {
+        uint32 spriteVAO;
+        glGenVertexArrays(1, &spriteVAO);
+        SetVAO(spriteVAO);
+
+        VertexArrayData vaoData;
+        vaoData.numBuffers                   = 2;
+        vaoData.numElements                  = maxQuads * 6;
+        vaoData.instanceComponentsStartIndex = 1;
+        vaoData.bufferUsage                  = BufferUsage::USAGE_DYNAMIC_DRAW;
+        vaoData.buffers                      = new uint32[2];
+        vaoData.bufferSizes                  = new uintptr[2];
+        vaoData.bufferSizes[0]               = 0;
+        glGenBuffers(2, vaoData.buffers);
+
+        const GLsizei stride = sizeof(float) * 5 + sizeof(uint32);
+        glBindBuffer(GL_ARRAY_BUFFER, vaoData.buffers[0]);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(5 * sizeof(float)));
+
+        // Every quad uses the same pattern, batches offset it with a base vertex.
+        std::vector<uint32> indices(vaoData.numElements);
+        for (uint32 i = 0; i < maxQuads; i++)
+        {
+            const uint32 first = i * 4;
+            indices[i * 6 + 0] = first;
+            indices[i * 6 + 1] = first + 1;
+            indices[i * 6 + 2] = first + 2;
+            indices[i * 6 + 3] = first + 2;
+            indices[i * 6 + 4] = first + 3;
+            indices[i * 6 + 5] = first;
+        }
+
+        vaoData.bufferSizes[1] = indices.size() * sizeof(uint32);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vaoData.buffers[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, vaoData.bufferSizes[1], indices.data(), GL_STATIC_DRAW);
+
+        if (spriteVAO >= m_vaoTable.size())
+            m_vaoTable.resize(spriteVAO + 1);
+        m_vaoTable[spriteVAO] = vaoData;
+        return spriteVAO;
+    }
+
     uint32 OpenGLRenderDevice::CreateHDRICubeVertexArray()
     {
         uint32 cubeVAO, cubeVBO;
@@ -637,7 +704,7 @@ namespace Lina::Graphics
         glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(hdriCubemapVertices), hdriCubemapVertices, GL_STATIC_DRAW);
         // link vertex attributes
-        glBindVertexArray(cubeVAO);
+        SetVAO(cubeVAO);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(1);
@@ -645,7 +712,7 @@ namespace Lina::Graphics
         glEnableVertexAttribArray(2);
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        SetVAO(0);
         return cubeVAO;
     }
 
@@ -681,6 +748,9 @@ namespace Lina::Graphics
         if (sampler == 0)
             return 0;
         glDeleteSamplers(1, &sampler);
+
+        m_stateCache.OnSamplerReleased(sampler);
+
         return 0;
     }
 
@@ -695,9 +765,9 @@ namespace Lina::Graphics
         // Bind a new uniform buffer to GL.
         uint32 ubo;
         glGenBuffers(1, &ubo);
-        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        SetUBO(ubo);
         glBufferData(GL_UNIFORM_BUFFER, dataSize, data, usage);
-        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        SetUBO(0);
         return ubo;
     }
 
@@ -707,6 +777,9 @@ namespace Lina::Graphics
         if (buffer == 0)
             return 0;
         glDeleteBuffers(1, &buffer);
+
+        m_stateCache.OnUBOReleased(buffer);
+
         return 0;
     }
 
@@ -756,9 +829,10 @@ namespace Lina::Graphics
         // Bind attributes for GL & add shader uniforms.
         AddAllAttributes(shaderProgram, vertexShaderText, GetVersion());
         AddShaderUniforms(shaderProgram, shaderText, programData.uniformBlockMap, programData.uniformMap, programData.samplerMap);
-        // Store the program in our map & return it.
-        m_shaderProgramMap[shaderProgram] = programData;
-        *data                             = ScanShaderUniforms(shaderProgram);
+        // Store the program in our table & return it.
+        programData.isValid             = true;
+        GetShaderProgram(shaderProgram) = programData;
+        *data                           = ScanShaderUniforms(shaderProgram);
 
         return shaderProgram;
     }
@@ -773,14 +847,11 @@ namespace Lina::Graphics
     uint32 OpenGLRenderDevice::ReleaseShaderProgram(uint32 shader)
     {
         // Terminate if shader is not valid or does not exist in our map.
-        if (shader == 0)
-            return 0;
-        std::map<uint32, ShaderProgram>::iterator programIt = m_shaderProgramMap.find(shader);
-        if (programIt == m_shaderProgramMap.end())
+        if (shader == 0 || shader >= m_shaderProgramTable.size() || !m_shaderProgramTable[shader].isValid)
             return 0;
 
-        // Get the program from the map.
-        const ShaderProgram* shaderProgram = &programIt->second;
+        // Get the program from the table.
+        const ShaderProgram* shaderProgram = &m_shaderProgramTable[shader];
 
         // Detach & delete each shader assigned to our program.
         for (std::vector<uint32>::const_iterator it = shaderProgram->shaders.begin(); it != shaderProgram->shaders.end(); ++it)
@@ -789,9 +860,12 @@ namespace Lina::Graphics
             glDeleteShader(*it);
         }
 
-        // Delete the program, erase from our map & return.
+        // Unbind, delete the program, clear the slot & return.
+        if (shader == m_stateCache.GetShader())
+            SetShader(0);
+
         glDeleteProgram(shader);
-        m_shaderProgramMap.erase(programIt);
+        m_shaderProgramTable[shader] = ShaderProgram();
         return 0;
     }
 
@@ -845,7 +919,7 @@ namespace Lina::Graphics
         GLenum textureAttachment = bindTextureMode + textureAttachmentNumber;
 
         if (bindTexture)
-            glBindTexture(GL_TEXTURE_2D, texture);
+            BindTexture(GL_TEXTURE_2D, texture);
 
         if (bindTextureMode != TextureBindMode::BINDTEXTURE_NONE)
             glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentTypeGL, textureAttachment, texture, mipLevel);
@@ -865,18 +939,18 @@ namespace Lina::Graphics
 
     void OpenGLRenderDevice::ResizeRTTexture(uint32 texture, Vector2i newSize, PixelFormat m_internalPixelFormat, PixelFormat m_pixelFormat, TextureBindMode bindMode, bool compress)
     {
-        glBindTexture(bindMode, texture);
+        BindTexture(bindMode, texture);
         GLint format         = GetOpenGLFormat(m_pixelFormat);
         GLint internalFormat = GetOpenGLInternalFormat(m_internalPixelFormat, compress);
         glTexImage2D(bindMode, 0, internalFormat, (uint32)newSize.x, (uint32)newSize.y, 0, format, GL_UNSIGNED_BYTE, NULL);
-        glBindTexture(bindMode, 0);
+        BindTexture(bindMode, 0);
     }
 
     void OpenGLRenderDevice::ResizeRenderBuffer(uint32 fbo, uint32 rbo, Vector2i newSize, RenderBufferStorage storage)
     {
-        glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+        SetRBO(rbo);
         glRenderbufferStorage(GL_RENDERBUFFER, storage, (uint32)newSize.x, (uint32)newSize.y);
-        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        SetRBO(0);
     }
 
     uint32 OpenGLRenderDevice::ReleaseRenderTarget(uint32 fbo)
@@ -885,8 +959,11 @@ namespace Lina::Graphics
         if (fbo == 0)
             return 0;
 
-        // Delete the frame buffer object, erase from our map & return.
+        // Delete the frame buffer object, GL falls back to the default one if it was bound.
         glDeleteFramebuffers(1, &fbo);
+
+        m_stateCache.OnFBOReleased(fbo);
+
         return 0;
     }
 
@@ -894,7 +971,7 @@ namespace Lina::Graphics
     {
         unsigned int rbo;
         glGenRenderbuffers(1, &rbo);
-        glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+        SetRBO(rbo);
 
         if (sampleCount == 0)
             glRenderbufferStorage(GL_RENDERBUFFER, storage, width, height);
@@ -907,6 +984,9 @@ namespace Lina::Graphics
     uint32 OpenGLRenderDevice::ReleaseRenderBufferObject(uint32 target)
     {
         glDeleteRenderbuffers(1, &target);
+
+        m_stateCache.OnRBOReleased(target);
+
         return 0;
     }
 
@@ -924,25 +1004,18 @@ namespace Lina::Graphics
 
     void OpenGLRenderDevice::GenerateTextureMipmaps(uint32 texture, TextureBindMode bindMode)
     {
-        glBindTexture(bindMode, texture);
+        BindTexture(bindMode, texture);
         glGenerateMipmap(bindMode);
     }
 
     void OpenGLRenderDevice::BlitRenderTargets(uint32 readFBO, uint32 readWidth, uint32 readHeight, uint32 writeFBO, uint32 writeWidth, uint32 writeHeight, BufferBit mask, SamplerFilter filter, FrameBufferAttachment att, uint32 attCount)
     {
-        if (m_boundReadFBO != readFBO)
-        {
-            m_boundReadFBO = readFBO;
-        }
         glBindFramebuffer(GL_READ_FRAMEBUFFER, readFBO);
         glReadBuffer(att + attCount);
-        if (m_boundWriteFBO != writeFBO)
-        {
-            m_boundWriteFBO = writeFBO;
-        }
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, writeFBO);
         glDrawBuffer(att + attCount);
         glBlitFramebuffer(0, 0, readWidth, readHeight, 0, 0, writeWidth, writeHeight, mask, filter);
+        m_stateCache.SetBlitTargets(readFBO, writeFBO);
     }
 
     bool OpenGLRenderDevice::IsRenderTargetComplete(uint32 fbo)
@@ -967,28 +1040,39 @@ namespace Lina::Graphics
     void OpenGLRenderDevice::SetShader(uint32 shader)
     {
         // Use the target shader if exists.
-        if (shader == m_boundShader)
-            return;
-        glUseProgram(shader);
-        m_boundShader = shader;
+        if (m_stateCache.SetShader(shader))
+            glUseProgram(shader);
     }
 
     void OpenGLRenderDevice::SetTexture(uint32 texture, uint32 sampler, uint32 unit, TextureBindMode bindTextureMode, bool setSampler)
     {
-        glActiveTexture(GL_TEXTURE0 + unit);
-        glBindTexture(bindTextureMode, texture);
+        SetActiveTextureUnit(unit);
+        BindTexture(bindTextureMode, texture);
 
-        if (setSampler)
+        if (setSampler && m_stateCache.BindSampler(unit, sampler))
             glBindSampler(unit, sampler);
     }
 
+    void OpenGLRenderDevice::SetActiveTextureUnit(uint32 unit)
+    {
+        if (m_stateCache.SetActiveTextureUnit(unit))
+            glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    void OpenGLRenderDevice::BindTexture(uint32 target, uint32 texture)
+    {
+        if (m_stateCache.BindTexture(target, texture))
+            glBindTexture(target, texture);
+    }
+
     void OpenGLRenderDevice::SetShaderUniformBuffer(uint32 shader, const std::string& uniformBufferName, uint32 buffer)
     {
         // Use shader first.
         SetShader(shader);
 
-        // Update the uniform data.
-        glBindBufferBase(GL_UNIFORM_BUFFER, m_shaderProgramMap[shader].uniformBlockMap[uniformBufferName], buffer);
+        // Update the uniform data, also binds the buffer to the generic binding point.
+        glBindBufferBase(GL_UNIFORM_BUFFER, GetShaderProgram(shader).uniformBlockMap[uniformBufferName], buffer);
+        m_stateCache.SetBufferBase(buffer);
     }
 
     void OpenGLRenderDevice::ReadPixels(uint32 x, uint32 y, uint32 w, uint32 h, FrameBufferAttachment att, uint32 attachmentNumber, void* data)
@@ -1003,20 +1087,38 @@ namespace Lina::Graphics
     void OpenGLRenderDevice::GetTextureImage(uint32 texture, PixelFormat format, TextureBindMode bindMode, void*& pixels)
     {
         GLint oglFormat = GetOpenGLFormat(format);
-        glBindTexture(bindMode, texture);
+        BindTexture(bindMode, texture);
         glGetTexImage(bindMode, (GLint)0, oglFormat, GL_FLOAT, pixels);
-        glBindTexture(bindMode, 0);
+        BindTexture(bindMode, 0);
+    }
+
+    void OpenGLRenderDevice::GetCubemapFaceImage(uint32 texture, uint32 face, PixelFormat format, void* pixels)
+    {
+        GLint oglFormat = GetOpenGLFormat(format);
+        BindTexture(GL_TEXTURE_CUBE_MAP, texture);
+        glGetTexImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, (GLint)0, oglFormat, GL_FLOAT, pixels);
+        BindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    }
+
+    void OpenGLRenderDevice::UpdateCubemapFace(uint32 texture, uint32 face, Vector2i size, PixelFormat internalFormat, PixelFormat format, const float* pixels)
+    {
+        GLint oglFormat         = GetOpenGLFormat(format);
+        GLint oglInternalFormat = GetOpenGLInternalFormat(internalFormat, false);
+        BindTexture(GL_TEXTURE_CUBE_MAP, texture);
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, oglInternalFormat, size.x, size.y, 0, oglFormat, GL_FLOAT, pixels);
+        BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     }
 
     void OpenGLRenderDevice::BindUniformBuffer(uint32 bufferObject, uint32 point)
     {
-        // Bind the buffer object to the point.
+        // Bind the buffer object to the point, also binds it to the generic binding point.
         glBindBufferBase(GL_UNIFORM_BUFFER, point, bufferObject);
+        m_stateCache.SetBufferBase(bufferObject);
     }
 
     void OpenGLRenderDevice::BindShaderBlockToBufferPoint(uint32 shader, uint32 blockPoint, std::string& blockName)
     {
-        glUniformBlockBinding(shader, m_shaderProgramMap[shader].uniformBlockMap[blockName], blockPoint);
+        glUniformBlockBinding(shader, GetShaderProgram(shader).uniformBlockMap[blockName], blockPoint);
     }
 
     // ---------------------------------------------------------------------
@@ -1030,13 +1132,10 @@ namespace Lina::Graphics
         // Terminate if VAO is not valid or does not exist in our map.
         if (vao == 0)
             return;
-        std::map<uint32, VertexArrayData>::iterator it = m_vaoMap.find(vao);
-        if (it == m_vaoMap.end())
+        VertexArrayData* vaoData = GetVertexArrayData(vao);
+        if (vaoData == nullptr)
             return;
 
-        // Get VAO data from the map.
-        const struct VertexArrayData* vaoData = &it->second;
-
         BufferUsage usage;
 
         // Check usage & enable dynamic draw if is needed to be instanced.
@@ -1063,17 +1162,13 @@ namespace Lina::Graphics
     void OpenGLRenderDevice::UpdateUniformBuffer(uint32 buffer, const void* data, uintptr offset, uintptr dataSize)
     {
         // Get buffer & set data.
-        if (m_boundUBO != buffer)
-        {
-            glBindBuffer(GL_UNIFORM_BUFFER, buffer);
-            m_boundUBO = buffer;
-        }
-
+        SetUBO(buffer);
         glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, data);
     }
 
     void OpenGLRenderDevice::UpdateUniformBuffer(uint32 buffer, const void* data, uintptr dataSize)
     {
+        SetUBO(buffer);
         void* dest = glMapBuffer(GL_UNIFORM_BUFFER, GL_WRITE_ONLY);
         Memory::memcpy(dest, data, dataSize);
         glUnmapBuffer(GL_UNIFORM_BUFFER);
@@ -1184,6 +1279,8 @@ namespace Lina::Graphics
         // Set vao & draw
         SetVAO(vao);
 
+        m_stateCache.AddDrawCall();
+
         if (drawArrays)
         {
             glDrawArrays(drawParams.primitiveType, 0, numElements);
@@ -1203,40 +1300,31 @@ namespace Lina::Graphics
         // This function requires you to set model matrix in the debuglines shader.
         glLineWidth(width);
         glDrawArrays(GL_LINES, 0, 2);
+        m_stateCache.AddDrawCall();
     }
 
-    void OpenGLRenderDevice::DrawLine(uint32 shader, const Matrix& model, const Vector3& from, const Vector3& to, float width)
+    void OpenGLRenderDevice::DrawLines(uint32 vao, uint32 vertexCount, float width)
     {
-        // Set line width.
-        glLineWidth(width);
-
-        // Lines
-        btLine  lines(from, to);
-        Vector3 result = to - from;
-        GLuint  vao, vbo;
-
-        // Buffers
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
-        glBindVertexArray(vao);
+        if (vertexCount == 0)
+            return;
 
-        // UPLOADING VERTEX
-        glBindBuffer(GL_ARRAY_BUFFER, vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6, lines.vertices, GL_STATIC_DRAW);
+        SetVAO(vao);
+        glLineWidth(width);
+        glDrawArrays(GL_LINES, 0, (GLsizei)vertexCount);
+        m_stateCache.AddDrawCall();
+    }
 
-        // Enable position.
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 3, (GLvoid*)0);
-        glBindVertexArray(0);
+    void OpenGLRenderDevice::DrawBaseVertex(uint32 vao, const DrawParams& drawParams, uint32 numElements, uint32 baseVertex)
+    {
+        if (numElements == 0)
+            return;
 
-        // Draw
-        glBindVertexArray(vao);
-        glDrawArrays(GL_LINES, 0, 2);
-        glBindVertexArray(0);
+        if (!drawParams.skipParameters)
+            SetDrawParameters(drawParams);
 
-        // delete buffers
-        glDeleteVertexArrays(1, &vao);
-        glDeleteBuffers(1, &vbo);
+        SetVAO(vao);
+        glDrawElementsBaseVertex(drawParams.primitiveType, (GLsizei)numElements, GL_UNSIGNED_INT, 0, (GLint)baseVertex);
+        m_stateCache.AddDrawCall();
     }
 
     void OpenGLRenderDevice::Clear(bool shouldClearColor, bool shouldClearDepth, bool shouldClearStencil, const Color& color, uint32 stencil)
@@ -1249,11 +1337,8 @@ namespace Lina::Graphics
         {
             flags |= GL_COLOR_BUFFER_BIT;
 
-            if (color != m_currentClearColor)
-            {
+            if (m_stateCache.SetClearColor(color))
                 glClearColor((GLfloat)color.r, (GLfloat)color.g, (GLfloat)color.b, (GLfloat)color.a);
-                m_currentClearColor = color;
-            }
         }
         if (shouldClearDepth)
             flags |= GL_DEPTH_BUFFER_BIT;
@@ -1269,60 +1354,80 @@ namespace Lina::Graphics
 
     void OpenGLRenderDevice::UpdateShaderUniformFloat(uint32 shader, const std::string& uniform, const float f)
     {
-        glUniform1f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)f);
+        glUniform1f(GetShaderProgram(shader).uniformMap[uniform], (GLfloat)f);
     }
 
     void OpenGLRenderDevice::UpdateShaderUniformInt(uint32 shader, const std::string& uniform, const int f)
     {
-        glUniform1i(m_shaderProgramMap[shader].uniformMap[uniform], (GLint)f);
+        glUniform1i(GetShaderProgram(shader).uniformMap[uniform], (GLint)f);
     }
 
     void OpenGLRenderDevice::UpdateShaderUniformColor(uint32 shader, const std::string& uniform, const Color& color)
     {
-        glUniform3f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)color.r, (GLfloat)color.g, (GLfloat)color.b);
+        glUniform3f(GetShaderProgram(shader).uniformMap[uniform], (GLfloat)color.r, (GLfloat)color.g, (GLfloat)color.b);
     }
 
     void OpenGLRenderDevice::UpdateShaderUniformVector2(uint32 shader, const std::string& uniform, const Vector2& m)
     {
-        glUniform2f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y);
+        glUniform2f(GetShaderProgram(shader).uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y);
     }
 
     void OpenGLRenderDevice::UpdateShaderUniformVector3(uint32 shader, const std::string& uniform, const Vector3& m)
     {
-        glUniform3f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z);
+        glUniform3f(GetShaderProgram(shader).uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z);
     }
 
     void OpenGLRenderDevice::UpdateShaderUniformVector4F(uint32 shader, const std::string& uniform, const Vector4& m)
     {
-        glUniform4f(m_shaderProgramMap[shader].uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z, (GLfloat)m.w);
+        glUniform4f(GetShaderProgram(shader).uniformMap[uniform], (GLfloat)m.x, (GLfloat)m.y, (GLfloat)m.z, (GLfloat)m.w);
     }
 
     void OpenGLRenderDevice::UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, void* data)
     {
         float* matrixData = ((float*)data);
-        glUniformMatrix4fv(m_shaderProgramMap[shader].uniformMap[uniform], 1, GL_FALSE, matrixData);
+        glUniformMatrix4fv(GetShaderProgram(shader).uniformMap[uniform], 1, GL_FALSE, matrixData);
     }
 
     void OpenGLRenderDevice::UpdateShaderUniformMatrix(uint32 shader, const std::string& uniform, const Matrix& m)
     {
-        glUniformMatrix4fv(m_shaderProgramMap[shader].uniformMap[uniform], 1, GL_FALSE, &m[0][0]);
+        glUniformMatrix4fv(GetShaderProgram(shader).uniformMap[uniform], 1, GL_FALSE, &m[0][0]);
     }
 
     void OpenGLRenderDevice::SetVAO(uint32 vao)
     {
         // Use VAO if exists.
-        if (vao == m_boundVAO)
-            return;
-        glBindVertexArray(vao);
-        m_boundVAO = vao;
+        if (m_stateCache.SetVAO(vao))
+            glBindVertexArray(vao);
+    }
+
+    void OpenGLRenderDevice::SetUBO(uint32 ubo)
+    {
+        if (m_stateCache.SetUBO(ubo))
+            glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    }
+
+    VertexArrayData* OpenGLRenderDevice::GetVertexArrayData(uint32 vao)
+    {
+        if (vao == 0 || vao >= m_vaoTable.size() || m_vaoTable[vao].buffers == nullptr)
+            return nullptr;
+
+        return &m_vaoTable[vao];
+    }
+
+    ShaderProgram& OpenGLRenderDevice::GetShaderProgram(uint32 shader)
+    {
+        if (shader >= m_shaderProgramTable.size())
+            m_shaderProgramTable.resize(shader + 1);
+
+        return m_shaderProgramTable[shader];
     }
 
     void OpenGLRenderDevice::CaptureHDRILightingData(Matrix& view, Matrix& projection, Vector2i captureSize, uint32 cubeMapTexture, uint32 hdrTexture, uint32 fbo, uint32 rbo, uint32 shader)
     {
         uint32 captureFBO;
         glGenFramebuffers(1, &captureFBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, captureFBO);
-        glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+        SetFBO(captureFBO);
+        SetRBO(rbo);
         glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, rbo);
 
         SetShader(shader);
@@ -1333,18 +1438,14 @@ namespace Lina::Graphics
 
     void OpenGLRenderDevice::SetFBO(uint32 fbo)
     {
-        if (fbo == m_boundFBO)
-            return;
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        m_boundFBO = m_boundReadFBO = m_boundWriteFBO = fbo;
+        if (m_stateCache.SetFBO(fbo))
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     }
 
     void OpenGLRenderDevice::SetRBO(uint32 rbo)
     {
-        if (rbo == m_boundRBO)
-            return;
-        glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-        m_boundRBO = rbo;
+        if (m_stateCache.SetRBO(rbo))
+            glBindRenderbuffer(GL_RENDERBUFFER, rbo);
     }
 
     void OpenGLRenderDevice::SetViewport(Vector2i pos, Vector2i size)
@@ -1353,112 +1454,89 @@ namespace Lina::Graphics
         // if (fbo == m_ViewportFBO) return;
         // m_ViewportFBO = fbo;
 
-        if (pos == m_boundViewportPos && size == m_boundViewportSize)
-            return;
-        glViewport((uint32)pos.x, (uint32)pos.y, (uint32)size.x, (uint32)size.y);
-        m_boundViewportSize = size;
-        m_boundViewportPos  = pos;
+        if (m_stateCache.SetViewport(pos, size))
+            glViewport((uint32)pos.x, (uint32)pos.y, (uint32)size.x, (uint32)size.y);
     }
 
     void OpenGLRenderDevice::SetFaceCulling(FaceCulling faceCulling)
     {
-        // If target is enabled, then disable face culling.
-        // If current is disabled, then enable faceculling.
-        // Else switch cull state.
-        if (faceCulling == FACE_CULL_NONE)
-        {
-            glDisable(GL_CULL_FACE);
-            m_usedFaceCulling = FACE_CULL_NONE;
+        const FaceCulling previous = m_stateCache.GetFaceCulling();
+
+        if (!m_stateCache.SetFaceCulling(faceCulling))
             return;
-        }
-        else if (m_usedFaceCulling == FACE_CULL_NONE) // Face culling is disabled but needs to be enabled
-            glEnable(GL_CULL_FACE);
 
-        if (m_usedFaceCulling != faceCulling)
+        if (faceCulling == FACE_CULL_NONE)
+            glDisable(GL_CULL_FACE);
+        else
         {
-            m_usedFaceCulling = faceCulling;
+            if (previous == FACE_CULL_NONE) // Face culling is disabled but needs to be enabled
+                glEnable(GL_CULL_FACE);
+
             glCullFace(faceCulling);
         }
     }
 
     void OpenGLRenderDevice::SetDepthTest(bool shouldWrite, DrawFunc depthFunc)
     {
-
         // Toggle dept writing.
-        if (shouldWrite != m_shouldWriteDepth)
-        {
+        if (m_stateCache.SetDepthWrite(shouldWrite))
             glDepthMask(shouldWrite ? GL_TRUE : GL_FALSE);
-            m_shouldWriteDepth = shouldWrite;
-        }
 
         // Update if change is needed.
-        if (depthFunc == m_usedDepthFunction)
-            return;
-
-        glDepthFunc(depthFunc);
-        m_usedDepthFunction = depthFunc;
+        if (m_stateCache.SetDepthFunc(depthFunc))
+            glDepthFunc(depthFunc);
     }
 
     void OpenGLRenderDevice::SetDepthTestEnable(bool enable)
     {
-        if (m_isDepthTestEnabled != enable)
-        {
-            if (enable)
-                glEnable(GL_DEPTH_TEST);
-            else
-                glDisable(GL_DEPTH_TEST);
+        if (!m_stateCache.SetDepthTestEnable(enable))
+            return;
 
-            m_isDepthTestEnabled = enable;
-        }
+        if (enable)
+            glEnable(GL_DEPTH_TEST);
+        else
+            glDisable(GL_DEPTH_TEST);
     }
+
     void OpenGLRenderDevice::SetBlending(BlendFunc sourceBlend, BlendFunc destBlend)
     {
+        const bool wasEnabled = m_stateCache.IsBlendingEnabled();
+
         // If no change is needed return.
-        if (sourceBlend == m_usedSourceBlending && destBlend == m_usedDestinationBlending)
+        if (!m_stateCache.SetBlending(sourceBlend, destBlend))
             return;
-        else if (sourceBlend == BLEND_FUNC_NONE || destBlend == BLEND_FUNC_NONE)
-            glDisable(GL_BLEND);
-        else if (m_usedSourceBlending == BLEND_FUNC_NONE || m_usedDestinationBlending == BLEND_FUNC_NONE)
+
+        if (!m_stateCache.IsBlendingEnabled())
         {
-            glEnable(GL_BLEND);
-            glBlendFunc(sourceBlend, destBlend);
+            if (wasEnabled)
+                glDisable(GL_BLEND);
         }
         else
-            glBlendFunc(sourceBlend, destBlend);
+        {
+            if (!wasEnabled)
+                glEnable(GL_BLEND);
 
-        m_usedSourceBlending      = sourceBlend;
-        m_usedDestinationBlending = destBlend;
+            glBlendFunc(sourceBlend, destBlend);
+        }
     }
 
     void OpenGLRenderDevice::SetStencilTest(bool enable, DrawFunc stencilFunc, uint32 stencilTestMask, uint32 stencilWriteMask, int32 stencilComparisonVal, StencilOp stencilFail, StencilOp stencilPassButDepthFail, StencilOp stencilPass)
     {
         // If change is needed toggle enabled state & enable/disable stencil test.
-        if (enable != m_isStencilTestEnabled)
+        if (m_stateCache.SetStencilTestEnable(enable))
         {
             if (enable)
                 glEnable(GL_STENCIL_TEST);
             else
                 glDisable(GL_STENCIL_TEST);
-
-            m_isStencilTestEnabled = enable;
         }
 
         // Set stencil params.
-        if (stencilFunc != m_usedStencilFunction || stencilTestMask != m_usedStencilTestMask || stencilComparisonVal != m_usedStencilComparisonValue)
-        {
+        if (m_stateCache.SetStencilFunc(stencilFunc, stencilTestMask, stencilComparisonVal))
             glStencilFunc(stencilFunc, stencilComparisonVal, stencilTestMask);
-            m_usedStencilComparisonValue = stencilComparisonVal;
-            m_usedStencilTestMask        = stencilTestMask;
-            m_usedStencilFunction        = stencilFunc;
-        }
 
-        if (stencilFail != m_usedStencilFail || stencilPass != m_usedStencilPass || stencilPassButDepthFail != m_usedStencilPassButDepthFail)
-        {
+        if (m_stateCache.SetStencilOp(stencilFail, stencilPassButDepthFail, stencilPass))
             glStencilOp(stencilFail, stencilPassButDepthFail, stencilPass);
-            m_usedStencilFail             = stencilFail;
-            m_usedStencilPass             = stencilPass;
-            m_usedStencilPassButDepthFail = stencilPassButDepthFail;
-        }
 
         SetStencilWriteMask(stencilWriteMask);
     }
@@ -1466,32 +1544,23 @@ namespace Lina::Graphics
     void OpenGLRenderDevice::SetStencilWriteMask(uint32 mask)
     {
         // Set write mask if a change is needed.
-        if (m_usedStencilWriteMask == mask)
-            return;
-        glStencilMask(mask);
-        m_usedStencilWriteMask = mask;
+        if (m_stateCache.SetStencilWriteMask(mask))
+            glStencilMask(mask);
     }
 
     void OpenGLRenderDevice::SetScissorTest(bool enable, uint32 startX, uint32 startY, uint32 width, uint32 height)
     {
-        // Disable if enabled.
-        if (!enable)
+        // Toggle the test, the box only matters while it's enabled.
+        if (m_stateCache.SetScissorTestEnable(enable))
         {
-            if (!m_isScissorsTestEnabled)
-                return;
+            if (enable)
+                glEnable(GL_SCISSOR_TEST);
             else
-            {
                 glDisable(GL_SCISSOR_TEST);
-                m_isScissorsTestEnabled = false;
-                return;
-            }
         }
 
-        // Enable if disabled, then bind it.
-        if (!m_isScissorsTestEnabled)
-            glEnable(GL_SCISSOR_TEST);
-        glScissor(startX, startY, width, height);
-        m_isScissorsTestEnabled = true;
+        if (enable && m_stateCache.SetScissorBox(startX, startY, width, height))
+            glScissor(startX, startY, width, height);
     }
 
     std::string OpenGLRenderDevice::GetShaderVersion()
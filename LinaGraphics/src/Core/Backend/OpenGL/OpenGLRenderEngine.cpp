@@ -82,6 +82,7 @@ namespace Lina::Graphics
         m_eventSystem = Event::EventSystem::Get();
         m_eventSystem->Connect<Event::EWindowResized, &OpenGLRenderEngine::OnWindowResized>(this);
         m_eventSystem->Connect<Event::EDrawLine, &OpenGLRenderEngine::OnDrawLine>(this);
+        m_eventSystem->Connect<Event::EDrawLines, &OpenGLRenderEngine::OnDrawLines>(this);
         m_eventSystem->Connect<Event::EDrawBox, &OpenGLRenderEngine::OnDrawBox>(this);
         m_eventSystem->Connect<Event::EDrawCircle, &OpenGLRenderEngine::OnDrawCircle>(this);
         m_eventSystem->Connect<Event::EDrawSphere, &OpenGLRenderEngine::OnDrawSphere>(this);
@@ -131,6 +132,7 @@ namespace Lina::Graphics
         m_hdriCubeVAO   = m_renderDevice.CreateHDRICubeVertexArray();
         m_screenQuadVAO = m_renderDevice.CreateScreenQuadVertexArray();
         m_lineVAO       = m_renderDevice.CreateLineVertexArray();
+        m_debugLineVAO  = m_renderDevice.CreateDebugLineVertexArray();
 
         // Meshes
         Graphics::ModelLoader::LoadSpriteQuad(m_quadMesh);
@@ -149,15 +151,19 @@ namespace Lina::Graphics
         m_modelNodeSystem.Initialize("Model Node System", m_appMode);
         m_spriteRendererSystem.Initialize("Sprite System");
         m_frustumSystem.Initialize("Frustum System");
+        m_spatialIndexSystem.Initialize("Spatial Index System");
+        m_staticBatchSystem.Initialize("Static Batch System");
         m_reflectionSystem.Initialize("Reflection System", m_appMode);
 
-        // Order is important.
-        AddToRenderingPipeline(m_cameraSystem);
-        AddToRenderingPipeline(m_frustumSystem);
-        AddToRenderingPipeline(m_reflectionSystem);
+        // Order is important. Scene extraction runs once per frame, view systems run for each rendered view.
+        AddToRenderingPipeline(m_spatialIndexSystem);
+        AddToRenderingPipeline(m_staticBatchSystem);
         AddToRenderingPipeline(m_modelNodeSystem);
         AddToRenderingPipeline(m_spriteRendererSystem);
         AddToRenderingPipeline(m_lightingSystem);
+        m_viewPipeline.AddSystem(m_cameraSystem);
+        m_viewPipeline.AddSystem(m_frustumSystem);
+        m_viewPipeline.AddSystem(m_reflectionSystem);
 
         // Animation pipeline
         m_animationSystem.Initialize("Animation System");
@@ -195,6 +201,10 @@ namespace Lina::Graphics
             shader->BindBlockToBuffer(UNIFORMBUFFER_VIEWDATA_BINDPOINT, UNIFORMBUFFER_VIEWDATA_NAME);
             shader->BindBlockToBuffer(UNIFORMBUFFER_LIGHTDATA_BINDPOINT, UNIFORMBUFFER_LIGHTDATA_NAME);
             shader->BindBlockToBuffer(UNIFORMBUFFER_DEBUGDATA_BINDPOINT, UNIFORMBUFFER_DEBUGDATA_NAME);
+
+            // Only the lit shader declares the bone block, binding a missing block would rebind the first one.
+            if (shader == m_standardLitShader)
+                shader->BindBlockToBuffer(UF_BONEDATA_BINDPOINT, UF_BONEDATA);
         }
     }
 
@@ -248,6 +258,7 @@ namespace Lina::Graphics
         m_hdriMaterial.SetShader(m_hdriEquirectangularShader);
         m_debugLineMaterial.SetShader(m_storage->GetResource<Shader>("Resources/Engine/Shaders/Debug/DebugLine.glsl"));
         m_debugIconMaterial.SetShader(m_storage->GetResource<Shader>("Resources/Engine/Shaders/Debug/DebugIcon.glsl"));
+        m_spriteRendererSystem.SetShader(m_storage->GetResource<Shader>("Resources/Engine/Shaders/2D/Sprite.glsl"));
         m_shadowMapMaterial.SetShader(m_storage->GetResource<Shader>("Resources/Engine/Shaders/ScreenQuads/SQShadowMap.glsl"));
         m_pLightShadowDepthMaterial.SetShader(m_storage->GetResource<Shader>("Resources/Engine/Shaders/PBR/PointShadowsDepth.glsl"));
         UpdateRenderSettings();
@@ -262,41 +273,18 @@ namespace Lina::Graphics
         cubemapParams.m_textureParams.m_internalPixelFormat                                                                   = PixelFormat::FORMAT_RGB16F;
         cubemapParams.m_textureParams.m_pixelFormat                                                                           = PixelFormat::FORMAT_RGB;
 
-        // GBuffer
-        SamplerParameters gBufferParams4;
-        gBufferParams4.m_textureParams.m_pixelFormat         = PixelFormat::FORMAT_RGB;
-        gBufferParams4.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGBA16F;
-        gBufferParams4.m_textureParams.m_minFilter           = SamplerFilter::FILTER_NEAREST;
-        gBufferParams4.m_textureParams.m_magFilter           = SamplerFilter::FILTER_NEAREST;
-
         // Primary
         m_primaryRTParams.m_textureParams.m_pixelFormat         = PixelFormat::FORMAT_RGB;
         m_primaryRTParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGBA16F;
         m_primaryRTParams.m_textureParams.m_minFilter = m_primaryRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
         m_primaryRTParams.m_textureParams.m_wrapS = m_primaryRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
 
-        // Ping pong
-        m_pingPongRTParams.m_textureParams.m_pixelFormat         = PixelFormat::FORMAT_RGB;
-        m_pingPongRTParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_RGBA16F;
-        m_pingPongRTParams.m_textureParams.m_minFilter = m_pingPongRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_LINEAR;
-        m_pingPongRTParams.m_textureParams.m_wrapS = m_pingPongRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
-
         // Shadows depth.
         m_shadowsRTParams.m_textureParams.m_pixelFormat         = PixelFormat::FORMAT_DEPTH;
         m_shadowsRTParams.m_textureParams.m_internalPixelFormat = PixelFormat::FORMAT_DEPTH;
         m_shadowsRTParams.m_textureParams.m_minFilter = m_shadowsRTParams.m_textureParams.m_magFilter = SamplerFilter::FILTER_NEAREST;
         m_shadowsRTParams.m_textureParams.m_wrapS = m_shadowsRTParams.m_textureParams.m_wrapR = m_shadowsRTParams.m_textureParams.m_wrapT = SamplerWrapMode::WRAP_CLAMP_EDGE;
 
-        // Initialize primary RT textures
-        m_primaryMSAARTTexture0.ConstructRTTextureMSAA(m_screenSize, m_primaryRTParams, 4);
-        m_primaryMSAARTTexture1.ConstructRTTextureMSAA(m_screenSize, m_primaryRTParams, 4);
-        m_primaryRTTexture0.ConstructRTTexture(m_screenSize, m_primaryRTParams, false);
-        m_primaryRTTexture1.ConstructRTTexture(m_screenSize, m_primaryRTParams, false);
-
-        // Initialize ping pong rt texture
-        m_pingPongRTTexture1.ConstructRTTexture(m_screenSize, m_pingPongRTParams, false);
-        m_pingPongRTTexture2.ConstructRTTexture(m_screenSize, m_pingPongRTParams, false);
-
         // Cubemaps
         m_reflectionCubemap.ConstructRTCubemapTexture(m_hdriResolution, cubemapParams);
         m_skyboxIrradianceCubemap.ConstructRTCubemapTexture(m_skyboxIrradianceResolution, cubemapParams);
@@ -308,46 +296,18 @@ namespace Lina::Graphics
         for (int i = 0; i < MAX_POINT_LIGHTS; i++)
             m_pLightShadowTextures[i].ConstructRTCubemapTexture(m_pLightShadowResolution, m_shadowsRTParams);
 
-        // Initialize primary render buffer
-        m_primaryBuffer.Construct(RenderBufferStorage::STORAGE_DEPTH, m_screenSize);
-        m_primaryMSAABuffer.Construct(RenderBufferStorage::STORAGE_DEPTH, m_screenSize, 4);
-
         // Initialize hdri render buffer
         m_hdriCaptureRenderBuffer.Construct(RenderBufferStorage::STORAGE_DEPTH_COMP24, m_hdriResolution);
         m_reflectionCaptureRenderBuffer.Construct(RenderBufferStorage::STORAGE_DEPTH_COMP24, m_hdriResolution);
         m_skyboxIrradianceCaptureRenderBuffer.Construct(RenderBufferStorage::STORAGE_DEPTH_COMP24, m_skyboxIrradianceResolution);
 
-        // Initialize primary render target.
-        m_primaryRenderTarget.Construct(m_primaryRTTexture0, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-        m_primaryMSAATarget.Construct(m_primaryMSAARTTexture0, TextureBindMode::BINDTEXTURE_TEXTURE2D_MULTISAMPLE, FrameBufferAttachment::ATTACHMENT_COLOR, FrameBufferAttachment::ATTACHMENT_DEPTH, m_primaryMSAABuffer.GetID(), 0);
-
-        m_gBufferPosition.ConstructRTTexture(m_screenSize, gBufferParams4, false);
-        m_gBufferNormal.ConstructRTTexture(m_screenSize, gBufferParams4, false);
-        m_gBufferAlbedo.ConstructRTTexture(m_screenSize, gBufferParams4, false);
-        m_gBufferEmission.ConstructRTTexture(m_screenSize, gBufferParams4, false);
-        m_gBufferMetallicRoughnessAOWorkflow.ConstructRTTexture(m_screenSize, gBufferParams4, false);
-
+        // GBuffer color attachments are attached by the frame graph.
         m_gBufferRenderBuffer.Construct(RenderBufferStorage::STORAGE_DEPTH, m_screenSize);
-        m_gBuffer.Construct(m_gBufferPosition, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, FrameBufferAttachment::ATTACHMENT_DEPTH, m_gBufferRenderBuffer.GetID(), 0);
-        m_renderDevice.BindTextureToRenderTarget(m_gBuffer.GetID(), m_gBufferNormal.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 1);
-        m_renderDevice.BindTextureToRenderTarget(m_gBuffer.GetID(), m_gBufferAlbedo.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 2);
-        m_renderDevice.BindTextureToRenderTarget(m_gBuffer.GetID(), m_gBufferEmission.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 3);
-        m_renderDevice.BindTextureToRenderTarget(m_gBuffer.GetID(), m_gBufferMetallicRoughnessAOWorkflow.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 4);
+        m_gBuffer.Construct(FrameBufferAttachment::ATTACHMENT_DEPTH, m_gBufferRenderBuffer.GetID());
         uint32 gBufferAttachments[5] = {FrameBufferAttachment::ATTACHMENT_COLOR, (FrameBufferAttachment::ATTACHMENT_COLOR + (uint32)1), (FrameBufferAttachment::ATTACHMENT_COLOR + (uint32)2),
                                         (FrameBufferAttachment::ATTACHMENT_COLOR + (uint32)3), (FrameBufferAttachment::ATTACHMENT_COLOR + (uint32)4)};
         m_renderDevice.MultipleDrawBuffersCommand(m_gBuffer.GetID(), 5, gBufferAttachments);
 
-        // Bind the extre texture to primary render target, also tell open gl that we are running mrts.
-        m_renderDevice.BindTextureToRenderTarget(m_primaryRenderTarget.GetID(), m_primaryRTTexture1.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 1);
-        m_renderDevice.BindTextureToRenderTarget(m_primaryMSAATarget.GetID(), m_primaryMSAARTTexture1.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D_MULTISAMPLE, FrameBufferAttachment::ATTACHMENT_COLOR, 1);
-        uint32 attachments[2] = {FrameBufferAttachment::ATTACHMENT_COLOR, (FrameBufferAttachment::ATTACHMENT_COLOR + (uint32)1)};
-        m_renderDevice.MultipleDrawBuffersCommand(m_primaryRenderTarget.GetID(), 2, attachments);
-        m_renderDevice.MultipleDrawBuffersCommand(m_primaryMSAATarget.GetID(), 2, attachments);
-
-        // Initialize ping pong render targets
-        m_pingPongRenderTarget1.Construct(m_pingPongRTTexture1, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-        m_pingPongRenderTarget2.Construct(m_pingPongRTTexture2, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
-
         // Initialize HDRI render target
         m_hdriCaptureRenderTarget.Construct(FrameBufferAttachment::ATTACHMENT_DEPTH, m_hdriCaptureRenderBuffer.GetID());
         m_reflectionCaptureRenderTarget.Construct(FrameBufferAttachment::ATTACHMENT_DEPTH, m_reflectionCaptureRenderBuffer.GetID());
@@ -369,6 +329,8 @@ namespace Lina::Graphics
             m_previewRenderBuffer.Construct(RenderBufferStorage::STORAGE_DEPTH, m_screenSize);
             m_previewRenderTarget.Construct(m_previewRTTexture, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, FrameBufferAttachment::ATTACHMENT_DEPTH, m_previewRenderBuffer.GetID());
         }
+
+        BuildFrameGraph();
     }
 
     void OpenGLRenderEngine::Shutdown()
@@ -383,6 +345,9 @@ namespace Lina::Graphics
         m_screenQuadVAO = m_renderDevice.ReleaseVertexArray(m_screenQuadVAO);
         m_hdriCubeVAO   = m_renderDevice.ReleaseVertexArray(m_hdriCubeVAO);
         m_lineVAO       = m_renderDevice.ReleaseVertexArray(m_lineVAO);
+        m_debugLineVAO  = m_renderDevice.ReleaseVertexArray(m_debugLineVAO);
+
+        ReleaseFrameGraphTextures();
     }
 
     void OpenGLRenderEngine::Tick(float delta)
@@ -392,6 +357,8 @@ namespace Lina::Graphics
 
     void OpenGLRenderEngine::Render(float interpolation)
     {
+        m_frame++;
+        m_renderDevice.BeginFrame();
         m_eventSystem->Trigger<Event::EPreRender>(Event::EPreRender{});
 
         Draw();
@@ -424,14 +391,7 @@ namespace Lina::Graphics
         m_screenSize = size;
         m_cameraSystem.SetAspectRatio((float)m_screenSize.x / (float)m_screenSize.y);
 
-        // Resize render buffers & frame buffer textures
-        m_renderDevice.ResizeRTTexture(m_pingPongRTTexture1.GetID(), m_screenSize, m_pingPongRTParams.m_textureParams.m_internalPixelFormat, m_pingPongRTParams.m_textureParams.m_pixelFormat);
-        m_renderDevice.ResizeRTTexture(m_pingPongRTTexture1.GetID(), m_screenSize, m_pingPongRTParams.m_textureParams.m_internalPixelFormat, m_pingPongRTParams.m_textureParams.m_pixelFormat);
-        m_renderDevice.ResizeRTTexture(m_primaryMSAARTTexture0.GetID(), m_screenSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
-        m_renderDevice.ResizeRTTexture(m_primaryMSAARTTexture1.GetID(), m_screenSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
-        m_renderDevice.ResizeRTTexture(m_primaryRTTexture0.GetID(), m_screenSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
-        m_renderDevice.ResizeRTTexture(m_primaryRTTexture1.GetID(), m_screenSize, m_primaryRTParams.m_textureParams.m_internalPixelFormat, m_primaryRTParams.m_textureParams.m_pixelFormat);
-
+        // Resize render buffers & frame buffer textures, frame graph textures are rebuilt on the next draw.
         for (auto& p : m_postProcessMap)
         {
             SamplerParameters sp = p.second.GetParams();
@@ -447,83 +407,37 @@ namespace Lina::Graphics
 
     void OpenGLRenderEngine::OnDrawLine(const Event::EDrawLine& event)
     {
-        DrawLine(event.m_from, event.m_to, event.m_color, event.m_lineWidth);
+        m_debugDrawBatcher.AddLine(event.m_from, event.m_to, event.m_color);
     }
 
-    void OpenGLRenderEngine::OnDrawBox(const Event::EDrawBox& event)
+    void OpenGLRenderEngine::OnDrawLines(const Event::EDrawLines& event)
     {
-        const Vector3 pos         = event.m_position;
-        const Vector3 halfExtents = event.m_halfExtents;
-
-        const Vector3 bottomLB = pos - halfExtents;
-        const Vector3 bottomLF = pos + Vector3(-halfExtents.x, -halfExtents.y, halfExtents.z);
-        const Vector3 bottomRB = pos + Vector3(halfExtents.x, -halfExtents.y, -halfExtents.z);
-        const Vector3 bottomRF = pos + Vector3(halfExtents.x, -halfExtents.y, halfExtents.z);
-
-        const Vector3 topLB = pos + Vector3(-halfExtents.x, halfExtents.y, -halfExtents.z);
-        const Vector3 topLF = pos + Vector3(-halfExtents.x, halfExtents.y, halfExtents.z);
-        const Vector3 topRB = pos + Vector3(halfExtents.x, halfExtents.y, -halfExtents.z);
-        const Vector3 topRF = pos + Vector3(halfExtents.x, halfExtents.y, halfExtents.z);
-
-        std::vector<Vector3> lines{bottomLB, bottomLF, bottomLF, bottomRF, bottomRF, bottomRB, bottomRB, bottomLB, topLB, topLF, topLF, topRF, topRF, topRB, topRB, topLB, bottomLB, topLB, bottomLF, topLF, bottomRF, topRF, bottomRB, topRB};
-
-        for (int i = 0; i < lines.size(); i += 2)
-            DrawLine(lines[i], lines[i + 1], event.m_color, event.m_lineWidth);
+        m_debugDrawBatcher.AddPackedLines(event.m_lines, event.m_lineCount);
+    }
 
-        lines.clear();
+    void OpenGLRenderEngine::OnDrawBox(const Event::EDrawBox& event)
+    {
+        m_debugDrawBatcher.AddBox(event.m_position, event.m_halfExtents, event.m_color);
     }
 
     void OpenGLRenderEngine::OnDrawCircle(const Event::EDrawCircle& event)
     {
-        Vector3          previousPos = (event.m_radius * Vector3(1, 0, 0));
-        const Quaternion rot         = event.m_rotation;
-
-        std::vector<std::pair<Vector3, Vector3>> lines;
-
-        const float end = event.m_half ? 200.0f : 380.0f;
-        for (float angle = 20.0f; angle < end; angle += 20.0f)
-        {
-            float         radians = Math::ToRadians(angle);
-            float         x       = event.m_radius * Math::Cos(radians);
-            float         y       = event.m_radius * Math::Sin(radians);
-            const Vector3 pos     = Vector3(x, 0, y);
-            const Vector3 start   = rot * previousPos;
-            const Vector3 target  = rot * pos;
-            lines.push_back(std::make_pair(start, target));
-            previousPos = pos;
-        }
-
-        for (auto& l : lines)
-            DrawLine(event.m_position + l.first, event.m_position + l.second, event.m_color, event.m_lineWidth);
+        m_debugDrawBatcher.AddCircle(event.m_position, event.m_radius, event.m_color, event.m_rotation, event.m_half);
     }
 
     void OpenGLRenderEngine::OnDrawSphere(const Event::EDrawSphere& event)
     {
-        OnDrawCircle(Event::EDrawCircle{event.m_position, event.m_radius, event.m_color, event.m_lineWidth, false, Quaternion()});
-        OnDrawCircle(Event::EDrawCircle{event.m_position, event.m_radius, event.m_color, event.m_lineWidth, false, Quaternion(Vector3(0, 0, 1), 90)});
-        OnDrawCircle(Event::EDrawCircle{event.m_position, event.m_radius, event.m_color, event.m_lineWidth, false, Quaternion(Vector3(1, 0, 0), 90)});
+        m_debugDrawBatcher.AddSphere(event.m_position, event.m_radius, event.m_color);
     }
 
     void OpenGLRenderEngine::OnDrawHemiSphere(const Event::EDrawHemiSphere& event)
     {
-        Quaternion q1 = Quaternion(Vector3(1, 0, 0), event.m_top ? -90.0f : 90.0f);
-        Quaternion q2 = q1 * Quaternion(Vector3(0, 0, 1), 90);
-        OnDrawCircle(Event::EDrawCircle{event.m_position, event.m_radius, event.m_color, event.m_lineWidth, false, Quaternion()});
-        OnDrawCircle(Event::EDrawCircle{event.m_position, event.m_radius, event.m_color, event.m_lineWidth, true, q1});
-        OnDrawCircle(Event::EDrawCircle{event.m_position, event.m_radius, event.m_color, event.m_lineWidth, true, q2});
+        m_debugDrawBatcher.AddHemiSphere(event.m_position, event.m_radius, event.m_top, event.m_color);
     }
 
     void OpenGLRenderEngine::OnDrawCapsule(const Event::EDrawCapsule& event)
     {
-        const Vector3 pos    = event.m_position;
-        const float   rad    = event.m_radius;
-        const float   height = event.m_height;
-        OnDrawHemiSphere(Event::EDrawHemiSphere{pos + Vector3(0, height, 0), rad, event.m_color, event.m_lineWidth, true});
-        OnDrawHemiSphere(Event::EDrawHemiSphere{pos - Vector3(0, height, 0), rad, event.m_color, event.m_lineWidth, false});
-        DrawLine(pos + Vector3(-rad, -height, 0.0f), pos + Vector3(-rad, height, 0.0f), event.m_color, event.m_lineWidth);
-        DrawLine(pos + Vector3(rad, -height, 0.0f), pos + Vector3(rad, height, 0.0f), event.m_color, event.m_lineWidth);
-        DrawLine(pos + Vector3(0.0f, -height, -rad), pos + Vector3(0.0f, height, -rad), event.m_color, event.m_lineWidth);
-        DrawLine(pos + Vector3(0.0f, -height, rad), pos + Vector3(0.0f, height, rad), event.m_color, event.m_lineWidth);
+        m_debugDrawBatcher.AddCapsule(event.m_position, event.m_radius, event.m_height, event.m_color);
     }
 
     void OpenGLRenderEngine::OnWindowResized(const Event::EWindowResized& event)
@@ -541,6 +455,11 @@ namespace Lina::Graphics
         {
             ConstructEngineMaterials();
         }
+        else if (ev.m_tid == GetTypeID<Texture>())
+        {
+            // Sprite textures of the bundle are packed together, the order doesn't depend on the order they were loaded in.
+            m_spriteRendererSystem.GetAtlas().Pack();
+        }
     }
 
     void OpenGLRenderEngine::OnResourceReloaded(const Event::EResourceReloaded& ev)
@@ -552,24 +471,158 @@ namespace Lina::Graphics
             shader->BindBlockToBuffer(UNIFORMBUFFER_LIGHTDATA_BINDPOINT, UNIFORMBUFFER_LIGHTDATA_NAME);
             shader->BindBlockToBuffer(UNIFORMBUFFER_DEBUGDATA_BINDPOINT, UNIFORMBUFFER_DEBUGDATA_NAME);
             shader->BindBlockToBuffer(UNIFORMBUFFER_APPDATA_BINDPOINT, UNIFORMBUFFER_APPDATA_NAME);
+
+            if (shader == m_standardLitShader)
+                shader->BindBlockToBuffer(UF_BONEDATA_BINDPOINT, UF_BONEDATA);
         }
     }
 
     void OpenGLRenderEngine::DumpMemory()
     {
-        while (!m_debugLineQueue.empty())
-            m_debugLineQueue.pop();
-
-        while (!m_debugIconQueue.empty())
-            m_debugIconQueue.pop();
+        m_debugDrawBatcher.Clear();
     }
 
     void OpenGLRenderEngine::Draw()
     {
-        UpdateSystems(0.0f);
+        ExtractScene();
+        UpdateView();
+
+        // Transient targets are sized to the screen & bloom adds 2 more, rebuild the graph if either changed.
+        if (m_frameGraphSize.x != m_screenSize.x || m_frameGraphSize.y != m_screenSize.y || m_frameGraphBloom != m_renderSettings->m_bloomEnabled)
+            BuildFrameGraph();
+
+        m_frameGraph.Execute();
+    }
+
+    void OpenGLRenderEngine::BuildFrameGraph()
+    {
+        m_frameGraphSize  = m_screenSize;
+        m_frameGraphBloom = m_renderSettings->m_bloomEnabled;
+        m_frameGraph.Reset();
+
+        // GBuffer & bloom blur are sampled on texel centers, FXAA filters the scene color.
+        RenderGraphTextureDesc screenDesc;
+        screenDesc.m_size = m_screenSize;
+
+        RenderGraphTextureDesc sceneColorDesc = screenDesc;
+        sceneColorDesc.m_filter               = SamplerFilter::FILTER_LINEAR;
+
+        RenderGraphTextureDesc shadowDesc;
+        shadowDesc.m_size                = m_pLightShadowResolution;
+        shadowDesc.m_internalPixelFormat = PixelFormat::FORMAT_DEPTH;
+        shadowDesc.m_isCubemap           = true;
+
+        // Point light shadows are kept in persistent cubemaps, output is the back buffer or an editor target.
+        m_fgPointLightShadows = m_frameGraph.ImportTexture("Point Light Shadows", shadowDesc);
+        m_fgOutput            = m_frameGraph.ImportTexture("Output", screenDesc);
+        m_fgGBuffer[0]        = m_frameGraph.CreateTexture("GBuffer Position", screenDesc);
+        m_fgGBuffer[1]        = m_frameGraph.CreateTexture("GBuffer Normal", screenDesc);
+        m_fgGBuffer[2]        = m_frameGraph.CreateTexture("GBuffer Albedo", screenDesc);
+        m_fgGBuffer[3]        = m_frameGraph.CreateTexture("GBuffer Emission", screenDesc);
+        m_fgGBuffer[4]        = m_frameGraph.CreateTexture("GBuffer MetallicRoughnessAO", screenDesc);
+        m_fgSceneColor        = m_frameGraph.CreateTexture("Scene Color", sceneColorDesc);
+        m_fgBloom[0]          = m_frameGraph.CreateTexture("Bloom Ping", screenDesc);
+        m_fgBloom[1]          = m_frameGraph.CreateTexture("Bloom Pong", screenDesc);
+
+        const uint32 shadowPass = m_frameGraph.AddPass("Point Light Shadows", [this]() { DrawPointLightShadows(); });
+        m_frameGraph.Write(shadowPass, m_fgPointLightShadows);
+
+        const uint32 gBufferPass = m_frameGraph.AddPass("GBuffer", [this]() { DrawGBuffer(); });
+        for (int i = 0; i < 5; i++)
+            m_frameGraph.Write(gBufferPass, m_fgGBuffer[i]);
+
+        const uint32 lightingPass = m_frameGraph.AddPass("Lighting", [this]() { DrawLighting(); });
+        for (int i = 0; i < 5; i++)
+            m_frameGraph.Read(lightingPass, m_fgGBuffer[i]);
+        m_frameGraph.Read(lightingPass, m_fgPointLightShadows);
+        m_frameGraph.Write(lightingPass, m_fgSceneColor);
+
+        // Culled when bloom is disabled as nothing reads its output.
+        const uint32 bloomPass = m_frameGraph.AddPass("Bloom", [this]() { DrawBloom(); });
+        m_frameGraph.Read(bloomPass, m_fgGBuffer[3]);
+        m_frameGraph.Write(bloomPass, m_fgBloom[0]);
+        m_frameGraph.Write(bloomPass, m_fgBloom[1]);
+
+        const uint32 compositePass = m_frameGraph.AddPass("Composite", [this]() { DrawComposite(); });
+        m_frameGraph.Read(compositePass, m_fgSceneColor);
+        if (m_frameGraphBloom)
+            m_frameGraph.Read(compositePass, m_fgBloom[1]);
+        m_frameGraph.Write(compositePass, m_fgOutput);
+
+        m_frameGraph.Compile();
+        RealizeFrameGraph();
+
+        const RenderGraphStats& stats = m_frameGraph.GetStats();
+        LINA_TRACE("[Render Graph] -> {0} passes ({1} culled), {2} transient targets on {3} textures, {4} KB -> {5} KB", stats.m_passes, stats.m_culledPasses, stats.m_transientTextures, stats.m_physicalTextures,
+                   stats.m_memoryBeforeAliasing / 1024, stats.m_memoryAfterAliasing / 1024);
+    }
+
+    void OpenGLRenderEngine::RealizeFrameGraph()
+    {
+        ReleaseFrameGraphTextures();
+
+        // One GL texture per physical slot, transients with disjoint lifetimes share them.
+        for (auto& desc : m_frameGraph.GetPhysicalTextures())
+        {
+            SamplerParameters params                     = m_primaryRTParams;
+            params.m_textureParams.m_internalPixelFormat = desc.m_internalPixelFormat;
+            params.m_textureParams.m_minFilter = params.m_textureParams.m_magFilter = desc.m_filter;
+
+            Texture* texture = new Texture();
+            texture->ConstructRTTexture(desc.m_size, params, false);
+            m_frameGraphTextures.push_back(texture);
+        }
+
+        m_renderDevice.ResizeRenderBuffer(m_gBuffer.GetID(), m_gBufferRenderBuffer.GetID(), m_screenSize, RenderBufferStorage::STORAGE_DEPTH);
+        for (int i = 0; i < 5; i++)
+            m_renderDevice.BindTextureToRenderTarget(m_gBuffer.GetID(), GetFrameGraphTexture(m_fgGBuffer[i])->GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, i);
+
+        m_sceneColorTarget = new RenderTarget();
+        m_sceneColorTarget->Construct(*GetFrameGraphTexture(m_fgSceneColor), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
+
+        for (int i = 0; i < 2; i++)
+        {
+            Texture* bloomTexture = GetFrameGraphTexture(m_fgBloom[i]);
+            if (bloomTexture == nullptr)
+                continue;
+
+            m_bloomTargets[i] = new RenderTarget();
+            m_bloomTargets[i]->Construct(*bloomTexture, TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR);
+        }
+    }
+
+    void OpenGLRenderEngine::ReleaseFrameGraphTextures()
+    {
+        delete m_sceneColorTarget;
+        m_sceneColorTarget = nullptr;
+
+        for (int i = 0; i < 2; i++)
+        {
+            delete m_bloomTargets[i];
+            m_bloomTargets[i] = nullptr;
+        }
+
+        for (auto* texture : m_frameGraphTextures)
+            delete texture;
+
+        m_frameGraphTextures.clear();
+    }
+
+    Texture* OpenGLRenderEngine::GetFrameGraphTexture(uint32 texture)
+    {
+        const uint32 physical = m_frameGraph.GetPhysicalTexture(texture);
+        return physical == RENDERGRAPH_INVALID ? nullptr : m_frameGraphTextures[physical];
+    }
+
+    void OpenGLRenderEngine::DrawPointLightShadows()
+    {
+        // Model previews don't have any lights.
+        if (m_previewModel != nullptr)
+            return;
 
         // Set render targets for point light shadows & calculate all the depth textures.
-        auto& tuple = m_lightingSystem.GetPointLights();
+        auto& tuple         = m_lightingSystem.GetPointLights();
+        bool  culledShadows = false;
         for (int i = 0; i < tuple.size(); i++)
         {
             if (std::get<1>(tuple[i])->m_castsShadows)
@@ -578,6 +631,13 @@ namespace Lina::Graphics
                 float   farPlane  = std::get<1>(tuple[i])->m_shadowFar;
                 float   nearPlane = std::get<1>(tuple[i])->m_shadowNear;
 
+                // The six faces together cover a box of the far plane's size around the light, casters outside of the
+                // camera's frustum still throw shadows into it.
+                Frustum shadowFrustum;
+                shadowFrustum.Calculate(Matrix::Orthographic(-farPlane, farPlane, -farPlane, farPlane, -farPlane, farPlane) * Matrix::Translate(-lightPos), false);
+                CullView(shadowFrustum, lightPos);
+                culledShadows = true;
+
                 std::vector<Matrix> shadowTransforms = m_lightingSystem.GetPointLightMatrices(lightPos, m_pLightShadowResolution, nearPlane, farPlane);
 
                 // Set render target
@@ -599,10 +659,23 @@ namespace Lina::Graphics
             }
         }
 
-        // m_renderDevice.SetFBO(m_primaryMSAATarget.GetID());
+        // The following passes draw from the camera.
+        if (culledShadows)
+            RestoreCameraView();
+    }
+
+    void OpenGLRenderEngine::DrawGBuffer()
+    {
         m_renderDevice.SetFBO(m_gBuffer.GetID());
         m_renderDevice.SetViewport(Vector2::Zero, m_screenSize);
 
+        if (m_previewModel != nullptr)
+        {
+            m_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+            m_modelNodeSystem.FlushModelNode(m_previewModel->m_rootNode, m_previewMatrix, m_defaultDrawParams, m_previewMaterial);
+            return;
+        }
+
         if (!Event::EventSystem::Get()->IsEmpty<Event::ECustomRender>())
             Event::EventSystem::Get()->Trigger<Event::ECustomRender>(Event::ECustomRender{});
         else
@@ -623,85 +696,13 @@ namespace Lina::Graphics
 
         // Draw debugs
         ProcessDebugQueue();
-
-        // Finalize drawing.
-        DrawFinalize();
     }
 
-    void OpenGLRenderEngine::DrawFinalize(RenderTarget* overrideTarget)
+    void OpenGLRenderEngine::DrawLighting()
     {
-        // Frag color
-        // m_renderDevice.BlitRenderTargets(m_primaryMSAATarget.GetID(), m_screenSize.x, m_screenSize.y, m_primaryRenderTarget.GetID(), m_screenSize.x, m_screenSize.y, BufferBit::BIT_COLOR, SamplerFilter::FILTER_NEAREST, FrameBufferAttachment::ATTACHMENT_COLOR, (uint32)0);
-
-        // Bright color - HDR
-        // m_renderDevice.BlitRenderTargets(m_primaryMSAATarget.GetID(), m_screenSize.x, m_screenSize.y, m_primaryRenderTarget.GetID(), m_screenSize.x, m_screenSize.y, BufferBit::BIT_COLOR, SamplerFilter::FILTER_NEAREST, FrameBufferAttachment::ATTACHMENT_COLOR, (uint32)1);
-
-        // Below we process bloom post fx based on brightColor output in the shaders.
-        //bool horizontal = true;
-        //if (m_renderSettings->m_bloomEnabled)
-        //{
-        //    // Write to the pingpong buffers to apply 2 pass gaussian blur.
-        //    bool         firstIteration = true;
-        //    unsigned int amount         = 10;
-        //    for (unsigned int i = 0; i < amount; i++)
-        //    {
-        //        // Select FBO
-        //        m_renderDevice.SetFBO(horizontal ? m_pingPongRenderTarget1.GetID() : m_pingPongRenderTarget2.GetID());
-        //
-        //        // Setup material & use.
-        //        m_screenQuadBlurMaterial.SetBool(MAT_ISHORIZONTAL, horizontal);
-        //        if (firstIteration)
-        //            m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_primaryRTTexture1);
-        //        else
-        //        {
-        //            if (horizontal)
-        //                m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_pingPongRTTexture2);
-        //            else
-        //                m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, &m_pingPongRTTexture1);
-        //        }
-        //
-        //        // Update shader data & draw.
-        //        UpdateShaderData(&m_screenQuadBlurMaterial);
-        //        m_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
-        //        horizontal = !horizontal;
-        //        if (firstIteration)
-        //            firstIteration = false;
-        //    }
-        //}
-
-        // Take the final image (without bloom), run it through a custom post processing pipeline.
-        // Texture* screenMap = &m_primaryRTTexture0;
-        // for (auto& pp : m_postProcessMap)
-        // {
-        //     pp.second.Draw(screenMap);
-        //     screenMap = &pp.second.GetTexture();
-        // }
-
-        // After we've applied custom post processing, draw the final image either to the screen, or to a secondary frame buffer to display it in editor.
-        if (m_appMode == ApplicationMode::Editor)
-        {
-            if (overrideTarget != nullptr)
-                m_renderDevice.SetFBO(overrideTarget->GetID());
-            else
-                m_renderDevice.SetFBO(m_secondaryRenderTarget.GetID());
-        }
-        else
-            // Back to default buffer
-            m_renderDevice.SetFBO(0);
-
-        m_renderDevice.SetViewport(m_screenPos, m_screenSize);
-        m_renderDevice.Clear(true, true, true, Color::White, 0xFF);
-
-        // Set frame buffer texture on the material.
-        // m_screenQuadFinalMaterial.SetTexture(MAT_MAP_SCREEN, screenMap, TextureBindMode::BINDTEXTURE_TEXTURE2D);
-        //
-        // if (m_screenQuadFinalMaterial.m_bools[MAT_BLOOMENABLED])
-        //     m_screenQuadFinalMaterial.SetTexture(MAT_MAP_BLOOM, horizontal ? &m_pingPongRTTexture1 : &m_pingPongRTTexture2, TextureBindMode::BINDTEXTURE_TEXTURE2D);
-        //
-        // Vector2 inverseMapSize = 1.0f / Vector2((float)m_primaryRTTexture0.GetSize().x, (float)(m_primaryRTTexture0.GetSize().y));
-        // m_screenQuadFinalMaterial.SetVector3(MAT_INVERSESCREENMAPSIZE, Vector3(inverseMapSize.x, inverseMapSize.y, 0.0));
-        //
-        // UpdateShaderData(&m_screenQuadFinalMaterial);
+        m_renderDevice.SetFBO(m_sceneColorTarget->GetID());
+        m_renderDevice.SetViewport(Vector2::Zero, m_screenSize);
+        m_renderDevice.Clear(true, true, true, Color::Black, 0xFF);
 
         if (m_skyboxMaterial->m_triggersHDRIReflections && !m_gBufferLightPassMaterial.m_hdriDataSet)
         {
@@ -710,11 +711,11 @@ namespace Lina::Graphics
         else if (!m_skyboxMaterial->m_triggersHDRIReflections && m_gBufferLightPassMaterial.m_hdriDataSet)
             RemoveHDRIData(&m_gBufferLightPassMaterial);
 
-        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GPOS, &m_gBufferPosition);
-        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GNORMAL, &m_gBufferNormal);
-        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GALBEDO, &m_gBufferAlbedo);
-        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GEMISSION, &m_gBufferEmission);
-        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GMETALLICROUGHNESSAOWORKFLOW, &m_gBufferMetallicRoughnessAOWorkflow);
+        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GPOS, GetFrameGraphTexture(m_fgGBuffer[0]));
+        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GNORMAL, GetFrameGraphTexture(m_fgGBuffer[1]));
+        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GALBEDO, GetFrameGraphTexture(m_fgGBuffer[2]));
+        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GEMISSION, GetFrameGraphTexture(m_fgGBuffer[3]));
+        m_gBufferLightPassMaterial.SetTexture(MAT_MAP_GMETALLICROUGHNESSAOWORKFLOW, GetFrameGraphTexture(m_fgGBuffer[4]));
         m_gBufferLightPassMaterial.SetTexture(MAT_MAP_REFLECTION, &m_reflectionCubemap);
 
         if (m_skyboxMaterial->m_skyboxIndirectLighting)
@@ -722,27 +723,84 @@ namespace Lina::Graphics
             m_gBufferLightPassMaterial.SetTexture(MAT_MAP_SKYBOXIRR, &m_skyboxIrradianceCubemap);
             m_gBufferLightPassMaterial.SetFloat(MAT_SKYBOXIRRFACTOR, m_skyboxMaterial->m_skyboxIndirectContributionFactor);
         }
-        
+
         UpdateShaderData(&m_gBufferLightPassMaterial, true);
         m_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
     }
 
+    void OpenGLRenderEngine::DrawBloom()
+    {
+        // 2 pass gaussian blur over the emission, ends on pong.
+        Texture*     source     = GetFrameGraphTexture(m_fgGBuffer[3]);
+        bool         horizontal = true;
+        unsigned int amount     = 10;
+
+        m_renderDevice.SetViewport(Vector2::Zero, m_screenSize);
+
+        for (unsigned int i = 0; i < amount; i++)
+        {
+            const int target = horizontal ? 0 : 1;
+            m_renderDevice.SetFBO(m_bloomTargets[target]->GetID());
+
+            m_screenQuadBlurMaterial.SetBool(MAT_ISHORIZONTAL, horizontal);
+            m_screenQuadBlurMaterial.SetTexture(MAT_MAP_SCREEN, source);
+
+            UpdateShaderData(&m_screenQuadBlurMaterial);
+            m_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
+
+            source     = GetFrameGraphTexture(m_fgBloom[target]);
+            horizontal = !horizontal;
+        }
+    }
+
+    void OpenGLRenderEngine::DrawComposite()
+    {
+        // Draw the final image either to the screen, or to a secondary frame buffer to display it in editor.
+        if (m_frameOutputOverride != nullptr)
+            m_renderDevice.SetFBO(m_frameOutputOverride->GetID());
+        else if (m_appMode == ApplicationMode::Editor)
+            m_renderDevice.SetFBO(m_secondaryRenderTarget.GetID());
+        else
+            // Back to default buffer
+            m_renderDevice.SetFBO(0);
+
+        m_renderDevice.SetViewport(m_screenPos, m_screenSize);
+        m_renderDevice.Clear(true, true, true, Color::White, 0xFF);
+
+        // Tone mapping, gamma, exposure, FXAA & vignette come from the render settings.
+        m_screenQuadFinalMaterial.SetTexture(MAT_MAP_SCREEN, GetFrameGraphTexture(m_fgSceneColor), TextureBindMode::BINDTEXTURE_TEXTURE2D);
+        m_screenQuadFinalMaterial.SetBool(MAT_BLOOMENABLED, m_frameGraphBloom);
+
+        if (m_frameGraphBloom)
+            m_screenQuadFinalMaterial.SetTexture(MAT_MAP_BLOOM, GetFrameGraphTexture(m_fgBloom[1]), TextureBindMode::BINDTEXTURE_TEXTURE2D);
+        else
+            m_screenQuadFinalMaterial.RemoveTexture(MAT_MAP_BLOOM);
+
+        Vector2 inverseMapSize = 1.0f / Vector2((float)m_screenSize.x, (float)m_screenSize.y);
+        m_screenQuadFinalMaterial.SetVector3(MAT_INVERSESCREENMAPSIZE, Vector3(inverseMapSize.x, inverseMapSize.y, 0.0));
+
+        UpdateShaderData(&m_screenQuadFinalMaterial);
+        m_renderDevice.Draw(m_screenQuadVAO, m_fullscreenQuadDP, 0, 6, true);
+    }
+
     uint32 OpenGLRenderEngine::RenderModelPreview(Model* model, Matrix& modelMatrix, RenderTarget* overrideTarget, Material* overrideMaterial)
     {
         // Store the current skybox & switch to HDRI one
         Material* currentSkybox = m_skyboxMaterial;
         SetSkyboxMaterial(m_defaultSkyboxHDRI);
 
-        // Update systems & prepare
-        UpdateSystems(0.0f);
-        m_renderDevice.SetFBO(m_primaryMSAATarget.GetID());
-        m_renderDevice.SetViewport(Vector2::Zero, m_screenSize);
-        m_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
-
-        // Draw skybox and given model.
-        // DrawSkybox();
-        m_modelNodeSystem.FlushModelNode(model->m_rootNode, modelMatrix, m_defaultDrawParams, overrideMaterial);
-        DrawFinalize(overrideTarget == nullptr ? &m_previewRenderTarget : overrideTarget);
+        // Only the model is drawn, so the scene isn't culled again. Extraction is shared with the main view if it was
+        // already done this frame.
+        ExtractScene();
+        UpdateUniformBuffers();
+        m_previewModel        = model;
+        m_previewMatrix       = modelMatrix;
+        m_previewMaterial     = overrideMaterial;
+        m_frameOutputOverride = overrideTarget == nullptr ? &m_previewRenderTarget : overrideTarget;
+        m_frameGraph.Execute();
+        m_previewModel        = nullptr;
+        m_previewMaterial     = nullptr;
+        m_frameOutputOverride = nullptr;
 
         // Reset buffers back as well as the skybox.
         m_renderDevice.SetFBO(0);
@@ -754,39 +812,70 @@ namespace Lina::Graphics
 
     void OpenGLRenderEngine::DrawIcon(Vector3 position, StringIDType textureID, float size)
     {
-        m_debugIconQueue.push(DebugIcon{position, textureID, size});
+        m_debugDrawBatcher.AddIcon(position, textureID, size);
     }
 
     void OpenGLRenderEngine::DrawLine(Vector3 p1, Vector3 p2, Color col, float width)
     {
-        m_debugLineQueue.push(DebugLine{p1, p2, col, width});
+        m_debugDrawBatcher.AddLine(p1, p2, col);
+    }
+
+    void OpenGLRenderEngine::DrawFrustum(const Matrix& viewProjection, Color col)
+    {
+        m_debugDrawBatcher.AddFrustum(viewProjection, col);
     }
 
     void OpenGLRenderEngine::ProcessDebugQueue()
     {
-        while (!m_debugLineQueue.empty())
+        // Lines, one upload & one draw per depth mode.
+        const uint32 lineShader    = m_debugLineMaterial.m_shaderHandle.m_value->GetID();
+        DrawParams   overlayParams = m_defaultDrawParams;
+        overlayParams.useDepthTest = false;
+
+        for (int i = 0; i < DEBUG_DEPTH_MODES; i++)
         {
-            DebugLine line = m_debugLineQueue.front();
-            m_renderDevice.SetShader(m_debugLineMaterial.m_shaderHandle.m_value->GetID());
-            m_renderDevice.UpdateShaderUniformColor(m_debugLineMaterial.m_shaderHandle.m_value->GetID(), MAT_COLOR, line.m_color);
-            m_renderDevice.DrawLine(m_debugLineMaterial.m_shaderHandle.m_value->GetID(), Matrix::Identity(), line.m_from, line.m_to, line.m_width);
-            m_debugLineQueue.pop();
+            const DebugDepthMode            mode     = static_cast<DebugDepthMode>(i);
+            const std::vector<DebugVertex>& vertices = m_debugDrawBatcher.GetLineVertices(mode);
+
+            if (vertices.empty())
+                continue;
+
+            m_renderDevice.SetShader(lineShader);
+            m_renderDevice.SetDrawParameters(mode == DebugDepthMode::DepthTested ? m_defaultDrawParams : overlayParams);
+            m_renderDevice.UpdateVertexArrayBuffer(m_debugLineVAO, 0, vertices.data(), vertices.size() * sizeof(DebugVertex));
+            m_renderDevice.DrawLines(m_debugLineVAO, (uint32)vertices.size(), m_debugDrawBatcher.GetLineWidth());
+            m_debugDrawBatcher.AddDrawCall();
         }
 
-        while (!m_debugIconQueue.empty())
+        // Icons, instanced per texture.
+        m_debugDrawBatcher.SortIcons();
+        const std::vector<DebugIcon>& icons     = m_debugDrawBatcher.GetIcons();
+        const Vector3                 cameraLoc = m_cameraSystem.GetCameraLocation();
+
+        for (size_t start = 0; start < icons.size();)
         {
-            DebugIcon      icon = m_debugIconQueue.front();
-            Transformation tr;
-            tr.m_location = icon.m_center;
-            tr.m_scale    = Vector3(icon.m_size);
-            tr.m_rotation = Quaternion::LookAt(icon.m_center, m_cameraSystem.GetCameraLocation(), Vector3::Up);
-            Matrix model  = tr.ToMatrix();
-            m_quadMesh.GetVertexArray().UpdateBuffer(2, &model, 1 * sizeof(Matrix));
-            m_debugIconMaterial.SetTexture(MAT_TEXTURE2D_DIFFUSE, m_storage->GetResource<Texture>(icon.m_textureID));
+            const StringIDType textureID = icons[start].m_textureID;
+            size_t             end       = start;
+            m_debugIconMatrices.clear();
+
+            for (; end < icons.size() && icons[end].m_textureID == textureID; end++)
+            {
+                Transformation tr;
+                tr.m_location = icons[end].m_center;
+                tr.m_scale    = Vector3(icons[end].m_size);
+                tr.m_rotation = Quaternion::LookAt(icons[end].m_center, cameraLoc, Vector3::Up);
+                m_debugIconMatrices.push_back(tr.ToMatrix());
+            }
+
+            m_quadMesh.GetVertexArray().UpdateBuffer(2, m_debugIconMatrices.data(), m_debugIconMatrices.size() * sizeof(Matrix));
+            m_debugIconMaterial.SetTexture(MAT_TEXTURE2D_DIFFUSE, m_storage->GetResource<Texture>(textureID));
             UpdateShaderData(&m_debugIconMaterial);
-            m_renderDevice.Draw(m_quadMesh.GetVertexArray().GetID(), m_defaultDrawParams, 1, m_quadMesh.GetVertexArray().GetIndexCount(), false);
-            m_debugIconQueue.pop();
+            m_renderDevice.Draw(m_quadMesh.GetVertexArray().GetID(), m_defaultDrawParams, (uint32)m_debugIconMatrices.size(), m_quadMesh.GetVertexArray().GetIndexCount(), false);
+            m_debugDrawBatcher.AddDrawCall();
+            start = end;
         }
+
+        m_debugDrawBatcher.Clear();
     }
 
     void OpenGLRenderEngine::SetDrawParameters(const DrawParams& params)
@@ -828,6 +917,7 @@ namespace Lina::Graphics
 
     void OpenGLRenderEngine::DrawSceneObjects(DrawParams& drawParams, Material* overrideMaterial, bool completeFlush)
     {
+        m_staticBatchSystem.Flush(drawParams, overrideMaterial);
         m_modelNodeSystem.FlushOpaque(drawParams, overrideMaterial, completeFlush);
         m_modelNodeSystem.FlushTransparent(drawParams, overrideMaterial, completeFlush);
         m_spriteRendererSystem.Flush(drawParams, overrideMaterial, completeFlush);
@@ -974,6 +1064,12 @@ namespace Lina::Graphics
     }
 
     void OpenGLRenderEngine::CaptureReflections(Texture& writeTexture, const Vector3& areaLocation, const Vector2i& resolution)
+    {
+        for (uint32 i = 0; i < 6; ++i)
+            CaptureReflectionFace(writeTexture, areaLocation, resolution, i);
+    }
+
+    void OpenGLRenderEngine::CaptureReflectionFace(Texture& writeTexture, const Vector3& areaLocation, const Vector2i& resolution, uint32 face)
     {
         // Build projection & view matrices for capturing HDRI data.
         Matrix captureProjection = Matrix::PerspectiveRH(90.0f, 1.0f, 0.1f, 10.0f);
@@ -986,23 +1082,27 @@ namespace Lina::Graphics
         m_renderDevice.SetShader(skyboxMaterialShader->GetID());
         m_renderDevice.SetFBO(m_reflectionCaptureRenderTarget.GetID());
         m_renderDevice.SetViewport(Vector2::Zero, resolution);
-        m_renderDevice.ResizeRenderBuffer(m_reflectionCaptureRenderTarget.GetID(), m_reflectionCaptureRenderBuffer.GetID(), resolution, RenderBufferStorage::STORAGE_DEPTH_COMP24);
-        m_cameraSystem.InjectProjMatrix(captureProjection);
 
-        // Draw the cubemap.
-        for (uint32 i = 0; i < 6; ++i)
+        // Only re-allocate the depth storage if the resolution actually changed since the last capture.
+        if (m_reflectionCaptureResolution != resolution)
         {
-            m_cameraSystem.InjectViewMatrix(captureViews[i]);
-            m_renderDevice.BindTextureToRenderTarget(m_reflectionCaptureRenderTarget.GetID(), writeTexture.GetID(), TextureBindMode::BINDTEXTURE_CUBEMAP_POSITIVE_X, FrameBufferAttachment::ATTACHMENT_COLOR, 0, i, 0, false);
-            m_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
+            m_renderDevice.ResizeRenderBuffer(m_reflectionCaptureRenderTarget.GetID(), m_reflectionCaptureRenderBuffer.GetID(), resolution, RenderBufferStorage::STORAGE_DEPTH_COMP24);
+            m_reflectionCaptureResolution = resolution;
+        }
 
-            // Draw whole scene
-            DrawSkybox();
-            DrawSceneObjects(m_defaultDrawParams);
+        m_cameraSystem.InjectProjMatrix(captureProjection);
+        m_cameraSystem.InjectViewMatrix(captureViews[face]);
+        m_renderDevice.BindTextureToRenderTarget(m_reflectionCaptureRenderTarget.GetID(), writeTexture.GetID(), TextureBindMode::BINDTEXTURE_CUBEMAP_POSITIVE_X, FrameBufferAttachment::ATTACHMENT_COLOR, 0, face, 0, false);
+        m_renderDevice.Clear(true, true, true, m_cameraSystem.GetCurrentClearColor(), 0xFF);
 
-            // m_renderDevice.Draw(m_hdriCubeVAO, m_defaultDrawParams, 0, 36, true);
-            // m_renderDevice.Draw(m_skyboxVAO, m_skyboxDrawParams, 1, 4, true);
-        }
+        // Draw whole scene, culled & sorted for this face instead of the camera.
+        Frustum faceFrustum;
+        faceFrustum.Calculate(captureProjection * captureViews[face], false);
+        CullView(faceFrustum, areaLocation);
+
+        DrawSkybox();
+        DrawSceneObjects(m_defaultDrawParams);
+        RestoreCameraView();
 
         // Get back to gBuffer
         m_renderDevice.SetFBO(m_gBuffer.GetID());
@@ -1043,7 +1143,7 @@ namespace Lina::Graphics
         }
 
         // Get back to gBuffer
-        m_renderDevice.BindTextureToRenderTarget(m_gBuffer.GetID(), m_gBufferAlbedo.GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 2, 0, 0, false, false);
+        m_renderDevice.BindTextureToRenderTarget(m_gBuffer.GetID(), GetFrameGraphTexture(m_fgGBuffer[2])->GetID(), TextureBindMode::BINDTEXTURE_TEXTURE2D, FrameBufferAttachment::ATTACHMENT_COLOR, 2, 0, 0, false, false);
         m_cameraSystem.SetProjectionMatrix(currentProjection);
         m_cameraSystem.SetViewMatrix(currentView);
         m_renderDevice.GenerateTextureMipmaps(m_skyboxIrradianceCubemap.GetID(), TextureBindMode::BINDTEXTURE_CUBEMAP);
@@ -1270,7 +1370,7 @@ namespace Lina::Graphics
         if (m_appMode == ApplicationMode::Editor)
             return m_secondaryRTTexture.GetID();
         else
-            return m_primaryRTTexture0.GetID();
+            return GetFrameGraphTexture(m_fgSceneColor)->GetID();
     }
 
     uint32 OpenGLRenderEngine::GetShadowMapImage()
@@ -1278,13 +1378,36 @@ namespace Lina::Graphics
         return m_shadowMapRTTexture.GetID();
     }
 
-    void OpenGLRenderEngine::UpdateSystems(float delta)
+    void OpenGLRenderEngine::ExtractScene()
     {
-        // Update pipeline.
-        m_renderingPipeline.UpdateSystems(delta);
+        // Proxies, bounds, batches, sprites & lights don't depend on the view.
+        m_renderingPipeline.UpdateSystemsOnce(m_frame, 0.0f);
+    }
+
+    void OpenGLRenderEngine::UpdateView()
+    {
+        // Camera, culling & reflection capture scheduling, then the lists culled for this view.
+        m_viewPipeline.UpdateSystems(0.0f);
+        m_staticBatchSystem.UpdateVisibility();
+        m_modelNodeSystem.UpdateVisibleLists();
 
         // Update uniform buffers on GPU
         UpdateUniformBuffers();
     }
 
+    void OpenGLRenderEngine::CullView(const Frustum& frustum, const Vector3& location)
+    {
+        // Additional views only cull & sort, proxies are synced once for all views during extraction.
+        m_frustumSystem.CullView(frustum);
+        m_staticBatchSystem.UpdateVisibility(frustum);
+        m_modelNodeSystem.UpdateVisibleLists(location);
+    }
+
+    void OpenGLRenderEngine::RestoreCameraView()
+    {
+        m_frustumSystem.RestoreCameraVisibility();
+        m_staticBatchSystem.UpdateVisibility();
+        m_modelNodeSystem.UpdateVisibleLists();
+    }
+
 } // namespace Lina::Graphics
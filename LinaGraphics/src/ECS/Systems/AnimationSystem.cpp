@@ -28,18 +28,126 @@ SOFTWARE.
 
 #include "ECS/Systems/AnimationSystem.hpp"
 
+#include "Animation/Animation.hpp"
+#include "Core/RenderDeviceBackend.hpp"
+#include "Core/RenderEngineBackend.hpp"
 #include "ECS/Components/AnimationComponent.hpp"
-#include "ECS/Components/MeshRendererComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
+#include "ECS/Registry.hpp"
+#include "JobSystem/JobSystem.hpp"
 #include "Rendering/Model.hpp"
-#include "..\..\..\include\ECS\Systems\AnimationSystem.hpp"
+
+#include <cmath>
 
 namespace Lina::ECS
 {
     void AnimationSystem::Initialize(const std::string& name)
     {
         System::Initialize(name);
+        m_renderDevice = Graphics::RenderEngineBackend::Get()->GetRenderDevice();
     }
+
     void AnimationSystem::UpdateComponents(float delta)
     {
+        auto* ecs  = ECS::Registry::Get();
+        auto  view = ecs->view<ModelNodeComponent, AnimationComponent>();
+        m_frame++;
+        m_activeInstances.clear();
+
+        for (auto entity : view)
+        {
+            ModelNodeComponent& nodeComponent = view.get<ModelNodeComponent>(entity);
+            AnimationComponent& animComponent = view.get<AnimationComponent>(entity);
+
+            if (!nodeComponent.GetIsEnabled() || !animComponent.GetIsEnabled())
+                continue;
+
+            Graphics::Model* model = nodeComponent.m_model.m_value;
+            if (model == nullptr || !model->GetSkeleton().IsLoaded())
+                continue;
+
+            if (nodeComponent.m_nodeIndex < 0 || nodeComponent.m_nodeIndex >= (int)model->GetAllNodes().size())
+                continue;
+
+            // Advance the playback on the component, so that the time is visible & editable outside.
+            const Graphics::Animation* animation = model->GetSkeleton().GetAnimation(animComponent.m_animationName);
+
+            if (animation != nullptr && animation->GetDuration() > 0.0f)
+            {
+                const float duration = animation->GetDuration();
+                animComponent.m_time += delta * animComponent.m_speed;
+
+                if (animComponent.m_loop)
+                {
+                    animComponent.m_time = std::fmod(animComponent.m_time, duration);
+                    if (animComponent.m_time < 0.0f)
+                        animComponent.m_time += duration;
+                }
+                else
+                    animComponent.m_time = animComponent.m_time < 0.0f ? 0.0f : (animComponent.m_time > duration ? duration : animComponent.m_time);
+            }
+
+            AnimationInstance& instance = m_instances[entity];
+
+            // Palette is relative to the node, as its skinned meshes are drawn with the entity's transformation.
+            if (instance.m_model != model || instance.m_nodeIndex != nodeComponent.m_nodeIndex)
+            {
+                instance.m_model         = model;
+                instance.m_nodeIndex     = nodeComponent.m_nodeIndex;
+                instance.m_rootTransform = model->GetAllNodes()[nodeComponent.m_nodeIndex]->GetGlobalTransform().Inverse();
+            }
+
+            instance.m_animation     = animation;
+            instance.m_time          = animComponent.m_time;
+            instance.m_lastSeenFrame = m_frame;
+            m_activeInstances.push_back(&instance);
+        }
+
+        m_poolSize = (int)m_activeInstances.size();
+
+        // Instances don't share any mutable data, each worker evaluates its own range of skeletons.
+        if (!m_activeInstances.empty())
+        {
+            ParallelFor(GetSharedExecutor(), (uint32)m_activeInstances.size(), 8, 0, [this](uint32 begin, uint32 end) {
+                for (uint32 i = begin; i < end; i++)
+                {
+                    AnimationInstance* instance = m_activeInstances[i];
+                    instance->m_model->GetSkeleton().Evaluate(instance->m_animation, instance->m_time, instance->m_rootTransform, instance->m_pose);
+                }
+            });
+        }
+
+        // GL calls need to happen on the main thread.
+        for (AnimationInstance* instance : m_activeInstances)
+            UploadPalette(*instance);
+
+        for (auto it = m_instances.begin(); it != m_instances.end();)
+        {
+            if (it->second.m_lastSeenFrame != m_frame)
+            {
+                if (it->second.m_paletteBuffer != 0)
+                    m_renderDevice->ReleaseUniformBuffer(it->second.m_paletteBuffer);
+
+                it = m_instances.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    void AnimationSystem::UploadPalette(AnimationInstance& instance)
+    {
+        if (instance.m_paletteBuffer == 0)
+            instance.m_paletteBuffer = m_renderDevice->CreateUniformBuffer(nullptr, sizeof(Matrix) * MAX_BONES, Graphics::BufferUsage::USAGE_DYNAMIC_DRAW);
+
+        const size_t jointCount = instance.m_pose.m_palette.size() < MAX_BONES ? instance.m_pose.m_palette.size() : MAX_BONES;
+        if (jointCount > 0)
+            m_renderDevice->UpdateUniformBuffer(instance.m_paletteBuffer, instance.m_pose.m_palette.data(), 0, jointCount * sizeof(Matrix));
+    }
+
+    uint32 AnimationSystem::GetPaletteBuffer(Entity entity) const
+    {
+        auto it = m_instances.find(entity);
+        return it == m_instances.end() ? 0 : it->second.m_paletteBuffer;
     }
 } // namespace Lina::ECS
@@ -31,6 +31,7 @@ SOFTWARE.
 #include "ECS/Components/EntityDataComponent.hpp"
 #include "ECS/Components/SpriteRendererComponent.hpp"
 #include "ECS/Components/ModelNodeComponent.hpp"
+#include "ECS/Components/OccluderComponent.hpp"
 #include "ECS/Registry.hpp"
 #include "Rendering/Mesh.hpp"
 #include "Math/Vector.hpp"
@@ -38,8 +39,8 @@ SOFTWARE.
 #include "EventSystem/GraphicsEvents.hpp"
 #include "Core/RenderEngineBackend.hpp"
 #include "ECS/Systems/CameraSystem.hpp"
+#include "ECS/Systems/SpatialIndexSystem.hpp"
 #include "ECS/Components/CameraComponent.hpp"
-#include "ECS/Components/ModelNodeComponent.hpp"
 
 namespace Lina::ECS
 {
@@ -51,40 +52,92 @@ namespace Lina::ECS
 
     void FrustumSystem::UpdateComponents(float delta)
     {
-        auto* ecs       = ECS::Registry::Get();
-        auto& view      = ecs->view<EntityDataComponent, ModelNodeComponent>();
-        auto* camSystem = m_renderEngine->GetCameraSystem();
-        m_poolSize      = 0;
+        auto*               camComponent = m_renderEngine->GetCameraSystem()->GetActiveCameraComponent();
+        SpatialIndexSystem* spatialIndex = m_renderEngine->GetSpatialIndexSystem();
+
+        // Without an active camera there is nothing to cull against.
+        if (camComponent == nullptr)
+        {
+            m_poolSize = 0;
+            m_viewCuller.Clear();
+            m_viewCuller.CommitCamera();
+            return;
+        }
+
+        uint32 visibleMeshes = CullFrustum(camComponent->m_viewFrustum);
+
+        if (m_occlusionCullingEnabled)
+            CullOccluded(visibleMeshes);
+
+        // Kept to restore after additional views are culled.
+        m_viewCuller.CommitCamera();
+
+        // Number of culled meshes.
+        m_poolSize = (int)(spatialIndex->GetTotalMeshCount() - visibleMeshes);
+    }
+
+    void FrustumSystem::CullView(const Frustum& frustum)
+    {
+        CullFrustum(frustum);
+        m_viewCuller.CommitView();
+    }
 
+    void FrustumSystem::RestoreCameraVisibility()
+    {
+        m_viewCuller.RestoreCamera();
+    }
+
+    uint32 FrustumSystem::CullFrustum(const Frustum& frustum)
+    {
+        SpatialIndexSystem* spatialIndex = m_renderEngine->GetSpatialIndexSystem();
+        return m_viewCuller.Cull(frustum, spatialIndex->GetTree(), spatialIndex->GetProxies(), spatialIndex->GetEntityCapacity());
+    }
+
+    void FrustumSystem::CullOccluded(uint32& visibleMeshes)
+    {
+        auto*               ecs          = ECS::Registry::Get();
+        auto*               cameraSystem = m_renderEngine->GetCameraSystem();
+        SpatialIndexSystem* spatialIndex = m_renderEngine->GetSpatialIndexSystem();
+        auto                view         = ecs->view<EntityDataComponent, ModelNodeComponent, OccluderComponent>();
+
+        m_occlusionCuller.BeginFrame(cameraSystem->GetProjectionMatrix() * cameraSystem->GetViewMatrix());
+
+        // Only occluders that passed the frustum test are rasterized.
         for (auto entity : view)
         {
-            ModelNodeComponent&  nodeComp = view.get<ModelNodeComponent>(entity);
+            OccluderComponent&   occluder = view.get<OccluderComponent>(entity);
+            ModelNodeComponent&  node     = view.get<ModelNodeComponent>(entity);
             EntityDataComponent& data     = view.get<EntityDataComponent>(entity);
-            Graphics::Model*     model    = nodeComp.m_model.m_value;
 
-            if (model == nullptr)
+            if (!occluder.GetIsEnabled() || !node.GetIsEnabled() || !data.GetIsEnabled() || !IsVisible(entity))
                 continue;
 
-            Graphics::ModelNode* node = model->GetAllNodes()[nodeComp.m_nodeIndex];
+            Graphics::Model* model = node.m_model.m_value;
 
-            auto* camComponent = camSystem->GetActiveCameraComponent();
+            if (model == nullptr || model->GetAllNodes()[node.m_nodeIndex] == nullptr)
+                continue;
+
+            const Matrix modelMatrix = data.ToMatrix();
+
+            for (auto* mesh : model->GetAllNodes()[node.m_nodeIndex]->GetMeshes())
+                m_occlusionCuller.AddOccluder(modelMatrix, mesh->GetOccluderVertices(), mesh->GetOccluderIndices());
+        }
 
-            bool nodeWithinFrustum = false;
+        if (!m_occlusionCuller.HasOccluders())
+            return;
 
-            Vector3 position   = Vector3::Zero;
-            Vector3 halfExtent = Vector3::Zero;
-            GetAABBInModelNode(node, position, halfExtent, data.GetLocation(), data.GetRotation(), data.GetScale());
-            AABB nodeAABB;
-            nodeAABB.m_boundsHalfExtents = halfExtent;
-            nodeAABB.m_boundsMin         = position - halfExtent;
-            nodeAABB.m_boundsMax         = position + halfExtent;
+        m_occlusionCuller.RasterizeOccluders();
 
-            FrustumTest test = camComponent->m_viewFrustum.TestIntersection(nodeAABB);
+        for (int proxyID : m_viewCuller.GetVisibleProxies())
+        {
+            const SpatialProxy& proxy = spatialIndex->GetProxy(proxyID);
 
-            nodeComp.m_culled = test == FrustumTest::Outside;
+            // Occluders would only hide behind themselves.
+            if (ecs->all_of<OccluderComponent>(proxy.m_entity) || m_occlusionCuller.TestAABB(proxy.m_center, proxy.m_halfExtent))
+                continue;
 
-            if (nodeComp.m_culled)
-                m_poolSize += (int)node->GetMeshes().size();
+            m_viewCuller.Hide(proxy.m_entity);
+            visibleMeshes -= proxy.m_meshCount;
         }
     }
 
@@ -94,14 +147,14 @@ namespace Lina::ECS
         const Vector3 offsetAddition = rot.GetForward() * vertexOffset.z + rot.GetRight() * vertexOffset.x + rot.GetUp() * vertexOffset.y;
         outPosition                  = location + offsetAddition;
 
-        std::vector<Vector3> boundsPositions = node->GetAABB().m_positions;
+        const std::vector<Vector3>& boundsPositions = node->GetAABB().m_positions;
 
         Vector3 totalMax = Vector3(-1000, -1000, -1000);
         Vector3 totalMin = Vector3(1000, 1000, 1000);
 
-        for (auto& p : boundsPositions)
+        for (const auto& bp : boundsPositions)
         {
-            p = rot.GetRotated(p);
+            const Vector3 p = rot.GetRotated(bp);
 
             if (p.x > totalMax.x)
                 totalMax.x = p.x;
@@ -28,7 +28,6 @@ SOFTWARE.
 
 #include "ECS/Systems/ModelNodeSystem.hpp"
 
-#include "Animation/Skeleton.hpp"
 #include "Core/RenderDeviceBackend.hpp"
 #include "Core/RenderEngineBackend.hpp"
 #include "ECS/Components/EntityDataComponent.hpp"
@@ -36,11 +35,14 @@ SOFTWARE.
 #include "ECS/Components/ModelRendererComponent.hpp"
 #include "ECS/Registry.hpp"
 #include "EventSystem/EventSystem.hpp"
+#include "EventSystem/LevelEvents.hpp"
 #include "Rendering/Material.hpp"
 #include "Rendering/Model.hpp"
 #include "Rendering/RenderConstants.hpp"
 #include "Utility/UtilityFunctions.hpp"
 
+#include <algorithm>
+
 namespace Lina::ECS
 {
     void ModelNodeSystem::Initialize(const std::string& name, ApplicationMode appMode)
@@ -49,6 +51,12 @@ namespace Lina::ECS
         m_appMode      = appMode;
         m_renderEngine = Graphics::RenderEngineBackend::Get();
         m_renderDevice = m_renderEngine->GetRenderDevice();
+
+        m_proxyCallbacks.m_isStaticBatched  = [this](Entity entity) { return m_renderEngine->GetStaticBatchSystem()->IsBatched(entity); };
+        m_proxyCallbacks.m_getPaletteBuffer = [this](Entity entity) { return m_renderEngine->GetAnimationSystem()->GetPaletteBuffer(entity); };
+
+        Event::EventSystem::Get()->Connect<Event::ELevelInstalled, &ModelNodeSystem::OnLevelInstalled>(this);
+        Event::EventSystem::Get()->Connect<Event::ELevelUninstalled, &ModelNodeSystem::OnLevelUninstalled>(this);
     }
 
     void ModelNodeSystem::ConstructEntityHierarchy(Entity entity, Matrix& parentTransform, Graphics::Model* model, Graphics::ModelNode* node)
@@ -117,90 +125,112 @@ namespace Lina::ECS
         ConstructEntityHierarchy(parentEntity, data.ToMatrix(), model, root);
     }
 
-    static float t = 0.0f;
+    void ModelNodeSystem::OnLevelInstalled(const Event::ELevelInstalled& ev)
+    {
+        auto* ecs = ECS::Registry::Get();
+        ecs->on_construct<ModelNodeComponent>().connect<&ModelNodeSystem::OnModelNodeAdded>(this);
+        ecs->on_destroy<ModelNodeComponent>().connect<&ModelNodeSystem::OnModelNodeRemoved>(this);
+
+        // Components that were created before the level was installed didn't go through the signal.
+        for (auto entity : ecs->view<ModelNodeComponent>())
+            m_proxyTable.MarkForRebuild(entity);
+    }
 
-    void ModelNodeSystem::UpdateComponents(float delta)
+    void ModelNodeSystem::OnLevelUninstalled(const Event::ELevelUninstalled& ev)
     {
-        auto* ecs  = ECS::Registry::Get();
-        auto  view = ecs->view<EntityDataComponent, ModelNodeComponent>();
-        m_poolSize = 0;
+        auto* ecs = ECS::Registry::Get();
+        ecs->on_construct<ModelNodeComponent>().disconnect(this);
+        ecs->on_destroy<ModelNodeComponent>().disconnect(this);
 
-        for (auto entity : view)
-        {
-            ModelNodeComponent& nodeComponent = view.get<ModelNodeComponent>(entity);
-            auto&               data          = view.get<EntityDataComponent>(entity);
+        m_proxyTable.Clear();
+        m_transparentOrder.clear();
+    }
 
-            if (!nodeComponent.GetIsEnabled() || !data.GetIsEnabled() || nodeComponent.m_culled)
-                continue;
+    void ModelNodeSystem::OnModelNodeAdded(entt::registry& reg, entt::entity ent)
+    {
+        // Component is usually filled after it's added, the proxy is built during the next update.
+        m_proxyTable.MarkForRebuild(ent);
+    }
 
-            auto* model = nodeComponent.m_model.m_value;
-            if (model == nullptr)
-                continue;
+    void ModelNodeSystem::OnModelNodeRemoved(entt::registry& reg, entt::entity ent)
+    {
+        m_proxyTable.Remove(ent);
+    }
 
-            auto* node = model->GetAllNodes()[nodeComponent.m_nodeIndex];
-            if (node == nullptr)
-                continue;
+    void ModelNodeSystem::InvalidateProxy(Entity entity)
+    {
+        m_proxyTable.Invalidate(entity);
+    }
 
-            auto& meshes = node->GetMeshes();
+    void ModelNodeSystem::UpdateComponents(float delta)
+    {
+        m_proxyTable.Sync(*ECS::Registry::Get(), m_extractor, m_proxyCallbacks);
+    }
 
-            const Matrix finalMatrix = data.ToMatrix();
+    void ModelNodeSystem::UpdateVisibleLists()
+    {
+        UpdateVisibleLists(m_renderEngine->GetCameraSystem()->GetCameraLocation());
+    }
 
-            for (uint32 i = 0; i < meshes.size(); i++)
+    void ModelNodeSystem::UpdateVisibleLists(const Vector3& viewLocation)
+    {
+        auto*        frustumSystem     = m_renderEngine->GetFrustumSystem();
+        auto&        opaqueBatches     = m_proxyTable.GetOpaqueBatches();
+        auto&        transparents      = m_proxyTable.GetTransparentInstances();
+        const uint32 visibilityVersion = frustumSystem->GetVisibilityVersion();
+        const bool   visibilityChanged = visibilityVersion != m_visibilityVersion;
+        m_visibilityVersion            = visibilityVersion;
+        m_poolSize                     = 0;
+
+        // Visible lists are kept as long as neither the batch nor the visibility changes, batches are independent.
+        m_extractor.ForEachSlice((uint32)opaqueBatches.size(), 1, [&](uint32 begin, uint32 end) {
+            for (uint32 b = begin; b < end; b++)
             {
-                auto*  mesh         = meshes[i];
-                uint32 materialSlot = mesh->GetMaterialSlotIndex();
+                Graphics::RenderBatch& batch = opaqueBatches[b];
 
-                // Check if material exists.
-                const StringIDType materialSID = nodeComponent.m_materials[i].m_sid;
-                if (!Resources::ResourceStorage::Get()->Exists<Graphics::Material>(materialSID))
+                if (!batch.m_isDirty && !visibilityChanged)
                     continue;
 
-                m_poolSize++;
+                batch.m_visibleModels.clear();
 
-                // Render the material & vertex array.
-                Graphics::Material* mat = nodeComponent.m_materials[i].m_value;
-
-                if (mat->GetSurfaceType() == Graphics::MaterialSurfaceType::Opaque)
-                    RenderOpaque(mesh->GetVertexArray(), Graphics::Skeleton(), mat, finalMatrix);
-                else
+                for (uint32 i = 0; i < (uint32)batch.m_models.size(); i++)
                 {
-                    float priority = (m_renderEngine->GetCameraSystem()->GetCameraLocation() - data.GetLocation()).MagnitudeSqrt();
-                    RenderTransparent(mesh->GetVertexArray(), Graphics::Skeleton(), mat, finalMatrix, priority);
+                    if (frustumSystem->IsVisible(batch.m_owners[i].m_entity))
+                        batch.m_visibleModels.push_back(batch.m_models[i]);
                 }
+
+                batch.m_isDirty = false;
             }
-        }
-    }
+        });
 
-    void ModelNodeSystem::RenderOpaque(Graphics::VertexArray& vertexArray, Graphics::Skeleton& skeleton, Graphics::Material* material, const Matrix& transformIn)
-    {
-        // Render commands basically add the necessary
-        // draw data into the maps/lists etc.
-        Graphics::BatchDrawData drawData;
-        drawData.m_vertexArray = &vertexArray;
-        drawData.m_material    = material;
-        m_opaqueRenderBatch[drawData].m_models.push_back(transformIn);
-
-        if (skeleton.IsLoaded())
+        for (auto& batch : opaqueBatches)
+            m_poolSize += (int)batch.m_visibleModels.size();
+
+        // Transparent objects are drawn back to front, so the order also depends on the view.
+        if (m_proxyTable.IsTransparentDirty() || visibilityChanged || viewLocation != m_lastViewLocation)
         {
-        }
-    }
+            m_transparentOrder.clear();
 
-    void ModelNodeSystem::RenderTransparent(Graphics::VertexArray& vertexArray, Graphics::Skeleton& skeleton, Graphics::Material* material, const Matrix& transformIn, float priority)
-    {
-        // Render commands basically add the necessary
-        // draw data into the maps/lists etc.
-        Graphics::BatchDrawData drawData;
-        drawData.m_vertexArray = &vertexArray;
-        drawData.m_material    = material;
-        drawData.m_distance    = priority;
+            for (uint32 i = 0; i < (uint32)transparents.size(); i++)
+            {
+                Graphics::TransparentInstance& instance = transparents[i];
 
-        Graphics::BatchModelData modelData;
-        modelData.m_models.push_back(transformIn);
+                if (!frustumSystem->IsVisible(instance.m_owner.m_entity))
+                    continue;
 
-        if (skeleton.IsLoaded())
-        {
+                instance.m_drawData.m_distance = (viewLocation - instance.m_location).MagnitudeSqrt();
+                m_transparentOrder.push_back(i);
+            }
 
+            std::sort(m_transparentOrder.begin(), m_transparentOrder.end(), [&transparents](uint32 a, uint32 b) {
+                return transparents[a].m_drawData.m_distance > transparents[b].m_drawData.m_distance;
+            });
+
+            m_lastViewLocation = viewLocation;
+            m_proxyTable.ClearTransparentDirty();
         }
+
+        m_poolSize += (int)m_transparentOrder.size();
     }
 
     void ModelNodeSystem::FlushModelNode(Graphics::ModelNode* node, Matrix& parentMatrix, Graphics::DrawParams& params, Graphics::Material* overrideMaterial)
@@ -228,20 +258,16 @@ namespace Lina::ECS
 
     void ModelNodeSystem::FlushOpaque(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
     {
-        // When flushed, all the data is delegated to the render device to do the actual
-        // drawing. Then the data is cleared if complete flush is requested.
-
-        for (std::map<Graphics::BatchDrawData, Graphics::BatchModelData>::iterator it = m_opaqueRenderBatch.begin(); it != m_opaqueRenderBatch.end(); ++it)
+        // When flushed, all the data is delegated to the render device to do the actual drawing.
+        for (auto& batch : m_proxyTable.GetOpaqueBatches())
         {
-            // Get references.
-            Graphics::BatchDrawData   drawData      = it->first;
-            Graphics::BatchModelData& modelData     = it->second;
-            size_t                    numTransforms = modelData.m_models.size();
+            size_t numTransforms = batch.m_visibleModels.size();
             if (numTransforms == 0)
                 continue;
 
-            Graphics::VertexArray* vertexArray = drawData.m_vertexArray;
-            Matrix*                models      = &modelData.m_models[0];
+            const Graphics::BatchDrawData& drawData    = batch.m_drawData;
+            Graphics::VertexArray*         vertexArray = drawData.m_vertexArray;
+            Matrix*                        models      = &batch.m_visibleModels[0];
 
             // Get the material for drawing, object's own material or overriden material.
             Graphics::Material* mat = overrideMaterial == nullptr ? drawData.m_material : overrideMaterial;
@@ -251,71 +277,40 @@ namespace Lina::ECS
             // Update the buffer w/ each transform.
             vertexArray->UpdateBuffer(7, models, numTransforms * sizeof(Matrix));
 
-            if (modelData.m_boneTransformations.size() == 0)
-                mat->SetBool(UF_BOOL_SKINNED, false);
-            else
-                mat->SetBool(UF_BOOL_SKINNED, true);
+            // Palette is uploaded by the animation system, only the buffer needs to be bound.
+            if (drawData.m_paletteBuffer != 0)
+                m_renderDevice->BindUniformBuffer(drawData.m_paletteBuffer, UF_BONEDATA_BINDPOINT);
 
-            for (int i = 0; i < modelData.m_boneTransformations.size(); i++)
-                mat->SetMatrix4(std::string(UF_BONE_MATRICES) + "[" + std::to_string(i) + "]", modelData.m_boneTransformations[i]);
+            mat->SetBool(UF_BOOL_SKINNED, drawData.m_paletteBuffer != 0);
 
             m_renderEngine->UpdateShaderData(mat);
 
             m_renderDevice->Draw(vertexArray->GetID(), drawParams, (uint32)numTransforms, vertexArray->GetIndexCount(), false);
-
-            // Clear the buffer.
-            if (completeFlush)
-            {
-                modelData.m_models.clear();
-                modelData.m_boneTransformations.clear();
-            }
         }
     }
 
     void ModelNodeSystem::FlushTransparent(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
     {
-        // When flushed, all the data is delegated to the render device to do the actual
-        // drawing. Then the data is cleared if complete flush is requested.
-
-        // Empty out the queue
-        while (!m_transparentRenderBatch.empty())
+        // When flushed, all the data is delegated to the render device to do the actual drawing.
+        for (uint32 index : m_transparentOrder)
         {
-            BatchPair pair = m_transparentRenderBatch.top();
-
-            Graphics::BatchDrawData&  drawData      = std::get<0>(pair);
-            Graphics::BatchModelData& modelData     = std::get<1>(pair);
-            size_t                    numTransforms = modelData.m_models.size();
-            if (numTransforms == 0)
-                continue;
-
-            Graphics::VertexArray* vertexArray = drawData.m_vertexArray;
-            Matrix*                models      = &modelData.m_models[0];
+            Graphics::TransparentInstance& instance    = m_proxyTable.GetTransparentInstances()[index];
+            const Graphics::BatchDrawData& drawData    = instance.m_drawData;
+            Graphics::VertexArray*         vertexArray = drawData.m_vertexArray;
 
             // Get the material for drawing, object's own material or overriden material.
             Graphics::Material* mat = overrideMaterial == nullptr ? drawData.m_material : overrideMaterial;
 
             // Draw call.
-            // Update the buffer w/ each transform.
-            vertexArray->UpdateBuffer(7, models, numTransforms * sizeof(Matrix));
+            // Update the buffer w/ the transform.
+            vertexArray->UpdateBuffer(7, &instance.m_model, sizeof(Matrix));
 
-            if (modelData.m_boneTransformations.size() == 0)
-                mat->SetBool(UF_BOOL_SKINNED, false);
-            else
-                mat->SetBool(UF_BOOL_SKINNED, true);
+            if (drawData.m_paletteBuffer != 0)
+                m_renderDevice->BindUniformBuffer(drawData.m_paletteBuffer, UF_BONEDATA_BINDPOINT);
 
-            for (int i = 0; i < modelData.m_boneTransformations.size(); i++)
-                mat->SetMatrix4(std::string(UF_BONE_MATRICES) + "[" + std::to_string(i) + "]", modelData.m_boneTransformations[i]);
+            mat->SetBool(UF_BOOL_SKINNED, drawData.m_paletteBuffer != 0);
             m_renderEngine->UpdateShaderData(mat);
-            m_renderDevice->Draw(vertexArray->GetID(), drawParams, (uint32)numTransforms, vertexArray->GetIndexCount(), false);
-
-            // Clear the buffer.
-            if (completeFlush)
-            {
-                modelData.m_models.clear();
-                modelData.m_boneTransformations.clear();
-            }
-
-            m_transparentRenderBatch.pop();
+            m_renderDevice->Draw(vertexArray->GetID(), drawParams, (uint32)1, vertexArray->GetIndexCount(), false);
         }
     }
 
@@ -28,14 +28,19 @@ SOFTWARE.
 
 #include "ECS/Systems/ReflectionSystem.hpp"
 #include "EventSystem/MainLoopEvents.hpp"
+#include "EventSystem/LevelEvents.hpp"
 #include "EventSystem/EventSystem.hpp"
 #include "ECS/Registry.hpp"
 #include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/LightComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
 #include "ECS/Components/ReflectionAreaComponent.hpp"
 #include "Rendering/RenderingCommon.hpp"
 #include "Rendering/Material.hpp"
 #include "Rendering/RenderConstants.hpp"
 #include "Core/RenderEngineBackend.hpp"
+#include "Log/Log.hpp"
+#include "Utility/UtilityFunctions.hpp"
 
 namespace Lina::ECS
 {
@@ -43,6 +48,9 @@ namespace Lina::ECS
     {
         System::Initialize(name);
         Event::EventSystem::Get()->Connect<Event::EPlayModeChanged, &ReflectionSystem::OnPlayModeChanged>(this);
+        Event::EventSystem::Get()->Connect<Event::ELevelInstalled, &ReflectionSystem::OnLevelInstalled>(this);
+        Event::EventSystem::Get()->Connect<Event::ELevelUninstalled, &ReflectionSystem::OnLevelUninstalled>(this);
+        Event::EventSystem::Get()->Connect<Event::ESerializedLevel, &ReflectionSystem::OnSerializedLevel>(this);
         m_renderEngine = Graphics::RenderEngineBackend::Get();
         m_appMode      = appMode;
     }
@@ -53,6 +61,9 @@ namespace Lina::ECS
         auto& view = reg->view<EntityDataComponent, ReflectionAreaComponent>();
         m_poolSize = (int)view.size_hint();
 
+        m_probeStates.clear();
+        m_probeEntities.clear();
+
         for (auto entity : view)
         {
             auto& refArea = view.get<ReflectionAreaComponent>(entity);
@@ -60,49 +71,76 @@ namespace Lina::ECS
 
             // Make sure the area's texture is constructed.
             if (refArea.m_cubemap.GetIsEmpty())
-                ConstructRefAreaTexture(&refArea.m_cubemap, refArea.m_resolution);
-
-            if (refArea.m_isDynamic)
             {
-                m_renderEngine->CaptureReflections(refArea.m_cubemap, data.GetLocation(), refArea.m_resolution);
+                ConstructRefAreaTexture(&refArea.m_cubemap, refArea.m_resolution);
+                refArea.m_isCaptured = false;
+                refArea.m_nextFace   = 0;
             }
+
+            Graphics::ReflectionProbeState state;
+            state.m_location         = data.GetLocation();
+            state.m_halfExtents      = refArea.m_halfExtents;
+            state.m_isLocal          = refArea.m_isLocal;
+            state.m_isDynamic        = refArea.m_isDynamic;
+            state.m_isCaptured       = refArea.m_isCaptured;
+            state.m_nextFace         = refArea.m_nextFace;
+            state.m_lastCaptureFrame = refArea.m_lastCaptureFrame;
+            m_probeStates.push_back(state);
+            m_probeEntities.push_back(entity);
+        }
+
+        // Only a limited amount of faces are captured per frame, the scheduler decides which ones.
+        m_scheduler.Schedule(m_probeStates, m_renderEngine->GetCameraSystem()->GetCameraLocation(), m_frame, m_faceCaptures);
+
+        for (auto& capture : m_faceCaptures)
+        {
+            auto& refArea = view.get<ReflectionAreaComponent>(m_probeEntities[capture.m_probeIndex]);
+            m_renderEngine->CaptureReflectionFace(refArea.m_cubemap, m_probeStates[capture.m_probeIndex].m_location, refArea.m_resolution, capture.m_face);
+        }
+
+        for (uint32 i = 0; i < (uint32)m_probeStates.size(); i++)
+        {
+            const auto& state = m_probeStates[i];
+
+            if (!state.m_isDynamic)
+                continue;
+
+            auto& refArea              = view.get<ReflectionAreaComponent>(m_probeEntities[i]);
+            refArea.m_isCaptured       = state.m_isCaptured;
+            refArea.m_nextFace         = state.m_nextFace;
+            refArea.m_lastCaptureFrame = state.m_lastCaptureFrame;
         }
+
+        m_lookup.Build(m_probeStates);
+        m_frame++;
     }
 
     void ReflectionSystem::SetReflectionsOnMaterial(Graphics::Material* mat, const Vector3& transformLocation)
     {
-        if (mat->m_receivesEnvironmentReflections)
-        {
-            auto* reg = Registry::Get();
+        if (!mat->m_receivesEnvironmentReflections)
+            return;
 
-            // Check if the given location is inside any of the reflection area's extents.
+        // Resolved against the probes gathered during the last update.
+        const int probe = m_lookup.Resolve(transformLocation);
 
-            auto& view = reg->view<EntityDataComponent, ReflectionAreaComponent>();
+        // The area might have been destroyed or lost its component since.
+        auto*                    reg     = Registry::Get();
+        ReflectionAreaComponent* refArea = probe != -1 && reg->valid(m_probeEntities[probe]) ? reg->try_get<ReflectionAreaComponent>(m_probeEntities[probe]) : nullptr;
 
-            for (auto entity : view)
+        if (refArea != nullptr)
+        {
+            if (mat->m_sampler2Ds.find(MAT_MAP_REFLECTIONAREAMAP) != mat->m_sampler2Ds.end())
             {
-                auto&         refArea = view.get<ReflectionAreaComponent>(entity);
-                auto&         data    = view.get<EntityDataComponent>(entity);
-                const Vector3 max     = data.GetLocation() + refArea.m_halfExtents;
-                const Vector3 min     = data.GetLocation() - refArea.m_halfExtents;
-                if (!refArea.m_isLocal || (transformLocation.x > min.x && transformLocation.x < max.x && transformLocation.y > min.y && transformLocation.y < max.y && transformLocation.z > min.z && transformLocation.z < max.z))
-                {
-                    if (mat->m_sampler2Ds.find(MAT_MAP_REFLECTIONAREAMAP) != mat->m_sampler2Ds.end())
-                    {
-                        mat->SetTexture(MAT_MAP_REFLECTIONAREAMAP, &refArea.m_cubemap, Graphics::TextureBindMode::BINDTEXTURE_CUBEMAP);
-                        mat->m_reflectionDataSet = true;
-                    }
-                }
-                else
-                {
-                    if (mat->m_reflectionDataSet)
-                    {
-                        // remove data.
-                        mat->RemoveTexture(MAT_MAP_REFLECTIONAREAMAP);
-                    }
-                }
+                mat->SetTexture(MAT_MAP_REFLECTIONAREAMAP, &refArea->m_cubemap, Graphics::TextureBindMode::BINDTEXTURE_CUBEMAP);
+                mat->m_reflectionDataSet = true;
             }
         }
+        else if (mat->m_reflectionDataSet)
+        {
+            // remove data.
+            mat->RemoveTexture(MAT_MAP_REFLECTIONAREAMAP);
+            mat->m_reflectionDataSet = false;
+        }
     }
 
     void ReflectionSystem::ConstructRefAreaTexture(Graphics::Texture* texture, const Vector2i& res)
@@ -116,26 +154,180 @@ namespace Lina::ECS
         texture->ConstructRTCubemapTexture(res, samplerParams);
     }
 
-    void ReflectionSystem::OnPlayModeChanged(const Event::EPlayModeChanged& ev)
+    void ReflectionSystem::LoadProbeCache()
     {
-        auto* reg = Registry::Get();
+        m_probeCache.Clear();
 
-        // Find all the reflection area's that are supposed to be calculated when the game begins.
-        if (ev.m_playMode)
+        if (m_probeCachePath.empty() || !Utility::FileExists(m_probeCachePath))
+            return;
+
+        m_probeCache.LoadFromFile(m_probeCachePath);
+
+        // Entries of another layout can't be trusted, they're baked again.
+        if (!m_probeCache.IsCurrentVersion())
+            m_probeCache.Clear();
+    }
+
+    void ReflectionSystem::SaveProbeCache()
+    {
+        if (m_probeCachePath.empty() || m_probeCache.m_entries.empty())
+            return;
+
+        // Shipped levels come with their cache, probes baked at runtime are kept in memory only.
+        if (m_appMode == ApplicationMode::Editor)
+            Resources::SaveArchiveToFile<Graphics::ReflectionProbeCache>(m_probeCachePath, m_probeCache);
+        else
+            LINA_WARN("[Reflection System] -> Static reflection areas of the level were baked at runtime, enter play mode in the editor to ship them.");
+    }
+
+    uint64 ReflectionSystem::HashScene()
+    {
+        // Everything a capture sees, rendered models, lights & the sky.
+        using Graphics::ReflectionProbeCache;
+        auto*        reg     = Registry::Get();
+        const uint32 version = ReflectionProbeCache::Version;
+        uint64       hash    = ReflectionProbeCache::HashBytes(ReflectionProbeCache::HashSeed, &version, sizeof(uint32));
+
+        Graphics::Material* skybox    = m_renderEngine->GetSkyboxMaterial();
+        const StringIDType  skyboxSid = skybox == nullptr ? 0 : skybox->GetSID();
+        hash                          = ReflectionProbeCache::HashBytes(hash, &skyboxSid, sizeof(StringIDType));
+
+        auto hashTransform = [&](Entity entity, EntityDataComponent& data, bool isEnabled) {
+            const Vector3    location   = data.GetLocation();
+            const Quaternion rotation   = data.GetRotation();
+            const Vector3    scale      = data.GetScale();
+            const float      values[10] = {location.x, location.y, location.z, rotation.x, rotation.y, rotation.z, rotation.w, scale.x, scale.y, scale.z};
+            const uint32     ids[2]     = {(uint32)entt::to_integral(entity), (uint32)(isEnabled && data.GetIsEnabled())};
+            hash                        = ReflectionProbeCache::HashBytes(hash, values, sizeof(values));
+            hash                        = ReflectionProbeCache::HashBytes(hash, ids, sizeof(ids));
+        };
+
+        auto hashLight = [&](Entity entity, EntityDataComponent& data, LightComponent& light, uint32 type) {
+            const float values[5] = {light.m_color.r, light.m_color.g, light.m_color.b, light.m_color.a, light.m_intensity};
+            hashTransform(entity, data, light.GetIsEnabled());
+            hash = ReflectionProbeCache::HashBytes(hash, values, sizeof(values));
+            hash = ReflectionProbeCache::HashBytes(hash, &type, sizeof(uint32));
+        };
+
+        for (auto entity : reg->view<EntityDataComponent, ModelNodeComponent>())
+        {
+            auto& nodeComponent = reg->get<ModelNodeComponent>(entity);
+            hashTransform(entity, reg->get<EntityDataComponent>(entity), nodeComponent.GetIsEnabled());
+            hash = ReflectionProbeCache::HashBytes(hash, &nodeComponent.m_model.m_sid, sizeof(StringIDType));
+            hash = ReflectionProbeCache::HashBytes(hash, &nodeComponent.m_nodeIndex, sizeof(int));
+
+            for (auto& material : nodeComponent.m_materials)
+                hash = ReflectionProbeCache::HashBytes(hash, &material.m_sid, sizeof(StringIDType));
+        }
+
+        for (auto entity : reg->view<EntityDataComponent, DirectionalLightComponent>())
+            hashLight(entity, reg->get<EntityDataComponent>(entity), reg->get<DirectionalLightComponent>(entity), 0);
+
+        for (auto entity : reg->view<EntityDataComponent, PointLightComponent>())
+        {
+            auto& light = reg->get<PointLightComponent>(entity);
+            hashLight(entity, reg->get<EntityDataComponent>(entity), light, 1);
+            hash = ReflectionProbeCache::HashBytes(hash, &light.m_distance, sizeof(float));
+        }
+
+        for (auto entity : reg->view<EntityDataComponent, SpotLightComponent>())
+        {
+            auto&       light     = reg->get<SpotLightComponent>(entity);
+            const float values[3] = {light.m_distance, light.m_cutoff, light.m_outerCutoff};
+            hashLight(entity, reg->get<EntityDataComponent>(entity), light, 2);
+            hash = ReflectionProbeCache::HashBytes(hash, values, sizeof(values));
+        }
+
+        return hash;
+    }
+
+    void ReflectionSystem::BakeStaticAreas()
+    {
+        auto* reg          = Registry::Get();
+        auto* renderDevice = m_renderEngine->GetRenderDevice();
+        auto& view         = reg->view<EntityDataComponent, ReflectionAreaComponent>();
+        bool  cacheDirty   = false;
+
+        // Hashed once, each area adds its own location & resolution.
+        const uint64 sceneHash = HashScene();
+
+        for (auto entity : view)
         {
-            auto& view = reg->view<EntityDataComponent, ReflectionAreaComponent>();
+            auto& refArea = view.get<ReflectionAreaComponent>(entity);
+            auto& data    = view.get<EntityDataComponent>(entity);
+
+            if (refArea.m_isDynamic)
+                continue;
+
+            if (refArea.m_cubemap.GetIsEmpty())
+                ConstructRefAreaTexture(&refArea.m_cubemap, refArea.m_resolution);
+
+            const Vector2i&                            res      = refArea.m_resolution;
+            const uint32                               probeID  = (uint32)entt::to_integral(entity);
+            const uint64                               hash     = Graphics::ReflectionProbeCache::GetProbeHash(sceneHash, data.GetLocation(), res);
+            const Graphics::ReflectionProbeCacheEntry* entry    = m_probeCache.GetEntry(probeID, hash);
+            const size_t                               faceSize = (size_t)res.x * (size_t)res.y * 3;
 
-            for (auto entity : view)
+            if (entry != nullptr && entry->m_resolution == res && entry->m_faces.size() == REFLECTION_PROBE_FACES)
             {
-                auto& refArea = view.get<ReflectionAreaComponent>(entity);
-                auto& data    = view.get<EntityDataComponent>(entity);
+                // Upload the baked data instead of rendering the scene again.
+                for (uint32 i = 0; i < REFLECTION_PROBE_FACES; i++)
+                    renderDevice->UpdateCubemapFace(refArea.m_cubemap.GetID(), i, res, Graphics::PixelFormat::FORMAT_RGB16F, Graphics::PixelFormat::FORMAT_RGB, entry->m_faces[i].data());
+            }
+            else
+            {
+                // Tell render engine to render the scene by writing to the reflection area's cubemap texture.
+                m_renderEngine->CaptureReflections(refArea.m_cubemap, data.GetLocation(), res);
+
+                Graphics::ReflectionProbeCacheEntry newEntry;
+                newEntry.m_hash       = hash;
+                newEntry.m_resolution = res;
+                newEntry.m_faces.resize(REFLECTION_PROBE_FACES);
 
-                if (!refArea.m_isDynamic)
+                for (uint32 i = 0; i < REFLECTION_PROBE_FACES; i++)
                 {
-                    // Tell render engine to render the scene by writing to the reflection area's cubemap texture.
-                    m_renderEngine->CaptureReflections(refArea.m_cubemap, data.GetLocation(), refArea.m_resolution);
+                    newEntry.m_faces[i].resize(faceSize);
+                    renderDevice->GetCubemapFaceImage(refArea.m_cubemap.GetID(), i, Graphics::PixelFormat::FORMAT_RGB, newEntry.m_faces[i].data());
                 }
+
+                m_probeCache.SetEntry(probeID, newEntry);
+                cacheDirty = true;
             }
+
+            refArea.m_isCaptured = true;
         }
+
+        if (cacheDirty)
+            SaveProbeCache();
+    }
+
+    void ReflectionSystem::OnPlayModeChanged(const Event::EPlayModeChanged& ev)
+    {
+        // Find all the reflection area's that are supposed to be calculated when the game begins.
+        if (ev.m_playMode)
+            BakeStaticAreas();
+    }
+
+    void ReflectionSystem::OnLevelInstalled(const Event::ELevelInstalled& ev)
+    {
+        // Levels that weren't saved yet have no cache, their areas are baked on entering play mode.
+        m_probeCachePath = ev.m_path.empty() ? "" : Graphics::ReflectionProbeCache::GetCachePath(ev.m_path);
+        LoadProbeCache();
+    }
+
+    void ReflectionSystem::OnLevelUninstalled(const Event::ELevelUninstalled& ev)
+    {
+        m_probeCachePath = "";
+        m_probeCache.Clear();
+        m_probeStates.clear();
+        m_probeEntities.clear();
+        m_lookup.Build(m_probeStates);
+    }
+
+    void ReflectionSystem::OnSerializedLevel(const Event::ESerializedLevel& ev)
+    {
+        // Saving under a new path moves the baked areas along, stale entries are skipped by their hash anyway.
+        m_probeCachePath = Graphics::ReflectionProbeCache::GetCachePath(ev.m_path);
+        SaveProbeCache();
     }
 } // namespace Lina::ECS
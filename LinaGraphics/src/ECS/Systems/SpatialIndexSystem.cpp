@@ -0,0 +1,128 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ECS/Systems/SpatialIndexSystem.hpp"
+#include "ECS/Systems/FrustumSystem.hpp"
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
+#include "ECS/Registry.hpp"
+#include "Core/RenderEngineBackend.hpp"
+#include "Math/Math.hpp"
+
+namespace Lina::ECS
+{
+    void SpatialIndexSystem::Initialize(const std::string& name)
+    {
+        System::Initialize(name);
+        m_renderEngine = Graphics::RenderEngineBackend::Get();
+    }
+
+    void SpatialIndexSystem::UpdateComponents(float delta)
+    {
+        auto*  ecs           = ECS::Registry::Get();
+        auto&  view          = ecs->view<EntityDataComponent, ModelNodeComponent>();
+        auto*  frustumSystem = m_renderEngine->GetFrustumSystem();
+        uint32 maxIndex      = 0;
+        m_frame++;
+        m_totalMeshCount = 0;
+
+        for (auto entity : view)
+        {
+            ModelNodeComponent&  nodeComp = view.get<ModelNodeComponent>(entity);
+            EntityDataComponent& data     = view.get<EntityDataComponent>(entity);
+            Graphics::Model*     model    = nodeComp.m_model.m_value;
+
+            if (model == nullptr)
+                continue;
+
+            Graphics::ModelNode* node     = model->GetAllNodes()[nodeComp.m_nodeIndex];
+            const Vector3&       location = data.GetLocation();
+            const Quaternion&    rotation = data.GetRotation();
+            const Vector3&       scale    = data.GetScale();
+            bool                 moved    = false;
+
+            // Only recalculate the world bounds if the node or the transformation has changed.
+            if (nodeComp.m_boundsNode != node || nodeComp.m_boundsLocation != location || nodeComp.m_boundsRotation != rotation || nodeComp.m_boundsScale != scale)
+            {
+                frustumSystem->GetAABBInModelNode(node, nodeComp.m_worldBoundsCenter, nodeComp.m_worldBoundsHalfExtent, location, rotation, scale);
+                nodeComp.m_boundsNode     = node;
+                nodeComp.m_boundsLocation = location;
+                nodeComp.m_boundsRotation = rotation;
+                nodeComp.m_boundsScale    = scale;
+                moved                     = true;
+            }
+
+            const Vector3 min   = nodeComp.m_worldBoundsCenter - nodeComp.m_worldBoundsHalfExtent;
+            const Vector3 max   = nodeComp.m_worldBoundsCenter + nodeComp.m_worldBoundsHalfExtent;
+            int           proxy = nodeComp.m_spatialProxy;
+
+            // Copied components carry the proxy of their source, so ownership is checked as well.
+            if (proxy == AABBTREE_NULL_NODE || proxy >= (int)m_proxies.size() || m_proxies[proxy].m_entity != entity)
+            {
+                proxy = m_tree.CreateProxy(min, max, (uint32)entity);
+
+                if (proxy >= (int)m_proxies.size())
+                    m_proxies.resize(proxy + 1);
+
+                nodeComp.m_spatialProxy   = proxy;
+                m_proxies[proxy].m_entity = entity;
+                moved                     = true;
+            }
+            else if (moved)
+                m_tree.MoveProxy(proxy, min, max);
+
+            SpatialProxy& proxyData   = m_proxies[proxy];
+            proxyData.m_lastSeenFrame = m_frame;
+
+            if (moved)
+            {
+                proxyData.m_center     = nodeComp.m_worldBoundsCenter;
+                proxyData.m_halfExtent = nodeComp.m_worldBoundsHalfExtent;
+                proxyData.m_meshCount  = (uint32)node->GetMeshes().size();
+            }
+
+            m_totalMeshCount += proxyData.m_meshCount;
+            maxIndex = Math::Max(maxIndex, (uint32)entt::to_entity(entity));
+        }
+
+        // Sweep proxies of destroyed entities & entities that lost their model.
+        for (int i = 0; i < (int)m_proxies.size(); i++)
+        {
+            SpatialProxy& proxyData = m_proxies[i];
+
+            if (proxyData.m_entity != entt::null && proxyData.m_lastSeenFrame != m_frame)
+            {
+                m_tree.DestroyProxy(i);
+                proxyData = SpatialProxy();
+            }
+        }
+
+        m_entityCapacity = m_tree.GetProxyCount() == 0 ? 0 : maxIndex + 1;
+        m_poolSize       = m_tree.GetProxyCount();
+    }
+} // namespace Lina::ECS
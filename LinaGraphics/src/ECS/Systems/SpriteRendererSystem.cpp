@@ -33,14 +33,19 @@ SOFTWARE.
 #include "ECS/Components/EntityDataComponent.hpp"
 #include "ECS/Components/SpriteRendererComponent.hpp"
 #include "ECS/Registry.hpp"
-#include "Rendering/Mesh.hpp"
-#include "Utility/ModelLoader.hpp"
+#include "Rendering/RenderConstants.hpp"
+#include "Rendering/Shader.hpp"
+#include "Rendering/Texture.hpp"
 
 namespace Lina::ECS
 {
     SpriteRendererSystem::~SpriteRendererSystem()
     {
-        delete m_quadMesh;
+        for (Graphics::Texture* texture : m_atlasTextures)
+            delete texture;
+
+        if (m_renderDevice != nullptr)
+            m_vao = m_renderDevice->ReleaseVertexArray(m_vao);
     }
 
     void SpriteRendererSystem::Initialize(const std::string& name)
@@ -48,73 +53,140 @@ namespace Lina::ECS
         System::Initialize(name);
         m_renderEngine = Graphics::RenderEngineBackend::Get();
         m_renderDevice = m_renderEngine->GetRenderDevice();
+        m_vao          = m_renderDevice->CreateSpriteVertexArray(SPRITE_BATCH_MAX_QUADS);
 
-        m_quadMesh = new Graphics::Mesh();
-        Graphics::ModelLoader::LoadSpriteQuad(*m_quadMesh);
-        m_quadMesh->CreateVertexArray(Graphics::BufferUsage::USAGE_STATIC_COPY);
+        // Sprites without a diffuse texture sample this.
+        const std::vector<uint8> white(4 * 4 * 4, 255);
+        m_atlas.AddImage(0, 4, 4, 4, white.data());
+        m_atlas.Pack();
     }
 
+    void SpriteRendererSystem::SetShader(Graphics::Shader* shader)
+    {
+        m_batchMaterial.SetShader(shader);
+    }
 
     void SpriteRendererSystem::UpdateComponents(float delta)
     {
-        auto* ecs = ECS::Registry::Get();
+        auto* ecs       = ECS::Registry::Get();
+        auto& renderers = ecs->storage<SpriteRendererComponent>();
+        auto& datas     = ecs->storage<EntityDataComponent>();
+        m_poolSize      = (int)renderers.size();
 
-        auto view = ecs->view<EntityDataComponent, SpriteRendererComponent>();
-        m_poolSize = (int)view.size_hint();
+        m_batcher.Clear();
+        m_frameMaterials.clear();
 
-        // Find the sprites and add them to the render queue.
-        for (auto entity : view)
-        {
-            SpriteRendererComponent& renderer = view.get<SpriteRendererComponent>(entity);
-            EntityDataComponent&     data     = view.get<EntityDataComponent>(entity);
+        // Textures imported after their bundle was loaded, regions have to exist before the sprites are batched.
+        m_atlas.Pack();
+        UploadAtlasPages();
+
+        // Sprite matrices are extracted on the workers, atlas & batcher are only touched here.
+        m_extractor.Gather((uint32)renderers.size(), m_instanceSlices, m_instances, [&](uint32 begin, uint32 end, std::vector<SpriteInstance>& instances) {
+            const Entity* entities = renderers.data();
+
+            for (uint32 i = begin; i < end; i++)
+            {
+                const Entity entity = entities[i];
+
+                if (!datas.contains(entity))
+                    continue;
+
+                SpriteRendererComponent& renderer = renderers.get(entity);
+                EntityDataComponent&     data     = datas.get(entity);
 
-            if (!renderer.GetIsEnabled() || !data.GetIsEnabled())
-                return;
+                if (!renderer.GetIsEnabled() || !data.GetIsEnabled() || renderer.m_material.m_value == nullptr)
+                    continue;
 
+                SpriteInstance& instance = instances.emplace_back();
+                instance.m_model         = data.ToMatrix();
+                instance.m_material      = renderer.m_material.m_value;
+                instance.m_layer         = renderer.m_layer;
+            }
+        });
+
+        for (const SpriteInstance& instance : m_instances)
+        {
+            Graphics::Material* material = instance.m_material;
 
-            // Dont draw if mesh or material does not exist.
-            if (renderer.m_materialID < 0)
-                continue;
+            // Material lookups are done once per frame for each material.
+            auto it = m_frameMaterials.find(material);
+            if (it == m_frameMaterials.end())
+            {
+                const Color        color = material->GetColor(MAT_OBJECTCOLORPROPERTY);
+                SpriteMaterialData materialData;
+                materialData.m_region    = GetRegion(material);
+                materialData.m_color     = Graphics::SpriteBatcher::PackColor(color.r, color.g, color.b, color.a);
+                materialData.m_blendMode = material->GetSurfaceType() == Graphics::MaterialSurfaceType::Transparent ? Graphics::SpriteBlendMode::Transparent : Graphics::SpriteBlendMode::Opaque;
+                it                       = m_frameMaterials.emplace(material, materialData).first;
+            }
 
-          //  Graphics::Material& mat = Graphics::Material::GetMaterial(renderer.m_materialID);
-          //  Render(mat, data.ToMatrix());
+            m_batcher.AddSprite(instance.m_model, *it->second.m_region, it->second.m_color, instance.m_layer, it->second.m_blendMode);
         }
+
+        m_batcher.Build();
     }
 
-    void SpriteRendererSystem::Render(Graphics::Material& material, const Matrix& transformIn)
+    const Graphics::AtlasRegion* SpriteRendererSystem::GetRegion(Graphics::Material* material)
     {
-        m_renderBatch[&material].m_models.push_back(transformIn);
+        Graphics::Texture* texture = material->GetTexture(MAT_TEXTURE2D_DIFFUSE);
+        if (texture == nullptr)
+            return m_atlas.GetRegion(0);
+
+        const Graphics::AtlasRegion* region = m_atlas.GetRegion(texture->GetSID());
+        return region != nullptr ? region : m_atlas.GetRegion(0);
     }
 
-    void SpriteRendererSystem::Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
+    void SpriteRendererSystem::UploadAtlasPages()
     {
-        // When flushed, all the data is delegated to the render device to do the actual
-        // drawing. Then the data is cleared if complete flush is requested.
+        Graphics::SamplerParameters params;
+        params.m_textureParams.m_minFilter       = Graphics::SamplerFilter::FILTER_LINEAR;
+        params.m_textureParams.m_magFilter       = Graphics::SamplerFilter::FILTER_LINEAR;
+        params.m_textureParams.m_wrapS           = Graphics::SamplerWrapMode::WRAP_CLAMP_EDGE;
+        params.m_textureParams.m_wrapT           = Graphics::SamplerWrapMode::WRAP_CLAMP_EDGE;
+        params.m_textureParams.m_generateMipMaps = false;
+
+        const uint32 pageSize = m_atlas.GetPageSize();
 
-        for (std::map<Graphics::Material*, BatchModelData>::iterator it = m_renderBatch.begin(); it != m_renderBatch.end(); ++it)
+        // New pages are only allocated, texels outside the packed images are never sampled.
+        while ((uint32)m_atlasTextures.size() < m_atlas.GetPageCount())
         {
-            // Get references.
-            BatchModelData& modelData     = it->second;
-            size_t          numTransforms = modelData.m_models.size();
-            if (numTransforms == 0)
-                continue;
+            Graphics::Texture* texture = new Graphics::Texture();
+            texture->ConstructFromPixels(Vector2i((int)pageSize, (int)pageSize), nullptr, params);
+            m_atlasTextures.push_back(texture);
+        }
 
-            Matrix* models = &modelData.m_models[0];
+        for (const Graphics::AtlasUpload& upload : m_atlas.GetUploads())
+            m_renderDevice->UpdateTexture2D(m_atlasTextures[upload.m_page]->GetID(), Vector2i((int)upload.m_x, (int)upload.m_y), Vector2i((int)upload.m_width, (int)upload.m_height), Graphics::PixelFormat::FORMAT_RGBA, upload.m_pixels.data());
 
-            // Get the material for drawing, object's own material or overriden material.
-            Graphics::Material* mat = overrideMaterial == nullptr ? it->first : overrideMaterial;
+        m_atlas.ClearUploads();
+    }
 
-            // Update the buffer w/ each transform.
-            m_quadMesh->GetVertexArray().UpdateBuffer(2, models, numTransforms * sizeof(Matrix));
+    void SpriteRendererSystem::Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial, bool completeFlush)
+    {
+        const std::vector<Graphics::SpriteVertex>& vertices = m_batcher.GetVertices();
 
-            m_renderEngine->UpdateShaderData(mat);
-            m_renderDevice->Draw(m_quadMesh->GetVertexArray().GetID(), drawParams, (uint32)numTransforms, m_quadMesh->GetVertexArray().GetIndexCount(), false);
+        if (overrideMaterial == nullptr && !vertices.empty() && m_batchMaterial.GetShaderHandle().m_value != nullptr)
+        {
+            m_renderDevice->UpdateVertexArrayBuffer(m_vao, 0, vertices.data(), vertices.size() * sizeof(Graphics::SpriteVertex));
 
-            // Clear the buffer.
-            if (completeFlush)
+            for (const Graphics::SpriteBatch& batch : m_batcher.GetBatches())
             {
-                modelData.m_models.clear();
+                Graphics::DrawParams params = drawParams;
+
+                if (batch.m_blendMode == Graphics::SpriteBlendMode::Transparent)
+                {
+                    params.sourceBlend      = Graphics::BLEND_FUNC_SRC_ALPHA;
+                    params.destBlend        = Graphics::BLEND_FUNC_ONE_MINUS_SRC_ALPHA;
+                    params.shouldWriteDepth = false;
+                }
+
+                m_batchMaterial.SetTexture(MAT_TEXTURE2D_DIFFUSE, m_atlasTextures[batch.m_page]);
+                m_renderEngine->UpdateShaderData(&m_batchMaterial);
+                m_renderDevice->DrawBaseVertex(m_vao, params, batch.m_quadCount * 6, batch.m_firstVertex);
             }
         }
+
+        if (completeFlush)
+            m_batcher.Clear();
     }
 } // namespace Lina::ECS
@@ -0,0 +1,209 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ECS/Systems/StaticBatchSystem.hpp"
+
+#include "Core/RenderDeviceBackend.hpp"
+#include "Core/RenderEngineBackend.hpp"
+#include "Log/Log.hpp"
+#include "ECS/Components/CameraComponent.hpp"
+#include "ECS/Registry.hpp"
+#include "ECS/Systems/CameraSystem.hpp"
+#include "ECS/Systems/ModelNodeSystem.hpp"
+#include "ECS/Systems/ReflectionSystem.hpp"
+#include "EventSystem/EventSystem.hpp"
+#include "EventSystem/LevelEvents.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/RenderConstants.hpp"
+#include "Rendering/StaticMesh.hpp"
+
+namespace Lina::ECS
+{
+    StaticBatchSystem::~StaticBatchSystem()
+    {
+        Clear();
+    }
+
+    void StaticBatchSystem::Initialize(const std::string& name)
+    {
+        System::Initialize(name);
+        m_renderEngine = Graphics::RenderEngineBackend::Get();
+        Event::EventSystem::Get()->Connect<Event::ELevelInstalled, &StaticBatchSystem::OnLevelInstalled>(this);
+        Event::EventSystem::Get()->Connect<Event::ELevelUninstalled, &StaticBatchSystem::OnLevelUninstalled>(this);
+    }
+
+    void StaticBatchSystem::OnLevelInstalled(const Event::ELevelInstalled& ev)
+    {
+        Rebuild();
+    }
+
+    void StaticBatchSystem::OnLevelUninstalled(const Event::ELevelUninstalled& ev)
+    {
+        Clear();
+    }
+
+    void StaticBatchSystem::Clear()
+    {
+        m_builder.Clear();
+        m_boundsChunks.clear();
+        m_visibility.clear();
+        m_bounds.Clear();
+    }
+
+    void StaticBatchSystem::Rebuild()
+    {
+        Clear();
+        m_builder.Build(*ECS::Registry::Get());
+        UploadMergedChunks();
+
+        // Batched entities are drawn from here from now on.
+        auto* modelNodeSystem = m_renderEngine->GetModelNodeSystem();
+        for (auto& pair : m_builder.GetBatchedEntities())
+            modelNodeSystem->InvalidateProxy(pair.first);
+
+        const Graphics::StaticBatchStats& stats = m_builder.GetStats();
+        LINA_TRACE("[Static Batch] -> {0} entities, {1} meshes in {2} chunks, draw calls {3} -> {4}, {5} KB vertex, {6} KB index memory.", stats.m_batchedEntities, stats.m_batchedMeshes, (uint32)m_builder.GetChunks().size(), stats.m_sourceDrawCalls, stats.m_chunkDrawCalls, stats.m_vertexMemory / 1024, stats.m_indexMemory / 1024);
+    }
+
+    void StaticBatchSystem::UploadMergedChunks()
+    {
+        const auto& chunks = m_builder.GetChunks();
+
+        if (m_builder.GetMergedChunks().empty())
+            return;
+
+        // Vertex arrays can only be created on the render thread.
+        for (uint32 chunkIndex : m_builder.GetMergedChunks())
+        {
+            Graphics::StaticMesh* mesh = chunks[chunkIndex].m_mesh;
+
+            if (mesh == nullptr)
+                continue;
+
+            mesh->CreateVertexArray(Graphics::BufferUsage::USAGE_STATIC_DRAW);
+            mesh->ReleaseCPUData();
+
+            // Vertices are already in world space.
+            Matrix identity = Matrix::Identity();
+            mesh->GetVertexArray().UpdateBuffer(7, &identity[0][0], sizeof(Matrix));
+        }
+
+        // Bounds are rebuilt over the chunks that have a mesh.
+        m_bounds.Clear();
+        m_boundsChunks.clear();
+
+        for (uint32 i = 0; i < (uint32)chunks.size(); i++)
+        {
+            if (chunks[i].m_mesh == nullptr)
+                continue;
+
+            m_bounds.Add(chunks[i].m_center, chunks[i].m_halfExtent);
+            m_boundsChunks.push_back(i);
+        }
+    }
+
+    void StaticBatchSystem::UpdateComponents(float delta)
+    {
+        if (m_builder.GetChunks().empty())
+        {
+            m_poolSize = 0;
+            return;
+        }
+
+        auto* ecs = ECS::Registry::Get();
+        m_builder.RemoveOutdated(*ecs, m_removedEntities);
+
+        if (m_removedEntities.empty())
+            return;
+
+        UploadMergedChunks();
+
+        // From now on the entities are drawn as regular model nodes.
+        for (Entity entity : m_removedEntities)
+        {
+            if (ecs->valid(entity))
+                m_renderEngine->GetModelNodeSystem()->InvalidateProxy(entity);
+        }
+    }
+
+    void StaticBatchSystem::UpdateVisibility()
+    {
+        auto* camComponent = m_renderEngine->GetCameraSystem()->GetActiveCameraComponent();
+
+        if (camComponent == nullptr)
+        {
+            m_visibility.clear();
+            m_poolSize = 0;
+            return;
+        }
+
+        UpdateVisibility(camComponent->m_viewFrustum);
+    }
+
+    void StaticBatchSystem::UpdateVisibility(const Frustum& frustum)
+    {
+        if (m_builder.GetChunks().empty())
+        {
+            m_visibility.clear();
+            m_poolSize = 0;
+            return;
+        }
+
+        FrustumCuller::Cull(frustum, m_bounds, m_visibility);
+
+        m_poolSize = 0;
+        for (uint32 i = 0; i < (uint32)m_boundsChunks.size(); i++)
+        {
+            if (FrustumCuller::IsVisible(m_visibility, i))
+                m_poolSize++;
+        }
+    }
+
+    void StaticBatchSystem::Flush(Graphics::DrawParams& drawParams, Graphics::Material* overrideMaterial)
+    {
+        if (m_visibility.empty())
+            return;
+
+        auto* renderDevice = m_renderEngine->GetRenderDevice();
+
+        for (uint32 i = 0; i < (uint32)m_boundsChunks.size(); i++)
+        {
+            if (!FrustumCuller::IsVisible(m_visibility, i))
+                continue;
+
+            const Graphics::StaticBatchChunk& chunk       = m_builder.GetChunks()[m_boundsChunks[i]];
+            Graphics::VertexArray&            vertexArray = chunk.m_mesh->GetVertexArray();
+            Graphics::Material*               mat         = overrideMaterial == nullptr ? chunk.m_material : overrideMaterial;
+
+            m_renderEngine->GetReflectionSystem()->SetReflectionsOnMaterial(mat, chunk.m_center);
+            mat->SetBool(UF_BOOL_SKINNED, false);
+            m_renderEngine->UpdateShaderData(mat);
+            renderDevice->Draw(vertexArray.GetID(), drawParams, (uint32)1, vertexArray.GetIndexCount(), false);
+        }
+    }
+} // namespace Lina::ECS
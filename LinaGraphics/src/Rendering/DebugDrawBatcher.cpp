@@ -0,0 +1,202 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/DebugDrawBatcher.hpp"
+#include "EventSystem/GraphicsEvents.hpp"
+#include "Math/Math.hpp"
+#include <algorithm>
+
+namespace Lina::Graphics
+{
+#define DEBUG_CIRCLE_SEGMENTS 18
+
+    namespace
+    {
+        // Unit circle on the XZ plane, shared by all circle based shapes.
+        const Vector3* GetUnitCircle()
+        {
+            static Vector3 circle[DEBUG_CIRCLE_SEGMENTS + 1];
+            static bool    initialized = false;
+
+            if (!initialized)
+            {
+                for (int i = 0; i <= DEBUG_CIRCLE_SEGMENTS; i++)
+                {
+                    const float radians = Math::ToRadians(i * (360.0f / DEBUG_CIRCLE_SEGMENTS));
+                    circle[i]           = Vector3(Math::Cos(radians), 0.0f, Math::Sin(radians));
+                }
+                initialized = true;
+            }
+
+            return circle;
+        }
+
+        Color UnpackColor(uint32 argb)
+        {
+            return Color((float)((argb >> 16) & 0xff), (float)((argb >> 8) & 0xff), (float)(argb & 0xff), 255.0f, true);
+        }
+    } // namespace
+
+    void DebugDrawBatcher::AddLine(const Vector3& from, const Vector3& to, const Color& color, DebugDepthMode mode)
+    {
+        auto& vertices = m_lineVertices[static_cast<int>(mode)];
+        vertices.push_back(DebugVertex{from, color});
+        vertices.push_back(DebugVertex{to, color});
+        m_stats.m_lineCount++;
+    }
+
+    void DebugDrawBatcher::AddLines(const Vector3* points, uint32 lineCount, const Color& color, DebugDepthMode mode)
+    {
+        auto& vertices = m_lineVertices[static_cast<int>(mode)];
+        vertices.reserve(vertices.size() + lineCount * 2);
+
+        for (uint32 i = 0; i < lineCount * 2; i++)
+            vertices.push_back(DebugVertex{points[i], color});
+
+        m_stats.m_lineCount += lineCount;
+    }
+
+    void DebugDrawBatcher::AddPackedLines(const Event::DebugPackedLine* lines, uint32 lineCount, DebugDepthMode mode)
+    {
+        auto& vertices = m_lineVertices[static_cast<int>(mode)];
+        vertices.reserve(vertices.size() + lineCount * 2);
+
+        for (uint32 i = 0; i < lineCount; i++)
+        {
+            const Event::DebugPackedLine& line = lines[i];
+            vertices.push_back(DebugVertex{Vector3(line.m_from[0], line.m_from[1], line.m_from[2]), UnpackColor(line.m_fromColor)});
+            vertices.push_back(DebugVertex{Vector3(line.m_to[0], line.m_to[1], line.m_to[2]), UnpackColor(line.m_toColor)});
+        }
+
+        m_stats.m_lineCount += lineCount;
+    }
+
+    void DebugDrawBatcher::AddBox(const Vector3& center, const Vector3& halfExtents, const Color& color, DebugDepthMode mode)
+    {
+        const Vector3 bottomLB = center - halfExtents;
+        const Vector3 bottomLF = center + Vector3(-halfExtents.x, -halfExtents.y, halfExtents.z);
+        const Vector3 bottomRB = center + Vector3(halfExtents.x, -halfExtents.y, -halfExtents.z);
+        const Vector3 bottomRF = center + Vector3(halfExtents.x, -halfExtents.y, halfExtents.z);
+
+        const Vector3 topLB = center + Vector3(-halfExtents.x, halfExtents.y, -halfExtents.z);
+        const Vector3 topLF = center + Vector3(-halfExtents.x, halfExtents.y, halfExtents.z);
+        const Vector3 topRB = center + Vector3(halfExtents.x, halfExtents.y, -halfExtents.z);
+        const Vector3 topRF = center + halfExtents;
+
+        const Vector3 lines[24] = {bottomLB, bottomLF, bottomLF, bottomRF, bottomRF, bottomRB, bottomRB, bottomLB, topLB, topLF, topLF, topRF, topRF, topRB, topRB, topLB, bottomLB, topLB, bottomLF, topLF, bottomRF, topRF, bottomRB, topRB};
+        AddLines(lines, 12, color, mode);
+    }
+
+    void DebugDrawBatcher::AddCircle(const Vector3& center, float radius, const Color& color, const Quaternion& rotation, bool half, DebugDepthMode mode)
+    {
+        const Vector3* circle   = GetUnitCircle();
+        const int      segments = half ? DEBUG_CIRCLE_SEGMENTS / 2 : DEBUG_CIRCLE_SEGMENTS;
+        auto&          vertices = m_lineVertices[static_cast<int>(mode)];
+        vertices.reserve(vertices.size() + segments * 2);
+
+        Vector3 previous = center + rotation * (circle[0] * radius);
+
+        for (int i = 1; i <= segments; i++)
+        {
+            const Vector3 current = center + rotation * (circle[i] * radius);
+            vertices.push_back(DebugVertex{previous, color});
+            vertices.push_back(DebugVertex{current, color});
+            previous = current;
+        }
+
+        m_stats.m_lineCount += segments;
+    }
+
+    void DebugDrawBatcher::AddSphere(const Vector3& center, float radius, const Color& color, DebugDepthMode mode)
+    {
+        AddCircle(center, radius, color, Quaternion(), false, mode);
+        AddCircle(center, radius, color, Quaternion(Vector3(0, 0, 1), 90), false, mode);
+        AddCircle(center, radius, color, Quaternion(Vector3(1, 0, 0), 90), false, mode);
+    }
+
+    void DebugDrawBatcher::AddHemiSphere(const Vector3& center, float radius, bool top, const Color& color, DebugDepthMode mode)
+    {
+        const Quaternion q1 = Quaternion(Vector3(1, 0, 0), top ? -90.0f : 90.0f);
+        const Quaternion q2 = q1 * Quaternion(Vector3(0, 0, 1), 90);
+        AddCircle(center, radius, color, Quaternion(), false, mode);
+        AddCircle(center, radius, color, q1, true, mode);
+        AddCircle(center, radius, color, q2, true, mode);
+    }
+
+    void DebugDrawBatcher::AddCapsule(const Vector3& center, float radius, float height, const Color& color, DebugDepthMode mode)
+    {
+        AddHemiSphere(center + Vector3(0, height, 0), radius, true, color, mode);
+        AddHemiSphere(center - Vector3(0, height, 0), radius, false, color, mode);
+
+        const Vector3 lines[8] = {center + Vector3(-radius, -height, 0.0f), center + Vector3(-radius, height, 0.0f),
+                                  center + Vector3(radius, -height, 0.0f), center + Vector3(radius, height, 0.0f),
+                                  center + Vector3(0.0f, -height, -radius), center + Vector3(0.0f, height, -radius),
+                                  center + Vector3(0.0f, -height, radius), center + Vector3(0.0f, height, radius)};
+        AddLines(lines, 4, color, mode);
+    }
+
+    void DebugDrawBatcher::AddFrustum(const Matrix& viewProjection, const Color& color, DebugDepthMode mode)
+    {
+        const Matrix inverse = viewProjection.Inverse();
+        Vector3      corners[8];
+
+        // Unproject the NDC cube, index bits are x, y, z.
+        for (int i = 0; i < 8; i++)
+        {
+            const glm::vec4 ndc   = glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+            const glm::vec4 world = inverse * ndc;
+            corners[i]            = Vector3(world.x / world.w, world.y / world.w, world.z / world.w);
+        }
+
+        const Vector3 lines[24] = {corners[0], corners[1], corners[1], corners[3], corners[3], corners[2], corners[2], corners[0],
+                                   corners[4], corners[5], corners[5], corners[7], corners[7], corners[6], corners[6], corners[4],
+                                   corners[0], corners[4], corners[1], corners[5], corners[2], corners[6], corners[3], corners[7]};
+        AddLines(lines, 12, color, mode);
+    }
+
+    void DebugDrawBatcher::AddIcon(const Vector3& center, StringIDType textureID, float size)
+    {
+        m_icons.push_back(DebugIcon{center, textureID, size});
+        m_stats.m_iconCount++;
+    }
+
+    void DebugDrawBatcher::SortIcons()
+    {
+        std::sort(m_icons.begin(), m_icons.end(), [](const DebugIcon& lhs, const DebugIcon& rhs) { return lhs.m_textureID < rhs.m_textureID; });
+    }
+
+    void DebugDrawBatcher::Clear()
+    {
+        for (int i = 0; i < DEBUG_DEPTH_MODES; i++)
+            m_lineVertices[i].clear();
+
+        m_icons.clear();
+        m_lastFrameStats = m_stats;
+        m_stats          = DebugDrawStats();
+    }
+} // namespace Lina::Graphics
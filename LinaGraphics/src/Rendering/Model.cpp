@@ -30,7 +30,10 @@ SOFTWARE.
 #include "Rendering/Model.hpp"
 #include "Core/RenderEngineBackend.hpp"
 #include "ECS/Components/MeshRendererComponent.hpp"
+#include "EventSystem/EventSystem.hpp"
+#include "EventSystem/ResourceEvents.hpp"
 #include "Log/Log.hpp"
+#include "Rendering/Mesh.hpp"
 #include "Rendering/VertexArray.hpp"
 #include "Utility/ModelLoader.hpp"
 #include "Utility/UtilityFunctions.hpp"
@@ -43,6 +46,13 @@ namespace Lina::Graphics
         delete m_rootNode;
     }
 
+    Model::Model(ModelNode* rootNode) : m_rootNode(rootNode)
+    {
+        m_allNodes.push_back(rootNode);
+        m_numNodes  = 1;
+        m_numMeshes = (int)rootNode->GetMeshes().size();
+    }
+
     void* Model::LoadFromMemory(const std::string& path, unsigned char* data, size_t dataSize)
     {
         LINA_TRACE("[Model Loader - Memory] -> Loading: {0}", path);
@@ -55,6 +65,9 @@ namespace Lina::Graphics
 
         ModelLoader::LoadModel(data, dataSize, this);
 
+        // Packed models are read only, missing collision meshes are cooked but not saved.
+        LoadCollisionMeshes();
+
         // Set id
         return static_cast<void*>(this);
     }
@@ -70,7 +83,45 @@ namespace Lina::Graphics
         GetCreateAssetdata<ModelAssetData>(assetDataPath, m_assetData);
 
         ModelLoader::LoadModel(path, this);
+
+        if (LoadCollisionMeshes())
+            Resources::SaveArchiveToFile<ModelAssetData>(assetDataPath, *m_assetData);
+
         return static_cast<void*>(this);
     }
 
+    uint32 Model::GetFirstMeshIndex(int nodeIndex)
+    {
+        uint32 meshIndex = 0;
+
+        for (int i = 0; i < nodeIndex && i < (int)m_allNodes.size(); i++)
+            meshIndex += (uint32)m_allNodes[i]->GetMeshes().size();
+
+        return meshIndex;
+    }
+
+    bool Model::LoadCollisionMeshes()
+    {
+        std::vector<Physics::CollisionMeshSource> sources;
+
+        for (ModelNode* node : m_allNodes)
+        {
+            for (Mesh* mesh : node->GetMeshes())
+            {
+                const std::vector<float>&  positions = mesh->GetVertexPositions().m_floatElements;
+                const std::vector<uint32>& indices   = mesh->GetIndices();
+
+                Physics::CollisionMeshSource& source = sources.emplace_back();
+                source.m_positions                   = positions.data();
+                source.m_indices                     = indices.data();
+                source.m_vertexCount                 = (uint32)positions.size() / 3;
+                source.m_indexCount                  = (uint32)indices.size();
+            }
+        }
+
+        bool cacheUpdated = false;
+        Event::EventSystem::Get()->Trigger<Event::EModelCollisionMeshesLoaded>(Event::EModelCollisionMeshesLoaded{m_sid, &sources, &m_assetData->m_cookedCollisionMeshes, &cacheUpdated});
+        return cacheUpdated;
+    }
+
 } // namespace Lina::Graphics
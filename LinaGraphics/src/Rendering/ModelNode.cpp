@@ -42,6 +42,10 @@ SOFTWARE.
 
 namespace Lina::Graphics
 {
+    ModelNode::ModelNode(const std::vector<Mesh*>& meshes) : m_meshes(meshes)
+    {
+    }
+
     ModelNode::~ModelNode()
     {
         LINA_TRACE("Deleting Node {0}", m_name);
@@ -52,11 +56,12 @@ namespace Lina::Graphics
         m_meshes.clear();
     }
 
-    void ModelNode::FillNodeHierarchy(const aiNode* node, const aiScene* scene, Model* parentModel)
+    void ModelNode::FillNodeHierarchy(const aiNode* node, const aiScene* scene, Model* parentModel, const Matrix& parentTransform)
     {
         m_name                    = std::string(node->mName.C_Str());
         const std::string sidName = parentModel->GetPath() + m_name;
         m_localTransform          = AssimpToLinaMatrix(node->mTransformation);
+        m_globalTransform         = parentTransform * m_localTransform;
         parentModel->m_allNodes.push_back(this);
         parentModel->m_numNodes++;
         m_nodeIndexInParentHierarchy = parentModel->m_numNodes - 1;
@@ -85,7 +90,7 @@ namespace Lina::Graphics
 
             parentModel->m_numVertices += aimesh->mNumVertices;
             parentModel->m_numBones += aimesh->mNumBones;
-            ModelLoader::FillMeshData(aimesh, addedMesh);
+            ModelLoader::FillMeshData(aimesh, addedMesh, parentModel->m_skeleton, parentModel->GetAssetData() != nullptr && parentModel->GetAssetData()->m_isOccluder);
 
             m_totalVertexCenter += addedMesh->GetVertexCenter();
 
@@ -137,7 +142,7 @@ namespace Lina::Graphics
         {
             ModelNode* newNode = new ModelNode();
             m_children.push_back(newNode);
-            newNode->FillNodeHierarchy(node->mChildren[i], scene, parentModel);
+            newNode->FillNodeHierarchy(node->mChildren[i], scene, parentModel, m_globalTransform);
         }
     }
 } // namespace Lina::Graphics
@@ -0,0 +1,679 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/OcclusionCuller.hpp"
+#include "JobSystem/JobSystem.hpp"
+#include "Math/Math.hpp"
+#include <array>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+#if defined(LINA_OCCLUSION_CULL_SSE)
+#include <emmintrin.h>
+#endif
+
+#define OCCLUSION_NEAR_EPSILON 0.00001f
+#define OCCLUSION_TEST_TEXELS  4
+
+// Share of the mesh bounds' volume an inner box has to fill to replace the mesh.
+#define OCCLUDER_INNER_BOX_MIN_FILL 0.1f
+
+namespace Lina::Graphics
+{
+    namespace
+    {
+        // Every edge of a closed surface is shared by exactly two triangles. Positions are welded first, as seams of the
+        // render mesh split vertices without opening the surface.
+        bool IsOccluderClosed(const std::vector<Vector3>& vertices, const std::vector<uint32>& indices)
+        {
+            std::map<std::array<float, 3>, uint32> welded;
+            std::vector<uint32>                    remap(vertices.size());
+            std::unordered_map<uint64, uint32>     edges;
+
+            for (size_t i = 0; i < vertices.size(); i++)
+                remap[i] = welded.emplace(std::array<float, 3>{vertices[i].x, vertices[i].y, vertices[i].z}, (uint32)welded.size()).first->second;
+
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                for (size_t edge = 0; edge < 3; edge++)
+                {
+                    const uint64 a = remap[indices[i + edge]];
+                    const uint64 b = remap[indices[i + (edge + 1) % 3]];
+
+                    if (a != b)
+                        edges[a < b ? (a << 32) | b : (b << 32) | a]++;
+                }
+            }
+
+            for (const auto& [edge, count] : edges)
+            {
+                if (count != 2)
+                    return false;
+            }
+
+            return !edges.empty();
+        }
+
+        // Counts the triangles crossed by rays from the point, an odd count means inside of a closed surface. The directions
+        // are skewed so that they don't run along edges of axis aligned geometry, all of them have to agree.
+        bool IsInsideOccluder(const std::vector<Vector3>& vertices, const std::vector<uint32>& indices, const Vector3& point)
+        {
+            const Vector3 directions[3] = {Vector3(1.0f, 0.0137f, 0.0071f), Vector3(-0.0113f, 1.0f, 0.0193f), Vector3(0.0089f, -0.0151f, -1.0f)};
+
+            for (const Vector3& direction : directions)
+            {
+                uint32 crossings = 0;
+
+                for (size_t i = 0; i + 2 < indices.size(); i += 3)
+                {
+                    const Vector3& v0    = vertices[indices[i]];
+                    const Vector3  edge1 = vertices[indices[i + 1]] - v0;
+                    const Vector3  edge2 = vertices[indices[i + 2]] - v0;
+                    const Vector3  p     = direction.Cross(edge2);
+                    const float    det   = edge1.Dot(p);
+
+                    if (Math::Abs(det) < 1e-12f)
+                        continue;
+
+                    const float   invDet = 1.0f / det;
+                    const Vector3 s      = point - v0;
+                    const float   u      = s.Dot(p) * invDet;
+
+                    if (u < 0.0f || u > 1.0f)
+                        continue;
+
+                    const Vector3 q = s.Cross(edge1);
+                    const float   v = direction.Dot(q) * invDet;
+
+                    if (v < 0.0f || u + v > 1.0f)
+                        continue;
+
+                    if (edge2.Dot(q) * invDet > 0.0f)
+                        crossings++;
+                }
+
+                if (crossings % 2 == 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Separating axis test, touching counts as overlapping.
+        bool OccluderTriangleOverlapsBox(const Vector3& a, const Vector3& b, const Vector3& c, const Vector3& center, const Vector3& halfExtent)
+        {
+            const Vector3 v[3]       = {a - center, b - center, c - center};
+            const Vector3 edges[3]   = {v[1] - v[0], v[2] - v[1], v[0] - v[2]};
+            const Vector3 boxAxes[3] = {Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f), Vector3(0.0f, 0.0f, 1.0f)};
+            Vector3       axes[13]   = {boxAxes[0], boxAxes[1], boxAxes[2], edges[0].Cross(edges[1])};
+            int           axisCount  = 4;
+
+            for (const Vector3& edge : edges)
+            {
+                for (const Vector3& boxAxis : boxAxes)
+                    axes[axisCount++] = edge.Cross(boxAxis);
+            }
+
+            for (const Vector3& axis : axes)
+            {
+                if (axis.Dot(axis) < 1e-12f)
+                    continue;
+
+                const float p0     = axis.Dot(v[0]);
+                const float p1     = axis.Dot(v[1]);
+                const float p2     = axis.Dot(v[2]);
+                const float radius = halfExtent.x * Math::Abs(axis.x) + halfExtent.y * Math::Abs(axis.y) + halfExtent.z * Math::Abs(axis.z);
+
+                if (Math::Min3(p0, p1, p2) > radius || Math::Max3(p0, p1, p2) < -radius)
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool IsOccluderBoxFree(const std::vector<Vector3>& vertices, const std::vector<uint32>& indices, const Vector3& min, const Vector3& max)
+        {
+            const Vector3 center     = (min + max) * 0.5f;
+            const Vector3 halfExtent = (max - min) * 0.5f;
+
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                if (OccluderTriangleOverlapsBox(vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]], center, halfExtent))
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Starts from a small box around a point inside of the closed surface & pushes its faces out one at a time, a push
+        // that would touch a triangle is retried with half the step. The box never crosses the surface, so it stays inside.
+        bool FindInnerOccluderBox(const std::vector<Vector3>& vertices, const std::vector<uint32>& indices, const Vector3& boundsMin, const Vector3& boundsMax, Vector3& outMin, Vector3& outMax)
+        {
+            const Vector3 size    = boundsMax - boundsMin;
+            const float   extent  = Math::Max3(size.x, size.y, size.z);
+            Vector3       average = Vector3::Zero;
+
+            if (extent <= 0.0f)
+                return false;
+
+            for (const Vector3& v : vertices)
+                average = average + v;
+
+            const Vector3 seeds[2] = {(boundsMin + boundsMax) * 0.5f, average / (float)vertices.size()};
+            bool          found    = false;
+
+            for (const Vector3& seed : seeds)
+            {
+                if (!IsInsideOccluder(vertices, indices, seed))
+                    continue;
+
+                for (float half = extent / 64.0f; half >= extent / 4096.0f && !found; half *= 0.5f)
+                {
+                    const Vector3 halfExtent = Vector3(half, half, half);
+                    found                    = IsOccluderBoxFree(vertices, indices, seed - halfExtent, seed + halfExtent);
+                    outMin                   = seed - halfExtent;
+                    outMax                   = seed + halfExtent;
+                }
+
+                if (found)
+                    break;
+            }
+
+            if (!found)
+                return false;
+
+            for (float step = extent / 8.0f; step >= extent / 512.0f; step *= 0.5f)
+            {
+                bool grown = true;
+
+                while (grown)
+                {
+                    grown = false;
+
+                    for (unsigned int face = 0; face < 6; face++)
+                    {
+                        Vector3 min = outMin;
+                        Vector3 max = outMax;
+
+                        if (face % 2 == 0)
+                            min[face / 2] -= step;
+                        else
+                            max[face / 2] += step;
+
+                        if (IsOccluderBoxFree(vertices, indices, min, max))
+                        {
+                            outMin = min;
+                            outMax = max;
+                            grown  = true;
+                        }
+                    }
+                }
+            }
+
+            return true;
+        }
+    } // namespace
+
+    OcclusionCuller::OcclusionCuller(uint32 width, uint32 height, uint32 bandHeight) : m_bandHeight(bandHeight)
+    {
+        SetResolution(width, height);
+    }
+
+    void OcclusionCuller::SetResolution(uint32 width, uint32 height)
+    {
+        m_width  = (Math::Max(width, 4u) + 3) & ~3u;
+        m_height = Math::Max(height, 1u);
+        m_levels.clear();
+
+        // Full resolution level followed by max-depth levels, down to a single texel.
+        uint32 levelWidth  = m_width;
+        uint32 levelHeight = m_height;
+
+        while (true)
+        {
+            DepthLevel level;
+            level.m_width  = levelWidth;
+            level.m_height = levelHeight;
+            level.m_depth.resize(levelWidth * levelHeight, std::numeric_limits<float>::max());
+            m_levels.push_back(level);
+
+            if (levelWidth == 1 && levelHeight == 1)
+                break;
+
+            levelWidth  = (levelWidth + 1) / 2;
+            levelHeight = (levelHeight + 1) / 2;
+        }
+
+        m_bins.resize((m_height + m_bandHeight - 1) / m_bandHeight);
+    }
+
+    void OcclusionCuller::BeginFrame(const Matrix& viewProjection)
+    {
+        m_viewProjection = viewProjection;
+        m_lastFrameStats = m_stats;
+        m_stats          = OcclusionCullerStats();
+
+        for (auto& bin : m_bins)
+            bin.clear();
+
+        // Nothing occludes until rasterized.
+        std::fill(m_levels[0].m_depth.begin(), m_levels[0].m_depth.end(), std::numeric_limits<float>::max());
+    }
+
+    void OcclusionCuller::AddOccluder(const Matrix& model, const std::vector<Vector3>& vertices, const std::vector<uint32>& indices)
+    {
+        const Matrix mvp = m_viewProjection * model;
+        m_clipVertices.resize(vertices.size());
+
+        for (size_t i = 0; i < vertices.size(); i++)
+            m_clipVertices[i] = mvp * glm::vec4(vertices[i].x, vertices[i].y, vertices[i].z, 1.0f);
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const Vector4 triangle[3] = {m_clipVertices[indices[i]], m_clipVertices[indices[i + 1]], m_clipVertices[indices[i + 2]]};
+            AddClippedTriangle(triangle);
+        }
+    }
+
+    void OcclusionCuller::AddClippedTriangle(const Vector4* clip)
+    {
+        // Clip against the near plane, z + w >= 0 in OpenGL clip space.
+        Vector4 polygon[4];
+        int     count = 0;
+
+        for (int i = 0; i < 3; i++)
+        {
+            const Vector4& a  = clip[i];
+            const Vector4& b  = clip[(i + 1) % 3];
+            const float    da = a.z + a.w;
+            const float    db = b.z + b.w;
+
+            if (da >= 0.0f)
+                polygon[count++] = a;
+
+            if ((da >= 0.0f) != (db >= 0.0f))
+            {
+                // Always interpolate from the inside vertex so a neighbour clipping the same edge gets the same point.
+                const Vector4& in   = da >= 0.0f ? a : b;
+                const Vector4& out  = da >= 0.0f ? b : a;
+                const float    din  = da >= 0.0f ? da : db;
+                const float    dout = da >= 0.0f ? db : da;
+                const float    t    = din / (din - dout);
+                polygon[count++]    = Vector4(in.x + (out.x - in.x) * t, in.y + (out.y - in.y) * t, in.z + (out.z - in.z) * t, in.w + (out.w - in.w) * t);
+            }
+        }
+
+        if (count < 3)
+            return;
+
+        float screenX[4], screenY[4], screenZ[4];
+
+        for (int i = 0; i < count; i++)
+        {
+            const float w = Math::Max(polygon[i].w, OCCLUSION_NEAR_EPSILON);
+            screenX[i]    = (polygon[i].x / w * 0.5f + 0.5f) * (float)m_width;
+            screenY[i]    = (polygon[i].y / w * 0.5f + 0.5f) * (float)m_height;
+            screenZ[i]    = polygon[i].z / w;
+        }
+
+        for (int i = 1; i + 1 < count; i++)
+            BinTriangle({{screenX[0], screenX[i], screenX[i + 1]}, {screenY[0], screenY[i], screenY[i + 1]}, {screenZ[0], screenZ[i], screenZ[i + 1]}});
+    }
+
+    void OcclusionCuller::BinTriangle(const ScreenTriangle& triangle)
+    {
+        const float minX = Math::Min3(triangle.m_x[0], triangle.m_x[1], triangle.m_x[2]);
+        const float maxX = Math::Max3(triangle.m_x[0], triangle.m_x[1], triangle.m_x[2]);
+        const float minY = Math::Min3(triangle.m_y[0], triangle.m_y[1], triangle.m_y[2]);
+        const float maxY = Math::Max3(triangle.m_y[0], triangle.m_y[1], triangle.m_y[2]);
+
+        if (maxX < 0.0f || maxY < 0.0f || minX >= (float)m_width || minY >= (float)m_height)
+            return;
+
+        const uint32 firstBand = (uint32)Math::Max(minY, 0.0f) / m_bandHeight;
+        const uint32 lastBand  = (uint32)Math::Min(maxY, (float)(m_height - 1)) / m_bandHeight;
+
+        for (uint32 band = firstBand; band <= lastBand; band++)
+            m_bins[band].push_back(triangle);
+
+        m_stats.m_occluderTriangles++;
+    }
+
+    void OcclusionCuller::RasterizeOccluders()
+    {
+        if (m_stats.m_occluderTriangles == 0)
+            return;
+
+        // Bands own separate rows of the depth buffer, so they can be rasterized without synchronization.
+        ParallelFor(GetSharedExecutor(), (uint32)m_bins.size(), 1, 0, [this](uint32 begin, uint32 end) {
+            for (uint32 band = begin; band < end; band++)
+                RasterizeBand(band);
+        });
+
+        ExpandFarthest();
+        BuildHierarchy();
+    }
+
+    void OcclusionCuller::RasterizeBand(uint32 band)
+    {
+        const uint32 minY = band * m_bandHeight;
+        const uint32 maxY = Math::Min(minY + m_bandHeight, m_height);
+
+        for (const ScreenTriangle& triangle : m_bins[band])
+            RasterizeTriangle(triangle, minY, maxY);
+    }
+
+    void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& tri, uint32 bandMinY, uint32 bandMaxY)
+    {
+        float x[3] = {tri.m_x[0], tri.m_x[1], tri.m_x[2]};
+        float y[3] = {tri.m_y[0], tri.m_y[1], tri.m_y[2]};
+        float z[3] = {tri.m_z[0], tri.m_z[1], tri.m_z[2]};
+
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+
+        if (Math::Abs(area) < 0.0001f)
+            return;
+
+        // Occluders are double sided, make the winding counter clockwise.
+        if (area < 0.0f)
+        {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(z[1], z[2]);
+            area = -area;
+        }
+
+        // Edge functions A * px + B * py + C, positive inside, sampled at pixel centers. Each edge is evaluated from a
+        // canonical vertex order, triangles sharing an edge then get exactly negated values & never both drop a pixel.
+        float edgeA[3], edgeB[3], edgeC[3];
+
+        for (int i = 0; i < 3; i++)
+        {
+            const int   j    = (i + 1) % 3;
+            const bool  flip = x[j] < x[i] || (x[j] == x[i] && y[j] < y[i]);
+            const int   p    = flip ? j : i;
+            const int   q    = flip ? i : j;
+            const float a    = y[p] - y[q];
+            const float b    = x[q] - x[p];
+            const float c    = -(a * x[p] + b * y[p]);
+            edgeA[i]         = flip ? -a : a;
+            edgeB[i]         = flip ? -b : b;
+            edgeC[i]         = flip ? -c : c;
+        }
+
+        const float zdx = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+        const float zdy = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+        const float zc  = z[0] - zdx * x[0] - zdy * y[0];
+
+        const int minX  = Math::Max((int)Math::Min3(x[0], x[1], x[2]), 0) & ~3;
+        const int maxX  = Math::Min((int)Math::Max3(x[0], x[1], x[2]), (int)m_width - 1);
+        const int minY  = Math::Max((int)Math::Min3(y[0], y[1], y[2]), (int)bandMinY);
+        const int maxY  = Math::Min((int)Math::Max3(y[0], y[1], y[2]), (int)bandMaxY - 1);
+        float*    depth = m_levels[0].m_depth.data();
+
+        for (int py = minY; py <= maxY; py++)
+        {
+            const float centerY = (float)py + 0.5f;
+            const float rowE0   = edgeB[0] * centerY + edgeC[0];
+            const float rowE1   = edgeB[1] * centerY + edgeC[1];
+            const float rowE2   = edgeB[2] * centerY + edgeC[2];
+            const float rowZ    = zdy * centerY + zc;
+            float*      row     = depth + py * m_width;
+
+#if defined(LINA_OCCLUSION_CULL_SSE)
+            const __m128 a0     = _mm_set1_ps(edgeA[0]);
+            const __m128 a1     = _mm_set1_ps(edgeA[1]);
+            const __m128 a2     = _mm_set1_ps(edgeA[2]);
+            const __m128 zx     = _mm_set1_ps(zdx);
+            const __m128 zero   = _mm_setzero_ps();
+            const __m128 offset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+
+            for (int px = minX; px <= maxX; px += 4)
+            {
+                const __m128 centerX = _mm_add_ps(_mm_set1_ps((float)px), offset);
+                const __m128 e0      = _mm_add_ps(_mm_mul_ps(a0, centerX), _mm_set1_ps(rowE0));
+                const __m128 e1      = _mm_add_ps(_mm_mul_ps(a1, centerX), _mm_set1_ps(rowE1));
+                const __m128 e2      = _mm_add_ps(_mm_mul_ps(a2, centerX), _mm_set1_ps(rowE2));
+                const __m128 inside  = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+
+                const __m128 pixelZ  = _mm_add_ps(_mm_mul_ps(zx, centerX), _mm_set1_ps(rowZ));
+                const __m128 current = _mm_loadu_ps(row + px);
+                const __m128 nearest = _mm_min_ps(current, pixelZ);
+                _mm_storeu_ps(row + px, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+            }
+#else
+            for (int px = minX; px <= maxX; px++)
+            {
+                const float centerX = (float)px + 0.5f;
+
+                if (edgeA[0] * centerX + rowE0 < 0.0f || edgeA[1] * centerX + rowE1 < 0.0f || edgeA[2] * centerX + rowE2 < 0.0f)
+                    continue;
+
+                row[px] = Math::Min(row[px], zdx * centerX + rowZ);
+            }
+#endif
+        }
+    }
+
+    void OcclusionCuller::ExpandFarthest()
+    {
+        // Pixels were covered by center sampling, which can overshoot a silhouette by up to half a pixel & only stores the
+        // plane depth at the center. Taking the farthest depth of the 3x3 neighbourhood covers the whole pixel area
+        // conservatively, empty pixels grow into their neighbours. Outside of the screen counts as empty, as coverage
+        // there is unknown. Done separably, horizontal pass into the scratch buffer.
+        const float empty = std::numeric_limits<float>::max();
+        DepthLevel& level = m_levels[0];
+        m_scratch.resize(level.m_depth.size());
+
+        for (uint32 y = 0; y < level.m_height; y++)
+        {
+            const float* source = level.m_depth.data() + y * level.m_width;
+            float*       target = m_scratch.data() + y * level.m_width;
+
+            for (uint32 x = 0; x < level.m_width; x++)
+            {
+                const float left  = x == 0 ? empty : source[x - 1];
+                const float right = x + 1 == level.m_width ? empty : source[x + 1];
+                target[x]         = Math::Max3(left, source[x], right);
+            }
+        }
+
+        for (uint32 y = 0; y < level.m_height; y++)
+        {
+            const float* middle = m_scratch.data() + y * level.m_width;
+            float*       target = level.m_depth.data() + y * level.m_width;
+
+            if (y == 0 || y + 1 == level.m_height)
+            {
+                std::fill(target, target + level.m_width, empty);
+                continue;
+            }
+
+            const float* up   = middle - level.m_width;
+            const float* down = middle + level.m_width;
+
+            for (uint32 x = 0; x < level.m_width; x++)
+                target[x] = Math::Max3(up[x], middle[x], down[x]);
+        }
+    }
+
+    void OcclusionCuller::BuildHierarchy()
+    {
+        for (size_t i = 1; i < m_levels.size(); i++)
+        {
+            const DepthLevel& source = m_levels[i - 1];
+            DepthLevel&       target = m_levels[i];
+
+            for (uint32 y = 0; y < target.m_height; y++)
+            {
+                const uint32 y0 = y * 2;
+                const uint32 y1 = Math::Min(y0 + 1, source.m_height - 1);
+
+                for (uint32 x = 0; x < target.m_width; x++)
+                {
+                    const uint32 x0 = x * 2;
+                    const uint32 x1 = Math::Min(x0 + 1, source.m_width - 1);
+                    const float  d0 = Math::Max(source.m_depth[y0 * source.m_width + x0], source.m_depth[y0 * source.m_width + x1]);
+                    const float  d1 = Math::Max(source.m_depth[y1 * source.m_width + x0], source.m_depth[y1 * source.m_width + x1]);
+
+                    target.m_depth[y * target.m_width + x] = Math::Max(d0, d1);
+                }
+            }
+        }
+    }
+
+    bool OcclusionCuller::TestAABB(const Vector3& center, const Vector3& halfExtent)
+    {
+        m_stats.m_testedObjects++;
+
+        if (m_stats.m_occluderTriangles == 0)
+            return true;
+
+        float minX = std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxX = -std::numeric_limits<float>::max();
+        float maxY = -std::numeric_limits<float>::max();
+        float minZ = std::numeric_limits<float>::max();
+
+        for (int i = 0; i < 8; i++)
+        {
+            const glm::vec4 corner = glm::vec4(center.x + ((i & 1) ? halfExtent.x : -halfExtent.x), center.y + ((i & 2) ? halfExtent.y : -halfExtent.y), center.z + ((i & 4) ? halfExtent.z : -halfExtent.z), 1.0f);
+            const glm::vec4 clip   = m_viewProjection * corner;
+
+            // Crossing the near plane, can't be bounded on screen.
+            if (clip.w <= OCCLUSION_NEAR_EPSILON || clip.z < -clip.w)
+                return true;
+
+            const float sx = (clip.x / clip.w * 0.5f + 0.5f) * (float)m_width;
+            const float sy = (clip.y / clip.w * 0.5f + 0.5f) * (float)m_height;
+            minX           = Math::Min(minX, sx);
+            maxX           = Math::Max(maxX, sx);
+            minY           = Math::Min(minY, sy);
+            maxY           = Math::Max(maxY, sy);
+            minZ           = Math::Min(minZ, clip.z / clip.w);
+        }
+
+        // Completely off screen, leave it to frustum culling.
+        if (maxX < 0.0f || maxY < 0.0f || minX >= (float)m_width || minY >= (float)m_height)
+            return true;
+
+        uint32 x0 = (uint32)Math::Max(minX, 0.0f);
+        uint32 y0 = (uint32)Math::Max(minY, 0.0f);
+        uint32 x1 = (uint32)Math::Min(maxX, (float)(m_width - 1));
+        uint32 y1 = (uint32)Math::Min(maxY, (float)(m_height - 1));
+
+        // Pick the finest level where the rectangle covers only a few texels.
+        size_t level = 0;
+
+        while (level + 1 < m_levels.size() && (x1 - x0 >= OCCLUSION_TEST_TEXELS || y1 - y0 >= OCCLUSION_TEST_TEXELS))
+        {
+            x0 >>= 1;
+            y0 >>= 1;
+            x1 >>= 1;
+            y1 >>= 1;
+            level++;
+        }
+
+        const DepthLevel& depth = m_levels[level];
+
+        for (uint32 y = y0; y <= y1; y++)
+        {
+            for (uint32 x = x0; x <= x1; x++)
+            {
+                if (depth.m_depth[y * depth.m_width + x] >= minZ)
+                    return true;
+            }
+        }
+
+        m_stats.m_occludedObjects++;
+        return false;
+    }
+
+    void OcclusionCuller::BuildOccluder(const std::vector<Vector3>& vertices, const std::vector<uint32>& indices, uint32 maxTriangles, std::vector<Vector3>& outVertices, std::vector<uint32>& outIndices)
+    {
+        outVertices.clear();
+        outIndices.clear();
+
+        if (vertices.empty() || indices.size() < 3)
+            return;
+
+        // Grid clustering & edge collapses move vertices outwards on concave parts, only the source triangles or geometry
+        // inside of a closed surface can't hide more than the mesh.
+        if (indices.size() / 3 <= maxTriangles || !IsOccluderClosed(vertices, indices))
+        {
+            outVertices = vertices;
+            outIndices  = indices;
+            return;
+        }
+
+        Vector3 boundsMin = vertices[0];
+        Vector3 boundsMax = vertices[0];
+
+        for (const Vector3& v : vertices)
+        {
+            boundsMin = Vector3(Math::Min(boundsMin.x, v.x), Math::Min(boundsMin.y, v.y), Math::Min(boundsMin.z, v.z));
+            boundsMax = Vector3(Math::Max(boundsMax.x, v.x), Math::Max(boundsMax.y, v.y), Math::Max(boundsMax.z, v.z));
+        }
+
+        const Vector3 boundsSize = boundsMax - boundsMin;
+        Vector3       boxMin, boxMax;
+
+        if (!FindInnerOccluderBox(vertices, indices, boundsMin, boundsMax, boxMin, boxMax))
+        {
+            outVertices = vertices;
+            outIndices  = indices;
+            return;
+        }
+
+        const Vector3 boxSize = boxMax - boxMin;
+
+        // A box hiding only a small part of what the mesh hides isn't worth the saved triangles.
+        if (boxSize.x * boxSize.y * boxSize.z < boundsSize.x * boundsSize.y * boundsSize.z * OCCLUDER_INNER_BOX_MIN_FILL)
+        {
+            outVertices = vertices;
+            outIndices  = indices;
+            return;
+        }
+
+        // Corner i has the max bound on x for bit 0, y for bit 1 & z for bit 2.
+        for (uint32 i = 0; i < 8; i++)
+            outVertices.push_back(Vector3((i & 1) ? boxMax.x : boxMin.x, (i & 2) ? boxMax.y : boxMin.y, (i & 4) ? boxMax.z : boxMin.z));
+
+        const uint32 faces[6][4] = {{0, 2, 6, 4}, {1, 5, 7, 3}, {0, 4, 5, 1}, {2, 3, 7, 6}, {0, 1, 3, 2}, {4, 6, 7, 5}};
+
+        for (const auto& face : faces)
+        {
+            outIndices.insert(outIndices.end(), {face[0], face[1], face[2]});
+            outIndices.insert(outIndices.end(), {face[0], face[2], face[3]});
+        }
+    }
+} // namespace Lina::Graphics
@@ -0,0 +1,75 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/ReflectionProbeCache.hpp"
+
+namespace Lina::Graphics
+{
+    void* ReflectionProbeCache::LoadFromMemory(const std::string& path, unsigned char* data, size_t dataSize)
+    {
+        *this = Resources::LoadArchiveFromMemory<ReflectionProbeCache>(path, data, dataSize);
+        IResource::SetSID(path);
+        return static_cast<void*>(this);
+    }
+
+    void* ReflectionProbeCache::LoadFromFile(const std::string& path)
+    {
+        *this = Resources::LoadArchiveFromFile<ReflectionProbeCache>(path);
+        IResource::SetSID(path);
+        return static_cast<void*>(this);
+    }
+
+    std::string ReflectionProbeCache::GetCachePath(const std::string& levelPath)
+    {
+        return levelPath + ".linaprobecache";
+    }
+
+    uint64 ReflectionProbeCache::HashBytes(uint64 hash, const void* data, size_t size)
+    {
+        const uint8* bytes = static_cast<const uint8*>(data);
+
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+        return hash;
+    }
+
+    uint64 ReflectionProbeCache::GetProbeHash(uint64 sceneHash, const Vector3& location, const Vector2i& resolution)
+    {
+        const float values[3] = {location.x, location.y, location.z};
+        const int   res[2]    = {resolution.x, resolution.y};
+        uint64      hash      = HashBytes(sceneHash, values, sizeof(values));
+        return HashBytes(hash, res, sizeof(res));
+    }
+
+    const ReflectionProbeCacheEntry* ReflectionProbeCache::GetEntry(uint32 probeID, uint64 hash) const
+    {
+        auto it = m_entries.find(probeID);
+        return it == m_entries.end() || it->second.m_hash != hash ? nullptr : &it->second;
+    }
+} // namespace Lina::Graphics
@@ -0,0 +1,147 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/ReflectionProbeLookup.hpp"
+#include "Math/Math.hpp"
+
+namespace Lina::Graphics
+{
+    void ReflectionProbeLookup::Build(const std::vector<ReflectionProbeState>& probes)
+    {
+        m_localProbes.clear();
+        m_globalProbe = -1;
+
+        Vector3 totalMin = Vector3(std::numeric_limits<float>::max());
+        Vector3 totalMax = Vector3(-std::numeric_limits<float>::max());
+
+        for (int i = 0; i < (int)probes.size(); i++)
+        {
+            const ReflectionProbeState& probe = probes[i];
+
+            if (!probe.m_isLocal)
+            {
+                if (m_globalProbe == -1)
+                    m_globalProbe = i;
+                continue;
+            }
+
+            LocalProbe local;
+            local.m_min    = probe.m_location - probe.m_halfExtents;
+            local.m_max    = probe.m_location + probe.m_halfExtents;
+            local.m_volume = probe.m_halfExtents.x * probe.m_halfExtents.y * probe.m_halfExtents.z;
+            local.m_index  = i;
+            m_localProbes.push_back(local);
+            totalMin = Vector3(Math::Min(totalMin.x, local.m_min.x), Math::Min(totalMin.y, local.m_min.y), Math::Min(totalMin.z, local.m_min.z));
+            totalMax = Vector3(Math::Max(totalMax.x, local.m_max.x), Math::Max(totalMax.y, local.m_max.y), Math::Max(totalMax.z, local.m_max.z));
+        }
+
+        const uint32 cellCount = m_cellsPerAxis * m_cellsPerAxis * m_cellsPerAxis;
+        m_cells.resize(cellCount);
+        for (auto& cell : m_cells)
+            cell.clear();
+
+        if (m_localProbes.empty())
+            return;
+
+        // Avoid zero sized cells for flat probes.
+        m_gridMin                = totalMin;
+        const Vector3 totalSize  = totalMax - totalMin;
+        const Vector3 gridExtent = Vector3(Math::Max(totalSize.x, 0.001f), Math::Max(totalSize.y, 0.001f), Math::Max(totalSize.z, 0.001f));
+        m_cellSize               = gridExtent / (float)m_cellsPerAxis;
+
+        const int maxCell = (int)m_cellsPerAxis - 1;
+
+        for (uint32 i = 0; i < (uint32)m_localProbes.size(); i++)
+        {
+            const LocalProbe& local = m_localProbes[i];
+            const Vector3     start = (local.m_min - m_gridMin) / m_cellSize;
+            const Vector3     end   = (local.m_max - m_gridMin) / m_cellSize;
+
+            const int startX = Math::Clamp((int)start.x, 0, maxCell), endX = Math::Clamp((int)end.x, 0, maxCell);
+            const int startY = Math::Clamp((int)start.y, 0, maxCell), endY = Math::Clamp((int)end.y, 0, maxCell);
+            const int startZ = Math::Clamp((int)start.z, 0, maxCell), endZ = Math::Clamp((int)end.z, 0, maxCell);
+
+            for (int x = startX; x <= endX; x++)
+                for (int y = startY; y <= endY; y++)
+                    for (int z = startZ; z <= endZ; z++)
+                        m_cells[ToCellIndex(x, y, z)].push_back(i);
+        }
+    }
+
+    int ReflectionProbeLookup::Resolve(const Vector3& location) const
+    {
+        uint32 cell = 0;
+
+        if (!GetCell(location, cell))
+            return m_globalProbe;
+
+        int   result     = -1;
+        float bestVolume = std::numeric_limits<float>::max();
+
+        for (uint32 localIndex : m_cells[cell])
+        {
+            const LocalProbe& local = m_localProbes[localIndex];
+
+            if (location.x > local.m_min.x && location.x < local.m_max.x && location.y > local.m_min.y && location.y < local.m_max.y && location.z > local.m_min.z && location.z < local.m_max.z)
+            {
+                if (local.m_volume < bestVolume)
+                {
+                    bestVolume = local.m_volume;
+                    result     = local.m_index;
+                }
+            }
+        }
+
+        return result == -1 ? m_globalProbe : result;
+    }
+
+    bool ReflectionProbeLookup::GetCell(const Vector3& location, uint32& outCell) const
+    {
+        if (m_localProbes.empty())
+            return false;
+
+        const Vector3 cell = (location - m_gridMin) / m_cellSize;
+
+        if (cell.x < 0.0f || cell.y < 0.0f || cell.z < 0.0f)
+            return false;
+
+        const float limit = (float)m_cellsPerAxis;
+
+        // Points lying exactly on the max boundary are never contained by a probe anyway.
+        if (cell.x >= limit || cell.y >= limit || cell.z >= limit)
+            return false;
+
+        outCell = ToCellIndex((int)cell.x, (int)cell.y, (int)cell.z);
+        return true;
+    }
+
+    uint32 ReflectionProbeLookup::ToCellIndex(int x, int y, int z) const
+    {
+        return ((uint32)z * m_cellsPerAxis + (uint32)y) * m_cellsPerAxis + (uint32)x;
+    }
+} // namespace Lina::Graphics
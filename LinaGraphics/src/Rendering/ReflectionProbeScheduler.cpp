@@ -0,0 +1,91 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/ReflectionProbeScheduler.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace Lina::Graphics
+{
+    float ReflectionProbeScheduler::GetPriority(const ReflectionProbeState& probe, const Vector3& cameraLocation, uint32 frame) const
+    {
+        // Never captured probes always go first, otherwise older & closer probes are preferred.
+        if (!probe.m_isCaptured)
+            return std::numeric_limits<float>::max();
+
+        const float staleness = (float)(frame - probe.m_lastCaptureFrame);
+        const float distance  = (probe.m_location - cameraLocation).MagnitudeSqrt();
+        return (1.0f + staleness * m_stalenessWeight) / (1.0f + distance * m_distanceWeight);
+    }
+
+    void ReflectionProbeScheduler::Schedule(std::vector<ReflectionProbeState>& probes, const Vector3& cameraLocation, uint32 frame, std::vector<ReflectionFaceCapture>& outCaptures)
+    {
+        outCaptures.clear();
+        m_sortedProbes.clear();
+
+        if (m_faceBudget == 0)
+            return;
+
+        for (uint32 i = 0; i < (uint32)probes.size(); i++)
+        {
+            if (probes[i].m_isDynamic)
+                m_sortedProbes.push_back(std::make_pair(GetPriority(probes[i], cameraLocation, frame), i));
+        }
+
+        // Ties are resolved by index so that the result is deterministic.
+        std::sort(m_sortedProbes.begin(), m_sortedProbes.end(), [](const std::pair<float, uint32>& lhs, const std::pair<float, uint32>& rhs) {
+            return lhs.first == rhs.first ? lhs.second < rhs.second : lhs.first > rhs.first;
+        });
+
+        uint32 remaining = m_faceBudget;
+
+        for (auto& pair : m_sortedProbes)
+        {
+            if (remaining == 0)
+                break;
+
+            ReflectionProbeState& probe = probes[pair.second];
+
+            // Continue from the face we've left off, a probe counts as captured once all of its faces are rendered.
+            while (remaining > 0)
+            {
+                outCaptures.push_back(ReflectionFaceCapture{pair.second, probe.m_nextFace});
+                remaining--;
+                probe.m_nextFace++;
+
+                if (probe.m_nextFace == REFLECTION_PROBE_FACES)
+                {
+                    probe.m_nextFace         = 0;
+                    probe.m_isCaptured       = true;
+                    probe.m_lastCaptureFrame = frame;
+                    break;
+                }
+            }
+        }
+    }
+} // namespace Lina::Graphics
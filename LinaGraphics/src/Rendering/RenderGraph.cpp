@@ -0,0 +1,295 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderGraph.hpp"
+
+#include <algorithm>
+
+namespace Lina::Graphics
+{
+    void RenderGraph::Reset()
+    {
+        m_passes.clear();
+        m_textures.clear();
+        m_physicalTextures.clear();
+        m_stats      = RenderGraphStats();
+        m_isCompiled = false;
+    }
+
+    uint32 RenderGraph::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+    {
+        TextureNode texture;
+        texture.m_name = name;
+        texture.m_desc = desc;
+        m_textures.push_back(texture);
+        m_isCompiled = false;
+        return (uint32)m_textures.size() - 1;
+    }
+
+    uint32 RenderGraph::ImportTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+    {
+        const uint32 texture           = CreateTexture(name, desc);
+        m_textures[texture].m_imported = true;
+        return texture;
+    }
+
+    uint32 RenderGraph::AddPass(const std::string& name, PassExecute execute)
+    {
+        PassNode pass;
+        pass.m_name    = name;
+        pass.m_execute = execute;
+        m_passes.push_back(pass);
+        m_isCompiled = false;
+        return (uint32)m_passes.size() - 1;
+    }
+
+    void RenderGraph::Read(uint32 pass, uint32 texture)
+    {
+        m_passes[pass].m_reads.push_back(texture);
+        m_isCompiled = false;
+    }
+
+    void RenderGraph::Write(uint32 pass, uint32 texture)
+    {
+        m_passes[pass].m_writes.push_back(texture);
+        m_textures[texture].m_producers.push_back(pass);
+        m_isCompiled = false;
+    }
+
+    void RenderGraph::SetSideEffects(uint32 pass)
+    {
+        m_passes[pass].m_sideEffects = true;
+        m_isCompiled                 = false;
+    }
+
+    void RenderGraph::Compile()
+    {
+        m_stats          = RenderGraphStats();
+        m_stats.m_passes = (uint32)m_passes.size();
+
+        CullPasses();
+        CalculateLifetimes();
+        AssignPhysicalTextures();
+
+        m_isCompiled = true;
+    }
+
+    void RenderGraph::CullPasses()
+    {
+        std::vector<uint32> unreferenced;
+
+        for (auto& pass : m_passes)
+        {
+            pass.m_isCulled = false;
+            pass.m_refCount = (uint32)pass.m_writes.size();
+        }
+
+        // Imported textures are read outside the graph.
+        for (auto& texture : m_textures)
+            texture.m_refCount = texture.m_imported ? 1 : 0;
+
+        for (auto& pass : m_passes)
+        {
+            for (uint32 read : pass.m_reads)
+                m_textures[read].m_refCount++;
+        }
+
+        for (uint32 i = 0; i < (uint32)m_textures.size(); i++)
+        {
+            if (m_textures[i].m_refCount == 0)
+                unreferenced.push_back(i);
+        }
+
+        auto cullPass = [&](PassNode& pass) {
+            pass.m_isCulled = true;
+            m_stats.m_culledPasses++;
+
+            for (uint32 read : pass.m_reads)
+            {
+                if (--m_textures[read].m_refCount == 0)
+                    unreferenced.push_back(read);
+            }
+        };
+
+        // Passes without any output would never be needed.
+        for (auto& pass : m_passes)
+        {
+            if (pass.m_refCount == 0 && !pass.m_sideEffects)
+                cullPass(pass);
+        }
+
+        // Walk back from the textures nobody reads, culling the producers that are left without a needed output.
+        while (!unreferenced.empty())
+        {
+            const uint32 texture = unreferenced.back();
+            unreferenced.pop_back();
+
+            for (uint32 producer : m_textures[texture].m_producers)
+            {
+                PassNode& pass = m_passes[producer];
+
+                if (pass.m_isCulled || pass.m_refCount == 0)
+                    continue;
+
+                if (--pass.m_refCount == 0 && !pass.m_sideEffects)
+                    cullPass(pass);
+            }
+        }
+    }
+
+    void RenderGraph::CalculateLifetimes()
+    {
+        for (auto& texture : m_textures)
+        {
+            texture.m_firstUse = RENDERGRAPH_INVALID;
+            texture.m_lastUse  = RENDERGRAPH_INVALID;
+            texture.m_physical = RENDERGRAPH_INVALID;
+        }
+
+        auto use = [this](uint32 texture, uint32 order) {
+            TextureNode& node = m_textures[texture];
+
+            if (node.m_firstUse == RENDERGRAPH_INVALID)
+                node.m_firstUse = order;
+
+            node.m_lastUse = order;
+        };
+
+        // Lifetimes are in the order of the executed passes, culled ones don't extend them.
+        uint32 order = 0;
+        for (auto& pass : m_passes)
+        {
+            if (pass.m_isCulled)
+                continue;
+
+            for (uint32 read : pass.m_reads)
+                use(read, order);
+
+            for (uint32 write : pass.m_writes)
+                use(write, order);
+
+            order++;
+        }
+    }
+
+    void RenderGraph::AssignPhysicalTextures()
+    {
+        std::vector<uint32> transients;
+        std::vector<uint32> physicalLastUse;
+
+        m_physicalTextures.clear();
+
+        for (uint32 i = 0; i < (uint32)m_textures.size(); i++)
+        {
+            const TextureNode& texture = m_textures[i];
+
+            if (!texture.m_imported && texture.m_firstUse != RENDERGRAPH_INVALID)
+            {
+                transients.push_back(i);
+                m_stats.m_memoryBeforeAliasing += GetTextureMemory(texture.m_desc);
+            }
+        }
+
+        std::stable_sort(transients.begin(), transients.end(), [this](uint32 a, uint32 b) { return m_textures[a].m_firstUse < m_textures[b].m_firstUse; });
+
+        // First fit, a physical texture is reused once the last transient assigned to it is no longer used.
+        for (uint32 index : transients)
+        {
+            TextureNode& texture = m_textures[index];
+
+            for (uint32 i = 0; i < (uint32)m_physicalTextures.size(); i++)
+            {
+                if (physicalLastUse[i] < texture.m_firstUse && m_physicalTextures[i] == texture.m_desc)
+                {
+                    texture.m_physical = i;
+                    physicalLastUse[i] = texture.m_lastUse;
+                    break;
+                }
+            }
+
+            if (texture.m_physical == RENDERGRAPH_INVALID)
+            {
+                texture.m_physical = (uint32)m_physicalTextures.size();
+                m_physicalTextures.push_back(texture.m_desc);
+                physicalLastUse.push_back(texture.m_lastUse);
+                m_stats.m_memoryAfterAliasing += GetTextureMemory(texture.m_desc);
+            }
+        }
+
+        m_stats.m_transientTextures = (uint32)transients.size();
+        m_stats.m_physicalTextures  = (uint32)m_physicalTextures.size();
+    }
+
+    void RenderGraph::Execute()
+    {
+        if (!m_isCompiled)
+            Compile();
+
+        for (auto& pass : m_passes)
+        {
+            if (!pass.m_isCulled && pass.m_execute)
+                pass.m_execute();
+        }
+    }
+
+    uint32 RenderGraph::GetPhysicalTexture(uint32 texture) const
+    {
+        return m_textures[texture].m_physical;
+    }
+
+    bool RenderGraph::IsPassCulled(uint32 pass) const
+    {
+        return m_passes[pass].m_isCulled;
+    }
+
+    uint64 RenderGraph::GetTextureMemory(const RenderGraphTextureDesc& desc)
+    {
+        uint64 bytesPerPixel = 4;
+
+        switch (desc.m_internalPixelFormat)
+        {
+        case PixelFormat::FORMAT_R:
+            bytesPerPixel = 1;
+            break;
+        case PixelFormat::FORMAT_RG:
+        case PixelFormat::FORMAT_DEPTH16:
+            bytesPerPixel = 2;
+            break;
+        case PixelFormat::FORMAT_RGB16F:
+        case PixelFormat::FORMAT_RGBA16F:
+            bytesPerPixel = 8;
+            break;
+        default:
+            bytesPerPixel = 4;
+            break;
+        }
+
+        const uint64 faces = desc.m_isCubemap ? 6 : 1;
+        return (uint64)desc.m_size.x * (uint64)desc.m_size.y * bytesPerPixel * (uint64)desc.m_samples * faces;
+    }
+} // namespace Lina::Graphics
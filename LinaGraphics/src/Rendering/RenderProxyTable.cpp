@@ -0,0 +1,318 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderProxyTable.hpp"
+
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
+#include "Rendering/DrawListExtractor.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Mesh.hpp"
+#include "Rendering/Model.hpp"
+#include "Rendering/ModelNode.hpp"
+
+namespace Lina::Graphics
+{
+    void RenderProxyTable::MarkForRebuild(ECS::Entity entity)
+    {
+        m_proxies[entity].m_needsRebuild = true;
+    }
+
+    void RenderProxyTable::Invalidate(ECS::Entity entity)
+    {
+        auto it = m_proxies.find(entity);
+
+        if (it != m_proxies.end())
+            it->second.m_needsRebuild = true;
+    }
+
+    void RenderProxyTable::Remove(ECS::Entity entity)
+    {
+        auto it = m_proxies.find(entity);
+
+        if (it == m_proxies.end())
+            return;
+
+        ReleaseProxy(it->second);
+        m_proxies.erase(it);
+    }
+
+    void RenderProxyTable::Clear()
+    {
+        m_proxies.clear();
+        m_batchLookup.clear();
+        m_opaqueBatches.clear();
+        m_transparentInstances.clear();
+        m_transparentDirty = true;
+    }
+
+    uint32 RenderProxyTable::Sync(entt::registry& reg, DrawListExtractor& extractor, const RenderProxyCallbacks& callbacks)
+    {
+        // Storages are fetched here, fetching them on the workers might create them.
+        auto& nodes = reg.storage<ECS::ModelNodeComponent>();
+        auto& datas = reg.storage<ECS::EntityDataComponent>();
+
+        // Detection only reads the proxies & components, so it runs on the workers. Matrices of moved entities are
+        // also calculated there, changes are then applied in storage order.
+        extractor.Gather((uint32)nodes.size(), m_changeSlices, m_changes, [&](uint32 begin, uint32 end, std::vector<RenderProxyChange>& changes) {
+            const ECS::Entity* entities = nodes.data();
+
+            for (uint32 i = begin; i < end; i++)
+            {
+                const ECS::Entity entity = entities[i];
+                auto              it     = m_proxies.find(entity);
+
+                if (it == m_proxies.end() || !datas.contains(entity))
+                    continue;
+
+                const RenderProxy&        proxy         = it->second;
+                ECS::ModelNodeComponent&  nodeComponent = nodes.get(entity);
+                ECS::EntityDataComponent& data          = datas.get(entity);
+
+                if (proxy.m_needsRebuild || IsProxyOutdated(proxy, nodeComponent, data, entity, callbacks))
+                {
+                    RenderProxyChange& change = changes.emplace_back();
+                    change.m_entity           = entity;
+                    change.m_needsRebuild     = true;
+                }
+                else if (proxy.m_transformVersion != data.GetTransformVersion())
+                {
+                    RenderProxyChange& change = changes.emplace_back();
+                    change.m_entity           = entity;
+                    change.m_model            = data.ToMatrix();
+                    change.m_location         = data.GetLocation();
+                    change.m_transformVersion = data.GetTransformVersion();
+                }
+            }
+        });
+
+        for (const RenderProxyChange& change : m_changes)
+        {
+            RenderProxy& proxy = m_proxies[change.m_entity];
+
+            if (change.m_needsRebuild)
+            {
+                ReleaseProxy(proxy);
+                BuildProxy(proxy, nodes.get(change.m_entity), datas.get(change.m_entity), change.m_entity, callbacks);
+            }
+            else
+                UpdateProxyTransform(proxy, change);
+        }
+
+        m_updatedProxies = (uint32)m_changes.size();
+        return m_updatedProxies;
+    }
+
+    bool RenderProxyTable::IsProxyOutdated(const RenderProxy& proxy, ECS::ModelNodeComponent& nodeComponent, ECS::EntityDataComponent& data, ECS::Entity entity, const RenderProxyCallbacks& callbacks) const
+    {
+        const bool isEnabled = nodeComponent.GetIsEnabled() && data.GetIsEnabled();
+
+        if (isEnabled != proxy.m_isEnabled || nodeComponent.m_model.m_value != proxy.m_model || nodeComponent.m_nodeIndex != proxy.m_nodeIndex)
+            return true;
+
+        // Unloaded materials are nulled out by their handles.
+        for (uint32 i = 0; i < (uint32)proxy.m_meshes.size(); i++)
+        {
+            const RenderProxyMesh& mesh     = proxy.m_meshes[i];
+            Material*              material = i < nodeComponent.m_materials.size() ? nodeComponent.m_materials[i].m_value : nullptr;
+
+            if (material != mesh.m_material)
+                return true;
+
+            if (material != nullptr && (material->GetSurfaceType() != MaterialSurfaceType::Opaque) != mesh.m_isTransparent)
+                return true;
+        }
+
+        return proxy.m_isSkinned && callbacks.m_getPaletteBuffer(entity) != proxy.m_paletteBuffer;
+    }
+
+    void RenderProxyTable::BuildProxy(RenderProxy& proxy, ECS::ModelNodeComponent& nodeComponent, ECS::EntityDataComponent& data, ECS::Entity entity, const RenderProxyCallbacks& callbacks)
+    {
+        proxy.m_model            = nodeComponent.m_model.m_value;
+        proxy.m_nodeIndex        = nodeComponent.m_nodeIndex;
+        proxy.m_isEnabled        = nodeComponent.GetIsEnabled() && data.GetIsEnabled();
+        proxy.m_transformVersion = data.GetTransformVersion();
+        proxy.m_paletteBuffer    = 0;
+        proxy.m_isSkinned        = false;
+        proxy.m_isStaticBatched  = callbacks.m_isStaticBatched(entity);
+        proxy.m_needsRebuild     = false;
+
+        auto* model = proxy.m_model;
+        if (model == nullptr || proxy.m_nodeIndex < 0 || proxy.m_nodeIndex >= (int)model->GetAllNodes().size())
+            return;
+
+        auto* node = model->GetAllNodes()[proxy.m_nodeIndex];
+        if (node == nullptr)
+            return;
+
+        auto& meshes = node->GetMeshes();
+        proxy.m_meshes.resize(meshes.size());
+
+        for (uint32 i = 0; i < meshes.size(); i++)
+        {
+            RenderProxyMesh& proxyMesh = proxy.m_meshes[i];
+            proxyMesh.m_material       = i < nodeComponent.m_materials.size() ? nodeComponent.m_materials[i].m_value : nullptr;
+            proxyMesh.m_isTransparent  = proxyMesh.m_material != nullptr && proxyMesh.m_material->GetSurfaceType() != MaterialSurfaceType::Opaque;
+
+            if (meshes[i]->IsSkinned())
+                proxy.m_isSkinned = true;
+        }
+
+        if (proxy.m_isSkinned)
+            proxy.m_paletteBuffer = callbacks.m_getPaletteBuffer(entity);
+
+        // Static batches draw the entity's meshes.
+        if (!proxy.m_isEnabled || proxy.m_isStaticBatched)
+            return;
+
+        const Matrix finalMatrix = data.ToMatrix();
+
+        for (uint32 i = 0; i < meshes.size(); i++)
+        {
+            RenderProxyMesh& proxyMesh = proxy.m_meshes[i];
+
+            if (proxyMesh.m_material == nullptr)
+                continue;
+
+            BatchDrawData drawData;
+            drawData.m_vertexArray   = &meshes[i]->GetVertexArray();
+            drawData.m_material      = proxyMesh.m_material;
+            drawData.m_paletteBuffer = meshes[i]->IsSkinned() ? proxy.m_paletteBuffer : 0;
+
+            const RenderInstanceOwner owner{entity, i};
+
+            if (proxyMesh.m_isTransparent)
+            {
+                TransparentInstance instance;
+                instance.m_drawData  = drawData;
+                instance.m_model     = finalMatrix;
+                instance.m_location  = data.GetLocation();
+                instance.m_owner     = owner;
+                proxyMesh.m_instance = (uint32)m_transparentInstances.size();
+                m_transparentInstances.push_back(instance);
+                m_transparentDirty = true;
+            }
+            else
+            {
+                auto it = m_batchLookup.find(drawData);
+
+                if (it == m_batchLookup.end())
+                {
+                    it = m_batchLookup.emplace(drawData, (uint32)m_opaqueBatches.size()).first;
+                    m_opaqueBatches.emplace_back();
+                    m_opaqueBatches.back().m_drawData = drawData;
+                }
+
+                RenderBatch& batch   = m_opaqueBatches[it->second];
+                proxyMesh.m_batch    = it->second;
+                proxyMesh.m_instance = (uint32)batch.m_models.size();
+                batch.m_models.push_back(finalMatrix);
+                batch.m_owners.push_back(owner);
+                batch.m_isDirty = true;
+            }
+
+            proxyMesh.m_isRendered = true;
+        }
+    }
+
+    void RenderProxyTable::ReleaseProxy(RenderProxy& proxy)
+    {
+        for (auto& proxyMesh : proxy.m_meshes)
+        {
+            if (proxyMesh.m_isRendered)
+                RemoveInstance(proxyMesh);
+        }
+
+        proxy.m_meshes.clear();
+    }
+
+    void RenderProxyTable::RemoveInstance(RenderProxyMesh& proxyMesh)
+    {
+        // Swap with the last instance & fix up the moved instance's owner.
+        RenderInstanceOwner moved;
+        uint32              last = 0;
+
+        if (proxyMesh.m_isTransparent)
+        {
+            last = (uint32)m_transparentInstances.size() - 1;
+            if (proxyMesh.m_instance != last)
+            {
+                m_transparentInstances[proxyMesh.m_instance] = m_transparentInstances[last];
+                moved                                        = m_transparentInstances[last].m_owner;
+            }
+
+            m_transparentInstances.pop_back();
+            m_transparentDirty = true;
+        }
+        else
+        {
+            RenderBatch& batch = m_opaqueBatches[proxyMesh.m_batch];
+            last               = (uint32)batch.m_models.size() - 1;
+            if (proxyMesh.m_instance != last)
+            {
+                batch.m_models[proxyMesh.m_instance] = batch.m_models[last];
+                batch.m_owners[proxyMesh.m_instance] = batch.m_owners[last];
+                moved                                = batch.m_owners[last];
+            }
+
+            batch.m_models.pop_back();
+            batch.m_owners.pop_back();
+            batch.m_isDirty = true;
+        }
+
+        if (moved.m_entity != entt::null)
+            m_proxies[moved.m_entity].m_meshes[moved.m_mesh].m_instance = proxyMesh.m_instance;
+
+        proxyMesh.m_isRendered = false;
+    }
+
+    void RenderProxyTable::UpdateProxyTransform(RenderProxy& proxy, const RenderProxyChange& change)
+    {
+        proxy.m_transformVersion = change.m_transformVersion;
+
+        for (auto& proxyMesh : proxy.m_meshes)
+        {
+            if (!proxyMesh.m_isRendered)
+                continue;
+
+            if (proxyMesh.m_isTransparent)
+            {
+                TransparentInstance& instance = m_transparentInstances[proxyMesh.m_instance];
+                instance.m_model              = change.m_model;
+                instance.m_location           = change.m_location;
+                m_transparentDirty            = true;
+            }
+            else
+            {
+                RenderBatch& batch                   = m_opaqueBatches[proxyMesh.m_batch];
+                batch.m_models[proxyMesh.m_instance] = change.m_model;
+                batch.m_isDirty                      = true;
+            }
+        }
+    }
+} // namespace Lina::Graphics
@@ -0,0 +1,414 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderStateCache.hpp"
+
+namespace Lina::Graphics
+{
+    void RenderStateCache::Reset(const Vector2i& viewportSize)
+    {
+        m_isDepthTestEnabled          = true;
+        m_usedDepthFunction           = DrawFunc::DRAW_FUNC_LESS;
+        m_shouldWriteDepth            = true;
+        m_isStencilTestEnabled        = true;
+        m_usedStencilFunction         = DrawFunc::DRAW_FUNC_NOT_EQUAL;
+        m_usedStencilComparisonValue  = 1;
+        m_usedStencilTestMask         = 0xFF;
+        m_usedStencilWriteMask        = 0xFF;
+        m_usedStencilFail             = StencilOp::STENCIL_KEEP;
+        m_usedStencilPassButDepthFail = StencilOp::STENCIL_KEEP;
+        m_usedStencilPass             = StencilOp::STENCIL_REPLACE;
+        m_isBlendingEnabled           = false;
+        m_usedSourceBlending          = BlendFunc::BLEND_FUNC_NONE;
+        m_usedDestinationBlending     = BlendFunc::BLEND_FUNC_NONE;
+        m_usedFaceCulling             = FaceCulling::FACE_CULL_NONE;
+        m_isScissorsTestEnabled       = false;
+        m_usedScissor[0]              = 0;
+        m_usedScissor[1]              = 0;
+        m_usedScissor[2]              = (uint32)viewportSize.x;
+        m_usedScissor[3]              = (uint32)viewportSize.y;
+        m_boundViewportPos            = Vector2i(0, 0);
+        m_boundViewportSize           = viewportSize;
+    }
+
+    void RenderStateCache::BeginFrame()
+    {
+        m_lastFrameStats = m_stats;
+        m_stats          = RenderDeviceStats();
+    }
+
+    bool RenderStateCache::SetShader(uint32 shader)
+    {
+        if (shader == m_boundShader)
+        {
+            m_stats.m_skippedBinds++;
+            return false;
+        }
+
+        m_boundShader = shader;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetVAO(uint32 vao)
+    {
+        if (vao == m_boundVAO)
+        {
+            m_stats.m_skippedBinds++;
+            return false;
+        }
+
+        m_boundVAO = vao;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetFBO(uint32 fbo)
+    {
+        if (fbo == m_boundFBO)
+        {
+            m_stats.m_skippedBinds++;
+            return false;
+        }
+
+        m_boundFBO = m_boundReadFBO = m_boundWriteFBO = fbo;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetRBO(uint32 rbo)
+    {
+        if (rbo == m_boundRBO)
+        {
+            m_stats.m_skippedBinds++;
+            return false;
+        }
+
+        m_boundRBO = rbo;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetUBO(uint32 ubo)
+    {
+        if (ubo == m_boundUBO)
+        {
+            m_stats.m_skippedBinds++;
+            return false;
+        }
+
+        m_boundUBO = ubo;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetActiveTextureUnit(uint32 unit)
+    {
+        if (unit == m_activeTextureUnit)
+        {
+            m_stats.m_skippedBinds++;
+            return false;
+        }
+
+        m_activeTextureUnit = unit;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::BindTexture(uint32 target, uint32 texture)
+    {
+        // Only the last target bound on a unit is tracked, binding another target on the same unit always reaches GL.
+        if (m_activeTextureUnit < LINA_GL_CACHED_TEXTURE_UNITS)
+        {
+            TextureUnitState& state = m_textureUnits[m_activeTextureUnit];
+            if (state.m_texture == texture && state.m_target == target)
+            {
+                m_stats.m_skippedBinds++;
+                return false;
+            }
+
+            state.m_target  = target;
+            state.m_texture = texture;
+        }
+
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::BindSampler(uint32 unit, uint32 sampler)
+    {
+        if (unit < LINA_GL_CACHED_TEXTURE_UNITS)
+        {
+            if (m_textureUnits[unit].m_sampler == sampler)
+            {
+                m_stats.m_skippedBinds++;
+                return false;
+            }
+
+            m_textureUnits[unit].m_sampler = sampler;
+        }
+
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    void RenderStateCache::SetBufferBase(uint32 ubo)
+    {
+        m_boundUBO = ubo;
+    }
+
+    void RenderStateCache::SetBlitTargets(uint32 readFBO, uint32 writeFBO)
+    {
+        m_boundReadFBO  = readFBO;
+        m_boundWriteFBO = writeFBO;
+        m_boundFBO      = readFBO == writeFBO ? readFBO : (uint32)-1;
+        m_stats.m_stateCalls += 2;
+    }
+
+    bool RenderStateCache::SetViewport(const Vector2i& pos, const Vector2i& size)
+    {
+        if (pos == m_boundViewportPos && size == m_boundViewportSize)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_boundViewportSize = size;
+        m_boundViewportPos  = pos;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetClearColor(const Color& color)
+    {
+        if (color == m_currentClearColor)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_currentClearColor = color;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetFaceCulling(FaceCulling faceCulling)
+    {
+        // FACE_CULL_NONE in the cache means culling is disabled.
+        if (faceCulling == m_usedFaceCulling)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_usedFaceCulling = faceCulling;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetDepthWrite(bool shouldWrite)
+    {
+        if (shouldWrite == m_shouldWriteDepth)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_shouldWriteDepth = shouldWrite;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetDepthFunc(DrawFunc depthFunc)
+    {
+        if (depthFunc == m_usedDepthFunction)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_usedDepthFunction = depthFunc;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetDepthTestEnable(bool enable)
+    {
+        if (enable == m_isDepthTestEnabled)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_isDepthTestEnabled = enable;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetBlending(BlendFunc sourceBlend, BlendFunc destBlend)
+    {
+        if (sourceBlend == m_usedSourceBlending && destBlend == m_usedDestinationBlending)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_isBlendingEnabled       = sourceBlend != BLEND_FUNC_NONE && destBlend != BLEND_FUNC_NONE;
+        m_usedSourceBlending      = sourceBlend;
+        m_usedDestinationBlending = destBlend;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetStencilTestEnable(bool enable)
+    {
+        if (enable == m_isStencilTestEnabled)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_isStencilTestEnabled = enable;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetStencilFunc(DrawFunc stencilFunc, uint32 stencilTestMask, int32 stencilComparisonVal)
+    {
+        if (stencilFunc == m_usedStencilFunction && stencilTestMask == m_usedStencilTestMask && stencilComparisonVal == m_usedStencilComparisonValue)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_usedStencilComparisonValue = stencilComparisonVal;
+        m_usedStencilTestMask        = stencilTestMask;
+        m_usedStencilFunction        = stencilFunc;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetStencilOp(StencilOp stencilFail, StencilOp stencilPassButDepthFail, StencilOp stencilPass)
+    {
+        if (stencilFail == m_usedStencilFail && stencilPass == m_usedStencilPass && stencilPassButDepthFail == m_usedStencilPassButDepthFail)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_usedStencilFail             = stencilFail;
+        m_usedStencilPass             = stencilPass;
+        m_usedStencilPassButDepthFail = stencilPassButDepthFail;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetStencilWriteMask(uint32 mask)
+    {
+        if (mask == m_usedStencilWriteMask)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_usedStencilWriteMask = mask;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetScissorTestEnable(bool enable)
+    {
+        if (enable == m_isScissorsTestEnabled)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_isScissorsTestEnabled = enable;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    bool RenderStateCache::SetScissorBox(uint32 startX, uint32 startY, uint32 width, uint32 height)
+    {
+        if (m_usedScissor[0] == startX && m_usedScissor[1] == startY && m_usedScissor[2] == width && m_usedScissor[3] == height)
+        {
+            m_stats.m_skippedRenderStates++;
+            return false;
+        }
+
+        m_usedScissor[0] = startX;
+        m_usedScissor[1] = startY;
+        m_usedScissor[2] = width;
+        m_usedScissor[3] = height;
+        m_stats.m_stateCalls++;
+        return true;
+    }
+
+    void RenderStateCache::OnTextureReleased(uint32 texture)
+    {
+        for (uint32 i = 0; i < LINA_GL_CACHED_TEXTURE_UNITS; i++)
+        {
+            if (m_textureUnits[i].m_texture == texture)
+                m_textureUnits[i].m_texture = 0;
+        }
+    }
+
+    void RenderStateCache::OnSamplerReleased(uint32 sampler)
+    {
+        for (uint32 i = 0; i < LINA_GL_CACHED_TEXTURE_UNITS; i++)
+        {
+            if (m_textureUnits[i].m_sampler == sampler)
+                m_textureUnits[i].m_sampler = 0;
+        }
+    }
+
+    void RenderStateCache::OnVAOReleased(uint32 vao)
+    {
+        if (vao == m_boundVAO)
+            m_boundVAO = 0;
+    }
+
+    void RenderStateCache::OnUBOReleased(uint32 ubo)
+    {
+        if (ubo == m_boundUBO)
+            m_boundUBO = 0;
+    }
+
+    void RenderStateCache::OnFBOReleased(uint32 fbo)
+    {
+        if (fbo == m_boundFBO)
+            m_boundFBO = m_boundReadFBO = m_boundWriteFBO = 0;
+    }
+
+    void RenderStateCache::OnRBOReleased(uint32 rbo)
+    {
+        if (rbo == m_boundRBO)
+            m_boundRBO = 0;
+    }
+} // namespace Lina::Graphics
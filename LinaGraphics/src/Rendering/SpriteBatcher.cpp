@@ -0,0 +1,120 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/SpriteBatcher.hpp"
+
+#include "Rendering/TextureAtlas.hpp"
+
+#include <algorithm>
+
+namespace Lina::Graphics
+{
+    void SpriteBatcher::AddSprite(const Matrix& transform, const AtlasRegion& region, uint32 color, int layer, SpriteBlendMode blendMode)
+    {
+        // Layers are biased so that negative layers sort before positive ones.
+        const uint64 key = ((uint64)((uint32)layer ^ 0x80000000u) << 32) | ((uint64)blendMode << 24) | (uint64)(region.m_page & 0xFFFFFFu);
+        m_sortKeys.push_back(std::make_pair(key, (uint32)m_sprites.size()));
+
+        SpriteInstance sprite;
+        for (int i = 0; i < 3; i++)
+        {
+            sprite.m_axisX[i]  = transform[0][i];
+            sprite.m_axisY[i]  = transform[1][i];
+            sprite.m_origin[i] = transform[3][i];
+        }
+
+        for (int i = 0; i < 4; i++)
+            sprite.m_uv[i] = region.m_uv[i];
+
+        sprite.m_color = color;
+        m_sprites.push_back(sprite);
+    }
+
+    void SpriteBatcher::Build()
+    {
+        m_vertices.clear();
+        m_batches.clear();
+
+        // Ties keep the order the sprites were added in.
+        std::sort(m_sortKeys.begin(), m_sortKeys.end());
+        m_vertices.resize(m_sortKeys.size() * 4);
+
+        // Corner offsets along the axes, same winding as the sprite quad mesh.
+        const float cornerX[4] = {-0.5f, -0.5f, 0.5f, 0.5f};
+        const float cornerY[4] = {0.5f, -0.5f, -0.5f, 0.5f};
+
+        uint64 currentKey = 0;
+
+        for (uint32 i = 0; i < (uint32)m_sortKeys.size(); i++)
+        {
+            const uint64          key    = m_sortKeys[i].first;
+            const SpriteInstance& sprite = m_sprites[m_sortKeys[i].second];
+
+            if (m_batches.empty() || key != currentKey || m_batches.back().m_quadCount == SPRITE_BATCH_MAX_QUADS)
+            {
+                SpriteBatch batch;
+                batch.m_layer       = (int)((uint32)(key >> 32) ^ 0x80000000u);
+                batch.m_blendMode   = (SpriteBlendMode)((key >> 24) & 0xFF);
+                batch.m_page        = (uint32)(key & 0xFFFFFF);
+                batch.m_firstVertex = i * 4;
+                m_batches.push_back(batch);
+                currentKey = key;
+            }
+
+            m_batches.back().m_quadCount++;
+
+            const float u[4] = {sprite.m_uv[0], sprite.m_uv[0], sprite.m_uv[2], sprite.m_uv[2]};
+            const float v[4] = {sprite.m_uv[3], sprite.m_uv[1], sprite.m_uv[1], sprite.m_uv[3]};
+
+            SpriteVertex* vertex = &m_vertices[(size_t)i * 4];
+            for (int c = 0; c < 4; c++, vertex++)
+            {
+                for (int axis = 0; axis < 3; axis++)
+                    vertex->m_position[axis] = sprite.m_origin[axis] + sprite.m_axisX[axis] * cornerX[c] + sprite.m_axisY[axis] * cornerY[c];
+
+                vertex->m_uv[0] = u[c];
+                vertex->m_uv[1] = v[c];
+                vertex->m_color = sprite.m_color;
+            }
+        }
+    }
+
+    void SpriteBatcher::Clear()
+    {
+        m_sprites.clear();
+        m_sortKeys.clear();
+        m_vertices.clear();
+        m_batches.clear();
+    }
+
+    uint32 SpriteBatcher::PackColor(float r, float g, float b, float a)
+    {
+        auto toByte = [](float value) { return (uint32)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+        return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+    }
+} // namespace Lina::Graphics
@@ -0,0 +1,327 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/StaticBatchBuilder.hpp"
+
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
+#include "ECS/Components/StaticComponent.hpp"
+#include "JobSystem/JobSystem.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Model.hpp"
+#include "Rendering/ModelNode.hpp"
+#include "Rendering/StaticMesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <tuple>
+
+namespace Lina::Graphics
+{
+    StaticBatchBuilder::~StaticBatchBuilder()
+    {
+        Clear();
+    }
+
+    void StaticBatchBuilder::Clear()
+    {
+        for (auto& chunk : m_chunks)
+            delete chunk.m_mesh;
+
+        m_chunks.clear();
+        m_batchedEntities.clear();
+        m_mergedChunks.clear();
+        m_stats = StaticBatchStats();
+    }
+
+    void StaticBatchBuilder::Build(entt::registry& reg)
+    {
+        Clear();
+
+        // Chunk key is the material, the vertex layout & the grid cell of the mesh's world center. A chunk can't mix
+        // layouts, so meshes with a different one go to their own chunk in the same cell.
+        std::map<std::tuple<Material*, uint32, int, int, int>, uint32> chunkLookup;
+        std::vector<Mesh*>                                              layouts;
+        auto view = reg.view<ECS::EntityDataComponent, ECS::ModelNodeComponent, ECS::StaticComponent>();
+
+        for (auto entity : view)
+        {
+            ECS::StaticComponent&     staticComp    = view.get<ECS::StaticComponent>(entity);
+            ECS::ModelNodeComponent&  nodeComponent = view.get<ECS::ModelNodeComponent>(entity);
+            ECS::EntityDataComponent& data          = view.get<ECS::EntityDataComponent>(entity);
+
+            if (!staticComp.GetIsEnabled() || !nodeComponent.GetIsEnabled() || !data.GetIsEnabled())
+                continue;
+
+            Model* model = nodeComponent.m_model.m_value;
+
+            if (model == nullptr || nodeComponent.m_nodeIndex < 0 || nodeComponent.m_nodeIndex >= (int)model->GetAllNodes().size())
+                continue;
+
+            ModelNode* node = model->GetAllNodes()[nodeComponent.m_nodeIndex];
+
+            if (node == nullptr || node->GetMeshes().empty())
+                continue;
+
+            // Entities are batched as a whole or not at all, so the model node system either draws all of their meshes or none.
+            const auto& meshes   = node->GetMeshes();
+            Mesh*       first    = meshes[0];
+            bool        canBatch = nodeComponent.m_materials.size() >= meshes.size();
+
+            for (uint32 i = 0; canBatch && i < (uint32)meshes.size(); i++)
+            {
+                Material* material = nodeComponent.m_materials[i].m_value;
+
+                if (meshes[i]->IsSkinned() || material == nullptr || material->GetSurfaceType() != MaterialSurfaceType::Opaque)
+                    canBatch = false;
+                else if (meshes[i]->GetBufferElements().empty() || meshes[i]->GetIndices().empty())
+                    canBatch = false;
+                else if (!StaticMesh::IsLayoutCompatible(*meshes[i], *first))
+                    canBatch = false;
+            }
+
+            if (!canBatch)
+                continue;
+
+            uint32 layout = 0;
+            while (layout < (uint32)layouts.size() && !StaticMesh::IsLayoutCompatible(*layouts[layout], *first))
+                layout++;
+
+            if (layout == (uint32)layouts.size())
+                layouts.push_back(first);
+
+            const Matrix      transform = data.ToMatrix();
+            StaticBatchEntity batched;
+            batched.m_model            = model;
+            batched.m_transformVersion = data.GetTransformVersion();
+
+            for (uint32 i = 0; i < (uint32)meshes.size(); i++)
+            {
+                Material*       material = nodeComponent.m_materials[i].m_value;
+                const glm::vec4 center   = transform * glm::vec4(meshes[i]->GetVertexCenter().x, meshes[i]->GetVertexCenter().y, meshes[i]->GetVertexCenter().z, 1.0f);
+                const auto      key      = std::make_tuple(material, layout, (int)std::floor(center.x / m_chunkSize), (int)std::floor(center.y / m_chunkSize), (int)std::floor(center.z / m_chunkSize));
+                auto            it       = chunkLookup.find(key);
+
+                if (it == chunkLookup.end())
+                {
+                    it = chunkLookup.emplace(key, (uint32)m_chunks.size()).first;
+                    m_chunks.emplace_back();
+                    m_chunks.back().m_material = material;
+                }
+
+                StaticBatchSource source;
+                source.m_entity    = entity;
+                source.m_mesh      = meshes[i];
+                source.m_transform = transform;
+                m_chunks[it->second].m_sources.push_back(source);
+
+                batched.m_materials.push_back(material);
+
+                if (std::find(batched.m_chunks.begin(), batched.m_chunks.end(), it->second) == batched.m_chunks.end())
+                    batched.m_chunks.push_back(it->second);
+            }
+
+            m_batchedEntities[entity] = batched;
+        }
+
+        MergeDirtyChunks();
+        UpdateStats();
+    }
+
+    void StaticBatchBuilder::RemoveOutdated(entt::registry& reg, std::vector<ECS::Entity>& outRemoved)
+    {
+        outRemoved.clear();
+        m_mergedChunks.clear();
+
+        for (auto& pair : m_batchedEntities)
+        {
+            if (IsBatchedEntityOutdated(reg, pair.first, pair.second))
+                outRemoved.push_back(pair.first);
+        }
+
+        if (outRemoved.empty())
+            return;
+
+        for (ECS::Entity entity : outRemoved)
+        {
+            for (uint32 chunkIndex : m_batchedEntities[entity].m_chunks)
+            {
+                auto& sources = m_chunks[chunkIndex].m_sources;
+                sources.erase(std::remove_if(sources.begin(), sources.end(), [entity](const StaticBatchSource& source) { return source.m_entity == entity; }), sources.end());
+                m_chunks[chunkIndex].m_isDirty = true;
+            }
+
+            m_batchedEntities.erase(entity);
+        }
+
+        // Only the chunks the entities were a part of are merged again.
+        MergeDirtyChunks();
+        UpdateStats();
+    }
+
+    bool StaticBatchBuilder::IsBatchedEntityOutdated(entt::registry& reg, ECS::Entity entity, const StaticBatchEntity& batched) const
+    {
+        if (!reg.valid(entity))
+            return true;
+
+        ECS::StaticComponent*     staticComp    = reg.try_get<ECS::StaticComponent>(entity);
+        ECS::ModelNodeComponent*  nodeComponent = reg.try_get<ECS::ModelNodeComponent>(entity);
+        ECS::EntityDataComponent* data          = reg.try_get<ECS::EntityDataComponent>(entity);
+
+        if (staticComp == nullptr || nodeComponent == nullptr || data == nullptr)
+            return true;
+
+        if (!staticComp->GetIsEnabled() || !nodeComponent->GetIsEnabled() || !data->GetIsEnabled())
+            return true;
+
+        if (data->GetTransformVersion() != batched.m_transformVersion || nodeComponent->m_model.m_value != batched.m_model)
+            return true;
+
+        // Unloaded materials are nulled out by their handles.
+        if (nodeComponent->m_materials.size() < batched.m_materials.size())
+            return true;
+
+        for (uint32 i = 0; i < (uint32)batched.m_materials.size(); i++)
+        {
+            if (nodeComponent->m_materials[i].m_value != batched.m_materials[i])
+                return true;
+        }
+
+        return false;
+    }
+
+    void StaticBatchBuilder::MergeDirtyChunks()
+    {
+        std::vector<StaticMesh*> merged;
+        m_mergedChunks.clear();
+
+        for (uint32 i = 0; i < (uint32)m_chunks.size(); i++)
+        {
+            if (m_chunks[i].m_isDirty)
+                m_mergedChunks.push_back(i);
+        }
+
+        if (m_mergedChunks.empty())
+            return;
+
+        merged.resize(m_mergedChunks.size(), nullptr);
+
+        // Merging only touches CPU memory, so chunks are merged on the workers.
+        ParallelFor(GetSharedExecutor(), (uint32)m_mergedChunks.size(), 1, 0, [&](uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; i++)
+            {
+                StaticBatchChunk& chunk = m_chunks[m_mergedChunks[i]];
+
+                if (chunk.m_sources.empty())
+                    continue;
+
+                StaticMesh* mesh = new StaticMesh();
+                mesh->CopyLayout(*chunk.m_sources[0].m_mesh);
+
+                for (auto& source : chunk.m_sources)
+                {
+                    source.m_firstIndex = mesh->AppendTransformed(*source.m_mesh, source.m_transform);
+                    source.m_indexCount = (uint32)source.m_mesh->GetIndices().size();
+                }
+
+                merged[i] = mesh;
+            }
+        });
+
+        for (uint32 i = 0; i < (uint32)m_mergedChunks.size(); i++)
+        {
+            StaticBatchChunk& chunk = m_chunks[m_mergedChunks[i]];
+            delete chunk.m_mesh;
+            chunk.m_mesh         = merged[i];
+            chunk.m_isDirty      = false;
+            chunk.m_vertexMemory = 0;
+            chunk.m_indexMemory  = 0;
+
+            if (chunk.m_mesh == nullptr)
+                continue;
+
+            StaticMesh* mesh    = chunk.m_mesh;
+            chunk.m_indexMemory = mesh->GetIndices().size() * sizeof(uint32);
+
+            for (auto& element : mesh->GetBufferElements())
+                chunk.m_vertexMemory += element.m_floatElements.size() * sizeof(float) + element.m_intElements.size() * sizeof(int);
+
+            const AABB& aabb   = mesh->GetAABB();
+            chunk.m_center     = (aabb.m_boundsMin + aabb.m_boundsMax) / 2.0f;
+            chunk.m_halfExtent = aabb.m_boundsHalfExtents;
+        }
+    }
+
+    void StaticBatchBuilder::UpdateStats()
+    {
+        std::set<std::pair<VertexArray*, Material*>> sourcePairs;
+
+        m_stats                   = StaticBatchStats();
+        m_stats.m_batchedEntities = (uint32)m_batchedEntities.size();
+
+        for (auto& chunk : m_chunks)
+        {
+            if (chunk.m_mesh != nullptr)
+            {
+                m_stats.m_chunkDrawCalls++;
+                m_stats.m_vertexMemory += chunk.m_vertexMemory;
+                m_stats.m_indexMemory += chunk.m_indexMemory;
+            }
+
+            for (auto& source : chunk.m_sources)
+                sourcePairs.emplace(&source.m_mesh->GetVertexArray(), chunk.m_material);
+
+            m_stats.m_batchedMeshes += (uint32)chunk.m_sources.size();
+        }
+
+        m_stats.m_sourceDrawCalls = (uint32)sourcePairs.size();
+    }
+
+    bool StaticBatchBuilder::IsBatched(ECS::Entity entity) const
+    {
+        return m_batchedEntities.find(entity) != m_batchedEntities.end();
+    }
+
+    ECS::Entity StaticBatchBuilder::GetSourceEntity(uint32 chunk, uint32 triangle) const
+    {
+        if (chunk >= (uint32)m_chunks.size())
+            return entt::null;
+
+        const uint32 index = triangle * 3;
+
+        for (const auto& source : m_chunks[chunk].m_sources)
+        {
+            if (index >= source.m_firstIndex && index < source.m_firstIndex + source.m_indexCount)
+                return source.m_entity;
+        }
+
+        return entt::null;
+    }
+} // namespace Lina::Graphics
@@ -27,8 +27,128 @@ SOFTWARE.
 */
 
 #include "Rendering/StaticMesh.hpp"
+#include "Math/Math.hpp"
+
+#include <cfloat>
 
 namespace Lina::Graphics
 {
+    bool StaticMesh::IsLayoutCompatible(Mesh& a, Mesh& b)
+    {
+        const auto& elementsA = a.GetBufferElements();
+        const auto& elementsB = b.GetBufferElements();
+
+        if (elementsA.size() != elementsB.size())
+            return false;
+
+        for (size_t i = 0; i < elementsA.size(); i++)
+        {
+            const BufferData& ea = elementsA[i];
+            const BufferData& eb = elementsB[i];
+
+            if (ea.m_elementSize != eb.m_elementSize || ea.m_attrib != eb.m_attrib || ea.m_isFloat != eb.m_isFloat || ea.m_isInstanced != eb.m_isInstanced)
+                return false;
+        }
+
+        return true;
+    }
+
+    void StaticMesh::CopyLayout(Mesh& source)
+    {
+        for (auto& element : source.GetBufferElements())
+            AllocateElement(element.m_elementSize, element.m_attrib, element.m_isFloat, element.m_isInstanced);
+
+        m_mergedMin = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
+        m_mergedMax = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    }
+
+    uint32 StaticMesh::AppendTransformed(Mesh& source, const Matrix& transform)
+    {
+        auto&           sourceElements = source.GetBufferElements();
+        const uint32    baseVertex     = (uint32)(m_bufferElements[0].m_floatElements.size() / m_bufferElements[0].m_elementSize);
+        const uint32    firstIndex     = (uint32)m_indices.size();
+        const glm::mat4 model          = transform;
+        const glm::mat3 directionMat   = glm::mat3(model);
+        const glm::mat3 normalMat      = glm::transpose(glm::inverse(directionMat));
+
+        for (size_t e = 0; e < m_bufferElements.size(); e++)
+        {
+            BufferData&       target = m_bufferElements[e];
+            const BufferData& src    = sourceElements[e];
+
+            // Instanced data isn't stored per vertex.
+            if (target.m_isInstanced)
+                continue;
+
+            if (!target.m_isFloat)
+            {
+                target.m_intElements.insert(target.m_intElements.end(), src.m_intElements.begin(), src.m_intElements.end());
+                continue;
+            }
+
+            const std::vector<float>& in = src.m_floatElements;
+
+            // Positions
+            if (target.m_attrib == 0)
+            {
+                for (size_t i = 0; i + 2 < in.size(); i += 3)
+                {
+                    const glm::vec3 p = glm::vec3(model * glm::vec4(in[i], in[i + 1], in[i + 2], 1.0f));
+                    target.m_floatElements.push_back(p.x);
+                    target.m_floatElements.push_back(p.y);
+                    target.m_floatElements.push_back(p.z);
+                    m_mergedMin = Vector3(Math::Min(m_mergedMin.x, p.x), Math::Min(m_mergedMin.y, p.y), Math::Min(m_mergedMin.z, p.z));
+                    m_mergedMax = Vector3(Math::Max(m_mergedMax.x, p.x), Math::Max(m_mergedMax.y, p.y), Math::Max(m_mergedMax.z, p.z));
+                }
+            }
+            // Normals, tangents & bitangents
+            else if (target.m_attrib >= 2 && target.m_attrib <= 4 && target.m_elementSize == 3)
+            {
+                const glm::mat3& mat = target.m_attrib == 2 ? normalMat : directionMat;
+
+                for (size_t i = 0; i + 2 < in.size(); i += 3)
+                {
+                    glm::vec3   d   = mat * glm::vec3(in[i], in[i + 1], in[i + 2]);
+                    const float len = glm::length(d);
+
+                    if (len > 0.0f)
+                        d /= len;
+
+                    target.m_floatElements.push_back(d.x);
+                    target.m_floatElements.push_back(d.y);
+                    target.m_floatElements.push_back(d.z);
+                }
+            }
+            else
+                target.m_floatElements.insert(target.m_floatElements.end(), in.begin(), in.end());
+        }
+
+        // Mirroring transforms flip the winding.
+        const auto& indices = source.GetIndices();
+        const bool  flip    = glm::determinant(directionMat) < 0.0f;
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            m_indices.push_back(baseVertex + indices[i]);
+            m_indices.push_back(baseVertex + (flip ? indices[i + 2] : indices[i + 1]));
+            m_indices.push_back(baseVertex + (flip ? indices[i + 1] : indices[i + 2]));
+        }
+
+        m_aabb.m_boundsMin         = m_mergedMin;
+        m_aabb.m_boundsMax         = m_mergedMax;
+        m_aabb.m_boundsHalfExtents = (m_mergedMax - m_mergedMin) / 2.0f;
+        m_vertexCenter             = (m_mergedMin + m_mergedMax) / 2.0f;
+        return firstIndex;
+    }
+
+    void StaticMesh::ReleaseCPUData()
+    {
+        for (auto& element : m_bufferElements)
+        {
+            std::vector<float>().swap(element.m_floatElements);
+            std::vector<int>().swap(element.m_intElements);
+        }
 
-}
+        std::vector<uint32>().swap(m_indices);
+    }
+} // namespace Lina::Graphics
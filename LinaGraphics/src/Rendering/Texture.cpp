@@ -159,6 +159,31 @@ namespace Lina::Graphics
         SetSID(path);
     }
 
+    void Texture::ConstructFromPixels(const Vector2i& size, const unsigned char* pixels, SamplerParameters samplerParams, const std::string& path)
+    {
+        m_renderDevice = RenderEngineBackend::Get()->GetRenderDevice();
+        m_bindMode     = TextureBindMode::BINDTEXTURE_TEXTURE2D;
+        m_sampler.Construct(samplerParams, m_bindMode);
+        m_id = m_renderDevice->CreateTexture2D(size, pixels, samplerParams, false, false, Color::White);
+        m_sampler.SetTargetTextureID(m_id);
+        m_size         = size;
+        m_isCompressed = false;
+        m_isEmpty      = false;
+        m_hasMipMaps   = samplerParams.m_textureParams.m_generateMipMaps;
+        SetSID(path);
+    }
+
+    void Texture::PackIntoSpriteAtlas()
+    {
+        if (!m_assetData->m_packIntoAtlas)
+            return;
+
+        // Sprites are drawn from the atlas, the pixels aren't needed once they are copied.
+        RenderEngineBackend::Get()->GetSpriteRendererSystem()->GetAtlas().AddImage(m_sid, (uint32)m_bitmap->GetWidth(), (uint32)m_bitmap->GetHeight(), (uint32)m_numComponents, m_bitmap->GetPixelArray());
+        delete m_bitmap;
+        m_bitmap = nullptr;
+    }
+
     void* Texture::LoadFromMemory(const std::string& path, unsigned char* data, size_t dataSize)
     {
         LINA_TRACE("[Texture Loader - Memory] -> Loading: {0}", path);
@@ -184,6 +209,7 @@ namespace Lina::Graphics
         GetCreateAssetdata<ImageAssetData>(assetDataPath, m_assetData);
 
         Construct(m_assetData->m_samplerParameters, false, path);
+        PackIntoSpriteAtlas();
 
         // Return
         return static_cast<void*>(this);
@@ -214,6 +240,7 @@ namespace Lina::Graphics
         GetCreateAssetdata<ImageAssetData>(assetDataPath, m_assetData);
 
         Construct(m_assetData->m_samplerParameters, false, path);
+        PackIntoSpriteAtlas();
 
         // Return
         return static_cast<void*>(this);
@@ -0,0 +1,209 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/TextureAtlas.hpp"
+
+#include "Log/Log.hpp"
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "Utility/stb/stb_rect_pack.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Lina::Graphics
+{
+    struct TextureAtlas::Page
+    {
+        stbrp_context           m_context;
+        std::vector<stbrp_node> m_nodes;
+        uint64                  m_usedArea = 0;
+    };
+
+    TextureAtlas::TextureAtlas(uint32 pageSize, uint32 padding) : m_pageSize(pageSize), m_padding(padding)
+    {
+    }
+
+    TextureAtlas::~TextureAtlas()
+    {
+        Clear();
+    }
+
+    bool TextureAtlas::AddImage(StringIDType sid, uint32 width, uint32 height, uint32 components, const uint8* pixels)
+    {
+        if (m_regions.find(sid) != m_regions.end())
+            return false;
+
+        for (const PendingImage& pending : m_pending)
+        {
+            if (pending.m_sid == sid)
+                return false;
+        }
+
+        const uint32 paddedWidth  = width + m_padding * 2;
+        const uint32 paddedHeight = height + m_padding * 2;
+
+        if (width == 0 || height == 0 || components == 0 || components > 4 || paddedWidth > m_pageSize || paddedHeight > m_pageSize)
+        {
+            LINA_WARN("[Texture Atlas] -> Image {0} with size {1}x{2} can not be packed into {3}x{3} pages.", sid, width, height, m_pageSize);
+            return false;
+        }
+
+        PendingImage& pending     = m_pending.emplace_back();
+        pending.m_sid             = sid;
+        pending.m_width           = width;
+        pending.m_height          = height;
+        pending.m_upload.m_width  = paddedWidth;
+        pending.m_upload.m_height = paddedHeight;
+        CopyImage(pending.m_upload, width, height, components, pixels);
+        return true;
+    }
+
+    void TextureAtlas::Pack()
+    {
+        if (m_pending.empty())
+            return;
+
+        // Same order as stb_rect_pack's own sort, the id makes it independent of the order the images were added in.
+        std::sort(m_pending.begin(), m_pending.end(), [](const PendingImage& a, const PendingImage& b) {
+            if (a.m_upload.m_height != b.m_upload.m_height)
+                return a.m_upload.m_height > b.m_upload.m_height;
+            if (a.m_upload.m_width != b.m_upload.m_width)
+                return a.m_upload.m_width > b.m_upload.m_width;
+            return a.m_sid < b.m_sid;
+        });
+
+        const float size = (float)m_pageSize;
+
+        for (PendingImage& pending : m_pending)
+        {
+            stbrp_rect rect;
+            rect.id = 0;
+            rect.w  = (stbrp_coord)pending.m_upload.m_width;
+            rect.h  = (stbrp_coord)pending.m_upload.m_height;
+
+            uint32 pageIndex = 0;
+            for (; pageIndex < (uint32)m_pages.size(); pageIndex++)
+            {
+                rect.was_packed = 0;
+                stbrp_pack_rects(&m_pages[pageIndex]->m_context, &rect, 1);
+                if (rect.was_packed)
+                    break;
+            }
+
+            if (pageIndex == (uint32)m_pages.size())
+            {
+                Page* page = new Page();
+                page->m_nodes.resize(m_pageSize);
+                stbrp_init_target(&page->m_context, (int)m_pageSize, (int)m_pageSize, page->m_nodes.data(), (int)m_pageSize);
+                m_pages.push_back(page);
+
+                rect.was_packed = 0;
+                stbrp_pack_rects(&page->m_context, &rect, 1);
+            }
+
+            m_pages[pageIndex]->m_usedArea += (uint64)pending.m_upload.m_width * pending.m_upload.m_height;
+
+            AtlasRegion& region = m_regions[pending.m_sid];
+            region.m_page       = pageIndex;
+            region.m_uv[0]      = (float)(rect.x + m_padding) / size;
+            region.m_uv[1]      = (float)(rect.y + m_padding) / size;
+            region.m_uv[2]      = (float)(rect.x + m_padding + pending.m_width) / size;
+            region.m_uv[3]      = (float)(rect.y + m_padding + pending.m_height) / size;
+
+            pending.m_upload.m_page = pageIndex;
+            pending.m_upload.m_x    = (uint32)rect.x;
+            pending.m_upload.m_y    = (uint32)rect.y;
+            m_uploads.push_back(std::move(pending.m_upload));
+        }
+
+        m_pending.clear();
+    }
+
+    void TextureAtlas::CopyImage(AtlasUpload& upload, uint32 width, uint32 height, uint32 components, const uint8* pixels)
+    {
+        upload.m_pixels.resize((size_t)upload.m_width * upload.m_height * 4);
+        uint8* dst = upload.m_pixels.data();
+
+        // Padding pixels repeat the closest edge pixel of the image.
+        for (uint32 row = 0; row < upload.m_height; row++)
+        {
+            const uint32 srcRow = row < m_padding ? 0 : (row - m_padding >= height ? height - 1 : row - m_padding);
+
+            for (uint32 column = 0; column < upload.m_width; column++, dst += 4)
+            {
+                const uint32 srcColumn = column < m_padding ? 0 : (column - m_padding >= width ? width - 1 : column - m_padding);
+                const uint8* src       = &pixels[((size_t)srcRow * width + srcColumn) * components];
+
+                if (components == 4)
+                    std::memcpy(dst, src, 4);
+                else if (components == 3)
+                {
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                    dst[3] = 255;
+                }
+                else
+                {
+                    dst[0] = dst[1] = dst[2] = src[0];
+                    dst[3]                   = components == 2 ? src[1] : 255;
+                }
+            }
+        }
+    }
+
+    void TextureAtlas::Clear()
+    {
+        for (Page* page : m_pages)
+            delete page;
+
+        m_pages.clear();
+        m_regions.clear();
+        m_pending.clear();
+        m_uploads.clear();
+    }
+
+    void TextureAtlas::ClearUploads()
+    {
+        m_uploads.clear();
+        m_uploads.shrink_to_fit();
+    }
+
+    const AtlasRegion* TextureAtlas::GetRegion(StringIDType sid) const
+    {
+        auto it = m_regions.find(sid);
+        return it == m_regions.end() ? nullptr : &it->second;
+    }
+
+    float TextureAtlas::GetOccupancy(uint32 page) const
+    {
+        return (float)((double)m_pages[page]->m_usedArea / ((double)m_pageSize * m_pageSize));
+    }
+} // namespace Lina::Graphics
@@ -35,7 +35,9 @@ namespace Lina::Graphics
 
     VertexArray::~VertexArray()
     {
-        m_engineBoundID = m_renderDevice->ReleaseVertexArray(m_engineBoundID);
+        // Meshes built headless never create their vertex array.
+        if (m_renderDevice != nullptr)
+            m_engineBoundID = m_renderDevice->ReleaseVertexArray(m_engineBoundID);
     }
 
     void VertexArray::UpdateBuffer(uint32 bufferIndex, const void* data, uintptr dataSize)
@@ -0,0 +1,128 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/ViewCuller.hpp"
+
+#include "ECS/Systems/SpatialIndexSystem.hpp"
+
+namespace Lina::Graphics
+{
+    uint32 ViewCuller::Cull(const Frustum& frustum, const DynamicAABBTree& tree, const std::vector<ECS::SpatialProxy>& proxies, uint32 entityCapacity)
+    {
+        uint32 visibleMeshes = 0;
+
+        m_bounds.Clear();
+        m_visibleProxies.clear();
+
+        m_visibilityCapacity = entityCapacity;
+        m_visibility.assign((m_visibilityCapacity + 31) / 32, 0);
+
+        // Broad phase on the shared executor, subtrees completely inside the frustum are visible as a whole, the rest are
+        // tested precisely below.
+        tree.QueryFrustumParallel(GetSharedExecutor(), frustum, m_treeQuery, m_insideProxies, m_boundsProxies);
+
+        for (int proxyID : m_insideProxies)
+        {
+            const ECS::SpatialProxy& proxy = proxies[proxyID];
+            const uint32             index = (uint32)entt::to_entity(proxy.m_entity);
+            m_visibility[index >> 5] |= 1u << (index & 31);
+            m_visibleProxies.push_back(proxyID);
+            visibleMeshes += proxy.m_meshCount;
+        }
+
+        for (int proxyID : m_boundsProxies)
+        {
+            const ECS::SpatialProxy& proxy = proxies[proxyID];
+            m_bounds.Add(proxy.m_center, proxy.m_halfExtent);
+        }
+
+        FrustumCuller::Cull(frustum, m_bounds, m_boundsVisibility);
+
+        // Scatter into a bitset indexed by entity so that other systems can query it without knowing the iteration order.
+        for (uint32 i = 0; i < (uint32)m_boundsProxies.size(); i++)
+        {
+            if (FrustumCuller::IsVisible(m_boundsVisibility, i))
+            {
+                const ECS::SpatialProxy& proxy = proxies[m_boundsProxies[i]];
+                const uint32             index = (uint32)entt::to_entity(proxy.m_entity);
+                m_visibility[index >> 5] |= 1u << (index & 31);
+                m_visibleProxies.push_back(m_boundsProxies[i]);
+                visibleMeshes += proxy.m_meshCount;
+            }
+        }
+
+        return visibleMeshes;
+    }
+
+    void ViewCuller::Hide(ECS::Entity entity)
+    {
+        const uint32 index = (uint32)entt::to_entity(entity);
+
+        if (index < m_visibilityCapacity)
+            m_visibility[index >> 5] &= ~(1u << (index & 31));
+    }
+
+    void ViewCuller::Clear()
+    {
+        m_visibilityCapacity = 0;
+        m_visibleProxies.clear();
+        m_visibility.clear();
+    }
+
+    void ViewCuller::CommitCamera()
+    {
+        UpdateVersion();
+        m_cameraVisibility = m_visibility;
+        m_cameraCapacity   = m_visibilityCapacity;
+        m_cameraVersion    = m_version;
+    }
+
+    void ViewCuller::CommitView()
+    {
+        UpdateVersion();
+    }
+
+    void ViewCuller::RestoreCamera()
+    {
+        // Lists built for a view see a different version & are rebuilt, the counter keeps later changes from reusing it.
+        m_visibility         = m_cameraVisibility;
+        m_previousVisibility = m_cameraVisibility;
+        m_visibilityCapacity = m_cameraCapacity;
+        m_version            = m_cameraVersion;
+    }
+
+    void ViewCuller::UpdateVersion()
+    {
+        // Lets the consumers skip rebuilding their visible lists when nothing has entered or left the view.
+        if (m_visibility != m_previousVisibility)
+        {
+            m_previousVisibility = m_visibility;
+            m_version            = ++m_versionCounter;
+        }
+    }
+} // namespace Lina::Graphics
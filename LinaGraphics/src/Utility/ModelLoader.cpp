@@ -28,10 +28,14 @@ SOFTWARE.
 
 #include "Utility/ModelLoader.hpp"
 
+#include "Animation/Animation.hpp"
+#include "Animation/AnimationCompressor.hpp"
+#include "Animation/Skeleton.hpp"
 #include "Log/Log.hpp"
 #include "Math/Math.hpp"
 #include "Rendering/Mesh.hpp"
 #include "Rendering/Model.hpp"
+#include "Rendering/OcclusionCuller.hpp"
 #include "Rendering/RenderingCommon.hpp"
 #include "Utility/AssimpUtility.hpp"
 #include "Utility/UtilityFunctions.hpp"
@@ -44,9 +48,11 @@ SOFTWARE.
 #include <fstream>
 #include <iostream>
 
+#define OCCLUDER_MAX_TRIANGLES 256
+
 namespace Lina::Graphics
 {
-    void ModelLoader::FillMeshData(const aiMesh* aiMesh, Mesh* linaMesh)
+    void ModelLoader::FillMeshData(const aiMesh* aiMesh, Mesh* linaMesh, const Skeleton& skeleton, bool buildOccluder)
     {
         // Build and indexed aiMesh for each aiMesh & fill in the data.
         linaMesh->SetName(aiMesh->mName.C_Str());
@@ -69,6 +75,34 @@ namespace Lina::Graphics
         {
             vertexBoneIDs.resize(aiMesh->mNumVertices, std::vector<int>(4, -1));
             vertexBoneWeights.resize(aiMesh->mNumVertices, std::vector<float>(4, 0.0f));
+
+            // Bone ids are the joint indices in the model's skeleton.
+            for (uint32 i = 0; i < aiMesh->mNumBones; i++)
+            {
+                const aiBone* bone  = aiMesh->mBones[i];
+                const int     joint = skeleton.GetJointIndex(bone->mName.C_Str());
+
+                if (joint < 0 || joint >= MAX_BONES)
+                    continue;
+
+                for (uint32 j = 0; j < bone->mNumWeights; j++)
+                {
+                    const aiVertexWeight& vertexWeight = bone->mWeights[j];
+                    SetVertexBoneData(vertexBoneIDs[vertexWeight.mVertexId], vertexBoneWeights[vertexWeight.mVertexId], joint, vertexWeight.mWeight);
+                }
+            }
+
+            // Weights of the dropped influences are redistributed.
+            for (auto& weights : vertexBoneWeights)
+            {
+                const float total = weights[0] + weights[1] + weights[2] + weights[3];
+
+                if (total > 0.0f)
+                {
+                    for (float& weight : weights)
+                        weight /= total;
+                }
+            }
         }
 
         Vector3 maxVertexPos = Vector3(-1000.0f, -1000.0f, -1000.0f);
@@ -137,6 +171,18 @@ namespace Lina::Graphics
         linaMesh->GetAABB().m_boundsMax         = maxVertexPos;
         linaMesh->m_vertexCenter                = (minVertexPos + maxVertexPos) / 2.0f;
         linaMesh->GetAABB().m_boundsHalfExtents = (maxVertexPos - minVertexPos) / 2.0f;
+
+        // Occluder geometry is only kept for models marked as occluders.
+        if (!buildOccluder)
+            return;
+
+        std::vector<Vector3> positions;
+        positions.reserve(aiMesh->mNumVertices);
+
+        for (uint32 i = 0; i < aiMesh->mNumVertices; i++)
+            positions.push_back(Vector3(aiMesh->mVertices[i].x, aiMesh->mVertices[i].y, aiMesh->mVertices[i].z));
+
+        OcclusionCuller::BuildOccluder(positions, linaMesh->m_indices, OCCLUDER_MAX_TRIANGLES, linaMesh->m_occluderVertices, linaMesh->m_occluderIndices);
     }
 
     bool ModelLoader::LoadModel(const aiScene* scene, Model* model)
@@ -147,6 +193,10 @@ namespace Lina::Graphics
         model->m_numMeshes     = scene->mNumMeshes;
         model->m_numAnimations = scene->mNumAnimations;
 
+        // Skeleton first, mesh data refers to its joints.
+        if (LoadSkeleton(scene, model->m_skeleton))
+            LoadAnimations(scene, model->m_skeleton);
+
         // Load the ai hierarchy into the root node.
         model->m_rootNode = new ModelNode();
         model->m_rootNode->FillNodeHierarchy(scene->mRootNode, scene, model);
@@ -303,14 +353,149 @@ namespace Lina::Graphics
 
     void ModelLoader::SetVertexBoneData(std::vector<int>& vertexBoneIDs, std::vector<float>& vertexBoneWeights, int boneID, float weight)
     {
-        for (int i = 0; i < 4; ++i)
+        // Take the first free slot, if all are taken replace the weakest influence.
+        int slot = 0;
+        for (int i = 0; i < MAX_BONE_INFLUENCE; ++i)
         {
             if (vertexBoneIDs[i] < 0)
             {
-                vertexBoneIDs[i]     = boneID;
-                vertexBoneWeights[i] = weight;
+                slot = i;
                 break;
             }
+
+            if (vertexBoneWeights[i] < vertexBoneWeights[slot])
+                slot = i;
+        }
+
+        if (vertexBoneIDs[slot] >= 0 && vertexBoneWeights[slot] >= weight)
+            return;
+
+        vertexBoneIDs[slot]     = boneID;
+        vertexBoneWeights[slot] = weight;
+    }
+
+    bool ModelLoader::LoadSkeleton(const aiScene* scene, Skeleton& skeleton)
+    {
+        std::map<std::string, Matrix> inverseBindPoses;
+
+        for (uint32 i = 0; i < scene->mNumMeshes; i++)
+        {
+            const aiMesh* mesh = scene->mMeshes[i];
+            for (uint32 j = 0; j < mesh->mNumBones; j++)
+                inverseBindPoses[mesh->mBones[j]->mName.C_Str()] = AssimpToLinaMatrix(mesh->mBones[j]->mOffsetMatrix);
+        }
+
+        if (inverseBindPoses.empty())
+            return false;
+
+        // Bones & all of their ancestors are joints, so that the hierarchy is complete up to the root.
+        std::set<const aiNode*> requiredNodes;
+        for (auto& [name, inverseBindPose] : inverseBindPoses)
+        {
+            for (const aiNode* node = scene->mRootNode->FindNode(name.c_str()); node != nullptr; node = node->mParent)
+            {
+                if (!requiredNodes.insert(node).second)
+                    break;
+            }
+        }
+
+        AddSkeletonJoints(scene->mRootNode, -1, requiredNodes, inverseBindPoses, skeleton);
+
+        if (skeleton.GetJointCount() > MAX_BONES)
+            LINA_WARN("[Model Loader] -> Skeleton has {0} joints, only the first {1} will be skinned.", skeleton.GetJointCount(), MAX_BONES);
+
+        return skeleton.IsLoaded();
+    }
+
+    void ModelLoader::AddSkeletonJoints(const aiNode* node, int parent, const std::set<const aiNode*>& requiredNodes, const std::map<std::string, Matrix>& inverseBindPoses, Skeleton& skeleton)
+    {
+        int joint = parent;
+
+        if (requiredNodes.find(node) != requiredNodes.end())
+        {
+            aiVector3D   scale, position;
+            aiQuaternion rotation;
+            node->mTransformation.Decompose(scale, rotation, position);
+
+            JointTransform bindPose;
+            bindPose.m_translation[0] = position.x;
+            bindPose.m_translation[1] = position.y;
+            bindPose.m_translation[2] = position.z;
+            bindPose.m_rotation[0]    = rotation.x;
+            bindPose.m_rotation[1]    = rotation.y;
+            bindPose.m_rotation[2]    = rotation.z;
+            bindPose.m_rotation[3]    = rotation.w;
+            bindPose.m_scale[0]       = scale.x;
+            bindPose.m_scale[1]       = scale.y;
+            bindPose.m_scale[2]       = scale.z;
+
+            // Nodes that aren't bones don't deform any vertices.
+            auto         it              = inverseBindPoses.find(node->mName.C_Str());
+            const Matrix inverseBindPose = it == inverseBindPoses.end() ? Matrix::Identity() : it->second;
+            joint                        = skeleton.AddJoint(node->mName.C_Str(), parent, bindPose, inverseBindPose);
+        }
+
+        for (uint32 i = 0; i < node->mNumChildren; i++)
+            AddSkeletonJoints(node->mChildren[i], joint, requiredNodes, inverseBindPoses, skeleton);
+    }
+
+    void ModelLoader::LoadAnimations(const aiScene* scene, Skeleton& skeleton)
+    {
+        for (uint32 i = 0; i < scene->mNumAnimations; i++)
+        {
+            const aiAnimation* aiAnim         = scene->mAnimations[i];
+            const double       ticksPerSecond = aiAnim->mTicksPerSecond != 0.0 ? aiAnim->mTicksPerSecond : 25.0;
+            const std::string  name           = aiAnim->mName.length > 0 ? aiAnim->mName.C_Str() : "Animation_" + std::to_string(i);
+
+            Animation* animation = new Animation();
+            animation->SetName(name);
+            animation->SetDuration((float)(aiAnim->mDuration / ticksPerSecond));
+
+            std::vector<float>        translationTimes, rotationTimes, scaleTimes;
+            std::vector<AnimationKey> translations, rotations, scales;
+
+            for (uint32 j = 0; j < aiAnim->mNumChannels; j++)
+            {
+                const aiNodeAnim* channel = aiAnim->mChannels[j];
+                const int         joint   = skeleton.GetJointIndex(channel->mNodeName.C_Str());
+
+                if (joint < 0)
+                    continue;
+
+                translationTimes.clear();
+                rotationTimes.clear();
+                scaleTimes.clear();
+                translations.clear();
+                rotations.clear();
+                scales.clear();
+
+                for (uint32 k = 0; k < channel->mNumPositionKeys; k++)
+                {
+                    const aiVectorKey& key = channel->mPositionKeys[k];
+                    translationTimes.push_back((float)(key.mTime / ticksPerSecond));
+                    translations.push_back(AnimationKey{{key.mValue.x, key.mValue.y, key.mValue.z, 0.0f}});
+                }
+
+                for (uint32 k = 0; k < channel->mNumRotationKeys; k++)
+                {
+                    const aiQuatKey& key = channel->mRotationKeys[k];
+                    rotationTimes.push_back((float)(key.mTime / ticksPerSecond));
+                    rotations.push_back(AnimationKey{{key.mValue.x, key.mValue.y, key.mValue.z, key.mValue.w}});
+                }
+
+                for (uint32 k = 0; k < channel->mNumScalingKeys; k++)
+                {
+                    const aiVectorKey& key = channel->mScalingKeys[k];
+                    scaleTimes.push_back((float)(key.mTime / ticksPerSecond));
+                    scales.push_back(AnimationKey{{key.mValue.x, key.mValue.y, key.mValue.z, 0.0f}});
+                }
+
+                animation->AddTrack((uint32)joint, translationTimes, translations, rotationTimes, rotations, scaleTimes, scales);
+            }
+
+            const AnimationCompressionStats stats = AnimationCompressor::Compress(skeleton, *animation);
+            LINA_TRACE("[Model Loader] -> Compressed animation {0}, {1} -> {2} bytes, ratio {3}, max error {4}", animation->GetName(), stats.m_rawSize, stats.m_compressedSize, stats.m_ratio, stats.m_maxError);
+            skeleton.AddAnimation(animation);
         }
     }
 } // namespace Lina::Graphics
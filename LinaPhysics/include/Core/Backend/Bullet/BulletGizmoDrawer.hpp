@@ -33,7 +33,7 @@ SOFTWARE.
 
 #define BT_NO_SIMD_OPERATOR_OVERLOADS
 #include "btBulletDynamicsCommon.h"
-#include "EventSystem/Events.hpp"
+#include "EventSystem/GraphicsEvents.hpp"
 #include "Math/Vector.hpp"
 #include "Math/Color.hpp"
 #include <functional>
@@ -30,6 +30,7 @@ SOFTWARE.
 Class: BulletPhysicsEngine
 
 Responsible for initializing, running and cleaning up the physics world. Also a wrapper for bt3.
+The world is multithreaded, its parallel loops run on the shared executor through BulletTaskScheduler.
 
 Timestamp: 5/1/2019 2:35:28 AM
 */
@@ -43,9 +44,15 @@ Timestamp: 5/1/2019 2:35:28 AM
 #define BT_NO_SIMD_OPERATOR_OVERLOADS
 #include "ECS/Systems/RigidbodySystem.hpp"
 #include "Core/Backend/Bullet/BulletGizmoDrawer.hpp"
-#include "ECS/Components/AABBComponent.hpp"
+#include "Core/Backend/Bullet/BulletTaskScheduler.hpp"
 #include "ECS/Components/PhysicsComponent.hpp"
+#include "ECS/SystemList.hpp"
+#include "Physics/SceneQuery.hpp"
 #include "btBulletDynamicsCommon.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include <vector>
 
 namespace Lina
 {
@@ -68,15 +75,43 @@ namespace Lina::Physics
 
 		btRigidBody* GetActiveRigidbody(ECS::Entity ent) { return s_bodies[ent]; }
 		void SetDebugDraw(bool enabled) { m_debugDrawEnabled = enabled; }
-		void SetBodySimulation(ECS::Entity body, bool simulate);
+		void SetBodySimulation(ECS::Entity body, SimulationType type);
 		void SetBodyCollisionShape(ECS::Entity body, Physics::CollisionShape shape);
 		void SetBodyMass(ECS::Entity body, float mass);
 		void SetBodyRadius(ECS::Entity body, float radius);
 		void SetBodyHeight(ECS::Entity body, float height);
 		void SetBodyHalfExtents(ECS::Entity body, const Vector3& extents);
+		void SetBodyQueryLayers(ECS::Entity body, uint32 layers);
+
+		/// <summary>
+		/// Batched scene queries, same results as the PhysX backend. Bullet's broadphase is only safe to query from
+		/// several threads if it's built with BT_THREADSAFE, otherwise batches run on the calling thread.
+		/// </summary>
+		void Raycast(const RaycastQuery* queries, uint32 count, HitInfo* hits);
+		void Sweep(const SweepQuery* queries, uint32 count, HitInfo* hits);
+		void Overlap(const OverlapQuery* queries, uint32 count, std::vector<OverlapHit>& hits, uint32 maxHitsPerQuery = 32);
+
+		/// <summary>
+		/// Dynamic bodies that were awake during the last step, same as the active actors of the PhysX backend.
+		/// </summary>
+		btRigidBody** GetActiveBodies(uint32& count)
+		{
+			count = (uint32)m_activeBodies.size();
+			return m_activeBodies.data();
+		}
+
+		/// <summary>
+		/// Shape of a body, capsules stand along the y axis like the PhysX ones. Mesh shapes aren't supported & use a box.
+		/// </summary>
+		static btCollisionShape* CreateCollisionShape(CollisionShape shape, const Vector3& halfExtents, float radius, float capsuleHalfHeight);
+
+		/// <summary>
+		/// Body the engine adds to the world for an entity, the entity is kept in the user index. A mass of 0 makes it static.
+		/// </summary>
+		static btRigidBody* CreateRigidBody(btCollisionShape* shape, float mass, const Vector3& location, const Quaternion& rotation, ECS::Entity body);
 
 	private:
-		btCollisionShape* GetCreateCollisionShape(ECS::PhysicsComponent rb);
+		btCollisionShape* GetCreateCollisionShape(ECS::PhysicsComponent& rb);
 
 	private:
 		friend class Engine;
@@ -85,6 +120,7 @@ namespace Lina::Physics
 		void Initialize(ApplicationMode appMode);
 		void Tick(float fixedDelta);
 		void Shutdown();
+		float GetStepTime() { return m_stepTime; }
 
 	private:
 
@@ -92,21 +128,26 @@ namespace Lina::Physics
 		void RemoveBodyFromWorld(ECS::Entity body);
 		void AddBodyToWorld(ECS::Entity body);
 		void OnPostSceneDraw(Event::EPostSceneDraw);
+		void CollectActiveBodies();
 
 	private:
 
 		static BulletPhysicsEngine* s_physicsEngine;
 		btDefaultCollisionConfiguration* m_collisionConfig = nullptr;
-		btCollisionDispatcher* m_collisionDispatcher = nullptr;
+		btCollisionDispatcherMt* m_collisionDispatcher = nullptr;
 		btBroadphaseInterface* m_overlappingPairCache = nullptr;
-		btSequentialImpulseConstraintSolver* m_impulseSolver = nullptr;
-		btDiscreteDynamicsWorld* m_world = nullptr;
+		btConstraintSolverPoolMt* m_solverPool = nullptr;
+		btSequentialImpulseConstraintSolverMt* m_impulseSolver = nullptr;
+		btDiscreteDynamicsWorldMt* m_world = nullptr;
+		BulletTaskScheduler m_taskScheduler;
+		std::vector<btRigidBody*> m_activeBodies;
 		BulletGizmoDrawer m_gizmoDrawer;
 		ECS::RigidbodySystem m_rigidbodySystem;
 		ECS::SystemList m_physicsPipeline;
 		Event::EventSystem* m_eventSystem;
 		std::map<ECS::Entity, btRigidBody*> s_bodies;		
 		bool m_debugDrawEnabled = false;
+		float m_stepTime = 0.016f;
 		ApplicationMode m_appMode = ApplicationMode::Editor;
 	};
 }
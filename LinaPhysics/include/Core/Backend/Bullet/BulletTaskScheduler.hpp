@@ -0,0 +1,80 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: BulletTaskScheduler
+
+Bullet task scheduler running the parallel loops of the multithreaded world on an engine executor. Loops are split
+into chunks of the grain size & run as a taskflow, calls made from one of the workers run inline. Bullet keeps per
+thread solvers indexed by thread, so the executor must have less than BT_MAX_THREAD_COUNT workers. Bullet has to be
+built with BT_THREADSAFE for the loops to run in parallel.
+
+Timestamp: 2/10/2022 1:16:22 PM
+*/
+
+#pragma once
+
+#ifndef BulletTaskScheduler_HPP
+#define BulletTaskScheduler_HPP
+
+#define BT_NO_SIMD_OPERATOR_OVERLOADS
+#include "JobSystem/JobSystem.hpp"
+#include "LinearMath/btThreads.h"
+
+namespace Lina::Physics
+{
+	class BulletTaskScheduler : public btITaskScheduler
+	{
+	public:
+
+		BulletTaskScheduler() : btITaskScheduler("LinaExecutor") {}
+		~BulletTaskScheduler() = default;
+
+		/// <summary>
+		/// Loops run on the given executor, the number of threads is reset to all of its workers & the calling thread.
+		/// </summary>
+		void SetExecutor(Executor* executor);
+
+		virtual int getMaxNumThreads() const override;
+		virtual int getNumThreads() const override;
+		virtual void setNumThreads(int numThreads) override;
+		virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+		virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+	private:
+
+		bool RunsInline(int chunks) const;
+
+	private:
+
+		Executor* m_executor = nullptr;
+		int m_numThreads = 1;
+	};
+}
+
+#endif
@@ -0,0 +1,141 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysXAllocator
+
+Allocator callback handed to the PhysX foundation, memory comes from the engine's Memory & is tracked in the memory
+statistics under PhysX categories. Allocations are tagged by the scope they are made in, the ones outside of a scope
+count as simulation while a step runs & as scene otherwise. Also owns the scratch block passed to simulate, it is grown
+between steps by the highest amount of temporary heap memory a step needed.
+
+Timestamp: 2/9/2022 11:40:18 AM
+*/
+
+#pragma once
+
+#ifndef PhysXAllocator_HPP
+#define PhysXAllocator_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+
+#include <atomic>
+#include <foundation/PxAllocatorCallback.h>
+
+namespace Lina
+{
+    class MemoryCategory;
+}
+
+namespace Lina::Physics
+{
+    enum class PhysXMemoryCategory : uint32
+    {
+        Scene,
+        Simulation,
+        Cooking,
+        Serialization,
+        Count
+    };
+
+    class PhysXAllocator : public physx::PxAllocatorCallback
+    {
+
+    public:
+        PhysXAllocator();
+        ~PhysXAllocator();
+
+        /// <summary>
+        /// Tags the allocations made on the calling thread while it is alive.
+        /// </summary>
+        class Scope
+        {
+        public:
+            Scope(PhysXMemoryCategory category);
+            ~Scope();
+
+        private:
+            int32 m_previous = -1;
+        };
+
+        void* allocate(size_t size, const char* typeName, const char* filename, int line) override;
+        void  deallocate(void* ptr) override;
+
+        /// <summary>
+        /// Scratch size is rounded up to a multiple of 16 KB as PhysX requires, it is never grown past maxSize.
+        /// Must not be called while a step is running.
+        /// </summary>
+        void SetScratchSize(uint32 size, uint32 maxSize);
+
+        /// <summary>
+        /// Called right before simulate, starts measuring the temporary allocations of the step.
+        /// </summary>
+        void BeginStep();
+
+        /// <summary>
+        /// Called right after fetching the step, grows the scratch block if the step spilled to the heap.
+        /// </summary>
+        void EndStep();
+
+        inline void* GetScratchBlock() const
+        {
+            return m_scratchBlock;
+        }
+
+        inline uint32 GetScratchSize() const
+        {
+            return m_scratchSize;
+        }
+
+        /// <summary>
+        /// Highest amount of memory allocated & freed within the last step, i.e. the peak of the step's simulation
+        /// allocations minus the ones still alive when it ended. Only valid after EndStep.
+        /// </summary>
+        inline uint64 GetStepTemporaryPeak() const
+        {
+            return m_stepTemporaryPeak.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void ResizeScratch(uint32 size);
+
+    private:
+        MemoryCategory*     m_categories[(uint32)PhysXMemoryCategory::Count];
+        MemoryCategory*     m_scratchCategory    = nullptr;
+        void*               m_scratchBlock       = nullptr;
+        uint32              m_scratchSize        = 0;
+        uint32              m_scratchMaxSize     = 0;
+        std::atomic<uint32> m_step               = 0;
+        std::atomic<bool>   m_isSimulating       = false;
+        std::atomic<int64>  m_stepTemporaryBytes = 0;
+        std::atomic<uint64> m_stepTemporaryPeak  = 0;
+    };
+} // namespace Lina::Physics
+
+#endif
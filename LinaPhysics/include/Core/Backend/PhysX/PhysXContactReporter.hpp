@@ -0,0 +1,139 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysXContactReporter
+
+Collects the contacts & trigger overlaps of a step. PhysX calls it from fetchResults on the fetching thread, reports are
+written into arrays allocated up front, so a step never allocates here. Reports past the capacity are dropped & counted.
+Which pairs are reported is decided by the filter shader from the shapes' simulation filter data: word0 holds the
+contact layers, word1 the report mask & word2 the report flags.
+
+Timestamp: 2/8/2022 11:06:52 AM
+*/
+
+#pragma once
+
+#ifndef PhysXContactReporter_HPP
+#define PhysXContactReporter_HPP
+
+// Headers here.
+#include "Core/CommonPhysics.hpp"
+
+#include <PxSimulationEventCallback.h>
+#include <PxFiltering.h>
+#include <vector>
+
+namespace Lina::Physics
+{
+    class PhysXContactReporter : public physx::PxSimulationEventCallback
+    {
+
+    public:
+        PhysXContactReporter()  = default;
+        ~PhysXContactReporter() = default;
+
+        /// <summary>
+        /// word2 bit of the simulation filter data, touches that persist are reported every step.
+        /// </summary>
+        static const uint32 ReportPersistent = 1;
+
+        /// <summary>
+        /// Reports a pair if either shape's report mask shares a bit with the other's contact layers, trigger pairs
+        /// that aren't reported are dropped. Everything else collides as with the default shader.
+        /// </summary>
+        static physx::PxFilterFlags FilterShader(physx::PxFilterObjectAttributes attributes0, physx::PxFilterData filterData0, physx::PxFilterObjectAttributes attributes1, physx::PxFilterData filterData1, physx::PxPairFlags& pairFlags, const void* constantBlock, physx::PxU32 constantBlockSize);
+
+        /// <summary>
+        /// Simulation filter data of a shape, see FilterShader.
+        /// </summary>
+        static physx::PxFilterData MakeFilterData(uint32 contactLayers, uint32 reportMask, bool reportPersistent);
+
+        /// <summary>
+        /// Allocates the report arrays, reports beyond these are dropped.
+        /// </summary>
+        void SetCapacity(uint32 contacts, uint32 triggers);
+
+        /// <summary>
+        /// Clears the reports of the previous step, called right before fetching a step.
+        /// </summary>
+        void BeginStep();
+
+        inline const ContactReport* GetContacts() const
+        {
+            return m_contacts.data();
+        }
+
+        inline const TriggerReport* GetTriggers() const
+        {
+            return m_triggers.data();
+        }
+
+        inline uint32 GetContactCount() const
+        {
+            return m_contactCount;
+        }
+
+        inline uint32 GetTriggerCount() const
+        {
+            return m_triggerCount;
+        }
+
+        /// <summary>
+        /// Reports that didn't fit in the arrays during the last step.
+        /// </summary>
+        inline uint32 GetDroppedCount() const
+        {
+            return m_droppedCount;
+        }
+
+        virtual void onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs, physx::PxU32 nbPairs) override;
+        virtual void onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count) override;
+        virtual void onConstraintBreak(physx::PxConstraintInfo* constraints, physx::PxU32 count) override
+        {
+        }
+        virtual void onWake(physx::PxActor** actors, physx::PxU32 count) override
+        {
+        }
+        virtual void onSleep(physx::PxActor** actors, physx::PxU32 count) override
+        {
+        }
+        virtual void onAdvance(const physx::PxRigidBody* const* bodyBuffer, const physx::PxTransform* poseBuffer, const physx::PxU32 count) override
+        {
+        }
+
+    private:
+        std::vector<ContactReport> m_contacts;
+        std::vector<TriggerReport> m_triggers;
+        uint32                     m_contactCount = 0;
+        uint32                     m_triggerCount = 0;
+        uint32                     m_droppedCount = 0;
+    };
+} // namespace Lina::Physics
+
+#endif
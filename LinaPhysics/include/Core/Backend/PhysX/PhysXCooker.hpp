@@ -29,7 +29,9 @@ SOFTWARE.
 /*
 Class: PhysXCooker
 
-
+Creates the collision meshes of loaded models. Every mesh of a model gets a convex hull & a BVH34 triangle mesh,
+the cooked streams are kept in the model's asset data keyed by the source mesh hash & the cooking parameters, so
+later loads only deserialize them. Meshes are looked up by the model & the mesh index in node order.
 
 Timestamp: 12/24/2021 7:47:26 PM
 */
@@ -41,27 +43,30 @@ Timestamp: 12/24/2021 7:47:26 PM
 
 // Headers here.
 #include "Core/CommonApplication.hpp"
+#include "Core/CommonPhysics.hpp"
 #include "Core/SizeDefinitions.hpp"
-#include "Math/Vector.hpp"
+#include "Utility/StringId.hpp"
 
+#include <map>
+#include <mutex>
 #include <vector>
 
-namespace Lina::Graphics
-{
-    class ModelNode;
-    class Model;
-} // namespace Lina::Graphics
-
 namespace Lina::Event
 {
     struct EShutdown;
-    struct EResourceLoadCompleted;
+    struct EModelCollisionMeshesLoaded;
+    struct EResourceUnloaded;
 } // namespace Lina::Event
 
 namespace physx
 {
     class PxFoundation;
-}
+    class PxPhysics;
+    class PxCooking;
+    class PxConvexMesh;
+    class PxTriangleMesh;
+    class PxCollection;
+} // namespace physx
 
 namespace Lina::Physics
 {
@@ -69,23 +74,63 @@ namespace Lina::Physics
     {
 
     public:
-        PhysXCooker() = default;
+        PhysXCooker()  = default;
         ~PhysXCooker() = default;
-        void Initialize(ApplicationMode appMode, physx::PxFoundation* foundation);
+        void Initialize(ApplicationMode appMode, physx::PxFoundation* foundation, physx::PxPhysics* physics);
+
+        /// <summary>
+        /// Creates the collision meshes of the model, cached streams are deserialized & missing ones are cooked into
+        /// the cache. Entries no mesh of the model uses anymore are dropped. Returns true if the cache changed.
+        /// </summary>
+        bool LoadCollisionMeshes(StringIDType model, const std::vector<CollisionMeshSource>& meshes, std::map<uint64, CookedCollisionMesh>& cache);
+
+        /// <summary>
+        /// Releases the collision meshes of the model, shapes using them keep them alive until they are released.
+        /// </summary>
+        void ReleaseCollisionMeshes(StringIDType model);
 
-    private:
         /// <summary>
-        /// Uses the cooking library to create a convex mesh stream using the given vertices.
-        /// Stream is placed into the given buffer data for custom serialization.
+        /// Returns nullptr if the model isn't loaded or the mesh couldn't be cooked.
         /// </summary>
-        void CookConvexMesh(std::vector<Vector3>& vertices, std::vector<uint8>& bufferData);
+        physx::PxConvexMesh*   GetConvexMesh(StringIDType model, uint32 meshIndex);
+        physx::PxTriangleMesh* GetTriangleMesh(StringIDType model, uint32 meshIndex);
 
+        /// <summary>
+        /// Cache key of a mesh, changes if the positions, the indices or the cooking parameters change.
+        /// </summary>
+        static uint64 GetCacheKey(const CollisionMeshSource& mesh);
+
+        /// <summary>
+        /// Adds the loaded collision meshes to the collection, e.g. as external references of serialized shapes.
+        /// Ids only change if the model, the mesh index or the mesh's cache key change.
+        /// </summary>
+        void AddToCollection(physx::PxCollection& collection);
+
+        /// <summary>
+        /// Initialize creates the cooking through these, tools & tests can use them directly without the engine's events.
+        /// </summary>
+        void CreateCooking(physx::PxFoundation* foundation, physx::PxPhysics* physics);
+        void ReleaseCooking();
+
+    private:
+        struct CollisionMesh
+        {
+            physx::PxConvexMesh*   m_convex    = nullptr;
+            physx::PxTriangleMesh* m_triangles = nullptr;
+            uint64                 m_key       = 0;
+        };
+
+        void Cook(const CollisionMeshSource& mesh, CookedCollisionMesh& cooked);
         void OnShutdown(const Event::EShutdown& ev);
-        void OnResourceLoadCompleted(const Event::EResourceLoadCompleted& ev);
-        void CookModelNodeVertices(Graphics::ModelNode& node, Graphics::Model& model);
+        void OnModelCollisionMeshesLoaded(const Event::EModelCollisionMeshesLoaded& ev);
+        void OnResourceUnloaded(const Event::EResourceUnloaded& ev);
 
     private:
-        ApplicationMode m_appMode;
+        ApplicationMode                                    m_appMode = ApplicationMode::Editor;
+        physx::PxCooking*                                  m_cooking = nullptr;
+        physx::PxPhysics*                                  m_physics = nullptr;
+        std::map<StringIDType, std::vector<CollisionMesh>> m_meshes;
+        std::mutex                                         m_mutex;
     };
 } // namespace Lina::Physics
 
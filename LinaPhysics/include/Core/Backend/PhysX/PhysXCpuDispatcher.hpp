@@ -0,0 +1,112 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysXCpuDispatcher
+
+Runs PhysX tasks on a taskflow executor instead of PhysX's own threads. At most thread budget tasks run at once, each
+one is a drain loop that keeps pulling queued tasks until the queue is empty, so a shared executor is never flooded by
+the solver. Task time is accumulated per executor worker.
+
+Timestamp: 2/5/2022 10:41:16 AM
+*/
+
+#pragma once
+
+#ifndef PhysXCpuDispatcher_HPP
+#define PhysXCpuDispatcher_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include "JobSystem/JobSystem.hpp"
+
+#include <PxPhysicsAPI.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Lina::Physics
+{
+    struct PhysXWorkerStats
+    {
+        int    m_worker = -1;
+        uint32 m_tasks  = 0;
+        double m_taskMs = 0.0;
+    };
+
+    class PhysXCpuDispatcher : public physx::PxCpuDispatcher
+    {
+
+    public:
+        PhysXCpuDispatcher(Executor* executor, uint32 threadBudget);
+        virtual ~PhysXCpuDispatcher();
+
+        virtual void     submitTask(physx::PxBaseTask& task) override;
+        virtual uint32_t getWorkerCount() const override;
+
+        /// <summary>
+        /// Switches to another executor or budget. Waits for the running tasks, must not be called during a step.
+        /// </summary>
+        void SetExecutor(Executor* executor, uint32 threadBudget);
+
+        /// <summary>
+        /// Blocks until no drain loop is running.
+        /// </summary>
+        void WaitIdle();
+
+        /// <summary>
+        /// Fills the task count & time of each worker that ran a task since the last reset.
+        /// </summary>
+        void CollectStats(std::vector<PhysXWorkerStats>& stats, bool reset);
+
+    private:
+        void Drain();
+        void ResizeCounters();
+
+    private:
+        struct WorkerCounters
+        {
+            std::atomic<uint64> m_taskNs{0};
+            std::atomic<uint32> m_tasks{0};
+        };
+
+        Executor*                         m_executor     = nullptr;
+        uint32                            m_threadBudget = 1;
+        uint32                            m_running      = 0;
+        uint32                            m_counterCount = 0;
+        std::unique_ptr<WorkerCounters[]> m_counters;
+        std::deque<physx::PxBaseTask*>    m_queue;
+        std::mutex                        m_mutex;
+        std::condition_variable           m_idle;
+    };
+} // namespace Lina::Physics
+
+#endif
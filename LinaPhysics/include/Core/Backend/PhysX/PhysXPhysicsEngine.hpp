@@ -31,6 +31,18 @@ Class: PhysXPhysicsEngine
 
 Responsible for initializing, running and cleaning up the physics world. Also a wrapper for bt3.
 
+With async simulation the step is started at the end of the game update & fetched at the start of the next one, so
+rendering runs while the PhysX workers solve. While a step is running:
+- Body & material setters are buffered, they are applied in order right after the step is fetched.
+- GetActor, GetEntityOfActor, IsEntityAPhysicsActor, GetKinematicBodies, GetActorCount & GetMaterials are safe to call.
+- Reading actor state, e.g. getGlobalPose(), returns the state from before the step. Transforms of simulated entities
+  are only written back after the fetch.
+- GetActiveActors must not be called. Debug lines come from the last fetched step.
+- Scene queries can run, they see the bodies as they were before the step.
+
+PhysX tasks run on the engine's shared executor by default, limited to a worker budget so the solver doesn't take
+every worker. Physics can also be pinned to an executor of its own, see SetWorkerBudget.
+
 Timestamp: 5/1/2019 2:35:28 AM
 */
 
@@ -39,12 +51,20 @@ Timestamp: 5/1/2019 2:35:28 AM
 #ifndef PhysicsEngine_HPP
 #define PhysicsEngine_HPP
 
+#include "Core/Backend/PhysX/PhysXContactReporter.hpp"
 #include "Core/Backend/PhysX/PhysXCooker.hpp"
+#include "Core/Backend/PhysX/PhysXCpuDispatcher.hpp"
+#include "Core/Backend/PhysX/PhysXSimulationStep.hpp"
+#include "Core/Backend/PhysX/PhysXStaticBatcher.hpp"
 #include "Core/CommonECS.hpp"
 #include "ECS/Components/PhysicsComponent.hpp"
 #include "ECS/SystemList.hpp"
 #include "ECS/Systems/RigidbodySystem.hpp"
 #include "Physics/PhysicsMaterial.hpp"
+#include "Physics/SceneQuery.hpp"
+
+#include <string>
+#include <vector>
 
 namespace Lina
 {
@@ -58,6 +78,7 @@ namespace Lina
     {
         class EventSystem;
         struct ELevelInstalled;
+        struct ESerializedLevel;
         struct EPostSceneDraw;
         struct ELoadResourceFromFile;
         struct ELoadResourceFromMemory;
@@ -68,15 +89,18 @@ namespace Lina
 
 namespace physx
 {
+    class PxPhysics;
     class PxShape;
     class PxRigidActor;
+    class PxRigidDynamic;
+    class PxRigidStatic;
     class PxActor;
     class PxMaterial;
+    class PxCollection;
 } // namespace physx
 
 namespace Lina::Physics
 {
-
     class PhysXPhysicsEngine
     {
     public:
@@ -85,25 +109,30 @@ namespace Lina::Physics
             return s_physicsEngine;
         }
 
-        /// <summary>
-        /// Given a convex mesh buffer data, creates a convex mesh object and stores it.
-        /// </summary>
-        void CreateConvexMesh(std::vector<uint8>& data, StringIDType sid, int nodeID);
-
         /// <summary>
         /// Returns all moving actor within the Nvidia PhysX scene.
         /// </summary>
         physx::PxActor** GetActiveActors(uint32& size);
 
         /// <summary>
-        /// Given a PxActor, returns the Entity it belongs to.
+        /// Given a PxActor, returns the Entity it belongs to, read from the actor's user data.
         /// </summary>
         ECS::Entity GetEntityOfActor(physx::PxActor* actor);
 
         /// <summary>
-        /// Returns all Dynamic bodies, regardless of whether they are static or not.
+        /// Returns the static or dynamic actor of the entity, nullptr if it's not in the physics world.
+        /// </summary>
+        physx::PxRigidActor* GetActor(ECS::Entity entity);
+
+        /// <summary>
+        /// Returns the dynamic bodies that are driven by their transforms.
+        /// </summary>
+        const std::vector<ECS::Entity>& GetKinematicBodies();
+
+        /// <summary>
+        /// Returns the number of actors in the physics world, static or dynamic.
         /// </summary>
-        std::map<ECS::Entity, physx::PxRigidActor*>& GetAllActors();
+        uint32 GetActorCount();
 
         /// <summary>
         /// Returns a map of created physics material, the key represents the Lina ID of the PhysicsMaterial object,
@@ -145,13 +174,129 @@ namespace Lina::Physics
         void SetBodyHeight(ECS::Entity body, float height);
         void SetBodyHalfExtents(ECS::Entity body, const Vector3& extents);
         void SetBodyKinematic(ECS::Entity body, bool kinematic);
+        void SetBodyQueryLayers(ECS::Entity body, uint32 layers);
         void UpdateBodyShapeParameters(ECS::Entity body);
 
+        /// <summary>
+        /// Contacts of the body are reported with EPhysicsContacts if its report mask shares a bit with the other body's
+        /// contact layers or the other way around. Touches that persist are reported every step if either body asks for it.
+        /// </summary>
+        void SetBodyContactReports(ECS::Entity body, uint32 contactLayers, uint32 reportMask, bool reportPersistent = false);
+
+        /// <summary>
+        /// Trigger bodies don't collide, bodies entering & leaving them are reported with EPhysicsContacts if the report
+        /// masks match as with contacts. Triangle mesh shapes can't be triggers.
+        /// </summary>
+        void SetBodyTrigger(ECS::Entity body, bool isTrigger);
+
+        /// <summary>
+        /// Contacts & triggers reported by a single step, the rest are dropped with a warning. Must not be called from
+        /// an EPhysicsContacts handler, the arrays of the event are reallocated.
+        /// </summary>
+        void SetContactReportCapacity(uint32 contacts, uint32 triggers);
+
+        /// <summary>
+        /// Shape of a box, sphere or capsule body, capsules stand along the y axis. Mesh shapes come from the cooker.
+        /// </summary>
+        static physx::PxShape* CreatePrimitiveShape(physx::PxPhysics& physics, physx::PxMaterial& material, CollisionShape shape, const Vector3& halfExtents, float radius, float capsuleHalfHeight);
+
+        /// <summary>
+        /// Dynamic actor the engine adds to the scene for an entity, the entity is kept in the user data. The mass is
+        /// spread over the shape even if it's a trigger, triangle mesh shapes are only attached to kinematic actors & get none.
+        /// </summary>
+        static physx::PxRigidDynamic* CreateDynamicActor(physx::PxPhysics& physics, physx::PxShape& shape, float mass, bool isKinematic, const Vector3& location, const Quaternion& rotation, ECS::Entity body);
+
         void SetDebugDraw(bool enabled)
         {
             m_debugDrawEnabled = enabled;
         }
 
+        /// <summary>
+        /// If enabled, the physics step overlaps with rendering, see the notes above. Otherwise the step blocks the game update.
+        /// </summary>
+        inline void SetAsyncSimulation(bool async)
+        {
+            m_asyncSimulation = async;
+        }
+
+        inline bool GetAsyncSimulation()
+        {
+            return m_asyncSimulation;
+        }
+
+        /// <summary>
+        /// True between Simulate() & FetchResults().
+        /// </summary>
+        inline bool IsSimulating()
+        {
+            return m_simulationStep.IsSimulating();
+        }
+
+        /// <summary>
+        /// Number of PhysX tasks that may run at once. With dedicated workers physics gets an executor of that many
+        /// threads, otherwise the tasks run on the shared executor next to the other jobs. Applied after a running step is fetched.
+        /// </summary>
+        void SetWorkerBudget(uint32 threads, bool dedicatedWorkers);
+
+        inline uint32 GetWorkerBudget()
+        {
+            return m_workerBudget;
+        }
+
+        inline bool GetDedicatedWorkers()
+        {
+            return m_dedicatedWorkers;
+        }
+
+        /// <summary>
+        /// Scratch block passed to each step, PhysX serves its temporary allocations from it before going to the heap.
+        /// Starts at size & grows up to maxSize by what the steps spill to the heap. Applied after a running step is fetched.
+        /// </summary>
+        void SetScratchMemory(uint32 size, uint32 maxSize);
+
+        /// <summary>
+        /// Current size of the scratch block, after the growth.
+        /// </summary>
+        uint32 GetScratchSize();
+
+        /// <summary>
+        /// Batched scene queries, run on the shared executor. Rays & sweeps write their closest hit to the same index
+        /// in hits, HitInfo::m_hitCount is 0 on a miss. Overlaps replace the contents of hits, ordered by query.
+        /// Safe to call during an async step, queries see the bodies as they were before the step.
+        /// </summary>
+        void Raycast(const RaycastQuery* queries, uint32 count, HitInfo* hits);
+        void Sweep(const SweepQuery* queries, uint32 count, HitInfo* hits);
+        void Overlap(const OverlapQuery* queries, uint32 count, std::vector<OverlapHit>& hits, uint32 maxHitsPerQuery = 32);
+
+        /// <summary>
+        /// How static bodies are inserted when a level is installed, see PhysXStaticBatcher. Cells are cellSize units
+        /// wide. Batches of levels installed from a file are cached next to it & rebuilt if the static bodies change.
+        /// Applied on the next level install.
+        /// </summary>
+        inline void SetStaticBatching(StaticBatching mode, float cellSize)
+        {
+            m_staticBatching = mode;
+            m_staticCellSize = cellSize;
+        }
+
+        inline StaticBatching GetStaticBatching()
+        {
+            return m_staticBatching;
+        }
+
+        inline float GetStaticCellSize()
+        {
+            return m_staticCellSize;
+        }
+
+        /// <summary>
+        /// Task count & time of each worker that ran PhysX tasks during the last fetched step.
+        /// </summary>
+        inline const std::vector<PhysXWorkerStats>& GetWorkerStats()
+        {
+            return m_workerStats;
+        }
+
     private:
         friend class Engine;
         friend struct ECS::PhysicsComponent;
@@ -160,6 +305,8 @@ namespace Lina::Physics
         ~PhysXPhysicsEngine();
         void  Initialize(ApplicationMode appMode);
         void  Tick(float fixedDelta);
+        void  Simulate(float fixedDelta);
+        void  FetchResults();
         void  Shutdown();
         float GetStepTime()
         {
@@ -170,23 +317,67 @@ namespace Lina::Physics
         void            OnPhysicsComponentAdded(entt::registry& reg, entt::entity ent);
         void            RecreateBodyShape(ECS::Entity body);
         void            OnLevelInstalled(const Event::ELevelInstalled& ev);
+        void            OnSerializedLevel(const Event::ESerializedLevel& ev);
         void            OnPostSceneDraw(const Event::EPostSceneDraw&);
         void            OnPhysicsComponentRemoved(entt::registry& reg, entt::entity ent);
         void            OnEntityEnabledChanged(const Event::EEntityEnabledChanged& ev);
         void            RemoveBodyFromWorld(ECS::Entity body);
         void            AddBodyToWorld(ECS::Entity body, bool isDynamic);
+        void            TrackActor(ECS::Entity body, physx::PxRigidActor* actor);
+        void            ApplyShapeFilters(physx::PxShape* shape, ECS::PhysicsComponent& phy);
         physx::PxShape* GetCreateShape(ECS::PhysicsComponent& phy, ECS::Entity ent = entt::null);
 
+        /// <summary>
+        /// Inserts the static bodies of an installed level through the static batcher, the batch is loaded from the
+        /// level's cache if it's still valid.
+        /// </summary>
+        void AddStaticBodiesToWorld(const std::vector<ECS::Entity>& bodies, const std::string& levelPath);
+
+        /// <summary>
+        /// Creates the actor of a static body without adding it to the scene.
+        /// </summary>
+        physx::PxRigidStatic* CreateStaticActor(ECS::Entity body);
+
+        /// <summary>
+        /// Hash of everything the static actors are created from, identifies a cached batch.
+        /// </summary>
+        uint64 HashStaticBodies(const std::vector<ECS::Entity>& bodies);
+
+        /// <summary>
+        /// Materials & collision meshes a cached batch refers to, created for all the static bodies.
+        /// </summary>
+        physx::PxCollection* CreateExternalReferences(const std::vector<ECS::Entity>& bodies);
+        physx::PxMaterial*   GetCreateMaterial(ECS::PhysicsComponent& phy);
+
+    private:
+        /// <summary>
+        /// Returns a write to fill if a step is running, nullptr otherwise. Writes for a body are dropped if it's destroyed before they are applied.
+        /// </summary>
+        DeferredWrite* DeferIfSimulating(DeferredWriteType type, ECS::Entity body = entt::null);
+        void           ApplyDeferredWrite(const DeferredWrite& write);
+
     private:
-        static PhysXPhysicsEngine* s_physicsEngine;
-        ECS::RigidbodySystem       m_rigidbodySystem;
-        ECS::SystemList            m_physicsPipeline;
-        Event::EventSystem*        m_eventSystem;
-        ApplicationMode            m_appMode = ApplicationMode::Editor;
-        PhysXCooker                m_cooker;
-        PhysicsMaterial*           m_defaultMaterial  = nullptr;
-        bool                       m_debugDrawEnabled = false;
-        float                      m_stepTime         = 0.016f;
+        static PhysXPhysicsEngine*    s_physicsEngine;
+        ECS::RigidbodySystem          m_rigidbodySystem;
+        ECS::SystemList               m_physicsPipeline;
+        Event::EventSystem*           m_eventSystem;
+        ApplicationMode               m_appMode = ApplicationMode::Editor;
+        PhysXCooker                   m_cooker;
+        PhysXContactReporter          m_contactReporter;
+        PhysXStaticBatcher            m_staticBatcher;
+        StaticBatching                m_staticBatching   = StaticBatching::PruningStructures;
+        float                         m_staticCellSize   = 64.0f;
+        PhysicsMaterial*              m_defaultMaterial  = nullptr;
+        PhysXSimulationStep           m_simulationStep;
+        std::vector<PhysXWorkerStats> m_workerStats;
+        uint32                        m_workerBudget     = 1;
+        bool                          m_dedicatedWorkers = false;
+        bool                          m_debugDrawEnabled = false;
+        bool                          m_asyncSimulation  = true;
+        uint32                        m_scratchSize      = 256 * 1024;
+        uint32                        m_scratchMaxSize   = 16 * 1024 * 1024;
+        float                         m_stepTime         = 0.016f;
+        float                         m_simulatedDelta   = 0.0f;
     };
 } // namespace Lina::Physics
 
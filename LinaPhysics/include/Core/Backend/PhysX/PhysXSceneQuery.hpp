@@ -0,0 +1,84 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysXSceneQuery
+
+Runs batches of raycasts, sweeps & overlaps against a PhysX scene. Batches are split into slices that run on the
+executor's workers, each query only writes its own result so nothing is locked. Queries only read the scene, they
+must not overlap with fetching a step or with writes to the scene.
+
+Timestamp: 2/6/2022 12:31:47 PM
+*/
+
+#pragma once
+
+#ifndef PhysXSceneQuery_HPP
+#define PhysXSceneQuery_HPP
+
+// Headers here.
+#include "JobSystem/JobSystem.hpp"
+#include "Physics/SceneQuery.hpp"
+
+#include <vector>
+
+namespace physx
+{
+    class PxScene;
+}
+
+namespace Lina::Physics
+{
+    class PhysXSceneQuery
+    {
+
+    public:
+        /// <summary>
+        /// Writes the closest hit of each ray to the same index in hits, HitInfo::m_hitCount is 0 on a miss.
+        /// </summary>
+        static void Raycast(physx::PxScene* scene, Executor& executor, const RaycastQuery* queries, uint32 count, HitInfo* hits);
+
+        /// <summary>
+        /// Writes the closest hit of each sweep to the same index in hits, HitInfo::m_hitCount is 0 on a miss.
+        /// </summary>
+        static void Sweep(physx::PxScene* scene, Executor& executor, const SweepQuery* queries, uint32 count, HitInfo* hits);
+
+        /// <summary>
+        /// Replaces the contents of hits with the overlapping entities, ordered by query. At most maxHitsPerQuery are
+        /// reported for each query.
+        /// </summary>
+        static void Overlap(physx::PxScene* scene, Executor& executor, const OverlapQuery* queries, uint32 count, std::vector<OverlapHit>& hits, uint32 maxHitsPerQuery = 32);
+
+        /// <summary>
+        /// Number of queries run by a single task.
+        /// </summary>
+        static const uint32 SliceSize = 256;
+    };
+} // namespace Lina::Physics
+
+#endif
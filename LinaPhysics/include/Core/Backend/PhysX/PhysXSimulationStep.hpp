@@ -0,0 +1,155 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysXSimulationStep
+
+Runs the split simulate / fetch step of a scene & records the setters called while the step is running. Recorded
+writes are replayed in the order they were made right after the step is fetched, writes for a body are dropped if
+it's destroyed in between except its removal, which releases the actor. Doesn't know about the physics engine, so it
+runs headless on any scene.
+
+Timestamp: 2/12/2022 4:52:18 PM
+*/
+
+#pragma once
+
+#ifndef PhysXSimulationStep_HPP
+#define PhysXSimulationStep_HPP
+
+// Headers here.
+#include "Core/CommonECS.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include "Math/Vector.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace physx
+{
+    class PxScene;
+}
+
+namespace Lina::Physics
+{
+    class PhysicsMaterial;
+
+    enum class DeferredWriteType
+    {
+        WorkerBudget,
+        ScratchMemory,
+        MaterialStaticFriction,
+        MaterialDynamicFriction,
+        MaterialRestitution,
+        BodySimulation,
+        BodyCollisionShape,
+        BodyMass,
+        BodyMaterial,
+        BodyRadius,
+        BodyHeight,
+        BodyHalfExtents,
+        BodyShapeParameters,
+        BodyKinematic,
+        BodyQueryLayers,
+        BodyContactReports,
+        BodyTrigger,
+        BodyEnabled,
+        AddBody,
+        RemoveBody,
+        LevelInstalled,
+        SerializedLevel
+    };
+
+    /// <summary>
+    /// Arguments of a setter called while a step is running, only the ones the setter takes are filled.
+    /// </summary>
+    struct DeferredWrite
+    {
+        DeferredWriteType m_type     = DeferredWriteType::WorkerBudget;
+        ECS::Entity       m_body     = entt::null;
+        PhysicsMaterial*  m_material = nullptr;
+        entt::registry*   m_registry = nullptr;
+        Vector3           m_vector   = Vector3::Zero;
+        float             m_value    = 0.0f;
+        uint32            m_args[3]  = {0, 0, 0};
+        bool              m_flag     = false;
+        std::string       m_path     = "";
+    };
+
+    class PhysXSimulationStep
+    {
+
+    public:
+        PhysXSimulationStep()  = default;
+        ~PhysXSimulationStep() = default;
+
+        /// <summary>
+        /// Starts a step, a running one has to be fetched first. The scratch block may be null.
+        /// </summary>
+        void Simulate(physx::PxScene* scene, float stepTime, void* scratchBlock, uint32 scratchSize);
+
+        /// <summary>
+        /// Blocks until the running step is done, returns false if there was none. Recorded writes are kept until
+        /// ApplyDeferredWrites.
+        /// </summary>
+        bool FetchResults(physx::PxScene* scene);
+
+        /// <summary>
+        /// Returns a write to fill if a step is running, nullptr otherwise.
+        /// </summary>
+        DeferredWrite* DeferIfSimulating(DeferredWriteType type, ECS::Entity body = entt::null);
+
+        /// <summary>
+        /// Passes the writes recorded during the fetched step to apply in the order they were made, writes for bodies
+        /// that are no longer valid in the registry are skipped except removals. Writes made by apply itself aren't
+        /// deferred since no step is running.
+        /// </summary>
+        void ApplyDeferredWrites(const entt::registry& reg, const std::function<void(const DeferredWrite&)>& apply);
+
+        /// <summary>
+        /// True between Simulate() & FetchResults().
+        /// </summary>
+        inline bool IsSimulating() const
+        {
+            return m_isSimulating;
+        }
+
+        inline uint32 GetDeferredCount() const
+        {
+            return (uint32)m_deferredWrites.size();
+        }
+
+    private:
+        std::vector<DeferredWrite> m_deferredWrites;
+        std::vector<DeferredWrite> m_appliedWrites;
+        bool                       m_isSimulating = false;
+    };
+} // namespace Lina::Physics
+
+#endif
@@ -0,0 +1,139 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysXStaticBatcher
+
+Inserts large numbers of static actors in bulk. Actors are grouped into cubic cells by position & each cell becomes
+either aggregates of up to 128 actors, so the broadphase only sees one bound per aggregate, or a pruning structure
+whose scene query tree is built on the workers & merged into the scene in a single call. PhysX doesn't allow an actor
+to be in both. Built batches can be written to a PhysX binary collection & loaded back without building anything.
+
+Timestamp: 2/7/2022 10:42:15 AM
+*/
+
+#pragma once
+
+#ifndef PhysXStaticBatcher_HPP
+#define PhysXStaticBatcher_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include "JobSystem/JobSystem.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace physx
+{
+    class PxPhysics;
+    class PxScene;
+    class PxRigidStatic;
+    class PxAggregate;
+    class PxPruningStructure;
+    class PxCollection;
+} // namespace physx
+
+namespace Lina::Physics
+{
+    enum class StaticBatching
+    {
+        None              = 0,
+        Aggregates        = 1,
+        PruningStructures = 2
+    };
+
+    struct StaticBatch
+    {
+        std::vector<physx::PxRigidStatic*>      m_actors;
+        std::vector<physx::PxAggregate*>        m_aggregates;
+        std::vector<physx::PxPruningStructure*> m_structures;
+    };
+
+    class PhysXStaticBatcher
+    {
+
+    public:
+        PhysXStaticBatcher()  = default;
+        ~PhysXStaticBatcher() = default;
+
+        inline void Initialize(physx::PxPhysics* physics)
+        {
+            m_physics = physics;
+        }
+
+        /// <summary>
+        /// Groups the actors into cells & creates the aggregates or the pruning structures of each cell, pruning
+        /// structures are built on the executor's workers. The actors must not be in a scene.
+        /// </summary>
+        void Build(const std::vector<physx::PxRigidStatic*>& actors, StaticBatching mode, float cellSize, Executor& executor, StaticBatch& batch);
+
+        /// <summary>
+        /// Adds a built or loaded batch to the scene. Pruning structures are released once merged, aggregates are kept
+        /// until ReleaseAggregates is called.
+        /// </summary>
+        void AddToScene(physx::PxScene* scene, StaticBatch& batch);
+
+        /// <summary>
+        /// Releases a batch that was never added to a scene, actors included.
+        /// </summary>
+        void ReleaseBatch(StaticBatch& batch);
+
+        /// <summary>
+        /// Releases the aggregates added to the scene so far, actors still in them are re-inserted one by one.
+        /// </summary>
+        void ReleaseAggregates();
+
+        /// <summary>
+        /// Writes a built batch to path, actorIds are the ids of the actors in m_actors order & must not be 0.
+        /// Objects in externalRefs, e.g. materials & meshes, are stored by their ids. hash identifies the bodies the
+        /// batch was built from, Load fails if it doesn't match.
+        /// </summary>
+        bool Save(const std::string& path, uint64 hash, const StaticBatch& batch, const std::vector<uint64>& actorIds, const physx::PxCollection& externalRefs);
+
+        /// <summary>
+        /// Loads a batch written by Save, fails if the file is missing, was saved from other bodies or refers to
+        /// objects that aren't in externalRefs. Loaded objects live in a memory block that is only freed with the
+        /// batcher, so it must outlive the physics SDK.
+        /// </summary>
+        bool Load(const std::string& path, uint64 hash, const physx::PxCollection& externalRefs, StaticBatch& batch, std::vector<uint64>& actorIds);
+
+        /// <summary>
+        /// PhysX limit on the actors of an aggregate.
+        /// </summary>
+        static const uint32 MaxAggregateActors = 128;
+
+    private:
+        physx::PxPhysics*                     m_physics = nullptr;
+        std::vector<physx::PxAggregate*>      m_aggregates;
+        std::vector<std::unique_ptr<uint8[]>> m_memoryBlocks;
+    };
+} // namespace Lina::Physics
+
+#endif
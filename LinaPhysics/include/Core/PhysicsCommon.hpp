@@ -40,6 +40,8 @@ Timestamp: 12/20/2021 1:05:42 PM
 #define PhysicsCommon_HPP
 
 // Headers here.
+#include "Core/CommonECS.hpp"
+#include "Core/SizeDefinitions.hpp"
 #include "Math/Quaternion.hpp"
 #include "Math/Vector.hpp"
 
@@ -70,8 +72,20 @@ namespace Lina::Physics
     extern Vector3       ToLinaVector3(const physx::PxVec3& v);
     extern Vector4       ToLinaVector4(const physx::PxVec4& v);
     extern Quaternion    ToLinaQuat(const physx::PxQuat& q);
+
+    /// <summary>
+    /// Actors carry their entity in PxActor::userData, so active actors can be mapped back without a lookup.
+    /// </summary>
+    extern void*       ToPxUserData(ECS::Entity entity);
+    extern ECS::Entity ToLinaEntity(void* userData);
 #endif
 
+    /// <summary>
+    /// FNV-1a over the bytes, chain calls by passing the previous result. Start with HashSeed.
+    /// </summary>
+    extern uint64 HashBytes(uint64 hash, const void* data, size_t size);
+    const uint64  HashSeed = 14695981039346656037ull;
+
 } // namespace Lina::Physics
 
 #endif
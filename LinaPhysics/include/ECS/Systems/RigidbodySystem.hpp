@@ -39,9 +39,22 @@ Timestamp: 9/30/2020 2:52:58 AM
 #ifndef RigidbodySystem_HPP
 #define RigidbodySystem_HPP
 
+#include "Core/CommonECS.hpp"
 #include "Core/PhysicsBackendFwd.hpp"
+#include "Core/SizeDefinitions.hpp"
 #include "ECS/System.hpp"
 
+#ifdef LINA_PHYSICS_PHYSX
+namespace physx
+{
+    class PxActor;
+}
+#endif
+
+#ifdef LINA_PHYSICS_BULLET
+class btRigidBody;
+#endif
+
 namespace Lina::ECS
 {
     class RigidbodySystem : public System
@@ -52,6 +65,22 @@ namespace Lina::ECS
         virtual void Initialize(const std::string& name, Physics::PhysicsEngine* engine);
         virtual void UpdateComponents(float delta) override;
 
+#ifdef LINA_PHYSICS_PHYSX
+        /// <summary>
+        /// Writes the global poses & velocities of the given active actors to their entities, entities are read from the
+        /// actors' user data. Kinematic actors are skipped. Returns the number of entities written.
+        /// </summary>
+        static uint32 SyncActiveActors(entt::registry& reg, physx::PxActor** actors, uint32 count);
+#endif
+
+#ifdef LINA_PHYSICS_BULLET
+        /// <summary>
+        /// Writes the world transforms & velocities of the given active bodies to their entities, entities are read from
+        /// the bodies' user index. Returns the number of entities written.
+        /// </summary>
+        static uint32 SyncActiveBodies(entt::registry& reg, btRigidBody** bodies, uint32 count);
+#endif
+
     private:
         Physics::PhysicsEngine* m_engine   = nullptr;
     };
@@ -0,0 +1,103 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: SceneQuery
+
+Query descriptions for the batched raycasts, sweeps & overlaps of the physics engine. A shape is hit if the query
+layers of its body share a bit with the query's layer mask.
+
+Timestamp: 2/6/2022 12:14:05 PM
+*/
+
+#pragma once
+
+#ifndef SceneQuery_HPP
+#define SceneQuery_HPP
+
+// Headers here.
+#include "Core/CommonECS.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include "Math/Quaternion.hpp"
+#include "Math/Vector.hpp"
+#include "Physics/Raycast.hpp"
+
+namespace Lina::Physics
+{
+    enum class QueryShape : uint8
+    {
+        Sphere  = 0,
+        Box     = 1,
+        Capsule = 2,
+    };
+
+    /// <summary>
+    /// Capsules stand along the Y axis, same as capsule bodies.
+    /// </summary>
+    struct QueryGeometry
+    {
+        QueryShape m_shape       = QueryShape::Sphere;
+        Vector3    m_halfExtents = Vector3(0.5f, 0.5f, 0.5f);
+        float      m_radius      = 0.5f;
+        float      m_halfHeight  = 0.5f;
+    };
+
+    struct RaycastQuery
+    {
+        Vector3 m_origin    = Vector3(0.0f, 0.0f, 0.0f);
+        Vector3 m_unitDir   = Vector3(0.0f, 0.0f, 1.0f);
+        float   m_distance  = 1000.0f;
+        uint32  m_layerMask = 0xFFFFFFFF;
+    };
+
+    struct SweepQuery
+    {
+        QueryGeometry m_geometry;
+        Vector3       m_origin    = Vector3(0.0f, 0.0f, 0.0f);
+        Quaternion    m_rotation  = Quaternion();
+        Vector3       m_unitDir   = Vector3(0.0f, 0.0f, 1.0f);
+        float         m_distance  = 1000.0f;
+        uint32        m_layerMask = 0xFFFFFFFF;
+    };
+
+    struct OverlapQuery
+    {
+        QueryGeometry m_geometry;
+        Vector3       m_position  = Vector3(0.0f, 0.0f, 0.0f);
+        Quaternion    m_rotation  = Quaternion();
+        uint32        m_layerMask = 0xFFFFFFFF;
+    };
+
+    struct OverlapHit
+    {
+        uint32      m_query  = 0;
+        ECS::Entity m_entity = entt::null;
+    };
+} // namespace Lina::Physics
+
+#endif
@@ -28,13 +28,13 @@ SOFTWARE.
 
 #include "Core/Backend/Bullet/BulletGizmoDrawer.hpp"
 #include "EventSystem/EventSystem.hpp"
-#include "EventSystem/Events.hpp"
+#include "EventSystem/GraphicsEvents.hpp"
 
 #define LINE_WIDTH 2.0f
 
 void BulletGizmoDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3& color)
 {
-	Event::EventSystem::Get()->Trigger<Event::EDrawPhysicsDebug>(Event::EDrawPhysicsDebug{
-		Vector3(from.getX(), from.getY(), from.getZ()), Vector3(to.getX(), to.getY(), to.getZ()), Color(color.getX(), color.getY(), color.getZ()), LINE_WIDTH
+	Lina::Event::EventSystem::Get()->Trigger<Lina::Event::EDrawLine>(Lina::Event::EDrawLine{
+		Lina::Vector3(from.getX(), from.getY(), from.getZ()), Lina::Vector3(to.getX(), to.getY(), to.getZ()), Lina::Color(color.getX(), color.getY(), color.getZ()), LINE_WIDTH
 		});
 }
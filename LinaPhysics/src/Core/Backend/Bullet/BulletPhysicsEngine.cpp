@@ -30,9 +30,13 @@ SOFTWARE.
 #include "Core/Backend/Bullet/BulletPhysicsEngine.hpp"  
 #include "Log/Log.hpp"
 #include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Registry.hpp"
 #include "Utility/UtilityFunctions.hpp"
 #include "EventSystem/EventSystem.hpp"
+#include "JobSystem/JobSystem.hpp"
 #include "Math/Color.hpp"
+#include <algorithm>
+#include <memory>
 
 namespace Lina::Physics
 {
@@ -71,9 +75,13 @@ namespace Lina::Physics
 
 		delete m_world;
 		delete m_impulseSolver;
+		delete m_solverPool;
 		delete m_overlappingPairCache;
 		delete m_collisionDispatcher;
 		delete m_collisionConfig;
+
+		// The scheduler is destroyed with the engine.
+		btSetTaskScheduler(btGetSequentialTaskScheduler());
 	}
 
 	void BulletPhysicsEngine::Initialize(ApplicationMode appMode)
@@ -84,20 +92,28 @@ namespace Lina::Physics
 		if (m_appMode == ApplicationMode::Editor)
 			SetDebugDraw(true);
 
-		// collision configuration contains default setup for memory, collision setup. Advanced users can create their own configuration.
-		m_collisionConfig = new btDefaultCollisionConfiguration();
+		// The scheduler has to be set before any of the Mt classes are created.
+		m_taskScheduler.SetExecutor(&GetSharedExecutor());
+		btSetTaskScheduler(&m_taskScheduler);
+
+		// Pools are shared by the dispatcher threads, the defaults are too small for them.
+		btDefaultCollisionConstructionInfo constructionInfo;
+		constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+		constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+		m_collisionConfig = new btDefaultCollisionConfiguration(constructionInfo);
 
-		// use the default collision dispatcher. For parallel processing you can use a diffent dispatcher (see Extras/BulletMultiThreaded)
-		m_collisionDispatcher = new btCollisionDispatcher(m_collisionConfig);
+		// Narrow phase runs in parallel over the overlapping pairs.
+		m_collisionDispatcher = new btCollisionDispatcherMt(m_collisionConfig, 40);
 
 		// btDbvtBroadphase is a good general purpose broadphase. You can also try out btAxis3Sweep.
 		m_overlappingPairCache = new btDbvtBroadphase();
 
-		// the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
-		m_impulseSolver = new btSequentialImpulseConstraintSolver;
+		// Islands are solved in parallel with a solver per thread, islands too large for a single thread use the Mt solver.
+		m_solverPool = new btConstraintSolverPoolMt(m_taskScheduler.getMaxNumThreads());
+		m_impulseSolver = new btSequentialImpulseConstraintSolverMt();
 
 		// Build dynamics world
-		m_world = new btDiscreteDynamicsWorld(m_collisionDispatcher, m_overlappingPairCache, m_impulseSolver, m_collisionConfig);
+		m_world = new btDiscreteDynamicsWorldMt(m_collisionDispatcher, m_overlappingPairCache, m_solverPool, m_impulseSolver, m_collisionConfig);
 		m_world->setGravity(btVector3(0, -0.2f, 0));
 
 		// Initialize the debug drawer.
@@ -106,7 +122,7 @@ namespace Lina::Physics
 		ECS::Registry::Get()->on_destroy<ECS::PhysicsComponent>().connect<&BulletPhysicsEngine::OnPhysicsComponentRemoved>(this);
 
 		// Setup rigidbody system and listen to events so that we can refresh bodies when new rigidbodies are created, destroyed etc.
-		m_rigidbodySystem.Initialize();
+		m_rigidbodySystem.Initialize("Rigidbody System", this);
 		m_physicsPipeline.AddSystem(m_rigidbodySystem);
 
 		// Engine events.
@@ -117,11 +133,25 @@ namespace Lina::Physics
 
 	void BulletPhysicsEngine::Tick(float fixedDelta)
 	{
-		// Update phy.
-		m_world->stepSimulation(fixedDelta, 10);
+		// A single sub step of the engine's fixed step, same as a PhysX step.
+		m_world->stepSimulation(fixedDelta, 1, fixedDelta);
+		CollectActiveBodies();
 		m_physicsPipeline.UpdateSystems(fixedDelta);
 	}
 
+	void BulletPhysicsEngine::CollectActiveBodies()
+	{
+		// Sleeping, static & kinematic bodies don't move on their own, they are left out of the write back.
+		btAlignedObjectArray<btRigidBody*>& bodies = m_world->getNonStaticRigidBodies();
+		m_activeBodies.clear();
+
+		for (int i = 0; i < bodies.size(); i++)
+		{
+			if (bodies[i]->isActive() && !bodies[i]->isKinematicObject())
+				m_activeBodies.push_back(bodies[i]);
+		}
+	}
+
 	void BulletPhysicsEngine::Shutdown()
 	{
 		LINA_TRACE("[Shutdown] -> Physics Engine ({0})", typeid(*this).name());
@@ -133,23 +163,21 @@ namespace Lina::Physics
 			m_world->debugDrawWorld();
 	}
 
-	void BulletPhysicsEngine::SetBodySimulation(ECS::Entity body, bool simulate)
+	void BulletPhysicsEngine::SetBodySimulation(ECS::Entity body, SimulationType type)
 	{
 		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+		const SimulationType previousType = phy.m_simType;
+		phy.m_simType = type;
 
-		// If started simulating.
-		if (simulate && !phy.m_wasSimulated)
-		{
-			AddBodyToWorld(body);
-			phy.m_wasSimulated = true;
-		}
-		else if (!phy.m_isSimulated && phy.m_wasSimulated)
-		{
+		if (previousType == type)
+			return;
+
+		// Static bodies are bodies with a mass of 0, switching between the types recreates the body.
+		if (previousType != SimulationType::None)
 			RemoveBodyFromWorld(body);
-			phy.m_wasSimulated = false;
-		}
 
-		phy.m_isSimulated = simulate;
+		if (type != SimulationType::None)
+			AddBodyToWorld(body);
 	}
 
 	void BulletPhysicsEngine::SetBodyCollisionShape(ECS::Entity body, Physics::CollisionShape shape)
@@ -157,7 +185,7 @@ namespace Lina::Physics
 		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
 		phy.m_collisionShape = shape;
 
-		if (phy.m_isSimulated)
+		if (s_bodies.find(body) != s_bodies.end())
 		{
 			btRigidBody* rb = s_bodies[body];
 			btCollisionShape* previousShape = rb->getCollisionShape();
@@ -171,7 +199,7 @@ namespace Lina::Physics
 		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
 		phy.m_mass = mass;
 		
-		if (phy.m_isSimulated)
+		if (phy.m_simType == SimulationType::Dynamic && s_bodies.find(body) != s_bodies.end())
 		{
 			btRigidBody* rb = s_bodies[body];
 			btVector3 localInertia(0, 0, 0);
@@ -186,7 +214,7 @@ namespace Lina::Physics
 		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
 		phy.m_radius = radius;
 
-		if (phy.m_isSimulated)
+		if (s_bodies.find(body) != s_bodies.end())
 		{
 			SetBodyCollisionShape(body, phy.m_collisionShape);
 		}
@@ -195,9 +223,9 @@ namespace Lina::Physics
 	void BulletPhysicsEngine::SetBodyHeight(ECS::Entity body, float height)
 	{
 		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
-		phy.m_capsuleHeight = height;
+		phy.m_capsuleHalfHeight = height;
 
-		if (phy.m_isSimulated)
+		if (s_bodies.find(body) != s_bodies.end())
 		{
 			SetBodyCollisionShape(body, phy.m_collisionShape);
 		}
@@ -208,7 +236,7 @@ namespace Lina::Physics
 		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
 		phy.m_halfExtents = extents;
 
-		if (phy.m_isSimulated)
+		if (s_bodies.find(body) != s_bodies.end())
 		{
 			SetBodyCollisionShape(body, phy.m_collisionShape);
 		}
@@ -225,6 +253,7 @@ namespace Lina::Physics
 	{
 		btRigidBody* rb = s_bodies[body];
 		m_world->removeRigidBody(rb);
+		m_activeBodies.erase(std::remove(m_activeBodies.begin(), m_activeBodies.end(), rb), m_activeBodies.end());
 		delete rb->getMotionState();
 		delete rb->getCollisionShape();
 		delete rb;
@@ -233,53 +262,202 @@ namespace Lina::Physics
 
 	void BulletPhysicsEngine::AddBodyToWorld(ECS::Entity body)
 	{
-		LINA_TRACE("Rigidbody");
 		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
 		auto& data = ECS::Registry::Get()->get<ECS::EntityDataComponent>(body);
-		Vector3 location = data.GetLocation();
-		Quaternion rotation = data.GetRotation();
+		const float mass = phy.m_simType == SimulationType::Dynamic ? phy.m_mass : 0.0f;
 
+		btRigidBody* rb = CreateRigidBody(GetCreateCollisionShape(phy), mass, data.GetLocation(), data.GetRotation(), body);
+		rb->setLinearVelocity(ToBtVector(phy.m_velocity));
+		rb->setAngularVelocity(ToBtVector(phy.m_angularVelocity));
+
+		// The filter group holds the query layers.
+		s_bodies[body] = rb;
+		m_world->addRigidBody(rb, (int)phy.m_queryLayers, btBroadphaseProxy::AllFilter);
+	}
+
+	btRigidBody* BulletPhysicsEngine::CreateRigidBody(btCollisionShape* shape, float mass, const Vector3& location, const Quaternion& rotation, ECS::Entity body)
+	{
 		btTransform transform;
 		transform.setIdentity();
-		transform.setOrigin(btVector3(location.x, location.y, location.z));
-		transform.setRotation(btQuaternion(rotation.x, rotation.y, rotation.z, rotation.w));
-		btScalar mass(phy.m_mass);
-		btVector3 localInertia(0, 0, 0);
+		transform.setOrigin(ToBtVector(location));
+		transform.setRotation(ToBtQuat(rotation));
 
-		// rigidbody is dynamic if and only if mass is non zero, otherwise static
-		bool isDynamic = (mass != 0.0f);
-		btCollisionShape* colShape = GetCreateCollisionShape(phy);
-		if (isDynamic)
-			colShape->calculateLocalInertia(mass, localInertia);
+		// Rigidbody is dynamic if and only if mass is non zero, otherwise static.
+		btVector3 localInertia(0, 0, 0);
+		if (mass != 0.0f)
+			shape->calculateLocalInertia(btScalar(mass), localInertia);
 
 		btDefaultMotionState* motionState = new btDefaultMotionState(transform);
-		btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState, colShape, localInertia);
+		btRigidBody::btRigidBodyConstructionInfo rbInfo(btScalar(mass), motionState, shape, localInertia);
 		btRigidBody* rb = new btRigidBody(rbInfo);
-		rb->setLinearVelocity(ToBtVector(phy.m_velocity));
-		rb->setAngularVelocity(ToBtVector(phy.m_angularVelocity));
-		rb->setPushVelocity(ToBtVector(phy.m_pushVelocity));
-		rb->setTurnVelocity(ToBtVector(phy.m_turnVelocity));
 
-		s_bodies[body] = rb;
-		m_world->addRigidBody(rb);
+		// Queries & the sync map bodies back to their entities through the user index.
+		rb->setUserIndex((int)entt::to_integral(body));
+		return rb;
 	}
 
-	btCollisionShape* BulletPhysicsEngine::GetCreateCollisionShape(ECS::PhysicsComponent rb)
+	void BulletPhysicsEngine::SetBodyQueryLayers(ECS::Entity body, uint32 layers)
 	{
-		btCollisionShape* colShape = nullptr;
+		auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+		phy.m_queryLayers = layers;
+
+		if (s_bodies.find(body) != s_bodies.end() && s_bodies[body]->getBroadphaseHandle() != nullptr)
+			s_bodies[body]->getBroadphaseHandle()->m_collisionFilterGroup = (int)layers;
+	}
 
+	namespace
+	{
+		const uint32 QuerySliceSize = 256;
+
+		template <typename Fn> void ForEachQuerySlice(uint32 count, Fn&& fn)
+		{
+			const uint32 slices = (count + QuerySliceSize - 1) / QuerySliceSize;
+
+#ifdef BT_THREADSAFE
+			Executor& executor = GetSharedExecutor();
+
+			if (slices > 1 && executor.this_worker_id() < 0)
+			{
+				TaskFlow taskflow;
+				taskflow.for_each_index(0u, slices, 1u, [&](uint32 slice) { fn(slice, slice * QuerySliceSize, std::min((slice + 1) * QuerySliceSize, count)); });
+				executor.run(taskflow).wait();
+				return;
+			}
+#endif
+
+			for (uint32 slice = 0; slice < slices; slice++)
+				fn(slice, slice * QuerySliceSize, std::min((slice + 1) * QuerySliceSize, count));
+		}
+
+		std::unique_ptr<btConvexShape> ToBtShape(const QueryGeometry& geometry)
+		{
+			if (geometry.m_shape == QueryShape::Box)
+				return std::make_unique<btBoxShape>(ToBtVector(geometry.m_halfExtents));
+			else if (geometry.m_shape == QueryShape::Capsule)
+				return std::make_unique<btCapsuleShape>(btScalar(geometry.m_radius), btScalar(geometry.m_halfHeight * 2.0f));
+
+			return std::make_unique<btSphereShape>(btScalar(geometry.m_radius));
+		}
+
+		ECS::Entity ToEntity(const btCollisionObject* object)
+		{
+			return (ECS::Entity)(uint32)object->getUserIndex();
+		}
+
+		struct OverlapCallback : public btCollisionWorld::ContactResultCallback
+		{
+			std::vector<ECS::Entity> m_entities;
+			uint32 m_maxHits = 0;
+
+			virtual btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0, const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1) override
+			{
+				// The query object is always the first one, bodies report a contact per manifold point.
+				const ECS::Entity entity = ToEntity(colObj1Wrap->getCollisionObject());
+
+				if (m_entities.size() < m_maxHits && std::find(m_entities.begin(), m_entities.end(), entity) == m_entities.end())
+					m_entities.push_back(entity);
+
+				return 0;
+			}
+		};
+	} // namespace
+
+	void BulletPhysicsEngine::Raycast(const RaycastQuery* queries, uint32 count, HitInfo* hits)
+	{
+		ForEachQuerySlice(count, [&](uint32, uint32 begin, uint32 end) {
+			for (uint32 i = begin; i < end; i++)
+			{
+				const RaycastQuery& query = queries[i];
+				const btVector3 from = ToBtVector(query.m_origin);
+				const btVector3 to = ToBtVector(query.m_origin + query.m_unitDir * query.m_distance);
+				btCollisionWorld::ClosestRayResultCallback callback(from, to);
+				callback.m_collisionFilterMask = (int)query.m_layerMask;
+				m_world->rayTest(from, to, callback);
+
+				hits[i] = HitInfo();
+				if (callback.hasHit())
+				{
+					hits[i].m_hitCount = 1;
+					hits[i].m_entity = ToEntity(callback.m_collisionObject);
+					hits[i].m_position = ToLinaVector(callback.m_hitPointWorld);
+					hits[i].m_normal = ToLinaVector(callback.m_hitNormalWorld);
+					hits[i].m_distance = callback.m_closestHitFraction * query.m_distance;
+				}
+			}
+		});
+	}
+
+	void BulletPhysicsEngine::Sweep(const SweepQuery* queries, uint32 count, HitInfo* hits)
+	{
+		ForEachQuerySlice(count, [&](uint32, uint32 begin, uint32 end) {
+			for (uint32 i = begin; i < end; i++)
+			{
+				const SweepQuery& query = queries[i];
+				std::unique_ptr<btConvexShape> shape = ToBtShape(query.m_geometry);
+				const btTransform from(ToBtQuat(query.m_rotation), ToBtVector(query.m_origin));
+				const btTransform to(ToBtQuat(query.m_rotation), ToBtVector(query.m_origin + query.m_unitDir * query.m_distance));
+				btCollisionWorld::ClosestConvexResultCallback callback(from.getOrigin(), to.getOrigin());
+				callback.m_collisionFilterMask = (int)query.m_layerMask;
+				m_world->convexSweepTest(shape.get(), from, to, callback);
+
+				hits[i] = HitInfo();
+				if (callback.hasHit())
+				{
+					hits[i].m_hitCount = 1;
+					hits[i].m_entity = ToEntity(callback.m_hitCollisionObject);
+					hits[i].m_position = ToLinaVector(callback.m_hitPointWorld);
+					hits[i].m_normal = ToLinaVector(callback.m_hitNormalWorld);
+					hits[i].m_distance = callback.m_closestHitFraction * query.m_distance;
+				}
+			}
+		});
+	}
+
+	void BulletPhysicsEngine::Overlap(const OverlapQuery* queries, uint32 count, std::vector<OverlapHit>& hits, uint32 maxHitsPerQuery)
+	{
+		std::vector<std::vector<OverlapHit>> sliceHits((count + QuerySliceSize - 1) / QuerySliceSize);
+
+		ForEachQuerySlice(count, [&](uint32 slice, uint32 begin, uint32 end) {
+			for (uint32 i = begin; i < end; i++)
+			{
+				const OverlapQuery& query = queries[i];
+				std::unique_ptr<btConvexShape> shape = ToBtShape(query.m_geometry);
+				btCollisionObject object;
+				object.setCollisionShape(shape.get());
+				object.setWorldTransform(btTransform(ToBtQuat(query.m_rotation), ToBtVector(query.m_position)));
+
+				OverlapCallback callback;
+				callback.m_collisionFilterMask = (int)query.m_layerMask;
+				callback.m_maxHits = maxHitsPerQuery;
+				m_world->contactTest(&object, callback);
+
+				for (ECS::Entity entity : callback.m_entities)
+					sliceHits[slice].push_back(OverlapHit{i, entity});
+			}
+		});
+
+		hits.clear();
+
+		for (auto& slice : sliceHits)
+			hits.insert(hits.end(), slice.begin(), slice.end());
+	}
+
+	btCollisionShape* BulletPhysicsEngine::GetCreateCollisionShape(ECS::PhysicsComponent& rb)
+	{
+		return CreateCollisionShape(rb.m_collisionShape, rb.m_halfExtents, rb.m_radius, rb.m_capsuleHalfHeight);
+	}
+
+	btCollisionShape* BulletPhysicsEngine::CreateCollisionShape(CollisionShape shape, const Vector3& halfExtents, float radius, float capsuleHalfHeight)
+	{
 		// Build collision shape depending on the type
-		if (rb.m_collisionShape == CollisionShape::Box)
-			colShape = new btBoxShape(btVector3(rb.m_halfExtents.x, rb.m_halfExtents.y, rb.m_halfExtents.z));
-		else if (rb.m_collisionShape == CollisionShape::Sphere)
-			colShape = new btSphereShape(btScalar(rb.m_radius));
-		else if (rb.m_collisionShape == CollisionShape::Capsule)
-			colShape = new btCapsuleShape(btScalar(rb.m_radius), btScalar(rb.m_capsuleHeight));
-		else if (rb.m_collisionShape == CollisionShape::Cylinder)
-			colShape = new btCylinderShape(btVector3(rb.m_halfExtents.x, rb.m_halfExtents.y, rb.m_halfExtents.z));
-
-		return colShape;
+		if (shape == CollisionShape::Sphere)
+			return new btSphereShape(btScalar(radius));
+		else if (shape == CollisionShape::Capsule)
+			return new btCapsuleShape(btScalar(radius), btScalar(capsuleHalfHeight * 2.0f));
+		else if (shape == CollisionShape::Cylinder)
+			return new btCylinderShape(ToBtVector(halfExtents));
+
+		return new btBoxShape(ToBtVector(halfExtents));
 	}
 
 }
-
@@ -0,0 +1,108 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/Bullet/BulletTaskScheduler.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace Lina::Physics
+{
+	void BulletTaskScheduler::SetExecutor(Executor* executor)
+	{
+		m_executor = executor;
+		m_numThreads = getMaxNumThreads();
+	}
+
+	int BulletTaskScheduler::getMaxNumThreads() const
+	{
+		if (m_executor == nullptr)
+			return 1;
+
+		return std::min((int)m_executor->num_workers() + 1, (int)BT_MAX_THREAD_COUNT);
+	}
+
+	int BulletTaskScheduler::getNumThreads() const
+	{
+		return m_numThreads;
+	}
+
+	void BulletTaskScheduler::setNumThreads(int numThreads)
+	{
+		m_numThreads = std::max(1, std::min(numThreads, getMaxNumThreads()));
+	}
+
+	bool BulletTaskScheduler::RunsInline(int chunks) const
+	{
+		return chunks <= 1 || m_numThreads <= 1 || m_executor == nullptr || m_executor->this_worker_id() >= 0;
+	}
+
+	void BulletTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+	{
+		const int grain = std::max(grainSize, 1);
+		const int chunks = (iEnd - iBegin + grain - 1) / grain;
+
+		if (RunsInline(chunks))
+		{
+			if (iEnd > iBegin)
+				body.forLoop(iBegin, iEnd);
+			return;
+		}
+
+		TaskFlow taskflow;
+		taskflow.for_each_index(0, chunks, 1, [&](int chunk) {
+			const int begin = iBegin + chunk * grain;
+			body.forLoop(begin, std::min(begin + grain, iEnd));
+		});
+		m_executor->run(taskflow).wait();
+	}
+
+	btScalar BulletTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+	{
+		const int grain = std::max(grainSize, 1);
+		const int chunks = (iEnd - iBegin + grain - 1) / grain;
+
+		if (RunsInline(chunks))
+			return iEnd > iBegin ? body.sumLoop(iBegin, iEnd) : btScalar(0);
+
+		// Chunks are summed in order, so the result doesn't depend on the scheduling.
+		std::vector<btScalar> sums(chunks, btScalar(0));
+
+		TaskFlow taskflow;
+		taskflow.for_each_index(0, chunks, 1, [&](int chunk) {
+			const int begin = iBegin + chunk * grain;
+			sums[chunk] = body.sumLoop(begin, std::min(begin + grain, iEnd));
+		});
+		m_executor->run(taskflow).wait();
+
+		btScalar sum = btScalar(0);
+		for (btScalar chunkSum : sums)
+			sum += chunkSum;
+
+		return sum;
+	}
+}
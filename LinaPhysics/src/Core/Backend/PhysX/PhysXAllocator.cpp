@@ -0,0 +1,181 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXAllocator.hpp"
+
+#include "Log/Log.hpp"
+#include "Memory/Memory.hpp"
+#include "Memory/MemoryStats.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace Lina::Physics
+{
+    namespace
+    {
+        // Keeps the returned block 16 byte aligned as PhysX requires.
+        struct PhysXAllocationHeader
+        {
+            uint64 m_size     = 0;
+            uint32 m_category = 0;
+            uint32 m_step     = 0;
+        };
+
+        static_assert(sizeof(PhysXAllocationHeader) == 16, "PhysX allocation header must keep 16 byte alignment!");
+
+        const uint32 ScratchGranularity = 16 * 1024;
+
+        thread_local int32 t_allocatorScope = -1;
+    } // namespace
+
+    PhysXAllocator::Scope::Scope(PhysXMemoryCategory category)
+    {
+        m_previous       = t_allocatorScope;
+        t_allocatorScope = (int32)category;
+    }
+
+    PhysXAllocator::Scope::~Scope()
+    {
+        t_allocatorScope = m_previous;
+    }
+
+    PhysXAllocator::PhysXAllocator()
+    {
+        m_categories[(uint32)PhysXMemoryCategory::Scene]         = MemoryStats::GetCategory("PhysX/Scene");
+        m_categories[(uint32)PhysXMemoryCategory::Simulation]    = MemoryStats::GetCategory("PhysX/Simulation");
+        m_categories[(uint32)PhysXMemoryCategory::Cooking]       = MemoryStats::GetCategory("PhysX/Cooking");
+        m_categories[(uint32)PhysXMemoryCategory::Serialization] = MemoryStats::GetCategory("PhysX/Serialization");
+        m_scratchCategory                                        = MemoryStats::GetCategory("PhysX/Scratch");
+    }
+
+    PhysXAllocator::~PhysXAllocator()
+    {
+        ResizeScratch(0);
+    }
+
+    void* PhysXAllocator::allocate(size_t size, const char*, const char*, int)
+    {
+        const bool isSimulating = m_isSimulating.load(std::memory_order_relaxed);
+        uint32     category     = (uint32)(isSimulating ? PhysXMemoryCategory::Simulation : PhysXMemoryCategory::Scene);
+
+        if (t_allocatorScope >= 0)
+            category = (uint32)t_allocatorScope;
+
+        uint8*                 block  = (uint8*)Memory::malloc(size + sizeof(PhysXAllocationHeader), 16);
+        PhysXAllocationHeader* header = new (block) PhysXAllocationHeader();
+        header->m_size                = (uint64)size;
+        header->m_category            = category;
+        m_categories[category]->OnAllocate(size);
+
+        // Simulation allocations freed within the same step are the ones the scratch block could have served.
+        if (isSimulating && category == (uint32)PhysXMemoryCategory::Simulation)
+        {
+            header->m_step       = m_step.load(std::memory_order_relaxed);
+            const uint64 current = (uint64)(m_stepTemporaryBytes.fetch_add((int64)size, std::memory_order_relaxed) + (int64)size);
+            uint64       peak    = m_stepTemporaryPeak.load(std::memory_order_relaxed);
+
+            while (current > peak && !m_stepTemporaryPeak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        return block + sizeof(PhysXAllocationHeader);
+    }
+
+    void PhysXAllocator::deallocate(void* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        uint8*                 block  = (uint8*)ptr - sizeof(PhysXAllocationHeader);
+        PhysXAllocationHeader* header = (PhysXAllocationHeader*)block;
+        m_categories[header->m_category]->OnFree(header->m_size);
+
+        if (header->m_step != 0 && header->m_step == m_step.load(std::memory_order_relaxed) && m_isSimulating.load(std::memory_order_relaxed))
+            m_stepTemporaryBytes.fetch_sub((int64)header->m_size, std::memory_order_relaxed);
+
+        Memory::free(block);
+    }
+
+    void PhysXAllocator::SetScratchSize(uint32 size, uint32 maxSize)
+    {
+        m_scratchMaxSize = (std::max(size, maxSize) + ScratchGranularity - 1) / ScratchGranularity * ScratchGranularity;
+        ResizeScratch((size + ScratchGranularity - 1) / ScratchGranularity * ScratchGranularity);
+    }
+
+    void PhysXAllocator::BeginStep()
+    {
+        // Step ids start from 1, 0 marks allocations made outside of a step.
+        uint32 step = m_step.load(std::memory_order_relaxed) + 1;
+        m_step.store(step == 0 ? 1 : step, std::memory_order_relaxed);
+        m_stepTemporaryBytes.store(0, std::memory_order_relaxed);
+        m_stepTemporaryPeak.store(0, std::memory_order_relaxed);
+        m_isSimulating.store(true, std::memory_order_release);
+    }
+
+    void PhysXAllocator::EndStep()
+    {
+        m_isSimulating.store(false, std::memory_order_release);
+
+        // Allocations still alive outlast the step, e.g. new contact pairs, the scratch block couldn't have served them.
+        const int64  live    = std::max(m_stepTemporaryBytes.load(std::memory_order_relaxed), (int64)0);
+        const uint64 peak    = m_stepTemporaryPeak.load(std::memory_order_relaxed);
+        const uint64 spilled = peak > (uint64)live ? peak - (uint64)live : 0;
+        m_stepTemporaryPeak.store(spilled, std::memory_order_relaxed);
+
+        if (spilled == 0 || m_scratchSize >= m_scratchMaxSize)
+            return;
+
+        const uint64 wanted = ((uint64)m_scratchSize + spilled + ScratchGranularity - 1) / ScratchGranularity * ScratchGranularity;
+        const uint32 size   = (uint32)std::min(wanted, (uint64)m_scratchMaxSize);
+        LINA_TRACE("[Physics Engine] -> Step needed {0} bytes of temporary memory, growing the scratch block to {1} bytes.", spilled, size);
+        ResizeScratch(size);
+    }
+
+    void PhysXAllocator::ResizeScratch(uint32 size)
+    {
+        if (size == m_scratchSize)
+            return;
+
+        if (m_scratchBlock != nullptr)
+        {
+            m_scratchCategory->OnFree(m_scratchSize);
+            Memory::free(m_scratchBlock);
+            m_scratchBlock = nullptr;
+        }
+
+        m_scratchSize = size;
+
+        if (m_scratchSize > 0)
+        {
+            m_scratchBlock = Memory::malloc(m_scratchSize, 16);
+            m_scratchCategory->OnAllocate(m_scratchSize);
+        }
+    }
+} // namespace Lina::Physics
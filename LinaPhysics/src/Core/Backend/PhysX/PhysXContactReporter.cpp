@@ -0,0 +1,167 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXContactReporter.hpp"
+
+#include "Core/PhysicsCommon.hpp"
+
+#include <PxPhysicsAPI.h>
+
+namespace Lina::Physics
+{
+    using namespace physx;
+
+    namespace
+    {
+        // Points of a pair read per report, only the first one & the summed impulse are kept.
+        const PxU32 MaxReportedPoints = 16;
+    } // namespace
+
+    PxFilterFlags PhysXContactReporter::FilterShader(PxFilterObjectAttributes attributes0, PxFilterData filterData0, PxFilterObjectAttributes attributes1, PxFilterData filterData1, PxPairFlags& pairFlags, const void* constantBlock, PxU32 constantBlockSize)
+    {
+        const bool reported = (filterData0.word1 & filterData1.word0) != 0 || (filterData1.word1 & filterData0.word0) != 0;
+
+        if (PxFilterObjectIsTrigger(attributes0) || PxFilterObjectIsTrigger(attributes1))
+        {
+            if (!reported)
+                return PxFilterFlag::eSUPPRESS;
+
+            pairFlags = PxPairFlag::eTRIGGER_DEFAULT;
+            return PxFilterFlag::eDEFAULT;
+        }
+
+        pairFlags = PxPairFlag::eCONTACT_DEFAULT;
+
+        if (reported)
+        {
+            pairFlags |= PxPairFlag::eNOTIFY_TOUCH_FOUND | PxPairFlag::eNOTIFY_TOUCH_LOST | PxPairFlag::eNOTIFY_CONTACT_POINTS;
+
+            if (((filterData0.word2 | filterData1.word2) & ReportPersistent) != 0)
+                pairFlags |= PxPairFlag::eNOTIFY_TOUCH_PERSISTS;
+        }
+
+        return PxFilterFlag::eDEFAULT;
+    }
+
+    PxFilterData PhysXContactReporter::MakeFilterData(uint32 contactLayers, uint32 reportMask, bool reportPersistent)
+    {
+        return PxFilterData(contactLayers, reportMask, reportPersistent ? ReportPersistent : 0, 0);
+    }
+
+    void PhysXContactReporter::SetCapacity(uint32 contacts, uint32 triggers)
+    {
+        m_contacts.resize(contacts);
+        m_triggers.resize(triggers);
+        BeginStep();
+    }
+
+    void PhysXContactReporter::BeginStep()
+    {
+        m_contactCount = 0;
+        m_triggerCount = 0;
+        m_droppedCount = 0;
+    }
+
+    void PhysXContactReporter::onContact(const physx::PxContactPairHeader& pairHeader, const physx::PxContactPair* pairs, physx::PxU32 nbPairs)
+    {
+        // Actors released during the step can't be mapped back to their entities.
+        if (pairHeader.flags & (PxContactPairHeaderFlag::eREMOVED_ACTOR_0 | PxContactPairHeaderFlag::eREMOVED_ACTOR_1))
+            return;
+
+        const ECS::Entity entity0 = ToLinaEntity(pairHeader.actors[0]->userData);
+        const ECS::Entity entity1 = ToLinaEntity(pairHeader.actors[1]->userData);
+
+        for (PxU32 i = 0; i < nbPairs; i++)
+        {
+            const PxContactPair& pair = pairs[i];
+            ContactEvent         event;
+
+            if (pair.events & PxPairFlag::eNOTIFY_TOUCH_FOUND)
+                event = ContactEvent::Begin;
+            else if (pair.events & PxPairFlag::eNOTIFY_TOUCH_PERSISTS)
+                event = ContactEvent::Persist;
+            else if (pair.events & PxPairFlag::eNOTIFY_TOUCH_LOST)
+                event = ContactEvent::End;
+            else
+                continue;
+
+            if (m_contactCount == (uint32)m_contacts.size())
+            {
+                m_droppedCount++;
+                continue;
+            }
+
+            ContactReport& report = m_contacts[m_contactCount++];
+            report.m_entity0      = entity0;
+            report.m_entity1      = entity1;
+            report.m_event        = event;
+            report.m_point        = Vector3::Zero;
+            report.m_normal       = Vector3::Zero;
+            report.m_impulse      = 0.0f;
+            report.m_points       = 0;
+
+            if (pair.contactCount == 0)
+                continue;
+
+            PxContactPairPoint points[MaxReportedPoints];
+            const PxU32        count = pair.extractContacts(points, MaxReportedPoints);
+
+            if (count > 0)
+            {
+                report.m_point  = ToLinaVector3(points[0].position);
+                report.m_normal = ToLinaVector3(points[0].normal);
+                report.m_points = (uint32)pair.contactCount;
+
+                for (PxU32 j = 0; j < count; j++)
+                    report.m_impulse += points[j].impulse.magnitude();
+            }
+        }
+    }
+
+    void PhysXContactReporter::onTrigger(physx::PxTriggerPair* pairs, physx::PxU32 count)
+    {
+        for (PxU32 i = 0; i < count; i++)
+        {
+            const PxTriggerPair& pair = pairs[i];
+
+            if (pair.flags & (PxTriggerPairFlag::eREMOVED_SHAPE_TRIGGER | PxTriggerPairFlag::eREMOVED_SHAPE_OTHER))
+                continue;
+
+            if (m_triggerCount == (uint32)m_triggers.size())
+            {
+                m_droppedCount++;
+                continue;
+            }
+
+            TriggerReport& report = m_triggers[m_triggerCount++];
+            report.m_trigger      = ToLinaEntity(pair.triggerActor->userData);
+            report.m_other        = ToLinaEntity(pair.otherActor->userData);
+            report.m_event        = pair.status == PxPairFlag::eNOTIFY_TOUCH_LOST ? ContactEvent::End : ContactEvent::Begin;
+        }
+    }
+} // namespace Lina::Physics
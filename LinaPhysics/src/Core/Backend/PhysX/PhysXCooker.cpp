@@ -26,131 +26,252 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include "Core/Backend/PhysX/PhysXAllocator.hpp"
 #include "Core/Backend/PhysX/PhysXCooker.hpp"
 
-#include "Core/Backend/PhysX/PhysXPhysicsEngine.hpp"
 #include "EventSystem/EventSystem.hpp"
 #include "EventSystem/MainLoopEvents.hpp"
 #include "EventSystem/ResourceEvents.hpp"
+#include "Core/PhysicsCommon.hpp"
 #include "Log/Log.hpp"
 
 #include <PxPhysicsAPI.h>
+#include <cstring>
 
 namespace Lina::Physics
 {
     using namespace physx;
 
-    PxCooking* m_pxCooking = nullptr;
+    namespace
+    {
+        // Part of the cache key, bump the format if the cooking parameters below change.
+        const uint32 CookingFormat     = 1;
+        const uint16 ConvexVertexLimit = 64;
+    } // namespace
 
-    void PhysXCooker::Initialize(ApplicationMode appMode, physx::PxFoundation* foundation)
+    void PhysXCooker::Initialize(ApplicationMode appMode, physx::PxFoundation* foundation, physx::PxPhysics* physics)
     {
-        m_appMode   = appMode;
-        m_pxCooking = PxCreateCooking(PX_PHYSICS_VERSION, *foundation, PxCookingParams(PxTolerancesScale()));
+        m_appMode = appMode;
+        CreateCooking(foundation, physics);
         Event::EventSystem::Get()->Connect<Event::EShutdown, &PhysXCooker::OnShutdown>(this);
+        Event::EventSystem::Get()->Connect<Event::EModelCollisionMeshesLoaded, &PhysXCooker::OnModelCollisionMeshesLoaded>(this);
+        Event::EventSystem::Get()->Connect<Event::EResourceUnloaded, &PhysXCooker::OnResourceUnloaded>(this);
+    }
+
+    void PhysXCooker::CreateCooking(physx::PxFoundation* foundation, physx::PxPhysics* physics)
+    {
+        PxCookingParams params(physics->getTolerancesScale());
+        params.midphaseDesc.setToDefault(PxMeshMidPhase::eBVH34);
+
+        m_physics = physics;
+        m_cooking = PxCreateCooking(PX_PHYSICS_VERSION, *foundation, params);
+    }
+
+    void PhysXCooker::ReleaseCooking()
+    {
+        std::vector<StringIDType> models;
+        for (auto& pair : m_meshes)
+            models.push_back(pair.first);
+
+        for (StringIDType model : models)
+            ReleaseCollisionMeshes(model);
+
+        if (m_cooking != nullptr)
+            m_cooking->release();
+
+        m_cooking = nullptr;
+    }
+
+    void PhysXCooker::OnShutdown(const Event::EShutdown& ev)
+    {
+        ReleaseCooking();
     }
 
-    void PhysXCooker::CookConvexMesh(std::vector<Vector3>& vertices, std::vector<uint8>& bufferData)
+    uint64 PhysXCooker::GetCacheKey(const CollisionMeshSource& mesh)
     {
-        PxConvexMeshDesc convexDesc;
-        convexDesc.points.count  = (PxU32)vertices.size();
-        convexDesc.points.stride = sizeof(Vector3);
-        convexDesc.points.data   = &vertices[0];
-        convexDesc.flags         = PxConvexFlag::eCOMPUTE_CONVEX;
-
-        PxDefaultMemoryOutputStream     buf;
-        PxConvexMeshCookingResult::Enum result;
-        if (!m_pxCooking->cookConvexMesh(convexDesc, buf, &result))
+        const uint32 parameters[4] = {CookingFormat, PX_PHYSICS_VERSION, ConvexVertexLimit, (uint32)PxMeshMidPhase::eBVH34};
+
+        uint64 hash = HashSeed;
+        hash        = HashBytes(hash, parameters, sizeof(parameters));
+        hash        = HashBytes(hash, &mesh.m_vertexCount, sizeof(uint32));
+        hash        = HashBytes(hash, &mesh.m_indexCount, sizeof(uint32));
+        hash        = HashBytes(hash, mesh.m_positions, sizeof(float) * 3 * mesh.m_vertexCount);
+        hash        = HashBytes(hash, mesh.m_indices, sizeof(uint32) * mesh.m_indexCount);
+        return hash;
+    }
+
+    void PhysXCooker::Cook(const CollisionMeshSource& mesh, CookedCollisionMesh& cooked)
+    {
+        PhysXAllocator::Scope scope(PhysXMemoryCategory::Cooking);
+        cooked.m_convexData.clear();
+        cooked.m_triangleData.clear();
+
+        // Streams left empty are stored too, so failed meshes aren't cooked again on every load.
+        if (mesh.m_vertexCount >= 4)
+        {
+            PxConvexMeshDesc convexDesc;
+            convexDesc.points.count  = (PxU32)mesh.m_vertexCount;
+            convexDesc.points.stride = sizeof(float) * 3;
+            convexDesc.points.data   = mesh.m_positions;
+            convexDesc.flags         = PxConvexFlag::eCOMPUTE_CONVEX;
+            convexDesc.vertexLimit   = ConvexVertexLimit;
+
+            PxDefaultMemoryOutputStream buf;
+            if (m_cooking->cookConvexMesh(convexDesc, buf))
+                cooked.m_convexData.assign(buf.getData(), buf.getData() + buf.getSize());
+            else
+                LINA_ERR("[PhysX Cooker] -> Cooking convex mesh failed, {0} vertices.", mesh.m_vertexCount);
+        }
+
+        if (mesh.m_indexCount >= 3)
+        {
+            PxTriangleMeshDesc triangleDesc;
+            triangleDesc.points.count     = (PxU32)mesh.m_vertexCount;
+            triangleDesc.points.stride    = sizeof(float) * 3;
+            triangleDesc.points.data      = mesh.m_positions;
+            triangleDesc.triangles.count  = (PxU32)mesh.m_indexCount / 3;
+            triangleDesc.triangles.stride = sizeof(uint32) * 3;
+            triangleDesc.triangles.data   = mesh.m_indices;
+
+            PxDefaultMemoryOutputStream buf;
+            if (m_cooking->cookTriangleMesh(triangleDesc, buf))
+                cooked.m_triangleData.assign(buf.getData(), buf.getData() + buf.getSize());
+            else
+                LINA_ERR("[PhysX Cooker] -> Cooking triangle mesh failed, {0} triangles.", mesh.m_indexCount / 3);
+        }
+    }
+
+    bool PhysXCooker::LoadCollisionMeshes(StringIDType model, const std::vector<CollisionMeshSource>& meshes, std::map<uint64, CookedCollisionMesh>& cache)
+    {
+        std::vector<CollisionMesh>            created(meshes.size());
+        std::map<uint64, CookedCollisionMesh> used;
+        uint32                                cookedCount = 0;
+
+        for (size_t i = 0; i < meshes.size(); i++)
         {
-            LINA_ERR("Cooking convex mesh failed! {0}", typeid(*this).name());
-            return;
+            const uint64 key = GetCacheKey(meshes[i]);
+            auto         it  = used.find(key);
+
+            // Identical meshes share the entry.
+            if (it == used.end())
+            {
+                auto cached = cache.find(key);
+
+                if (cached != cache.end())
+                    it = used.emplace(key, std::move(cached->second)).first;
+                else
+                {
+                    it = used.emplace(key, CookedCollisionMesh()).first;
+                    Cook(meshes[i], it->second);
+                    cookedCount++;
+                }
+            }
+
+            const CookedCollisionMesh& cooked = it->second;
+            created[i].m_key                  = key;
+
+            if (!cooked.m_convexData.empty())
+            {
+                PxDefaultMemoryInputData input(const_cast<PxU8*>(cooked.m_convexData.data()), (PxU32)cooked.m_convexData.size());
+                created[i].m_convex = m_physics->createConvexMesh(input);
+            }
+
+            if (!cooked.m_triangleData.empty())
+            {
+                PxDefaultMemoryInputData input(const_cast<PxU8*>(cooked.m_triangleData.data()), (PxU32)cooked.m_triangleData.size());
+                created[i].m_triangles = m_physics->createTriangleMesh(input);
+            }
         }
 
-        bufferData.clear();
-        bufferData = std::vector<uint8>(buf.getData(), buf.getData() + buf.getSize());
+        const bool cacheUpdated = cookedCount > 0 || used.size() != cache.size();
+        cache.swap(used);
+
+        ReleaseCollisionMeshes(model);
 
-        PxDefaultMemoryInputData input(buf.getData(), buf.getSize());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_meshes[model].swap(created);
+        }
 
-        // LINA_TRACE("Cooked! Creating convex mesh with sid {0} and node id {1}", sid, nodeIndex);
+        if (cookedCount > 0)
+            LINA_TRACE("[PhysX Cooker] -> Cooked {0} of {1} collision meshes.", cookedCount, meshes.size());
 
-        // PHYSICSENGINE CreateConvexMesh(bufferData, sid, nodeIndex);
+        return cacheUpdated;
     }
 
-    void PhysXCooker::OnShutdown(const Event::EShutdown& ev)
+    void PhysXCooker::ReleaseCollisionMeshes(StringIDType model)
     {
-        m_pxCooking->release();
+        std::vector<CollisionMesh> meshes;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto                        it = m_meshes.find(model);
+
+            if (it == m_meshes.end())
+                return;
+
+            meshes.swap(it->second);
+            m_meshes.erase(it);
+        }
+
+        for (CollisionMesh& mesh : meshes)
+        {
+            if (mesh.m_convex != nullptr)
+                mesh.m_convex->release();
+
+            if (mesh.m_triangles != nullptr)
+                mesh.m_triangles->release();
+        }
+    }
+
+    physx::PxConvexMesh* PhysXCooker::GetConvexMesh(StringIDType model, uint32 meshIndex)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto                        it = m_meshes.find(model);
+        return it != m_meshes.end() && meshIndex < it->second.size() ? it->second[meshIndex].m_convex : nullptr;
     }
 
-    void PhysXCooker::CookModelNodeVertices(Graphics::ModelNode& node, Graphics::Model& model)
+    physx::PxTriangleMesh* PhysXCooker::GetTriangleMesh(StringIDType model, uint32 meshIndex)
     {
-        std::vector<Vector3> vertices;
-
-        // if (node.m_meshIndexes.size() > 0)
-        //{
-        //	// Get model meshes.
-        //	auto& meshes = model.GetMeshes();
-        //
-        //	// For each mesh attach to this node.
-        //	for (uint32 i = 0; i < node.m_meshIndexes.size(); i++)
-        //	{
-        //		// Get the mesh & it's vertex position data.
-        //		auto& mesh = meshes[node.m_meshIndexes[i]];
-        //		auto& data = mesh.GetVertexPositions();
-        //
-        //		// Add each of the 3 positions to the vertices array.
-        //		for (uint32 j = 0; j < data.m_floatElements.size(); j += 3)
-        //			vertices.push_back(Vector3(data.m_floatElements[j], data.m_floatElements[j + 1], data.m_floatElements[j + 2]));
-        //	}
-        //
-        //	// Now we have a vertex vector, that contains all the vertices from a model node's all meshes.
-        //	// This is the combined vertex data from sub-meshes.
-        //	// Now we cook this data & assign a model & node id to it.
-        //	CookConvexMesh(vertices, model.GetAssetData().m_convexMeshData[node.m_nodeID]);
-        //}
-        //
-        // for (auto& child : node.m_children)
-        //	CookModelNodeVertices(child, model);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto                        it = m_meshes.find(model);
+        return it != m_meshes.end() && meshIndex < it->second.size() ? it->second[meshIndex].m_triangles : nullptr;
     }
 
-    void CreateConvexMeshesFromNodes(Graphics::ModelNode& node, Graphics::Model& model)
+    void PhysXCooker::AddToCollection(physx::PxCollection& collection)
     {
-        // if (node.m_meshIndexes.size() > 0)
-        //{
-        //	Graphics::ModelAssetData& data = model.GetAssetData();
-        //	Physics::PhysicsEngine::Get()->CreateConvexMesh(data.m_convexMeshData[node.m_nodeID], model.GetID(), node.m_nodeID);
-        //}
-        //
-        // for (auto& child : node.m_children)
-        //	CreateConvexMeshesFromNodes(child, model);
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& pair : m_meshes)
+        {
+            for (uint32 i = 0; i < (uint32)pair.second.size(); i++)
+            {
+                const CollisionMesh& mesh   = pair.second[i];
+                const uint64         ids[3] = {(uint64)pair.first, (uint64)i, mesh.m_key};
+                const uint64         id     = HashBytes(HashSeed, ids, sizeof(ids));
+
+                // Convex ids are even & triangle ids odd, neither is ever 0.
+                if (mesh.m_convex != nullptr)
+                    collection.add(*mesh.m_convex, (PxSerialObjectId)((id & ~1ull) | 2ull));
+
+                if (mesh.m_triangles != nullptr)
+                    collection.add(*mesh.m_triangles, (PxSerialObjectId)(id | 1ull));
+            }
+        }
+    }
+
+    void PhysXCooker::OnModelCollisionMeshesLoaded(const Event::EModelCollisionMeshesLoaded& ev)
+    {
+        const bool cacheUpdated = LoadCollisionMeshes(ev.m_sid, *ev.m_meshes, *ev.m_cache);
+
+        if (cacheUpdated && m_appMode == ApplicationMode::Standalone)
+            LINA_WARN("[PhysX Cooker] -> Collision meshes of a model were cooked at runtime, re-import it in the editor to ship them cooked.");
+
+        *ev.m_cacheUpdated = cacheUpdated;
     }
 
-    void PhysXCooker::OnResourceLoadCompleted(const Event::EResourceLoadCompleted& ev)
+    void PhysXCooker::OnResourceUnloaded(const Event::EResourceUnloaded& ev)
     {
-        // Handle convex mesh cooking if the loaded model does not contain any.
-        // if (ev.m_type == Resources::ResourceType::Model)
-        //{
-        //	auto& model = Graphics::Model::GetModel(ev.m_sid);
-        //	auto& meshes = model.GetMeshes();
-        //
-        //	if (m_appMode == ApplicationMode::Editor)
-        //	{
-        //		Graphics::ModelNode& root = model.GetRoot();
-        //
-        //		// If the model parameters does not contain a convex mesh data for the current mesh or regeneration is marked.
-        //		if (model.GetAssetData().m_convexMeshData.size() == 0 || model.GetAssetData().m_regenerateConvexMeshes)
-        //		{
-        //			CookModelNodeVertices(root, model);
-        //			model.SaveAssetData(model.GetAssetDataPath(), model.GetAssetData());
-        //		}
-        //		else
-        //			CreateConvexMeshesFromNodes(root, model);
-        //	}
-        //	else
-        //	{
-        //		if (model.GetAssetData().m_convexMeshData.size() == 0)
-        //			LINA_ERR("You are running in Standalone mode but your loaded models does not contain any convex mesh data. This might result in inaccurate collision simulation! {0}", typeid(*this).name());
-        //
-        //	}
-        //
-        //}
+        ReleaseCollisionMeshes(ev.m_sid);
     }
 } // namespace Lina::Physics
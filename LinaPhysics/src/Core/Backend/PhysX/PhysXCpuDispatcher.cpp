@@ -0,0 +1,142 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXCpuDispatcher.hpp"
+
+#include <chrono>
+
+namespace Lina::Physics
+{
+    PhysXCpuDispatcher::PhysXCpuDispatcher(Executor* executor, uint32 threadBudget)
+    {
+        SetExecutor(executor, threadBudget);
+    }
+
+    PhysXCpuDispatcher::~PhysXCpuDispatcher()
+    {
+        WaitIdle();
+    }
+
+    void PhysXCpuDispatcher::SetExecutor(Executor* executor, uint32 threadBudget)
+    {
+        WaitIdle();
+        m_executor     = executor;
+        m_threadBudget = threadBudget == 0 ? 1 : threadBudget;
+        ResizeCounters();
+    }
+
+    void PhysXCpuDispatcher::ResizeCounters()
+    {
+        m_counterCount = (uint32)m_executor->num_workers();
+        m_counters.reset(new WorkerCounters[m_counterCount]);
+    }
+
+    uint32_t PhysXCpuDispatcher::getWorkerCount() const
+    {
+        return m_threadBudget;
+    }
+
+    void PhysXCpuDispatcher::submitTask(physx::PxBaseTask& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(&task);
+
+            // Running loops will pick it up.
+            if (m_running >= m_threadBudget)
+                return;
+
+            m_running++;
+        }
+
+        m_executor->silent_async([this]() { Drain(); });
+    }
+
+    void PhysXCpuDispatcher::Drain()
+    {
+        const int       worker   = m_executor->this_worker_id();
+        WorkerCounters* counters = worker >= 0 && (uint32)worker < m_counterCount ? &m_counters[worker] : nullptr;
+
+        while (true)
+        {
+            physx::PxBaseTask* task = nullptr;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (m_queue.empty())
+                {
+                    m_running--;
+
+                    if (m_running == 0)
+                        m_idle.notify_all();
+
+                    return;
+                }
+
+                task = m_queue.front();
+                m_queue.pop_front();
+            }
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            task->run();
+            task->release();
+
+            if (counters != nullptr)
+            {
+                counters->m_taskNs += (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+                counters->m_tasks++;
+            }
+        }
+    }
+
+    void PhysXCpuDispatcher::WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]() { return m_running == 0; });
+    }
+
+    void PhysXCpuDispatcher::CollectStats(std::vector<PhysXWorkerStats>& stats, bool reset)
+    {
+        stats.clear();
+
+        for (uint32 i = 0; i < m_counterCount; i++)
+        {
+            const uint32 tasks = reset ? m_counters[i].m_tasks.exchange(0) : m_counters[i].m_tasks.load();
+            const uint64 ns    = reset ? m_counters[i].m_taskNs.exchange(0) : m_counters[i].m_taskNs.load();
+
+            if (tasks == 0)
+                continue;
+
+            PhysXWorkerStats& worker = stats.emplace_back();
+            worker.m_worker          = (int)i;
+            worker.m_tasks           = tasks;
+            worker.m_taskMs          = (double)ns / 1000000.0;
+        }
+    }
+} // namespace Lina::Physics
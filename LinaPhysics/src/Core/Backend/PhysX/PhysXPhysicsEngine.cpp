@@ -28,12 +28,15 @@ SOFTWARE.
 
 #include "Core/Backend/PhysX/PhysXPhysicsEngine.hpp"
 
+#include "Core/Backend/PhysX/PhysXAllocator.hpp"
+#include "Core/Backend/PhysX/PhysXSceneQuery.hpp"
 #include "Core/PhysicsCommon.hpp"
 #include "ECS/Components/EntityDataComponent.hpp"
 #include "ECS/Registry.hpp"
 #include "EventSystem/EventSystem.hpp"
 #include "EventSystem/GraphicsEvents.hpp"
 #include "EventSystem/LevelEvents.hpp"
+#include "EventSystem/PhysicsEvents.hpp"
 #include "EventSystem/ResourceEvents.hpp"
 #include "EventSystem/ECSEvents.hpp"
 #include "Log/Log.hpp"
@@ -42,30 +45,69 @@ SOFTWARE.
 #include "Physics/PhysicsMaterial.hpp"
 #include "Physics/Raycast.hpp"
 #include <PxPhysicsAPI.h>
+#include <algorithm>
 #include <cereal/archives/portable_binary.hpp>
+#include <chrono>
+#include <cstddef>
 #include <fstream>
+#include <memory>
+#include <thread>
 
 namespace Lina::Physics
 {
     PhysXPhysicsEngine* PhysXPhysicsEngine::s_physicsEngine;
     using namespace physx;
 
-    PxDefaultAllocator      m_pxAllocator;
+    PhysXAllocator          m_pxAllocator;
     PxDefaultErrorCallback  m_pxErrorCallback;
     PxReal                  m_pxStackZ          = 10.0f;
     PxFoundation*           m_pxFoundation      = nullptr;
     PxPhysics*              m_pxPhysics         = nullptr;
-    PxDefaultCpuDispatcher* m_pxDispatcher      = nullptr;
+    PhysXCpuDispatcher*     m_pxDispatcher      = nullptr;
     PxScene*                m_pxScene           = nullptr;
     PxMaterial*             m_pxDefaultMaterial = nullptr;
     PxPvd*                  m_pxPvd             = nullptr;
 
-    std::map<ECS::Entity, physx::PxRigidActor*> m_actors;
-    std::map<StringIDType, physx::PxMaterial*>  m_materials;
-    std::map<ECS::Entity, PxShape*>             m_shapes;
+    // Only created if physics is pinned to its own workers.
+    std::unique_ptr<Executor> m_pxDedicatedExecutor;
 
-    // Key is the target model, value is a vector of pairs whose key is the node ID in the model and value is the cooked mesh.
-    std::map<StringIDType, std::vector<std::pair<int, PxConvexMesh*>>> m_convexMeshMap;
+    // Actors & shapes are indexed by the entity index, the actor's user data holds the full entity.
+    std::vector<physx::PxRigidActor*>          m_actors;
+    std::vector<PxShape*>                      m_shapes;
+    std::vector<ECS::Entity>                   m_kinematicBodies;
+    uint32                                     m_actorCount = 0;
+    std::map<StringIDType, physx::PxMaterial*> m_materials;
+    std::vector<PxDebugLine>                   m_debugLines;
+
+    namespace
+    {
+        inline uint32 ToActorIndex(ECS::Entity entity)
+        {
+            return (uint32)entt::to_entity(entity);
+        }
+
+        // Cached static batches sit next to the level file. Actors are stored with the entity as their id, the top
+        // bit keeps them apart from the ids of the materials & meshes they refer to.
+        const char*            StaticCacheExtension = ".linaphx";
+        const PxSerialObjectId StaticActorIdBit     = 1ull << 63;
+        const PxSerialObjectId DefaultMaterialId    = 1;
+
+        const uint32 ContactReportCapacity = 16384;
+        const uint32 TriggerReportCapacity = 4096;
+
+        void SetBodyListedKinematic(ECS::Entity body, bool kinematic)
+        {
+            auto it = std::find(m_kinematicBodies.begin(), m_kinematicBodies.end(), body);
+
+            if (kinematic && it == m_kinematicBodies.end())
+                m_kinematicBodies.push_back(body);
+            else if (!kinematic && it != m_kinematicBodies.end())
+            {
+                *it = m_kinematicBodies.back();
+                m_kinematicBodies.pop_back();
+            }
+        }
+    } // namespace
 
     PhysXPhysicsEngine::PhysXPhysicsEngine()
     {
@@ -80,6 +122,7 @@ namespace Lina::Physics
         if (m_appMode == ApplicationMode::Editor)
             SetDebugDraw(true);
 
+        m_pxAllocator.SetScratchSize(m_scratchSize, m_scratchMaxSize);
         m_pxFoundation = PxCreateFoundation(PX_PHYSICS_VERSION, m_pxAllocator, m_pxErrorCallback);
         LINA_ASSERT(m_pxFoundation != nullptr, "Nvidia PhysX foundation could not be created!");
 
@@ -92,10 +135,18 @@ namespace Lina::Physics
 
         PxSceneDesc sceneDesc(m_pxPhysics->getTolerancesScale());
         sceneDesc.gravity       = PxVec3(0.0f, -9.81f, 0.0f);
-        m_pxDispatcher          = PxDefaultCpuDispatcherCreate(2);
-        sceneDesc.cpuDispatcher = m_pxDispatcher;
-        sceneDesc.filterShader  = PxDefaultSimulationFilterShader;
-        m_pxScene               = m_pxPhysics->createScene(sceneDesc);
+        // One hardware thread is left for the main thread, which keeps rendering during async steps.
+        const uint32 hardwareThreads = std::thread::hardware_concurrency();
+        m_workerBudget               = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        m_pxDispatcher               = new PhysXCpuDispatcher(&GetSharedExecutor(), m_workerBudget);
+
+        // Reports of a step are written into arrays allocated here, see SetContactReportCapacity.
+        m_contactReporter.SetCapacity(ContactReportCapacity, TriggerReportCapacity);
+
+        sceneDesc.cpuDispatcher           = m_pxDispatcher;
+        sceneDesc.filterShader            = PhysXContactReporter::FilterShader;
+        sceneDesc.simulationEventCallback = &m_contactReporter;
+        m_pxScene                         = m_pxPhysics->createScene(sceneDesc);
         m_pxScene->setFlag(PxSceneFlag::eENABLE_ACTIVE_ACTORS, true);
 
         if (m_appMode == ApplicationMode::Editor)
@@ -124,44 +175,208 @@ namespace Lina::Physics
         m_eventSystem = Event::EventSystem::Get();
         m_eventSystem->Connect<Event::EPostSceneDraw, &PhysXPhysicsEngine::OnPostSceneDraw>(this);
         m_eventSystem->Connect<Event::ELevelInstalled, &PhysXPhysicsEngine::OnLevelInstalled>(this);
+        m_eventSystem->Connect<Event::ESerializedLevel, &PhysXPhysicsEngine::OnSerializedLevel>(this);
         m_eventSystem->Connect<Event::EEntityEnabledChanged, &PhysXPhysicsEngine::OnEntityEnabledChanged>(this);
 
-        m_cooker.Initialize(m_appMode, m_pxFoundation);
+        m_cooker.Initialize(m_appMode, m_pxFoundation, m_pxPhysics);
+        m_staticBatcher.Initialize(m_pxPhysics);
     }
 
     void PhysXPhysicsEngine::Tick(float fixedDelta)
     {
-        // Update phy.
-        m_pxScene->simulate((PxReal)m_stepTime);
-        m_pxScene->fetchResults(true);
-        m_physicsPipeline.UpdateSystems(fixedDelta);
+        Simulate(fixedDelta);
+        FetchResults();
+    }
+
+    void PhysXPhysicsEngine::Simulate(float fixedDelta)
+    {
+        FetchResults();
+        m_pxAllocator.BeginStep();
+        m_simulationStep.Simulate(m_pxScene, m_stepTime, m_pxAllocator.GetScratchBlock(), m_pxAllocator.GetScratchSize());
+        m_simulatedDelta = fixedDelta;
+    }
+
+    void PhysXPhysicsEngine::FetchResults()
+    {
+        if (!m_simulationStep.IsSimulating())
+            return;
+
+        m_contactReporter.BeginStep();
+        m_simulationStep.FetchResults(m_pxScene);
+        m_pxAllocator.EndStep();
+        m_pxDispatcher->CollectStats(m_workerStats, true);
+
+        // The render buffer can't be read while the next step is running, keep a copy for the debug draw.
+        const PxRenderBuffer& rb = m_pxScene->getRenderBuffer();
+        m_debugLines.assign(rb.getLines(), rb.getLines() + rb.getNbLines());
+
+        m_physicsPipeline.UpdateSystems(m_simulatedDelta);
+
+        // Writes made while the step was running, in the order they were made.
+        m_simulationStep.ApplyDeferredWrites(*ECS::Registry::Get(), [this](const DeferredWrite& write) { ApplyDeferredWrite(write); });
+
+        // Sent last, handlers see the poses of the step & their writes to the bodies are applied directly.
+        const PhysXContactReporter& reports = m_contactReporter;
+
+        if (reports.GetContactCount() > 0 || reports.GetTriggerCount() > 0)
+            m_eventSystem->Trigger<Event::EPhysicsContacts>(Event::EPhysicsContacts{reports.GetContacts(), reports.GetTriggers(), reports.GetContactCount(), reports.GetTriggerCount()});
+
+        if (reports.GetDroppedCount() > 0)
+            LINA_WARN("[Physics Engine] -> {0} contact reports didn't fit this step, raise the capacity with SetContactReportCapacity.", reports.GetDroppedCount());
+    }
+
+    void PhysXPhysicsEngine::SetWorkerBudget(uint32 threads, bool dedicatedWorkers)
+    {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::WorkerBudget))
+        {
+            write->m_args[0] = threads;
+            write->m_flag    = dedicatedWorkers;
+            return;
+        }
+
+        m_workerBudget     = threads == 0 ? 1 : threads;
+        m_dedicatedWorkers = dedicatedWorkers;
+
+        if (m_dedicatedWorkers)
+        {
+            // Tasks of the old executor are done, no step is running.
+            std::unique_ptr<Executor> executor = std::make_unique<Executor>(m_workerBudget);
+            m_pxDispatcher->SetExecutor(executor.get(), m_workerBudget);
+            m_pxDedicatedExecutor = std::move(executor);
+        }
+        else
+        {
+            m_pxDispatcher->SetExecutor(&GetSharedExecutor(), m_workerBudget);
+            m_pxDedicatedExecutor.reset();
+        }
+
+        LINA_TRACE("[Physics Engine] -> PhysX worker budget set to {0}, dedicated workers: {1}", m_workerBudget, m_dedicatedWorkers);
+    }
+
+    void PhysXPhysicsEngine::SetScratchMemory(uint32 size, uint32 maxSize)
+    {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::ScratchMemory))
+        {
+            write->m_args[0] = size;
+            write->m_args[1] = maxSize;
+            return;
+        }
+
+        m_scratchSize    = size;
+        m_scratchMaxSize = maxSize;
+        m_pxAllocator.SetScratchSize(size, maxSize);
+    }
+
+    uint32 PhysXPhysicsEngine::GetScratchSize()
+    {
+        return m_pxAllocator.GetScratchSize();
+    }
+
+    DeferredWrite* PhysXPhysicsEngine::DeferIfSimulating(DeferredWriteType type, ECS::Entity body)
+    {
+        return m_simulationStep.DeferIfSimulating(type, body);
+    }
+
+    void PhysXPhysicsEngine::ApplyDeferredWrite(const DeferredWrite& write)
+    {
+        switch (write.m_type)
+        {
+        case DeferredWriteType::WorkerBudget:
+            SetWorkerBudget(write.m_args[0], write.m_flag);
+            break;
+        case DeferredWriteType::ScratchMemory:
+            SetScratchMemory(write.m_args[0], write.m_args[1]);
+            break;
+        case DeferredWriteType::MaterialStaticFriction:
+            SetMaterialStaticFriction(*write.m_material, write.m_value);
+            break;
+        case DeferredWriteType::MaterialDynamicFriction:
+            SetMaterialDynamicFriction(*write.m_material, write.m_value);
+            break;
+        case DeferredWriteType::MaterialRestitution:
+            SetMaterialRestitution(*write.m_material, write.m_value);
+            break;
+        case DeferredWriteType::BodySimulation:
+            SetBodySimulation(write.m_body, (SimulationType)write.m_args[0]);
+            break;
+        case DeferredWriteType::BodyCollisionShape:
+            SetBodyCollisionShape(write.m_body, (CollisionShape)write.m_args[0]);
+            break;
+        case DeferredWriteType::BodyMass:
+            SetBodyMass(write.m_body, write.m_value);
+            break;
+        case DeferredWriteType::BodyMaterial:
+            SetBodyMaterial(write.m_body, write.m_material);
+            break;
+        case DeferredWriteType::BodyRadius:
+            SetBodyRadius(write.m_body, write.m_value);
+            break;
+        case DeferredWriteType::BodyHeight:
+            SetBodyHeight(write.m_body, write.m_value);
+            break;
+        case DeferredWriteType::BodyHalfExtents:
+            SetBodyHalfExtents(write.m_body, write.m_vector);
+            break;
+        case DeferredWriteType::BodyShapeParameters:
+            UpdateBodyShapeParameters(write.m_body);
+            break;
+        case DeferredWriteType::BodyKinematic:
+            SetBodyKinematic(write.m_body, write.m_flag);
+            break;
+        case DeferredWriteType::BodyQueryLayers:
+            SetBodyQueryLayers(write.m_body, write.m_args[0]);
+            break;
+        case DeferredWriteType::BodyContactReports:
+            SetBodyContactReports(write.m_body, write.m_args[0], write.m_args[1], write.m_flag);
+            break;
+        case DeferredWriteType::BodyTrigger:
+            SetBodyTrigger(write.m_body, write.m_flag);
+            break;
+        case DeferredWriteType::BodyEnabled:
+            OnEntityEnabledChanged(Event::EEntityEnabledChanged{write.m_body, write.m_flag});
+            break;
+        case DeferredWriteType::AddBody:
+            OnPhysicsComponentAdded(*write.m_registry, write.m_body);
+            break;
+        case DeferredWriteType::RemoveBody:
+            RemoveBodyFromWorld(write.m_body);
+            break;
+        case DeferredWriteType::LevelInstalled:
+            OnLevelInstalled(Event::ELevelInstalled{write.m_path});
+            break;
+        case DeferredWriteType::SerializedLevel:
+            OnSerializedLevel(Event::ESerializedLevel{write.m_path});
+            break;
+        }
     }
 
     void PhysXPhysicsEngine::Shutdown()
     {
         LINA_TRACE("[Shutdown] -> Physics Engine ({0})", typeid(*this).name());
+        FetchResults();
     }
 
     PhysXPhysicsEngine::~PhysXPhysicsEngine()
     {
         LINA_TRACE("[Destructor] -> Physics Engine ({0})", typeid(*this).name());
 
-        for (auto ent : m_actors)
-            ent.second->release();
-
-        for (auto v : m_convexMeshMap)
+        for (auto* actor : m_actors)
         {
-            for (uint32 i = 0; i < v.second.size(); i++)
-                v.second[i].second->release();
-            v.second.clear();
+            if (actor != nullptr)
+                actor->release();
         }
 
-        m_convexMeshMap.clear();
         m_actors.clear();
         m_shapes.clear();
+        m_kinematicBodies.clear();
+        m_actorCount = 0;
 
+        // Loaded batches live in the batcher's memory blocks, which are freed with it after the SDK is released.
+        m_staticBatcher.ReleaseAggregates();
         m_pxScene->release();
-        m_pxDispatcher->release();
+        delete m_pxDispatcher;
+        m_pxDispatcher = nullptr;
+        m_pxDedicatedExecutor.reset();
         m_pxPhysics->release();
 
         if (m_pxPvd)
@@ -177,73 +392,82 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::OnPostSceneDraw(const Event::EPostSceneDraw&)
     {
-        const PxRenderBuffer& rb = m_pxScene->getRenderBuffer();
-        for (PxU32 i = 0; i < rb.getNbLines(); i++)
-        {
-            const PxDebugLine& line = rb.getLines()[i];
-            Color              renderColor;
-            renderColor.r = (float)((line.color0 >> 16) & 0xff);
-            renderColor.g = (float)((line.color0 >> 8) & 0xff);
-            renderColor.b = (float)((line.color0 & 0xff));
-            renderColor.a = 1.0f;
-            m_eventSystem->Trigger<Event::EDrawLine>(Event::EDrawLine{ToLinaVector3(line.pos0), ToLinaVector3(line.pos1), renderColor});
-        }
+        // Forward the whole render buffer at once, PxDebugLine's layout matches DebugPackedLine.
+        static_assert(sizeof(PxDebugLine) == sizeof(Event::DebugPackedLine), "PxDebugLine layout mismatch!");
+        static_assert(offsetof(PxDebugLine, pos0) == offsetof(Event::DebugPackedLine, m_from), "PxDebugLine layout mismatch!");
+        static_assert(offsetof(PxDebugLine, color0) == offsetof(Event::DebugPackedLine, m_fromColor), "PxDebugLine layout mismatch!");
+        static_assert(offsetof(PxDebugLine, pos1) == offsetof(Event::DebugPackedLine, m_to), "PxDebugLine layout mismatch!");
+        static_assert(offsetof(PxDebugLine, color1) == offsetof(Event::DebugPackedLine, m_toColor), "PxDebugLine layout mismatch!");
+
+        if (!m_debugLines.empty())
+            m_eventSystem->Trigger<Event::EDrawLines>(Event::EDrawLines{reinterpret_cast<const Event::DebugPackedLine*>(m_debugLines.data()), (uint32)m_debugLines.size()});
     }
 
     PxShape* PhysXPhysicsEngine::GetCreateShape(ECS::PhysicsComponent& phy, ECS::Entity ent)
     {
         const CollisionShape shape = phy.GetCollisionShape();
+        PxMaterial*          mat   = GetCreateMaterial(phy);
 
-        PxMaterial* mat = nullptr;
-
-        if (m_materials.find(phy.m_material.m_sid) != m_materials.end())
-            mat = m_materials[phy.m_material.m_sid];
-        else
+        if (shape == CollisionShape::ConvexMesh || shape == CollisionShape::TriangleMesh)
         {
-            auto* phyMat                      = phy.m_material.m_value;
-            m_materials[phy.m_material.m_sid] = m_pxPhysics->createMaterial(phyMat->m_staticFriction, phyMat->m_dynamicFriction, phyMat->m_restitution);
-            mat                               = m_materials[phy.m_material.m_sid];
+            auto*             data = ent != entt::null ? ECS::Registry::Get()->try_get<ECS::EntityDataComponent>(ent) : nullptr;
+            const PxMeshScale scale(data != nullptr ? ToPxVector3(data->GetScale()) : PxVec3(1.0f));
+
+            // Triangle meshes can't be simulated on dynamic bodies, those use the convex hull of the mesh.
+            const bool simulated = phy.m_simType == SimulationType::Dynamic && !phy.m_isKinematic;
+
+            if (shape == CollisionShape::TriangleMesh && !simulated)
+            {
+                if (PxTriangleMesh* triangleMesh = m_cooker.GetTriangleMesh(phy.m_attachedModelID, phy.m_attachedMeshIndex))
+                    return m_pxPhysics->createShape(PxTriangleMeshGeometry(triangleMesh, scale), *mat, true);
+            }
+
+            if (PxConvexMesh* convexMesh = m_cooker.GetConvexMesh(phy.m_attachedModelID, phy.m_attachedMeshIndex))
+                return m_pxPhysics->createShape(PxConvexMeshGeometry(convexMesh, scale), *mat, true);
+
+            LINA_ERR("[Physics Engine] -> Collision mesh {0} of model {1} isn't loaded, using a box shape.", phy.m_attachedMeshIndex, phy.m_attachedModelID);
+            return CreatePrimitiveShape(*m_pxPhysics, *mat, CollisionShape::Box, phy.GetHalfExtents(), phy.GetRadius(), phy.GetCapsuleHalfHeight());
         }
 
-        LINA_ASSERT(mat != nullptr, "Physics material is null!");
+        return CreatePrimitiveShape(*m_pxPhysics, *mat, shape, phy.GetHalfExtents(), phy.GetRadius(), phy.GetCapsuleHalfHeight());
+    }
 
-        if (shape == CollisionShape::Box)
-            return m_pxPhysics->createShape(PxBoxGeometry(ToPxVector3(phy.GetHalfExtents())), *mat, true);
-        else if (shape == CollisionShape::Sphere)
-            return m_pxPhysics->createShape(PxSphereGeometry(phy.GetRadius()), *m_pxDefaultMaterial, true);
+    PxShape* PhysXPhysicsEngine::CreatePrimitiveShape(PxPhysics& physics, PxMaterial& material, CollisionShape shape, const Vector3& halfExtents, float radius, float capsuleHalfHeight)
+    {
+        if (shape == CollisionShape::Sphere)
+            return physics.createShape(PxSphereGeometry(radius), material, true);
         else if (shape == CollisionShape::Capsule)
         {
-            PxShape*    newShape = m_pxPhysics->createShape(PxCapsuleGeometry(phy.GetRadius(), phy.GetCapsuleHalfHeight()), *mat, true);
+            // PhysX capsules lie along the x axis.
+            PxShape*    newShape = physics.createShape(PxCapsuleGeometry(radius, capsuleHalfHeight), material, true);
             PxTransform relativePose(PxQuat(PxHalfPi, PxVec3(0, 0, 1)));
             newShape->setLocalPose(relativePose);
             return newShape;
         }
-        else if (shape == CollisionShape::ConvexMesh)
-        {
-            // auto* mr = ECS::Registry::Get()->try_get<ECS::MeshRendererComponent>(ent);
-            //
-            // if (mr != nullptr)
-            // {
-            // 	// mr->
-            //
-            // }
-            return m_pxPhysics->createShape(PxConvexMeshGeometry(m_convexMeshMap[phy.m_attachedModelID][0].second, PxMeshScale(PxVec3(100.0f, 100.0f, 100.0f))), *mat, true);
-        }
 
-        return m_pxPhysics->createShape(PxBoxGeometry(ToPxVector3(phy.GetHalfExtents())), *mat);
+        return physics.createShape(PxBoxGeometry(ToPxVector3(halfExtents)), material, true);
     }
 
-    void PhysXPhysicsEngine::CreateConvexMesh(std::vector<uint8>& data, StringIDType sid, int nodeID)
+    PxMaterial* PhysXPhysicsEngine::GetCreateMaterial(ECS::PhysicsComponent& phy)
     {
-        PxDefaultMemoryInputData input(&data[0], (PxU32)data.size());
-        m_convexMeshMap[sid].push_back(std::make_pair(nodeID, m_pxPhysics->createConvexMesh(input)));
+        PxMaterial* mat = nullptr;
+
+        if (m_materials.find(phy.m_material.m_sid) != m_materials.end())
+            mat = m_materials[phy.m_material.m_sid];
+        else
+        {
+            auto* phyMat                      = phy.m_material.m_value;
+            m_materials[phy.m_material.m_sid] = m_pxPhysics->createMaterial(phyMat->m_staticFriction, phyMat->m_dynamicFriction, phyMat->m_restitution);
+            mat                               = m_materials[phy.m_material.m_sid];
+        }
 
-        LINA_TRACE("Created convex mesh with sid {0} and nodeID {1}", sid, nodeID);
+        LINA_ASSERT(mat != nullptr, "Physics material is null!");
+        return mat;
     }
 
     bool PhysXPhysicsEngine::IsEntityAPhysicsActor(ECS::Entity ent)
     {
-        return m_actors.find(ent) != m_actors.end();
+        return GetActor(ent) != nullptr;
     }
 
     void PhysXPhysicsEngine::AddToPhysicsPipeline(ECS::System& system)
@@ -253,6 +477,13 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetMaterialStaticFriction(PhysicsMaterial& mat, float friction)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::MaterialStaticFriction))
+        {
+            write->m_material = &mat;
+            write->m_value    = friction;
+            return;
+        }
+
         StringIDType sid = mat.GetSID();
         if (m_materials.find(sid) == m_materials.end())
             m_materials[sid] = m_pxPhysics->createMaterial(mat.m_staticFriction, mat.m_dynamicFriction, mat.m_restitution);
@@ -262,6 +493,13 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetMaterialDynamicFriction(PhysicsMaterial& mat, float friction)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::MaterialDynamicFriction))
+        {
+            write->m_material = &mat;
+            write->m_value    = friction;
+            return;
+        }
+
         StringIDType sid = mat.GetSID();
         if (m_materials.find(sid) == m_materials.end())
             m_materials[sid] = m_pxPhysics->createMaterial(mat.m_staticFriction, mat.m_dynamicFriction, mat.m_restitution);
@@ -271,6 +509,13 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetMaterialRestitution(PhysicsMaterial& mat, float restitution)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::MaterialRestitution))
+        {
+            write->m_material = &mat;
+            write->m_value    = restitution;
+            return;
+        }
+
         StringIDType sid = mat.GetSID();
         if (m_materials.find(sid) == m_materials.end())
             m_materials[sid] = m_pxPhysics->createMaterial(mat.m_staticFriction, mat.m_dynamicFriction, mat.m_restitution);
@@ -280,6 +525,12 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetBodySimulation(ECS::Entity body, SimulationType type)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodySimulation, body))
+        {
+            write->m_args[0] = (uint32)type;
+            return;
+        }
+
         auto& phy  = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
         auto& data = ECS::Registry::Get()->get<ECS::EntityDataComponent>(body);
 
@@ -323,6 +574,12 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetBodyCollisionShape(ECS::Entity body, Physics::CollisionShape shape)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyCollisionShape, body))
+        {
+            write->m_args[0] = (uint32)shape;
+            return;
+        }
+
         auto& phy            = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
         phy.m_collisionShape = shape;
         RecreateBodyShape(body);
@@ -330,14 +587,26 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetBodyMass(ECS::Entity body, float mass)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyMass, body))
+        {
+            write->m_value = mass;
+            return;
+        }
+
         auto& phy  = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
         phy.m_mass = Math::Clamp(mass, 0.1f, 1000.0f);
-        if (phy.GetSimType() == SimulationType::Dynamic)
-            PxRigidBodyExt::updateMassAndInertia(*(PxRigidDynamic*)m_actors[body], phy.m_mass);
+        if (phy.GetSimType() == SimulationType::Dynamic && IsEntityAPhysicsActor(body))
+            PxRigidBodyExt::setMassAndUpdateInertia(*(PxRigidDynamic*)GetActor(body), phy.m_mass, nullptr, true);
     }
 
     void PhysXPhysicsEngine::SetBodyMaterial(ECS::Entity body, PhysicsMaterial* material)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyMaterial, body))
+        {
+            write->m_material = material;
+            return;
+        }
+
         if (!IsEntityAPhysicsActor(body))
             return;
 
@@ -346,7 +615,7 @@ namespace Lina::Physics
         phy.m_material.m_value = material;
 
         PxMaterial* pxMaterial = nullptr;
-        m_shapes[body]->getMaterials(&pxMaterial, 1);
+        m_shapes[ToActorIndex(body)]->getMaterials(&pxMaterial, 1);
 
         if (pxMaterial == nullptr)
             return;
@@ -357,6 +626,12 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetBodyRadius(ECS::Entity body, float radius)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyRadius, body))
+        {
+            write->m_value = radius;
+            return;
+        }
+
         auto& phy    = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
         phy.m_radius = Math::Clamp(radius, 0.1f, 50.0f);
         UpdateBodyShapeParameters(body);
@@ -364,6 +639,12 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetBodyHeight(ECS::Entity body, float height)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyHeight, body))
+        {
+            write->m_value = height;
+            return;
+        }
+
         auto& phy               = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
         phy.m_capsuleHalfHeight = Math::Clamp(height, 0.5f, 100.0f);
         UpdateBodyShapeParameters(body);
@@ -371,6 +652,12 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::SetBodyHalfExtents(ECS::Entity body, const Vector3& extents)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyHalfExtents, body))
+        {
+            write->m_vector = extents;
+            return;
+        }
+
         auto& phy         = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
         phy.m_halfExtents = Vector3(Math::Clamp(extents.x, 0.1f, 50.0f), Math::Clamp(extents.y, 0.1f, 50.0f), Math::Clamp(extents.z, 0.1f, 50.0f));
         UpdateBodyShapeParameters(body);
@@ -378,6 +665,12 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::OnPhysicsComponentAdded(entt::registry& reg, entt::entity ent)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::AddBody, ent))
+        {
+            write->m_registry = &reg;
+            return;
+        }
+
         auto* phy = ECS::Registry::Get()->try_get<ECS::PhysicsComponent>(ent);
         if (phy == nullptr)
             return;
@@ -392,17 +685,20 @@ namespace Lina::Physics
         if (phy->GetSimType() == SimulationType::None)
             return;
 
-        if (data != nullptr && m_actors.find(ent) == m_actors.end())
+        if (data != nullptr && !IsEntityAPhysicsActor(ent))
             AddBodyToWorld(ent, phy->GetSimType() == SimulationType::Dynamic);
     }
 
     void PhysXPhysicsEngine::UpdateBodyShapeParameters(ECS::Entity body)
     {
+        if (DeferIfSimulating(DeferredWriteType::BodyShapeParameters, body))
+            return;
+
         auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
-        if (phy.m_simType == SimulationType::None)
+        if (phy.m_simType == SimulationType::None || !IsEntityAPhysicsActor(body))
             return;
 
-        PxShape* shape = m_shapes[body];
+        PxShape* shape = m_shapes[ToActorIndex(body)];
         auto&    data  = ECS::Registry::Get()->get<ECS::EntityDataComponent>(body);
 
         if (phy.m_collisionShape == CollisionShape::Sphere)
@@ -428,61 +724,157 @@ namespace Lina::Physics
             geo.halfHeight = phy.m_capsuleHalfHeight * data.GetScale().y;
             shape->setGeometry(geo);
         }
-        else if (phy.m_collisionShape == CollisionShape::ConvexMesh)
+        else if (shape->getGeometryType() == PxGeometryType::eCONVEXMESH)
         {
             PxConvexMeshGeometry geo;
             shape->getConvexMeshGeometry(geo);
             geo.scale.scale = ToPxVector3(data.GetScale());
             shape->setGeometry(geo);
         }
+        else if (shape->getGeometryType() == PxGeometryType::eTRIANGLEMESH)
+        {
+            PxTriangleMeshGeometry geo;
+            shape->getTriangleMeshGeometry(geo);
+            geo.scale.scale = ToPxVector3(data.GetScale());
+            shape->setGeometry(geo);
+        }
     }
 
     void PhysXPhysicsEngine::RecreateBodyShape(ECS::Entity body)
     {
         auto& phy = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
 
-        if (phy.m_simType != SimulationType::None)
+        if (phy.m_simType != SimulationType::None && IsEntityAPhysicsActor(body))
         {
-            PxU32    nbShapes     = 0;
-            PxShape* currentShape = nullptr;
-            PxShape* newShape     = GetCreateShape(phy);
-            auto*    actor        = m_actors[body];
+            const uint32 index        = ToActorIndex(body);
+            PxShape*     currentShape = m_shapes[index];
+            PxShape*     newShape     = GetCreateShape(phy, body);
+            auto*        actor        = m_actors[index];
 
-            if (phy.m_simType == SimulationType::Dynamic)
-            {
-                currentShape = m_shapes[body];
-                actor->detachShape(*currentShape);
-                actor->attachShape(*newShape);
-            }
-            else
-            {
-                currentShape = m_shapes[body];
-                actor->detachShape(*currentShape);
-                actor->attachShape(*newShape);
-            }
+            ApplyShapeFilters(newShape, phy);
+            actor->detachShape(*currentShape);
+            actor->attachShape(*newShape);
 
-            m_shapes[body] = newShape;
+            m_shapes[index] = newShape;
             newShape->release();
         }
     }
 
     void PhysXPhysicsEngine::SetBodyKinematic(ECS::Entity body, bool kinematic)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyKinematic, body))
+        {
+            write->m_flag = kinematic;
+            return;
+        }
+
         auto& phy         = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
         phy.m_isKinematic = kinematic;
 
-        if (phy.m_simType == SimulationType::Dynamic)
+        if (phy.m_simType == SimulationType::Dynamic && IsEntityAPhysicsActor(body))
         {
-            auto* act = (PxRigidDynamic*)m_actors[body];
+            auto* act = (PxRigidDynamic*)GetActor(body);
+
+            // Triangle mesh shapes are swapped with the convex hull before the body is simulated & back once it's kinematic.
+            if (!kinematic && phy.m_collisionShape == CollisionShape::TriangleMesh)
+                RecreateBodyShape(body);
+
             act->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, kinematic);
+            SetBodyListedKinematic(body, kinematic);
+
+            if (kinematic && phy.m_collisionShape == CollisionShape::TriangleMesh)
+                RecreateBodyShape(body);
 
             if (!kinematic)
                 act->wakeUp();
         }
     }
 
+    void PhysXPhysicsEngine::SetBodyQueryLayers(ECS::Entity body, uint32 layers)
+    {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyQueryLayers, body))
+        {
+            write->m_args[0] = layers;
+            return;
+        }
+
+        auto& phy         = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+        phy.m_queryLayers = layers;
+
+        if (phy.m_simType != SimulationType::None && IsEntityAPhysicsActor(body))
+            m_shapes[ToActorIndex(body)]->setQueryFilterData(PxFilterData(layers, 0, 0, 0));
+    }
+
+    void PhysXPhysicsEngine::SetBodyContactReports(ECS::Entity body, uint32 contactLayers, uint32 reportMask, bool reportPersistent)
+    {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyContactReports, body))
+        {
+            write->m_args[0] = contactLayers;
+            write->m_args[1] = reportMask;
+            write->m_flag    = reportPersistent;
+            return;
+        }
+
+        auto& phy                      = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+        phy.m_contactLayers            = contactLayers;
+        phy.m_contactReportMask        = reportMask;
+        phy.m_reportPersistentContacts = reportPersistent;
+
+        if (phy.m_simType != SimulationType::None && IsEntityAPhysicsActor(body))
+        {
+            const uint32 index = ToActorIndex(body);
+            m_shapes[index]->setSimulationFilterData(PhysXContactReporter::MakeFilterData(contactLayers, reportMask, reportPersistent));
+
+            // Pairs that already exist keep their flags until they are filtered again.
+            m_pxScene->resetFiltering(*m_actors[index]);
+        }
+    }
+
+    void PhysXPhysicsEngine::SetBodyTrigger(ECS::Entity body, bool isTrigger)
+    {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyTrigger, body))
+        {
+            write->m_flag = isTrigger;
+            return;
+        }
+
+        auto& phy       = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+        phy.m_isTrigger = isTrigger;
+        RecreateBodyShape(body);
+    }
+
+    void PhysXPhysicsEngine::SetContactReportCapacity(uint32 contacts, uint32 triggers)
+    {
+        // Reports are only written while fetching, which never overlaps with this.
+        m_contactReporter.SetCapacity(contacts, triggers);
+    }
+
+    void PhysXPhysicsEngine::ApplyShapeFilters(PxShape* shape, ECS::PhysicsComponent& phy)
+    {
+        shape->setQueryFilterData(PxFilterData(phy.m_queryLayers, 0, 0, 0));
+        shape->setSimulationFilterData(PhysXContactReporter::MakeFilterData(phy.m_contactLayers, phy.m_contactReportMask, phy.m_reportPersistentContacts));
+
+        // A shape can't be both at once, the flag being cleared goes first.
+        if (phy.m_isTrigger && shape->getGeometryType() != PxGeometryType::eTRIANGLEMESH)
+        {
+            shape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, false);
+            shape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, true);
+        }
+        else
+        {
+            shape->setFlag(PxShapeFlag::eTRIGGER_SHAPE, false);
+            shape->setFlag(PxShapeFlag::eSIMULATION_SHAPE, true);
+        }
+    }
+
     void PhysXPhysicsEngine::OnLevelInstalled(const Event::ELevelInstalled& ev)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::LevelInstalled))
+        {
+            write->m_path = ev.m_path;
+            return;
+        }
+
         ECS::Registry::Get()->on_destroy<ECS::PhysicsComponent>().connect<&PhysXPhysicsEngine::OnPhysicsComponentRemoved>(this);
         ECS::Registry::Get()->on_construct<ECS::PhysicsComponent>().connect<&PhysXPhysicsEngine::OnPhysicsComponentAdded>(this);
         ECS::Registry::Get()->on_construct<ECS::EntityDataComponent>().connect<&PhysXPhysicsEngine::OnPhysicsComponentAdded>(this);
@@ -492,7 +884,8 @@ namespace Lina::Physics
         m_pxDefaultMaterial->setDynamicFriction(m_defaultMaterial->m_dynamicFriction);
         m_pxDefaultMaterial->setRestitution(m_defaultMaterial->m_restitution);
 
-        auto view = ECS::Registry::Get()->view<ECS::PhysicsComponent>();
+        auto                     view = ECS::Registry::Get()->view<ECS::PhysicsComponent>();
+        std::vector<ECS::Entity> statics;
 
         for (auto entity : view)
         {
@@ -501,17 +894,180 @@ namespace Lina::Physics
             if (phyComp.m_simType == SimulationType::Dynamic)
                 AddBodyToWorld(entity, true);
             else if (phyComp.m_simType == SimulationType::Static)
-                AddBodyToWorld(entity, false);
+                statics.push_back(entity);
+        }
+
+        AddStaticBodiesToWorld(statics, ev.m_path);
+    }
+
+    void PhysXPhysicsEngine::OnSerializedLevel(const Event::ESerializedLevel& ev)
+    {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::SerializedLevel))
+        {
+            write->m_path = ev.m_path;
+            return;
+        }
+
+        if (m_staticBatching == StaticBatching::None || ev.m_path.empty())
+            return;
+
+        auto                     view = ECS::Registry::Get()->view<ECS::PhysicsComponent>();
+        std::vector<ECS::Entity> bodies;
+
+        for (auto entity : view)
+        {
+            if (view.get<ECS::PhysicsComponent>(entity).m_simType == SimulationType::Static)
+                bodies.push_back(entity);
+        }
+
+        if (bodies.empty())
+            return;
+
+        // Built into actors of its own, the bodies in the scene are left alone.
+        std::vector<PxRigidStatic*> actors;
+        std::vector<uint64>         ids;
+
+        for (ECS::Entity body : bodies)
+        {
+            actors.push_back(CreateStaticActor(body));
+            ids.push_back(StaticActorIdBit | (uint64)entt::to_integral(body));
+        }
+
+        StaticBatch   batch;
+        PxCollection* refs = CreateExternalReferences(bodies);
+        m_staticBatcher.Build(actors, m_staticBatching, m_staticCellSize, GetSharedExecutor(), batch);
+        m_staticBatcher.Save(ev.m_path + StaticCacheExtension, HashStaticBodies(bodies), batch, ids, *refs);
+        m_staticBatcher.ReleaseBatch(batch);
+        refs->release();
+    }
+
+    void PhysXPhysicsEngine::AddStaticBodiesToWorld(const std::vector<ECS::Entity>& bodies, const std::string& levelPath)
+    {
+        // Aggregates of the previous level were emptied as its bodies were removed.
+        m_staticBatcher.ReleaseAggregates();
+
+        if (m_staticBatching == StaticBatching::None || bodies.empty())
+        {
+            for (ECS::Entity body : bodies)
+                AddBodyToWorld(body, false);
+
+            return;
+        }
+
+        const auto          start     = std::chrono::high_resolution_clock::now();
+        const std::string   cachePath = levelPath.empty() ? "" : levelPath + StaticCacheExtension;
+        const uint64        hash      = HashStaticBodies(bodies);
+        PxCollection*       refs      = CreateExternalReferences(bodies);
+        StaticBatch         batch;
+        std::vector<uint64> ids;
+        const bool          loaded = !cachePath.empty() && m_staticBatcher.Load(cachePath, hash, *refs, batch, ids);
+
+        if (!loaded)
+        {
+            std::vector<PxRigidStatic*> actors;
+
+            for (ECS::Entity body : bodies)
+            {
+                actors.push_back(CreateStaticActor(body));
+                ids.push_back(StaticActorIdBit | (uint64)entt::to_integral(body));
+            }
+
+            m_staticBatcher.Build(actors, m_staticBatching, m_staticCellSize, GetSharedExecutor(), batch);
+
+            // The batch is saved before it's added, pruning structures are released once merged into the scene.
+            if (!cachePath.empty() && m_appMode == ApplicationMode::Editor)
+                m_staticBatcher.Save(cachePath, hash, batch, ids, *refs);
+            else if (!cachePath.empty())
+                LINA_WARN("[Physics Engine] -> Static bodies of the level were batched at runtime, save it in the editor to ship the batch.");
+        }
+
+        refs->release();
+
+        for (size_t i = 0; i < batch.m_actors.size(); i++)
+        {
+            const ECS::Entity body      = ECS::Entity((std::underlying_type_t<ECS::Entity>)(ids[i] & ~StaticActorIdBit));
+            batch.m_actors[i]->userData = ToPxUserData(body);
+            TrackActor(body, batch.m_actors[i]);
         }
+
+        m_staticBatcher.AddToScene(m_pxScene, batch);
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        LINA_TRACE("[Physics Engine] -> Added {0} static bodies in {1} ms, {2}.", bodies.size(), ms, loaded ? "loaded from the cache" : "built");
+    }
+
+    PxRigidStatic* PhysXPhysicsEngine::CreateStaticActor(ECS::Entity body)
+    {
+        ECS::EntityDataComponent& data    = ECS::Registry::Get()->get<ECS::EntityDataComponent>(body);
+        ECS::PhysicsComponent&    phyComp = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+        PxRigidStatic*            stc     = m_pxPhysics->createRigidStatic(PxTransform(ToPxVector3(data.GetLocation()), ToPxQuat(data.GetRotation())));
+        PxShape*                  shape   = GetCreateShape(phyComp, body);
+
+        ApplyShapeFilters(shape, phyComp);
+        stc->attachShape(*shape);
+        stc->userData = ToPxUserData(body);
+        shape->release();
+        return stc;
+    }
+
+    uint64 PhysXPhysicsEngine::HashStaticBodies(const std::vector<ECS::Entity>& bodies)
+    {
+        const uint32 settings[3] = {(uint32)m_staticBatching, (uint32)PX_PHYSICS_VERSION, (uint32)bodies.size()};
+        uint64       hash        = HashBytes(HashSeed, settings, sizeof(settings));
+        hash                     = HashBytes(hash, &m_staticCellSize, sizeof(float));
+
+        for (ECS::Entity body : bodies)
+        {
+            ECS::EntityDataComponent& data        = ECS::Registry::Get()->get<ECS::EntityDataComponent>(body);
+            ECS::PhysicsComponent&    phyComp     = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+            const Vector3             location    = data.GetLocation();
+            const Quaternion          rotation    = data.GetRotation();
+            const Vector3             scale       = data.GetScale();
+            const Vector3             halfExtents = phyComp.GetHalfExtents();
+
+            const float        values[15] = {location.x, location.y, location.z, rotation.x, rotation.y, rotation.z, rotation.w, scale.x, scale.y, scale.z, phyComp.GetRadius(), phyComp.GetCapsuleHalfHeight(), halfExtents.x, halfExtents.y, halfExtents.z};
+            const uint32       ids[8]     = {(uint32)entt::to_integral(body), (uint32)phyComp.GetCollisionShape(), phyComp.m_queryLayers, phyComp.m_attachedMeshIndex, phyComp.m_contactLayers, phyComp.m_contactReportMask, (uint32)phyComp.m_reportPersistentContacts, (uint32)phyComp.m_isTrigger};
+            const StringIDType sids[2]    = {phyComp.m_material.m_sid, phyComp.m_attachedModelID};
+
+            hash = HashBytes(hash, values, sizeof(values));
+            hash = HashBytes(hash, ids, sizeof(ids));
+            hash = HashBytes(hash, sids, sizeof(sids));
+        }
+
+        return hash;
+    }
+
+    PxCollection* PhysXPhysicsEngine::CreateExternalReferences(const std::vector<ECS::Entity>& bodies)
+    {
+        // A cached batch can only refer to materials that already exist.
+        for (ECS::Entity body : bodies)
+            GetCreateMaterial(ECS::Registry::Get()->get<ECS::PhysicsComponent>(body));
+
+        PxCollection* refs = PxCreateCollection();
+        refs->add(*m_pxDefaultMaterial, DefaultMaterialId);
+
+        for (auto& pair : m_materials)
+            refs->add(*pair.second, (PxSerialObjectId)pair.first);
+
+        m_cooker.AddToCollection(*refs);
+        return refs;
     }
 
     void PhysXPhysicsEngine::OnPhysicsComponentRemoved(entt::registry& reg, entt::entity ent)
     {
+        if (DeferIfSimulating(DeferredWriteType::RemoveBody, ent))
+            return;
+
         RemoveBodyFromWorld(ent);
     }
 
     void PhysXPhysicsEngine::OnEntityEnabledChanged(const Event::EEntityEnabledChanged& ev)
     {
+        if (DeferredWrite* write = DeferIfSimulating(DeferredWriteType::BodyEnabled, ev.m_entity))
+        {
+            write->m_flag = ev.m_enabled;
+            return;
+        }
 
         if (IsEntityAPhysicsActor(ev.m_entity))
         {
@@ -529,68 +1085,130 @@ namespace Lina::Physics
 
     void PhysXPhysicsEngine::RemoveBodyFromWorld(ECS::Entity body)
     {
-        if (m_actors.find(body) == m_actors.end())
+        if (!IsEntityAPhysicsActor(body))
             return;
         LINA_TRACE("Removing body from the world. {0}", body);
-        m_actors[body]->release();
-        m_actors.erase(body);
+        const uint32 index = ToActorIndex(body);
+        m_actors[index]->release();
+        m_actors[index] = nullptr;
+        m_shapes[index] = nullptr;
+        m_actorCount--;
+        SetBodyListedKinematic(body, false);
     }
 
     void PhysXPhysicsEngine::AddBodyToWorld(ECS::Entity body, bool isDynamic)
     {
-        if (isDynamic && m_actors.find(body) != m_actors.end())
+        if (IsEntityAPhysicsActor(body))
             return;
 
-        ECS::EntityDataComponent& data    = ECS::Registry::Get()->get<ECS::EntityDataComponent>(body);
-        ECS::PhysicsComponent&    phyComp = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
-        PxTransform               pose;
-        pose.p         = ToPxVector3(data.GetLocation());
-        pose.q         = ToPxQuat(data.GetRotation());
-        PxShape* shape = GetCreateShape(phyComp);
-
-        if (isDynamic)
-        {
-            LINA_TRACE("Adding a dynamic actor to the world. {0}", body);
-            PxRigidDynamic* rigid = m_pxPhysics->createRigidDynamic(pose);
-            rigid->attachShape(*shape);
-            physx::PxRigidBodyExt::updateMassAndInertia(*rigid, 10.0f);
-            rigid->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, phyComp.GetIsKinematic());
-            m_actors[body] = rigid;
-            m_pxScene->addActor(*rigid);
-            m_shapes[body] = shape;
-        }
-        else
+        if (!isDynamic)
         {
             LINA_TRACE("Adding a static actor to the world. {0}", body);
-            PxRigidStatic* stc = m_pxPhysics->createRigidStatic(pose);
-            stc->attachShape(*shape);
-            m_actors[body] = stc;
+            PxRigidStatic* stc = CreateStaticActor(body);
             m_pxScene->addActor(*stc);
-            m_shapes[body] = shape;
+            TrackActor(body, stc);
+            return;
         }
 
+        ECS::EntityDataComponent& data    = ECS::Registry::Get()->get<ECS::EntityDataComponent>(body);
+        ECS::PhysicsComponent&    phyComp = ECS::Registry::Get()->get<ECS::PhysicsComponent>(body);
+        PxShape*                  shape   = GetCreateShape(phyComp, body);
+        ApplyShapeFilters(shape, phyComp);
+
+        LINA_TRACE("Adding a dynamic actor to the world. {0}", body);
+        PxRigidDynamic* rigid = CreateDynamicActor(*m_pxPhysics, *shape, phyComp.m_mass, phyComp.GetIsKinematic(), data.GetLocation(), data.GetRotation(), body);
+        m_pxScene->addActor(*rigid);
+        TrackActor(body, rigid);
+        SetBodyListedKinematic(body, phyComp.GetIsKinematic());
+
         shape->release();
     }
 
+    PxRigidDynamic* PhysXPhysicsEngine::CreateDynamicActor(PxPhysics& physics, PxShape& shape, float mass, bool isKinematic, const Vector3& location, const Quaternion& rotation, ECS::Entity body)
+    {
+        PxRigidDynamic* rigid = physics.createRigidDynamic(PxTransform(ToPxVector3(location), ToPxQuat(rotation)));
+
+        // Kinematic first, triangle mesh shapes can only be attached to kinematic bodies.
+        rigid->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, isKinematic);
+        rigid->attachShape(shape);
+
+        // Trigger shapes aren't simulation shapes, they are included so triggers get a mass too.
+        if (shape.getGeometryType() != PxGeometryType::eTRIANGLEMESH)
+            PxRigidBodyExt::setMassAndUpdateInertia(*rigid, mass, nullptr, true);
+
+        rigid->userData = ToPxUserData(body);
+        return rigid;
+    }
+
+    void PhysXPhysicsEngine::TrackActor(ECS::Entity body, PxRigidActor* actor)
+    {
+        const uint32 index = ToActorIndex(body);
+
+        if (index >= m_actors.size())
+        {
+            m_actors.resize(index + 1, nullptr);
+            m_shapes.resize(index + 1, nullptr);
+        }
+
+        PxShape* shape = nullptr;
+        actor->getShapes(&shape, 1);
+
+        m_actors[index] = actor;
+        m_shapes[index] = shape;
+        m_actorCount++;
+    }
+
     physx::PxActor** PhysXPhysicsEngine::GetActiveActors(uint32& size)
     {
         return m_pxScene->getActiveActors(size);
     }
 
+    void PhysXPhysicsEngine::Raycast(const RaycastQuery* queries, uint32 count, HitInfo* hits)
+    {
+        PhysXSceneQuery::Raycast(m_pxScene, GetSharedExecutor(), queries, count, hits);
+    }
+
+    void PhysXPhysicsEngine::Sweep(const SweepQuery* queries, uint32 count, HitInfo* hits)
+    {
+        PhysXSceneQuery::Sweep(m_pxScene, GetSharedExecutor(), queries, count, hits);
+    }
+
+    void PhysXPhysicsEngine::Overlap(const OverlapQuery* queries, uint32 count, std::vector<OverlapHit>& hits, uint32 maxHitsPerQuery)
+    {
+        PhysXSceneQuery::Overlap(m_pxScene, GetSharedExecutor(), queries, count, hits, maxHitsPerQuery);
+    }
+
     ECS::Entity PhysXPhysicsEngine::GetEntityOfActor(physx::PxActor* actor)
     {
-        for (auto& p : m_actors)
-        {
-            if (p.second == actor)
-                return p.first;
-        }
+        if (actor == nullptr)
+            return entt::null;
 
-        return entt::null;
+        const ECS::Entity entity = ToLinaEntity(actor->userData);
+        return GetActor(entity) == actor ? entity : entt::null;
+    }
+
+    physx::PxRigidActor* PhysXPhysicsEngine::GetActor(ECS::Entity entity)
+    {
+        if (entity == entt::null)
+            return nullptr;
+
+        const uint32 index = ToActorIndex(entity);
+
+        if (index >= m_actors.size() || m_actors[index] == nullptr)
+            return nullptr;
+
+        // Index might be reused by a newer version of the entity.
+        return ToLinaEntity(m_actors[index]->userData) == entity ? m_actors[index] : nullptr;
+    }
+
+    const std::vector<ECS::Entity>& PhysXPhysicsEngine::GetKinematicBodies()
+    {
+        return m_kinematicBodies;
     }
 
-    std::map<ECS::Entity, physx::PxRigidActor*>& PhysXPhysicsEngine::GetAllActors()
+    uint32 PhysXPhysicsEngine::GetActorCount()
     {
-        return m_actors;
+        return m_actorCount;
     }
 
     std::map<StringIDType, physx::PxMaterial*>& PhysXPhysicsEngine::GetMaterials()
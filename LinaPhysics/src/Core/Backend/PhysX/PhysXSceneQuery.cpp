@@ -0,0 +1,151 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXSceneQuery.hpp"
+
+#include "Core/PhysicsCommon.hpp"
+
+#include <PxPhysicsAPI.h>
+#include <algorithm>
+
+namespace Lina::Physics
+{
+    using namespace physx;
+
+    namespace
+    {
+        template <typename Fn> void ForEachSlice(Executor& executor, uint32 count, Fn&& fn)
+        {
+            const uint32 slices = (count + PhysXSceneQuery::SliceSize - 1) / PhysXSceneQuery::SliceSize;
+
+            // Waiting on the executor from one of its own workers could block all of them, such batches run inline.
+            if (slices <= 1 || executor.num_workers() <= 1 || executor.this_worker_id() >= 0)
+            {
+                for (uint32 slice = 0; slice < slices; slice++)
+                    fn(slice, slice * PhysXSceneQuery::SliceSize, std::min((slice + 1) * PhysXSceneQuery::SliceSize, count));
+                return;
+            }
+
+            TaskFlow taskflow;
+            taskflow.for_each_index(0u, slices, 1u, [&](uint32 slice) { fn(slice, slice * PhysXSceneQuery::SliceSize, std::min((slice + 1) * PhysXSceneQuery::SliceSize, count)); });
+            executor.run(taskflow).wait();
+        }
+
+        PxGeometryHolder ToPxGeometry(const QueryGeometry& geometry)
+        {
+            if (geometry.m_shape == QueryShape::Box)
+                return PxGeometryHolder(PxBoxGeometry(ToPxVector3(geometry.m_halfExtents)));
+            else if (geometry.m_shape == QueryShape::Capsule)
+                return PxGeometryHolder(PxCapsuleGeometry(geometry.m_radius, geometry.m_halfHeight));
+
+            return PxGeometryHolder(PxSphereGeometry(geometry.m_radius));
+        }
+
+        PxTransform ToPxPose(const QueryGeometry& geometry, const Vector3& position, const Quaternion& rotation)
+        {
+            // PhysX capsules lie along X, rotated the same way as capsule shapes.
+            if (geometry.m_shape == QueryShape::Capsule)
+                return PxTransform(ToPxVector3(position), ToPxQuat(rotation) * PxQuat(PxHalfPi, PxVec3(0.0f, 0.0f, 1.0f)));
+
+            return PxTransform(ToPxVector3(position), ToPxQuat(rotation));
+        }
+
+        PxQueryFilterData ToPxFilter(uint32 layerMask, PxQueryFlags flags = PxQueryFlags())
+        {
+            return PxQueryFilterData(PxFilterData(layerMask, 0, 0, 0), PxQueryFlag::eSTATIC | PxQueryFlag::eDYNAMIC | flags);
+        }
+
+        template <typename T> void ToHitInfo(const T& hit, HitInfo& info)
+        {
+            info.m_hitCount = 1;
+            info.m_entity   = ToLinaEntity(hit.actor->userData);
+            info.m_position = ToLinaVector3(hit.position);
+            info.m_normal   = ToLinaVector3(hit.normal);
+            info.m_distance = hit.distance;
+        }
+    } // namespace
+
+    void PhysXSceneQuery::Raycast(physx::PxScene* scene, Executor& executor, const RaycastQuery* queries, uint32 count, HitInfo* hits)
+    {
+        ForEachSlice(executor, count, [&](uint32, uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; i++)
+            {
+                const RaycastQuery& query = queries[i];
+                PxRaycastBuffer     buffer;
+                hits[i]                   = HitInfo();
+
+                if (scene->raycast(ToPxVector3(query.m_origin), ToPxVector3(query.m_unitDir), query.m_distance, buffer, PxHitFlag::ePOSITION | PxHitFlag::eNORMAL, ToPxFilter(query.m_layerMask)) && buffer.hasBlock)
+                    ToHitInfo(buffer.block, hits[i]);
+            }
+        });
+    }
+
+    void PhysXSceneQuery::Sweep(physx::PxScene* scene, Executor& executor, const SweepQuery* queries, uint32 count, HitInfo* hits)
+    {
+        ForEachSlice(executor, count, [&](uint32, uint32 begin, uint32 end) {
+            for (uint32 i = begin; i < end; i++)
+            {
+                const SweepQuery&      query    = queries[i];
+                const PxGeometryHolder geometry = ToPxGeometry(query.m_geometry);
+                PxSweepBuffer          buffer;
+                hits[i]                         = HitInfo();
+
+                if (scene->sweep(geometry.any(), ToPxPose(query.m_geometry, query.m_origin, query.m_rotation), ToPxVector3(query.m_unitDir), query.m_distance, buffer, PxHitFlag::ePOSITION | PxHitFlag::eNORMAL, ToPxFilter(query.m_layerMask)) && buffer.hasBlock)
+                    ToHitInfo(buffer.block, hits[i]);
+            }
+        });
+    }
+
+    void PhysXSceneQuery::Overlap(physx::PxScene* scene, Executor& executor, const OverlapQuery* queries, uint32 count, std::vector<OverlapHit>& hits, uint32 maxHitsPerQuery)
+    {
+        const uint32                         slices = (count + SliceSize - 1) / SliceSize;
+        std::vector<std::vector<OverlapHit>> sliceHits(slices);
+
+        ForEachSlice(executor, count, [&](uint32 slice, uint32 begin, uint32 end) {
+            std::vector<PxOverlapHit> touches(maxHitsPerQuery);
+
+            for (uint32 i = begin; i < end; i++)
+            {
+                const OverlapQuery&    query    = queries[i];
+                const PxGeometryHolder geometry = ToPxGeometry(query.m_geometry);
+                PxOverlapBuffer        buffer(touches.data(), maxHitsPerQuery);
+
+                // Overlaps don't block, every overlapping shape is reported as a touch.
+                scene->overlap(geometry.any(), ToPxPose(query.m_geometry, query.m_position, query.m_rotation), buffer, ToPxFilter(query.m_layerMask, PxQueryFlag::eNO_BLOCK));
+
+                for (PxU32 j = 0; j < buffer.getNbTouches(); j++)
+                    sliceHits[slice].push_back(OverlapHit{i, ToLinaEntity(buffer.getTouch(j).actor->userData)});
+            }
+        });
+
+        hits.clear();
+
+        for (auto& slice : sliceHits)
+            hits.insert(hits.end(), slice.begin(), slice.end());
+    }
+} // namespace Lina::Physics
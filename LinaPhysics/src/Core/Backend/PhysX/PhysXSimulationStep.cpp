@@ -0,0 +1,81 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXSimulationStep.hpp"
+
+#include "Log/Log.hpp"
+
+#include <PxScene.h>
+
+namespace Lina::Physics
+{
+    void PhysXSimulationStep::Simulate(physx::PxScene* scene, float stepTime, void* scratchBlock, uint32 scratchSize)
+    {
+        LINA_ASSERT(!m_isSimulating, "The running step has to be fetched before a new one is started!");
+        scene->simulate((physx::PxReal)stepTime, nullptr, scratchBlock, scratchSize);
+        m_isSimulating = true;
+    }
+
+    bool PhysXSimulationStep::FetchResults(physx::PxScene* scene)
+    {
+        if (!m_isSimulating)
+            return false;
+
+        scene->fetchResults(true);
+        m_isSimulating = false;
+        return true;
+    }
+
+    DeferredWrite* PhysXSimulationStep::DeferIfSimulating(DeferredWriteType type, ECS::Entity body)
+    {
+        if (!m_isSimulating)
+            return nullptr;
+
+        DeferredWrite& write = m_deferredWrites.emplace_back();
+        write.m_type         = type;
+        write.m_body         = body;
+        return &write;
+    }
+
+    void PhysXSimulationStep::ApplyDeferredWrites(const entt::registry& reg, const std::function<void(const DeferredWrite&)>& apply)
+    {
+        LINA_ASSERT(!m_isSimulating, "Deferred writes can't be applied while a step is running!");
+
+        // Both lists keep their capacity, no step is running while they are applied so nothing is deferred in between.
+        m_appliedWrites.swap(m_deferredWrites);
+
+        for (const DeferredWrite& write : m_appliedWrites)
+        {
+            // Removals release the actor of a destroyed entity, so they are always applied.
+            if (write.m_body == entt::null || write.m_type == DeferredWriteType::RemoveBody || reg.valid(write.m_body))
+                apply(write);
+        }
+
+        m_appliedWrites.clear();
+    }
+} // namespace Lina::Physics
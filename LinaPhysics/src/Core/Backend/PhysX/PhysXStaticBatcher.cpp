@@ -0,0 +1,276 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXStaticBatcher.hpp"
+
+#include "Core/Backend/PhysX/PhysXAllocator.hpp"
+#include "Log/Log.hpp"
+
+#include <PxPhysicsAPI.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <tuple>
+
+namespace Lina::Physics
+{
+    using namespace physx;
+
+    namespace
+    {
+        // Bump the version if the layout of the batches changes.
+        const uint32 StaticBatchMagic   = 0x5848504C; // LPHX
+        const uint32 StaticBatchVersion = 1;
+
+        struct StaticBatchHeader
+        {
+            uint32 m_magic   = StaticBatchMagic;
+            uint32 m_version = StaticBatchVersion;
+            uint64 m_hash    = 0;
+            uint64 m_size    = 0;
+        };
+
+        typedef std::tuple<int, int, int> CellKey;
+
+        // Ordered by cell, so the same actors always end up in the same cells.
+        std::map<CellKey, std::vector<PxRigidStatic*>> GroupIntoCells(const std::vector<PxRigidStatic*>& actors, float cellSize)
+        {
+            std::map<CellKey, std::vector<PxRigidStatic*>> cells;
+
+            for (PxRigidStatic* actor : actors)
+            {
+                const PxVec3 p = actor->getGlobalPose().p;
+                cells[CellKey((int)std::floor(p.x / cellSize), (int)std::floor(p.y / cellSize), (int)std::floor(p.z / cellSize))].push_back(actor);
+            }
+
+            return cells;
+        }
+    } // namespace
+
+    void PhysXStaticBatcher::Build(const std::vector<physx::PxRigidStatic*>& actors, StaticBatching mode, float cellSize, Executor& executor, StaticBatch& batch)
+    {
+        batch.m_actors = actors;
+
+        if (mode == StaticBatching::None || actors.empty())
+            return;
+
+        const auto cells = GroupIntoCells(actors, cellSize > 0.0f ? cellSize : 1.0f);
+
+        if (mode == StaticBatching::Aggregates)
+        {
+            // Static actors never collide with each other, self collisions are left off.
+            for (auto& pair : cells)
+            {
+                const std::vector<PxRigidStatic*>& cell = pair.second;
+
+                for (size_t first = 0; first < cell.size(); first += MaxAggregateActors)
+                {
+                    const size_t last      = std::min(first + MaxAggregateActors, cell.size());
+                    PxAggregate* aggregate = m_physics->createAggregate((PxU32)(last - first), false);
+
+                    for (size_t i = first; i < last; i++)
+                        aggregate->addActor(*cell[i]);
+
+                    batch.m_aggregates.push_back(aggregate);
+                }
+            }
+
+            return;
+        }
+
+        std::vector<const std::vector<PxRigidStatic*>*> cellList;
+        for (auto& pair : cells)
+            cellList.push_back(&pair.second);
+
+        batch.m_structures.resize(cellList.size(), nullptr);
+
+        auto buildCell = [&](uint32 i) { batch.m_structures[i] = m_physics->createPruningStructure(reinterpret_cast<PxRigidActor* const*>(cellList[i]->data()), (PxU32)cellList[i]->size()); };
+
+        // Inline if there is a single cell or this already runs on one of the workers.
+        if (cellList.size() == 1 || executor.num_workers() <= 1 || executor.this_worker_id() >= 0)
+        {
+            for (uint32 i = 0; i < (uint32)cellList.size(); i++)
+                buildCell(i);
+        }
+        else
+        {
+            TaskFlow taskflow;
+            taskflow.for_each_index(0u, (uint32)cellList.size(), 1u, buildCell);
+            executor.run(taskflow).wait();
+        }
+
+        // Actors of a cell that failed are inserted one by one.
+        for (uint32 i = 0; i < (uint32)batch.m_structures.size(); i++)
+        {
+            if (batch.m_structures[i] == nullptr)
+                LINA_ERR("[PhysX Static Batcher] -> Pruning structure of a cell with {0} actors couldn't be created.", cellList[i]->size());
+        }
+
+        batch.m_structures.erase(std::remove(batch.m_structures.begin(), batch.m_structures.end(), nullptr), batch.m_structures.end());
+    }
+
+    void PhysXStaticBatcher::AddToScene(physx::PxScene* scene, StaticBatch& batch)
+    {
+        for (PxAggregate* aggregate : batch.m_aggregates)
+        {
+            scene->addAggregate(*aggregate);
+            m_aggregates.push_back(aggregate);
+        }
+
+        for (PxPruningStructure* structure : batch.m_structures)
+        {
+            scene->addActors(*structure);
+            structure->release();
+        }
+
+        // Actors that are in neither, e.g. with batching off.
+        for (PxRigidStatic* actor : batch.m_actors)
+        {
+            if (actor->getScene() == nullptr)
+                scene->addActor(*actor);
+        }
+
+        batch.m_aggregates.clear();
+        batch.m_structures.clear();
+    }
+
+    void PhysXStaticBatcher::ReleaseBatch(StaticBatch& batch)
+    {
+        // Pruning structures have to go before their actors.
+        for (PxPruningStructure* structure : batch.m_structures)
+            structure->release();
+
+        for (PxRigidStatic* actor : batch.m_actors)
+            actor->release();
+
+        for (PxAggregate* aggregate : batch.m_aggregates)
+            aggregate->release();
+
+        batch.m_actors.clear();
+        batch.m_aggregates.clear();
+        batch.m_structures.clear();
+    }
+
+    void PhysXStaticBatcher::ReleaseAggregates()
+    {
+        for (PxAggregate* aggregate : m_aggregates)
+            aggregate->release();
+
+        m_aggregates.clear();
+    }
+
+    bool PhysXStaticBatcher::Save(const std::string& path, uint64 hash, const StaticBatch& batch, const std::vector<uint64>& actorIds, const physx::PxCollection& externalRefs)
+    {
+        PhysXAllocator::Scope    scope(PhysXMemoryCategory::Serialization);
+        PxSerializationRegistry* registry   = PxSerialization::createSerializationRegistry(*m_physics);
+        PxCollection*            collection = PxCreateCollection();
+
+        // Aggregates & pruning structures add their actors without ids, ids are set after.
+        for (PxAggregate* aggregate : batch.m_aggregates)
+            collection->add(*aggregate);
+
+        for (PxPruningStructure* structure : batch.m_structures)
+            collection->add(*structure);
+
+        for (size_t i = 0; i < batch.m_actors.size(); i++)
+            collection->add(*batch.m_actors[i], (PxSerialObjectId)actorIds[i]);
+
+        PxSerialization::complete(*collection, *registry, &externalRefs);
+
+        PxDefaultMemoryOutputStream stream;
+        const bool                  serialized = PxSerialization::serializeCollectionToBinary(stream, *collection, *registry, &externalRefs);
+
+        collection->release();
+        registry->release();
+
+        if (!serialized)
+        {
+            LINA_ERR("[PhysX Static Batcher] -> Static bodies couldn't be serialized to {0}.", path);
+            return false;
+        }
+
+        StaticBatchHeader header;
+        header.m_hash = hash;
+        header.m_size = stream.getSize();
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(StaticBatchHeader));
+        file.write(reinterpret_cast<const char*>(stream.getData()), stream.getSize());
+        return file.good();
+    }
+
+    bool PhysXStaticBatcher::Load(const std::string& path, uint64 hash, const physx::PxCollection& externalRefs, StaticBatch& batch, std::vector<uint64>& actorIds)
+    {
+        PhysXAllocator::Scope scope(PhysXMemoryCategory::Serialization);
+        std::ifstream         file(path, std::ios::binary);
+        StaticBatchHeader     header;
+
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(StaticBatchHeader)))
+            return false;
+
+        if (header.m_magic != StaticBatchMagic || header.m_version != StaticBatchVersion || header.m_hash != hash || header.m_size == 0)
+            return false;
+
+        // Binary collections are deserialized in place & need a 128 byte aligned block.
+        std::unique_ptr<uint8[]> block(new uint8[header.m_size + PX_SERIAL_FILE_ALIGN]);
+        void*                    memory = (void*)(((uintptr_t)block.get() + PX_SERIAL_FILE_ALIGN - 1) & ~(uintptr_t)(PX_SERIAL_FILE_ALIGN - 1));
+
+        if (!file.read(reinterpret_cast<char*>(memory), header.m_size))
+            return false;
+
+        PxSerializationRegistry* registry   = PxSerialization::createSerializationRegistry(*m_physics);
+        PxCollection*            collection = PxSerialization::createCollectionFromBinary(memory, *registry, &externalRefs);
+        registry->release();
+
+        if (collection == nullptr)
+        {
+            LINA_WARN("[PhysX Static Batcher] -> {0} refers to objects that no longer exist, rebuilding the static bodies.", path);
+            return false;
+        }
+
+        for (PxU32 i = 0; i < collection->getNbObjects(); i++)
+        {
+            PxBase& object = collection->getObject(i);
+
+            if (PxRigidStatic* actor = object.is<PxRigidStatic>())
+            {
+                batch.m_actors.push_back(actor);
+                actorIds.push_back((uint64)collection->getId(object));
+            }
+            else if (PxAggregate* aggregate = object.is<PxAggregate>())
+                batch.m_aggregates.push_back(aggregate);
+            else if (PxPruningStructure* structure = object.is<PxPruningStructure>())
+                batch.m_structures.push_back(structure);
+        }
+
+        collection->release();
+        m_memoryBlocks.push_back(std::move(block));
+        return true;
+    }
+} // namespace Lina::Physics
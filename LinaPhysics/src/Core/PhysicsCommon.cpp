@@ -87,6 +87,24 @@ namespace Lina::Physics
     {
         return Quaternion(q.x, q.y, q.z, q.w);
     }
+    void* ToPxUserData(ECS::Entity entity)
+    {
+        return reinterpret_cast<void*>((uintptr_t)entt::to_integral(entity));
+    }
+    ECS::Entity ToLinaEntity(void* userData)
+    {
+        return ECS::Entity((std::underlying_type_t<ECS::Entity>)reinterpret_cast<uintptr_t>(userData));
+    }
 
 #endif
+
+    uint64 HashBytes(uint64 hash, const void* data, size_t size)
+    {
+        const uint8* bytes = static_cast<const uint8*>(data);
+
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+        return hash;
+    }
 } // namespace Lina::Physics
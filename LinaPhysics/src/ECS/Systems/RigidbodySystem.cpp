@@ -36,9 +36,10 @@ SOFTWARE.
 
 #ifdef LINA_PHYSICS_PHYSX
 #include "PxPhysics.h"
-#endif
 
 using namespace physx;
+#endif
+
 namespace Lina::ECS
 {
 
@@ -56,65 +57,101 @@ namespace Lina::ECS
 
 #ifdef LINA_PHYSICS_BULLET
 
-        auto view = ecs->view<EntityDataComponent, PhysicsComponent>();
+        // Same as the PhysX path, only the bodies that were awake during the step are written back.
+        uint32        activeCount  = 0;
+        btRigidBody** activeBodies = physicsEngine->GetActiveBodies(activeCount);
+        SyncActiveBodies(*ecs, activeBodies, activeCount);
+#endif
+#ifdef LINA_PHYSICS_PHYSX
 
-        // Find all entities with rigidbody component and transform component attached to them.
-        for (auto entity : view)
+        // Kinematic bodies follow their transforms.
+        for (ECS::Entity entity : physicsEngine->GetKinematicBodies())
         {
-            PhysicsComponent& phyComp = view.get<PhysicsComponent>(entity);
-            if (!phyComp.GetIsSimulated())
+            // Removal is buffered if the entity was destroyed while the step was running.
+            if (!ecs->valid(entity))
                 continue;
-            EntityDataComponent& data = view.get<EntityDataComponent>(entity);
-            btRigidBody*         rb   = Physics::PhysicsEngineBackend::Get()->GetActiveRigidbody(entity);
-            btTransform          btTrans;
-            rb->getMotionState()->getWorldTransform(btTrans);
-            Vector3 location = Physics::ToLinaVector(rb->getWorldTransform().getOrigin());
-            data.SetLocation(location);
-            data.SetRotation(Quaternion(btTrans.getRotation().getX(), btTrans.getRotation().getY(), btTrans.getRotation().getZ(), btTrans.getRotation().getW()));
-            phyComp.m_angularVelocity = Physics::ToLinaVector(rb->getAngularVelocity());
-            phyComp.m_velocity        = Physics::ToLinaVector(rb->getLinearVelocity());
-            phyComp.m_turnVelocity    = Physics::ToLinaVector(rb->getTurnVelocity());
+
+            EntityDataComponent& data = ecs->get<EntityDataComponent>(entity);
+            PxTransform          destination;
+            destination.p = Physics::ToPxVector3(data.GetLocation());
+            destination.q = Physics::ToPxQuat(data.GetRotation());
+            ((PxRigidDynamic*)physicsEngine->GetActor(entity))->setKinematicTarget(destination);
+            m_engine->UpdateBodyShapeParameters(entity);
         }
+
+        // Everything else is written back only if it moved during the last simulation step.
+        PxU32     nbActiveActors = 0;
+        PxActor** activeActors   = m_engine->GetActiveActors(nbActiveActors);
+        SyncActiveActors(*ecs, activeActors, nbActiveActors);
+        m_poolSize = (int)physicsEngine->GetActorCount();
+
 #endif
-#ifdef LINA_PHYSICS_PHYSX
+    }
 
-        auto& actors = physicsEngine->GetAllActors();
-        m_poolSize   = (int)actors.size();
+#ifdef LINA_PHYSICS_BULLET
+    uint32 RigidbodySystem::SyncActiveBodies(entt::registry& reg, btRigidBody** bodies, uint32 count)
+    {
+        auto&  datas   = reg.storage<EntityDataComponent>();
+        auto&  physics = reg.storage<PhysicsComponent>();
+        uint32 synced  = 0;
 
-        for (auto& p : actors)
+        for (uint32 i = 0; i < count; i++)
         {
-            EntityDataComponent& data    = ecs->get<EntityDataComponent>(p.first);
-            PhysicsComponent&    phyComp = ecs->get<PhysicsComponent>(p.first);
-            if (phyComp.m_simType == Physics::SimulationType::Static)
+            const ECS::Entity entity = (ECS::Entity)(uint32)bodies[i]->getUserIndex();
+            if (!datas.contains(entity))
                 continue;
 
-            if (phyComp.m_isKinematic)
+            const btTransform& transform = bodies[i]->getWorldTransform();
+            datas.get(entity).SetPose(Physics::ToLinaVector(transform.getOrigin()), Physics::ToLinaQuat(transform.getRotation()));
+
+            if (physics.contains(entity))
             {
-                PxTransform destination;
-                destination.p = Physics::ToPxVector3(data.GetLocation());
-                destination.q = Physics::ToPxQuat(data.GetRotation());
-                ((PxRigidDynamic*)p.second)->setKinematicTarget(destination);
-                m_engine->UpdateBodyShapeParameters(p.first);
+                PhysicsComponent& phy = physics.get(entity);
+                phy.m_velocity        = Physics::ToLinaVector(bodies[i]->getLinearVelocity());
+                phy.m_angularVelocity = Physics::ToLinaVector(bodies[i]->getAngularVelocity());
             }
-            else
+
+            synced++;
+        }
+
+        return synced;
+    }
+#endif
+
+#ifdef LINA_PHYSICS_PHYSX
+    uint32 RigidbodySystem::SyncActiveActors(entt::registry& reg, physx::PxActor** actors, uint32 count)
+    {
+        auto&  datas   = reg.storage<EntityDataComponent>();
+        auto&  physics = reg.storage<PhysicsComponent>();
+        uint32 synced  = 0;
+
+        for (uint32 i = 0; i < count; i++)
+        {
+            if (actors[i]->getType() != PxActorType::eRIGID_DYNAMIC)
+                continue;
+
+            PxRigidDynamic* rigid = static_cast<PxRigidDynamic*>(actors[i]);
+            if (rigid->getRigidBodyFlags().isSet(PxRigidBodyFlag::eKINEMATIC))
+                continue;
+
+            const ECS::Entity entity = Physics::ToLinaEntity(rigid->userData);
+            if (!datas.contains(entity))
+                continue;
+
+            const PxTransform pose = rigid->getGlobalPose();
+            datas.get(entity).SetPose(Physics::ToLinaVector3(pose.p), Physics::ToLinaQuat(pose.q));
+
+            if (physics.contains(entity))
             {
-                PxU32     nbActiveActors;
-                PxActor** activeActors = m_engine->GetActiveActors(nbActiveActors);
-                for (PxU32 i = 0; i < nbActiveActors; ++i)
-                {
-                    ECS::Entity entity = m_engine->GetEntityOfActor(activeActors[i]);
-
-                    if (entity == p.first)
-                    {
-                        PxRigidDynamic* rigid = static_cast<PxRigidDynamic*>(activeActors[i]);
-                        auto&           pose  = rigid->getGlobalPose();
-                        data.SetLocation(Physics::ToLinaVector3(pose.p));
-                        data.SetRotation(Physics::ToLinaQuat(pose.q));
-                    }
-                }
+                PhysicsComponent& phy = physics.get(entity);
+                phy.m_velocity        = Physics::ToLinaVector3(rigid->getLinearVelocity());
+                phy.m_angularVelocity = Physics::ToLinaVector3(rigid->getAngularVelocity());
             }
+
+            synced++;
         }
 
-#endif
+        return synced;
     }
+#endif
 } // namespace Lina::ECS
@@ -0,0 +1,90 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysXTestFoundation
+
+Creates the PhysX foundation & SDK for a headless physics test & releases them when it goes out of scope.
+PhysX allows a single foundation, so tests create their own one at a time & the physics engine isn't initialized
+in the test executable.
+
+Timestamp: 2/12/2022 11:02:40 AM
+*/
+
+#pragma once
+
+#ifndef PhysXTestFoundation_HPP
+#define PhysXTestFoundation_HPP
+
+// Headers here.
+#include <PxPhysicsAPI.h>
+
+namespace Lina::Physics
+{
+    class PhysXTestFoundation
+    {
+
+    public:
+        /// <summary>
+        /// Uses PhysX's default allocator if none is given, the allocator needs to outlive the foundation.
+        /// </summary>
+        PhysXTestFoundation(physx::PxAllocatorCallback* allocator = nullptr);
+        ~PhysXTestFoundation();
+
+        PhysXTestFoundation(const PhysXTestFoundation&) = delete;
+        PhysXTestFoundation& operator=(const PhysXTestFoundation&) = delete;
+
+        /// <summary>
+        /// Scene with the default simulation filter shader & the given dispatcher, released by the caller.
+        /// </summary>
+        physx::PxScene* CreateScene(physx::PxCpuDispatcher* dispatcher, float gravity = -9.81f);
+
+        inline bool IsValid() const
+        {
+            return m_physics != nullptr;
+        }
+
+        inline physx::PxFoundation* GetFoundation()
+        {
+            return m_foundation;
+        }
+
+        inline physx::PxPhysics* GetPhysics()
+        {
+            return m_physics;
+        }
+
+    private:
+        physx::PxDefaultAllocator     m_defaultAllocator;
+        physx::PxDefaultErrorCallback m_errorCallback;
+        physx::PxFoundation*          m_foundation = nullptr;
+        physx::PxPhysics*             m_physics    = nullptr;
+    };
+} // namespace Lina::Physics
+
+#endif
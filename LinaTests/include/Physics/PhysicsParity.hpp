@@ -0,0 +1,122 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: PhysicsParity
+
+Parity check between the physics backends. Both backends run the same scene of box stacks & dropped spheres on a
+ground plane, bodies are created by the physics engine's body code & written back to a registry by the rigidbody
+system's sync, so the aggregates are read from the entities. A build only links a single backend, the parity
+benchmark saves its results & compares them with the other backend's saved results.
+
+Timestamp: 2/10/2022 3:02:47 PM
+*/
+
+#pragma once
+
+#ifndef PhysicsParity_HPP
+#define PhysicsParity_HPP
+
+// Headers here.
+#include "Core/CommonECS.hpp"
+#include "Core/SizeDefinitions.hpp"
+#include "Math/Vector.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Lina::Physics
+{
+    struct PhysicsParityBody
+    {
+        Vector3 m_position = Vector3::Zero;
+        bool    m_isSphere = false;
+        float   m_size     = 0.5f;
+    };
+
+    /// <summary>
+    /// Bodies have a mass of 1, boxes use m_size as their half extents & spheres as their radius. The ground is the y = 0 plane.
+    /// </summary>
+    struct PhysicsParityScene
+    {
+        std::vector<PhysicsParityBody> m_bodies;
+        uint32                         m_steps    = 0;
+        float                          m_stepTime = 1.0f / 60.0f;
+        float                          m_gravity  = -9.81f;
+        float                          m_friction = 0.5f;
+    };
+
+    struct PhysicsParityResult
+    {
+        std::string m_backend     = "";
+        uint32      m_bodies      = 0;
+        uint32      m_steps       = 0;
+        uint32      m_threads     = 0;
+        uint32      m_settled     = 0;
+        uint32      m_belowGround = 0;
+        float       m_meanHeight  = 0.0f;
+        float       m_meanSpeed   = 0.0f;
+        float       m_maxSpeed    = 0.0f;
+        double      m_stepMs      = 0.0;
+    };
+
+    class PhysicsParity
+    {
+
+    public:
+        /// <summary>
+        /// Stacks of 4 boxes, every third cell has 4 spheres dropped next to each other instead.
+        /// </summary>
+        static PhysicsParityScene CreateScene(uint32 bodies, uint32 steps);
+
+        /// <summary>
+        /// Adds the entities of the scene's bodies to the registry, in the order of the bodies.
+        /// </summary>
+        static void CreateEntities(const PhysicsParityScene& scene, entt::registry& reg, std::vector<ECS::Entity>& entities);
+
+        /// <summary>
+        /// Fills the aggregates of the result from the synced locations & linear velocities of the entities.
+        /// </summary>
+        static void Aggregate(entt::registry& reg, const std::vector<ECS::Entity>& entities, PhysicsParityResult& result);
+
+        /// <summary>
+        /// True if both results come from the same scene & their aggregates agree within tolerance.
+        /// </summary>
+        static bool Compare(const PhysicsParityResult& a, const PhysicsParityResult& b);
+
+        static bool Save(const std::string& path, const PhysicsParityResult& result);
+        static bool Load(const std::string& path, PhysicsParityResult& result);
+
+        /// <summary>
+        /// Where the results of the backend are saved in the directory.
+        /// </summary>
+        static std::string GetResultsPath(const std::string& directory, const std::string& backend);
+    };
+} // namespace Lina::Physics
+
+#endif
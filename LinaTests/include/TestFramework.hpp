@@ -0,0 +1,183 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Class: TestFramework
+
+Minimal registry & runner for the headless engine tests. Tests & benchmarks register themselves at static init
+through LINA_TEST & LINA_BENCHMARK, checks inside them are made with LINA_CHECK & LINA_REQUIRE. Benchmarks run the
+same checks as the tests on bigger scenes & print their timings, they only run when asked for.
+
+Timestamp: 2/12/2022 10:14:32 AM
+*/
+
+#pragma once
+
+#ifndef TestFramework_HPP
+#define TestFramework_HPP
+
+// Headers here.
+#include "Core/SizeDefinitions.hpp"
+#include "fmt/core.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Lina::Test
+{
+    typedef void (*TestFunction)();
+
+    enum class TestKind
+    {
+        Test,
+        Benchmark
+    };
+
+    struct TestCase
+    {
+        const char*  m_suite    = "";
+        const char*  m_name     = "";
+        TestFunction m_function = nullptr;
+        TestKind     m_kind     = TestKind::Test;
+    };
+
+    class TestRegistry
+    {
+
+    public:
+        static TestRegistry& Get();
+
+        void Add(const TestCase& test);
+
+        /// <summary>
+        /// Runs the tests of the given kind whose "Suite.Name" starts with the filter, returns the number of failed ones.
+        /// </summary>
+        uint32 Run(TestKind kind, const std::string& filter);
+
+        /// <summary>
+        /// Prints "Suite.Name" of the tests of the given kind.
+        /// </summary>
+        void List(TestKind kind) const;
+
+        /// <summary>
+        /// Called by the check macros, marks the running test as failed.
+        /// </summary>
+        void Fail(const char* file, int line, const char* expression);
+
+    private:
+        std::vector<TestCase> m_tests;
+        uint32                m_failedChecks = 0;
+    };
+
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* suite, const char* name, TestFunction function, TestKind kind);
+    };
+
+    /// <summary>
+    /// Prints a line to the standard output, the engine log needs an application to be published to.
+    /// </summary>
+    template <typename... Args> void Print(const Args&... args)
+    {
+        fmt::print("{0}\n", fmt::format(args...));
+    }
+
+    class Stopwatch
+    {
+
+    public:
+        Stopwatch() : m_start(std::chrono::high_resolution_clock::now()){};
+
+        inline void Restart()
+        {
+            m_start = std::chrono::high_resolution_clock::now();
+        }
+
+        inline double GetElapsedMs() const
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_start).count();
+        }
+
+    private:
+        std::chrono::high_resolution_clock::time_point m_start;
+    };
+
+    /// <summary>
+    /// Small LCG, keeps generated scenes the same between runs & platforms.
+    /// </summary>
+    class Random
+    {
+
+    public:
+        Random(uint32 seed = 1) : m_state(seed){};
+
+        inline uint32 Next()
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return m_state >> 8;
+        }
+
+        inline float Range(float min, float max)
+        {
+            return min + (max - min) * (float)(Next() & 0xFFFF) / 65535.0f;
+        }
+
+    private:
+        uint32 m_state = 1;
+    };
+} // namespace Lina::Test
+
+#define LINA_TEST_REGISTER(SUITE, NAME, KIND)                                                                                                                                                                                                                                                              \
+    static void LinaTest_##SUITE##_##NAME();                                                                                                                                                                                                                                                               \
+    static const Lina::Test::TestRegistrar LinaTestRegistrar_##SUITE##_##NAME(#SUITE, #NAME, &LinaTest_##SUITE##_##NAME, KIND);                                                                                                                                                                            \
+    static void LinaTest_##SUITE##_##NAME()
+
+#define LINA_TEST(SUITE, NAME)      LINA_TEST_REGISTER(SUITE, NAME, Lina::Test::TestKind::Test)
+#define LINA_BENCHMARK(SUITE, NAME) LINA_TEST_REGISTER(SUITE, NAME, Lina::Test::TestKind::Benchmark)
+
+// Marks the running test as failed & continues.
+#define LINA_CHECK(x)                                                                                                                                                                                                                                                                                      \
+    do                                                                                                                                                                                                                                                                                                     \
+    {                                                                                                                                                                                                                                                                                                      \
+        if (!(x))                                                                                                                                                                                                                                                                                          \
+            Lina::Test::TestRegistry::Get().Fail(__FILE__, __LINE__, #x);                                                                                                                                                                                                                                  \
+    } while (0)
+
+// Marks the running test as failed & returns from the calling function, which has to return void.
+#define LINA_REQUIRE(x)                                                                                                                                                                                                                                                                                    \
+    do                                                                                                                                                                                                                                                                                                     \
+    {                                                                                                                                                                                                                                                                                                      \
+        if (!(x))                                                                                                                                                                                                                                                                                          \
+        {                                                                                                                                                                                                                                                                                                  \
+            Lina::Test::TestRegistry::Get().Fail(__FILE__, __LINE__, #x);                                                                                                                                                                                                                                  \
+            return;                                                                                                                                                                                                                                                                                        \
+        }                                                                                                                                                                                                                                                                                                  \
+    } while (0)
+
+#endif
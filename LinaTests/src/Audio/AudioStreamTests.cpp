@@ -0,0 +1,232 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Audio/AudioDecoder.hpp"
+#include "Audio/AudioStream.hpp"
+#include "Audio/FakeAudioStreamSink.hpp"
+#include "TestFramework.hpp"
+
+#include <thread>
+#include <vector>
+
+// Streams run a synthetic wav through a fake sink, so no device is needed. Every frame carries its own index, the
+// played output is checked for gaps & repeats while playing through, looping, seeking & starving the stream.
+namespace Lina::Audio
+{
+    namespace
+    {
+        const uint32 StreamTestSampleRate = 44100;
+        const uint32 StreamTestMaxTicks   = 10000000;
+
+        void WriteWavLE(std::vector<uint8>& data, uint32 value, uint32 bytes)
+        {
+            for (uint32 i = 0; i < bytes; i++)
+                data.push_back((uint8)(value >> (i * 8)));
+        }
+
+        // Left channel has the low 15 bits of the frame index, right channel the next 15.
+        std::vector<uint8> MakeStreamTestWav(uint32 frames)
+        {
+            const uint32       dataSize = frames * 4;
+            std::vector<uint8> data;
+            data.reserve(44 + dataSize);
+
+            data.insert(data.end(), {'R', 'I', 'F', 'F'});
+            WriteWavLE(data, 36 + dataSize, 4);
+            data.insert(data.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+            WriteWavLE(data, 16, 4);
+            WriteWavLE(data, 1, 2);
+            WriteWavLE(data, 2, 2);
+            WriteWavLE(data, StreamTestSampleRate, 4);
+            WriteWavLE(data, StreamTestSampleRate * 4, 4);
+            WriteWavLE(data, 4, 2);
+            WriteWavLE(data, 16, 2);
+            data.insert(data.end(), {'d', 'a', 't', 'a'});
+            WriteWavLE(data, dataSize, 4);
+
+            for (uint32 i = 0; i < frames; i++)
+            {
+                WriteWavLE(data, i & 0x7FFF, 2);
+                WriteWavLE(data, (i >> 15) & 0x7FFF, 2);
+            }
+
+            return data;
+        }
+
+        // Played frames must be firstFrame, firstFrame + 1 ..., wrapping to 0 at the end if the stream loops.
+        bool CheckStreamSequence(const std::vector<int16>& played, uint64 firstFrame, uint64 totalFrames, bool wrap)
+        {
+            for (size_t i = 0; i < played.size() / 2; i++)
+            {
+                uint64 expected = firstFrame + i;
+
+                if (wrap)
+                    expected %= totalFrames;
+                else if (expected >= totalFrames)
+                    return false;
+
+                const uint64 frame = (uint64)played[i * 2] | ((uint64)played[i * 2 + 1] << 15);
+                if (frame != expected)
+                    return false;
+            }
+
+            return true;
+        }
+
+        std::unique_ptr<AudioStream> MakeTestStream(const std::vector<uint8>& wav, FakeAudioStreamSink*& sink, uint32 bufferFrames, bool decodeOnThread)
+        {
+            std::unique_ptr<AudioDecoder> decoder = AudioDecoder::Create("StreamTest.wav", wav.data(), wav.size());
+
+            if (decoder == nullptr)
+                return nullptr;
+
+            auto fakeSink = std::make_unique<FakeAudioStreamSink>(4);
+            sink          = fakeSink.get();
+            return std::make_unique<AudioStream>(std::move(decoder), std::move(fakeSink), bufferFrames, decodeOnThread);
+        }
+
+        // Ticks until the sink played the given number of frames or the stream stopped.
+        void TickStream(AudioStream& stream, FakeAudioStreamSink& sink, uint32 tickFrames, uint64 frames)
+        {
+            uint64 played = 0;
+
+            for (uint32 tick = 0; tick < StreamTestMaxTicks && played < frames && stream.GetState() == AudioStreamState::Playing; tick++)
+            {
+                stream.Update();
+                const uint32 advanced = sink.Advance((uint32)std::min((uint64)tickFrames, frames - played));
+                played += advanced;
+
+                // The decoding thread fell behind, gives it time.
+                if (advanced == 0)
+                    std::this_thread::yield();
+            }
+        }
+
+        // Streams a stereo 16 bit wav of the given length, ticks consume frameMs of audio each.
+        void CheckStreams(uint32 seconds, uint32 bufferFrames, float frameMs, bool printTimings)
+        {
+            const uint32             totalFrames = seconds * StreamTestSampleRate;
+            const uint32             tickFrames  = std::max((uint32)(frameMs * 0.001f * (float)StreamTestSampleRate), 1u);
+            const std::vector<uint8> wav         = MakeStreamTestWav(totalFrames);
+            FakeAudioStreamSink*     sink        = nullptr;
+            uint32                   underruns   = 0;
+
+            // Playing through with the decoding thread, underruns depend on scheduling, only the output is checked.
+            {
+                auto stream = MakeTestStream(wav, sink, bufferFrames, true);
+                LINA_REQUIRE(stream != nullptr);
+
+                stream->Play();
+                TickStream(*stream, *sink, tickFrames, UINT64_MAX);
+
+                LINA_CHECK(stream->GetState() == AudioStreamState::Stopped);
+                LINA_CHECK(sink->GetPlayed().size() == (size_t)totalFrames * 2);
+                LINA_CHECK(CheckStreamSequence(sink->GetPlayed(), 0, totalFrames, false));
+
+                if (printTimings)
+                    Test::Print("Decoding thread: {0} underruns, {1} KB resident instead of {2} KB.", stream->GetStats().m_underruns, (uint64)sink->GetBufferCount() * bufferFrames * 2 * sizeof(int16) / 1024, (uint64)totalFrames * 2 * sizeof(int16) / 1024);
+            }
+
+            // The rest decodes on update, so the ring is always refilled in time & underruns are deterministic.
+            {
+                auto stream = MakeTestStream(wav, sink, bufferFrames, false);
+                stream->SetLooping(true);
+                stream->Play();
+                TickStream(*stream, *sink, tickFrames, (uint64)totalFrames * 5 / 2);
+
+                LINA_CHECK(sink->GetPlayed().size() == (size_t)totalFrames * 5);
+                LINA_CHECK(stream->GetStats().m_loops >= 2);
+                LINA_CHECK(CheckStreamSequence(sink->GetPlayed(), 0, totalFrames, true));
+                underruns += stream->GetStats().m_underruns;
+            }
+
+            {
+                auto stream = MakeTestStream(wav, sink, bufferFrames, false);
+                stream->Play();
+                TickStream(*stream, *sink, tickFrames, totalFrames / 4);
+
+                const uint64 seekFrame = totalFrames / 2;
+                stream->Seek(seekFrame);
+                sink->ClearPlayed();
+                stream->Update();
+
+                LINA_CHECK(stream->GetPlaybackFrame() == seekFrame);
+                TickStream(*stream, *sink, tickFrames, StreamTestSampleRate);
+
+                LINA_CHECK(sink->GetPlayed().size() == (size_t)std::min(StreamTestSampleRate, totalFrames - (uint32)seekFrame) * 2);
+                LINA_CHECK(CheckStreamSequence(sink->GetPlayed(), seekFrame, totalFrames, false));
+                underruns += stream->GetStats().m_underruns;
+            }
+
+            LINA_CHECK(underruns == 0);
+
+            // Plays more than the ring holds without updating, the sink runs dry & stops, a single underrun is reported.
+            if (totalFrames > 4 * bufferFrames)
+            {
+                auto stream = MakeTestStream(wav, sink, bufferFrames, false);
+                stream->Play();
+                sink->Advance(sink->GetBufferCount() * bufferFrames + tickFrames);
+
+                LINA_CHECK(!sink->IsPlaying());
+                stream->Update();
+                LINA_CHECK(sink->IsPlaying());
+                LINA_CHECK(stream->GetStats().m_underruns == 1);
+
+                TickStream(*stream, *sink, tickFrames, UINT64_MAX);
+
+                LINA_CHECK(sink->GetPlayed().size() == (size_t)totalFrames * 2);
+                LINA_CHECK(CheckStreamSequence(sink->GetPlayed(), 0, totalFrames, false));
+                LINA_CHECK(stream->GetStats().m_underruns == 1);
+            }
+
+            if (!printTimings)
+                return;
+
+            // Decode cost of the chunks alone.
+            std::unique_ptr<AudioDecoder> decoder = AudioDecoder::Create("StreamTest.wav", wav.data(), wav.size());
+            std::vector<int16>            samples((size_t)bufferFrames * 2);
+            const Test::Stopwatch         stopwatch;
+
+            while (decoder->Read(samples.data(), bufferFrames) == bufferFrames)
+            {
+            }
+
+            Test::Print("{0} seconds streamed, {1} ms decoding per second of audio.", seconds, stopwatch.GetElapsedMs() / seconds);
+        }
+    } // namespace
+
+    LINA_TEST(Audio, StreamPlaysLoopsSeeksAndStarvesWithoutGaps)
+    {
+        CheckStreams(3, 8192, 16.6f, false);
+    }
+
+    LINA_BENCHMARK(Audio, StreamDecoding)
+    {
+        CheckStreams(30, 8192, 16.6f, true);
+    }
+} // namespace Lina::Audio
@@ -0,0 +1,209 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Audio/AudioVoiceManager.hpp"
+#include "Audio/NullAudioVoiceDevice.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <vector>
+
+// The voice manager runs on a null device, which tracks the playback position of its sources without any output.
+namespace Lina::Audio
+{
+    namespace
+    {
+        const uint32 VoiceTestSources = 8;
+        const float  VoiceTestStep    = 0.1f;
+
+        void StepVoices(NullAudioVoiceDevice& device, AudioVoiceManager& manager, float deltaTime)
+        {
+            device.Advance(deltaTime);
+            manager.Update(deltaTime);
+        }
+
+        AudioVoiceParams MakeVoiceParams(const Vector3& position, bool looping = false)
+        {
+            AudioVoiceParams params;
+            params.m_position = position;
+            params.m_looping  = looping;
+            return params;
+        }
+
+        // Emitters spread around the listener fire short shots, several per frame, with many more voices than sources.
+        void FireShots(uint32 sources, uint32 emitters, uint32 frames, bool printTimings)
+        {
+            NullAudioVoiceDevice device(sources);
+            AudioVoiceManager    manager(&device, sources, emitters);
+            std::vector<Vector3> positions(emitters);
+            Test::Random         random;
+            const float          dt = 1.0f / 60.0f;
+
+            for (Vector3& position : positions)
+                position = Vector3(random.Range(-200.0f, 200.0f), 0.0f, random.Range(-200.0f, 200.0f));
+
+            const Test::Stopwatch stopwatch;
+
+            for (uint32 frame = 0; frame < frames; frame++)
+            {
+                const uint32 shots = 1 + random.Next() % 8;
+
+                for (uint32 i = 0; i < shots; i++)
+                {
+                    const uint32 emitter  = random.Next() % emitters;
+                    const uint8  priority = (uint8)(64 + random.Next() % 128);
+                    manager.Play(emitter + 1, random.Range(0.3f, 1.5f), MakeVoiceParams(positions[emitter]), priority);
+                }
+
+                StepVoices(device, manager, dt);
+
+                const AudioVoiceStats stats = manager.GetStats();
+                LINA_REQUIRE(stats.m_realVoices + stats.m_freeSources == sources);
+                LINA_REQUIRE(stats.m_realVoices + stats.m_virtualVoices <= emitters);
+            }
+
+            const double          frameMs = frames > 0 ? stopwatch.GetElapsedMs() / frames : 0.0;
+            const AudioVoiceStats stats   = manager.GetStats();
+            LINA_CHECK(stats.m_played > 0);
+            LINA_CHECK(stats.m_finished > 0);
+
+            if (printTimings)
+                Test::Print("{0} sources, {1} emitters, {2} ms per frame, {3} played, {4} stolen, {5} virtualized, {6} rebound, {7} dropped.", sources, emitters, frameMs, stats.m_played, stats.m_stolen, stats.m_virtualized, stats.m_rebound, stats.m_dropped);
+        }
+    } // namespace
+
+    LINA_TEST(Audio, VoicesStealByPriorityAndAge)
+    {
+        // Fills the pool one voice per step, so the first voice is the oldest.
+        NullAudioVoiceDevice device(VoiceTestSources);
+        AudioVoiceManager    manager(&device, VoiceTestSources, VoiceTestSources * 4);
+        std::vector<uint32>  voices;
+
+        for (uint32 i = 0; i < VoiceTestSources; i++)
+        {
+            voices.push_back(manager.Play(i + 1, 60.0f, MakeVoiceParams(Vector3::Zero)));
+            StepVoices(device, manager, VoiceTestStep);
+        }
+
+        for (uint32 voice : voices)
+            LINA_CHECK(manager.IsPlaying(voice) && !manager.IsVirtual(voice));
+
+        LINA_CHECK(manager.GetStats().m_freeSources == 0);
+        LINA_CHECK(manager.GetStats().m_realVoices == VoiceTestSources);
+
+        // Lower priority can't steal.
+        const uint32 low = manager.Play(100, 60.0f, MakeVoiceParams(Vector3::Zero), 64);
+        LINA_CHECK(manager.IsVirtual(low));
+        LINA_CHECK(manager.GetStats().m_stolen == 0);
+
+        // Higher priority takes the oldest voice's source, which keeps its position.
+        const uint32 high = manager.Play(101, 60.0f, MakeVoiceParams(Vector3::Zero), 200);
+        LINA_CHECK(!manager.IsVirtual(high));
+        LINA_CHECK(manager.IsVirtual(voices[0]));
+        LINA_CHECK(manager.GetStats().m_stolen == 1);
+        LINA_CHECK(std::fabs(manager.GetPosition(voices[0]) - VoiceTestStep * VoiceTestSources) < VoiceTestStep * 0.5f);
+
+        // Same priority takes the next oldest.
+        const uint32 newer = manager.Play(102, 60.0f, MakeVoiceParams(Vector3::Zero));
+        LINA_CHECK(!manager.IsVirtual(newer));
+        LINA_CHECK(manager.IsVirtual(voices[1]));
+        LINA_CHECK(manager.GetStats().m_stolen == 2);
+
+        // Ranking on update keeps the same voices.
+        StepVoices(device, manager, VoiceTestStep);
+        LINA_CHECK(manager.IsVirtual(low) && manager.IsVirtual(voices[0]) && manager.IsVirtual(voices[1]));
+        LINA_CHECK(!manager.IsVirtual(high) && !manager.IsVirtual(newer));
+    }
+
+    LINA_TEST(Audio, VoicesVirtualizeAndRebindAtTrackedPosition)
+    {
+        NullAudioVoiceDevice device(VoiceTestSources);
+        AudioVoiceManager    manager(&device, VoiceTestSources);
+
+        // A far voice is virtual with free sources.
+        const uint32 far = manager.Play(1, 60.0f, MakeVoiceParams(Vector3(1000.0f, 0.0f, 0.0f)));
+        LINA_CHECK(manager.IsVirtual(far));
+        LINA_CHECK(manager.GetStats().m_freeSources == VoiceTestSources);
+
+        for (uint32 i = 0; i < 10; i++)
+            StepVoices(device, manager, VoiceTestStep);
+
+        LINA_CHECK(manager.IsVirtual(far));
+        LINA_CHECK(manager.GetStats().m_virtualized == 1);
+
+        // Moving it close rebinds it where it would have been.
+        manager.SetParams(far, MakeVoiceParams(Vector3(2.0f, 0.0f, 0.0f)));
+        StepVoices(device, manager, VoiceTestStep);
+        LINA_CHECK(!manager.IsVirtual(far));
+        LINA_CHECK(manager.GetStats().m_rebound == 1);
+
+        StepVoices(device, manager, VoiceTestStep);
+        LINA_CHECK(std::fabs(manager.GetPosition(far) - VoiceTestStep * 12.0f) < VoiceTestStep * 0.5f);
+
+        // Real & virtual voices both end with their buffer.
+        const uint32 shortReal    = manager.Play(2, 0.5f, MakeVoiceParams(Vector3::Zero));
+        const uint32 shortVirtual = manager.Play(3, 0.5f, MakeVoiceParams(Vector3(1000.0f, 0.0f, 0.0f)));
+
+        for (uint32 i = 0; i < 6; i++)
+            StepVoices(device, manager, VoiceTestStep);
+
+        LINA_CHECK(!manager.IsPlaying(shortReal));
+        LINA_CHECK(!manager.IsPlaying(shortVirtual));
+        LINA_CHECK(manager.IsPlaying(far));
+        LINA_CHECK(manager.GetStats().m_finished == 2);
+    }
+
+    LINA_TEST(Audio, VoiceCapDropsLowestRanked)
+    {
+        NullAudioVoiceDevice device(VoiceTestSources);
+        AudioVoiceManager    manager(&device, VoiceTestSources / 2, VoiceTestSources);
+
+        for (uint32 i = 0; i < VoiceTestSources; i++)
+            manager.Play(i + 1, 60.0f, MakeVoiceParams(Vector3::Zero));
+
+        // The new voice is dropped if it ranks the lowest, otherwise the lowest ranked playing one is.
+        const uint32          rejected = manager.Play(100, 60.0f, MakeVoiceParams(Vector3::Zero), 10);
+        const uint32          accepted = manager.Play(101, 60.0f, MakeVoiceParams(Vector3::Zero), 250);
+        const AudioVoiceStats stats    = manager.GetStats();
+
+        LINA_CHECK(rejected == 0);
+        LINA_CHECK(accepted != 0 && !manager.IsVirtual(accepted));
+        LINA_CHECK(stats.m_dropped == 2);
+        LINA_CHECK(stats.m_realVoices + stats.m_virtualVoices == VoiceTestSources);
+    }
+
+    LINA_TEST(Audio, VoicesStayWithinPoolUnderGunfire)
+    {
+        FireShots(VoiceTestSources, 64, 120, false);
+    }
+
+    LINA_BENCHMARK(Audio, VoiceGunfire)
+    {
+        FireShots(32, 512, 600, true);
+    }
+} // namespace Lina::Audio
@@ -0,0 +1,380 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Math/DynamicAABBTree.hpp"
+#include "Math/Frustum.hpp"
+#include "Math/Matrix.hpp"
+#include "TestFramework.hpp"
+
+#include <algorithm>
+
+// Creates, moves & destroys random proxies & runs every query type against the tree, serially & split over an
+// executor, and against a brute force loop over the fat bounds of the live proxies. Results have to be the same sets.
+namespace Lina
+{
+    namespace
+    {
+        struct TreeTestProxy
+        {
+            int     m_id = AABBTREE_NULL_NODE;
+            Vector3 m_center;
+            Vector3 m_halfExtent;
+        };
+
+        struct TreeTestTimings
+        {
+            double m_updateMs          = 0.0;
+            double m_bruteAABBMs       = 0.0;
+            double m_treeAABBMs        = 0.0;
+            double m_parallelAABBMs    = 0.0;
+            double m_bruteFrustumMs    = 0.0;
+            double m_treeFrustumMs     = 0.0;
+            double m_parallelFrustumMs = 0.0;
+            double m_bruteRayMs        = 0.0;
+            double m_treeRayMs         = 0.0;
+        };
+
+        Vector3 CreateTreeTestLocation(Test::Random& random, float worldSize)
+        {
+            return Vector3(random.Range(-worldSize, worldSize), random.Range(-worldSize * 0.25f, worldSize * 0.25f), random.Range(-worldSize, worldSize));
+        }
+
+        void RandomizeTreeTestProxy(Test::Random& random, float worldSize, TreeTestProxy& proxy)
+        {
+            proxy.m_center     = CreateTreeTestLocation(random, worldSize);
+            proxy.m_halfExtent = Vector3(random.Range(0.1f, 4.0f), random.Range(0.1f, 4.0f), random.Range(0.1f, 4.0f));
+        }
+
+        Frustum CreateTreeTestFrustum(Test::Random& random, float worldSize)
+        {
+            const Vector3 location = CreateTreeTestLocation(random, worldSize);
+            const Vector3 target   = location + Vector3(random.Range(-1.0f, 1.0f), random.Range(-0.3f, 0.3f), random.Range(-1.0f, 1.0f)) * worldSize + Vector3(0.0f, 0.0f, 1.0f);
+            const Matrix  view     = Matrix::InitLookAt(location, target, Vector3(0.0f, 1.0f, 0.0f));
+
+            Frustum frustum;
+            frustum.Calculate(Matrix::Perspective(random.Range(30.0f, 70.0f), 1.77f, 0.1f, worldSize) * view, true);
+            return frustum;
+        }
+
+        bool OverlapsFatBounds(const DynamicAABBTree& tree, int id, const Vector3& min, const Vector3& max)
+        {
+            const Vector3& fatMin = tree.GetFatMin(id);
+            const Vector3& fatMax = tree.GetFatMax(id);
+            return fatMin.x <= max.x && fatMax.x >= min.x && fatMin.y <= max.y && fatMax.y >= min.y && fatMin.z <= max.z && fatMax.z >= min.z;
+        }
+
+        bool SphereTouchesFatBounds(const DynamicAABBTree& tree, int id, const Vector3& center, float radius)
+        {
+            const Vector3& fatMin = tree.GetFatMin(id);
+            const Vector3& fatMax = tree.GetFatMax(id);
+            const Vector3  closest(Math::Clamp(center.x, fatMin.x, fatMax.x), Math::Clamp(center.y, fatMin.y, fatMax.y), Math::Clamp(center.z, fatMin.z, fatMax.z));
+            const Vector3  offset = closest - center;
+            return offset.Dot(offset) <= radius * radius;
+        }
+
+        // Same positive & negative vertex tests as the tree, inside means no plane cuts the box.
+        FrustumTest TestFatBounds(const DynamicAABBTree& tree, int id, const Frustum& frustum)
+        {
+            const Plane*   planes[6] = {&frustum.m_left, &frustum.m_right, &frustum.m_top, &frustum.m_bottom, &frustum.m_near, &frustum.m_far};
+            const Vector3& fatMin    = tree.GetFatMin(id);
+            const Vector3& fatMax    = tree.GetFatMax(id);
+            FrustumTest    result    = FrustumTest::Inside;
+
+            for (const Plane* plane : planes)
+            {
+                const Vector3& n        = plane->m_normal;
+                const Vector3  positive = Vector3(n.x >= 0.0f ? fatMax.x : fatMin.x, n.y >= 0.0f ? fatMax.y : fatMin.y, n.z >= 0.0f ? fatMax.z : fatMin.z);
+                const Vector3  negative = Vector3(n.x >= 0.0f ? fatMin.x : fatMax.x, n.y >= 0.0f ? fatMin.y : fatMax.y, n.z >= 0.0f ? fatMin.z : fatMax.z);
+
+                if (n.Dot(positive) + plane->m_distance < 0.0f)
+                    return FrustumTest::Outside;
+
+                if (n.Dot(negative) + plane->m_distance < 0.0f)
+                    result = FrustumTest::Intersects;
+            }
+
+            return result;
+        }
+
+        // Clips the ray against each slab in turn, an axis the ray is parallel to keeps the whole interval if the origin
+        // is inside of the slab, bounds included.
+        bool RayHitsFatBounds(const DynamicAABBTree& tree, int id, const Vector3& origin, const Vector3& direction, float maxDistance)
+        {
+            const Vector3& fatMin = tree.GetFatMin(id);
+            const Vector3& fatMax = tree.GetFatMax(id);
+            float          enter  = 0.0f;
+            float          exit   = maxDistance;
+
+            for (unsigned int axis = 0; axis < 3; axis++)
+            {
+                if (direction[axis] == 0.0f)
+                {
+                    if (origin[axis] < fatMin[axis] || origin[axis] > fatMax[axis])
+                        return false;
+
+                    continue;
+                }
+
+                const float t1 = (fatMin[axis] - origin[axis]) / direction[axis];
+                const float t2 = (fatMax[axis] - origin[axis]) / direction[axis];
+                enter          = std::max(enter, std::min(t1, t2));
+                exit           = std::min(exit, std::max(t1, t2));
+            }
+
+            return enter <= exit;
+        }
+
+        // Random rays, or rays along an axis that start in front of a live proxy, exactly on its bounds on the other two
+        // axes. Returns the proxy the ray has to hit for the latter.
+        int CreateTreeTestRay(Test::Random& random, const DynamicAABBTree& tree, const std::vector<TreeTestProxy>& proxies, float worldSize, Vector3& origin, Vector3& direction)
+        {
+            if (random.Next() % 2 == 0 || proxies.empty())
+            {
+                origin    = CreateTreeTestLocation(random, worldSize);
+                direction = Vector3(random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f)).Normalized();
+                return AABBTREE_NULL_NODE;
+            }
+
+            const TreeTestProxy& proxy = proxies[random.Next() % proxies.size()];
+            const unsigned int   axis  = random.Next() % 3;
+
+            origin          = random.Next() % 2 == 0 ? tree.GetFatMin(proxy.m_id) : tree.GetFatMax(proxy.m_id);
+            origin[axis]    = tree.GetFatMin(proxy.m_id)[axis] - worldSize * 0.1f;
+            direction       = Vector3::Zero;
+            direction[axis] = 1.0f;
+            return proxy.m_id;
+        }
+
+        bool SameProxies(std::vector<int> a, std::vector<int> b)
+        {
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            return a == b;
+        }
+
+        void CheckDynamicAABBTree(uint32 count, uint32 rounds, uint32 queries, float worldSize, bool printTimings)
+        {
+            Test::Random               random(4321);
+            DynamicAABBTree            tree;
+            std::vector<TreeTestProxy> proxies;
+            Executor                   executor(4);
+            AABBTreeParallelQuery      parallelQuery;
+            TreeTestTimings            timings;
+            uint32                     axisRays = 0;
+
+            for (uint32 i = 0; i < count; i++)
+            {
+                TreeTestProxy proxy;
+                RandomizeTreeTestProxy(random, worldSize, proxy);
+                proxy.m_id = tree.CreateProxy(proxy.m_center - proxy.m_halfExtent, proxy.m_center + proxy.m_halfExtent, i);
+                proxies.push_back(proxy);
+            }
+
+            LINA_REQUIRE(tree.Validate());
+
+            for (uint32 round = 0; round < rounds; round++)
+            {
+                const Test::Stopwatch updateStopwatch;
+
+                // Most proxies jitter inside their fat bounds, some teleport, a few are replaced.
+                for (TreeTestProxy& proxy : proxies)
+                {
+                    const uint32 kind = random.Next() % 16;
+
+                    if (kind < 8)
+                        proxy.m_center = proxy.m_center + Vector3(random.Range(-0.05f, 0.05f), random.Range(-0.05f, 0.05f), random.Range(-0.05f, 0.05f));
+                    else if (kind < 10)
+                        proxy.m_center = CreateTreeTestLocation(random, worldSize);
+                    else if (kind == 10)
+                    {
+                        tree.DestroyProxy(proxy.m_id);
+                        RandomizeTreeTestProxy(random, worldSize, proxy);
+                        proxy.m_id = tree.CreateProxy(proxy.m_center - proxy.m_halfExtent, proxy.m_center + proxy.m_halfExtent, 0);
+                        continue;
+                    }
+                    else
+                        continue;
+
+                    tree.MoveProxy(proxy.m_id, proxy.m_center - proxy.m_halfExtent, proxy.m_center + proxy.m_halfExtent);
+                }
+
+                timings.m_updateMs += updateStopwatch.GetElapsedMs();
+
+                LINA_REQUIRE(tree.Validate());
+                LINA_REQUIRE(tree.GetProxyCount() == (int)count);
+
+                std::vector<int> expected;
+                std::vector<int> found;
+                std::vector<int> parallelInside;
+                std::vector<int> parallelIntersects;
+
+                for (uint32 query = 0; query < queries; query++)
+                {
+                    // Boxes.
+                    const Vector3 center = CreateTreeTestLocation(random, worldSize);
+                    const Vector3 extent = Vector3(random.Range(1.0f, 40.0f), random.Range(1.0f, 40.0f), random.Range(1.0f, 40.0f));
+                    expected.clear();
+                    found.clear();
+
+                    const Test::Stopwatch bruteAABB;
+                    for (const TreeTestProxy& proxy : proxies)
+                    {
+                        if (OverlapsFatBounds(tree, proxy.m_id, center - extent, center + extent))
+                            expected.push_back(proxy.m_id);
+                    }
+                    timings.m_bruteAABBMs += bruteAABB.GetElapsedMs();
+
+                    const Test::Stopwatch treeAABB;
+                    tree.QueryAABB(center - extent, center + extent, [&](int proxyID) {
+                        found.push_back(proxyID);
+                        return true;
+                    });
+                    timings.m_treeAABBMs += treeAABB.GetElapsedMs();
+                    LINA_CHECK(SameProxies(found, expected));
+
+                    const Test::Stopwatch parallelAABB;
+                    tree.QueryAABBParallel(executor, center - extent, center + extent, parallelQuery, found);
+                    timings.m_parallelAABBMs += parallelAABB.GetElapsedMs();
+                    LINA_CHECK(SameProxies(found, expected));
+
+                    // Spheres.
+                    const float radius = extent.x;
+                    expected.clear();
+                    found.clear();
+
+                    for (const TreeTestProxy& proxy : proxies)
+                    {
+                        if (SphereTouchesFatBounds(tree, proxy.m_id, center, radius))
+                            expected.push_back(proxy.m_id);
+                    }
+
+                    tree.QuerySphere(center, radius, [&](int proxyID) {
+                        found.push_back(proxyID);
+                        return true;
+                    });
+                    LINA_CHECK(SameProxies(found, expected));
+
+                    // Frustums, proxies reported as inside have to be completely inside.
+                    const Frustum    frustum = CreateTreeTestFrustum(random, worldSize);
+                    std::vector<int> expectedInside;
+                    std::vector<int> inside;
+                    expected.clear();
+                    found.clear();
+
+                    const Test::Stopwatch bruteFrustum;
+                    for (const TreeTestProxy& proxy : proxies)
+                    {
+                        const FrustumTest result = TestFatBounds(tree, proxy.m_id, frustum);
+
+                        if (result != FrustumTest::Outside)
+                            expected.push_back(proxy.m_id);
+
+                        if (result == FrustumTest::Inside)
+                            expectedInside.push_back(proxy.m_id);
+                    }
+                    timings.m_bruteFrustumMs += bruteFrustum.GetElapsedMs();
+
+                    const Test::Stopwatch treeFrustum;
+                    tree.QueryFrustum(frustum, [&](int proxyID, AABBTreeQueryResult result) {
+                        found.push_back(proxyID);
+
+                        if (result == AABBTreeQueryResult::Inside)
+                            inside.push_back(proxyID);
+
+                        return true;
+                    });
+                    timings.m_treeFrustumMs += treeFrustum.GetElapsedMs();
+                    LINA_CHECK(SameProxies(found, expected));
+
+                    LINA_CHECK(SameProxies(inside, expectedInside));
+
+                    const Test::Stopwatch parallelFrustum;
+                    tree.QueryFrustumParallel(executor, frustum, parallelQuery, parallelInside, parallelIntersects);
+                    timings.m_parallelFrustumMs += parallelFrustum.GetElapsedMs();
+                    LINA_CHECK(SameProxies(parallelInside, inside));
+                    parallelInside.insert(parallelInside.end(), parallelIntersects.begin(), parallelIntersects.end());
+                    LINA_CHECK(SameProxies(parallelInside, expected));
+
+                    // Rays.
+                    Vector3     origin;
+                    Vector3     direction;
+                    const float maxDistance = worldSize;
+                    const int   source      = CreateTreeTestRay(random, tree, proxies, worldSize, origin, direction);
+                    bool        inRange     = true;
+                    expected.clear();
+                    found.clear();
+
+                    const Test::Stopwatch bruteRay;
+                    for (const TreeTestProxy& proxy : proxies)
+                    {
+                        if (RayHitsFatBounds(tree, proxy.m_id, origin, direction, maxDistance))
+                            expected.push_back(proxy.m_id);
+                    }
+                    timings.m_bruteRayMs += bruteRay.GetElapsedMs();
+
+                    const Test::Stopwatch treeRay;
+                    tree.RayCast(origin, direction, maxDistance, [&](int proxyID, float distance) {
+                        found.push_back(proxyID);
+                        inRange = inRange && distance >= 0.0f && distance <= maxDistance;
+                        return true;
+                    });
+                    timings.m_treeRayMs += treeRay.GetElapsedMs();
+                    LINA_CHECK(inRange);
+                    LINA_CHECK(SameProxies(found, expected));
+
+                    if (source != AABBTREE_NULL_NODE)
+                    {
+                        axisRays++;
+                        LINA_CHECK(std::find(found.begin(), found.end(), source) != found.end());
+                    }
+                }
+            }
+
+            LINA_CHECK(axisRays > 0);
+
+            if (!printTimings)
+                return;
+
+            const double totalQueries = (double)rounds * queries;
+            Test::Print("{0} proxies, tree height {1}, {2} ms per update round.", count, tree.GetHeight(), timings.m_updateMs / rounds);
+            Test::Print("AABB queries, brute force {0} ms, tree {1} ms, parallel tree {2} ms.", timings.m_bruteAABBMs / totalQueries, timings.m_treeAABBMs / totalQueries, timings.m_parallelAABBMs / totalQueries);
+            Test::Print("Frustum queries, brute force {0} ms, tree {1} ms, parallel tree {2} ms.", timings.m_bruteFrustumMs / totalQueries, timings.m_treeFrustumMs / totalQueries, timings.m_parallelFrustumMs / totalQueries);
+            Test::Print("Ray queries, brute force {0} ms, tree {1} ms.", timings.m_bruteRayMs / totalQueries, timings.m_treeRayMs / totalQueries);
+        }
+    } // namespace
+
+    LINA_TEST(Common, AABBTreeQueriesMatchBruteForce)
+    {
+        CheckDynamicAABBTree(4000, 6, 24, 400.0f, false);
+    }
+
+    LINA_BENCHMARK(Common, DynamicAABBTree)
+    {
+        CheckDynamicAABBTree(100000, 5, 40, 2000.0f, true);
+    }
+} // namespace Lina
@@ -0,0 +1,237 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Math/AABB.hpp"
+#include "Math/Frustum.hpp"
+#include "Math/FrustumCuller.hpp"
+#include "Math/Matrix.hpp"
+#include "TestFramework.hpp"
+
+// Culls random boxes against random camera frustums with the scalar reference & every SIMD kernel compiled into this
+// build, the visibility bitsets have to match bit for bit.
+namespace Lina
+{
+    namespace
+    {
+        Frustum CreateFuzzFrustum(Test::Random& random)
+        {
+            const Vector3 location = Vector3(random.Range(-200.0f, 200.0f), random.Range(-50.0f, 50.0f), random.Range(-200.0f, 200.0f));
+            Vector3       target   = Vector3(random.Range(-200.0f, 200.0f), random.Range(-50.0f, 50.0f), random.Range(-200.0f, 200.0f));
+
+            if ((target - location).MagnitudeSqrt() < 1.0f)
+                target = location + Vector3(0.0f, 0.0f, 1.0f);
+
+            const Matrix view       = Matrix::InitLookAt(location, target, Vector3(0.0f, 1.0f, 0.0f));
+            const Matrix projection = Matrix::Perspective(random.Range(20.0f, 60.0f), random.Range(1.0f, 2.5f), random.Range(0.01f, 1.0f), random.Range(50.0f, 1000.0f));
+
+            Frustum frustum;
+            frustum.Calculate(projection * view, random.Next() % 2 == 0);
+            return frustum;
+        }
+
+        // Mostly regular boxes, some flat, empty or huge ones & some exactly at the origin so several share a center.
+        void CreateFuzzBounds(Test::Random& random, uint32 count, AABBSoA& bounds)
+        {
+            bounds.Clear();
+            bounds.Reserve(count);
+
+            for (uint32 i = 0; i < count; i++)
+            {
+                Vector3      center = Vector3(random.Range(-400.0f, 400.0f), random.Range(-100.0f, 100.0f), random.Range(-400.0f, 400.0f));
+                Vector3      extent = Vector3(random.Range(0.0f, 10.0f), random.Range(0.0f, 10.0f), random.Range(0.0f, 10.0f));
+                const uint32 kind   = random.Next() % 16;
+
+                if (kind == 0)
+                    extent = Vector3::Zero;
+                else if (kind == 1)
+                    extent.y = 0.0f;
+                else if (kind == 2)
+                    extent = extent * 50.0f;
+                else if (kind == 3)
+                    center = Vector3::Zero;
+
+                bounds.Add(center, extent);
+            }
+        }
+
+        uint32 CountVisible(const std::vector<uint32>& visibility, uint32 count)
+        {
+            uint32 visible = 0;
+
+            for (uint32 i = 0; i < count; i++)
+                visible += FrustumCuller::IsVisible(visibility, i) ? 1 : 0;
+
+            return visible;
+        }
+
+        // Bits past the last box stay clear, so callers can count words.
+        bool HasClearTail(const std::vector<uint32>& visibility, uint32 count)
+        {
+            for (uint32 i = count; i < (uint32)visibility.size() * 32; i++)
+            {
+                if (FrustumCuller::IsVisible(visibility, i))
+                    return false;
+            }
+
+            return true;
+        }
+
+        void CheckKernels(const Frustum& frustum, AABBSoA& bounds)
+        {
+            std::vector<uint32> reference;
+            FrustumCuller::CullScalar(frustum, bounds, reference);
+            LINA_REQUIRE(reference.size() == (bounds.m_count + 31) / 32);
+            LINA_REQUIRE(HasClearTail(reference, bounds.m_count));
+
+#ifdef LINA_FRUSTUM_CULL_SSE
+            std::vector<uint32> sse;
+            FrustumCuller::CullSSE(frustum, bounds, sse);
+            LINA_REQUIRE(sse == reference);
+#endif
+
+#ifdef LINA_FRUSTUM_CULL_AVX
+            if (FrustumCuller::IsAVXSupported())
+            {
+                std::vector<uint32> avx;
+                FrustumCuller::CullAVX(frustum, bounds, avx);
+                LINA_REQUIRE(avx == reference);
+            }
+#endif
+
+            std::vector<uint32> dispatched;
+            FrustumCuller::Cull(frustum, bounds, dispatched);
+            LINA_REQUIRE(dispatched == reference);
+        }
+
+        // Per box test the culler replaced, the box is visible unless it's fully outside a plane.
+        uint32 CullWithFrustum(const Frustum& frustum, const AABBSoA& bounds)
+        {
+            uint32 visible = 0;
+
+            for (uint32 i = 0; i < bounds.m_count; i++)
+            {
+                const Vector3 center = Vector3(bounds.m_centerX[i], bounds.m_centerY[i], bounds.m_centerZ[i]);
+                const Vector3 extent = Vector3(bounds.m_extentX[i], bounds.m_extentY[i], bounds.m_extentZ[i]);
+                visible += frustum.TestIntersection(AABB(center - extent, center + extent)) != FrustumTest::Outside ? 1 : 0;
+            }
+
+            return visible;
+        }
+    } // namespace
+
+    LINA_TEST(Common, FrustumCullKernelsMatchScalar)
+    {
+        Test::Random random(1234);
+        AABBSoA      bounds;
+
+        // Every count up to a few SIMD widths, so each padding length is hit.
+        for (uint32 count = 0; count < 70; count++)
+        {
+            CreateFuzzBounds(random, count, bounds);
+            CheckKernels(CreateFuzzFrustum(random), bounds);
+        }
+
+        for (uint32 run = 0; run < 200; run++)
+        {
+            CreateFuzzBounds(random, 1000 + random.Next() % 1000, bounds);
+            CheckKernels(CreateFuzzFrustum(random), bounds);
+        }
+
+        // Boxes added after a padded cull drop the padding first.
+        CreateFuzzBounds(random, 13, bounds);
+        CheckKernels(CreateFuzzFrustum(random), bounds);
+
+        for (uint32 i = 0; i < 6; i++)
+            bounds.Add(Vector3(random.Range(-10.0f, 10.0f), 0.0f, random.Range(-10.0f, 10.0f)), Vector3::One);
+
+        LINA_CHECK(bounds.m_count == 19 && bounds.m_centerX.size() == 19);
+        CheckKernels(CreateFuzzFrustum(random), bounds);
+    }
+
+    LINA_BENCHMARK(Common, FrustumCuller)
+    {
+        const uint32 count = 100000;
+        const uint32 runs  = 200;
+        Test::Random random(99);
+        AABBSoA      bounds;
+        CreateFuzzBounds(random, count, bounds);
+
+        std::vector<Frustum> frustums;
+        for (uint32 i = 0; i < runs; i++)
+            frustums.push_back(CreateFuzzFrustum(random));
+
+        std::vector<uint32> visibility;
+        uint32              visible = 0;
+
+        const Test::Stopwatch frustumStopwatch;
+        for (const Frustum& frustum : frustums)
+            visible += CullWithFrustum(frustum, bounds);
+        const double frustumMs = frustumStopwatch.GetElapsedMs() / runs;
+        Test::Print("{0} boxes, {1} visible on average. Per box frustum test {2} ms per cull.", count, visible / runs, frustumMs);
+
+        visible = 0;
+        const Test::Stopwatch scalarStopwatch;
+        for (const Frustum& frustum : frustums)
+        {
+            FrustumCuller::CullScalar(frustum, bounds, visibility);
+            visible += CountVisible(visibility, count);
+        }
+        const double scalarMs = scalarStopwatch.GetElapsedMs() / runs;
+        Test::Print("Scalar {0} ms per cull, {1}x the per box test, {2} visible on average.", scalarMs, scalarMs > 0.0 ? frustumMs / scalarMs : 1.0, visible / runs);
+
+#ifdef LINA_FRUSTUM_CULL_SSE
+        visible = 0;
+        const Test::Stopwatch sseStopwatch;
+        for (const Frustum& frustum : frustums)
+        {
+            FrustumCuller::CullSSE(frustum, bounds, visibility);
+            visible += CountVisible(visibility, count);
+        }
+        const double sseMs = sseStopwatch.GetElapsedMs() / runs;
+        Test::Print("SSE {0} ms per cull, {1}x scalar, {2} visible on average.", sseMs, sseMs > 0.0 ? scalarMs / sseMs : 1.0, visible / runs);
+#endif
+
+#ifdef LINA_FRUSTUM_CULL_AVX
+        if (!FrustumCuller::IsAVXSupported())
+        {
+            Test::Print("AVX isn't supported on this CPU.");
+            return;
+        }
+
+        visible = 0;
+        const Test::Stopwatch avxStopwatch;
+        for (const Frustum& frustum : frustums)
+        {
+            FrustumCuller::CullAVX(frustum, bounds, visibility);
+            visible += CountVisible(visibility, count);
+        }
+        const double avxMs = avxStopwatch.GetElapsedMs() / runs;
+        Test::Print("AVX {0} ms per cull, {1}x scalar, {2} visible on average.", avxMs, avxMs > 0.0 ? scalarMs / avxMs : 1.0, visible / runs);
+#endif
+    }
+} // namespace Lina
@@ -0,0 +1,156 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Animation/Animation.hpp"
+#include "Animation/AnimationCompressor.hpp"
+#include "Animation/Skeleton.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <memory>
+
+// Compresses a synthetic clip keyed at 60 fps, the way the importer does. The compressed clip has to stay within the
+// object space tolerance of the source keys, measured against an uncompressed copy of the same clip.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        const uint32 CompressorKeysPerSecond = 60;
+
+        // Three children per joint. Rotations are always animated, every fourth joint moves, the others hold an offset
+        // translation away from the bind pose. Scales stay at the bind pose so they can be dropped.
+        void CreateCompressorRig(Skeleton& skeleton, uint32 joints)
+        {
+            for (uint32 i = 0; i < joints; i++)
+            {
+                JointTransform bindPose;
+                bindPose.m_translation[1] = i == 0 ? 0.0f : 0.1f;
+                skeleton.AddJoint("Joint_" + std::to_string(i), i == 0 ? -1 : (int)(i - 1) / 3, bindPose, Matrix::Identity());
+            }
+        }
+
+        Animation* CreateCompressorClip(uint32 joints, float duration)
+        {
+            Animation* animation = new Animation();
+            animation->SetName("CompressorTest");
+            animation->SetDuration(duration);
+
+            const uint32              keys = (uint32)(duration * CompressorKeysPerSecond) + 1;
+            std::vector<float>        times(keys);
+            std::vector<AnimationKey> translations(keys), rotations(keys), scales(keys);
+
+            for (uint32 i = 0; i < joints; i++)
+            {
+                for (uint32 k = 0; k < keys; k++)
+                {
+                    const float t     = (float)k / (float)CompressorKeysPerSecond;
+                    const float angle = std::sin(t * 3.0f + (float)i) * 0.4f + std::sin(t * 7.0f) * 0.05f;
+                    const float lift  = i % 4 == 0 ? std::sin(t * 2.0f + (float)i) * 0.02f : 0.01f;
+                    times[k]          = t;
+                    translations[k]   = AnimationKey{{0.0f, (i == 0 ? 0.0f : 0.1f) + lift, 0.0f, 0.0f}};
+                    rotations[k]      = AnimationKey{{std::sin(angle * 0.5f), 0.0f, 0.0f, std::cos(angle * 0.5f)}};
+                    scales[k]         = AnimationKey{{1.0f, 1.0f, 1.0f, 0.0f}};
+                }
+
+                animation->AddTrack(i, times, translations, times, rotations, times, scales);
+            }
+
+            return animation;
+        }
+
+        void CheckAnimationCompressor(uint32 joints, float duration, float minRatio, bool printTimings)
+        {
+            Skeleton skeleton;
+            CreateCompressorRig(skeleton, joints);
+
+            // The skeleton owns the compressed clip, the reference keeps the source keys.
+            std::unique_ptr<Animation> reference(CreateCompressorClip(joints, duration));
+            Animation*                 animation = CreateCompressorClip(joints, duration);
+            skeleton.AddAnimation(animation);
+
+            AnimationCompressionSettings    settings;
+            const Test::Stopwatch           compressStopwatch;
+            const AnimationCompressionStats stats      = AnimationCompressor::Compress(skeleton, *animation, settings);
+            const double                    compressMs = compressStopwatch.GetElapsedMs();
+
+            LINA_REQUIRE(animation->IsCompressed());
+            LINA_CHECK(stats.m_rawSize == reference->GetDataSize());
+            LINA_CHECK(stats.m_compressedSize == animation->GetDataSize());
+            LINA_CHECK(stats.m_ratio >= minRatio);
+            LINA_CHECK(stats.m_maxError <= settings.m_tolerance);
+
+            // Every translation that holds an offset is stored once, every scale is dropped.
+            LINA_CHECK(stats.m_animatedChannels == joints + (joints + 3) / 4);
+            LINA_CHECK(stats.m_constantChannels == joints - (joints + 3) / 4);
+            LINA_CHECK(stats.m_droppedChannels == joints);
+
+            // Measured independently of the compressor's own stats, at a rate that doesn't line up with the source keys.
+            uint32      errorJoint = 0;
+            const float error      = AnimationCompressor::MeasureError(skeleton, *reference, *animation, 47.0f, settings.m_shellDistance, &errorJoint);
+            LINA_CHECK(error <= settings.m_tolerance);
+            LINA_CHECK(errorJoint < joints);
+
+            // Compressing again leaves the clip as it is.
+            const AnimationCompressionStats again = AnimationCompressor::Compress(skeleton, *animation, settings);
+            LINA_CHECK(again.m_rawSize == stats.m_compressedSize && again.m_ratio == 1.0f);
+
+            if (!printTimings)
+                return;
+
+            // Sampling cost of both forms, over the whole clip.
+            std::vector<JointTransform> pose(joints);
+            const uint32                samples = 10000;
+            double                      sampleMs[2];
+
+            for (uint32 form = 0; form < 2; form++)
+            {
+                const Animation*      clip = form == 0 ? reference.get() : animation;
+                const Test::Stopwatch stopwatch;
+
+                for (uint32 i = 0; i < samples; i++)
+                    clip->Sample(duration * (float)i / (float)samples, pose.data());
+
+                sampleMs[form] = stopwatch.GetElapsedMs();
+            }
+
+            Test::Print("{0} joints, {1} s clip, {2} -> {3} bytes, {4}x ratio, compressed in {5} ms.", joints, duration, stats.m_rawSize, stats.m_compressedSize, stats.m_ratio, compressMs);
+            Test::Print("Max error {0} at joint {1}, {2} stored keys, {3} animated, {4} constant, {5} dropped channels.", error, errorJoint, stats.m_storedKeys, stats.m_animatedChannels, stats.m_constantChannels, stats.m_droppedChannels);
+            Test::Print("Sampling {0} us raw, {1} us compressed.", sampleMs[0] * 1000.0 / samples, sampleMs[1] * 1000.0 / samples);
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, AnimationCompressorStaysWithinTolerance)
+    {
+        CheckAnimationCompressor(40, 2.0f, 4.0f, false);
+    }
+
+    LINA_BENCHMARK(Graphics, AnimationCompressor)
+    {
+        CheckAnimationCompressor(120, 30.0f, 4.0f, true);
+    }
+} // namespace Lina::Graphics
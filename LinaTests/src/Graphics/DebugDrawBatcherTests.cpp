@@ -0,0 +1,200 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "EventSystem/GraphicsEvents.hpp"
+#include "Rendering/DebugDrawBatcher.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <set>
+
+// Expands debug shapes into line lists & counts the draws the render engine issues for them, one per non-empty depth
+// mode & one per icon texture. Nothing is uploaded, so it runs without the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        const uint32 DebugCircleLines = 18;
+
+        bool IsNear(float a, float b)
+        {
+            return std::fabs(a - b) < 1e-3f;
+        }
+
+        // Same grouping the render engine walks when it flushes the batcher.
+        uint32 CountDebugDraws(DebugDrawBatcher& batcher)
+        {
+            uint32 draws = 0;
+
+            for (int i = 0; i < DEBUG_DEPTH_MODES; i++)
+                draws += batcher.GetLineVertices(static_cast<DebugDepthMode>(i)).empty() ? 0 : 1;
+
+            batcher.SortIcons();
+            const std::vector<DebugIcon>& icons = batcher.GetIcons();
+
+            for (size_t i = 0; i < icons.size(); i++)
+            {
+                if (i == 0 || icons[i].m_textureID != icons[i - 1].m_textureID)
+                    draws++;
+            }
+
+            return draws;
+        }
+
+        void CheckDebugDrawBatcher(uint32 shapes, bool printTimings)
+        {
+            DebugDrawBatcher batcher;
+            Test::Random     random(shapes);
+            uint32           lines[DEBUG_DEPTH_MODES] = {0, 0};
+
+            const Test::Stopwatch stopwatch;
+
+            for (uint32 i = 0; i < shapes; i++)
+            {
+                const DebugDepthMode mode   = (DebugDepthMode)(random.Next() % DEBUG_DEPTH_MODES);
+                const Vector3        center = Vector3(random.Range(-50.0f, 50.0f), random.Range(-50.0f, 50.0f), random.Range(-50.0f, 50.0f));
+                const float          size   = random.Range(0.1f, 5.0f);
+
+                switch (i % 5)
+                {
+                case 0:
+                    batcher.AddLine(center, center + Vector3(size), Color::Red, mode);
+                    lines[(int)mode] += 1;
+                    break;
+                case 1:
+                    batcher.AddBox(center, Vector3(size, size * 2.0f, size * 0.5f), Color::Red, mode);
+                    lines[(int)mode] += 12;
+                    break;
+                case 2:
+                    batcher.AddSphere(center, size, Color::Red, mode);
+                    lines[(int)mode] += DebugCircleLines * 3;
+                    break;
+                case 3:
+                    batcher.AddCapsule(center, size, size * 2.0f, Color::Red, mode);
+                    lines[(int)mode] += (DebugCircleLines * 2) * 2 + 4;
+                    break;
+                default:
+                    batcher.AddIcon(center, 1 + random.Next() % 7, size);
+                    break;
+                }
+            }
+
+            const double addMs = stopwatch.GetElapsedMs();
+
+            for (int i = 0; i < DEBUG_DEPTH_MODES; i++)
+                LINA_CHECK(batcher.GetLineVertices(static_cast<DebugDepthMode>(i)).size() == (size_t)lines[i] * 2);
+
+            std::set<StringIDType> textures;
+            for (const DebugIcon& icon : batcher.GetIcons())
+                textures.insert(icon.m_textureID);
+
+            // Icons sharing a texture end up consecutive, so each texture costs a single draw.
+            const uint32 draws = CountDebugDraws(batcher);
+            LINA_CHECK(draws == (lines[0] > 0 ? 1 : 0) + (lines[1] > 0 ? 1 : 0) + (uint32)textures.size());
+
+            for (uint32 i = 0; i < draws; i++)
+                batcher.AddDrawCall();
+
+            batcher.Clear();
+
+            const DebugDrawStats& stats = batcher.GetLastFrameStats();
+            LINA_CHECK(stats.m_lineCount == lines[0] + lines[1]);
+            LINA_CHECK(stats.m_iconCount == shapes / 5);
+            LINA_CHECK(stats.m_drawCalls == draws);
+            LINA_CHECK(batcher.GetIcons().empty() && batcher.GetLineVertices(DebugDepthMode::DepthTested).empty() && batcher.GetLineVertices(DebugDepthMode::Overlay).empty());
+
+            if (printTimings)
+                Test::Print("{0} shapes into {1} lines & {2} icons in {3} ms, {4} draws.", shapes, stats.m_lineCount, stats.m_iconCount, addMs, draws);
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, DebugDrawBatcherExpandsShapes)
+    {
+        DebugDrawBatcher batcher;
+        const Vector3    center(1.0f, 2.0f, 3.0f);
+        const Vector3    halfExtents(1.0f, 2.0f, 3.0f);
+
+        // Every box vertex is one of its corners, both ends of each edge differ on exactly one axis.
+        batcher.AddBox(center, halfExtents, Color::Red, DebugDepthMode::Overlay);
+        const std::vector<DebugVertex>& box = batcher.GetLineVertices(DebugDepthMode::Overlay);
+        LINA_REQUIRE(box.size() == 24);
+        LINA_CHECK(batcher.GetLineVertices(DebugDepthMode::DepthTested).empty());
+
+        for (size_t i = 0; i < box.size(); i += 2)
+        {
+            int differingAxes = 0;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                LINA_CHECK(IsNear(std::fabs(box[i].m_position[axis] - center[axis]), halfExtents[axis]));
+                differingAxes += IsNear(box[i].m_position[axis], box[i + 1].m_position[axis]) ? 0 : 1;
+            }
+            LINA_CHECK(differingAxes == 1);
+        }
+
+        // Sphere vertices are on the sphere.
+        batcher.AddSphere(center, 2.5f, Color::Green);
+        const std::vector<DebugVertex>& sphere = batcher.GetLineVertices(DebugDepthMode::DepthTested);
+        LINA_REQUIRE(sphere.size() == DebugCircleLines * 3 * 2);
+
+        for (const DebugVertex& vertex : sphere)
+            LINA_CHECK(IsNear((vertex.m_position - center).Magnitude(), 2.5f));
+
+        // Frustum corners of an orthographic projection land on its box, the engine is left handed.
+        batcher.Clear();
+        batcher.AddFrustum(Matrix::Orthographic(-2.0f, 2.0f, -3.0f, 3.0f, 1.0f, 5.0f), Color::White);
+        const std::vector<DebugVertex>& frustum = batcher.GetLineVertices(DebugDepthMode::DepthTested);
+        LINA_REQUIRE(frustum.size() == 24);
+
+        for (const DebugVertex& vertex : frustum)
+        {
+            LINA_CHECK(IsNear(std::fabs(vertex.m_position.x), 2.0f));
+            LINA_CHECK(IsNear(std::fabs(vertex.m_position.y), 3.0f));
+            LINA_CHECK(IsNear(vertex.m_position.z, 1.0f) || IsNear(vertex.m_position.z, 5.0f));
+        }
+
+        // Packed lines keep their positions & unpack ARGB colors.
+        Event::DebugPackedLine packed = {{1.0f, 2.0f, 3.0f}, 0xFFFF0000u, {4.0f, 5.0f, 6.0f}, 0xFF0000FFu};
+        batcher.Clear();
+        batcher.AddPackedLines(&packed, 1, DebugDepthMode::Overlay);
+        const std::vector<DebugVertex>& packedVertices = batcher.GetLineVertices(DebugDepthMode::Overlay);
+        LINA_REQUIRE(packedVertices.size() == 2);
+        LINA_CHECK(packedVertices[0].m_position == Vector3(1.0f, 2.0f, 3.0f) && packedVertices[1].m_position == Vector3(4.0f, 5.0f, 6.0f));
+        LINA_CHECK(packedVertices[0].m_color == Color(1.0f, 0.0f, 0.0f, 1.0f) && packedVertices[1].m_color == Color(0.0f, 0.0f, 1.0f, 1.0f));
+        LINA_CHECK(batcher.GetLineVertices(DebugDepthMode::DepthTested).empty());
+    }
+
+    LINA_TEST(Graphics, DebugDrawBatcherCountsDraws)
+    {
+        CheckDebugDrawBatcher(1000, false);
+    }
+
+    LINA_BENCHMARK(Graphics, DebugDrawBatcher)
+    {
+        CheckDebugDrawBatcher(100000, true);
+    }
+} // namespace Lina::Graphics
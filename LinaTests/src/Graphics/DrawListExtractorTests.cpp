@@ -0,0 +1,183 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
+#include "Rendering/DrawListExtractor.hpp"
+#include "TestFramework.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Fills a registry with model node renderables & gathers the ones that moved, the same way the model node system
+// detects changed proxies. Nothing is drawn, so it runs without the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        struct ExtractedRenderable
+        {
+            ECS::Entity m_entity = entt::null;
+            Matrix      m_model;
+        };
+
+        void CreateExtractionScene(entt::registry& reg, uint32 renderables)
+        {
+            const uint32 gridSize = (uint32)std::ceil(std::cbrt((float)renderables));
+
+            for (uint32 i = 0; i < renderables; i++)
+            {
+                const ECS::Entity entity = reg.create();
+                auto&             data   = reg.emplace<ECS::EntityDataComponent>(entity);
+                data.SetLocation(Vector3((float)(i % gridSize), (float)((i / gridSize) % gridSize), (float)(i / (gridSize * gridSize))) * 4.0f);
+                reg.emplace<ECS::ModelNodeComponent>(entity).m_nodeIndex = 0;
+            }
+        }
+
+        // Every moveEvery'th renderable in storage order moves.
+        void MoveRenderables(entt::registry& reg, uint32 moveEvery, float offset)
+        {
+            auto&              datas    = reg.storage<ECS::EntityDataComponent>();
+            const ECS::Entity* entities = reg.storage<ECS::ModelNodeComponent>().data();
+            const uint32       count    = (uint32)reg.storage<ECS::ModelNodeComponent>().size();
+
+            for (uint32 i = 0; i < count; i += moveEvery)
+            {
+                auto& data = datas.get(entities[i]);
+                data.SetLocation(data.GetLocation() + Vector3(0.0f, offset, 0.0f));
+            }
+        }
+
+        void ExtractMoved(DrawListExtractor& extractor, entt::registry& reg, uint32 version, std::vector<std::vector<ExtractedRenderable>>& slices, std::vector<ExtractedRenderable>& out)
+        {
+            // Storages are fetched here, fetching them on the workers might create them.
+            auto& nodes = reg.storage<ECS::ModelNodeComponent>();
+            auto& datas = reg.storage<ECS::EntityDataComponent>();
+
+            extractor.Gather((uint32)nodes.size(), slices, out, [&](uint32 begin, uint32 end, std::vector<ExtractedRenderable>& items) {
+                const ECS::Entity* entities = nodes.data();
+
+                for (uint32 i = begin; i < end; i++)
+                {
+                    ECS::EntityDataComponent& data = datas.get(entities[i]);
+
+                    if (data.GetTransformVersion() == version)
+                        continue;
+
+                    ExtractedRenderable& item = items.emplace_back();
+                    item.m_entity             = entities[i];
+                    item.m_model              = data.ToMatrix();
+                }
+            });
+        }
+
+        // Moved renderables in storage order, matrices match the components.
+        void CheckExtracted(entt::registry& reg, const std::vector<ExtractedRenderable>& items, uint32 moveEvery)
+        {
+            const ECS::Entity* entities = reg.storage<ECS::ModelNodeComponent>().data();
+            const uint32       count    = (uint32)reg.storage<ECS::ModelNodeComponent>().size();
+            LINA_REQUIRE(items.size() == (count + moveEvery - 1) / moveEvery);
+
+            for (uint32 i = 0; i < (uint32)items.size(); i++)
+            {
+                LINA_REQUIRE(items[i].m_entity == entities[i * moveEvery]);
+                LINA_REQUIRE(items[i].m_model.GetTranslation() == reg.get<ECS::EntityDataComponent>(items[i].m_entity).GetLocation());
+            }
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, GatheredItemsAreIndependentOfScheduling)
+    {
+        const uint32   renderables = 5000;
+        const uint32   moveEvery   = 3;
+        entt::registry reg;
+        CreateExtractionScene(reg, renderables);
+
+        const uint32 version = reg.get<ECS::EntityDataComponent>(reg.storage<ECS::ModelNodeComponent>().data()[0]).GetTransformVersion();
+        MoveRenderables(reg, moveEvery, 1.0f);
+
+        // Small slices, so there are several per worker.
+        DrawListExtractor                             serial(1);
+        DrawListExtractor                             parallel;
+        std::vector<std::vector<ExtractedRenderable>> serialSlices, parallelSlices;
+        std::vector<ExtractedRenderable>              a, b;
+        serial.SetSliceSize(64);
+        parallel.SetSliceSize(64);
+        ExtractMoved(serial, reg, version, serialSlices, a);
+        ExtractMoved(parallel, reg, version, parallelSlices, b);
+
+        CheckExtracted(reg, a, moveEvery);
+        CheckExtracted(reg, b, moveEvery);
+        LINA_CHECK(serialSlices.size() == (renderables + 63) / 64);
+
+        // Against the moved version only the others are gathered, slice arrays are cleared & reused.
+        const uint32 movedVersion = reg.get<ECS::EntityDataComponent>(reg.storage<ECS::ModelNodeComponent>().data()[0]).GetTransformVersion();
+        ExtractMoved(parallel, reg, movedVersion, parallelSlices, b);
+        LINA_CHECK(b.size() == renderables - (renderables + moveEvery - 1) / moveEvery);
+        LINA_CHECK(parallelSlices.size() == (renderables + 63) / 64);
+    }
+
+    LINA_BENCHMARK(Graphics, DrawListExtraction)
+    {
+        const uint32   renderables = 200000;
+        const uint32   moveEvery   = 4;
+        const uint32   frames      = 30;
+        entt::registry reg;
+        CreateExtractionScene(reg, renderables);
+
+        const uint32 version = reg.get<ECS::EntityDataComponent>(reg.storage<ECS::ModelNodeComponent>().data()[0]).GetTransformVersion();
+        MoveRenderables(reg, moveEvery, 1.0f);
+
+        const uint32 workers  = std::max((uint32)GetSharedExecutor().num_workers(), 1u);
+        double       singleMs = 0.0;
+
+        // 1, 2, 4 ... threads, the last run uses every worker.
+        for (uint32 threads = 1;; threads = std::min(threads * 2, workers))
+        {
+            DrawListExtractor                             extractor(threads);
+            std::vector<std::vector<ExtractedRenderable>> slices;
+            std::vector<ExtractedRenderable>              items;
+
+            // Warm up, allocates the slice arrays.
+            ExtractMoved(extractor, reg, version, slices, items);
+            CheckExtracted(reg, items, moveEvery);
+
+            const Test::Stopwatch stopwatch;
+
+            for (uint32 frame = 0; frame < frames; frame++)
+                ExtractMoved(extractor, reg, version, slices, items);
+
+            const double frameMs = stopwatch.GetElapsedMs() / frames;
+            singleMs             = threads == 1 ? frameMs : singleMs;
+            Test::Print("{0} renderables, {1} moved, {2} threads, {3} ms per frame, {4}x speedup.", renderables, items.size(), extractor.GetWorkerCount(), frameMs, frameMs > 0.0 ? singleMs / frameMs : 1.0);
+
+            if (threads == workers)
+                break;
+        }
+    }
+} // namespace Lina::Graphics
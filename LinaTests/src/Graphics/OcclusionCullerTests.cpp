@@ -0,0 +1,271 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Math/Math.hpp"
+#include "Rendering/OcclusionCuller.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+
+// Builds occluder geometry out of closed, open & concave meshes & checks it never covers more than the mesh. A row of
+// sphere occluders then hides random boxes, every box hidden by the built occluders has to be hidden by the full
+// meshes as well.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        struct OccluderTestMesh
+        {
+            std::vector<Vector3> m_vertices;
+            std::vector<uint32>  m_indices;
+        };
+
+        struct OccluderTestRun
+        {
+            OcclusionCullerStats m_stats;
+            std::vector<bool>    m_visible;
+            double               m_rasterizeMs = 0.0;
+            double               m_testMs      = 0.0;
+        };
+
+        // Rows & columns of vertices with a duplicated seam column like a textured mesh, seam & pole vertices share their
+        // exact positions, so the surface is closed.
+        OccluderTestMesh CreateOccluderTestSphere(float radius, uint32 rings, uint32 segments)
+        {
+            OccluderTestMesh mesh;
+
+            for (uint32 ring = 0; ring <= rings; ring++)
+            {
+                const float theta    = MATH_PI * (float)ring / (float)rings;
+                const float sinTheta = ring == 0 || ring == rings ? 0.0f : std::sin(theta);
+
+                for (uint32 segment = 0; segment <= segments; segment++)
+                {
+                    const float phi = MATH_TWO_PI * (float)(segment % segments) / (float)segments;
+                    mesh.m_vertices.push_back(Vector3(sinTheta * std::cos(phi), std::cos(theta), sinTheta * std::sin(phi)) * radius);
+                }
+            }
+
+            for (uint32 ring = 0; ring < rings; ring++)
+            {
+                for (uint32 segment = 0; segment < segments; segment++)
+                {
+                    const uint32 a = ring * (segments + 1) + segment;
+                    const uint32 b = a + segments + 1;
+
+                    if (ring != 0)
+                        mesh.m_indices.insert(mesh.m_indices.end(), {a, b, a + 1});
+
+                    if (ring != rings - 1)
+                        mesh.m_indices.insert(mesh.m_indices.end(), {a + 1, b, b + 1});
+                }
+            }
+
+            return mesh;
+        }
+
+        // Closed, but the center of its bounds is in the hole.
+        OccluderTestMesh CreateOccluderTestTorus(float radius, float tubeRadius, uint32 rings, uint32 sides)
+        {
+            OccluderTestMesh mesh;
+
+            for (uint32 ring = 0; ring < rings; ring++)
+            {
+                const float phi = MATH_TWO_PI * (float)ring / (float)rings;
+
+                for (uint32 side = 0; side < sides; side++)
+                {
+                    const float theta = MATH_TWO_PI * (float)side / (float)sides;
+                    const float r     = radius + tubeRadius * std::cos(theta);
+                    mesh.m_vertices.push_back(Vector3(r * std::cos(phi), tubeRadius * std::sin(theta), r * std::sin(phi)));
+                }
+            }
+
+            for (uint32 ring = 0; ring < rings; ring++)
+            {
+                for (uint32 side = 0; side < sides; side++)
+                {
+                    const uint32 a = ring * sides + side;
+                    const uint32 b = ((ring + 1) % rings) * sides + side;
+                    const uint32 c = ((ring + 1) % rings) * sides + (side + 1) % sides;
+                    const uint32 d = ring * sides + (side + 1) % sides;
+                    mesh.m_indices.insert(mesh.m_indices.end(), {a, b, c, a, c, d});
+                }
+            }
+
+            return mesh;
+        }
+
+        // Open grid, a wall.
+        OccluderTestMesh CreateOccluderTestPlane(float size, uint32 cells)
+        {
+            OccluderTestMesh mesh;
+
+            for (uint32 y = 0; y <= cells; y++)
+            {
+                for (uint32 x = 0; x <= cells; x++)
+                    mesh.m_vertices.push_back(Vector3(((float)x / (float)cells - 0.5f) * size, ((float)y / (float)cells - 0.5f) * size, 0.0f));
+            }
+
+            for (uint32 y = 0; y < cells; y++)
+            {
+                for (uint32 x = 0; x < cells; x++)
+                {
+                    const uint32 a = y * (cells + 1) + x;
+                    const uint32 b = a + cells + 1;
+                    mesh.m_indices.insert(mesh.m_indices.end(), {a, b, b + 1, a, b + 1, a + 1});
+                }
+            }
+
+            return mesh;
+        }
+
+        bool IsInsideConvexOccluderTestMesh(const OccluderTestMesh& mesh, const Vector3& point)
+        {
+            for (size_t i = 0; i + 2 < mesh.m_indices.size(); i += 3)
+            {
+                const Vector3& a      = mesh.m_vertices[mesh.m_indices[i]];
+                const Vector3  normal = (mesh.m_vertices[mesh.m_indices[i + 1]] - a).Cross(mesh.m_vertices[mesh.m_indices[i + 2]] - a);
+
+                // Facets of a mesh around the origin face away from it.
+                const float side = normal.Dot(point - a);
+
+                if (normal.Dot(a) > 0.0f ? side > 0.0f : side < 0.0f)
+                    return false;
+            }
+
+            return true;
+        }
+
+        OccluderTestMesh BuildOccluderTestMesh(const OccluderTestMesh& source, uint32 maxTriangles)
+        {
+            OccluderTestMesh occluder;
+            OcclusionCuller::BuildOccluder(source.m_vertices, source.m_indices, maxTriangles, occluder.m_vertices, occluder.m_indices);
+            return occluder;
+        }
+
+        // Occluder spheres in a row in front of the camera, boxes scattered behind & around them.
+        OccluderTestRun CullOccluderTestScene(OcclusionCuller& culler, const OccluderTestMesh& occluder, const std::vector<Vector3>& occluderLocations, const std::vector<Vector3>& boxes, const Vector3& halfExtent)
+        {
+            const Matrix view       = Matrix::InitLookAt(Vector3::Zero, Vector3(0.0f, 0.0f, 1.0f), Vector3(0.0f, 1.0f, 0.0f));
+            const Matrix projection = Matrix::Perspective(30.0f, 2.0f, 0.1f, 500.0f);
+
+            OccluderTestRun run;
+            culler.BeginFrame(projection * view);
+
+            const Test::Stopwatch rasterize;
+
+            for (const Vector3& location : occluderLocations)
+                culler.AddOccluder(Matrix::Translate(location), occluder.m_vertices, occluder.m_indices);
+
+            culler.RasterizeOccluders();
+            run.m_rasterizeMs = rasterize.GetElapsedMs();
+
+            const Test::Stopwatch test;
+
+            for (const Vector3& box : boxes)
+                run.m_visible.push_back(culler.TestAABB(box, halfExtent));
+
+            run.m_testMs = test.GetElapsedMs();
+            run.m_stats  = culler.GetStats();
+            return run;
+        }
+
+        void CheckOcclusionCuller(uint32 sphereRings, uint32 occluderCount, uint32 boxCount, bool printTimings)
+        {
+            const float      radius = 4.0f;
+            OccluderTestMesh sphere = CreateOccluderTestSphere(radius, sphereRings, sphereRings * 2);
+            OccluderTestMesh torus  = CreateOccluderTestTorus(4.0f, 1.0f, 32, 16);
+            OccluderTestMesh plane  = CreateOccluderTestPlane(8.0f, 32);
+
+            // Small meshes, open meshes & closed ones without a box inside of their bounds' center keep their triangles.
+            const OccluderTestMesh smallSphere = BuildOccluderTestMesh(sphere, (uint32)sphere.m_indices.size());
+            LINA_CHECK(smallSphere.m_indices == sphere.m_indices);
+
+            const OccluderTestMesh planeOccluder = BuildOccluderTestMesh(plane, 16);
+            LINA_CHECK(planeOccluder.m_indices == plane.m_indices);
+
+            const OccluderTestMesh torusOccluder = BuildOccluderTestMesh(torus, 16);
+            LINA_CHECK(torusOccluder.m_indices == torus.m_indices);
+
+            // A large closed mesh becomes a box inside of it, filling a fair share of its bounds.
+            const Test::Stopwatch  buildStopwatch;
+            const OccluderTestMesh sphereOccluder = BuildOccluderTestMesh(sphere, 16);
+            const double           buildMs        = buildStopwatch.GetElapsedMs();
+            LINA_REQUIRE(sphereOccluder.m_indices.size() == 36 && sphereOccluder.m_vertices.size() == 8);
+
+            // The sphere mesh is convex, every corner of the box has to be behind every facet.
+            for (const Vector3& corner : sphereOccluder.m_vertices)
+                LINA_CHECK(IsInsideConvexOccluderTestMesh(sphere, corner));
+
+            const Vector3 boxSize = sphereOccluder.m_vertices[7] - sphereOccluder.m_vertices[0];
+            LINA_CHECK(boxSize.x * boxSize.y * boxSize.z > radius * radius * radius * 8.0f * 0.1f);
+
+            // Row of spheres at 20 units, boxes between 25 & 80 units.
+            Test::Random         random(2022);
+            std::vector<Vector3> occluderLocations;
+            std::vector<Vector3> boxes;
+            const Vector3        halfExtent = Vector3(0.4f, 0.4f, 0.4f);
+
+            for (uint32 i = 0; i < occluderCount; i++)
+                occluderLocations.push_back(Vector3(((float)(i % 8) - 3.5f) * 7.0f, ((float)(i / 8) - (float)(occluderCount / 16)) * 7.0f, 20.0f));
+
+            for (uint32 i = 0; i < boxCount; i++)
+                boxes.push_back(Vector3(random.Range(-30.0f, 30.0f), random.Range(-15.0f, 15.0f), random.Range(25.0f, 80.0f)));
+
+            OcclusionCuller       culler;
+            const OccluderTestRun full  = CullOccluderTestScene(culler, sphere, occluderLocations, boxes, halfExtent);
+            const OccluderTestRun built = CullOccluderTestScene(culler, sphereOccluder, occluderLocations, boxes, halfExtent);
+
+            // The box covers less of the screen than the sphere, so it can only hide fewer boxes.
+            for (uint32 i = 0; i < boxCount; i++)
+                LINA_CHECK(built.m_visible[i] || !full.m_visible[i]);
+
+            LINA_CHECK(built.m_stats.m_occludedObjects > 0);
+            LINA_CHECK(built.m_stats.m_occludedObjects <= full.m_stats.m_occludedObjects);
+            LINA_CHECK(built.m_stats.m_testedObjects == boxCount);
+
+            if (!printTimings)
+                return;
+
+            Test::Print("{0} boxes behind {1} spheres of {2} triangles, inner box built in {3} ms.", boxCount, occluderCount, sphere.m_indices.size() / 3, buildMs);
+            Test::Print("Full meshes, {0} occluder triangles, {1} occluded, rasterized in {2} ms, tested in {3} ms.", full.m_stats.m_occluderTriangles, full.m_stats.m_occludedObjects, full.m_rasterizeMs, full.m_testMs);
+            Test::Print("Inner boxes, {0} occluder triangles, {1} occluded, rasterized in {2} ms, tested in {3} ms.", built.m_stats.m_occluderTriangles, built.m_stats.m_occludedObjects, built.m_rasterizeMs, built.m_testMs);
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, OccludersStayInsideTheirMeshes)
+    {
+        CheckOcclusionCuller(16, 16, 2000, false);
+    }
+
+    LINA_BENCHMARK(Graphics, OcclusionCuller)
+    {
+        CheckOcclusionCuller(64, 64, 100000, true);
+    }
+} // namespace Lina::Graphics
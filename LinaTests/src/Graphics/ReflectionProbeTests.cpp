@@ -0,0 +1,219 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/ReflectionProbeLookup.hpp"
+#include "Rendering/ReflectionProbeScheduler.hpp"
+#include "TestFramework.hpp"
+
+#include <limits>
+
+// Schedules captures for dynamic reflection areas over a number of frames & resolves random locations against random
+// local areas, the lookup is compared to testing every area. Neither touches the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        std::vector<ReflectionProbeState> CreateProbeStates(uint32 count, uint32 staticEvery, uint32 seed)
+        {
+            Test::Random                      random(seed);
+            std::vector<ReflectionProbeState> probes(count);
+
+            for (uint32 i = 0; i < count; i++)
+            {
+                ReflectionProbeState& probe = probes[i];
+                probe.m_location            = Vector3(random.Range(-100.0f, 100.0f), random.Range(-10.0f, 10.0f), random.Range(-100.0f, 100.0f));
+                probe.m_halfExtents         = Vector3(random.Range(1.0f, 20.0f), random.Range(1.0f, 8.0f), random.Range(1.0f, 20.0f));
+                probe.m_isLocal             = true;
+                probe.m_isDynamic           = staticEvery == 0 || i % staticEvery != 0;
+            }
+
+            return probes;
+        }
+
+        // Smallest local area strictly containing the location, the first global one otherwise.
+        int ResolveBruteForce(const std::vector<ReflectionProbeState>& probes, const Vector3& location)
+        {
+            int   result     = -1;
+            int   global     = -1;
+            float bestVolume = std::numeric_limits<float>::max();
+
+            for (int i = 0; i < (int)probes.size(); i++)
+            {
+                const ReflectionProbeState& probe = probes[i];
+
+                if (!probe.m_isLocal)
+                {
+                    global = global == -1 ? i : global;
+                    continue;
+                }
+
+                const Vector3 min    = probe.m_location - probe.m_halfExtents;
+                const Vector3 max    = probe.m_location + probe.m_halfExtents;
+                const float   volume = probe.m_halfExtents.x * probe.m_halfExtents.y * probe.m_halfExtents.z;
+
+                if (location.x > min.x && location.x < max.x && location.y > min.y && location.y < max.y && location.z > min.z && location.z < max.z && volume < bestVolume)
+                {
+                    bestVolume = volume;
+                    result     = i;
+                }
+            }
+
+            return result == -1 ? global : result;
+        }
+
+        void CheckProbeLookup(uint32 probeCount, uint32 locations, uint32 cellsPerAxis, bool printTimings)
+        {
+            std::vector<ReflectionProbeState> probes = CreateProbeStates(probeCount, 0, 7);
+
+            // A global area in the middle of the list is the fallback.
+            probes[probeCount / 2].m_isLocal = false;
+
+            ReflectionProbeLookup lookup;
+            lookup.SetCellsPerAxis(cellsPerAxis);
+            lookup.Build(probes);
+
+            Test::Random         random(11);
+            std::vector<Vector3> points(locations);
+
+            for (Vector3& point : points)
+                point = Vector3(random.Range(-130.0f, 130.0f), random.Range(-25.0f, 25.0f), random.Range(-130.0f, 130.0f));
+
+            std::vector<int>      resolved(locations);
+            const Test::Stopwatch lookupStopwatch;
+
+            for (uint32 i = 0; i < locations; i++)
+                resolved[i] = lookup.Resolve(points[i]);
+
+            const double          lookupMs = lookupStopwatch.GetElapsedMs();
+            const Test::Stopwatch bruteStopwatch;
+            uint32                locals = 0;
+
+            for (uint32 i = 0; i < locations; i++)
+            {
+                const int expected = ResolveBruteForce(probes, points[i]);
+                LINA_REQUIRE(resolved[i] == expected);
+                locals += expected != (int)probeCount / 2 ? 1 : 0;
+            }
+
+            const double bruteMs = bruteStopwatch.GetElapsedMs();
+
+            // Both the local areas & the fallback were hit.
+            LINA_CHECK(locals > 0 && locals < locations);
+
+            if (printTimings)
+                Test::Print("{0} areas, {1} locations, {2} inside a local area. Lookup {3} ms, testing every area {4} ms.", probeCount, locations, locals, lookupMs, bruteMs);
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, ReflectionSchedulerRespectsTheFaceBudget)
+    {
+        const uint32                       probeCount = 12;
+        const uint32                       budget     = 4;
+        std::vector<ReflectionProbeState>  probes     = CreateProbeStates(probeCount, 4, 3);
+        std::vector<ReflectionFaceCapture> captures;
+        std::vector<uint32>                faces(probeCount, 0);
+
+        ReflectionProbeScheduler scheduler;
+        scheduler.SetFaceBudget(budget);
+
+        // Every dynamic area is captured before any of them is captured again, faces follow each other. The budget left
+        // in the last frame of the first pass goes to a captured area.
+        const uint32 dynamicProbes = probeCount - probeCount / 4;
+        const uint32 firstPass     = (dynamicProbes * REFLECTION_PROBE_FACES + budget - 1) / budget;
+
+        for (uint32 frame = 0; frame < firstPass; frame++)
+        {
+            scheduler.Schedule(probes, Vector3::Zero, frame, captures);
+            LINA_REQUIRE(captures.size() <= budget);
+
+            for (const ReflectionFaceCapture& capture : captures)
+            {
+                LINA_REQUIRE(probes[capture.m_probeIndex].m_isDynamic);
+                LINA_REQUIRE(capture.m_face == faces[capture.m_probeIndex] % REFLECTION_PROBE_FACES);
+                faces[capture.m_probeIndex]++;
+            }
+        }
+
+        for (uint32 i = 0; i < probeCount; i++)
+        {
+            LINA_CHECK(probes[i].m_isCaptured == probes[i].m_isDynamic);
+            LINA_CHECK(probes[i].m_isDynamic ? faces[i] >= REFLECTION_PROBE_FACES : faces[i] == 0);
+        }
+
+        // Far areas get stale enough to be captured again.
+        for (uint32 frame = firstPass; frame < firstPass + 400; frame++)
+            scheduler.Schedule(probes, Vector3::Zero, frame, captures);
+
+        for (const ReflectionProbeState& probe : probes)
+            LINA_CHECK(!probe.m_isDynamic || probe.m_lastCaptureFrame >= firstPass);
+
+        // No budget, nothing is captured.
+        scheduler.SetFaceBudget(0);
+        scheduler.Schedule(probes, Vector3::Zero, firstPass + 400, captures);
+        LINA_CHECK(captures.empty());
+    }
+
+    LINA_TEST(Graphics, ReflectionSchedulerIsDeterministic)
+    {
+        std::vector<ReflectionProbeState>  a = CreateProbeStates(32, 0, 5);
+        std::vector<ReflectionProbeState>  b = a;
+        std::vector<ReflectionFaceCapture> capturesA, capturesB;
+        ReflectionProbeScheduler           schedulerA, schedulerB;
+
+        for (uint32 frame = 0; frame < 200; frame++)
+        {
+            const Vector3 camera = Vector3((float)(frame % 50) * 4.0f - 100.0f, 0.0f, 0.0f);
+            schedulerA.Schedule(a, camera, frame, capturesA);
+            schedulerB.Schedule(b, camera, frame, capturesB);
+            LINA_REQUIRE(capturesA.size() == capturesB.size());
+
+            for (size_t i = 0; i < capturesA.size(); i++)
+                LINA_REQUIRE(capturesA[i].m_probeIndex == capturesB[i].m_probeIndex && capturesA[i].m_face == capturesB[i].m_face);
+        }
+    }
+
+    LINA_TEST(Graphics, ReflectionLookupMatchesTestingEveryArea)
+    {
+        CheckProbeLookup(64, 20000, 8, false);
+
+        // Without local areas everything resolves to the global one, without any area to nothing.
+        std::vector<ReflectionProbeState> probes(2);
+        ReflectionProbeLookup             lookup;
+        lookup.Build(probes);
+        LINA_CHECK(lookup.Resolve(Vector3::Zero) == 0);
+
+        probes.clear();
+        lookup.Build(probes);
+        LINA_CHECK(lookup.Resolve(Vector3::Zero) == -1);
+    }
+
+    LINA_BENCHMARK(Graphics, ReflectionLookup)
+    {
+        CheckProbeLookup(1024, 1000000, 16, true);
+    }
+} // namespace Lina::Graphics
@@ -0,0 +1,277 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/RenderGraph.hpp"
+#include "TestFramework.hpp"
+
+#include <vector>
+
+// Compiles render graphs without a graphics context. A fixed deferred frame checks culling, lifetimes & the aliasing
+// plan by hand, random graphs are checked against a brute force pass over the compiled plan.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        RenderGraphTextureDesc GetGraphTestDesc(int width, int height, PixelFormat format)
+        {
+            RenderGraphTextureDesc desc;
+            desc.m_size                = Vector2i(width, height);
+            desc.m_internalPixelFormat = format;
+            return desc;
+        }
+
+        // Every transient used by an executed pass has a physical texture with its description. Transients sharing a
+        // physical texture never overlap, memory before & after aliasing adds up to the transients & physical textures.
+        bool IsGraphPlanValid(const RenderGraph& graph, uint32 textureCount, const std::vector<RenderGraphTextureDesc>& descs, const std::vector<bool>& imported)
+        {
+            const std::vector<RenderGraphTextureDesc>& physical = graph.GetPhysicalTextures();
+            uint64                                     before   = 0;
+            uint32                                     used     = 0;
+
+            for (uint32 a = 0; a < textureCount; a++)
+            {
+                const uint32 slot = graph.GetPhysicalTexture(a);
+
+                if (imported[a] || graph.GetFirstUse(a) == RENDERGRAPH_INVALID)
+                {
+                    if (slot != RENDERGRAPH_INVALID)
+                        return false;
+                    continue;
+                }
+
+                if (slot >= (uint32)physical.size() || !(physical[slot] == descs[a]) || graph.GetFirstUse(a) > graph.GetLastUse(a))
+                    return false;
+
+                before += RenderGraph::GetTextureMemory(descs[a]);
+                used++;
+
+                for (uint32 b = a + 1; b < textureCount; b++)
+                {
+                    if (graph.GetPhysicalTexture(b) != slot)
+                        continue;
+
+                    if (graph.GetFirstUse(a) <= graph.GetLastUse(b) && graph.GetFirstUse(b) <= graph.GetLastUse(a))
+                        return false;
+                }
+            }
+
+            uint64 after = 0;
+            for (const RenderGraphTextureDesc& desc : physical)
+                after += RenderGraph::GetTextureMemory(desc);
+
+            const RenderGraphStats& stats = graph.GetStats();
+            return stats.m_memoryBeforeAliasing == before && stats.m_memoryAfterAliasing == after && stats.m_transientTextures == used && stats.m_physicalTextures == (uint32)physical.size() && after <= before;
+        }
+
+        void CheckRandomRenderGraphs(uint32 graphs, uint32 passCount, uint32 textureCount, bool printTimings)
+        {
+            Test::Random random(passCount);
+            RenderGraph  graph;
+            double       compileMs    = 0.0;
+            uint64       memoryBefore = 0;
+            uint64       memoryAfter  = 0;
+            uint32       culled       = 0;
+
+            const PixelFormat formats[3] = {PixelFormat::FORMAT_RGBA16F, PixelFormat::FORMAT_RGBA, PixelFormat::FORMAT_DEPTH};
+
+            for (uint32 g = 0; g < graphs; g++)
+            {
+                std::vector<RenderGraphTextureDesc> descs;
+                std::vector<bool>                   imported;
+                std::vector<uint32>                 executed;
+                graph.Reset();
+
+                for (uint32 i = 0; i < textureCount; i++)
+                {
+                    descs.push_back(GetGraphTestDesc(1920 >> (random.Next() % 2), 1080 >> (random.Next() % 2), formats[random.Next() % 3]));
+                    descs.back().m_filter = random.Next() % 4 == 0 ? SamplerFilter::FILTER_LINEAR : SamplerFilter::FILTER_NEAREST;
+                    imported.push_back(random.Next() % 8 == 0);
+
+                    if (imported.back())
+                        graph.ImportTexture("Imported", descs.back());
+                    else
+                        graph.CreateTexture("Transient", descs.back());
+                }
+
+                // Passes read textures written by earlier passes, so the graph stays acyclic.
+                std::vector<uint32> written;
+                for (uint32 p = 0; p < passCount; p++)
+                {
+                    const uint32 pass = graph.AddPass("Pass", [&executed, p]() { executed.push_back(p); });
+
+                    for (uint32 r = 0; r < 2 && !written.empty(); r++)
+                        graph.Read(pass, written[random.Next() % written.size()]);
+
+                    const uint32 writes = 1 + random.Next() % 2;
+                    for (uint32 w = 0; w < writes; w++)
+                    {
+                        const uint32 texture = random.Next() % textureCount;
+                        graph.Write(pass, texture);
+                        written.push_back(texture);
+                    }
+
+                    if (random.Next() % 32 == 0)
+                        graph.SetSideEffects(pass);
+                }
+
+                const Test::Stopwatch stopwatch;
+                graph.Compile();
+                compileMs += stopwatch.GetElapsedMs();
+
+                LINA_REQUIRE(IsGraphPlanValid(graph, textureCount, descs, imported));
+
+                // Executed passes run in order & are exactly the ones that survived culling.
+                graph.Execute();
+                uint32 next = 0;
+                for (uint32 p = 0; p < passCount; p++)
+                {
+                    if (graph.IsPassCulled(p))
+                        continue;
+
+                    LINA_REQUIRE(next < (uint32)executed.size() && executed[next] == p);
+                    next++;
+                }
+                LINA_CHECK(next == (uint32)executed.size());
+
+                memoryBefore += graph.GetStats().m_memoryBeforeAliasing;
+                memoryAfter += graph.GetStats().m_memoryAfterAliasing;
+                culled += graph.GetStats().m_culledPasses;
+            }
+
+            if (printTimings)
+                Test::Print("{0} graphs of {1} passes & {2} textures, {3} us per compile, {4} culled passes, {5} MB -> {6} MB transient memory on average.", graphs, passCount, textureCount, compileMs * 1000.0 / graphs, culled / graphs,
+                            memoryBefore / graphs / (1024 * 1024), memoryAfter / graphs / (1024 * 1024));
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, RenderGraphCullsDeferredFrame)
+    {
+        const RenderGraphTextureDesc screen = GetGraphTestDesc(1920, 1080, PixelFormat::FORMAT_RGBA16F);
+        const RenderGraphTextureDesc depth  = GetGraphTestDesc(1920, 1080, PixelFormat::FORMAT_DEPTH);
+        RenderGraph                  graph;
+        std::vector<uint32>          executed;
+
+        const uint32 output      = graph.ImportTexture("Output", screen);
+        const uint32 position    = graph.CreateTexture("GBuffer Position", screen);
+        const uint32 normal      = graph.CreateTexture("GBuffer Normal", screen);
+        const uint32 emission    = graph.CreateTexture("GBuffer Emission", screen);
+        const uint32 sceneColor  = graph.CreateTexture("Scene Color", screen);
+        const uint32 bloomPing   = graph.CreateTexture("Bloom Ping", screen);
+        const uint32 bloomPong   = graph.CreateTexture("Bloom Pong", screen);
+        const uint32 debugDepth  = graph.CreateTexture("Debug Depth", depth);
+        const uint32 debugResult = graph.CreateTexture("Debug Result", screen);
+
+        const uint32 gBufferPass = graph.AddPass("GBuffer", [&executed]() { executed.push_back(0); });
+        graph.Write(gBufferPass, position);
+        graph.Write(gBufferPass, normal);
+        graph.Write(gBufferPass, emission);
+
+        const uint32 lightingPass = graph.AddPass("Lighting", [&executed]() { executed.push_back(1); });
+        graph.Read(lightingPass, position);
+        graph.Read(lightingPass, normal);
+        graph.Write(lightingPass, sceneColor);
+
+        const uint32 bloomPass = graph.AddPass("Bloom", [&executed]() { executed.push_back(2); });
+        graph.Read(bloomPass, emission);
+        graph.Write(bloomPass, bloomPing);
+        graph.Write(bloomPass, bloomPong);
+
+        // Nothing reads the debug chain, both of its passes are culled.
+        const uint32 debugDepthPass = graph.AddPass("Debug Depth", [&executed]() { executed.push_back(3); });
+        graph.Write(debugDepthPass, debugDepth);
+        const uint32 debugPass = graph.AddPass("Debug", [&executed]() { executed.push_back(4); });
+        graph.Read(debugPass, debugDepth);
+        graph.Write(debugPass, debugResult);
+
+        const uint32 compositePass = graph.AddPass("Composite", [&executed]() { executed.push_back(5); });
+        graph.Read(compositePass, sceneColor);
+        graph.Read(compositePass, bloomPong);
+        graph.Write(compositePass, output);
+
+        // Writes nothing in the graph, kept for its side effects.
+        const uint32 capturePass = graph.AddPass("Capture", [&executed]() { executed.push_back(6); });
+        graph.SetSideEffects(capturePass);
+
+        graph.Execute();
+        LINA_CHECK(graph.IsCompiled());
+        LINA_CHECK(graph.IsPassCulled(debugDepthPass) && graph.IsPassCulled(debugPass));
+        LINA_CHECK(!graph.IsPassCulled(gBufferPass) && !graph.IsPassCulled(lightingPass) && !graph.IsPassCulled(bloomPass) && !graph.IsPassCulled(compositePass) && !graph.IsPassCulled(capturePass));
+        LINA_CHECK(executed == std::vector<uint32>({0, 1, 2, 5, 6}));
+
+        // Lifetimes are in executed pass order: gbuffer 0, lighting 1, bloom 2, composite 3.
+        LINA_CHECK(graph.GetFirstUse(position) == 0 && graph.GetLastUse(position) == 1);
+        LINA_CHECK(graph.GetFirstUse(emission) == 0 && graph.GetLastUse(emission) == 2);
+        LINA_CHECK(graph.GetFirstUse(sceneColor) == 1 && graph.GetLastUse(sceneColor) == 3);
+        LINA_CHECK(graph.GetFirstUse(bloomPing) == 2 && graph.GetLastUse(bloomPing) == 2);
+        LINA_CHECK(graph.GetFirstUse(bloomPong) == 2 && graph.GetLastUse(bloomPong) == 3);
+        LINA_CHECK(graph.GetFirstUse(debugDepth) == RENDERGRAPH_INVALID && graph.GetFirstUse(debugResult) == RENDERGRAPH_INVALID);
+
+        // Bloom targets take over the position & normal textures once lighting is done with them.
+        LINA_CHECK(graph.GetPhysicalTexture(output) == RENDERGRAPH_INVALID && graph.GetPhysicalTexture(debugDepth) == RENDERGRAPH_INVALID);
+        LINA_CHECK(graph.GetPhysicalTexture(bloomPing) == graph.GetPhysicalTexture(position));
+        LINA_CHECK(graph.GetPhysicalTexture(bloomPong) == graph.GetPhysicalTexture(normal));
+        LINA_CHECK(graph.GetPhysicalTexture(emission) != graph.GetPhysicalTexture(bloomPing) && graph.GetPhysicalTexture(sceneColor) != graph.GetPhysicalTexture(bloomPong));
+
+        const uint64            screenMemory = RenderGraph::GetTextureMemory(screen);
+        const RenderGraphStats& stats        = graph.GetStats();
+        LINA_CHECK(screenMemory == 1920ull * 1080ull * 8ull);
+        LINA_CHECK(stats.m_passes == 7 && stats.m_culledPasses == 2);
+        LINA_CHECK(stats.m_transientTextures == 6 && stats.m_physicalTextures == 4);
+        LINA_CHECK(stats.m_memoryBeforeAliasing == screenMemory * 6 && stats.m_memoryAfterAliasing == screenMemory * 4);
+
+        // Without a reader for the bloom, the pass & both of its targets drop out of the plan.
+        graph.Reset();
+        const uint32 plainOutput  = graph.ImportTexture("Output", screen);
+        const uint32 plainColor   = graph.CreateTexture("Scene Color", screen);
+        const uint32 plainBloom   = graph.CreateTexture("Bloom", screen);
+        const uint32 plainLight   = graph.AddPass("Lighting", nullptr);
+        const uint32 plainBlur    = graph.AddPass("Bloom", nullptr);
+        const uint32 plainCompose = graph.AddPass("Composite", nullptr);
+        graph.Write(plainLight, plainColor);
+        graph.Read(plainBlur, plainColor);
+        graph.Write(plainBlur, plainBloom);
+        graph.Read(plainCompose, plainColor);
+        graph.Write(plainCompose, plainOutput);
+        graph.Compile();
+
+        LINA_CHECK(graph.IsPassCulled(plainBlur) && !graph.IsPassCulled(plainLight) && !graph.IsPassCulled(plainCompose));
+        LINA_CHECK(graph.GetPhysicalTexture(plainBloom) == RENDERGRAPH_INVALID);
+        LINA_CHECK(graph.GetLastUse(plainColor) == 1);
+        LINA_CHECK(graph.GetStats().m_memoryBeforeAliasing == screenMemory && graph.GetStats().m_memoryAfterAliasing == screenMemory);
+    }
+
+    LINA_TEST(Graphics, RenderGraphAliasesDisjointLifetimes)
+    {
+        CheckRandomRenderGraphs(200, 24, 12, false);
+    }
+
+    LINA_BENCHMARK(Graphics, RenderGraph)
+    {
+        CheckRandomRenderGraphs(100, 400, 120, true);
+    }
+} // namespace Lina::Graphics
@@ -0,0 +1,282 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
+#include "Rendering/DrawListExtractor.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Mesh.hpp"
+#include "Rendering/Model.hpp"
+#include "Rendering/ModelNode.hpp"
+#include "Rendering/RenderProxyTable.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <set>
+
+// Builds render proxies for a registry of model node entities, the same way the model node system syncs them each
+// frame, then moves, re-materials & removes entities. Batches only hold matrices, so it runs without the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        // The model owns its node & the node its meshes.
+        struct ProxyTestScene
+        {
+            Model                 m_model = Model(new ModelNode({new Mesh(), new Mesh()}));
+            Material              m_opaque[2];
+            Material              m_transparent;
+            entt::registry        m_reg;
+            std::set<ECS::Entity> m_staticBatched;
+            RenderProxyCallbacks  m_callbacks;
+        };
+
+        void SetMaterials(ECS::ModelNodeComponent& nodeComponent, Material* first, Material* second)
+        {
+            nodeComponent.m_materials.resize(2);
+            nodeComponent.m_materials[0].m_value = first;
+            nodeComponent.m_materials[1].m_value = second;
+        }
+
+        // Every third entity draws its second mesh transparent.
+        void CreateProxyTestScene(ProxyTestScene& scene, RenderProxyTable& table, uint32 entities)
+        {
+            scene.m_transparent.SetSurfaceType(MaterialSurfaceType::Transparent);
+            scene.m_callbacks.m_isStaticBatched  = [&scene](ECS::Entity entity) { return scene.m_staticBatched.count(entity) != 0; };
+            scene.m_callbacks.m_getPaletteBuffer = [](ECS::Entity entity) { return 0u; };
+
+            const uint32 gridSize = (uint32)std::ceil(std::cbrt((float)entities));
+
+            for (uint32 i = 0; i < entities; i++)
+            {
+                const ECS::Entity entity = scene.m_reg.create();
+                auto&             data   = scene.m_reg.emplace<ECS::EntityDataComponent>(entity);
+                data.SetLocation(Vector3((float)(i % gridSize), (float)((i / gridSize) % gridSize), (float)(i / (gridSize * gridSize))) * 4.0f);
+
+                auto& nodeComponent           = scene.m_reg.emplace<ECS::ModelNodeComponent>(entity);
+                nodeComponent.m_model.m_value = &scene.m_model;
+                nodeComponent.m_nodeIndex     = 0;
+                SetMaterials(nodeComponent, &scene.m_opaque[i % 2], i % 3 == 0 ? &scene.m_transparent : &scene.m_opaque[(i + 1) % 2]);
+
+                // Done by the component's construct signal in the engine.
+                table.MarkForRebuild(entity);
+            }
+        }
+
+        // Every rendered proxy mesh owns exactly the slot it points to & the slot holds the entity's matrix, nothing
+        // else is in the batches.
+        void CheckProxyOwners(ProxyTestScene& scene, RenderProxyTable& table)
+        {
+            uint32 rendered = 0;
+
+            for (const auto& [entity, proxy] : table.GetProxies())
+            {
+                const Vector3 location = scene.m_reg.get<ECS::EntityDataComponent>(entity).GetLocation();
+
+                for (uint32 i = 0; i < (uint32)proxy.m_meshes.size(); i++)
+                {
+                    const RenderProxyMesh& mesh = proxy.m_meshes[i];
+
+                    if (!mesh.m_isRendered)
+                        continue;
+
+                    RenderInstanceOwner owner;
+                    Matrix              model;
+
+                    if (mesh.m_isTransparent)
+                    {
+                        LINA_REQUIRE(mesh.m_instance < table.GetTransparentInstances().size());
+                        owner = table.GetTransparentInstances()[mesh.m_instance].m_owner;
+                        model = table.GetTransparentInstances()[mesh.m_instance].m_model;
+                    }
+                    else
+                    {
+                        LINA_REQUIRE(mesh.m_batch < table.GetOpaqueBatches().size() && mesh.m_instance < table.GetOpaqueBatches()[mesh.m_batch].m_models.size());
+                        owner = table.GetOpaqueBatches()[mesh.m_batch].m_owners[mesh.m_instance];
+                        model = table.GetOpaqueBatches()[mesh.m_batch].m_models[mesh.m_instance];
+                        LINA_CHECK(table.GetOpaqueBatches()[mesh.m_batch].m_drawData.m_material == mesh.m_material);
+                    }
+
+                    LINA_CHECK(owner.m_entity == entity && owner.m_mesh == i);
+                    LINA_CHECK(model.GetTranslation() == location);
+                    rendered++;
+                }
+            }
+
+            uint32 instances = (uint32)table.GetTransparentInstances().size();
+            for (const RenderBatch& batch : table.GetOpaqueBatches())
+                instances += (uint32)batch.m_models.size();
+
+            LINA_CHECK(instances == rendered);
+        }
+
+        void ClearBatchDirtyFlags(RenderProxyTable& table)
+        {
+            for (RenderBatch& batch : table.GetOpaqueBatches())
+                batch.m_isDirty = false;
+
+            table.ClearTransparentDirty();
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, RenderProxiesOnlyUpdateChangedEntities)
+    {
+        const uint32      entities = 300;
+        ProxyTestScene    scene;
+        RenderProxyTable  table;
+        DrawListExtractor extractor;
+        extractor.SetSliceSize(32);
+        CreateProxyTestScene(scene, table, entities);
+
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == entities);
+        LINA_CHECK(table.GetProxies().size() == entities);
+        // 2 opaque materials in both mesh slots, every third entity's second mesh is transparent.
+        LINA_CHECK(table.GetOpaqueBatches().size() == 4);
+        LINA_CHECK(table.GetTransparentInstances().size() == entities / 3);
+        CheckProxyOwners(scene, table);
+
+        // Nothing changed, nothing is touched.
+        ClearBatchDirtyFlags(table);
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == 0);
+        LINA_CHECK(table.GetUpdatedProxyCount() == 0);
+        LINA_CHECK(!table.IsTransparentDirty());
+
+        for (const RenderBatch& batch : table.GetOpaqueBatches())
+            LINA_CHECK(!batch.m_isDirty);
+
+        // A moved entity only rewrites its own slots.
+        const ECS::Entity moved = scene.m_reg.storage<ECS::ModelNodeComponent>().data()[3];
+        auto&             data  = scene.m_reg.get<ECS::EntityDataComponent>(moved);
+        data.SetLocation(data.GetLocation() + Vector3(0.0f, 10.0f, 0.0f));
+
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == 1);
+        LINA_CHECK(table.IsTransparentDirty());
+        CheckProxyOwners(scene, table);
+
+        uint32 dirtyBatches = 0;
+        for (const RenderBatch& batch : table.GetOpaqueBatches())
+            dirtyBatches += batch.m_isDirty ? 1 : 0;
+
+        LINA_CHECK(dirtyBatches == 1);
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == 0);
+    }
+
+    LINA_TEST(Graphics, RenderProxyRemovalFixesUpMovedOwners)
+    {
+        const uint32      entities = 300;
+        ProxyTestScene    scene;
+        RenderProxyTable  table;
+        DrawListExtractor extractor;
+        CreateProxyTestScene(scene, table, entities);
+        table.Sync(scene.m_reg, extractor, scene.m_callbacks);
+
+        // The first entity's instances are at the front of their batches, so removing it swaps the last ones in.
+        const ECS::Entity removed = scene.m_reg.storage<ECS::ModelNodeComponent>().data()[0];
+        LINA_REQUIRE(table.GetProxies().at(removed).m_meshes[0].m_instance == 0);
+
+        table.Remove(removed);
+        scene.m_reg.destroy(removed);
+        LINA_CHECK(table.GetProxies().size() == entities - 1);
+        CheckProxyOwners(scene, table);
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == 0);
+
+        // Turning an opaque mesh transparent rebuilds the proxy, its old batch slot is reused by another entity.
+        const ECS::Entity rematerialed = scene.m_reg.storage<ECS::ModelNodeComponent>().data()[1];
+        const size_t      transparents = table.GetTransparentInstances().size();
+        auto&             component    = scene.m_reg.get<ECS::ModelNodeComponent>(rematerialed);
+        SetMaterials(component, component.m_materials[0].m_value, &scene.m_transparent);
+
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == 1);
+        LINA_CHECK(table.GetTransparentInstances().size() == transparents + 1);
+        CheckProxyOwners(scene, table);
+
+        // Entities in a static batch keep their proxy but don't draw through it.
+        const ECS::Entity batched = scene.m_reg.storage<ECS::ModelNodeComponent>().data()[2];
+        scene.m_staticBatched.insert(batched);
+        table.Invalidate(batched);
+
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == 1);
+        LINA_CHECK(table.GetProxies().at(batched).m_isStaticBatched);
+
+        for (const RenderProxyMesh& mesh : table.GetProxies().at(batched).m_meshes)
+            LINA_CHECK(!mesh.m_isRendered);
+
+        CheckProxyOwners(scene, table);
+
+        // Removing every other entity keeps the batches packed.
+        auto&                    nodes = scene.m_reg.storage<ECS::ModelNodeComponent>();
+        std::vector<ECS::Entity> remaining(nodes.data(), nodes.data() + nodes.size());
+        for (uint32 i = 0; i < (uint32)remaining.size(); i += 2)
+        {
+            table.Remove(remaining[i]);
+            scene.m_reg.destroy(remaining[i]);
+        }
+
+        CheckProxyOwners(scene, table);
+        LINA_CHECK(table.Sync(scene.m_reg, extractor, scene.m_callbacks) == 0);
+    }
+
+    LINA_BENCHMARK(Graphics, RenderProxySync)
+    {
+        const uint32      entities = 100000;
+        const uint32      frames   = 30;
+        ProxyTestScene    scene;
+        RenderProxyTable  table;
+        DrawListExtractor extractor;
+        CreateProxyTestScene(scene, table, entities);
+
+        const Test::Stopwatch build;
+        table.Sync(scene.m_reg, extractor, scene.m_callbacks);
+        const double buildMs = build.GetElapsedMs();
+
+        const Test::Stopwatch idle;
+        for (uint32 frame = 0; frame < frames; frame++)
+            table.Sync(scene.m_reg, extractor, scene.m_callbacks);
+        const double idleMs = idle.GetElapsedMs() / frames;
+
+        // 1% of the entities move every frame.
+        auto&                 datas   = scene.m_reg.storage<ECS::EntityDataComponent>();
+        const ECS::Entity*    nodes   = scene.m_reg.storage<ECS::ModelNodeComponent>().data();
+        uint32                updated = 0;
+        const Test::Stopwatch moving;
+
+        for (uint32 frame = 0; frame < frames; frame++)
+        {
+            for (uint32 i = frame % 100; i < entities; i += 100)
+            {
+                auto& data = datas.get(nodes[i]);
+                data.SetLocation(data.GetLocation() + Vector3(0.0f, 0.1f, 0.0f));
+            }
+
+            updated += table.Sync(scene.m_reg, extractor, scene.m_callbacks);
+        }
+
+        const double movingMs = moving.GetElapsedMs() / frames;
+        Test::Print("{0} proxies built in {1} ms, static frame {2} ms, {3} moved per frame in {4} ms.", entities, buildMs, idleMs, updated / frames, movingMs);
+    }
+} // namespace Lina::Graphics
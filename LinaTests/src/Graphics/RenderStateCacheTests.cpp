@@ -0,0 +1,206 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "Rendering/RenderStateCache.hpp"
+#include "TestFramework.hpp"
+
+#include <vector>
+
+// Feeds the state cache the bind & draw parameter sequence the render device issues per draw & checks which calls it
+// lets through to GL. The cache doesn't call GL, so it runs without the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        struct TestDraw
+        {
+            uint32     m_shader  = 0;
+            uint32     m_texture = 0;
+            uint32     m_sampler = 0;
+            uint32     m_vao     = 0;
+            DrawParams m_params;
+        };
+
+        // Same order OpenGLRenderDevice::SetTexture, SetDrawParameters & Draw go through the cache, returns the calls that reached GL.
+        uint32 ApplyDraw(RenderStateCache& cache, const TestDraw& draw)
+        {
+            const DrawParams& params = draw.m_params;
+            uint32            calls  = 0;
+
+            calls += cache.SetShader(draw.m_shader) ? 1 : 0;
+            calls += cache.SetActiveTextureUnit(0) ? 1 : 0;
+            calls += cache.BindTexture(BINDTEXTURE_TEXTURE2D, draw.m_texture) ? 1 : 0;
+            calls += cache.BindSampler(0, draw.m_sampler) ? 1 : 0;
+
+            calls += cache.SetFaceCulling(params.faceCulling) ? 1 : 0;
+            calls += cache.SetBlending(params.sourceBlend, params.destBlend) ? 1 : 0;
+            calls += cache.SetScissorTestEnable(params.useScissorTest) ? 1 : 0;
+            if (params.useScissorTest)
+                calls += cache.SetScissorBox(params.scissorStartX, params.scissorStartY, params.scissorWidth, params.scissorHeight) ? 1 : 0;
+
+            calls += cache.SetDepthTestEnable(params.useDepthTest) ? 1 : 0;
+            if (params.useDepthTest)
+            {
+                calls += cache.SetDepthWrite(params.shouldWriteDepth) ? 1 : 0;
+                calls += cache.SetDepthFunc(params.depthFunc) ? 1 : 0;
+            }
+
+            calls += cache.SetStencilTestEnable(params.useStencilTest) ? 1 : 0;
+            calls += cache.SetStencilFunc(params.stencilFunc, params.stencilTestMask, params.stencilComparisonVal) ? 1 : 0;
+            calls += cache.SetStencilOp(params.stencilFail, params.stencilPassButDepthFail, params.stencilPass) ? 1 : 0;
+            calls += cache.SetStencilWriteMask(params.stencilWriteMask) ? 1 : 0;
+
+            calls += cache.SetVAO(draw.m_vao) ? 1 : 0;
+            cache.AddDrawCall();
+            return calls;
+        }
+
+        TestDraw MakeDraw(uint32 shader, uint32 texture, uint32 sampler, uint32 vao)
+        {
+            TestDraw draw;
+            draw.m_shader  = shader;
+            draw.m_texture = texture;
+            draw.m_sampler = sampler;
+            draw.m_vao     = vao;
+            return draw;
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, RenderStateCacheSkipsRepeatedDraws)
+    {
+        RenderStateCache cache;
+        cache.Reset(Vector2i(800, 600));
+
+        // Defaults differ from the initial GL state in depth func, stencil enable, stencil func & write mask, texture unit 0 is already active.
+        const TestDraw draw = MakeDraw(5, 7, 3, 2);
+        LINA_CHECK(ApplyDraw(cache, draw) == 8);
+
+        const RenderDeviceStats first = cache.GetStats();
+        LINA_CHECK(first.m_stateCalls == 8);
+        LINA_CHECK(first.m_skippedBinds == 1);
+        LINA_CHECK(first.m_skippedRenderStates == 6);
+
+        // Repeating the exact sequence never reaches GL, 5 binds & 10 render states are filtered per draw.
+        for (uint32 i = 0; i < 99; i++)
+            LINA_CHECK(ApplyDraw(cache, draw) == 0);
+
+        const RenderDeviceStats& stats = cache.GetStats();
+        LINA_CHECK(stats.m_drawCalls == 100);
+        LINA_CHECK(stats.m_stateCalls == first.m_stateCalls);
+        LINA_CHECK(stats.m_skippedBinds == first.m_skippedBinds + 99 * 5);
+        LINA_CHECK(stats.m_skippedRenderStates == first.m_skippedRenderStates + 99 * 10);
+
+        // The frame's counters move to the last frame stats.
+        cache.BeginFrame();
+        LINA_CHECK(cache.GetLastFrameStats().m_skippedBinds == first.m_skippedBinds + 99 * 5);
+        LINA_CHECK(cache.GetStats().m_drawCalls == 0 && cache.GetStats().m_stateCalls == 0);
+    }
+
+    LINA_TEST(Graphics, RenderStateCacheRebindsChangedState)
+    {
+        RenderStateCache cache;
+        cache.Reset(Vector2i(800, 600));
+
+        // Two textures sharing a material alternate on the same unit, only the texture bind reaches GL.
+        const TestDraw a = MakeDraw(5, 7, 3, 2);
+        const TestDraw b = MakeDraw(5, 8, 3, 2);
+        ApplyDraw(cache, a);
+        LINA_CHECK(ApplyDraw(cache, b) == 1);
+        LINA_CHECK(ApplyDraw(cache, a) == 1);
+
+        // Transparent params enable blending, switching back disables it again.
+        TestDraw transparent                = a;
+        transparent.m_params.sourceBlend    = BLEND_FUNC_SRC_ALPHA;
+        transparent.m_params.destBlend      = BLEND_FUNC_ONE_MINUS_SRC_ALPHA;
+        transparent.m_params.useScissorTest = true;
+        transparent.m_params.scissorWidth   = 100;
+        transparent.m_params.scissorHeight  = 50;
+        LINA_CHECK(ApplyDraw(cache, transparent) == 3);
+        LINA_CHECK(cache.IsBlendingEnabled());
+        LINA_CHECK(ApplyDraw(cache, transparent) == 0);
+        LINA_CHECK(ApplyDraw(cache, a) == 2);
+        LINA_CHECK(!cache.IsBlendingEnabled());
+
+        // Released names can be handed out again, the next bind has to reach GL.
+        cache.OnTextureReleased(7);
+        cache.OnSamplerReleased(3);
+        LINA_CHECK(ApplyDraw(cache, a) == 2);
+
+        cache.OnVAOReleased(2);
+        LINA_CHECK(cache.SetVAO(2));
+
+        // A blit splits read & draw targets, binding either again reaches GL.
+        LINA_CHECK(cache.SetFBO(4));
+        LINA_CHECK(!cache.SetFBO(4));
+        cache.SetBlitTargets(4, 9);
+        LINA_CHECK(cache.SetFBO(4));
+
+        // Deleting the bound framebuffer falls back to the default one.
+        cache.OnFBOReleased(4);
+        LINA_CHECK(!cache.SetFBO(0));
+
+        // Viewport & clear color are filtered the same way.
+        LINA_CHECK(!cache.SetViewport(Vector2i(0, 0), Vector2i(800, 600)));
+        LINA_CHECK(cache.SetViewport(Vector2i(0, 0), Vector2i(400, 300)));
+        LINA_CHECK(!cache.SetClearColor(Color::Black));
+        LINA_CHECK(cache.SetClearColor(Color::White));
+    }
+
+    LINA_BENCHMARK(Graphics, RenderStateCache)
+    {
+        const uint32          drawCount = 1000000;
+        Test::Random          random(drawCount);
+        std::vector<TestDraw> draws(64);
+
+        // A handful of materials, most draws share shader, sampler & params with their neighbours.
+        for (size_t i = 0; i < draws.size(); i++)
+        {
+            draws[i] = MakeDraw(1 + random.Next() % 4, 1 + random.Next() % 16, 1 + random.Next() % 2, 1 + random.Next() % 32);
+            if (i % 8 == 0)
+            {
+                draws[i].m_params.sourceBlend = BLEND_FUNC_SRC_ALPHA;
+                draws[i].m_params.destBlend   = BLEND_FUNC_ONE_MINUS_SRC_ALPHA;
+            }
+        }
+
+        RenderStateCache cache;
+        cache.Reset(Vector2i(1920, 1080));
+
+        const Test::Stopwatch stopwatch;
+        uint32                calls = 0;
+
+        for (uint32 i = 0; i < drawCount; i++)
+            calls += ApplyDraw(cache, draws[(i / 4) % draws.size()]);
+
+        const double             ms    = stopwatch.GetElapsedMs();
+        const RenderDeviceStats& stats = cache.GetStats();
+        LINA_CHECK(calls == stats.m_stateCalls);
+        Test::Print("{0} draws in {1} ms, {2} calls reached GL, {3} binds & {4} render states skipped.", stats.m_drawCalls, ms, stats.m_stateCalls, stats.m_skippedBinds, stats.m_skippedRenderStates);
+    }
+} // namespace Lina::Graphics
@@ -0,0 +1,138 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Animation/Animation.hpp"
+#include "Animation/Skeleton.hpp"
+#include "JobSystem/JobSystem.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <cstring>
+
+// A crowd of characters shares a synthetic skeleton & clip, poses are evaluated on the shared executor the same way
+// the animation system does. Doesn't touch the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        const uint32 SkinningKeysPerChannel = 30;
+        const float  SkinningClipDuration   = 1.0f;
+
+        // Three children per joint, similar depth to a humanoid rig. Every joint is animated on all channels.
+        Animation* CreateSkinningRig(Skeleton& skeleton, uint32 joints)
+        {
+            for (uint32 i = 0; i < joints; i++)
+            {
+                JointTransform bindPose;
+                bindPose.m_translation[1] = i == 0 ? 0.0f : 0.25f;
+                skeleton.AddJoint("Joint_" + std::to_string(i), i == 0 ? -1 : (int)(i - 1) / 3, bindPose, Matrix::Identity());
+            }
+
+            Animation* animation = new Animation();
+            animation->SetName("SkinningTest");
+            animation->SetDuration(SkinningClipDuration);
+
+            std::vector<float>        times(SkinningKeysPerChannel);
+            std::vector<AnimationKey> translations(SkinningKeysPerChannel), rotations(SkinningKeysPerChannel), scales(SkinningKeysPerChannel);
+
+            for (uint32 i = 0; i < joints; i++)
+            {
+                for (uint32 k = 0; k < SkinningKeysPerChannel; k++)
+                {
+                    const float t     = (float)k / (float)(SkinningKeysPerChannel - 1);
+                    const float angle = std::sin(t * 6.2831853f + (float)i) * 0.5f;
+                    times[k]          = t * SkinningClipDuration;
+                    translations[k]   = AnimationKey{{0.0f, 0.25f + angle * 0.05f, 0.0f, 0.0f}};
+                    rotations[k]      = AnimationKey{{std::sin(angle * 0.5f), 0.0f, 0.0f, std::cos(angle * 0.5f)}};
+                    scales[k]         = AnimationKey{{1.0f, 1.0f, 1.0f, 0.0f}};
+                }
+
+                animation->AddTrack(i, times, translations, times, rotations, times, scales);
+            }
+
+            // The skeleton owns the animation from here on.
+            skeleton.AddAnimation(animation);
+            return animation;
+        }
+
+        float GetCharacterTime(float time, uint32 character)
+        {
+            return std::fmod(time + (float)character * 0.013f, SkinningClipDuration);
+        }
+
+        // Evaluates the crowd in parallel for the given frames, palettes must match a serial evaluation bit for bit.
+        void CheckSkinning(uint32 characters, uint32 joints, uint32 frames, bool printTimings)
+        {
+            Skeleton                  skeleton;
+            Animation*                animation = CreateSkinningRig(skeleton, joints);
+            std::vector<SkeletonPose> poses(characters);
+            Executor&                 executor = GetSharedExecutor();
+            const Matrix              root     = Matrix::Identity();
+
+            auto evaluate = [&](float time) {
+                ParallelFor(executor, characters, 8, 0, [&](uint32 begin, uint32 end) {
+                    for (uint32 i = begin; i < end; i++)
+                        skeleton.Evaluate(animation, GetCharacterTime(time, i), root, poses[i]);
+                });
+            };
+
+            // Warm up, allocates the pose buffers.
+            evaluate(0.0f);
+
+            const Test::Stopwatch stopwatch;
+
+            for (uint32 frame = 0; frame < frames; frame++)
+                evaluate((float)frame / 60.0f);
+
+            const double frameMs = frames > 0 ? stopwatch.GetElapsedMs() / frames : 0.0;
+            const float  time    = frames > 0 ? (float)(frames - 1) / 60.0f : 0.0f;
+            SkeletonPose serial;
+
+            for (uint32 i = 0; i < characters; i++)
+            {
+                skeleton.Evaluate(animation, GetCharacterTime(time, i), root, serial);
+                LINA_REQUIRE(poses[i].m_palette.size() == joints);
+                LINA_REQUIRE(serial.m_palette.size() == joints);
+                LINA_CHECK(std::memcmp(poses[i].m_palette.data(), serial.m_palette.data(), joints * sizeof(Matrix)) == 0);
+            }
+
+            if (printTimings)
+                Test::Print("{0} characters x {1} joints, {2} ms per frame, {3} us per character, {4} worker threads.", characters, joints, frameMs, frameMs * 1000.0 / characters, executor.num_workers());
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, SkinningParallelPosesMatchSerial)
+    {
+        CheckSkinning(64, 40, 4, false);
+    }
+
+    LINA_BENCHMARK(Graphics, Skinning)
+    {
+        CheckSkinning(1000, 80, 60, true);
+    }
+} // namespace Lina::Graphics
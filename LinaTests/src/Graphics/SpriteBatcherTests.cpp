@@ -0,0 +1,203 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/SpriteBatcher.hpp"
+#include "Rendering/TextureAtlas.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <vector>
+
+// Batches random sprites over a few layers, blend modes & atlas pages. Each sprite carries its index as its color so
+// every quad in the vertex stream can be traced back to the sprite it came from.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        const uint32 BatcherTestPages = 3;
+
+        struct BatcherTestSprite
+        {
+            Matrix          m_transform;
+            AtlasRegion     m_region;
+            int             m_layer     = 0;
+            SpriteBlendMode m_blendMode = SpriteBlendMode::Opaque;
+        };
+
+        std::vector<BatcherTestSprite> CreateBatcherTestSprites(uint32 count, bool singleKey)
+        {
+            Test::Random                   random(count);
+            std::vector<BatcherTestSprite> sprites(count);
+
+            for (BatcherTestSprite& sprite : sprites)
+            {
+                const Vector3    position(random.Range(-50.0f, 50.0f), random.Range(-50.0f, 50.0f), random.Range(-5.0f, 5.0f));
+                const Quaternion rotation(Vector3(0.0f, 0.0f, 1.0f), random.Range(0.0f, 360.0f));
+                const Vector3    scale(random.Range(0.1f, 4.0f), random.Range(0.1f, 4.0f), 1.0f);
+                sprite.m_transform = Matrix::TransformMatrix(position, rotation, scale);
+
+                const float u0          = random.Range(0.0f, 0.5f);
+                const float v0          = random.Range(0.0f, 0.5f);
+                sprite.m_region.m_uv[0] = u0;
+                sprite.m_region.m_uv[1] = v0;
+                sprite.m_region.m_uv[2] = u0 + random.Range(0.01f, 0.5f);
+                sprite.m_region.m_uv[3] = v0 + random.Range(0.01f, 0.5f);
+                sprite.m_region.m_page  = singleKey ? 0 : random.Next() % BatcherTestPages;
+                sprite.m_layer          = singleKey ? 0 : (int)(random.Next() % 5) - 2;
+                sprite.m_blendMode      = singleKey ? SpriteBlendMode::Opaque : (SpriteBlendMode)(random.Next() % 2);
+            }
+
+            return sprites;
+        }
+
+        bool IsBatchKeyLess(const SpriteBatch& a, const SpriteBatch& b)
+        {
+            if (a.m_layer != b.m_layer)
+                return a.m_layer < b.m_layer;
+            if (a.m_blendMode != b.m_blendMode)
+                return a.m_blendMode < b.m_blendMode;
+            return a.m_page < b.m_page;
+        }
+
+        bool IsBatchKeyEqual(const SpriteBatch& a, const SpriteBatch& b)
+        {
+            return a.m_layer == b.m_layer && a.m_blendMode == b.m_blendMode && a.m_page == b.m_page;
+        }
+
+        // Corners go (-x, +y), (-x, -y), (+x, -y), (+x, +y) in the sprite's space, with the region's v flipped.
+        bool IsQuadOfSprite(const SpriteVertex* vertices, const BatcherTestSprite& sprite)
+        {
+            const float cornerX[4] = {-0.5f, -0.5f, 0.5f, 0.5f};
+            const float cornerY[4] = {0.5f, -0.5f, -0.5f, 0.5f};
+            const float u[4]       = {sprite.m_region.m_uv[0], sprite.m_region.m_uv[0], sprite.m_region.m_uv[2], sprite.m_region.m_uv[2]};
+            const float v[4]       = {sprite.m_region.m_uv[3], sprite.m_region.m_uv[1], sprite.m_region.m_uv[1], sprite.m_region.m_uv[3]};
+
+            for (int c = 0; c < 4; c++)
+            {
+                const glm::vec4 expected = sprite.m_transform * glm::vec4(cornerX[c], cornerY[c], 0.0f, 1.0f);
+
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    if (std::fabs(vertices[c].m_position[axis] - expected[axis]) > 1e-3f)
+                        return false;
+                }
+
+                if (vertices[c].m_uv[0] != u[c] || vertices[c].m_uv[1] != v[c] || vertices[c].m_color != vertices[0].m_color)
+                    return false;
+            }
+
+            return true;
+        }
+
+        void CheckSpriteBatcher(uint32 count, bool singleKey, bool printTimings)
+        {
+            const std::vector<BatcherTestSprite> sprites = CreateBatcherTestSprites(count, singleKey);
+            SpriteBatcher                        batcher;
+
+            const Test::Stopwatch stopwatch;
+
+            for (uint32 i = 0; i < count; i++)
+                batcher.AddSprite(sprites[i].m_transform, sprites[i].m_region, i, sprites[i].m_layer, sprites[i].m_blendMode);
+
+            batcher.Build();
+            const double buildMs = stopwatch.GetElapsedMs();
+
+            const std::vector<SpriteVertex>& vertices = batcher.GetVertices();
+            const std::vector<SpriteBatch>&  batches  = batcher.GetBatches();
+
+            LINA_CHECK(batcher.GetSpriteCount() == count);
+            LINA_REQUIRE(vertices.size() == (size_t)count * 4);
+            LINA_REQUIRE(!batches.empty());
+
+            uint32 nextVertex = 0;
+
+            for (uint32 b = 0; b < (uint32)batches.size(); b++)
+            {
+                const SpriteBatch& batch = batches[b];
+
+                // Keys only go up, a batch with the same key as the previous one only follows a full batch.
+                if (b > 0)
+                {
+                    const SpriteBatch& previous = batches[b - 1];
+                    LINA_CHECK(IsBatchKeyLess(previous, batch) || (IsBatchKeyEqual(previous, batch) && previous.m_quadCount == SPRITE_BATCH_MAX_QUADS));
+                }
+
+                LINA_CHECK(batch.m_firstVertex == nextVertex);
+                LINA_CHECK(batch.m_quadCount > 0 && batch.m_quadCount <= SPRITE_BATCH_MAX_QUADS);
+                nextVertex += batch.m_quadCount * 4;
+
+                // Every quad belongs to a sprite with the batch's key, sprites sharing a key keep the order they were added in.
+                uint32 previousSprite = 0;
+                for (uint32 q = 0; q < batch.m_quadCount; q++)
+                {
+                    const SpriteVertex* quad  = &vertices[(size_t)batch.m_firstVertex + q * 4];
+                    const uint32        index = quad->m_color;
+                    LINA_REQUIRE(index < count);
+
+                    const BatcherTestSprite& sprite = sprites[index];
+                    LINA_CHECK(sprite.m_layer == batch.m_layer && sprite.m_blendMode == batch.m_blendMode && sprite.m_region.m_page == batch.m_page);
+                    LINA_CHECK(q == 0 || index > previousSprite);
+                    LINA_CHECK(IsQuadOfSprite(quad, sprite));
+                    previousSprite = index;
+                }
+            }
+
+            LINA_CHECK(nextVertex == count * 4);
+
+            if (singleKey)
+                LINA_CHECK(batches.size() == (count + SPRITE_BATCH_MAX_QUADS - 1) / SPRITE_BATCH_MAX_QUADS);
+
+            const size_t batchCount = batches.size();
+            batcher.Clear();
+            LINA_CHECK(batcher.GetSpriteCount() == 0 && batcher.GetVertices().empty() && batcher.GetBatches().empty());
+
+            if (printTimings)
+                Test::Print("{0} sprites into {1} batches in {2} ms.", count, batchCount, buildMs);
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, SpriteBatcherSortsAndSplits)
+    {
+        CheckSpriteBatcher(2000, false, false);
+        CheckSpriteBatcher(SPRITE_BATCH_MAX_QUADS + 4464, true, false);
+    }
+
+    LINA_TEST(Graphics, SpriteBatcherPacksColors)
+    {
+        LINA_CHECK(SpriteBatcher::PackColor(1.0f, 0.0f, 0.0f, 0.0f) == 0x000000FFu);
+        LINA_CHECK(SpriteBatcher::PackColor(0.0f, 1.0f, 0.0f, 0.0f) == 0x0000FF00u);
+        LINA_CHECK(SpriteBatcher::PackColor(0.0f, 0.0f, 1.0f, 0.0f) == 0x00FF0000u);
+        LINA_CHECK(SpriteBatcher::PackColor(0.0f, 0.0f, 0.0f, 1.0f) == 0xFF000000u);
+        LINA_CHECK(SpriteBatcher::PackColor(0.5f, -1.0f, 2.0f, 0.25f) == 0x40FF0080u);
+    }
+
+    LINA_BENCHMARK(Graphics, SpriteBatcher)
+    {
+        CheckSpriteBatcher(100000, false, true);
+    }
+} // namespace Lina::Graphics
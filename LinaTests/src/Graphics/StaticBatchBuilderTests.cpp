@@ -0,0 +1,275 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/ModelNodeComponent.hpp"
+#include "ECS/Components/StaticComponent.hpp"
+#include "Rendering/Material.hpp"
+#include "Rendering/Model.hpp"
+#include "Rendering/ModelNode.hpp"
+#include "Rendering/StaticBatchBuilder.hpp"
+#include "Rendering/StaticMesh.hpp"
+#include "TestFramework.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+// Merges static entities into chunks & checks the merged meshes against their sources, vertex by vertex. Merged
+// meshes aren't uploaded, so it runs without the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        bool IsNear(const glm::vec3& a, const glm::vec3& b)
+        {
+            return glm::length(a - b) < 1e-4f;
+        }
+
+        // Unit quad on the xz plane with positions, uvs & normals, or without uvs for a second layout.
+        StaticMesh* CreateBatchTestQuad(bool withUVs)
+        {
+            const float  corners[4][2] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+            const uint32 normalElement = withUVs ? 2 : 1;
+            StaticMesh*  mesh          = new StaticMesh();
+
+            mesh->AllocateElement(3, 0, true);
+            if (withUVs)
+                mesh->AllocateElement(2, 1, true);
+            mesh->AllocateElement(3, 2, true);
+
+            for (uint32 i = 0; i < 4; i++)
+            {
+                mesh->AddElement(0, corners[i][0], 0.0f, corners[i][1]);
+                if (withUVs)
+                    mesh->AddElement(1, corners[i][0] + 0.5f, corners[i][1] + 0.5f);
+                mesh->AddElement(normalElement, 0.0f, 1.0f, 0.0f);
+            }
+
+            mesh->AddIndices(0, 1, 2);
+            mesh->AddIndices(0, 2, 3);
+            return mesh;
+        }
+
+        // Models own their node & the node its meshes.
+        struct BatchTestScene
+        {
+            Model          m_quads      = Model(new ModelNode({CreateBatchTestQuad(true)}));
+            Model          m_plainQuads = Model(new ModelNode({CreateBatchTestQuad(false)}));
+            Material       m_materials[2];
+            Material       m_transparent;
+            entt::registry m_reg;
+        };
+
+        ECS::Entity AddBatchTestQuad(BatchTestScene& scene, Model& model, Material* material, const Vector3& location, const Vector3& scale = Vector3::One, bool isStatic = true)
+        {
+            const ECS::Entity entity = scene.m_reg.create();
+            auto&             data   = scene.m_reg.emplace<ECS::EntityDataComponent>(entity);
+            data.SetLocation(location);
+            data.SetScale(scale);
+
+            auto& nodeComponent           = scene.m_reg.emplace<ECS::ModelNodeComponent>(entity);
+            nodeComponent.m_model.m_value = &model;
+            nodeComponent.m_nodeIndex     = 0;
+            nodeComponent.m_materials.resize(1);
+            nodeComponent.m_materials[0].m_value = material;
+
+            if (isStatic)
+                scene.m_reg.emplace<ECS::StaticComponent>(entity);
+
+            return entity;
+        }
+
+        // Each source's vertices are transformed to world space & its indices are offset by the vertices before it,
+        // winding flips for mirroring transforms. Every merged triangle maps back to its source's entity.
+        void CheckMergedChunk(const StaticBatchBuilder& builder, uint32 chunkIndex)
+        {
+            const StaticBatchChunk& chunk = builder.GetChunks()[chunkIndex];
+            LINA_REQUIRE(chunk.m_mesh != nullptr && !chunk.m_sources.empty());
+
+            StaticMesh&               merged     = *chunk.m_mesh;
+            const std::vector<float>& positions  = merged.GetBufferElements()[0].m_floatElements;
+            const auto&               indices    = merged.GetIndices();
+            uint32                    baseVertex = 0;
+            uint32                    firstIndex = 0;
+            glm::vec3                 min        = glm::vec3(FLT_MAX);
+            glm::vec3                 max        = glm::vec3(-FLT_MAX);
+
+            for (const StaticBatchSource& source : chunk.m_sources)
+            {
+                const glm::mat4           model       = source.m_transform;
+                const std::vector<float>& srcPosition = source.m_mesh->GetBufferElements()[0].m_floatElements;
+                const auto&               srcIndices  = source.m_mesh->GetIndices();
+                const uint32              vertices    = (uint32)srcPosition.size() / 3;
+                const bool                flip        = glm::determinant(glm::mat3(model)) < 0.0f;
+
+                LINA_CHECK(source.m_firstIndex == firstIndex && source.m_indexCount == (uint32)srcIndices.size());
+
+                for (uint32 v = 0; v < vertices; v++)
+                {
+                    const glm::vec3 expected = glm::vec3(model * glm::vec4(srcPosition[v * 3], srcPosition[v * 3 + 1], srcPosition[v * 3 + 2], 1.0f));
+                    const glm::vec3 actual   = glm::vec3(positions[(baseVertex + v) * 3], positions[(baseVertex + v) * 3 + 1], positions[(baseVertex + v) * 3 + 2]);
+                    LINA_CHECK(IsNear(expected, actual));
+                    min = glm::min(min, actual);
+                    max = glm::max(max, actual);
+                }
+
+                for (uint32 t = 0; t < (uint32)srcIndices.size(); t += 3)
+                {
+                    LINA_CHECK(indices[firstIndex + t] == baseVertex + srcIndices[t]);
+                    LINA_CHECK(indices[firstIndex + t + 1] == baseVertex + srcIndices[flip ? t + 2 : t + 1]);
+                    LINA_CHECK(indices[firstIndex + t + 2] == baseVertex + srcIndices[flip ? t + 1 : t + 2]);
+                    LINA_CHECK(builder.GetSourceEntity(chunkIndex, (firstIndex + t) / 3) == source.m_entity);
+                }
+
+                baseVertex += vertices;
+                firstIndex += (uint32)srcIndices.size();
+            }
+
+            LINA_CHECK(positions.size() == (size_t)baseVertex * 3 && indices.size() == firstIndex);
+            LINA_CHECK(builder.GetSourceEntity(chunkIndex, firstIndex / 3) == entt::null);
+            LINA_CHECK(IsNear(chunk.m_center, (min + max) / 2.0f) && IsNear(chunk.m_halfExtent, (max - min) / 2.0f));
+        }
+
+        uint32 GetOnlyChunk(const StaticBatchBuilder& builder, ECS::Entity entity)
+        {
+            const std::vector<uint32>& chunks = builder.GetBatchedEntities().at(entity).m_chunks;
+            LINA_CHECK(chunks.size() == 1);
+            return chunks[0];
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, StaticBatchMergesInWorldSpace)
+    {
+        BatchTestScene scene;
+
+        // Same material & cell, the second one is mirrored & stretched.
+        const ECS::Entity shared   = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[0], Vector3(1.0f, 0.0f, 1.0f));
+        const ECS::Entity mirrored = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[0], Vector3(3.0f, 0.0f, 1.0f), Vector3(-1.0f, 1.0f, 2.0f));
+        // Another material, another cell & another layout in the same cell, each gets its own chunk.
+        const ECS::Entity material = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[1], Vector3(1.0f, 0.0f, 1.0f));
+        const ECS::Entity far      = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[0], Vector3(40.0f, 0.0f, 1.0f));
+        const ECS::Entity layout   = AddBatchTestQuad(scene, scene.m_plainQuads, &scene.m_materials[0], Vector3(2.0f, 0.0f, 2.0f));
+        // Neither transparent nor non-static entities are batched.
+        const ECS::Entity transparent = AddBatchTestQuad(scene, scene.m_quads, &scene.m_transparent, Vector3(1.0f, 0.0f, 1.0f));
+        const ECS::Entity dynamic     = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[0], Vector3(5.0f, 0.0f, 5.0f), Vector3::One, false);
+        scene.m_transparent.SetSurfaceType(MaterialSurfaceType::Transparent);
+
+        StaticBatchBuilder builder;
+        builder.Build(scene.m_reg);
+
+        LINA_REQUIRE(builder.GetChunks().size() == 4);
+        LINA_CHECK(builder.GetMergedChunks().size() == 4);
+        LINA_CHECK(!builder.IsBatched(transparent) && !builder.IsBatched(dynamic));
+        LINA_CHECK(GetOnlyChunk(builder, shared) == GetOnlyChunk(builder, mirrored));
+
+        const uint32 sharedChunk = GetOnlyChunk(builder, shared);
+        LINA_CHECK(GetOnlyChunk(builder, material) != sharedChunk && GetOnlyChunk(builder, far) != sharedChunk && GetOnlyChunk(builder, layout) != sharedChunk);
+        LINA_CHECK(builder.GetChunks()[GetOnlyChunk(builder, material)].m_material == &scene.m_materials[1]);
+        LINA_CHECK(builder.GetChunks()[GetOnlyChunk(builder, layout)].m_mesh->GetBufferElements().size() == 2);
+
+        for (uint32 i = 0; i < (uint32)builder.GetChunks().size(); i++)
+            CheckMergedChunk(builder, i);
+
+        LINA_CHECK(builder.GetSourceEntity(4, 0) == entt::null);
+
+        // 3 source draws, quads with either material & plain quads, are now 4 chunk draws.
+        const StaticBatchStats& stats = builder.GetStats();
+        LINA_CHECK(stats.m_batchedEntities == 5 && stats.m_batchedMeshes == 5);
+        LINA_CHECK(stats.m_sourceDrawCalls == 3 && stats.m_chunkDrawCalls == 4);
+        LINA_CHECK(stats.m_indexMemory == 5 * 6 * sizeof(uint32));
+        LINA_CHECK(stats.m_vertexMemory == 4 * 4 * 8 * sizeof(float) + 4 * 6 * sizeof(float));
+    }
+
+    LINA_TEST(Graphics, StaticBatchOnlyMergesAffectedChunks)
+    {
+        BatchTestScene    scene;
+        const ECS::Entity first  = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[0], Vector3(1.0f, 0.0f, 1.0f));
+        const ECS::Entity second = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[0], Vector3(3.0f, 0.0f, 1.0f));
+        const ECS::Entity lonely = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[1], Vector3(1.0f, 0.0f, 1.0f));
+        const ECS::Entity other  = AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[0], Vector3(40.0f, 0.0f, 1.0f));
+
+        StaticBatchBuilder       builder;
+        std::vector<ECS::Entity> removed;
+        builder.Build(scene.m_reg);
+
+        const uint32 sharedChunk = GetOnlyChunk(builder, first);
+        const uint32 lonelyChunk = GetOnlyChunk(builder, lonely);
+        const uint32 otherChunk  = GetOnlyChunk(builder, other);
+
+        // Nothing changed.
+        builder.RemoveOutdated(scene.m_reg, removed);
+        LINA_CHECK(removed.empty() && builder.GetMergedChunks().empty());
+
+        // A moved entity leaves its chunk, only that chunk is merged again.
+        auto& data = scene.m_reg.get<ECS::EntityDataComponent>(second);
+        data.SetLocation(data.GetLocation() + Vector3(0.0f, 1.0f, 0.0f));
+        builder.RemoveOutdated(scene.m_reg, removed);
+
+        LINA_REQUIRE(removed.size() == 1 && removed[0] == second);
+        LINA_REQUIRE(builder.GetMergedChunks().size() == 1 && builder.GetMergedChunks()[0] == sharedChunk);
+        LINA_CHECK(!builder.IsBatched(second));
+        LINA_CHECK(builder.GetChunks()[sharedChunk].m_sources.size() == 1);
+        CheckMergedChunk(builder, sharedChunk);
+        CheckMergedChunk(builder, otherChunk);
+
+        // Losing the static component empties the chunk, so it has nothing to draw.
+        scene.m_reg.remove<ECS::StaticComponent>(lonely);
+        builder.RemoveOutdated(scene.m_reg, removed);
+
+        LINA_REQUIRE(removed.size() == 1 && removed[0] == lonely);
+        LINA_CHECK(builder.GetChunks()[lonelyChunk].m_mesh == nullptr);
+        LINA_CHECK(builder.GetStats().m_batchedEntities == 2 && builder.GetStats().m_chunkDrawCalls == 2);
+
+        // Destroyed entities leave too.
+        scene.m_reg.destroy(other);
+        builder.RemoveOutdated(scene.m_reg, removed);
+        LINA_CHECK(removed.size() == 1 && removed[0] == other);
+        LINA_CHECK(builder.GetStats().m_batchedEntities == 1 && builder.GetStats().m_chunkDrawCalls == 1);
+    }
+
+    LINA_BENCHMARK(Graphics, StaticBatchBuild)
+    {
+        const uint32   entities = 20000;
+        BatchTestScene scene;
+        Test::Random   random(entities);
+
+        for (uint32 i = 0; i < entities; i++)
+        {
+            const Vector3 location(random.Range(-200.0f, 200.0f), random.Range(-20.0f, 20.0f), random.Range(-200.0f, 200.0f));
+            AddBatchTestQuad(scene, scene.m_quads, &scene.m_materials[i % 2], location);
+        }
+
+        StaticBatchBuilder    builder;
+        const Test::Stopwatch stopwatch;
+        builder.Build(scene.m_reg);
+        const double buildMs = stopwatch.GetElapsedMs();
+
+        const StaticBatchStats& stats = builder.GetStats();
+        Test::Print("{0} entities into {1} chunks in {2} ms, draw calls {3} -> {4}, {5} KB vertex, {6} KB index memory.", stats.m_batchedEntities, (uint32)builder.GetChunks().size(), buildMs, stats.m_sourceDrawCalls, stats.m_chunkDrawCalls, stats.m_vertexMemory / 1024, stats.m_indexMemory / 1024);
+    }
+} // namespace Lina::Graphics
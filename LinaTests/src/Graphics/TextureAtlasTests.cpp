@@ -0,0 +1,240 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Rendering/TextureAtlas.hpp"
+#include "TestFramework.hpp"
+
+#include <algorithm>
+#include <vector>
+
+// Packs random images into two atlases in different orders, both have to end up with the same layout. Pages are
+// rebuilt on the CPU from the uploads the same way the sprite system copies them into its textures, every image has
+// to be found under its region with its edges extruded into the padding, & packed blocks must not overlap.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        const uint32 AtlasTestPadding = 2;
+
+        struct AtlasTestImage
+        {
+            StringIDType       m_sid        = 0;
+            uint32             m_width      = 0;
+            uint32             m_height     = 0;
+            uint32             m_components = 0;
+            std::vector<uint8> m_pixels;
+        };
+
+        std::vector<AtlasTestImage> CreateAtlasTestImages(Test::Random& random, uint32 count, uint32 maxSize, StringIDType firstSid)
+        {
+            std::vector<AtlasTestImage> images(count);
+
+            for (uint32 i = 0; i < count; i++)
+            {
+                AtlasTestImage& image = images[i];
+                image.m_sid           = firstSid + (StringIDType)i * 7919;
+                image.m_width         = 1 + random.Next() % maxSize;
+                image.m_height        = 1 + random.Next() % maxSize;
+                image.m_components    = 1 + random.Next() % 4;
+                image.m_pixels.resize((size_t)image.m_width * image.m_height * image.m_components);
+
+                for (uint8& pixel : image.m_pixels)
+                    pixel = (uint8)random.Next();
+            }
+
+            return images;
+        }
+
+        // Same expansion the atlas does for images with less than 4 components.
+        void GetAtlasTestTexel(const AtlasTestImage& image, uint32 x, uint32 y, uint8* out)
+        {
+            const uint8* src = &image.m_pixels[((size_t)y * image.m_width + x) * image.m_components];
+            out[0]           = src[0];
+            out[1]           = image.m_components >= 3 ? src[1] : src[0];
+            out[2]           = image.m_components >= 3 ? src[2] : src[0];
+            out[3]           = image.m_components == 4 ? src[3] : (image.m_components == 2 ? src[1] : 255);
+        }
+
+        // Copies the uploads into the pages, marks the covered texels & returns false if two blocks overlap.
+        bool ApplyAtlasUploads(const TextureAtlas& atlas, std::vector<std::vector<uint8>>& pages, std::vector<std::vector<uint8>>& covered)
+        {
+            const uint32 pageSize = atlas.GetPageSize();
+            bool         isValid  = true;
+
+            while ((uint32)pages.size() < atlas.GetPageCount())
+            {
+                pages.emplace_back((size_t)pageSize * pageSize * 4, 0);
+                covered.emplace_back((size_t)pageSize * pageSize, 0);
+            }
+
+            for (const AtlasUpload& upload : atlas.GetUploads())
+            {
+                if (upload.m_page >= atlas.GetPageCount() || upload.m_x + upload.m_width > pageSize || upload.m_y + upload.m_height > pageSize || upload.m_pixels.size() != (size_t)upload.m_width * upload.m_height * 4)
+                    return false;
+
+                for (uint32 row = 0; row < upload.m_height; row++)
+                {
+                    for (uint32 column = 0; column < upload.m_width; column++)
+                    {
+                        const size_t texel = (size_t)(upload.m_y + row) * pageSize + upload.m_x + column;
+                        isValid            = isValid && covered[upload.m_page][texel] == 0;
+                        covered[upload.m_page][texel] = 1;
+                        std::copy_n(&upload.m_pixels[((size_t)row * upload.m_width + column) * 4], 4, &pages[upload.m_page][texel * 4]);
+                    }
+                }
+            }
+
+            return isValid;
+        }
+
+        // Every texel of the region & its padding has to match the image, padding repeats the closest edge texel.
+        bool IsImageInAtlas(const TextureAtlas& atlas, const std::vector<std::vector<uint8>>& pages, const AtlasTestImage& image)
+        {
+            const AtlasRegion* region = atlas.GetRegion(image.m_sid);
+            if (region == nullptr || region->m_page >= (uint32)pages.size())
+                return false;
+
+            const float  pageSize = (float)atlas.GetPageSize();
+            const int    x0       = (int)(region->m_uv[0] * pageSize + 0.5f);
+            const int    y0       = (int)(region->m_uv[1] * pageSize + 0.5f);
+            const int    x1       = (int)(region->m_uv[2] * pageSize + 0.5f);
+            const int    y1       = (int)(region->m_uv[3] * pageSize + 0.5f);
+            const int    padding  = (int)AtlasTestPadding;
+            const uint8* page     = pages[region->m_page].data();
+
+            if (x1 - x0 != (int)image.m_width || y1 - y0 != (int)image.m_height)
+                return false;
+
+            for (int y = y0 - padding; y < y1 + padding; y++)
+            {
+                for (int x = x0 - padding; x < x1 + padding; x++)
+                {
+                    uint8 expected[4];
+                    GetAtlasTestTexel(image, (uint32)std::min(std::max(x - x0, 0), x1 - x0 - 1), (uint32)std::min(std::max(y - y0, 0), y1 - y0 - 1), expected);
+
+                    if (!std::equal(expected, expected + 4, &page[((size_t)y * atlas.GetPageSize() + x) * 4]))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        void CheckTextureAtlas(uint32 count, uint32 maxSize, uint32 pageSize, bool printTimings)
+        {
+            Test::Random                random(count);
+            std::vector<AtlasTestImage> images = CreateAtlasTestImages(random, count, maxSize, 1);
+            std::vector<AtlasTestImage> later  = CreateAtlasTestImages(random, count / 4 + 1, maxSize, 1 + (StringIDType)count * 7919);
+
+            TextureAtlas ordered(pageSize, AtlasTestPadding);
+            TextureAtlas shuffled(pageSize, AtlasTestPadding);
+
+            for (const AtlasTestImage& image : images)
+                LINA_REQUIRE(ordered.AddImage(image.m_sid, image.m_width, image.m_height, image.m_components, image.m_pixels.data()));
+
+            // Ids that are already added & images larger than a page are refused.
+            LINA_CHECK(!ordered.AddImage(images[0].m_sid, images[0].m_width, images[0].m_height, images[0].m_components, images[0].m_pixels.data()));
+            LINA_CHECK(!ordered.AddImage(0, pageSize, 1, 4, images[0].m_pixels.data()));
+            LINA_CHECK(ordered.GetPendingCount() == count);
+            LINA_CHECK(ordered.GetRegion(images[0].m_sid) == nullptr);
+
+            for (auto it = images.rbegin(); it != images.rend(); ++it)
+                LINA_REQUIRE(shuffled.AddImage(it->m_sid, it->m_width, it->m_height, it->m_components, it->m_pixels.data()));
+
+            const Test::Stopwatch packStopwatch;
+            ordered.Pack();
+            const double packMs = packStopwatch.GetElapsedMs();
+            shuffled.Pack();
+
+            LINA_CHECK(ordered.GetPendingCount() == 0);
+            LINA_CHECK(ordered.GetRegionCount() == count);
+            LINA_CHECK(ordered.GetPageCount() == shuffled.GetPageCount());
+            LINA_REQUIRE(ordered.GetUploads().size() == count);
+
+            // Same layout no matter the order the images came in.
+            for (const AtlasTestImage& image : images)
+            {
+                const AtlasRegion* a = ordered.GetRegion(image.m_sid);
+                const AtlasRegion* b = shuffled.GetRegion(image.m_sid);
+                LINA_REQUIRE(a != nullptr && b != nullptr);
+                LINA_CHECK(a->m_page == b->m_page && std::equal(a->m_uv, a->m_uv + 4, b->m_uv));
+            }
+
+            std::vector<std::vector<uint8>> pages, covered;
+            LINA_CHECK(ApplyAtlasUploads(ordered, pages, covered));
+            ordered.ClearUploads();
+            LINA_CHECK(ordered.GetUploads().empty());
+
+            for (const AtlasTestImage& image : images)
+                LINA_CHECK(IsImageInAtlas(ordered, pages, image));
+
+            // Images packed later go around the existing ones, which keep their regions.
+            std::vector<AtlasRegion> regions;
+            for (const AtlasTestImage& image : images)
+                regions.push_back(*ordered.GetRegion(image.m_sid));
+
+            for (const AtlasTestImage& image : later)
+                LINA_REQUIRE(ordered.AddImage(image.m_sid, image.m_width, image.m_height, image.m_components, image.m_pixels.data()));
+
+            ordered.Pack();
+            LINA_CHECK(ordered.GetUploads().size() == later.size());
+            LINA_CHECK(ApplyAtlasUploads(ordered, pages, covered));
+
+            for (uint32 i = 0; i < count; i++)
+            {
+                const AtlasRegion* region = ordered.GetRegion(images[i].m_sid);
+                LINA_CHECK(region->m_page == regions[i].m_page && std::equal(region->m_uv, region->m_uv + 4, regions[i].m_uv));
+                LINA_CHECK(IsImageInAtlas(ordered, pages, images[i]));
+            }
+
+            for (const AtlasTestImage& image : later)
+                LINA_CHECK(IsImageInAtlas(ordered, pages, image));
+
+            float fullOccupancy = 0.0f;
+            for (uint32 page = 0; page < ordered.GetPageCount(); page++)
+            {
+                const float occupancy = ordered.GetOccupancy(page);
+                LINA_CHECK(occupancy > 0.0f && occupancy <= 1.0f);
+                fullOccupancy += page + 1 < ordered.GetPageCount() ? occupancy : 0.0f;
+            }
+
+            if (printTimings)
+                Test::Print("{0} images up to {1}x{1} packed into {2} pages of {3}x{3} in {4} ms, {5} occupancy on the full pages.", count, maxSize, ordered.GetPageCount(), pageSize, packMs, ordered.GetPageCount() > 1 ? fullOccupancy / (ordered.GetPageCount() - 1) : 0.0f);
+        }
+    } // namespace
+
+    LINA_TEST(Graphics, TextureAtlasPacksDeterministically)
+    {
+        CheckTextureAtlas(300, 48, 256, false);
+    }
+
+    LINA_BENCHMARK(Graphics, TextureAtlas)
+    {
+        CheckTextureAtlas(4000, 128, 2048, true);
+    }
+} // namespace Lina::Graphics
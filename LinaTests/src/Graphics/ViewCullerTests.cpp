@@ -0,0 +1,198 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "ECS/System.hpp"
+#include "ECS/SystemList.hpp"
+#include "ECS/Systems/SpatialIndexSystem.hpp"
+#include "Math/Frustum.hpp"
+#include "Math/Matrix.hpp"
+#include "Rendering/ViewCuller.hpp"
+#include "TestFramework.hpp"
+
+#include <algorithm>
+
+// Culls the camera & additional views against a spatial index built by hand & checks that the camera's visibility
+// comes back after them, also runs the frame guarded pipeline the way Render() does. Nothing is uploaded, so it runs
+// without the GPU.
+namespace Lina::Graphics
+{
+    namespace
+    {
+        struct ViewTestScene
+        {
+            entt::registry                 m_registry;
+            DynamicAABBTree                m_tree;
+            std::vector<ECS::SpatialProxy> m_proxies;
+            std::vector<ECS::Entity>       m_entities;
+            uint32                         m_entityCapacity = 0;
+        };
+
+        // Unit boxes on a row along x, centered on the origin.
+        void CreateRow(ViewTestScene& scene, uint32 count)
+        {
+            for (uint32 i = 0; i < count; i++)
+            {
+                ECS::SpatialProxy proxy;
+                proxy.m_entity     = scene.m_registry.create();
+                proxy.m_meshCount  = 1;
+                proxy.m_center     = Vector3((float)i * 2.0f - (float)count + 1.0f, 0.0f, 10.0f);
+                proxy.m_halfExtent = Vector3(0.5f);
+
+                const int id = scene.m_tree.CreateProxy(proxy.m_center - proxy.m_halfExtent, proxy.m_center + proxy.m_halfExtent, i);
+                if ((int)scene.m_proxies.size() <= id)
+                    scene.m_proxies.resize(id + 1);
+
+                scene.m_proxies[id] = proxy;
+                scene.m_entities.push_back(proxy.m_entity);
+                scene.m_entityCapacity = std::max(scene.m_entityCapacity, (uint32)entt::to_entity(proxy.m_entity) + 1);
+            }
+        }
+
+        // Box shaped view looking down +z, the engine is left handed. Planes are kept unnormalized, only their signs matter.
+        Frustum CreateBoxFrustum(float left, float right)
+        {
+            Frustum frustum;
+            frustum.Calculate(Matrix::Orthographic(left, right, -5.0f, 5.0f, 1.0f, 50.0f), false);
+            return frustum;
+        }
+
+        class CountingSystem : public ECS::System
+        {
+        public:
+            virtual void UpdateComponents(float delta) override
+            {
+                m_updates++;
+            }
+
+            uint32 m_updates = 0;
+        };
+    } // namespace
+
+    LINA_TEST(Graphics, ViewCullerRestoresCameraVisibility)
+    {
+        ViewTestScene scene;
+        CreateRow(scene, 20);
+
+        // The camera sees the left half.
+        ViewCuller culler;
+        LINA_CHECK(culler.Cull(CreateBoxFrustum(-20.0f, 0.0f), scene.m_tree, scene.m_proxies, scene.m_entityCapacity) == 10);
+        culler.CommitCamera();
+
+        const std::vector<uint32> cameraVisibility = culler.GetVisibility();
+        const uint32              cameraVersion    = culler.GetVersion();
+        LINA_CHECK(cameraVersion != 0);
+
+        for (uint32 i = 0; i < 20; i++)
+            LINA_CHECK(culler.IsVisible(scene.m_entities[i]) == (i < 10));
+
+        // A shadow view sees the right half, then a second view only the rightmost boxes.
+        LINA_CHECK(culler.Cull(CreateBoxFrustum(0.0f, 20.0f), scene.m_tree, scene.m_proxies, scene.m_entityCapacity) == 10);
+        culler.CommitView();
+        const uint32 firstViewVersion = culler.GetVersion();
+        LINA_CHECK(firstViewVersion != cameraVersion);
+        LINA_CHECK(!culler.IsVisible(scene.m_entities[0]) && culler.IsVisible(scene.m_entities[19]));
+
+        LINA_CHECK(culler.Cull(CreateBoxFrustum(14.0f, 20.0f), scene.m_tree, scene.m_proxies, scene.m_entityCapacity) == 3);
+        culler.CommitView();
+        const uint32 secondViewVersion = culler.GetVersion();
+        LINA_CHECK(secondViewVersion != firstViewVersion && secondViewVersion != cameraVersion);
+
+        // Restoring brings back the camera's bits & version.
+        culler.RestoreCamera();
+        LINA_CHECK(culler.GetVisibility() == cameraVisibility);
+        LINA_CHECK(culler.GetVersion() == cameraVersion);
+
+        for (uint32 i = 0; i < 20; i++)
+            LINA_CHECK(culler.IsVisible(scene.m_entities[i]) == (i < 10));
+
+        // The same camera next frame keeps its version, a moved one gets a number no view had.
+        culler.Cull(CreateBoxFrustum(-20.0f, 0.0f), scene.m_tree, scene.m_proxies, scene.m_entityCapacity);
+        culler.CommitCamera();
+        LINA_CHECK(culler.GetVersion() == cameraVersion);
+
+        culler.Cull(CreateBoxFrustum(-20.0f, 4.0f), scene.m_tree, scene.m_proxies, scene.m_entityCapacity);
+        culler.CommitCamera();
+        LINA_CHECK(culler.GetVersion() != cameraVersion && culler.GetVersion() != firstViewVersion && culler.GetVersion() != secondViewVersion);
+
+        // Occluded entities are hidden, without a camera everything counts as visible.
+        culler.Hide(scene.m_entities[0]);
+        LINA_CHECK(!culler.IsVisible(scene.m_entities[0]) && culler.IsVisible(scene.m_entities[1]));
+
+        culler.Clear();
+        culler.CommitCamera();
+        for (ECS::Entity entity : scene.m_entities)
+            LINA_CHECK(culler.IsVisible(entity));
+    }
+
+    LINA_TEST(Graphics, ExtractionRunsOncePerFrame)
+    {
+        CountingSystem  extraction;
+        CountingSystem  view;
+        ECS::SystemList renderingPipeline;
+        ECS::SystemList viewPipeline;
+        renderingPipeline.AddSystem(extraction);
+        viewPipeline.AddSystem(view);
+
+        // Each Render() advances the frame, the main view & the model preview both extract but only the first one runs.
+        uint32 frame = 0;
+        for (uint32 i = 0; i < 3; i++)
+        {
+            frame++;
+            LINA_CHECK(renderingPipeline.UpdateSystemsOnce(frame, 0.0f));
+            viewPipeline.UpdateSystems(0.0f);
+            LINA_CHECK(!renderingPipeline.UpdateSystemsOnce(frame, 0.0f));
+        }
+
+        LINA_CHECK(extraction.m_updates == 3);
+        LINA_CHECK(view.m_updates == 3);
+    }
+
+    LINA_BENCHMARK(Graphics, ViewCuller)
+    {
+        ViewTestScene scene;
+        CreateRow(scene, 100000);
+
+        // The camera, six shadow faces & a restore, the way a frame with a shadow casting point light goes.
+        ViewCuller            culler;
+        const Test::Stopwatch stopwatch;
+        uint32                visible = culler.Cull(CreateBoxFrustum(-20000.0f, 0.0f), scene.m_tree, scene.m_proxies, scene.m_entityCapacity);
+        culler.CommitCamera();
+
+        for (uint32 i = 0; i < 6; i++)
+        {
+            const float left = (float)i * 10000.0f;
+            culler.Cull(CreateBoxFrustum(left, left + 10000.0f), scene.m_tree, scene.m_proxies, scene.m_entityCapacity);
+            culler.CommitView();
+        }
+
+        culler.RestoreCamera();
+        const double ms = stopwatch.GetElapsedMs();
+        LINA_CHECK(visible == 10000);
+        Test::Print("{0} proxies, camera & 6 views culled & restored in {1} ms.", (uint32)scene.m_entities.size(), ms);
+    }
+} // namespace Lina::Graphics
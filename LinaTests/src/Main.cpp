@@ -0,0 +1,63 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "TestFramework.hpp"
+
+#include <cstring>
+
+// Usage: LinaTests [--benchmarks] [--list] [--filter Suite.Name]
+// Runs the tests, or the benchmarks if asked for, exits with 1 if any of them failed.
+int main(int argc, char** argv)
+{
+    Lina::Test::TestKind kind   = Lina::Test::TestKind::Test;
+    std::string          filter = "";
+    bool                 list   = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--benchmarks") == 0)
+            kind = Lina::Test::TestKind::Benchmark;
+        else if (std::strcmp(argv[i], "--list") == 0)
+            list = true;
+        else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else
+        {
+            Lina::Test::Print("Unknown argument {0}, usage: LinaTests [--benchmarks] [--list] [--filter Suite.Name]", argv[i]);
+            return 1;
+        }
+    }
+
+    if (list)
+    {
+        Lina::Test::TestRegistry::Get().List(kind);
+        return 0;
+    }
+
+    return Lina::Test::TestRegistry::Get().Run(kind, filter) == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/BulletParityScene.hpp"
+#include "Core/Backend/Bullet/BulletPhysicsEngine.hpp"
+#include "Core/Backend/Bullet/BulletTaskScheduler.hpp"
+#include "Core/PhysicsCommon.hpp"
+#include "ECS/Systems/RigidbodySystem.hpp"
+#include "btBulletDynamicsCommon.h"
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include <chrono>
+#include <memory>
+
+namespace Lina::Physics
+{
+	PhysicsParityResult BulletParityScene::Run(const PhysicsParityScene& scene)
+	{
+		PhysicsParityResult result;
+		result.m_backend = "Bullet";
+		result.m_bodies = (uint32)scene.m_bodies.size();
+		result.m_steps = scene.m_steps;
+
+		btITaskScheduler* previousScheduler = btGetTaskScheduler();
+		BulletTaskScheduler scheduler;
+		scheduler.SetExecutor(&GetSharedExecutor());
+		btSetTaskScheduler(&scheduler);
+		result.m_threads = (uint32)scheduler.getNumThreads();
+
+		// Same setup as the physics engine.
+		btDefaultCollisionConstructionInfo constructionInfo;
+		constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+		constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+
+		btDefaultCollisionConfiguration* config = new btDefaultCollisionConfiguration(constructionInfo);
+		btCollisionDispatcherMt* dispatcher = new btCollisionDispatcherMt(config, 40);
+		btBroadphaseInterface* broadphase = new btDbvtBroadphase();
+		btConstraintSolverPoolMt* solverPool = new btConstraintSolverPoolMt(scheduler.getMaxNumThreads());
+		btSequentialImpulseConstraintSolverMt* solver = new btSequentialImpulseConstraintSolverMt();
+		btDiscreteDynamicsWorldMt* world = new btDiscreteDynamicsWorldMt(dispatcher, broadphase, solverPool, solver, config);
+		world->setGravity(btVector3(0, scene.m_gravity, 0));
+
+		std::unique_ptr<btCollisionShape> groundShape = std::make_unique<btStaticPlaneShape>(btVector3(0, 1, 0), btScalar(0));
+		btRigidBody* ground = new btRigidBody(btRigidBody::btRigidBodyConstructionInfo(0, nullptr, groundShape.get()));
+		ground->setFriction(scene.m_friction);
+		world->addRigidBody(ground);
+
+		// Same bodies the physics engine creates for dynamic bodies.
+		entt::registry reg;
+		std::vector<ECS::Entity> entities;
+		std::vector<btRigidBody*> bodies;
+		PhysicsParity::CreateEntities(scene, reg, entities);
+		bodies.reserve(entities.size());
+
+		for (size_t i = 0; i < entities.size(); i++)
+		{
+			const PhysicsParityBody& body = scene.m_bodies[i];
+			const CollisionShape type = body.m_isSphere ? CollisionShape::Sphere : CollisionShape::Box;
+			btCollisionShape* shape = BulletPhysicsEngine::CreateCollisionShape(type, Vector3(body.m_size), body.m_size, body.m_size);
+			btRigidBody* rb = BulletPhysicsEngine::CreateRigidBody(shape, 1.0f, body.m_position, Quaternion(), entities[i]);
+			rb->setFriction(scene.m_friction);
+			world->addRigidBody(rb);
+			bodies.push_back(rb);
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+		std::vector<btRigidBody*> activeBodies;
+
+		// A sub step per call like the physics engine, the awake bodies are written back after every step.
+		for (uint32 i = 0; i < scene.m_steps; i++)
+		{
+			world->stepSimulation(scene.m_stepTime, 1, scene.m_stepTime);
+
+			activeBodies.clear();
+			for (btRigidBody* rb : bodies)
+			{
+				if (rb->isActive() && !rb->isKinematicObject())
+					activeBodies.push_back(rb);
+			}
+
+			ECS::RigidbodySystem::SyncActiveBodies(reg, activeBodies.data(), (uint32)activeBodies.size());
+		}
+
+		const auto end = std::chrono::high_resolution_clock::now();
+		result.m_stepMs = scene.m_steps > 0 ? std::chrono::duration<double, std::milli>(end - start).count() / scene.m_steps : 0.0;
+		PhysicsParity::Aggregate(reg, entities, result);
+
+		for (btRigidBody* rb : bodies)
+		{
+			world->removeRigidBody(rb);
+			delete rb->getMotionState();
+			delete rb->getCollisionShape();
+			delete rb;
+		}
+
+		world->removeRigidBody(ground);
+		delete ground;
+		delete world;
+		delete solver;
+		delete solverPool;
+		delete broadphase;
+		delete dispatcher;
+		delete config;
+
+		btSetTaskScheduler(previousScheduler);
+		return result;
+	}
+}
@@ -0,0 +1,236 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXAllocator.hpp"
+#include "Memory/MemoryStats.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Runs PhysX on the engine's allocator callback & checks the memory statistics it reports, the alignment PhysX requires
+// & how the scratch block grows between steps. Categories are shared by every allocator in the process, so counters
+// are compared against the values they had before the test.
+namespace Lina::Physics
+{
+    namespace
+    {
+        const uint32 AllocatorTestGranularity = 16 * 1024;
+
+        struct AllocatorTestCounters
+        {
+            uint64 m_bytes[(uint32)PhysXMemoryCategory::Count + 1];
+            uint64 m_allocations[(uint32)PhysXMemoryCategory::Count + 1];
+        };
+
+        // Same order as PhysXMemoryCategory, the scratch block last.
+        const char* AllocatorTestCategories[(uint32)PhysXMemoryCategory::Count + 1] = {"PhysX/Scene", "PhysX/Simulation", "PhysX/Cooking", "PhysX/Serialization", "PhysX/Scratch"};
+
+        AllocatorTestCounters ReadAllocatorTestCounters()
+        {
+            AllocatorTestCounters counters;
+
+            for (uint32 i = 0; i < (uint32)PhysXMemoryCategory::Count + 1; i++)
+            {
+                MemoryCategory* category   = MemoryStats::GetCategory(AllocatorTestCategories[i]);
+                counters.m_bytes[i]       = category->GetBytes();
+                counters.m_allocations[i] = category->GetAllocations();
+            }
+
+            return counters;
+        }
+
+        uint32 RoundToScratchGranularity(uint64 size)
+        {
+            return (uint32)((size + AllocatorTestGranularity - 1) / AllocatorTestGranularity * AllocatorTestGranularity);
+        }
+
+        void StepAllocatorTestScene(PhysXTestFoundation& foundation, PhysXAllocator& allocator, uint32 bodies, uint32 steps)
+        {
+            physx::PxPhysics*              physics    = foundation.GetPhysics();
+            physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(1);
+            physx::PxScene*                scene      = foundation.CreateScene(dispatcher);
+            physx::PxMaterial*             material   = physics->createMaterial(0.5f, 0.5f, 0.6f);
+            physx::PxShape*                shape      = physics->createShape(physx::PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, false);
+
+            physx::PxRigidStatic* ground = physx::PxCreatePlane(*physics, physx::PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material);
+            scene->addActor(*ground);
+
+            std::vector<physx::PxRigidDynamic*> actors;
+
+            for (uint32 i = 0; i < bodies; i++)
+            {
+                const physx::PxVec3    location((float)(i / 8) * 2.0f, 0.5f + (float)(i % 8) * 1.05f, 0.0f);
+                physx::PxRigidDynamic* rigid = physics->createRigidDynamic(physx::PxTransform(location));
+                rigid->attachShape(*shape);
+                physx::PxRigidBodyExt::updateMassAndInertia(*rigid, 10.0f);
+                scene->addActor(*rigid);
+                actors.push_back(rigid);
+            }
+
+            for (uint32 i = 0; i < steps; i++)
+            {
+                allocator.BeginStep();
+                scene->simulate(0.016f, nullptr, allocator.GetScratchBlock(), allocator.GetScratchSize());
+                scene->fetchResults(true);
+                allocator.EndStep();
+            }
+
+            for (physx::PxRigidDynamic* rigid : actors)
+                rigid->release();
+
+            ground->release();
+            shape->release();
+            material->release();
+            scene->release();
+            dispatcher->release();
+        }
+    } // namespace
+
+    LINA_TEST(Physics, PhysXAllocatorReleasesCategories)
+    {
+        const AllocatorTestCounters before = ReadAllocatorTestCounters();
+
+        {
+            PhysXAllocator allocator;
+            allocator.SetScratchSize(AllocatorTestGranularity, 1024 * 1024);
+
+            {
+                PhysXTestFoundation foundation(&allocator);
+                LINA_REQUIRE(foundation.IsValid());
+
+                StepAllocatorTestScene(foundation, allocator, 64, 10);
+
+                // PhysX requires 16 byte aligned blocks, the header in front of them must keep it.
+                const size_t sizes[] = {1, 3, 16, 17, 100, 4097};
+                std::vector<void*> blocks;
+
+                for (size_t size : sizes)
+                {
+                    PhysXAllocator::Scope scope(PhysXMemoryCategory::Cooking);
+                    void*                 block = allocator.allocate(size, "PhysXAllocatorTests", __FILE__, __LINE__);
+                    LINA_CHECK(((uintptr_t)block & 15) == 0);
+                    blocks.push_back(block);
+                }
+
+                const AllocatorTestCounters allocated = ReadAllocatorTestCounters();
+                LINA_CHECK(allocated.m_allocations[(uint32)PhysXMemoryCategory::Cooking] == before.m_allocations[(uint32)PhysXMemoryCategory::Cooking] + blocks.size());
+                LINA_CHECK(allocated.m_bytes[(uint32)PhysXMemoryCategory::Cooking] == before.m_bytes[(uint32)PhysXMemoryCategory::Cooking] + 1 + 3 + 16 + 17 + 100 + 4097);
+
+                for (void* block : blocks)
+                    allocator.deallocate(block);
+            }
+
+            // Everything PhysX allocated is freed with the foundation, only the scratch block is left.
+            const AllocatorTestCounters released = ReadAllocatorTestCounters();
+
+            for (uint32 i = 0; i < (uint32)PhysXMemoryCategory::Count; i++)
+            {
+                LINA_CHECK(released.m_bytes[i] == before.m_bytes[i]);
+                LINA_CHECK(released.m_allocations[i] == before.m_allocations[i]);
+            }
+
+            LINA_CHECK(released.m_bytes[(uint32)PhysXMemoryCategory::Count] == before.m_bytes[(uint32)PhysXMemoryCategory::Count] + allocator.GetScratchSize());
+        }
+
+        const AllocatorTestCounters after = ReadAllocatorTestCounters();
+        LINA_CHECK(after.m_bytes[(uint32)PhysXMemoryCategory::Count] == before.m_bytes[(uint32)PhysXMemoryCategory::Count]);
+        LINA_CHECK(after.m_allocations[(uint32)PhysXMemoryCategory::Count] == before.m_allocations[(uint32)PhysXMemoryCategory::Count]);
+    }
+
+    LINA_TEST(Physics, PhysXAllocatorGrowsScratchByTemporaryPeak)
+    {
+        const uint32   maxSize = 16 * AllocatorTestGranularity;
+        PhysXAllocator allocator;
+        allocator.SetScratchSize(AllocatorTestGranularity, maxSize);
+        LINA_REQUIRE(allocator.GetScratchSize() == AllocatorTestGranularity);
+        LINA_CHECK(((uintptr_t)allocator.GetScratchBlock() & 15) == 0);
+
+        // Memory kept past the step doesn't grow the scratch block, only the temporary memory on top of it does.
+        allocator.BeginStep();
+        void* kept      = allocator.allocate(30000, "PhysXAllocatorTests", __FILE__, __LINE__);
+        void* temporary = allocator.allocate(40000, "PhysXAllocatorTests", __FILE__, __LINE__);
+        allocator.deallocate(temporary);
+        allocator.EndStep();
+
+        LINA_CHECK(allocator.GetStepTemporaryPeak() == 40000);
+        const uint32 grown = RoundToScratchGranularity(AllocatorTestGranularity + 40000);
+        LINA_CHECK(allocator.GetScratchSize() == grown);
+
+        // Freed after the step it was allocated in, the next step doesn't see it.
+        allocator.BeginStep();
+        allocator.deallocate(kept);
+        void* persistent = allocator.allocate(50000, "PhysXAllocatorTests", __FILE__, __LINE__);
+        allocator.EndStep();
+
+        LINA_CHECK(allocator.GetStepTemporaryPeak() == 0);
+        LINA_CHECK(allocator.GetScratchSize() == grown);
+
+        // Tagged allocations aren't simulation memory.
+        allocator.BeginStep();
+        {
+            PhysXAllocator::Scope scope(PhysXMemoryCategory::Cooking);
+            allocator.deallocate(allocator.allocate(100000, "PhysXAllocatorTests", __FILE__, __LINE__));
+        }
+        allocator.EndStep();
+
+        LINA_CHECK(allocator.GetStepTemporaryPeak() == 0);
+        LINA_CHECK(allocator.GetScratchSize() == grown);
+
+        // Never grown past the maximum.
+        allocator.BeginStep();
+        allocator.deallocate(allocator.allocate(maxSize * 2, "PhysXAllocatorTests", __FILE__, __LINE__));
+        allocator.EndStep();
+
+        LINA_CHECK(allocator.GetScratchSize() == maxSize);
+        allocator.deallocate(persistent);
+    }
+
+    LINA_BENCHMARK(Physics, PhysXAllocator)
+    {
+        const uint32 bodies[] = {256, 1024, 4096};
+
+        for (uint32 count : bodies)
+        {
+            PhysXAllocator allocator;
+            allocator.SetScratchSize(AllocatorTestGranularity, 16 * 1024 * 1024);
+
+            PhysXTestFoundation foundation(&allocator);
+            LINA_REQUIRE(foundation.IsValid());
+
+            const Test::Stopwatch stopwatch;
+            StepAllocatorTestScene(foundation, allocator, count, 60);
+            Test::Print("{0} bodies, 60 steps in {1} ms, scratch grown to {2} KB.", count, stopwatch.GetElapsedMs(), allocator.GetScratchSize() / 1024);
+        }
+    }
+} // namespace Lina::Physics
+
+#endif
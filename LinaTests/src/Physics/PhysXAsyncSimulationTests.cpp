@@ -0,0 +1,317 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXSimulationStep.hpp"
+#include "Core/PhysicsCommon.hpp"
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Systems/RigidbodySystem.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Drives PhysXSimulationStep on a scene of stacked boxes with the blocking & the async (split simulate / fetch) step, a
+// busy wait stands in for rendering. Writes made while a step is running go through the step's deferral the same way
+// the physics engine's setters do, pose hashes after each step have to match between the modes.
+namespace Lina::Physics
+{
+    namespace
+    {
+        const float AsyncTestStep = 0.016f;
+
+        struct AsyncTestRun
+        {
+            std::vector<uint64> m_stepHashes;
+            double              m_frameMs = 0.0;
+            double              m_waitMs  = 0.0;
+        };
+
+        struct AsyncTestScene
+        {
+            entt::registry                      m_reg;
+            std::vector<ECS::Entity>            m_entities;
+            std::vector<physx::PxRigidDynamic*> m_actors;
+        };
+
+        uint64 HashAsyncTestPoses(entt::registry& reg)
+        {
+            auto&  datas = reg.storage<ECS::EntityDataComponent>();
+            uint64 hash  = 14695981039346656037ull;
+
+            for (auto& data : datas)
+            {
+                const float pose[7] = {data.GetLocation().x, data.GetLocation().y, data.GetLocation().z, data.GetRotation().x, data.GetRotation().y, data.GetRotation().z, data.GetRotation().w};
+                uint8       bytes[sizeof(pose)];
+                std::memcpy(bytes, pose, sizeof(pose));
+
+                for (uint8 byte : bytes)
+                    hash = (hash ^ byte) * 1099511628211ull;
+            }
+
+            return hash;
+        }
+
+        // Stands in for the physics engine's setters, bodies are looked up by entity.
+        void ApplyAsyncTestWrite(AsyncTestScene& scene, const DeferredWrite& write)
+        {
+            if (write.m_type == DeferredWriteType::BodyMass)
+                scene.m_actors[entt::to_entity(write.m_body)]->setMass(write.m_value);
+        }
+
+        void SetAsyncTestMass(PhysXSimulationStep& step, AsyncTestScene& scene, ECS::Entity body, float mass)
+        {
+            if (DeferredWrite* write = step.DeferIfSimulating(DeferredWriteType::BodyMass, body))
+            {
+                write->m_value = mass;
+                return;
+            }
+
+            DeferredWrite write;
+            write.m_type  = DeferredWriteType::BodyMass;
+            write.m_body  = body;
+            write.m_value = mass;
+            ApplyAsyncTestWrite(scene, write);
+        }
+
+        // Writes are keyed by the step they land before, so both modes apply the same writes to the same steps.
+        void WriteGameplay(AsyncTestScene& scene, uint32 targetStep)
+        {
+            if (targetStep == 0 || targetStep % 10 != 0)
+                return;
+
+            scene.m_actors[(targetStep * 31) % scene.m_actors.size()]->addForce(physx::PxVec3(0.0f, 60.0f, 0.0f), physx::PxForceMode::eIMPULSE);
+        }
+
+        void WriteDuringRender(PhysXSimulationStep& step, AsyncTestScene& scene, uint32 targetStep)
+        {
+            if (targetStep == 0 || targetStep % 7 != 0)
+                return;
+
+            SetAsyncTestMass(step, scene, scene.m_entities[(targetStep * 17) % scene.m_entities.size()], 40.0f);
+        }
+
+        void SpinFor(double ms)
+        {
+            const Test::Stopwatch stopwatch;
+            while (stopwatch.GetElapsedMs() < ms)
+            {
+            }
+        }
+
+        AsyncTestRun RunAsyncTestMode(PhysXTestFoundation& foundation, physx::PxCpuDispatcher* dispatcher, physx::PxMaterial* material, physx::PxShape* shape, uint32 bodies, uint32 steps, double renderMs, bool async)
+        {
+            physx::PxPhysics* physics = foundation.GetPhysics();
+            physx::PxScene*   pxScene = foundation.CreateScene(dispatcher);
+            pxScene->setFlag(physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS, true);
+
+            physx::PxRigidStatic* ground = physx::PxCreatePlane(*physics, physx::PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material);
+            pxScene->addActor(*ground);
+
+            // Columns of 8, so the solver has contacts to work on.
+            AsyncTestScene scene;
+            const uint32   columns  = (bodies + 7) / 8;
+            const uint32   gridSize = (uint32)std::ceil(std::sqrt((float)columns));
+            scene.m_actors.reserve(bodies);
+
+            for (uint32 i = 0; i < bodies; i++)
+            {
+                const uint32  column   = i / 8;
+                const Vector3 location = Vector3((float)(column % gridSize) * 2.0f, 0.5f + (float)(i % 8) * 1.05f, (float)(column / gridSize) * 2.0f);
+                const auto    entity   = scene.m_reg.create();
+                scene.m_reg.emplace<ECS::EntityDataComponent>(entity).SetLocation(location);
+
+                physx::PxRigidDynamic* rigid = physics->createRigidDynamic(physx::PxTransform(ToPxVector3(location)));
+                rigid->attachShape(*shape);
+                physx::PxRigidBodyExt::updateMassAndInertia(*rigid, 10.0f);
+                rigid->userData = ToPxUserData(entity);
+                pxScene->addActor(*rigid);
+                scene.m_entities.push_back(entity);
+                scene.m_actors.push_back(rigid);
+            }
+
+            AsyncTestRun        run;
+            PhysXSimulationStep step;
+
+            // Same order as the physics engine, fetch & sync, then the writes deferred during the step.
+            auto fetch = [&]() {
+                const Test::Stopwatch wait;
+                step.FetchResults(pxScene);
+                run.m_waitMs += wait.GetElapsedMs();
+
+                physx::PxU32     nbActiveActors = 0;
+                physx::PxActor** activeActors   = pxScene->getActiveActors(nbActiveActors);
+                ECS::RigidbodySystem::SyncActiveActors(scene.m_reg, activeActors, nbActiveActors);
+                run.m_stepHashes.push_back(HashAsyncTestPoses(scene.m_reg));
+
+                step.ApplyDeferredWrites(scene.m_reg, [&scene](const DeferredWrite& write) { ApplyAsyncTestWrite(scene, write); });
+            };
+
+            for (uint32 frame = 0; frame < steps; frame++)
+            {
+                const Test::Stopwatch frameStopwatch;
+
+                if (async)
+                {
+                    if (frame > 0)
+                        fetch();
+
+                    WriteGameplay(scene, frame);
+                    step.Simulate(pxScene, AsyncTestStep, nullptr, 0);
+                    WriteDuringRender(step, scene, frame + 1);
+                    SpinFor(renderMs);
+                }
+                else
+                {
+                    const Test::Stopwatch wait;
+                    step.Simulate(pxScene, AsyncTestStep, nullptr, 0);
+                    run.m_waitMs += wait.GetElapsedMs();
+                    fetch();
+
+                    WriteGameplay(scene, frame + 1);
+                    WriteDuringRender(step, scene, frame + 1);
+                    SpinFor(renderMs);
+                }
+
+                run.m_frameMs += frameStopwatch.GetElapsedMs();
+            }
+
+            // The last step is still running in async mode, it isn't part of the frame timings.
+            if (async && steps > 0)
+            {
+                const double waitMs = run.m_waitMs;
+                fetch();
+                run.m_waitMs = waitMs;
+            }
+
+            for (physx::PxRigidDynamic* rigid : scene.m_actors)
+                rigid->release();
+
+            ground->release();
+            pxScene->release();
+
+            run.m_frameMs = steps > 0 ? run.m_frameMs / steps : 0.0;
+            run.m_waitMs  = steps > 0 ? run.m_waitMs / steps : 0.0;
+            return run;
+        }
+
+        void CheckAsyncSimulation(uint32 bodies, uint32 steps, double renderMs, bool printTimings)
+        {
+            PhysXTestFoundation foundation;
+            LINA_REQUIRE(foundation.IsValid());
+
+            physx::PxPhysics*              physics    = foundation.GetPhysics();
+            physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(2);
+            physx::PxMaterial*             material   = physics->createMaterial(0.5f, 0.5f, 0.6f);
+            physx::PxShape*                shape      = physics->createShape(physx::PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, false);
+
+            const AsyncTestRun blocking = RunAsyncTestMode(foundation, dispatcher, material, shape, bodies, steps, renderMs, false);
+            const AsyncTestRun async    = RunAsyncTestMode(foundation, dispatcher, material, shape, bodies, steps, renderMs, true);
+
+            shape->release();
+            material->release();
+            dispatcher->release();
+
+            LINA_REQUIRE(blocking.m_stepHashes.size() == steps);
+            LINA_REQUIRE(async.m_stepHashes.size() == steps);
+
+            for (uint32 i = 0; i < steps; i++)
+                LINA_REQUIRE(blocking.m_stepHashes[i] == async.m_stepHashes[i]);
+
+            if (printTimings)
+                Test::Print("{0} bodies, {1} steps. Blocking {2} ms per frame, {3} ms waiting. Async {4} ms per frame, {5} ms waiting.", bodies, steps, blocking.m_frameMs, blocking.m_waitMs, async.m_frameMs, async.m_waitMs);
+        }
+    } // namespace
+
+    LINA_TEST(Physics, AsyncStepAppliesWritesInOrder)
+    {
+        PhysXTestFoundation foundation;
+        LINA_REQUIRE(foundation.IsValid());
+
+        physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(1);
+        physx::PxScene*                scene      = foundation.CreateScene(dispatcher);
+        entt::registry                 reg;
+        const ECS::Entity              kept      = reg.create();
+        const ECS::Entity              destroyed = reg.create();
+        PhysXSimulationStep            step;
+
+        // Nothing is deferred or fetched without a running step.
+        LINA_CHECK(step.DeferIfSimulating(DeferredWriteType::BodyMass, kept) == nullptr);
+        LINA_CHECK(!step.FetchResults(scene));
+
+        step.Simulate(scene, AsyncTestStep, nullptr, 0);
+        LINA_CHECK(step.IsSimulating());
+
+        step.DeferIfSimulating(DeferredWriteType::BodyMass, kept)->m_value      = 1.0f;
+        step.DeferIfSimulating(DeferredWriteType::BodyMass, destroyed)->m_value = 2.0f;
+        step.DeferIfSimulating(DeferredWriteType::WorkerBudget)->m_args[0]      = 3;
+        step.DeferIfSimulating(DeferredWriteType::RemoveBody, destroyed);
+        step.DeferIfSimulating(DeferredWriteType::BodyMass, kept)->m_value = 4.0f;
+        reg.destroy(destroyed);
+
+        // Fetching keeps the writes until they are applied.
+        LINA_CHECK(step.FetchResults(scene));
+        LINA_CHECK(!step.IsSimulating());
+        LINA_CHECK(step.GetDeferredCount() == 5);
+
+        std::vector<DeferredWrite> applied;
+        bool                       deferredAgain = false;
+
+        step.ApplyDeferredWrites(reg, [&](const DeferredWrite& write) {
+            applied.push_back(write);
+            deferredAgain |= step.DeferIfSimulating(write.m_type, write.m_body) != nullptr;
+        });
+
+        scene->release();
+        dispatcher->release();
+
+        // The mass of the destroyed body is dropped, its removal isn't.
+        LINA_REQUIRE(applied.size() == 4);
+        LINA_CHECK(applied[0].m_type == DeferredWriteType::BodyMass && applied[0].m_body == kept && applied[0].m_value == 1.0f);
+        LINA_CHECK(applied[1].m_type == DeferredWriteType::WorkerBudget && applied[1].m_args[0] == 3);
+        LINA_CHECK(applied[2].m_type == DeferredWriteType::RemoveBody && applied[2].m_body == destroyed);
+        LINA_CHECK(applied[3].m_type == DeferredWriteType::BodyMass && applied[3].m_body == kept && applied[3].m_value == 4.0f);
+        LINA_CHECK(!deferredAgain);
+        LINA_CHECK(step.GetDeferredCount() == 0);
+    }
+
+    LINA_TEST(Physics, AsyncStepMatchesBlockingStep)
+    {
+        CheckAsyncSimulation(256, 40, 0.0, false);
+    }
+
+    LINA_BENCHMARK(Physics, AsyncSimulation)
+    {
+        CheckAsyncSimulation(4000, 120, 4.0, true);
+    }
+} // namespace Lina::Physics
+
+#endif
@@ -0,0 +1,160 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXCooker.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <cereal/archives/portable_binary.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/vector.hpp>
+#include <cmath>
+#include <sstream>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Loads the collision meshes of a set of synthetic meshes once with an empty cache, which cooks all of them, then
+// again from the serialized cache. Both loads have to create the same meshes.
+namespace Lina::Physics
+{
+    namespace
+    {
+        struct CollisionCacheTestMesh
+        {
+            std::vector<float>  m_positions;
+            std::vector<uint32> m_indices;
+        };
+
+        // Lumpy sphere, every mesh has its own bumps so no two of them share a cache entry.
+        void CreateLumpySphere(CollisionCacheTestMesh& mesh, uint32 rings, uint32 segments, uint32 seed)
+        {
+            for (uint32 ring = 0; ring <= rings; ring++)
+            {
+                const float theta = 3.14159265f * (float)ring / (float)rings;
+
+                for (uint32 segment = 0; segment <= segments; segment++)
+                {
+                    const float phi    = 6.28318531f * (float)segment / (float)segments;
+                    const float radius = 1.0f + 0.15f * std::sin(theta * (float)(3 + seed % 5) + (float)seed) * std::cos(phi * (float)(2 + seed % 3));
+                    mesh.m_positions.push_back(radius * std::sin(theta) * std::cos(phi));
+                    mesh.m_positions.push_back(radius * std::cos(theta));
+                    mesh.m_positions.push_back(radius * std::sin(theta) * std::sin(phi));
+                }
+            }
+
+            for (uint32 ring = 0; ring < rings; ring++)
+            {
+                for (uint32 segment = 0; segment < segments; segment++)
+                {
+                    const uint32 a = ring * (segments + 1) + segment;
+                    const uint32 b = a + segments + 1;
+                    mesh.m_indices.insert(mesh.m_indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+                }
+            }
+        }
+
+        void CheckCollisionCache(uint32 meshes, uint32 verticesPerMesh, bool printTimings)
+        {
+            PhysXTestFoundation foundation;
+            LINA_REQUIRE(foundation.IsValid());
+
+            PhysXCooker cooker;
+            cooker.CreateCooking(foundation.GetFoundation(), foundation.GetPhysics());
+
+            const uint32                        segments = (uint32)std::ceil(std::sqrt((float)verticesPerMesh * 2.0f));
+            const uint32                        rings    = segments / 2 > 2 ? segments / 2 : 2;
+            std::vector<CollisionCacheTestMesh> source(meshes);
+            std::vector<CollisionMeshSource>    sources(meshes);
+
+            for (uint32 i = 0; i < meshes; i++)
+            {
+                CreateLumpySphere(source[i], rings, segments, i);
+                sources[i].m_positions   = source[i].m_positions.data();
+                sources[i].m_indices     = source[i].m_indices.data();
+                sources[i].m_vertexCount = (uint32)source[i].m_positions.size() / 3;
+                sources[i].m_indexCount  = (uint32)source[i].m_indices.size();
+            }
+
+            // Without the cache, every mesh is cooked.
+            const StringIDType                    uncachedModel = 1;
+            std::map<uint64, CookedCollisionMesh> cache;
+            const Test::Stopwatch                 uncachedStopwatch;
+            LINA_CHECK(cooker.LoadCollisionMeshes(uncachedModel, sources, cache));
+            const double uncachedMs = uncachedStopwatch.GetElapsedMs();
+            LINA_CHECK(cache.size() == meshes);
+
+            std::stringstream archive(std::ios::in | std::ios::out | std::ios::binary);
+            {
+                cereal::PortableBinaryOutputArchive oarchive(archive);
+                oarchive(cache);
+            }
+
+            // With the cache, the archive is read back & the streams are only deserialized, which leaves the cache as it is.
+            const StringIDType    cachedModel = 2;
+            const Test::Stopwatch cachedStopwatch;
+            {
+                std::map<uint64, CookedCollisionMesh> loadedCache;
+                cereal::PortableBinaryInputArchive    iarchive(archive);
+                iarchive(loadedCache);
+                LINA_CHECK(!cooker.LoadCollisionMeshes(cachedModel, sources, loadedCache));
+            }
+            const double cachedMs = cachedStopwatch.GetElapsedMs();
+
+            for (uint32 i = 0; i < meshes; i++)
+            {
+                physx::PxConvexMesh*   convexA    = cooker.GetConvexMesh(uncachedModel, i);
+                physx::PxConvexMesh*   convexB    = cooker.GetConvexMesh(cachedModel, i);
+                physx::PxTriangleMesh* trianglesA = cooker.GetTriangleMesh(uncachedModel, i);
+                physx::PxTriangleMesh* trianglesB = cooker.GetTriangleMesh(cachedModel, i);
+
+                LINA_REQUIRE(convexA != nullptr && convexB != nullptr && trianglesA != nullptr && trianglesB != nullptr);
+                LINA_CHECK(convexA->getNbVertices() == convexB->getNbVertices() && convexA->getNbPolygons() == convexB->getNbPolygons());
+                LINA_CHECK(trianglesA->getNbVertices() == trianglesB->getNbVertices() && trianglesA->getNbTriangles() == trianglesB->getNbTriangles());
+            }
+
+            if (printTimings)
+                Test::Print("{0} meshes of {1} vertices, {2} bytes cached. Load without cache {3} ms, with cache {4} ms, {5}x speedup.", meshes, sources[0].m_vertexCount, archive.str().size(), uncachedMs, cachedMs, cachedMs > 0.0 ? uncachedMs / cachedMs : 1.0);
+
+            cooker.ReleaseCollisionMeshes(uncachedModel);
+            cooker.ReleaseCollisionMeshes(cachedModel);
+            cooker.ReleaseCooking();
+        }
+    } // namespace
+
+    LINA_TEST(Physics, CollisionCacheLoadsTheSameMeshes)
+    {
+        CheckCollisionCache(4, 200, false);
+    }
+
+    LINA_BENCHMARK(Physics, CollisionCache)
+    {
+        CheckCollisionCache(64, 2000, true);
+    }
+} // namespace Lina::Physics
+
+#endif
@@ -0,0 +1,173 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXContactReporter.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Boxes resting on the ground report their touches every step. After the warm up steps the reporter must neither
+// allocate through the foundation nor move its arrays, & no contact may be dropped.
+namespace Lina::Physics
+{
+    namespace
+    {
+        const float ContactTestStep = 0.016f;
+
+        class CountingAllocator : public physx::PxAllocatorCallback
+        {
+        public:
+            void* allocate(size_t size, const char* typeName, const char* filename, int line) override
+            {
+                m_allocations++;
+                return m_allocator.allocate(size, typeName, filename, line);
+            }
+
+            void deallocate(void* ptr) override
+            {
+                m_allocator.deallocate(ptr);
+            }
+
+            physx::PxDefaultAllocator m_allocator;
+            std::atomic<uint64>       m_allocations{0};
+        };
+
+        void CheckContactReports(uint32 bodies, uint32 steps, uint32 warmup, bool printTimings)
+        {
+            // Declared first, it has to outlive the foundation.
+            CountingAllocator   allocator;
+            PhysXTestFoundation foundation(&allocator);
+            LINA_REQUIRE(foundation.IsValid());
+
+            const uint32                   threads    = std::max(1u, std::thread::hardware_concurrency() - 1);
+            physx::PxPhysics*              physics    = foundation.GetPhysics();
+            physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(threads);
+            physx::PxMaterial*             material   = physics->createMaterial(0.5f, 0.5f, 0.0f);
+            physx::PxShape*                shape      = physics->createShape(physx::PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, false);
+
+            // Boxes are on layer 2 & report touches with layer 1, the ground. Boxes don't touch each other.
+            shape->setSimulationFilterData(PhysXContactReporter::MakeFilterData(2, 1, true));
+
+            PhysXContactReporter reporter;
+            reporter.SetCapacity(bodies, 16);
+
+            physx::PxSceneDesc sceneDesc(physics->getTolerancesScale());
+            sceneDesc.gravity                 = physx::PxVec3(0.0f, -9.81f, 0.0f);
+            sceneDesc.cpuDispatcher           = dispatcher;
+            sceneDesc.filterShader            = PhysXContactReporter::FilterShader;
+            sceneDesc.simulationEventCallback = &reporter;
+            physx::PxScene* scene             = physics->createScene(sceneDesc);
+
+            physx::PxRigidStatic* ground = physx::PxCreatePlane(*physics, physx::PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material);
+            physx::PxShape*       groundShape;
+            ground->getShapes(&groundShape, 1);
+            groundShape->setSimulationFilterData(PhysXContactReporter::MakeFilterData(1, 0, false));
+            scene->addActor(*ground);
+
+            std::vector<physx::PxRigidDynamic*> actors;
+            const uint32                        gridSize = (uint32)std::ceil(std::sqrt((float)bodies));
+            actors.reserve(bodies);
+
+            for (uint32 i = 0; i < bodies; i++)
+            {
+                physx::PxRigidDynamic* rigid = physics->createRigidDynamic(physx::PxTransform(physx::PxVec3((float)(i % gridSize) * 1.5f, 0.5f, (float)(i / gridSize) * 1.5f)));
+                rigid->attachShape(*shape);
+                physx::PxRigidBodyExt::updateMassAndInertia(*rigid, 10.0f);
+
+                // Resting boxes would fall asleep & stop reporting.
+                rigid->setSleepThreshold(0.0f);
+                scene->addActor(*rigid);
+                actors.push_back(rigid);
+            }
+
+            auto step = [&]() {
+                scene->simulate(ContactTestStep);
+                reporter.BeginStep();
+                scene->fetchResults(true);
+            };
+
+            // The first steps allocate the solver & broad phase buffers.
+            for (uint32 i = 0; i < warmup; i++)
+                step();
+
+            const ContactReport*  contacts        = reporter.GetContacts();
+            const TriggerReport*  triggers        = reporter.GetTriggers();
+            const uint64          allocations     = allocator.m_allocations;
+            uint32                contactsPerStep = bodies;
+            uint32                dropped         = 0;
+            const Test::Stopwatch stopwatch;
+
+            for (uint32 i = 0; i < steps; i++)
+            {
+                step();
+                contactsPerStep = std::min(contactsPerStep, reporter.GetContactCount());
+                dropped += reporter.GetDroppedCount();
+            }
+
+            const double stepMs          = steps > 0 ? stopwatch.GetElapsedMs() / steps : 0.0;
+            const uint64 stepAllocations = allocator.m_allocations - allocations;
+
+            LINA_CHECK(stepAllocations == 0);
+            LINA_CHECK(contacts == reporter.GetContacts());
+            LINA_CHECK(triggers == reporter.GetTriggers());
+            LINA_CHECK(dropped == 0);
+            LINA_CHECK(contactsPerStep == bodies);
+
+            if (printTimings)
+                Test::Print("{0} bodies, {1} contacts per step, {2} ms per step, {3} allocations, {4} dropped.", bodies, contactsPerStep, stepMs, stepAllocations, dropped);
+
+            for (physx::PxRigidDynamic* rigid : actors)
+                rigid->release();
+
+            ground->release();
+            scene->release();
+            shape->release();
+            material->release();
+            dispatcher->release();
+        }
+    } // namespace
+
+    LINA_TEST(Physics, ContactReportsDontAllocateAfterWarmup)
+    {
+        CheckContactReports(256, 10, 10, false);
+    }
+
+    LINA_BENCHMARK(Physics, ContactReport)
+    {
+        CheckContactReports(100000, 30, 10, true);
+    }
+} // namespace Lina::Physics
+
+#endif
@@ -0,0 +1,167 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXCpuDispatcher.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Steps a scene of stacked boxes with the PhysX tasks running on executors of increasing worker counts, PhysX's own
+// dispatcher is the baseline.
+namespace Lina::Physics
+{
+    namespace
+    {
+        struct DispatcherTestRun
+        {
+            double m_stepMs    = 0.0;
+            float  m_minHeight = 0.0f;
+        };
+
+        DispatcherTestRun StepStackingScene(PhysXTestFoundation& foundation, physx::PxCpuDispatcher* dispatcher, physx::PxMaterial* material, physx::PxShape* shape, uint32 bodies, uint32 steps)
+        {
+            physx::PxPhysics* physics = foundation.GetPhysics();
+            physx::PxScene*   scene   = foundation.CreateScene(dispatcher);
+
+            physx::PxRigidStatic* ground = physx::PxCreatePlane(*physics, physx::PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material);
+            scene->addActor(*ground);
+
+            // Columns of 8, so every step has contacts to solve.
+            std::vector<physx::PxRigidDynamic*> actors;
+            const uint32                        columns  = (bodies + 7) / 8;
+            const uint32                        gridSize = (uint32)std::ceil(std::sqrt((float)columns));
+            actors.reserve(bodies);
+
+            for (uint32 i = 0; i < bodies; i++)
+            {
+                const uint32           column = i / 8;
+                const physx::PxVec3    location((float)(column % gridSize) * 2.0f, 0.5f + (float)(i % 8) * 1.05f, (float)(column / gridSize) * 2.0f);
+                physx::PxRigidDynamic* rigid = physics->createRigidDynamic(physx::PxTransform(location));
+                rigid->attachShape(*shape);
+                physx::PxRigidBodyExt::updateMassAndInertia(*rigid, 10.0f);
+                scene->addActor(*rigid);
+                actors.push_back(rigid);
+            }
+
+            // Warm up, the first step allocates the islands & contact buffers.
+            scene->simulate(0.016f);
+            scene->fetchResults(true);
+
+            const Test::Stopwatch stopwatch;
+
+            for (uint32 step = 0; step < steps; step++)
+            {
+                scene->simulate(0.016f);
+                scene->fetchResults(true);
+            }
+
+            DispatcherTestRun run;
+            run.m_stepMs    = steps > 0 ? stopwatch.GetElapsedMs() / steps : 0.0;
+            run.m_minHeight = actors.empty() ? 0.0f : actors[0]->getGlobalPose().p.y;
+
+            for (physx::PxRigidDynamic* rigid : actors)
+            {
+                run.m_minHeight = std::min(run.m_minHeight, rigid->getGlobalPose().p.y);
+                rigid->release();
+            }
+
+            ground->release();
+            scene->release();
+            return run;
+        }
+
+        void CheckDispatcher(uint32 bodies, uint32 steps, uint32 maxThreads, bool printTimings)
+        {
+            PhysXTestFoundation foundation;
+            LINA_REQUIRE(foundation.IsValid());
+
+            physx::PxPhysics*  physics  = foundation.GetPhysics();
+            physx::PxMaterial* material = physics->createMaterial(0.5f, 0.5f, 0.6f);
+            physx::PxShape*    shape    = physics->createShape(physx::PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, false);
+
+            physx::PxDefaultCpuDispatcher* defaultDispatcher = physx::PxDefaultCpuDispatcherCreate(2);
+            const DispatcherTestRun        baseline          = StepStackingScene(foundation, defaultDispatcher, material, shape, bodies, steps);
+            defaultDispatcher->release();
+
+            if (printTimings)
+                Test::Print("{0} bodies, PhysX default dispatcher with 2 threads, {1} ms per step.", bodies, baseline.m_stepMs);
+
+            double singleMs = 0.0;
+
+            for (uint32 threads = 1; threads <= maxThreads; threads *= 2)
+            {
+                Executor           executor(threads);
+                PhysXCpuDispatcher dispatcher(&executor, threads);
+
+                const DispatcherTestRun run = StepStackingScene(foundation, &dispatcher, material, shape, bodies, steps);
+                singleMs                    = threads == 1 ? run.m_stepMs : singleMs;
+
+                // Every task ran on a worker & the stacks rest on the ground.
+                std::vector<PhysXWorkerStats> workers;
+                dispatcher.CollectStats(workers, true);
+
+                uint32 tasks = 0;
+                for (const PhysXWorkerStats& worker : workers)
+                    tasks += worker.m_tasks;
+
+                LINA_CHECK(tasks > 0);
+                LINA_CHECK(workers.size() <= threads);
+                LINA_CHECK(run.m_minHeight > 0.0f);
+                LINA_CHECK(std::fabs(run.m_minHeight - baseline.m_minHeight) < 0.05f);
+
+                if (!printTimings)
+                    continue;
+
+                Test::Print("{0} bodies, {1} threads, {2} ms per step, {3}x speedup.", bodies, threads, run.m_stepMs, run.m_stepMs > 0.0 ? singleMs / run.m_stepMs : 1.0);
+
+                for (const PhysXWorkerStats& worker : workers)
+                    Test::Print("Worker {0}, {1} tasks, {2} ms.", worker.m_worker, worker.m_tasks, worker.m_taskMs);
+            }
+
+            shape->release();
+            material->release();
+        }
+    } // namespace
+
+    LINA_TEST(Physics, DispatcherRunsTasksOnTheExecutor)
+    {
+        CheckDispatcher(512, 20, 2, false);
+    }
+
+    LINA_BENCHMARK(Physics, Dispatcher)
+    {
+        CheckDispatcher(10000, 60, 16, true);
+    }
+} // namespace Lina::Physics
+
+#endif
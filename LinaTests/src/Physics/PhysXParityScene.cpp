@@ -0,0 +1,106 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/PhysXParityScene.hpp"
+
+#include "Core/Backend/PhysX/PhysXPhysicsEngine.hpp"
+#include "Core/PhysicsCommon.hpp"
+#include "ECS/Systems/RigidbodySystem.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <thread>
+
+namespace Lina::Physics
+{
+    PhysicsParityResult PhysXParityScene::Run(const PhysicsParityScene& scene)
+    {
+        PhysicsParityResult result;
+        result.m_backend = "PhysX";
+        result.m_bodies  = (uint32)scene.m_bodies.size();
+        result.m_steps   = scene.m_steps;
+        result.m_threads = std::thread::hardware_concurrency() == 0 ? 1 : std::thread::hardware_concurrency();
+
+        PhysXTestFoundation foundation;
+
+        if (!foundation.IsValid())
+            return result;
+
+        physx::PxPhysics*              physics    = foundation.GetPhysics();
+        physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(result.m_threads);
+        physx::PxMaterial*             material   = physics->createMaterial(scene.m_friction, scene.m_friction, 0.0f);
+        physx::PxScene*                pxScene    = foundation.CreateScene(dispatcher, scene.m_gravity);
+        pxScene->setFlag(physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS, true);
+
+        physx::PxRigidStatic* ground = physx::PxCreatePlane(*physics, physx::PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material);
+        pxScene->addActor(*ground);
+
+        // Same actors the physics engine creates for dynamic, non kinematic bodies.
+        entt::registry                      reg;
+        std::vector<ECS::Entity>            entities;
+        std::vector<physx::PxRigidDynamic*> actors;
+        PhysicsParity::CreateEntities(scene, reg, entities);
+        actors.reserve(entities.size());
+
+        for (size_t i = 0; i < entities.size(); i++)
+        {
+            const PhysicsParityBody& body  = scene.m_bodies[i];
+            const CollisionShape     type  = body.m_isSphere ? CollisionShape::Sphere : CollisionShape::Box;
+            physx::PxShape*          shape = PhysXPhysicsEngine::CreatePrimitiveShape(*physics, *material, type, Vector3(body.m_size), body.m_size, body.m_size);
+            physx::PxRigidDynamic*   rigid = PhysXPhysicsEngine::CreateDynamicActor(*physics, *shape, 1.0f, false, body.m_position, Quaternion(), entities[i]);
+            shape->release();
+            pxScene->addActor(*rigid);
+            actors.push_back(rigid);
+        }
+
+        // Written back after every step, as the rigidbody system does after each fetch.
+        const Test::Stopwatch stopwatch;
+
+        for (uint32 i = 0; i < scene.m_steps; i++)
+        {
+            pxScene->simulate(scene.m_stepTime);
+            pxScene->fetchResults(true);
+
+            physx::PxU32     nbActiveActors = 0;
+            physx::PxActor** activeActors   = pxScene->getActiveActors(nbActiveActors);
+            ECS::RigidbodySystem::SyncActiveActors(reg, activeActors, nbActiveActors);
+        }
+
+        result.m_stepMs = scene.m_steps > 0 ? stopwatch.GetElapsedMs() / scene.m_steps : 0.0;
+        PhysicsParity::Aggregate(reg, entities, result);
+
+        for (physx::PxRigidDynamic* rigid : actors)
+            rigid->release();
+
+        ground->release();
+        pxScene->release();
+        material->release();
+        dispatcher->release();
+        return result;
+    }
+} // namespace Lina::Physics
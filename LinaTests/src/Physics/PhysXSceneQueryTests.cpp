@@ -0,0 +1,169 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXSceneQuery.hpp"
+#include "Core/PhysicsCommon.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <random>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Batches of rays against a grid of static boxes & spheres, split over executors of increasing worker counts. Hits
+// have to be the same for every worker count & the same as a single blocking raycast.
+namespace Lina::Physics
+{
+    namespace
+    {
+        bool SameHit(const HitInfo& a, const HitInfo& b)
+        {
+            return a.m_hitCount == b.m_hitCount && a.m_entity == b.m_entity && a.m_distance == b.m_distance;
+        }
+
+        void CheckSceneQuery(uint32 rays, uint32 shapes, uint32 maxThreads, uint32 batches, bool printTimings)
+        {
+            PhysXTestFoundation foundation;
+            LINA_REQUIRE(foundation.IsValid());
+
+            physx::PxPhysics*              physics    = foundation.GetPhysics();
+            physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(1);
+            physx::PxMaterial*             material   = physics->createMaterial(0.5f, 0.5f, 0.6f);
+            physx::PxShape*                box        = physics->createShape(physx::PxBoxGeometry(0.5f, 0.5f, 0.5f), *material, false);
+            physx::PxShape*                sphere     = physics->createShape(physx::PxSphereGeometry(0.5f), *material, false);
+            physx::PxScene*                scene      = foundation.CreateScene(dispatcher, 0.0f);
+            box->setQueryFilterData(physx::PxFilterData(1, 0, 0, 0));
+            sphere->setQueryFilterData(physx::PxFilterData(1, 0, 0, 0));
+
+            // Shapes fill a cube with a 3 unit spacing, every other one is a sphere.
+            std::vector<physx::PxRigidStatic*> actors;
+            const uint32                       gridSize = (uint32)std::ceil(std::cbrt((float)shapes));
+            const float                        extent   = (float)gridSize * 3.0f;
+            actors.reserve(shapes);
+
+            for (uint32 i = 0; i < shapes; i++)
+            {
+                const Vector3         location = Vector3((float)(i % gridSize), (float)((i / gridSize) % gridSize), (float)(i / (gridSize * gridSize))) * 3.0f;
+                physx::PxRigidStatic* rigid    = physics->createRigidStatic(physx::PxTransform(ToPxVector3(location)));
+                rigid->attachShape(i % 2 == 0 ? *box : *sphere);
+                rigid->userData = ToPxUserData((ECS::Entity)i);
+                scene->addActor(*rigid);
+                actors.push_back(rigid);
+            }
+
+            // Queries use the scene query structure of the last fetched step.
+            scene->simulate(0.016f);
+            scene->fetchResults(true);
+
+            // Rays start on the faces of the grid's bounds & aim at random points inside it.
+            std::mt19937                          rng(1234);
+            std::uniform_real_distribution<float> dist(0.0f, extent);
+            std::vector<RaycastQuery>             queries(rays);
+
+            for (uint32 i = 0; i < rays; i++)
+            {
+                Vector3 origin = Vector3(dist(rng), dist(rng), dist(rng));
+                origin[i % 3]  = i % 2 == 0 ? -2.0f : extent + 2.0f;
+
+                const Vector3 target  = Vector3(dist(rng), dist(rng), dist(rng));
+                queries[i].m_origin   = origin;
+                queries[i].m_unitDir  = (target - origin).Normalized();
+                queries[i].m_distance = extent * 2.0f;
+            }
+
+            std::vector<HitInfo> reference;
+            double               singleMs = 0.0;
+
+            for (uint32 threads = 1; threads <= maxThreads; threads *= 2)
+            {
+                Executor             executor(threads);
+                std::vector<HitInfo> hits(rays);
+
+                // Warm up.
+                PhysXSceneQuery::Raycast(scene, executor, queries.data(), rays, hits.data());
+
+                const Test::Stopwatch stopwatch;
+
+                for (uint32 batch = 0; batch < batches; batch++)
+                    PhysXSceneQuery::Raycast(scene, executor, queries.data(), rays, hits.data());
+
+                const double batchMs = batches > 0 ? stopwatch.GetElapsedMs() / batches : 0.0;
+                singleMs             = threads == 1 ? batchMs : singleMs;
+
+                if (reference.empty())
+                    reference = hits;
+
+                uint32 hitCount = 0;
+
+                for (uint32 i = 0; i < rays; i++)
+                {
+                    hitCount += hits[i].m_hitCount > 0 ? 1 : 0;
+                    LINA_CHECK(SameHit(hits[i], reference[i]));
+                }
+
+                LINA_CHECK(hitCount > 0);
+
+                if (printTimings)
+                    Test::Print("{0} rays, {1} shapes, {2} hits, {3} threads, {4} ms per batch, {5}x speedup.", rays, shapes, hitCount, threads, batchMs, batchMs > 0.0 ? singleMs / batchMs : 1.0);
+            }
+
+            // The batched hits match the scene's own blocking raycast.
+            for (uint32 i = 0; i < rays && i < 256; i++)
+            {
+                physx::PxRaycastBuffer hit;
+                const bool             blocking = scene->raycast(ToPxVector3(queries[i].m_origin), ToPxVector3(queries[i].m_unitDir), queries[i].m_distance, hit);
+                LINA_CHECK(blocking == (reference[i].m_hitCount > 0));
+
+                if (blocking && reference[i].m_hitCount > 0)
+                    LINA_CHECK(std::fabs(hit.block.distance - reference[i].m_distance) < 0.001f);
+            }
+
+            for (physx::PxRigidStatic* rigid : actors)
+                rigid->release();
+
+            scene->release();
+            sphere->release();
+            box->release();
+            material->release();
+            dispatcher->release();
+        }
+    } // namespace
+
+    LINA_TEST(Physics, SceneQueryHitsMatchForEveryWorkerCount)
+    {
+        CheckSceneQuery(2048, 1000, 4, 1, false);
+    }
+
+    LINA_BENCHMARK(Physics, SceneQuery)
+    {
+        CheckSceneQuery(100000, 20000, 16, 10, true);
+    }
+} // namespace Lina::Physics
+
+#endif
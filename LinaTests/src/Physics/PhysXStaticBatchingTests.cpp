@@ -0,0 +1,215 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/Backend/PhysX/PhysXStaticBatcher.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Fills a scene with static boxes on a terrain like grid once per batching mode, pruning structures both built at
+// load & loaded from a saved batch. Every static has to be hit by a ray in every mode, populate & step times are
+// measured with dynamic bodies falling on the statics.
+namespace Lina::Physics
+{
+    namespace
+    {
+        const char* StaticBatchingTestCachePath = "LinaTests_StaticBatching.linaphx";
+
+        float GetStaticHeight(float x, float z)
+        {
+            return std::sin(x * 0.05f) * 4.0f + std::cos(z * 0.03f) * 6.0f;
+        }
+
+        // Boxes on a grid with 3 units spacing, heights follow a few waves so cells aren't flat.
+        std::vector<physx::PxRigidStatic*> CreateStatics(physx::PxPhysics* physics, physx::PxMaterial* material, uint32 count)
+        {
+            std::vector<physx::PxRigidStatic*> actors;
+            const uint32                       gridSize = (uint32)std::ceil(std::sqrt((float)count));
+            actors.reserve(count);
+
+            for (uint32 i = 0; i < count; i++)
+            {
+                const float           x     = (float)(i % gridSize) * 3.0f;
+                const float           z     = (float)(i / gridSize) * 3.0f;
+                physx::PxRigidStatic* actor = physics->createRigidStatic(physx::PxTransform(physx::PxVec3(x, GetStaticHeight(x, z), z)));
+                physx::PxRigidActorExt::createExclusiveShape(*actor, physx::PxBoxGeometry(1.4f, 0.5f, 1.4f), *material);
+                actors.push_back(actor);
+            }
+
+            return actors;
+        }
+
+        void CheckStaticBatching(uint32 statics, uint32 dynamics, uint32 steps, float cellSize, bool printTimings)
+        {
+            PhysXTestFoundation foundation;
+            LINA_REQUIRE(foundation.IsValid());
+
+            const uint32                   threads    = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() : 1;
+            physx::PxPhysics*              physics    = foundation.GetPhysics();
+            physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(2);
+            physx::PxMaterial*             material   = physics->createMaterial(0.5f, 0.5f, 0.6f);
+            physx::PxShape*                sphere     = physics->createShape(physx::PxSphereGeometry(0.5f), *material, false);
+            physx::PxCollection*           refs       = PxCreateCollection();
+            refs->add(*material, 1);
+
+            // Loaded batches live in the batcher's memory blocks, it's only destroyed after the SDK is released.
+            PhysXStaticBatcher  batcher;
+            Executor            executor(threads);
+            const uint64        hash = statics;
+            std::vector<uint64> savedIds;
+            batcher.Initialize(physics);
+
+            // Saved once up front, the load run measures only the load.
+            {
+                StaticBatch batch;
+                auto        actors = CreateStatics(physics, material, statics);
+
+                for (uint32 i = 0; i < statics; i++)
+                    savedIds.push_back((uint64)i + 2);
+
+                batcher.Build(actors, StaticBatching::PruningStructures, cellSize, executor, batch);
+                LINA_CHECK(batcher.Save(StaticBatchingTestCachePath, hash, batch, savedIds, *refs));
+                batcher.ReleaseBatch(batch);
+            }
+
+            // A different hash means the saved batch is stale.
+            {
+                StaticBatch         batch;
+                std::vector<uint64> ids;
+                LINA_CHECK(!batcher.Load(StaticBatchingTestCachePath, hash + 1, *refs, batch, ids));
+            }
+
+            const StaticBatching modes[4]     = {StaticBatching::None, StaticBatching::Aggregates, StaticBatching::PruningStructures, StaticBatching::PruningStructures};
+            const bool           loaded[4]    = {false, false, false, true};
+            const char*          modeNames[3] = {"individual actors", "aggregates", "pruning structures"};
+            const uint32         gridSize     = (uint32)std::ceil(std::sqrt((float)statics));
+
+            for (uint32 run = 0; run < 4; run++)
+            {
+                physx::PxScene* scene = foundation.CreateScene(dispatcher);
+                StaticBatch     batch;
+                auto            actors = loaded[run] ? std::vector<physx::PxRigidStatic*>() : CreateStatics(physics, material, statics);
+
+                const Test::Stopwatch populateStopwatch;
+
+                if (loaded[run])
+                {
+                    std::vector<uint64> ids;
+                    const bool          isLoaded = batcher.Load(StaticBatchingTestCachePath, hash, *refs, batch, ids);
+                    LINA_CHECK(isLoaded);
+                    LINA_CHECK(ids == savedIds);
+
+                    if (!isLoaded)
+                    {
+                        scene->release();
+                        continue;
+                    }
+                }
+                else
+                    batcher.Build(actors, modes[run], cellSize, executor, batch);
+
+                std::vector<physx::PxRigidStatic*> inserted = batch.m_actors;
+                batcher.AddToScene(scene, batch);
+                const double populateMs = populateStopwatch.GetElapsedMs();
+                LINA_CHECK(inserted.size() == statics);
+
+                // Dynamic bodies rain down on the statics, so the broadphase keeps finding new pairs.
+                std::vector<physx::PxRigidDynamic*> bodies;
+
+                for (uint32 i = 0; i < dynamics; i++)
+                {
+                    const float            x     = (float)((i * 7919) % gridSize) * 3.0f;
+                    const float            z     = (float)((i * 104729) % gridSize) * 3.0f;
+                    physx::PxRigidDynamic* rigid = physics->createRigidDynamic(physx::PxTransform(physx::PxVec3(x, 20.0f + (float)(i % 10) * 2.0f, z)));
+                    rigid->attachShape(*sphere);
+                    physx::PxRigidBodyExt::updateMassAndInertia(*rigid, 10.0f);
+                    scene->addActor(*rigid);
+                    bodies.push_back(rigid);
+                }
+
+                const Test::Stopwatch stepStopwatch;
+
+                for (uint32 step = 0; step < steps; step++)
+                {
+                    scene->simulate(0.016f);
+                    scene->fetchResults(true);
+                }
+
+                const double stepMs = steps > 0 ? stepStopwatch.GetElapsedMs() / steps : 0.0;
+
+                // Rays straight down on the statics hit their top faces, static only so the falling bodies don't block them.
+                physx::PxQueryFilterData filter(physx::PxQueryFlag::eSTATIC);
+
+                for (uint32 i = 0; i < statics; i += statics / 64 + 1)
+                {
+                    const float            x = (float)(i % gridSize) * 3.0f;
+                    const float            z = (float)(i / gridSize) * 3.0f;
+                    physx::PxRaycastBuffer hit;
+                    const bool             isHit = scene->raycast(physx::PxVec3(x, 100.0f, z), physx::PxVec3(0.0f, -1.0f, 0.0f), 200.0f, hit, physx::PxHitFlag::eDEFAULT, filter);
+                    LINA_CHECK(isHit && std::fabs(hit.block.position.y - (GetStaticHeight(x, z) + 0.5f)) < 0.01f);
+                }
+
+                if (printTimings)
+                    Test::Print("{0} statics as {1}{2}, populated in {3} ms, {4} ms per step with {5} dynamic bodies.", statics, modeNames[(int)modes[run]], loaded[run] ? " (loaded)" : "", populateMs, stepMs, dynamics);
+
+                for (physx::PxRigidDynamic* rigid : bodies)
+                    rigid->release();
+
+                for (physx::PxRigidStatic* actor : inserted)
+                    actor->release();
+
+                batcher.ReleaseAggregates();
+                scene->release();
+            }
+
+            std::remove(StaticBatchingTestCachePath);
+
+            refs->release();
+            sphere->release();
+            material->release();
+            dispatcher->release();
+        }
+    } // namespace
+
+    LINA_TEST(Physics, StaticBatchesAreQueryableInEveryMode)
+    {
+        CheckStaticBatching(1024, 32, 5, 16.0f, false);
+    }
+
+    LINA_BENCHMARK(Physics, StaticBatching)
+    {
+        CheckStaticBatching(50000, 1000, 60, 64.0f, true);
+    }
+} // namespace Lina::Physics
+
+#endif
@@ -0,0 +1,163 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Core/PhysicsCommon.hpp"
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Systems/RigidbodySystem.hpp"
+#include "Physics/PhysXTestFoundation.hpp"
+#include "TestFramework.hpp"
+
+#include <cmath>
+#include <vector>
+
+#ifdef LINA_PHYSICS_PHYSX
+
+// Free falling spheres, every other one sleeping. Only the active actors reported by the scene are written back to the
+// registry, the legacy registry mirrors the entities & gets the same poses through SetLocation & SetRotation.
+namespace Lina::Physics
+{
+    namespace
+    {
+        void CheckSync(uint32 bodies, uint32 frames, bool printTimings)
+        {
+            PhysXTestFoundation foundation;
+            LINA_REQUIRE(foundation.IsValid());
+
+            physx::PxPhysics*              physics    = foundation.GetPhysics();
+            physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(2);
+            physx::PxScene*                scene      = foundation.CreateScene(dispatcher);
+            scene->setFlag(physx::PxSceneFlag::eENABLE_ACTIVE_ACTORS, true);
+
+            // Spread apart on a grid so they fall without touching, sleeping ones are never woken up. The shape is shared.
+            physx::PxMaterial*                  material = physics->createMaterial(0.5f, 0.5f, 0.6f);
+            physx::PxShape*                     shape    = physics->createShape(physx::PxSphereGeometry(0.5f), *material, false);
+            entt::registry                      reg;
+            entt::registry                      legacyReg;
+            std::vector<physx::PxRigidDynamic*> actors;
+            const uint32                        gridSize = (uint32)std::ceil(std::cbrt((float)bodies));
+            uint32                              sleeping = 0;
+            actors.reserve(bodies);
+
+            for (uint32 i = 0; i < bodies; i++)
+            {
+                const ECS::Entity entity   = reg.create();
+                const Vector3     location = Vector3((float)(i % gridSize), (float)((i / gridSize) % gridSize), (float)(i / (gridSize * gridSize))) * 4.0f;
+                reg.emplace<ECS::EntityDataComponent>(entity).SetLocation(location);
+                legacyReg.emplace<ECS::EntityDataComponent>(legacyReg.create()).SetLocation(location);
+
+                physx::PxRigidDynamic* rigid = physics->createRigidDynamic(physx::PxTransform(ToPxVector3(location)));
+                rigid->attachShape(*shape);
+                physx::PxRigidBodyExt::updateMassAndInertia(*rigid, 10.0f);
+                rigid->userData = ToPxUserData(entity);
+                scene->addActor(*rigid);
+                actors.push_back(rigid);
+
+                if (i % 2 == 1)
+                {
+                    rigid->putToSleep();
+                    sleeping++;
+                }
+            }
+
+            shape->release();
+
+            // First step reports every body that was added, so it's left out.
+            scene->simulate(0.016f);
+            scene->fetchResults(true);
+
+            double simulateMs    = 0.0;
+            double syncMs        = 0.0;
+            double legacyWriteMs = 0.0;
+            uint32 active        = 0;
+
+            for (uint32 frame = 0; frame < frames; frame++)
+            {
+                Test::Stopwatch stopwatch;
+                scene->simulate(0.016f);
+                scene->fetchResults(true);
+                simulateMs += stopwatch.GetElapsedMs();
+
+                physx::PxU32     nbActiveActors = 0;
+                physx::PxActor** activeActors   = scene->getActiveActors(nbActiveActors);
+
+                stopwatch.Restart();
+                const uint32 synced = ECS::RigidbodySystem::SyncActiveActors(reg, activeActors, nbActiveActors);
+                syncMs += stopwatch.GetElapsedMs();
+
+                stopwatch.Restart();
+
+                for (physx::PxU32 i = 0; i < nbActiveActors; i++)
+                {
+                    physx::PxRigidDynamic*    rigid = static_cast<physx::PxRigidDynamic*>(activeActors[i]);
+                    const physx::PxTransform  pose  = rigid->getGlobalPose();
+                    ECS::EntityDataComponent& data  = legacyReg.get<ECS::EntityDataComponent>(ToLinaEntity(rigid->userData));
+                    data.SetLocation(ToLinaVector3(pose.p));
+                    data.SetRotation(ToLinaQuat(pose.q));
+                }
+
+                legacyWriteMs += stopwatch.GetElapsedMs();
+                active = nbActiveActors;
+                LINA_REQUIRE(synced == nbActiveActors);
+                LINA_REQUIRE(nbActiveActors <= bodies - sleeping);
+            }
+
+            // Both registries were created in the same order, so the entities match.
+            for (physx::PxRigidDynamic* rigid : actors)
+            {
+                const ECS::Entity entity   = ToLinaEntity(rigid->userData);
+                const Vector3     location = reg.get<ECS::EntityDataComponent>(entity).GetLocation();
+                const Vector3     legacy   = legacyReg.get<ECS::EntityDataComponent>(entity).GetLocation();
+                LINA_CHECK(location.x == legacy.x && location.y == legacy.y && location.z == legacy.z);
+            }
+
+            LINA_CHECK(frames == 0 || active > 0);
+
+            if (printTimings && frames > 0)
+                Test::Print("{0} bodies, {1} sleeping, {2} active, simulate {3} ms, sync {4} ms, legacy write {5} ms per frame.", bodies, sleeping, active, simulateMs / frames, syncMs / frames, legacyWriteMs / frames);
+
+            for (physx::PxRigidDynamic* rigid : actors)
+                rigid->release();
+
+            material->release();
+            scene->release();
+            dispatcher->release();
+        }
+    } // namespace
+
+    LINA_TEST(Physics, SyncWritesOnlyActiveActors)
+    {
+        CheckSync(512, 10, false);
+    }
+
+    LINA_BENCHMARK(Physics, Sync)
+    {
+        CheckSync(20000, 60, true);
+    }
+} // namespace Lina::Physics
+
+#endif
@@ -0,0 +1,58 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/PhysXTestFoundation.hpp"
+
+namespace Lina::Physics
+{
+    PhysXTestFoundation::PhysXTestFoundation(physx::PxAllocatorCallback* allocator)
+    {
+        m_foundation = PxCreateFoundation(PX_PHYSICS_VERSION, allocator != nullptr ? *allocator : m_defaultAllocator, m_errorCallback);
+
+        if (m_foundation != nullptr)
+            m_physics = PxCreatePhysics(PX_PHYSICS_VERSION, *m_foundation, physx::PxTolerancesScale());
+    }
+
+    PhysXTestFoundation::~PhysXTestFoundation()
+    {
+        if (m_physics != nullptr)
+            m_physics->release();
+
+        if (m_foundation != nullptr)
+            m_foundation->release();
+    }
+
+    physx::PxScene* PhysXTestFoundation::CreateScene(physx::PxCpuDispatcher* dispatcher, float gravity)
+    {
+        physx::PxSceneDesc sceneDesc(m_physics->getTolerancesScale());
+        sceneDesc.gravity       = physx::PxVec3(0.0f, gravity, 0.0f);
+        sceneDesc.cpuDispatcher = dispatcher;
+        sceneDesc.filterShader  = physx::PxDefaultSimulationFilterShader;
+        return m_physics->createScene(sceneDesc);
+    }
+} // namespace Lina::Physics
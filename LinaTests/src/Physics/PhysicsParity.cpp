@@ -0,0 +1,149 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/PhysicsParity.hpp"
+
+#include "ECS/Components/EntityDataComponent.hpp"
+#include "ECS/Components/PhysicsComponent.hpp"
+
+#include <cmath>
+#include <fstream>
+
+namespace Lina::Physics
+{
+    namespace
+    {
+        const float  ParitySettledSpeed     = 0.05f;
+        const float  ParityHeightTolerance  = 0.05f;
+        const float  ParitySettledTolerance = 0.02f;
+        const uint32 ParityStackHeight      = 4;
+        const float  ParityCellSize         = 3.0f;
+    } // namespace
+
+    PhysicsParityScene PhysicsParity::CreateScene(uint32 bodies, uint32 steps)
+    {
+        PhysicsParityScene scene;
+        scene.m_steps = steps;
+        scene.m_bodies.resize(bodies);
+
+        const uint32 cells    = (bodies + ParityStackHeight - 1) / ParityStackHeight;
+        const uint32 gridSize = (uint32)std::ceil(std::sqrt((float)cells));
+
+        for (uint32 i = 0; i < bodies; i++)
+        {
+            const uint32       cell   = i / ParityStackHeight;
+            const uint32       level  = i % ParityStackHeight;
+            const Vector3      center = Vector3((float)(cell % gridSize) * ParityCellSize, 0.0f, (float)(cell / gridSize) * ParityCellSize);
+            PhysicsParityBody& body   = scene.m_bodies[i];
+
+            if (cell % 3 == 2)
+            {
+                // Dropped next to each other, so they settle without rolling.
+                body.m_isSphere = true;
+                body.m_position = center + Vector3(level % 2 == 0 ? -0.6f : 0.6f, 2.0f, level < 2 ? -0.6f : 0.6f);
+            }
+            else
+                body.m_position = center + Vector3(0.0f, 0.5f + (float)level * 1.01f, 0.0f);
+        }
+
+        return scene;
+    }
+
+    void PhysicsParity::CreateEntities(const PhysicsParityScene& scene, entt::registry& reg, std::vector<ECS::Entity>& entities)
+    {
+        entities.clear();
+        entities.reserve(scene.m_bodies.size());
+
+        for (const PhysicsParityBody& body : scene.m_bodies)
+        {
+            const ECS::Entity entity = reg.create();
+            reg.emplace<ECS::EntityDataComponent>(entity).SetLocation(body.m_position);
+            reg.emplace<ECS::PhysicsComponent>(entity);
+            entities.push_back(entity);
+        }
+    }
+
+    void PhysicsParity::Aggregate(entt::registry& reg, const std::vector<ECS::Entity>& entities, PhysicsParityResult& result)
+    {
+        double heightSum = 0.0;
+        double speedSum  = 0.0;
+
+        for (ECS::Entity entity : entities)
+        {
+            const Vector3 position = reg.get<ECS::EntityDataComponent>(entity).GetLocation();
+            const Vector3 v        = reg.get<ECS::PhysicsComponent>(entity).GetVelocity();
+            const float   speed    = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+
+            heightSum += position.y;
+            speedSum += speed;
+            result.m_maxSpeed = speed > result.m_maxSpeed ? speed : result.m_maxSpeed;
+
+            if (speed < ParitySettledSpeed)
+                result.m_settled++;
+
+            if (position.y < 0.0f)
+                result.m_belowGround++;
+        }
+
+        const double count  = entities.empty() ? 1.0 : (double)entities.size();
+        result.m_meanHeight = (float)(heightSum / count);
+        result.m_meanSpeed  = (float)(speedSum / count);
+    }
+
+    bool PhysicsParity::Compare(const PhysicsParityResult& a, const PhysicsParityResult& b)
+    {
+        if (a.m_bodies != b.m_bodies || a.m_steps != b.m_steps)
+            return false;
+
+        const float heightTolerance  = ParityHeightTolerance * std::fmax(1.0f, std::fmax(a.m_meanHeight, b.m_meanHeight));
+        const float settledTolerance = ParitySettledTolerance * (float)a.m_bodies;
+
+        return std::fabs(a.m_meanHeight - b.m_meanHeight) <= heightTolerance && std::fabs((float)a.m_settled - (float)b.m_settled) <= settledTolerance && a.m_belowGround == 0 && b.m_belowGround == 0;
+    }
+
+    bool PhysicsParity::Save(const std::string& path, const PhysicsParityResult& result)
+    {
+        std::ofstream file(path);
+        file << result.m_backend << " " << result.m_bodies << " " << result.m_steps << " " << result.m_threads << " " << result.m_settled << " " << result.m_belowGround << " ";
+        file << result.m_meanHeight << " " << result.m_meanSpeed << " " << result.m_maxSpeed << " " << result.m_stepMs << "\n";
+        return file.good();
+    }
+
+    bool PhysicsParity::Load(const std::string& path, PhysicsParityResult& result)
+    {
+        std::ifstream file(path);
+        file >> result.m_backend >> result.m_bodies >> result.m_steps >> result.m_threads >> result.m_settled >> result.m_belowGround;
+        file >> result.m_meanHeight >> result.m_meanSpeed >> result.m_maxSpeed >> result.m_stepMs;
+        return !file.fail();
+    }
+
+    std::string PhysicsParity::GetResultsPath(const std::string& directory, const std::string& backend)
+    {
+        return directory + "/PhysicsParity_" + backend + ".txt";
+    }
+} // namespace Lina::Physics
@@ -0,0 +1,107 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "Physics/PhysicsParity.hpp"
+#include "TestFramework.hpp"
+
+#ifdef LINA_PHYSICS_PHYSX
+#include "Physics/PhysXParityScene.hpp"
+#endif
+
+#ifdef LINA_PHYSICS_BULLET
+#include "Physics/BulletParityScene.hpp"
+#endif
+
+// Runs the parity scene on the backend of this build. The benchmark saves its result to the working directory &
+// compares it with the other backend's result, if a build of it ran the same scene there before.
+namespace Lina::Physics
+{
+    namespace
+    {
+#ifdef LINA_PHYSICS_PHYSX
+        const char* ParityOtherBackend = "Bullet";
+#endif
+
+#ifdef LINA_PHYSICS_BULLET
+        const char* ParityOtherBackend = "PhysX";
+#endif
+
+        PhysicsParityResult RunParityScene(const PhysicsParityScene& scene)
+        {
+#ifdef LINA_PHYSICS_PHYSX
+            return PhysXParityScene::Run(scene);
+#endif
+
+#ifdef LINA_PHYSICS_BULLET
+            return BulletParityScene::Run(scene);
+#endif
+        }
+
+        void PrintParityResult(const PhysicsParityResult& result)
+        {
+            Test::Print("{0}: {1} bodies, {2} steps, {3} threads, {4} ms per step. Mean height {5}, mean speed {6}, {7} settled, {8} below ground.", result.m_backend, result.m_bodies, result.m_steps, result.m_threads, result.m_stepMs, result.m_meanHeight, result.m_meanSpeed, result.m_settled,
+                        result.m_belowGround);
+        }
+    } // namespace
+
+    LINA_TEST(Physics, ParitySceneSettles)
+    {
+        const uint32              bodies = 64;
+        const PhysicsParityScene  scene  = PhysicsParity::CreateScene(bodies, 240);
+        const PhysicsParityResult result = RunParityScene(scene);
+        LINA_REQUIRE(result.m_bodies == bodies);
+
+        float startHeight = 0.0f;
+        for (const PhysicsParityBody& body : scene.m_bodies)
+            startHeight += body.m_position.y / (float)bodies;
+
+        // Dropped spheres reached the entities through the sync, stacks stand & everything comes to rest within 4 seconds.
+        LINA_CHECK(result.m_meanHeight < startHeight);
+        LINA_CHECK(result.m_belowGround == 0);
+        LINA_CHECK(result.m_settled >= bodies * 3 / 4);
+    }
+
+    LINA_BENCHMARK(Physics, Parity)
+    {
+        const PhysicsParityResult result = RunParityScene(PhysicsParity::CreateScene(4000, 300));
+        PrintParityResult(result);
+        LINA_CHECK(result.m_belowGround == 0);
+        LINA_CHECK(PhysicsParity::Save(PhysicsParity::GetResultsPath(".", result.m_backend), result));
+
+        PhysicsParityResult other;
+        if (!PhysicsParity::Load(PhysicsParity::GetResultsPath(".", ParityOtherBackend), other) || other.m_bodies != result.m_bodies || other.m_steps != result.m_steps)
+        {
+            Test::Print("No {0} results for the same scene yet, run the benchmark in a {0} build to compare.", ParityOtherBackend);
+            return;
+        }
+
+        PrintParityResult(other);
+        LINA_CHECK(PhysicsParity::Compare(result, other));
+        Test::Print("{0} steps {1}x as fast as {2}.", result.m_backend, result.m_stepMs > 0.0 ? other.m_stepMs / result.m_stepMs : 1.0, other.m_backend);
+    }
+} // namespace Lina::Physics
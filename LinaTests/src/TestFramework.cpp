@@ -0,0 +1,108 @@
+/* 
+This file is a part of: Lina Engine
+https://github.com/inanevin/LinaEngine
+
+Author: Inan Evin
+http://www.inanevin.com
+
+Copyright (c) [2018-2020] [Inan Evin]
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "TestFramework.hpp"
+
+#include <exception>
+
+namespace Lina::Test
+{
+    TestRegistry& TestRegistry::Get()
+    {
+        static TestRegistry registry;
+        return registry;
+    }
+
+    void TestRegistry::Add(const TestCase& test)
+    {
+        m_tests.push_back(test);
+    }
+
+    uint32 TestRegistry::Run(TestKind kind, const std::string& filter)
+    {
+        uint32 ran    = 0;
+        uint32 failed = 0;
+
+        for (const TestCase& test : m_tests)
+        {
+            const std::string fullName = std::string(test.m_suite) + "." + test.m_name;
+
+            if (test.m_kind != kind || fullName.compare(0, filter.size(), filter) != 0)
+                continue;
+
+            Print("[ RUN      ] {0}", fullName);
+
+            const uint32    failedChecks = m_failedChecks;
+            const Stopwatch stopwatch;
+
+            try
+            {
+                test.m_function();
+            }
+            catch (const std::exception& e)
+            {
+                Print("Unhandled exception: {0}", e.what());
+                m_failedChecks++;
+            }
+
+            const bool passed = m_failedChecks == failedChecks;
+            Print("[ {0} ] {1} ({2} ms)", passed ? "      OK" : "  FAILED", fullName, stopwatch.GetElapsedMs());
+
+            ran++;
+            failed += passed ? 0 : 1;
+        }
+
+        Print("{0} of {1} passed.", ran - failed, ran);
+        return failed;
+    }
+
+    void TestRegistry::List(TestKind kind) const
+    {
+        for (const TestCase& test : m_tests)
+        {
+            if (test.m_kind == kind)
+                Print("{0}.{1}", test.m_suite, test.m_name);
+        }
+    }
+
+    void TestRegistry::Fail(const char* file, int line, const char* expression)
+    {
+        Print("{0}({1}): check failed: {2}", file, line, expression);
+        m_failedChecks++;
+    }
+
+    TestRegistrar::TestRegistrar(const char* suite, const char* name, TestFunction function, TestKind kind)
+    {
+        TestCase test;
+        test.m_suite    = suite;
+        test.m_name     = name;
+        test.m_function = function;
+        test.m_kind     = kind;
+        TestRegistry::Get().Add(test);
+    }
+} // namespace Lina::Test
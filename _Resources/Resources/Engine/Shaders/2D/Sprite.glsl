@@ -19,14 +19,17 @@
 #include <../UniformBuffers.glh>
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texCoords;
-layout (location = 7) in mat4 model;
+layout (location = 2) in vec4 color;
 
 out vec2 TexCoords;
+out vec4 Color;
 
+// Positions are in world space, sprites are expanded on the CPU & drawn in batches.
 void main()
 {
-	gl_Position = LINA_VP * model * vec4(position, 1.0);
+	gl_Position = LINA_VP * vec4(position, 1.0);
 	TexCoords = texCoords;
+	Color = color;
 }
 
 #elif defined(FS_BUILD)
@@ -37,6 +40,7 @@ layout (location = 0) out vec4 fragColor;
 layout (location = 1) out vec4 brightColor;
 
 in vec2 TexCoords;
+in vec4 Color;
 
 struct Material
 {
@@ -49,7 +53,7 @@ uniform Material material;
 
 void main()
 {
-	fragColor = (material.diffuse.isActive ? texture(material.diffuse.texture ,TexCoords) : vec4(1.0)) * vec4(material.objectColor, 1.0);
+	fragColor = (material.diffuse.isActive ? texture(material.diffuse.texture ,TexCoords) : vec4(1.0)) * Color * vec4(material.objectColor, 1.0);
 
 }
 #endif
@@ -18,10 +18,14 @@
 #if defined(VS_BUILD)
 #include <../UniformBuffers.glh>
 layout (location = 0) in vec3 position;
+layout (location = 1) in vec4 color;
+
+out vec4 vColor;
 
 void main()
 {
   gl_Position = LINA_VP * vec4(position, 1.0);
+  vColor = color;
 }
 
 #elif defined(FS_BUILD)
@@ -31,14 +35,10 @@ layout (location = 1) out vec4 gNormalRoughness;		// rgb = normal, a = roughness
 layout (location = 2) out vec4 gAlbedoAO;				// rgb = albedo, a = AO
 layout (location = 3) out vec4 gEmissionWorkflow;		// rgb = emission, a = workflow
 out vec4 fragColor;
-struct Material
-{
-  vec3 color;
-};
-uniform Material material;
+in vec4 vColor;
 
 void main()
 {
-   fragColor = vec4(material.color.x, material.color.y, material.color.z, 1);
+   fragColor = vec4(vColor.rgb, 1);
 }
 #endif
@@ -34,7 +34,11 @@ out vec3 Normal;
 uniform bool uf_isSkinned;
 const int MAX_BONES = 150;
 const int MAX_BONE_INFLUENCE = 4;
-uniform mat4 uf_boneMatrices[MAX_BONES];
+
+layout (std140) uniform BoneData
+{
+	mat4 LINA_BONES[MAX_BONES];
+};
 
   
 void main()
@@ -43,32 +47,27 @@ void main()
 	
 	if(uf_isSkinned)
 	{
-		
-		vec4 totalPosition = vec4(0.0f);
+		mat4 skinMatrix = mat4(0.0f);
+		float totalWeight = 0.0f;
 		
 		for(int i = 0 ; i < MAX_BONE_INFLUENCE ; i++)
 		{
-			if(boneIDs[i] == -1) 
+			if(boneIDs[i] < 0 || boneIDs[i] >= MAX_BONES) 
 				continue;
 				
-			if(boneIDs[i] >= MAX_BONES) 
-			{
-				totalPosition = vec4(position,1.0f);
-				break;
-			}
-			
-			vec4 localPosition = uf_boneMatrices[boneIDs[i]] * vec4(position,1.0f);
-			totalPosition += localPosition * boneWeights[i];
-			vec3 localNormal = mat3(uf_boneMatrices[boneIDs[i]]) * normal;
+			skinMatrix += LINA_BONES[boneIDs[i]] * boneWeights[i];
+			totalWeight += boneWeights[i];
 		}
 		
-		//mat4 BoneTransform = uf_boneMatrices[boneIDs[0]] * boneWeights[0];
-		//BoneTransform += uf_boneMatrices[boneIDs[1]] * boneWeights[1];
-		//BoneTransform += uf_boneMatrices[boneIDs[2]] * boneWeights[2];
-		//BoneTransform += uf_boneMatrices[boneIDs[3]] * boneWeights[3];
+		// Vertices without any influences stay in bind pose.
+		if(totalWeight <= 0.0f)
+			skinMatrix = mat4(1.0f);
 		
-		WorldPos = vec3(model * vec4(position,1.0f));
-		Normal = mat3(model) * normal;
+		vec4 skinnedPosition = skinMatrix * vec4(position, 1.0f);
+		vec3 skinnedNormal = mat3(skinMatrix) * normal;
+		
+		WorldPos = vec3(model * skinnedPosition);
+		Normal = mat3(model) * skinnedNormal;
 		gl_Position = LINA_VP *  vec4(WorldPos, 1.0f);
 	}
 	else